@@ -0,0 +1,94 @@
+/*
+ * A contention benchmark of ConcurrentStack against a ChunkedStack behind a
+ * mutex: every thread pushes and pops the same stack, in bursts, and the
+ * sum of the popped values checks that no element is lost or duplicated.
+ *
+ * Usage: concurrent_bench [operations per thread = 1000000]
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "my_chunked_stack.h"
+#include "my_concurrent_stack.h"
+
+class lockedStack
+// Overview: A ChunkedStack that one thread at a time may use.
+{
+private:
+    ChunkedStack<long long> stack;
+    std::mutex mutex;
+
+public:
+    void push(long long val)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stack.push(val);
+    }
+
+    long long pop()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        long long val = stack.top();
+        stack.pop();
+        return val;
+    }
+};
+
+template <class S>
+double run(int threads, long long operations, long long &sum)
+// MODIFIES: sum
+// EFFECTS: runs operations pushes and pops on each of threads threads
+//          sharing one stack S, adds the popped values to sum, and returns
+//          the time taken in seconds.
+{
+    S stack;
+    std::vector<std::thread> pool;
+    std::vector<long long> sums(threads, 0);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; t++) {
+        pool.push_back(std::thread([&stack, &sums, t, operations]() {
+            // Bursts of 8 pushes then 8 pops, so that the stack stays short
+            // and every thread works on its top
+            for (long long i = 0; i < operations; i += 16) {
+                for (int j = 0; j < 8; j++) stack.push(i + j);
+                for (int j = 0; j < 8; j++) {
+                    try {
+                        sums[t] += stack.pop();
+                    } catch (stackEmpty) {
+                    }
+                }
+            }
+        }));
+    }
+    for (size_t t = 0; t < pool.size(); t++) pool[t].join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    for (int t = 0; t < threads; t++) sum += sums[t];
+    return seconds;
+}
+
+int main(int argc, char *argv[])
+{
+    long long operations = argc > 1 ? atoll(argv[1]) : 1000000;
+    // Each burst pushes i..i+7 and pops 8 elements, all of them in the end
+    long long expected = 0;
+    for (long long i = 0; i < operations; i += 16) {
+        for (int j = 0; j < 8; j++) expected += i + j;
+    }
+    std::cout << "threads  lock-free Mops/s  mutex Mops/s\n";
+    for (int threads = 1; threads <= 8; threads *= 2) {
+        long long lockFreeSum = 0, lockedSum = 0;
+        double lockFree = run<ConcurrentStack<long long> >(threads, operations, lockFreeSum);
+        double locked = run<lockedStack>(threads, operations, lockedSum);
+        if (lockFreeSum != expected * threads || lockedSum != expected * threads) {
+            std::cout << "Wrong sum with " << threads << " threads\n";
+            return 1;
+        }
+        double total = (double)threads * operations / 1e6;
+        std::cout << threads << "  " << total / lockFree << "  " << total / locked << "\n";
+    }
+    return 0;
+}
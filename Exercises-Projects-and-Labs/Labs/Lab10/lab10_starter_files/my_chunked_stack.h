@@ -0,0 +1,124 @@
+/*
+ * A stack with the interface of Stack in my_stack.h, stored in blocks of
+ * about 4 KiB instead of one node per element.
+ */
+
+#ifndef MY_CHUNKED_STACK_H
+#define MY_CHUNKED_STACK_H
+
+#include <cstddef>
+#include <type_traits>
+#include "my_stack.h"
+
+
+template <class T>
+class ChunkedStack
+// Overview: A stack stored in a list of blocks, the top block first. Each
+//           block holds CAPACITY elements, so a push or a pop only moves a
+//           pointer within the top block, and a block is allocated once in
+//           CAPACITY pushes.
+{
+
+private:
+    static const size_t BLOCK_SIZE = 4096;
+    static const size_t CAPACITY = (BLOCK_SIZE - 2 * sizeof(void *)) / sizeof(T) > 0
+                                   ? (BLOCK_SIZE - 2 * sizeof(void *)) / sizeof(T) : 1;
+
+    struct Block
+    // Overview: CAPACITY slots for elements, constructed in place from the
+    //           first one.
+    {
+        Block *below;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type slots[CAPACITY];
+    };
+
+    /* Attributes */
+    Block *head;    // the top block, NULL for an empty stack
+    Block *spare;   // a free block kept for the next push that needs one,
+                    // so that pushing and popping at a block boundary does
+                    // not allocate each time
+    T *next;        // the slot after the top element, in head
+    size_t count;   // the number of elements
+
+    /* Utilities */
+    T *slots(Block *block) const;
+    // EFFECTS: returns the first slot of block.
+
+    void removeAll();
+    // EFFECTS: called by destructor/operator=
+    //          to remove and destroy all elements and blocks.
+
+    void copyFrom(const ChunkedStack &s);
+    // MODIFIES: this
+    // EFFECTS: called by copy constructor/operator=
+    //          to copy elements from a source stack s to this stack;
+    //          if this stack is not empty originally,
+    //          removes all elements from it before copying.
+    //          If copying an element throws, this is left empty.
+
+public:
+
+    ChunkedStack();
+    // constructor
+    ChunkedStack(const ChunkedStack &s);
+    // copy constructor
+    ChunkedStack(ChunkedStack &&s) noexcept;
+    // move constructor, leaving s empty
+    ChunkedStack &operator = (const ChunkedStack &s);
+    // assignment operator, leaving this unchanged if copying throws
+    ChunkedStack &operator = (ChunkedStack &&s) noexcept;
+    // move assignment operator, leaving s empty
+    ~ChunkedStack();
+    // destructor
+
+
+    /* Methods */
+    void print();
+    // EFFECTS: print the elements in the stack, from the top
+
+    bool isEmpty() const;
+    // EFFECTS: returns true if stack is empty, false otherwise.
+
+    size_t size() const;
+    // EFFECTS: returns the size of the stack.
+
+    void push(T val);
+    // MODIFIES: this
+    // EFFECTS: inserts val at the top of the stack.
+
+    void pop();
+    // MODIFIES: this
+    // EFFECTS: removes the top element from a non-empty stack;
+    //          in case of empty stack, throws an instance of stackEmpty.
+
+    T top() const;
+    // EFFECTS: returns the top element from a stack.
+    //          in case of empty stack, throws an instance of stackEmpty.
+
+};
+
+template <class T>
+void reverse(ChunkedStack<T> &s);
+// MODIFIES: s
+// EFFECTS: reverse stack s.
+//           * for example:
+//             [12345] => [54321]
+
+/* Operators */
+template <class T>
+ChunkedStack<T> operator +(ChunkedStack<T> &s, T val);
+// EFFECTS: returns a new stack which is the result of appending stack s by val.
+//          for example:
+//             [123] + 4 => [1234]
+
+template <class T>
+ChunkedStack<T> operator +(ChunkedStack<T> &first, ChunkedStack<T> &second);
+// EFFECTS: returns a new stack which is the result of appending stack first
+//          by another stack second.
+//          for example:
+//             [123] + [45] => [12345]
+
+
+#include "my_chunked_stack_impl.h"
+
+#endif //MY_CHUNKED_STACK_H
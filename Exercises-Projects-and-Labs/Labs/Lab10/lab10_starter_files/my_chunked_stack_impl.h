@@ -0,0 +1,223 @@
+/*
+ * The implementation of ChunkedStack in my_chunked_stack.h.
+ */
+
+#ifndef MY_CHUNKED_STACK_IMPL_H
+#define MY_CHUNKED_STACK_IMPL_H
+
+#include <iostream>
+#include <new>
+#include <utility>
+#include <vector>
+#include "my_chunked_stack.h"
+
+
+template <class T>
+T *ChunkedStack<T>::slots(Block *block) const
+{
+    return reinterpret_cast<T *>(block->slots);
+}
+
+template <class T>
+void ChunkedStack<T>::removeAll()
+{
+    while (head) {
+        T *first = slots(head);
+        while (next != first) {
+            (--next)->~T();
+        }
+        Block *below = head->below;
+        delete head;
+        head = below;
+        next = head ? slots(head) + CAPACITY : NULL;
+    }
+    count = 0;
+}
+
+template <class T>
+void ChunkedStack<T>::copyFrom(const ChunkedStack &s)
+{
+    removeAll();
+    // The blocks of s from its bottom, which are full but for the top one
+    std::vector<Block *> blocks;
+    for (Block *block = s.head; block; block = block->below) {
+        blocks.push_back(block);
+    }
+    try {
+        for (size_t i = blocks.size(); i-- > 0;) {
+            T *first = slots(blocks[i]), *last = i == 0 ? s.next : first + CAPACITY;
+            for (T *itr = first; itr != last; ++itr) {
+                push(*itr);
+            }
+        }
+    } catch (...) {
+        removeAll();
+        throw;
+    }
+}
+
+template <class T>
+ChunkedStack<T>::ChunkedStack()
+    : head(NULL), spare(NULL), next(NULL), count(0)
+{
+}
+
+template <class T>
+ChunkedStack<T>::ChunkedStack(const ChunkedStack &s)
+    : head(NULL), spare(NULL), next(NULL), count(0)
+{
+    copyFrom(s);
+}
+
+template <class T>
+ChunkedStack<T>::ChunkedStack(ChunkedStack &&s) noexcept
+    : head(s.head), spare(NULL), next(s.next), count(s.count)
+{
+    s.head = NULL;
+    s.next = NULL;
+    s.count = 0;
+}
+
+template <class T>
+ChunkedStack<T> &ChunkedStack<T>::operator = (const ChunkedStack &s)
+{
+    // Copied aside first, so that this is unchanged if copying throws
+    ChunkedStack copy(s);
+    return *this = std::move(copy);
+}
+
+template <class T>
+ChunkedStack<T> &ChunkedStack<T>::operator = (ChunkedStack &&s) noexcept
+{
+    if (this != &s) {
+        removeAll();
+        head = s.head;
+        next = s.next;
+        count = s.count;
+        s.head = NULL;
+        s.next = NULL;
+        s.count = 0;
+    }
+    return *this;
+}
+
+template <class T>
+ChunkedStack<T>::~ChunkedStack()
+{
+    removeAll();
+    delete spare;
+}
+
+template <class T>
+void ChunkedStack<T>::print()
+{
+    T *last = next;
+    for (Block *block = head; block; block = block->below) {
+        for (T *itr = last; itr != slots(block);) {
+            std::cout << *--itr;
+        }
+        last = block->below ? slots(block->below) + CAPACITY : NULL;
+    }
+    std::cout << "\n";
+}
+
+template <class T>
+bool ChunkedStack<T>::isEmpty() const
+{
+    return count == 0;
+}
+
+template <class T>
+size_t ChunkedStack<T>::size() const
+{
+    return count;
+}
+
+template <class T>
+void ChunkedStack<T>::push(T val)
+{
+    // A new block only when the top one is full, and linked only once the
+    // element is in it, so that a throwing T leaves the stack unchanged
+    Block *block = NULL;
+    T *slot = next;
+    if (!head || next == slots(head) + CAPACITY) {
+        block = spare ? spare : new Block;
+        spare = NULL;
+        slot = slots(block);
+    }
+    try {
+        new (slot) T(std::move(val));
+    } catch (...) {
+        if (block) spare = block;
+        throw;
+    }
+    if (block) {
+        block->below = head;
+        head = block;
+    }
+    next = slot + 1;
+    ++count;
+}
+
+template <class T>
+void ChunkedStack<T>::pop()
+{
+    if (count == 0) throw stackEmpty();
+    (--next)->~T();
+    --count;
+    if (next == slots(head)) {
+        // The emptied block is kept aside, and the one below it is full
+        Block *block = head;
+        head = head->below;
+        delete spare;
+        spare = block;
+        next = head ? slots(head) + CAPACITY : NULL;
+    }
+}
+
+template <class T>
+T ChunkedStack<T>::top() const
+{
+    if (count == 0) throw stackEmpty();
+    return next[-1];
+}
+
+template <class T>
+void reverse(ChunkedStack<T> &s)
+{
+    ChunkedStack<T> reversed;
+    while (!s.isEmpty()) {
+        reversed.push(s.top());
+        s.pop();
+    }
+    s = std::move(reversed);
+}
+
+template <class T>
+ChunkedStack<T> operator +(ChunkedStack<T> &s, T val)
+{
+    ChunkedStack<T> result, reversed(s);
+    reverse(reversed);
+    result.push(val);
+    while (!reversed.isEmpty()) {
+        result.push(reversed.top());
+        reversed.pop();
+    }
+    return result;
+}
+
+template <class T>
+ChunkedStack<T> operator +(ChunkedStack<T> &first, ChunkedStack<T> &second)
+{
+    // second at the bottom, then first above it, each pushed from its bottom
+    ChunkedStack<T> result(second), reversed(first);
+    reverse(reversed);
+    while (!reversed.isEmpty()) {
+        result.push(reversed.top());
+        reversed.pop();
+    }
+    return result;
+}
+
+
+#endif //MY_CHUNKED_STACK_IMPL_H
@@ -0,0 +1,118 @@
+/*
+ * A stack that many threads may push to and pop from at once, without a
+ * lock: a Treiber stack, with hazard pointers to free the popped nodes.
+ */
+
+#ifndef MY_CONCURRENT_STACK_H
+#define MY_CONCURRENT_STACK_H
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+#include "my_stack.h"
+
+
+class tooManyThreads
+// Overview: An exception class, for more than HAZARD_SLOTS threads using
+//           concurrent stacks at once.
+{};
+
+
+const int HAZARD_SLOTS = 128;
+
+struct hazardRecord
+// Overview: The node a thread is reading, which no thread may delete.
+{
+    std::atomic<void *> pointer;
+    std::atomic<bool> owned;
+};
+
+struct retiredNode
+// Overview: A node popped but maybe still read by another thread.
+{
+    void *node;
+    void (*destroy)(void *);
+};
+
+class hazardThread
+// Overview: The hazard record and the retired nodes of a thread, shared by
+//           all its concurrent stacks.
+{
+private:
+    hazardRecord *record;
+    std::vector<retiredNode> retired;
+
+    void scan();
+    // MODIFIES: retired
+    // EFFECTS: destroys the retired nodes no hazard record points to, and
+    //          takes over the nodes left by the threads that exited.
+
+public:
+    hazardThread();
+    // EFFECTS: claims a free hazard record,
+    //          throws an instance of tooManyThreads if there is none.
+    ~hazardThread();
+    // EFFECTS: releases the record, leaving the nodes still in use to the
+    //          next thread that scans.
+
+    void protect(void *node);
+    // EFFECTS: forbids the other threads to destroy node, until the next
+    //          call.
+
+    void retire(void *node, void (*destroy)(void *));
+    // EFFECTS: destroys node once no thread protects it.
+
+    static hazardThread &current();
+    // EFFECTS: returns the hazardThread of the calling thread.
+};
+
+
+template <class T>
+class ConcurrentStack
+// Overview: A list based stack, safe to use from several threads at once.
+//           push and pop retry a compare-and-swap of the head; a popped
+//           node is destroyed only once no pop in progress reads it, which
+//           also rules out the ABA problem.
+{
+
+private:
+    /* Attributes */
+    std::atomic<Node<T> *> head;
+
+    static void destroy(void *node);
+    // EFFECTS: deletes node, a Node<T>.
+
+public:
+
+    ConcurrentStack();
+    // constructor
+    ConcurrentStack(const ConcurrentStack &s) = delete;
+    ConcurrentStack &operator = (const ConcurrentStack &s) = delete;
+    // a copy would not be consistent while other threads use s
+    ~ConcurrentStack();
+    // REQUIRES: no other thread uses this
+    // destructor
+
+
+    /* Methods */
+    bool isEmpty() const;
+    // EFFECTS: returns true if stack is empty, false otherwise, which
+    //          another thread may have changed on return.
+
+    void push(T val);
+    // MODIFIES: this
+    // EFFECTS: inserts val at the top of the stack.
+
+    T pop();
+    // MODIFIES: this
+    // EFFECTS: removes the top element from a non-empty stack and returns it,
+    //          as top and pop at once, since another thread may pop between
+    //          the two;
+    //          in case of empty stack, throws an instance of stackEmpty.
+
+};
+
+
+#include "my_concurrent_stack_impl.h"
+
+#endif //MY_CONCURRENT_STACK_H
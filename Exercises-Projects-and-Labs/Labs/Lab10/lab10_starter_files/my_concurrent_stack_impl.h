@@ -0,0 +1,173 @@
+/*
+ * The implementation of ConcurrentStack in my_concurrent_stack.h.
+ */
+
+#ifndef MY_CONCURRENT_STACK_IMPL_H
+#define MY_CONCURRENT_STACK_IMPL_H
+
+#include <algorithm>
+#include <mutex>
+#include <utility>
+#include "my_concurrent_stack.h"
+
+
+inline hazardRecord *hazardRecords()
+// EFFECTS: returns the HAZARD_SLOTS hazard records of the process.
+{
+    static hazardRecord records[HAZARD_SLOTS];
+    return records;
+}
+
+inline std::mutex &orphanMutex()
+// EFFECTS: returns the lock of orphanNodes.
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+inline std::vector<retiredNode> &orphanNodes()
+// EFFECTS: returns the retired nodes of the threads that exited.
+{
+    static std::vector<retiredNode> nodes;
+    return nodes;
+}
+
+inline hazardThread::hazardThread()
+    : record(NULL)
+{
+    hazardRecord *records = hazardRecords();
+    for (int i = 0; i < HAZARD_SLOTS && !record; i++) {
+        bool owned = false;
+        if (records[i].owned.compare_exchange_strong(owned, true)) record = &records[i];
+    }
+    if (!record) throw tooManyThreads();
+}
+
+inline hazardThread::~hazardThread()
+{
+    record->pointer.store(NULL);
+    scan();
+    if (!retired.empty()) {
+        std::lock_guard<std::mutex> lock(orphanMutex());
+        orphanNodes().insert(orphanNodes().end(), retired.begin(), retired.end());
+    }
+    record->owned.store(false);
+}
+
+inline void hazardThread::scan()
+{
+    {
+        std::unique_lock<std::mutex> lock(orphanMutex(), std::try_to_lock);
+        if (lock.owns_lock()) {
+            retired.insert(retired.end(), orphanNodes().begin(), orphanNodes().end());
+            orphanNodes().clear();
+        }
+    }
+    std::vector<void *> hazards;
+    hazardRecord *records = hazardRecords();
+    for (int i = 0; i < HAZARD_SLOTS; i++) {
+        void *node = records[i].pointer.load();
+        if (node) hazards.push_back(node);
+    }
+    std::sort(hazards.begin(), hazards.end());
+    size_t kept = 0;
+    for (size_t i = 0; i < retired.size(); i++) {
+        if (std::binary_search(hazards.begin(), hazards.end(), retired[i].node)) {
+            retired[kept++] = retired[i];
+        } else {
+            retired[i].destroy(retired[i].node);
+        }
+    }
+    retired.resize(kept);
+}
+
+inline void hazardThread::protect(void *node)
+{
+    record->pointer.store(node);
+}
+
+inline void hazardThread::retire(void *node, void (*destroy)(void *))
+{
+    retiredNode entry = {node, destroy};
+    retired.push_back(entry);
+    // Scanning once in 2 * HAZARD_SLOTS retirements frees at least half of
+    // them each time, as at most HAZARD_SLOTS are protected
+    if (retired.size() >= 2 * (size_t)HAZARD_SLOTS) scan();
+}
+
+inline hazardThread &hazardThread::current()
+{
+    thread_local hazardThread thread;
+    return thread;
+}
+
+
+template <class T>
+void ConcurrentStack<T>::destroy(void *node)
+{
+    delete static_cast<Node<T> *>(node);
+}
+
+template <class T>
+ConcurrentStack<T>::ConcurrentStack()
+    : head(NULL)
+{
+}
+
+template <class T>
+ConcurrentStack<T>::~ConcurrentStack()
+{
+    Node<T> *node = head.load();
+    while (node) {
+        Node<T> *next = node->next;
+        delete node;
+        node = next;
+    }
+}
+
+template <class T>
+bool ConcurrentStack<T>::isEmpty() const
+{
+    return head.load() == NULL;
+}
+
+template <class T>
+void ConcurrentStack<T>::push(T val)
+{
+    Node<T> *node = new Node<T>;
+    node->val = std::move(val);
+    node->next = head.load(std::memory_order_relaxed);
+    // On failure, node->next is updated to the current head
+    while (!head.compare_exchange_weak(node->next, node, std::memory_order_release,
+                                       std::memory_order_relaxed)) {
+    }
+}
+
+template <class T>
+T ConcurrentStack<T>::pop()
+{
+    hazardThread &thread = hazardThread::current();
+    Node<T> *node = head.load();
+    while (true) {
+        if (!node) {
+            thread.protect(NULL);
+            throw stackEmpty();
+        }
+        // node is safe to read once it is protected and still the head: a
+        // thread popping it after that sees the protection before deleting
+        thread.protect(node);
+        Node<T> *current = head.load();
+        if (current != node) {
+            node = current;
+            continue;
+        }
+        if (head.compare_exchange_strong(node, node->next)) break;
+    }
+    thread.protect(NULL);
+    T val = std::move(node->val);
+    thread.retire(node, &ConcurrentStack<T>::destroy);
+    return val;
+}
+
+
+#endif //MY_CONCURRENT_STACK_IMPL_H
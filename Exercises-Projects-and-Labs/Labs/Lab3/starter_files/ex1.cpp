@@ -4,26 +4,79 @@
  */
 
 #include <iostream>
+#include <vector>
 
 using namespace std;
 
-const int MAXSIZE = 10;
+const int WINNING_CARD = 280;
+
+void winningPositions(int count, int arr[], bool win[]) {
+    // REQUIRES: win has count elements
+    // MODIFIES: win
+    // EFFECTS: sets win[p] to whether the player can win from the start
+    // position p, for every p at once in O(count)
+    //
+    // A card turned face up can never be chosen again, but this does not
+    // matter: any sequence of moves reaching the winning card can skip the
+    // loop between two visits of the same card, so the player can win from p
+    // exactly when the winning card is reachable from p by the moves p + v
+    // and p - v. The positions reaching it are found by walking the moves
+    // backwards from it, marking each position once, so cycles are no issue.
+
+    // The positions moving to each position p, at from[first[p]] to
+    // from[first[p + 1] - 1]
+    vector<int> first(count + 2, 0), from(2 * count);
+    for (int p = 0; p < count; ++p) {
+        if (p + arr[p] < count) ++first[p + arr[p] + 2];
+        if (p - arr[p] >= 0) ++first[p - arr[p] + 2];
+    }
+    for (int p = 0; p < count; ++p) first[p + 2] += first[p + 1];
+    for (int p = 0; p < count; ++p) {
+        if (p + arr[p] < count) from[first[p + arr[p] + 1]++] = p;
+        if (p - arr[p] >= 0) from[first[p - arr[p] + 1]++] = p;
+    }
+
+    vector<int> queue;
+    for (int p = 0; p < count; ++p) {
+        win[p] = arr[p] == WINNING_CARD;
+        if (win[p]) queue.push_back(p);
+    }
+    for (size_t i = 0; i < queue.size(); ++i) {
+        int p = queue[i];
+        for (int j = first[p]; j < first[p + 1]; ++j) {
+            if (!win[from[j]]) {
+                win[from[j]] = true;
+                queue.push_back(from[j]);
+            }
+        }
+    }
+}
 
 bool canWin(int count, int arr[], int position) {
     // EFFECTS: return whether the player can win given the start position
     // and the card sequence
-    
-    // TODO: implement this function
+    bool *win = new bool[count];
+    winningPositions(count, arr, win);
+    bool result = win[position];
+    delete[] win;
+    return result;
 }
 
 int main() {
+    // Any number of cards, then any number of start positions, each answered
+    // from the same pass over the sequence
     int count;
     cin >> count;
-    int arr[MAXSIZE];
+    vector<int> arr(count);
     for (int i = 0; i < count; ++i) {
         cin >> arr[i];
     }
+    bool *win = new bool[count];
+    winningPositions(count, arr.data(), win);
     int position;
-    cin >> position;
-    cout << canWin(count, arr, position);
-}
\ No newline at end of file
+    for (bool first = true; cin >> position; first = false) {
+        if (!first) cout << endl;
+        cout << win[position];
+    }
+    delete[] win;
+}
@@ -7,19 +7,20 @@ using namespace std;
 
 int fold (int count, int arr[], int (*fn) (int, int), int initial) {
     // EFFECTS: returns the result of the fold function
-    // TODO: implement this function recursively
+    return fold_loop(count, arr, fn, initial);
 }
 
 
 int fn_add (int a, int b) {
-    // TODO: implement this function such that fold(count, arr, fn_add, 0)
-    // returns the sum of all the elements in arr
-    
+    // EFFECTS: fold(count, arr, fn_add, 0) returns the sum of all the
+    // elements in arr
+    return FnAdd()(a, b);
 }
 
 
 int fn_count_odd (int a, int n) {
-    // TODO: implement this function such that fold(n,arr,fn_count_odd, 0)
-    // returns the numebr of odd numbers in the array
+    // EFFECTS: fold(n, arr, fn_count_odd, 0) returns the number of odd
+    // numbers in the array
+    return FnCountOdd()(a, n);
 }
 
@@ -1,8 +1,98 @@
 #ifndef EX2_H
 #define EX2_H
 
+#include <future>
+#include <thread>
+
 int fold (int count, int arr[], int (*fn) (int, int), int initial);
 int fn_add (int a, int b);
 int fn_count_odd(int a, int b);
 
-#endif
\ No newline at end of file
+// fn_add and fn_count_odd as callables, which the fold template inlines
+struct FnAdd {
+    int operator() (int a, int b) const { return a + b; }
+};
+
+struct FnCountOdd {
+    int operator() (int a, int n) const { return n + (a % 2 != 0); }
+};
+
+// How the folds of two parts of an array combine, for the functions whose
+// fold may be split: fold(arr, fn, initial) is combine(initial, the folds of
+// the parts from identity, combined in order). A function without it is
+// folded by a single loop.
+template <typename Fn>
+struct fold_reduction {
+    static const bool splittable = false;
+};
+
+template <>
+struct fold_reduction<FnAdd> {
+    static const bool splittable = true;
+    static int identity() { return 0; }
+    static int combine(int a, int b) { return a + b; }
+};
+
+template <>
+struct fold_reduction<FnCountOdd> {
+    static const bool splittable = true;
+    static int identity() { return 0; }
+    static int combine(int a, int b) { return a + b; }
+};
+
+// The number of elements below which a part of a fold is not split
+const int FOLD_PARALLEL_CUTOFF = 1 << 16;
+
+template <typename Fn>
+int fold_loop(int count, const int arr[], Fn fn, int initial) {
+    // EFFECTS: returns the fold of arr, in one loop that inlines fn, which
+    // the compiler vectorizes when fn is a simple arithmetic operation
+    int result = initial;
+    for (int i = 0; i < count; ++i) {
+        result = fn(arr[i], result);
+    }
+    return result;
+}
+
+template <typename Fn>
+int fold_tree(int count, const int arr[], Fn fn, unsigned int threads) {
+    // REQUIRES: fold_reduction<Fn>::splittable, threads >= 1
+    // EFFECTS: returns the fold of arr from the identity, folding its two
+    // halves in parallel while there are threads for them and the halves
+    // have at least FOLD_PARALLEL_CUTOFF elements, and combining the folds of
+    // the halves up the tree
+    typedef fold_reduction<Fn> reduction;
+    if (threads < 2 || count < 2 * FOLD_PARALLEL_CUTOFF) {
+        return fold_loop(count, arr, fn, reduction::identity());
+    }
+    int half = count / 2;
+    std::future<int> left = std::async(std::launch::async, fold_tree<Fn>, half, arr, fn, threads / 2);
+    int right = fold_tree(count - half, arr + half, fn, threads - threads / 2);
+    return reduction::combine(left.get(), right);
+}
+
+template <typename Fn, bool splittable = fold_reduction<Fn>::splittable>
+struct fold_dispatch {
+    static int fold(int count, const int arr[], Fn fn, int initial) {
+        return fold_loop(count, arr, fn, initial);
+    }
+};
+
+template <typename Fn>
+struct fold_dispatch<Fn, true> {
+    static int fold(int count, const int arr[], Fn fn, int initial) {
+        typedef fold_reduction<Fn> reduction;
+        unsigned int threads = std::thread::hardware_concurrency();
+        if (threads < 2 || count < 2 * FOLD_PARALLEL_CUTOFF) return fold_loop(count, arr, fn, initial);
+        return reduction::combine(initial, fold_tree(count, arr, fn, threads));
+    }
+};
+
+template <typename Fn>
+int fold (int count, int arr[], Fn fn, int initial) {
+    // EFFECTS: returns the result of the fold function, with any callable fn,
+    // splitting the large arrays across threads when fn has a fold_reduction
+    return fold_dispatch<Fn>::fold(count, arr, fn, initial);
+}
+
+#endif
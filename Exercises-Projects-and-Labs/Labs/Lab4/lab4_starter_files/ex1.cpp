@@ -7,6 +7,7 @@
 
 #include <iostream>
 #include <cstdlib>
+#include <string>
 using namespace std;
 
 // Classes for exception types. They are just dummy types for you to use when
@@ -14,26 +15,37 @@ using namespace std;
 class MARKET1_CLOSED{};
 class MARKET2_CLOSED{};
 
+// What one apple pie needs.
+const float FLOUR_PER_PIE = 250;
+const int EGGS_PER_PIE = 1;
+const int APPLES_PER_PIE = 2;
+
 
 // EFFECTS: Check whether there is enough flour in market1. If not, throw
 //          how much flour you still want.
 void buy_flour(int num_pies, float flour_remain)
 {
-    // TODO:
+    float flour_needed = FLOUR_PER_PIE * num_pies;
+    if (flour_remain < flour_needed)
+        throw flour_needed - flour_remain;
 }
 
 // EFFECTS: Check whether there are enough eggs in market1. If not, throw
 //          how many eggs you still want.
 void buy_eggs(int num_pies, int eggs_remain)
 {
-    // TODO:
+    int eggs_needed = EGGS_PER_PIE * num_pies;
+    if (eggs_remain < eggs_needed)
+        throw eggs_needed - eggs_remain;
 }
 
 // EFFECTS: Check whether there are enough apples in market2. If not, throw
 //          how many apples you still want.
 void buy_apples(int num_pies, int apples_remain)
 {
-    // TODO:
+    int apples_needed = APPLES_PER_PIE * num_pies;
+    if (apples_remain < apples_needed)
+        throw apples_needed - apples_remain;
 }
 
 // EFFECTS: Check if market1 is open. If it is open, then go on to buy flour 
@@ -43,17 +55,113 @@ void buy_apples(int num_pies, int apples_remain)
 //          if market1 is open.
 void visit_market1(bool market1_status, int num_pies, float flour_remain, int eggs_remain)
 {
-    // TODO:
+    if (!market1_status)
+        throw MARKET1_CLOSED();
+    buy_flour(num_pies, flour_remain);
+    buy_eggs(num_pies, eggs_remain);
 }
 
 // EFFECTS: Check if market2 is open. If it is open, then go on to buy apples.
 //          If it is closed, throw an exception of "MARKET2_CLOSED" type.
 void visit_market2(bool market2_status, int num_pies, int apples_remain)
 {
-    // TODO:
+    if (!market2_status)
+        throw MARKET2_CLOSED();
+    buy_apples(num_pies, apples_remain);
 }
 
 
+// The outcome of an order, which check_order returns rather than throwing
+// it, so that a batch of orders does not unwind the stack for each failing one.
+enum order_status
+{
+    ORDER_OK,
+    ORDER_MARKET1_CLOSED,
+    ORDER_FLOUR_SHORT,
+    ORDER_EGGS_SHORT,
+    ORDER_MARKET2_CLOSED,
+    ORDER_APPLES_SHORT
+};
+
+// The program arguments of one run, as one order.
+struct order
+{
+    int num_pies;
+    bool market1_status;
+    bool market2_status;
+    float flour_remain;
+    int eggs_remain;
+    int apples_remain;
+};
+
+struct order_result
+{
+    order_status status;
+    float shortfall;    // what is still needed, for the shortage statuses
+};
+
+// EFFECTS: Returns what visit_market1 and then visit_market2 would throw for
+//          the order, in the same order of checks, or ORDER_OK.
+order_result check_order(const order &o)
+{
+    // Every quantity is computed up front, and only the first failing check
+    // is picked, so that the checks compile to selects rather than branches
+    float flour_short = FLOUR_PER_PIE * o.num_pies - o.flour_remain;
+    int eggs_short = EGGS_PER_PIE * o.num_pies - o.eggs_remain;
+    int apples_short = APPLES_PER_PIE * o.num_pies - o.apples_remain;
+    order_result result = {ORDER_OK, 0};
+    if (!o.market1_status) result.status = ORDER_MARKET1_CLOSED;
+    else if (flour_short > 0) result.status = ORDER_FLOUR_SHORT, result.shortfall = flour_short;
+    else if (eggs_short > 0) result.status = ORDER_EGGS_SHORT, result.shortfall = eggs_short;
+    else if (!o.market2_status) result.status = ORDER_MARKET2_CLOSED;
+    else if (apples_short > 0) result.status = ORDER_APPLES_SHORT, result.shortfall = apples_short;
+    return result;
+}
+
+// REQUIRES: orders and results have count elements
+// MODIFIES: results
+// EFFECTS: Checks every order, results[i] being the outcome of orders[i].
+void check_orders(const order orders[], int count, order_result results[])
+{
+    for (int i = 0; i < count; i++)
+        results[i] = check_order(orders[i]);
+}
+
+// EFFECTS: Reads orders from stdin, 6 numbers each as in the program
+//          arguments, until its end, and prints the outcome of each on a line:
+//          "ok", "market1_closed", "market2_closed", or the missing
+//          ingredient and how much of it is still needed.
+int run_batch()
+{
+    const char *names[] = {"ok", "market1_closed", "flour", "eggs", "market2_closed", "apples"};
+    const int BATCH = 4096;
+    order orders[BATCH];
+    order_result results[BATCH];
+    ios::sync_with_stdio(false);
+    while (cin)
+    {
+        // The orders are checked a batch at a time, as they are read
+        int count = 0;
+        for (; count < BATCH; count++)
+        {
+            order &o = orders[count];
+            if (!(cin >> o.num_pies >> o.market1_status >> o.market2_status
+                      >> o.flour_remain >> o.eggs_remain >> o.apples_remain))
+                break;
+        }
+        check_orders(orders, count, results);
+        for (int i = 0; i < count; i++)
+        {
+            cout << names[results[i].status];
+            if (results[i].status == ORDER_FLOUR_SHORT || results[i].status == ORDER_EGGS_SHORT
+                || results[i].status == ORDER_APPLES_SHORT)
+                cout << " " << results[i].shortfall;
+            cout << "\n";
+        }
+    }
+    return 0;
+}
+
 
 int main(int argc, char* argv[])
 {
@@ -65,9 +173,22 @@ int main(int argc, char* argv[])
     int apples_remain;      // number of apples remaining in market2.
     
 
-    // TODO: 
-    // Read all the above parameters from the program arguments
+    if (argc == 2 && string(argv[1]) == "--batch")
+        return run_batch();
 
+    if (argc < 7)
+    {
+        cout << "Usage: " << argv[0] << " num_pies market1_status market2_status"
+             << " flour_remain eggs_remain apples_remain" << endl;
+        cout << "   or: " << argv[0] << " --batch < orders" << endl;
+        return 1;
+    }
+    num_pies = atoi(argv[1]);
+    market1_status = atoi(argv[2]);
+    market2_status = atoi(argv[3]);
+    flour_remain = atof(argv[4]);
+    eggs_remain = atoi(argv[5]);
+    apples_remain = atoi(argv[6]);
     
     bool flag = 1;  // If any expception happens, flag will be changed to 0.
 
@@ -77,39 +198,39 @@ int main(int argc, char* argv[])
     cout << "You visit market1 first..." << endl;
     try 
     {
-        // TODO:
+        visit_market1(market1_status, num_pies, flour_remain, eggs_remain);
 
         cout << "You've bought enough flour and eggs. Then you visit market2..." << endl;
         try
         {
-            // TODO:
+            visit_market2(market2_status, num_pies, apples_remain);
 
             cout << "You've also bought enough apples! You can go home and make the pies now!" << endl;
         }
-        catch( /* TODO: */ )
+        catch(MARKET2_CLOSED)
         {
             cout << "market2 is closed!" << endl;
             flag = 0;
         }
-        catch( /* TODO: */ )
+        catch(int apples_short)
         {
-            cout << "Apples in market2 are not enough. You still need " << /* TODO: */ << " more." << endl;
+            cout << "Apples in market2 are not enough. You still need " << apples_short << " more." << endl;
             flag = 0;
         }  
     }
-    catch( /* TODO: */ )
+    catch(MARKET1_CLOSED)
     {
         cout << "market1 is closed!" << endl;
         flag = 0;
     }
-    catch( /* TODO: */ )
+    catch(float flour_short)
     {
-        cout << "Flour in market1 is not enough. You still need " << /* TODO: */ << " grams more." << endl;
+        cout << "Flour in market1 is not enough. You still need " << flour_short << " grams more." << endl;
         flag = 0;
     }
-    catch( /* TODO: */ )
+    catch(int eggs_short)
     {
-        cout << "Eggs in market1 are not enough. You still need " << /* TODO: */ << " more." << endl;
+        cout << "Eggs in market1 are not enough. You still need " << eggs_short << " more." << endl;
         flag = 0;
     }
 
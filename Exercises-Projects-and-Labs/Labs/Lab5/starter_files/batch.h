@@ -0,0 +1,46 @@
+//
+// Splitting a batch of points across threads, for the batch evaluate of
+// both forms of quadraticFunction.
+//
+
+#ifndef LAB5_BATCH_H
+#define LAB5_BATCH_H
+
+#include <algorithm>
+#include <future>
+#include <thread>
+#include <vector>
+
+const int BATCH_PARALLEL_CUTOFF = 1 << 18;
+// The fewest points a thread is given. A batch that is not large enough for
+// two threads runs on the calling thread, where it costs memory bandwidth
+// rather than the start of a thread
+
+template <typename Fn>
+void forEachRange(int count, Fn fn)
+// EFFECTS: calls fn(begin, end) on ranges that together cover 0 to count,
+// one range for each thread the hardware has while each gets at least
+// BATCH_PARALLEL_CUTOFF points. The ranges start at multiples of 16 points,
+// so no two threads write the same cache line of floats, and the last one
+// runs on the calling thread
+{
+    int threads = (int) std::thread::hardware_concurrency();
+    int ranges = std::min(threads, count / BATCH_PARALLEL_CUTOFF);
+    if (ranges < 2) {
+        fn(0, count);
+        return;
+    }
+    std::vector<std::future<void> > others;
+    int begin = 0;
+    for (int i = 1; i < ranges; i++) {
+        int end = (int) ((long long) count * i / ranges) & ~15;
+        others.push_back(std::async(std::launch::async, fn, begin, end));
+        begin = end;
+    }
+    fn(begin, count);
+    for (auto &other : others) {
+        other.get();
+    }
+}
+
+#endif //LAB5_BATCH_H
@@ -3,6 +3,7 @@
 //
 
 #include "factoredForm.h"
+#include "batch.h"
 
 quadraticFunction::quadraticFunction(float a_in, float b_in, float c_in){}
 // TODO: implement this constructor
@@ -23,6 +24,18 @@ float quadraticFunction::evaluate(float x) {
     // TODO: implement this function
 }
 
+void quadraticFunction::evaluate(int count, const float x[], float y[]) const {
+    // f(x) = a(x - r1)(x - r2). As the roots are real or conjugate, its
+    // imaginary part is 0, and it is a((x - p1)(x - p2) - q1 q2) for the
+    // real parts p and imaginary parts q of the roots
+    float a = this->a, p1 = r1.real, p2 = r2.real, q = r1.imaginary * r2.imaginary;
+    forEachRange(count, [=](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            y[i] = a * ((x[i] - p1) * (x[i] - p2) - q);
+        }
+    });
+}
+
 root quadraticFunction::getRoot() {
     // TODO: implement this function
 }
@@ -30,6 +30,13 @@ public:
     float evaluate(float x);
     // EFFECTS: returns the value of f(x)
 
+    void evaluate(int count, const float x[], float y[]) const;
+    // REQUIRES: x and y have count elements, and are the same array or do
+    //           not overlap
+    // MODIFIES: y
+    // EFFECTS: writes f(x[i]) to y[i] for each i, over several threads for
+    //          a large count
+
     root getRoot();
     // EFFECTS: returns the roots of the quadratic function
 
@@ -4,9 +4,44 @@
 
 #include <cmath>
 #include "standardForm.h"
+#include "batch.h"
 
-quadraticFunction::quadraticFunction(float a_in, float b_in, float c_in){}
-// TODO: implement this constructor
+static inline double discriminant(double a, double b, double c)
+// EFFECTS: returns b^2 - 4ac. The products of floats are exact in double, so
+//          its sign is right even when b^2 and 4ac nearly cancel
+{
+    return b * b - 4 * a * c;
+}
+
+static inline int intersects(double a, double b, double c)
+// EFFECTS: returns whether ax^2 + bx + c has a real root, for any a
+{
+    // Without branches, so that countIntersections vectorizes
+    return ((a != 0) & (discriminant(a, b, c) >= 0)) | ((a == 0) & ((b != 0) | (c == 0)));
+}
+
+static inline void solve(float a, float b, float c,
+                         float &real1, float &real2, float &imaginary, unsigned int &realRootNum)
+// REQUIRES: a is not 0
+// MODIFIES: real1, real2, imaginary, realRootNum
+// EFFECTS: solves ax^2 + bx + c = 0, as described by getRoots
+{
+    double delta = discriminant(a, b, c);
+    double s = std::sqrt(std::fabs(delta));
+    // -b - sign(b)sqrt(delta) adds numbers of the same sign, so there is no
+    // cancellation, and the other root comes from x1 * x2 = c / a. q is 0
+    // only when b and c are, and both roots are 0
+    double q = -0.5 * (b + std::copysign(s, (double)b));
+    double x1 = q / a, x2 = q != 0 ? c / q : 0;
+    double m = -0.5 * b / a;
+    real1 = delta > 0 ? std::fmin(x1, x2) : m;
+    real2 = delta > 0 ? std::fmax(x1, x2) : m;
+    imaginary = delta < 0 ? 0.5 * s / std::fabs(a) : 0;
+    realRootNum = (delta > 0) + (delta >= 0);
+}
+
+quadraticFunction::quadraticFunction(float a_in, float b_in, float c_in)
+    : a(a_in), b(b_in), c(c_in) {}
 
 float quadraticFunction::getA() const {
     return a;
@@ -21,13 +56,55 @@ float quadraticFunction::getC() const {
 }
 
 float quadraticFunction::evaluate(float x) {
-    // TODO: implement this function
+    return (a * x + b) * x + c;
+}
+
+void quadraticFunction::evaluate(int count, const float x[], float y[]) const {
+    float a = this->a, b = this->b, c = this->c;
+    forEachRange(count, [=](int begin, int end) {
+        // Horner's form, with the coefficients in registers, a loop gcc
+        // vectorizes at -O3
+        for (int i = begin; i < end; i++) {
+            y[i] = (a * x[i] + b) * x[i] + c;
+        }
+    });
 }
 
 root quadraticFunction::getRoot() {
-    // TODO: implement this function
+    root result;
+    float imaginary;
+    solve(a, b, c, result.roots[0].real, result.roots[1].real, imaginary, result.realRootNum);
+    // 0 rather than -0 for the real roots
+    result.roots[0].imaginary = imaginary > 0 ? -imaginary : 0;
+    result.roots[1].imaginary = imaginary;
+    return result;
 }
 
 int quadraticFunction::intersect(quadraticFunction g){
-    // TODO: implement this function
-}
\ No newline at end of file
+    // f(x) = g(x) is (a - g.a)x^2 + (b - g.b)x + (c - g.c) = 0
+    return intersects((double)a - g.a, (double)b - g.b, (double)c - g.c);
+}
+
+void getRoots(int count, const float a[], const float b[], const float c[],
+              float real1[], float real2[], float imaginary[], unsigned int realRootNum[])
+{
+    for (int i = 0; i < count; i++) {
+        solve(a[i], b[i], c[i], real1[i], real2[i], imaginary[i], realRootNum[i]);
+    }
+}
+
+long long countIntersections(int count, const float a[], const float b[], const float c[])
+{
+    long long total = 0;
+    for (int i = 0; i < count; i++) {
+        // The count has the width of a double, so that the loop over j
+        // vectorizes
+        double ai = a[i], bi = b[i], ci = c[i];
+        long long n = 0;
+        for (int j = i + 1; j < count; j++) {
+            n += intersects(ai - a[j], bi - b[j], ci - c[j]);
+        }
+        total += n;
+    }
+    return total;
+}
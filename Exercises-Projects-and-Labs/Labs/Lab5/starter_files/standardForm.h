@@ -30,6 +30,13 @@ public:
     float evaluate(float x);
     // EFFECTS: returns the value of f(x)
 
+    void evaluate(int count, const float x[], float y[]) const;
+    // REQUIRES: x and y have count elements, and are the same array or do
+    //           not overlap
+    // MODIFIES: y
+    // EFFECTS: writes f(x[i]) to y[i] for each i, as evaluate(x[i]) returns
+    //          it, over several threads for a large count
+
     root getRoot();
     // EFFECTS: returns the roots of the quadratic function
 
@@ -39,5 +46,21 @@ public:
     // if false, return 0
 };
 
+// Batches of quadratic functions, as the arrays of their a, b and c, so that
+// the same operation runs over consecutive values of each coefficient
+
+void getRoots(int count, const float a[], const float b[], const float c[],
+              float real1[], float real2[], float imaginary[], unsigned int realRootNum[]);
+// REQUIRES: a[i] is not 0, every array has count elements
+// MODIFIES: real1, real2, imaginary, realRootNum
+// EFFECTS: writes the roots of each a[i]x^2 + b[i]x + c[i] as getRoot
+//          returns them: roots[0] is real1[i] - imaginary[i]i and roots[1]
+//          is real2[i] + imaginary[i]i, with imaginary[i] >= 0
+
+long long countIntersections(int count, const float a[], const float b[], const float c[]);
+// REQUIRES: a[i] is not 0, every array has count elements
+// EFFECTS: returns the number of pairs i < j such that the functions i and
+//          j intersect
+
 
 #endif //LAB5_STANDARDFORM_H
@@ -0,0 +1,267 @@
+#include <cstdlib>
+#include <cstring>
+#include <unordered_map>
+#include "flatAst.h"
+
+using namespace std;
+
+static const char *const KIND_NAMES[NODE_KIND_NUM] = {
+    "ProgramNode", "DeclListNode", "VarDeclNode", "FnDeclNode", "FormalDeclNode",
+    "FormalsListNode", "FnBodyNode", "StmtListNode", "IntNode", "BoolNode", "VoidNode",
+    "AssignStmtNode", "PostIncStmtNode", "PostDecStmtNode", "IntLitNode", "TrueNode",
+    "FalseNode", "IdNode", "AssignNode",
+};
+
+// The abstract classes of ex1.cpp, as sets of kinds
+static const unsigned int TYPE = 1u << INT_NODE | 1u << BOOL_NODE | 1u << VOID_NODE;
+static const unsigned int DECL = 1u << VAR_DECL_NODE | 1u << FN_DECL_NODE;
+static const unsigned int STMT = 1u << ASSIGN_STMT_NODE | 1u << POST_INC_STMT_NODE | 1u << POST_DEC_STMT_NODE;
+static const unsigned int EXP = 1u << INT_LIT_NODE | 1u << TRUE_NODE | 1u << FALSE_NODE | 1u << ID_NODE
+                                | 1u << ASSIGN_NODE;
+
+struct Shape {
+    int childNum;               // -1 for a list of any length
+    unsigned int child[4];      // the kinds each child may be; child[0] for every item of a list
+};
+
+// The children column of the class description, indexed by NodeKind
+static const Shape SHAPES[NODE_KIND_NUM] = {
+    {1, {1u << DECL_LIST_NODE}},
+    {-1, {DECL}},
+    {2, {TYPE, 1u << ID_NODE}},
+    {4, {TYPE, 1u << ID_NODE, 1u << FORMALS_LIST_NODE, 1u << FN_BODY_NODE}},
+    {2, {TYPE, 1u << ID_NODE}},
+    {-1, {1u << FORMAL_DECL_NODE}},
+    {2, {1u << DECL_LIST_NODE, 1u << STMT_LIST_NODE}},
+    {-1, {STMT}},
+    {0, {0}}, {0, {0}}, {0, {0}},
+    {1, {1u << ASSIGN_NODE}},
+    {1, {EXP}},
+    {1, {EXP}},
+    {0, {0}}, {0, {0}}, {0, {0}}, {0, {0}},
+    {2, {EXP, EXP}},
+};
+
+static int kindhelper(const char *word, size_t length)
+// EFFECTS: return the NodeKind named word, or -1 if none
+{
+    for (int k = 0; k < NODE_KIND_NUM; k++) {
+        if (strncmp(KIND_NAMES[k], word, length) == 0 && KIND_NAMES[k][length] == '\0') return k;
+    }
+    return -1;
+}
+
+static void indenthelper(int indent, string &out) {
+    out.append(indent, ' ');
+}
+
+const char *FlatAst::kindName(NodeKind k) {
+    return KIND_NAMES[k];
+}
+
+bool FlatAst::read(istream &in) {
+    kind.clear();
+    childNum.clear();
+    first.clear();
+    value.clear();
+    names.clear();
+
+    // The whole input at once, then split in place
+    string text;
+    char buffer[1 << 16];
+    while (in.read(buffer, sizeof(buffer)) || in.gcount() > 0) text.append(buffer, (size_t) in.gcount());
+    const char *p = text.c_str(), *end = p + text.size();
+
+    // A token ends at a space or a '#'; a comment runs to the end of its line
+    auto skip = [&](bool lineToo) {
+        while (p < end) {
+            if (*p == '#') {
+                while (p < end && *p != '\n') p++;
+            } else if (*p == ' ' || *p == '\t' || *p == '\r' || (lineToo && *p == '\n')) {
+                p++;
+            } else {
+                break;
+            }
+        }
+    };
+    auto lineEnd = [&]() {
+        return p == end || *p == '\n';
+    };
+    auto token = [&](size_t &length) {
+        const char *start = p;
+        while (p < end && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n' && *p != '#') p++;
+        length = (size_t) (p - start);
+        return start;
+    };
+
+    skip(true);
+    char *after;
+    long n = strtol(p, &after, 10);
+    if (after == p || n <= 0) return false;
+    p = after;
+    kind.reserve(n);
+    childNum.reserve(n);
+    first.reserve(n);
+    value.reserve(n);
+
+    unordered_map<string, int> interned;
+    long next = 1;
+    for (long i = 0; i < n; i++) {
+        skip(true);
+        size_t length;
+        const char *word = token(length);
+        int k = kindhelper(word, length);
+        skip(false);
+        if (k < 0 || lineEnd()) break;
+        long num = strtol(p, &after, 10);
+        if (after == p || num < 0 || num > n) break;
+        p = after;
+        skip(false);
+        int v = 0;
+        if ((k == INT_LIT_NODE || k == ID_NODE) && lineEnd()) break;
+        if (k == INT_LIT_NODE) {
+            v = (int) strtol(p, &after, 10);
+            if (after == p) break;
+            p = after;
+        } else if (k == ID_NODE) {
+            const char *name = token(length);
+            if (length == 0) break;
+            auto found = interned.emplace(string(name, length), (int) names.size());
+            v = found.first->second;
+            if (found.second) {
+                names.append(name, length);
+                names.push_back('\0');
+            }
+        }
+        kind.push_back((unsigned char) k);
+        childNum.push_back((int) num);
+        first.push_back((int) next);
+        value.push_back(v);
+        next += num;
+    }
+    // Each node but the root is the child of one node before it
+    bool valid = (long) kind.size() == n && next == n;
+    for (long i = 0; valid && i < n; i++) {
+        valid = childNum[i] == 0 || first[i] > i;
+    }
+    if (!valid) {
+        kind.clear();
+        childNum.clear();
+        first.clear();
+        value.clear();
+        names.clear();
+    }
+    return valid;
+}
+
+int FlatAst::nodeNum() const {
+    return (int) kind.size();
+}
+
+bool FlatAst::childKinds(int i) const {
+    const Shape &shape = SHAPES[kind[i]];
+    if (shape.childNum >= 0 && childNum[i] != shape.childNum) return false;
+    for (int c = 0; c < childNum[i]; c++) {
+        unsigned int allowed = shape.childNum < 0 ? shape.child[0] : shape.child[c];
+        if (!(allowed & 1u << kind[first[i] + c])) return false;
+    }
+    return true;
+}
+
+int FlatAst::check() const {
+    if (nodeNum() > 0 && kind[0] != PROGRAM_NODE) return 0;
+    // One pass in index order: each node reads its own children, which are
+    // next to each other
+    for (int i = 0; i < nodeNum(); i++) {
+        if (!childKinds(i)) return i;
+    }
+    return -1;
+}
+
+void FlatAst::unparse(int i, int indent, string &out) const {
+    int c = first[i];
+    switch (kind[i]) {
+        case PROGRAM_NODE:
+            unparse(c, indent, out);
+            break;
+        case DECL_LIST_NODE:
+        case STMT_LIST_NODE:
+            for (int j = c; j < c + childNum[i]; j++) unparse(j, indent, out);
+            break;
+        case VAR_DECL_NODE:
+            indenthelper(indent, out);
+            unparse(c, indent, out);
+            out += ' ';
+            unparse(c + 1, indent, out);
+            out += ";\n";
+            break;
+        case FN_DECL_NODE:
+            indenthelper(indent, out);
+            unparse(c, indent, out);
+            out += ' ';
+            unparse(c + 1, indent, out);
+            out += '(';
+            unparse(c + 2, indent, out);
+            out += ") {\n";
+            unparse(c + 3, indent, out);
+            indenthelper(indent, out);
+            out += "}\n";
+            break;
+        case FORMAL_DECL_NODE:
+            unparse(c, indent, out);
+            out += ' ';
+            unparse(c + 1, indent, out);
+            break;
+        case FORMALS_LIST_NODE:
+            for (int j = c; j < c + childNum[i]; j++) {
+                if (j > c) out += ", ";
+                unparse(j, indent, out);
+            }
+            break;
+        case FN_BODY_NODE:
+            unparse(c, indent + 4, out);
+            unparse(c + 1, indent + 4, out);
+            break;
+        case INT_NODE:
+            out += "int";
+            break;
+        case BOOL_NODE:
+            out += "bool";
+            break;
+        case VOID_NODE:
+            out += "void";
+            break;
+        case ASSIGN_STMT_NODE:
+            indenthelper(indent, out);
+            unparse(c, indent, out);
+            out += ";\n";
+            break;
+        case POST_INC_STMT_NODE:
+        case POST_DEC_STMT_NODE:
+            indenthelper(indent, out);
+            unparse(c, indent, out);
+            out += kind[i] == POST_INC_STMT_NODE ? "++;\n" : "--;\n";
+            break;
+        case INT_LIT_NODE:
+            out += to_string(value[i]);
+            break;
+        case TRUE_NODE:
+            out += "true";
+            break;
+        case FALSE_NODE:
+            out += "false";
+            break;
+        case ID_NODE:
+            out += names.c_str() + value[i];
+            break;
+        case ASSIGN_NODE:
+            unparse(c, indent, out);
+            out += " = ";
+            unparse(c + 1, indent, out);
+            break;
+    }
+}
+
+void FlatAst::unparse(string &out) const {
+    unparse(0, 0, out);
+}
@@ -0,0 +1,98 @@
+#ifndef LAB6_FLATAST_H
+#define LAB6_FLATAST_H
+
+#include <istream>
+#include <string>
+#include <vector>
+
+// The classes of ex1.cpp that can be made, as a tag
+enum NodeKind {
+    PROGRAM_NODE,
+    DECL_LIST_NODE,
+    VAR_DECL_NODE,
+    FN_DECL_NODE,
+    FORMAL_DECL_NODE,
+    FORMALS_LIST_NODE,
+    FN_BODY_NODE,
+    STMT_LIST_NODE,
+    INT_NODE,
+    BOOL_NODE,
+    VOID_NODE,
+    ASSIGN_STMT_NODE,
+    POST_INC_STMT_NODE,
+    POST_DEC_STMT_NODE,
+    INT_LIT_NODE,
+    TRUE_NODE,
+    FALSE_NODE,
+    ID_NODE,
+    ASSIGN_NODE,
+    NODE_KIND_NUM
+};
+
+class FlatAst {
+    // OVERVIEW: the AST of ex1.cpp with no class per node and no cap on the
+    //           nodes: one array per field, indexed by the nodes in the
+    //           breadth-first order of the input. In that order the
+    //           children of a node are next to each other, after the
+    //           children of the nodes before it, so those of node i are
+    //           [first[i], first[i] + childNum[i]) and no pointer is kept
+private:
+    std::vector<unsigned char> kind;    // the NodeKind of each node
+    std::vector<int> childNum;          // the number of children of each node
+    std::vector<int> first;             // the index of the first child of each node
+    std::vector<int> value;
+    // the value of an IntLitNode, the offset in names of the name of an
+    // IdNode, 0 for the others
+    std::string names;
+    // the names of the IdNodes, each once and ended by '\0', so that two
+    // IdNodes of the same name have the same offset
+
+    void unparse(int i, int indent, std::string &out) const;
+    // REQUIRES: check() == -1
+    // EFFECTS: appends the code of the node at index i to out
+
+    bool childKinds(int i) const;
+    // EFFECTS: return whether the children of node i are as the class
+    //          description of ex1.cpp gives them
+
+public:
+    static const char *kindName(NodeKind k);
+    // EFFECTS: return the class name of k, e.g. "IdNode"
+
+    bool read(std::istream &in);
+    // MODIFIES: this, in
+    // EFFECTS: replace the tree with the one read from in, as the input of
+    //          ex1 gives it: the number of nodes, then one line per node,
+    //          "<NodeType> <ChildNum> [OptionalParam]", where a '#' starts a
+    //          comment. Return false, with the tree empty, on a node of
+    //          unknown type, a missing value or name, or child numbers that
+    //          do not add up to a tree of that many nodes
+
+    int nodeNum() const;
+    // EFFECTS: return the number of nodes
+
+    // For the passes over the tree, which go through the node array in
+    // index order; each REQUIRES: 0 <= i < nodeNum()
+    NodeKind kindOf(int i) const { return (NodeKind) kind[i]; }
+    int childNumOf(int i) const { return childNum[i]; }
+    int child(int i, int c) const { return first[i] + c; }
+    // REQUIRES: 0 <= c < childNumOf(i)
+    int intValue(int i) const { return value[i]; }
+    // REQUIRES: node i is an IntLitNode
+    int nameId(int i) const { return value[i]; }
+    // REQUIRES: node i is an IdNode
+    // EFFECTS: return a number that only IdNodes of the same name share
+    const char *name(int i) const { return names.c_str() + value[i]; }
+    // REQUIRES: node i is an IdNode
+
+    int check() const;
+    // EFFECTS: return the index of the first node whose children do not
+    //          match the class description of ex1.cpp, or -1 if none
+
+    void unparse(std::string &out) const;
+    // REQUIRES: check() == -1 and nodeNum() > 0
+    // EFFECTS: appends the program of the tree to out, as the unparse() of
+    //          ex1 prints it from the root
+};
+
+#endif //LAB6_FLATAST_H
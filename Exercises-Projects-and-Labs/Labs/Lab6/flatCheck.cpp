@@ -0,0 +1,151 @@
+#include <algorithm>
+#include "flatCheck.h"
+
+using namespace std;
+
+static unsigned long long keyhelper(int nameId, int function)
+// EFFECTS: return the key of nameId in the scope of function, -1 for the
+//          file scope
+{
+    return (unsigned long long) (unsigned int) (function + 1) << 32 | (unsigned int) nameId;
+}
+
+static const char *typehelper(NodeKind type)
+// EFFECTS: return the keyword of a TypeNode kind, "" if not one
+{
+    return type == INT_NODE ? "int" : type == BOOL_NODE ? "bool" : type == VOID_NODE ? "void" : "";
+}
+
+DeclPass::DeclPass(const FlatAst &ast) : ast(ast), function(ast.nodeNum(), -1) {}
+
+void DeclPass::visit(int i, vector<Diagnostic> &out) {
+    NodeKind k = ast.kindOf(i);
+    // The children of this node are in the function this node is in, or in
+    // this node if it is the function
+    int inside = k == FN_DECL_NODE ? i : function[i];
+    for (int c = 0; c < ast.childNumOf(i); c++) function[ast.child(i, c)] = inside;
+
+    if (k != VAR_DECL_NODE && k != FORMAL_DECL_NODE && k != FN_DECL_NODE) return;
+    int id = ast.child(i, 1);
+    Declaration d = {ast.kindOf(ast.child(i, 0)), k == FN_DECL_NODE, i};
+    auto found = index.emplace(keyhelper(ast.nameId(id), function[i]), (int) declarations.size());
+    if (found.second) {
+        declarations.push_back(d);
+    } else {
+        out.push_back(Diagnostic{i, string(ast.name(id)) + " redeclared"});
+    }
+}
+
+int DeclPass::functionOf(int i) const {
+    return function[i];
+}
+
+const DeclPass::Declaration *DeclPass::lookup(int nameId, int fn) const {
+    auto found = index.find(keyhelper(nameId, fn));
+    if (found == index.end() && fn >= 0) found = index.find(keyhelper(nameId, -1));
+    return found == index.end() ? NULL : &declarations[found->second];
+}
+
+int DeclPass::declarationNum() const {
+    return (int) declarations.size();
+}
+
+TypePass::TypePass(const FlatAst &ast, const DeclPass &decls) : ast(ast), decls(decls) {}
+
+NodeKind TypePass::typeOf(int e, int function) const {
+    // An assignment has the type of its variable, so this follows the left
+    // children only, and does not recurse into the tree
+    while (ast.kindOf(e) == ASSIGN_NODE) e = ast.child(e, 0);
+    switch (ast.kindOf(e)) {
+        case INT_LIT_NODE:
+            return INT_NODE;
+        case TRUE_NODE:
+        case FALSE_NODE:
+            return BOOL_NODE;
+        case ID_NODE: {
+            const DeclPass::Declaration *d = decls.lookup(ast.nameId(e), function);
+            return d && !d->function ? d->type : NODE_KIND_NUM;
+        }
+        default:
+            return NODE_KIND_NUM;
+    }
+}
+
+void TypePass::visit(int i, vector<Diagnostic> &out) {
+    NodeKind k = ast.kindOf(i);
+    if (k == VAR_DECL_NODE || k == FORMAL_DECL_NODE) {
+        if (ast.kindOf(ast.child(i, 0)) == VOID_NODE) {
+            out.push_back(Diagnostic{i, string(k == VAR_DECL_NODE ? "variable " : "parameter ")
+                                        + ast.name(ast.child(i, 1)) + " declared void"});
+        }
+        return;
+    }
+    if (k != ASSIGN_NODE) return;
+    int function = decls.functionOf(i);
+    int lhs = ast.child(i, 0), rhs = ast.child(i, 1);
+    const DeclPass::Declaration *target = NULL;
+    if (ast.kindOf(lhs) != ID_NODE) {
+        out.push_back(Diagnostic{i, "assignment to an expression"});
+    } else if (!(target = decls.lookup(ast.nameId(lhs), function))) {
+        out.push_back(Diagnostic{i, string(ast.name(lhs)) + " undeclared"});
+    } else if (target->function) {
+        out.push_back(Diagnostic{i, string("assignment to function ") + ast.name(lhs)});
+        target = NULL;
+    }
+    if (ast.kindOf(rhs) == ID_NODE) {
+        const DeclPass::Declaration *d = decls.lookup(ast.nameId(rhs), function);
+        if (!d) out.push_back(Diagnostic{i, string(ast.name(rhs)) + " undeclared"});
+        else if (d->function) out.push_back(Diagnostic{i, string("function ") + ast.name(rhs) + " used as a value"});
+    }
+    NodeKind type = typeOf(rhs, function);
+    if (target && type != NODE_KIND_NUM && type != target->type) {
+        out.push_back(Diagnostic{i, string("assigning ") + typehelper(type) + " to "
+                                    + typehelper(target->type) + " " + ast.name(lhs)});
+    }
+}
+
+IncPass::IncPass(const FlatAst &ast, const DeclPass &decls) : ast(ast), decls(decls) {}
+
+void IncPass::visit(int i, vector<Diagnostic> &out) {
+    NodeKind k = ast.kindOf(i);
+    if (k != POST_INC_STMT_NODE && k != POST_DEC_STMT_NODE) return;
+    string op = k == POST_INC_STMT_NODE ? "++" : "--";
+    int e = ast.child(i, 0);
+    if (ast.kindOf(e) != ID_NODE) {
+        out.push_back(Diagnostic{i, op + " of an expression"});
+        return;
+    }
+    const DeclPass::Declaration *d = decls.lookup(ast.nameId(e), decls.functionOf(i));
+    if (!d) out.push_back(Diagnostic{i, string(ast.name(e)) + " undeclared"});
+    else if (d->function) out.push_back(Diagnostic{i, op + " of function " + ast.name(e)});
+    else if (d->type != INT_NODE) out.push_back(Diagnostic{i, op + " of " + typehelper(d->type) + " " + ast.name(e)});
+}
+
+template<class... Passes>
+static void sweephelper(int nodes, vector<Diagnostic> &out, Passes &... passes)
+// MODIFIES: passes, out
+// EFFECTS: visits every node with each of passes in turn, in one loop
+{
+    for (int i = 0; i < nodes; i++) {
+        int unused[] = {(passes.visit(i, out), 0)...};
+        (void) unused;
+    }
+}
+
+vector<Diagnostic> checkProgram(const FlatAst &ast, bool fused) {
+    DeclPass decls(ast);
+    TypePass types(ast, decls);
+    IncPass incs(ast, decls);
+    vector<Diagnostic> out;
+    if (fused) {
+        sweephelper(ast.nodeNum(), out, decls, types, incs);
+    } else {
+        sweephelper(ast.nodeNum(), out, decls);
+        sweephelper(ast.nodeNum(), out, types);
+        sweephelper(ast.nodeNum(), out, incs);
+        stable_sort(out.begin(), out.end(), [](const Diagnostic &a, const Diagnostic &b) {
+            return a.node < b.node;
+        });
+    }
+    return out;
+}
@@ -0,0 +1,100 @@
+#ifndef LAB6_FLATCHECK_H
+#define LAB6_FLATCHECK_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "flatAst.h"
+
+// The semantic checks of a FlatAst, as passes that each keep their state
+// in a struct and look at one node at a time, in index order. Run fused,
+// one loop over the node array calls every pass on each node, so the tree
+// is read once whatever the number of passes.
+//
+// The order makes this possible: the input is breadth-first, and each
+// declaration is taken from its VarDeclNode, FormalDeclNode or FnDeclNode,
+// whose depth is less than that of any statement of the same function. So
+// by the time a statement is reached, the declarations it can see are
+// known. The globals are seen by every function, wherever they are
+// declared.
+
+struct Diagnostic {
+    int node;               // the index of the node at fault
+    std::string message;
+};
+
+class DeclPass {
+    // OVERVIEW: collects the declarations, each in the scope of the
+    //           function it is in or in the file scope, and reports the
+    //           names declared twice in one scope
+public:
+    struct Declaration {
+        NodeKind type;      // IntNode, BoolNode or VoidNode
+        bool function;      // declared by a FnDeclNode
+        int node;
+    };
+
+    explicit DeclPass(const FlatAst &ast);
+
+    void visit(int i, std::vector<Diagnostic> &out);
+    // REQUIRES: every node before i was visited
+    // MODIFIES: this, out
+
+    int functionOf(int i) const;
+    // REQUIRES: the parent of node i was visited
+    // EFFECTS: return the index of the FnDeclNode node i is in, -1 if none
+
+    const Declaration *lookup(int nameId, int function) const;
+    // EFFECTS: return the declaration of nameId seen from function, in the
+    //          function first, then in the file scope, or NULL if none
+
+    int declarationNum() const;
+
+private:
+    const FlatAst &ast;
+    std::vector<int> function;      // functionOf each node, -1 if not known yet
+    std::vector<Declaration> declarations;
+    std::unordered_map<unsigned long long, int> index;
+    // from (function, nameId) to the first declaration of that name there
+};
+
+class TypePass {
+    // OVERVIEW: checks the use of the types: no variable or parameter is
+    //           void, an assignment is to a variable, of an expression of
+    //           its type
+public:
+    TypePass(const FlatAst &ast, const DeclPass &decls);
+
+    void visit(int i, std::vector<Diagnostic> &out);
+
+    NodeKind typeOf(int e, int function) const;
+    // REQUIRES: node e is an ExpNode
+    // EFFECTS: return the type of node e, IntNode or BoolNode, or
+    //          NODE_KIND_NUM if it names no variable
+
+private:
+    const FlatAst &ast;
+    const DeclPass &decls;
+};
+
+class IncPass {
+    // OVERVIEW: checks that each PostIncStmtNode and PostDecStmtNode
+    //           applies to an int variable
+public:
+    IncPass(const FlatAst &ast, const DeclPass &decls);
+
+    void visit(int i, std::vector<Diagnostic> &out);
+
+private:
+    const FlatAst &ast;
+    const DeclPass &decls;
+};
+
+std::vector<Diagnostic> checkProgram(const FlatAst &ast, bool fused = true);
+// REQUIRES: ast.check() == -1
+// EFFECTS: return the diagnostics of all the passes, ordered by node, and
+//          by pass for one node. With fused false, each pass sweeps the
+//          array alone, which gives the same diagnostics and is kept to
+//          compare against
+
+#endif //LAB6_FLATCHECK_H
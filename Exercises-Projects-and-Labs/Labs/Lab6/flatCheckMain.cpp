@@ -0,0 +1,22 @@
+// Reads an AST as ex1 does and prints the diagnostics of checkProgram, one
+// "node <index>: <message>" line each; with -separate, runs the passes one
+// sweep each rather than fused. Exits with 1 if there is any.
+
+#include <cstring>
+#include <iostream>
+#include "flatCheck.h"
+
+using namespace std;
+
+int main(int argc, char *argv[]) {
+    ios::sync_with_stdio(false);
+    bool fused = !(argc > 1 && strcmp(argv[1], "-separate") == 0);
+    FlatAst ast;
+    if (!ast.read(cin) || ast.check() >= 0) {
+        cerr << "Error: the input is not a valid AST" << endl;
+        return 2;
+    }
+    vector<Diagnostic> diagnostics = checkProgram(ast, fused);
+    for (const Diagnostic &d : diagnostics) cout << "node " << d.node << ": " << d.message << '\n';
+    return diagnostics.empty() ? 0 : 1;
+}
@@ -0,0 +1,27 @@
+// The unparser of ex1 on a FlatAst: the same input and output, with no cap
+// on the number of nodes.
+
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include "flatAst.h"
+
+using namespace std;
+
+int main() {
+    ios::sync_with_stdio(false);
+    FlatAst ast;
+    if (!ast.read(cin)) {
+        cerr << "Error: the input is not a tree of known nodes" << endl;
+        return 1;
+    }
+    int bad = ast.check();
+    if (bad >= 0) {
+        cerr << "Error: node " << bad << " does not have the children of its class" << endl;
+        return 1;
+    }
+    string out;
+    ast.unparse(out);
+    fwrite(out.data(), 1, out.size(), stdout);
+    return 0;
+}
@@ -0,0 +1,169 @@
+//
+// VE280 Lab 7: the courses of course.h in bulk.
+//
+
+#include <algorithm>
+#include "courseRegistry.h"
+
+using namespace std;
+
+// The class types create() knows, looked up once per call instead of
+// compared one after the other
+static const unordered_map<string, int> KINDS = {
+    {"Technical", CourseRegistry::TECHNICAL},
+    {"Upper Level Technical", CourseRegistry::UPPER_LEVEL_TECHNICAL},
+};
+
+static bool beforehelper(int month1, int day1, int month2, int day2)
+// EFFECTS: returns whether month1/day1 is strictly before month2/day2
+{
+    return month1 < month2 || (month1 == month2 && day1 < day2);
+}
+
+static unsigned int orderhelper(int tasks_size)
+// EFFECTS: returns the smallest order whose range holds tasks_size tasks,
+//          and holds one at least
+{
+    unsigned int order = 0;
+    while ((1u << order) < (unsigned int) tasks_size) order++;
+    return order;
+}
+
+int CourseRegistry::kindOf(const string &class_type) {
+    auto found = KINDS.find(class_type);
+    return found == KINDS.end() ? -1 : found->second;
+}
+
+CourseRegistry::CourseRegistry(ostream &out) : out(out) {}
+
+void CourseRegistry::reserve(size_t courses, size_t tasks) {
+    this->courses.reserve(courses);
+    byCode.reserve(courses);
+    slab.reserve(tasks);
+}
+
+int CourseRegistry::add(const string &class_type, const string &course_code, bool assign_size, int tasks_size) {
+    int kind = kindOf(class_type);
+    if (kind < 0) return -1;
+    return add((Kind) kind, course_code, assign_size ? tasks_size : DEFAULT_TASKS);
+}
+
+int CourseRegistry::add(Kind kind, const string &course_code, int tasks_size) {
+    int id = (int) courses.size();
+    if (!byCode.emplace(course_code, id).second) return -1;
+    unsigned int order = orderhelper(tasks_size);
+    courses.push_back(Record{course_code, kind, allocatehelper(order), 0, order});
+    return id;
+}
+
+int CourseRegistry::find(const string &course_code) const {
+    auto found = byCode.find(course_code);
+    return found == byCode.end() ? -1 : found->second;
+}
+
+int CourseRegistry::courseNum() const {
+    return (int) courses.size();
+}
+
+int CourseRegistry::taskNum(int course) const {
+    return (int) courses[course].num;
+}
+
+unsigned int CourseRegistry::allocatehelper(unsigned int order) {
+    if (order < freeRanges.size() && !freeRanges[order].empty()) {
+        unsigned int offset = freeRanges[order].back();
+        freeRanges[order].pop_back();
+        return offset;
+    }
+    // A new range at the end of the slab; the slab grows geometrically as
+    // any vector does, and the ranges are offsets, so none moves with it
+    unsigned int offset = (unsigned int) slab.size();
+    slab.resize(slab.size() + (size_t(1) << order));
+    return offset;
+}
+
+int CourseRegistry::typehelper(const string &type) {
+    auto found = typeIds.emplace(type, (int) types.size());
+    if (found.second) {
+        const char *via = type == "Lab" || type == "Project" ? "oj" : "canvas";
+        types.push_back(TypeInfo{type, {via, type == "Team Project" ? "github" : via}});
+    }
+    return found.first->second;
+}
+
+int CourseRegistry::findhelper(const Record &r, int type, int index) const {
+    const Task *tasks = slab.data() + r.offset;
+    for (unsigned int i = 0; i < r.num; i++) {
+        if (tasks[i].type == type && tasks[i].index == index) return (int) i;
+    }
+    return -1;
+}
+
+void CourseRegistry::inserthelper(Record &r, const Task &task) {
+    if (r.num == 1u << r.order) {
+        // Full: move to a range twice as large, and give this one up
+        unsigned int offset = allocatehelper(r.order + 1);
+        copy(slab.begin() + r.offset, slab.begin() + r.offset + r.num, slab.begin() + offset);
+        if (freeRanges.size() <= r.order) freeRanges.resize(r.order + 1);
+        freeRanges[r.order].push_back(r.offset);
+        r.offset = offset;
+        r.order++;
+    }
+    Task *tasks = slab.data() + r.offset;
+    unsigned int at = r.num;
+    if (r.kind == UPPER_LEVEL_TECHNICAL) {
+        // After every task due on or before it, so that of two tasks due the
+        // same day the one updated first comes first
+        while (at > 0 && beforehelper(task.due_month, task.due_day, tasks[at - 1].due_month, tasks[at - 1].due_day)) {
+            tasks[at] = tasks[at - 1];
+            at--;
+        }
+    }
+    tasks[at] = task;
+    r.num++;
+}
+
+void CourseRegistry::updateTask(int course, const string &type, int index, int due_month, int due_day) {
+    Record &r = courses[course];
+    int t = typehelper(type);
+    int i = findhelper(r, t, index);
+    if (i < 0) {
+        inserthelper(r, Task{t, index, due_month, due_day});
+        out << r.code << " " << type << " " << index << " is released! Submit it via "
+            << types[t].via[r.kind] << "!\n";
+        return;
+    }
+    Task *tasks = slab.data() + r.offset;
+    if (r.kind == TECHNICAL) {
+        tasks[i].due_month = due_month;
+        tasks[i].due_day = due_day;
+    } else if (tasks[i].due_month != due_month || tasks[i].due_day != due_day) {
+        // Taken out and put back where its new date goes
+        copy(tasks + i + 1, tasks + r.num, tasks + i);
+        r.num--;
+        inserthelper(r, Task{t, index, due_month, due_day});
+    }
+}
+
+bool CourseRegistry::finishTask(int course, const string &type, int index, int finish_month, int finish_day) {
+    Record &r = courses[course];
+    auto found = typeIds.find(type);
+    int i = found == typeIds.end() ? -1 : findhelper(r, found->second, index);
+    if (i < 0) return false;
+    Task *tasks = slab.data() + r.offset;
+    bool overdue = beforehelper(tasks[i].due_month, tasks[i].due_day, finish_month, finish_day);
+    out << r.code << " " << type << " " << index << (overdue ? " is overdue!" : " is finished!") << "\n";
+    copy(tasks + i + 1, tasks + r.num, tasks + i);
+    r.num--;
+    return true;
+}
+
+void CourseRegistry::print(int course) const {
+    const Record &r = courses[course];
+    const Task *tasks = slab.data() + r.offset;
+    out << r.code << "\n";
+    for (unsigned int i = 0; i < r.num; i++) {
+        out << types[tasks[i].type].name << " " << tasks[i].index << ": "
+            << tasks[i].due_month << "/" << tasks[i].due_day << "\n";
+    }
+}
@@ -0,0 +1,125 @@
+//
+// VE280 Lab 7: the courses of course.h in bulk, for an import of many
+// courses at once.
+//
+
+#ifndef COURSEREGISTRY_H
+#define COURSEREGISTRY_H
+
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+const int DEFAULT_TASKS = 4;    // MAXTASKS of course.cpp
+
+class CourseRegistry {
+    // OVERVIEW: many courses of the two kinds of course.cpp, each course
+    //           named by an id, its position in the registry. The tasks of
+    //           all the courses live in one slab: a course owns a range of
+    //           it, of a power of two tasks, and moves to a range twice as
+    //           large when its own is full, rather than throw tooManyTasks.
+    //           The ranges given up are reused by the courses that grow
+    //           later. The messages of the lab go to the stream given.
+public:
+    enum Kind {
+        TECHNICAL,              // "Technical": tasks in the order they came
+        UPPER_LEVEL_TECHNICAL,  // "Upper Level Technical": earliest deadline first
+        KIND_NUM
+    };
+
+    static int kindOf(const std::string &class_type);
+    // EFFECTS: returns the kind of class_type, -1 if it is none
+
+    explicit CourseRegistry(std::ostream &out = std::cout);
+
+    void reserve(size_t courses, size_t tasks);
+    // MODIFIES: this
+    // EFFECTS: makes room for that many courses and tasks in all
+
+    int add(const std::string &class_type, const std::string &course_code, bool assign_size, int tasks_size);
+    // MODIFIES: this
+    // EFFECTS: as create() of course.cpp: adds a course of class_type with
+    //          room for tasks_size tasks at first if assign_size, for the
+    //          default otherwise, and returns its id; returns -1 if
+    //          class_type is no kind or course_code is already registered
+
+    int add(Kind kind, const std::string &course_code, int tasks_size = DEFAULT_TASKS);
+    // MODIFIES: this
+    // EFFECTS: as above, with the kind already looked up
+
+    int find(const std::string &course_code) const;
+    // EFFECTS: returns the id of course_code, -1 if not registered
+
+    int courseNum() const;
+
+    int taskNum(int course) const;
+    // REQUIRES: 0 <= course < courseNum()
+    // EFFECTS: returns the number of unfinished tasks of course
+
+    void updateTask(int course, const std::string &type, int index, int due_month, int due_day);
+    // REQUIRES: 0 <= course < courseNum(), due_month and due_day are in
+    //           normal range
+    // MODIFIES: this, the stream
+    // EFFECTS: updateTask of the course's kind, except that it never throws
+
+    bool finishTask(int course, const std::string &type, int index, int finish_month, int finish_day);
+    // REQUIRES: 0 <= course < courseNum(), finish_month and finish_day are
+    //           in normal range
+    // MODIFIES: this, the stream
+    // EFFECTS: finishTask of the lab, if Task index of type is in the
+    //          course; returns whether it was
+
+    void print(int course) const;
+    // REQUIRES: 0 <= course < courseNum()
+    // MODIFIES: the stream
+    // EFFECTS: prints the course as print() of course.cpp does
+
+private:
+    struct Task {
+        int type;               // an index of types
+        int index;
+        int due_month;
+        int due_day;
+    };
+
+    struct Record {
+        std::string code;
+        Kind kind;
+        unsigned int offset;    // the course's range of the slab
+        unsigned int num;       // the tasks in use, at the front of the range
+        unsigned int order;     // the range has 1 << order tasks
+    };
+
+    struct TypeInfo {
+        std::string name;
+        const char *via[KIND_NUM];  // where to submit it, in each kind of course
+    };
+
+    std::ostream &out;
+    std::vector<Task> slab;
+    std::vector<std::vector<unsigned int> > freeRanges;    // the free offsets, by order
+    std::vector<Record> courses;
+    std::unordered_map<std::string, int> byCode;
+    std::vector<TypeInfo> types;
+    std::unordered_map<std::string, int> typeIds;
+
+    unsigned int allocatehelper(unsigned int order);
+    // MODIFIES: this
+    // EFFECTS: returns the offset of a free range of 1 << order tasks
+
+    int typehelper(const std::string &type);
+    // MODIFIES: this
+    // EFFECTS: returns the index of type in types, adding it if new
+
+    int findhelper(const Record &r, int type, int index) const;
+    // EFFECTS: returns the position of Task index of type in the range of
+    //          r, -1 if none
+
+    void inserthelper(Record &r, const Task &task);
+    // MODIFIES: this
+    // EFFECTS: adds task to r where its kind puts it, growing its range if
+    //          full
+};
+
+#endif //COURSEREGISTRY_H
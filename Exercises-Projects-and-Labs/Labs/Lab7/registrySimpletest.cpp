@@ -0,0 +1,48 @@
+//
+// VE280 Lab 7: test/simpletest.cpp of the starter files, on a
+// CourseRegistry; it prints test/simpletest.out.
+//
+
+#include <iostream>
+
+#include "courseRegistry.h"
+
+int main() {
+    CourseRegistry registry;
+
+    int ve281 = registry.add("Technical", "VE281", false, 0);
+    int ve370 = registry.add("Technical", "VE370", false, 0);
+    int ve482 = registry.add("Upper Level Technical", "VE482", true, 10);
+
+    registry.updateTask(ve482, "Homework", 1, 9, 20);
+    registry.updateTask(ve482, "Lab", 1, 9, 15);
+    registry.print(ve482);
+    registry.updateTask(ve482, "Lab", 2, 9, 23);
+    registry.finishTask(ve482, "Lab", 1, 9, 13);
+    registry.print(ve482);
+    registry.finishTask(ve482, "Homework", 1, 9, 19);
+    registry.updateTask(ve482, "Homework", 2, 9, 30);
+    registry.finishTask(ve482, "Lab", 2, 9, 22);
+    registry.updateTask(ve482, "Homework", 3, 10, 14);
+    registry.updateTask(ve482, "Team Project", 1, 10, 13);
+    registry.print(ve482);
+
+    registry.updateTask(ve281, "Lab", 1, 9, 23);
+    registry.updateTask(ve281, "Project", 1, 9, 30);
+    registry.print(ve281);
+    registry.finishTask(ve281, "Lab", 1, 9, 23);
+    registry.updateTask(ve281, "Lab", 2, 10, 2);
+    registry.updateTask(ve281, "Project", 1, 10, 4);
+    registry.print(ve281);
+
+    registry.updateTask(ve370, "Project", 1, 9, 27);
+    registry.updateTask(ve370, "Homework", 1, 9, 25);
+    registry.updateTask(ve370, "Homework", 1, 9, 25);
+    registry.print(ve370);
+    registry.finishTask(ve370, "Project", 1, 9, 25);
+    registry.finishTask(ve370, "Homework", 1, 9, 30);
+    registry.updateTask(ve370, "Homework", 2, 10, 15);
+    registry.print(ve370);
+
+    return 0;
+}
@@ -0,0 +1,82 @@
+#include <iostream>
+#include "flatTree.h"
+
+using namespace std;
+
+static unsigned long long mix(unsigned long long x)
+// EFFECTS: returns x with its bits mixed, by the finalizer of splitmix64
+{
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+void FlatTree::flatten(const Node *root) {
+    // With a stack rather than recursion, so that deep trees do not overflow
+    // it, and the sizes are added up from the last node back, as each node
+    // comes after its parent
+    vector<pair<const Node *, int> > stack(1, make_pair(root, -1));
+    vector<int> parent;
+    while (!stack.empty()) {
+        const Node *node = stack.back().first;
+        parent.push_back(stack.back().second);
+        stack.pop_back();
+        int index = (int)value.size();
+        value.push_back(node->value);
+        size.push_back(1);
+        for (int i = node->child_num - 1; i >= 0; i--) {
+            stack.push_back(make_pair(node->children[i], index));
+        }
+    }
+    for (int i = (int)value.size() - 1; i > 0; i--) {
+        size[parent[i]] += size[i];
+    }
+}
+
+FlatTree::FlatTree(const Node &root) {
+    flatten(&root);
+    int num = nodeNum();
+    height.assign(num, 0);
+    hash.assign(num, 0);
+    // The children come after their parent, so a backward scan has them
+    // ready, and each node is visited once as a child
+    for (int i = num - 1; i >= 0; i--) {
+        unsigned long long h = mix(value[i]);
+        for (int j = i + 1; j < i + size[i]; j += size[j]) {
+            if (height[j] + 1 > height[i]) height[i] = height[j] + 1;
+            h = mix(h * 31 + hash[j]);
+        }
+        hash[i] = h;
+    }
+}
+
+int FlatTree::nodeNum() const {
+    return (int)value.size();
+}
+
+void FlatTree::traverse() const {
+    for (int i = 0; i < nodeNum(); i++) {
+        cout << value[i] << " ";
+    }
+}
+
+int FlatTree::getHeight(int i) const {
+    return height[i];
+}
+
+bool FlatTree::equal(int i, const FlatTree &sub) const {
+    // The values and sizes in pre-order determine the tree
+    for (int j = 0; j < sub.nodeNum(); j++) {
+        if (value[i + j] != sub.value[j] || size[i + j] != sub.size[j]) return false;
+    }
+    return true;
+}
+
+bool FlatTree::contain(const FlatTree &sub) const {
+    for (int i = 0; i < nodeNum(); i++) {
+        if (hash[i] == sub.hash[0] && size[i] == sub.size[0] && equal(i, sub)) return true;
+    }
+    return false;
+}
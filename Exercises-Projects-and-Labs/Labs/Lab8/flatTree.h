@@ -0,0 +1,48 @@
+#ifndef LAB8_FLATTREE_H
+#define LAB8_FLATTREE_H
+
+#include <vector>
+#include "node.h"
+
+class FlatTree {
+    // OVERVIEW: an n-ary tree stored in pre-order, in one array per field.
+    //           The subtree of the node at index i is at [i, i + size[i]),
+    //           its first child is at i + 1, and each next child follows the
+    //           subtree of the child before it
+private:
+    std::vector<int> value;     // the value of each node
+    std::vector<int> size;      // the number of nodes in each subtree
+    std::vector<int> height;    // the height of each node
+    std::vector<unsigned long long> hash;
+    // hash of each subtree, from its values and its shape, so that equal
+    // subtrees have equal hashes
+
+    void flatten(const Node *root);
+    // EFFECTS: appends the value and size of every node in the tree rooted
+    //          at root, in pre-order, to value and size
+
+    bool equal(int i, const FlatTree &sub) const;
+    // EFFECTS: return whether the subtree at index i is the same as sub
+
+public:
+    explicit FlatTree(const Node &root);
+    // EFFECTS: create the flattened copy of the tree rooted at root
+
+    int nodeNum() const;
+    // EFFECTS: return the number of nodes in the tree
+
+    void traverse() const;
+    // EFFECTS: print the value of the nodes using a pre-order traversal,
+    //          separated by a space, as Node::traverse does
+
+    int getHeight(int i = 0) const;
+    // REQUIRES: 0 <= i < nodeNum()
+    // EFFECTS: return height of the node at index i, the root by default
+
+    bool contain(const FlatTree &sub) const;
+    // EFFECTS: return whether sub is a subtree of this, in O(nodeNum()) by
+    //          comparing the hashes of the subtrees and checking the
+    //          subtrees with the same hash as sub
+};
+
+#endif //LAB8_FLATTREE_H
@@ -0,0 +1,111 @@
+#include <iostream>
+#include <vector>
+#include "node.h"
+#include "flatTree.h"
+
+using namespace std;
+
+Node::Node(int _value, int _n)
+    : value(_value), child_num(0), n(_n), parent(NULL), children(new Node *[_n]), height(0),
+      dirty(false) {}
+
+Node::Node(int count, const int values[], const int childNums[], int _n)
+    : value(values[0]), child_num(0), n(_n), parent(NULL), children(new Node *[_n]), height(0),
+      dirty(false) {
+    for (int i = 0; i < count; i++) {
+        if (childNums[i] > n) {
+            delete[] children;
+            throw tooManyChildren();
+        }
+    }
+    // In level order, the children of each node are the next nodes not yet
+    // given a parent
+    vector<Node *> nodes(count);
+    nodes[0] = this;
+    for (int i = 1; i < count; i++) {
+        nodes[i] = new Node(values[i], n);
+    }
+    for (int i = 0, next = 1; i < count; i++) {
+        for (int j = 0; j < childNums[i]; j++, next++) {
+            nodes[i]->children[nodes[i]->child_num++] = nodes[next];
+            nodes[next]->parent = nodes[i];
+        }
+    }
+    // The children come after their parent, so a backward pass has their
+    // heights ready
+    for (int i = count - 1; i > 0; i--) {
+        Node *p = nodes[i]->parent;
+        if (nodes[i]->height + 1 > p->height) p->height = nodes[i]->height + 1;
+    }
+}
+
+Node::~Node() {
+    // The descendants are deleted from a list rather than recursively, so
+    // that deep trees do not overflow the stack
+    vector<Node *> nodes(children, children + child_num);
+    while (!nodes.empty()) {
+        Node *node = nodes.back();
+        nodes.pop_back();
+        nodes.insert(nodes.end(), node->children, node->children + node->child_num);
+        node->child_num = 0;
+        delete node;
+    }
+    delete[] children;
+}
+
+void Node::addChild(Node *child) {
+    if (child_num >= n) throw tooManyChildren();
+    children[child_num++] = child;
+    child->parent = this;
+    // The ancestors above a dirty node are already dirty, so each node is
+    // marked once between two getHeight
+    for (Node *node = this; node != NULL && !node->dirty; node = node->parent) {
+        node->dirty = true;
+    }
+}
+
+void Node::addChild(int _value) {
+    if (child_num >= n) throw tooManyChildren();
+    addChild(new Node(_value, n));
+}
+
+void Node::updateHeight() {
+    // A post-order walk of the dirty nodes, with a stack rather than recursion
+    vector<pair<Node *, int> > stack(1, make_pair(this, 0));
+    while (!stack.empty()) {
+        Node *node = stack.back().first;
+        int &next = stack.back().second;
+        while (next < node->child_num && !node->children[next]->dirty) next++;
+        if (next < node->child_num) {
+            stack.push_back(make_pair(node->children[next++], 0));
+            continue;
+        }
+        node->height = 0;
+        for (int i = 0; i < node->child_num; i++) {
+            if (node->children[i]->height + 1 > node->height) node->height = node->children[i]->height + 1;
+        }
+        node->dirty = false;
+        stack.pop_back();
+    }
+}
+
+void Node::traverse() {
+    cout << value << " ";
+    for (int i = 0; i < child_num; i++) {
+        children[i]->traverse();
+    }
+}
+
+bool Node::contain(Node *sub) {
+    return FlatTree(*this).contain(FlatTree(*sub));
+}
+
+int Node::getHeight() {
+    if (dirty) updateHeight();
+    return height;
+}
+
+Node &Node::operator[](int i) {
+    if (i < 0 || i >= child_num) throw invalidIndex();
+    return *children[i];
+}
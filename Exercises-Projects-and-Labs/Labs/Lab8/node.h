@@ -5,10 +5,14 @@
 #ifndef LAB8_NODE_H
 #define LAB8_NODE_H
 
+#include "../../../alloc/alloc.h"
+
 class tooManyChildren{};
 class invalidIndex{};
-class Node {
+class Node : public alloc::Allocated<Node> {
     // OVERVIEW: a node in the n-Ary tree, can also represent a n-ary tree rooted at 'this'
+    //           Nodes come from the resource given to Node::setResource()
+    friend class FlatTree;
 private:
     int value;      // the integer value of this
     int child_num;  // the number of child of this
@@ -16,17 +20,31 @@ private:
     Node *parent;   // parent node of this, for root node, parent = NULL
     Node **children;
     // children is an array of pointer to Node. Therefore, children is a pointer of pointer
-    int height;     // height of this node
+    int height;     // height of this node, if it is not dirty
+    bool dirty;     // whether a descendant was added since height was computed
 
     void addChild(Node *child);
     // REQUIRES: n of the child node is the same with n of this
     // EFFECTS: add the node child to the children array
     //          throw an exception tooManyChildren when child_num exceed n
 
+    void updateHeight();
+    // MODIFIES: height, dirty of this and its dirty descendants
+    // EFFECTS: recompute the height of every dirty node of the tree rooted at
+    //          this. The dirty nodes are the ancestors of the added nodes, so
+    //          only they are visited, each once
+
 public:
     Node(int _value, int _n = 2);
     // EFFECTS: create a root node with value and n
 
+    Node(int count, const int values[], const int childNums[], int _n = 2);
+    // REQUIRES: count >= 1, the node at index i in level order has the value
+    //           values[i] and childNums[i] children, and the childNums add up
+    //           to count - 1
+    // EFFECTS: create the whole tree at once in O(count), this being its root
+    //          throw an exception tooManyChildren when a childNums exceed n
+
     ~Node();
     // EFFECTS: destroy the whole tree rooted at sub
 
@@ -49,7 +67,8 @@ public:
     // EFFECTS: return whether the tree rooted at sub is a subtree of this
 
     int getHeight();
-    // EFFECTS: return height of this
+    // EFFECTS: return height of this, recomputing the heights below this
+    //          that nodes added since the last call may have changed
 
     Node &operator[](int i);
     // EFFECTS: return a reference of (i+1) th child node of this,
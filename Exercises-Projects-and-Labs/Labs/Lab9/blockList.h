@@ -0,0 +1,132 @@
+//
+// VE280 Lab 9: the List<T> of mylist.h, with moves and its nodes
+// allocated in blocks.
+//
+
+#ifndef BLOCKLIST_H
+#define BLOCKLIST_H
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+// an exception class
+class emptyBlockList{};
+
+template <class T>
+struct block_node_t{
+    block_node_t* next;
+    T val;
+
+    template <class... Args>
+    explicit block_node_t(Args&&... args);
+    // EFFECTS: constructs val from args, with no next
+};
+
+// singly-linked list
+template <class T>
+class BlockList{
+    // OVERVIEW: List<T> of mylist.h, but its nodes are not allocated one by
+    //           one: they are taken from blocks of many nodes, each block
+    //           at least as large as all the blocks before it, so that n
+    //           insertions allocate O(log n) times. The node of a removed
+    //           element is kept for the next insertion; the blocks are only
+    //           given back by the destructor and the assignments. A list
+    //           moved from is empty.
+private:
+    typedef block_node_t<T> node;
+
+    union slot{
+        slot* nextFree;
+        typename std::aligned_storage<sizeof(node), alignof(node)>::type storage;
+    };
+
+    static const size_t MIN_BLOCK = 4;
+
+    node* first;
+    node* last;
+
+    std::vector<slot*> blocks;      // every block, to give back
+    size_t capacity;                // the slots of all the blocks
+    slot* spare;                    // the slots never used, of the last block:
+    slot* spareEnd;                 // [spare, spareEnd)
+    slot* freeSlots;                // the slots of the removed nodes
+
+    void removeAll();
+    // EFFECTS: called by destructor/operator= to remove and destroy
+    //          all list elements, and give back the blocks
+
+    void copyFrom(const BlockList &l);
+    // MODIFIES: this
+    // EFFECTS: called by copy constructor/operator= to copy elements
+    //          from a source list l to this list;
+    //          if this list is not empty originally, removes all elements from it before copying
+
+    void moveFrom(BlockList &l);
+    // REQUIRES: this list is empty and has no block
+    // MODIFIES: this, l
+    // EFFECTS: takes the elements and the blocks of l, leaving l empty
+
+    void reservehelper(size_t n);
+    // MODIFIES: this
+    // EFFECTS: makes sure n nodes can be inserted without allocating, by
+    //          allocating one block if needed
+
+    slot* slothelper();
+    // MODIFIES: this
+    // EFFECTS: returns a slot for one node
+
+    template <class InputIt>
+    void appendhelper(InputIt begin, InputIt end, std::input_iterator_tag);
+    template <class ForwardIt>
+    void appendhelper(ForwardIt begin, ForwardIt end, std::forward_iterator_tag);
+    // MODIFIES: this
+    // EFFECTS: appendRange(begin, end); only a forward range can be counted
+    //          first, to be placed in one block
+
+public:
+    bool isEmpty() const;
+    // EFFECTS: returns true if list is empty, false otherwise
+
+    void insertBack(const T &val);
+    void insertBack(T &&val);
+    // MODIFIES: this
+    // EFFECTS: inserts val at the back of the list, moving it if it can
+
+    template <class... Args>
+    void emplaceBack(Args&&... args);
+    // MODIFIES: this
+    // EFFECTS: inserts at the back of the list an element constructed from
+    //          args, in its node
+
+    template <class InputIt>
+    void appendRange(InputIt begin, InputIt end);
+    // REQUIRES: [begin, end) is a valid range, not of this list
+    // MODIFIES: this
+    // EFFECTS: inserts the elements of [begin, end) at the back of the
+    //          list, in order; the nodes of a forward range are allocated
+    //          at once, next to each other
+
+    T removeFront();
+    // MODIFIES: this
+    // EFFECTS: removes the first element from non-empty list and returns its value
+    //          throws an instance of emptyBlockList if empty
+
+    const block_node_t<T>* returnHead() const;
+    // EFFECTS: returns first
+
+    void print() const;
+    // EFFECTS: print the elements in the list
+
+    BlockList();                                    // constructor
+    BlockList(const BlockList &l);                  // copy constructor
+    BlockList(BlockList &&l);                       // move constructor
+    BlockList &operator=(const BlockList &l);       // assignment operator
+    BlockList &operator=(BlockList &&l);            // move assignment operator
+    ~BlockList();                                   // destructor
+};
+
+#include "blockList_impl.h"
+
+#endif //BLOCKLIST_H
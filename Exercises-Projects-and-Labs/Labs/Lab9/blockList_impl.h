@@ -0,0 +1,247 @@
+//
+// VE280 Lab 9: the implementation of BlockList<T>.
+//
+
+#ifndef BLOCKLIST_IMPL_H
+#define BLOCKLIST_IMPL_H
+
+#include <iostream>
+#include <new>
+#include <utility>
+#include "blockList.h"
+
+template <class T>
+template <class... Args>
+block_node_t<T>::block_node_t(Args&&... args): next(nullptr), val(std::forward<Args>(args)...)
+{
+}
+
+template <class T>
+BlockList<T>::BlockList(): first(nullptr), last(nullptr), capacity(0), spare(nullptr), spareEnd(nullptr),
+                           freeSlots(nullptr)
+{
+}
+
+template <class T>
+BlockList<T>::BlockList(const BlockList &l): BlockList()
+{
+    copyFrom(l);
+}
+
+template <class T>
+BlockList<T>::BlockList(BlockList &&l): BlockList()
+{
+    moveFrom(l);
+}
+
+template <class T>
+BlockList<T> &BlockList<T>::operator=(const BlockList &l)
+{
+    if(this != &l){
+        copyFrom(l);
+    }
+    return *this;
+}
+
+template <class T>
+BlockList<T> &BlockList<T>::operator=(BlockList &&l)
+{
+    if(this != &l){
+        removeAll();
+        moveFrom(l);
+    }
+    return *this;
+}
+
+template <class T>
+BlockList<T>::~BlockList()
+{
+    removeAll();
+}
+
+template <class T>
+void BlockList<T>::removeAll()
+{
+    while(first){
+        node* victim = first;
+        first = first->next;
+        victim->~node();
+    }
+    last = nullptr;
+    for(size_t i = 0; i < blocks.size(); ++i){
+        ::operator delete(blocks[i]);
+    }
+    blocks.clear();
+    capacity = 0;
+    spare = spareEnd = freeSlots = nullptr;
+}
+
+template <class T>
+void BlockList<T>::copyFrom(const BlockList &l)
+{
+    removeAll();
+    size_t n = 0;
+    for(const node* itr = l.first; itr; itr = itr->next){
+        ++n;
+    }
+    reservehelper(n);
+    for(const node* itr = l.first; itr; itr = itr->next){
+        emplaceBack(itr->val);
+    }
+}
+
+template <class T>
+void BlockList<T>::moveFrom(BlockList &l)
+{
+    first = l.first;
+    last = l.last;
+    blocks.swap(l.blocks);
+    capacity = l.capacity;
+    spare = l.spare;
+    spareEnd = l.spareEnd;
+    freeSlots = l.freeSlots;
+    l.first = l.last = nullptr;
+    l.capacity = 0;
+    l.spare = l.spareEnd = l.freeSlots = nullptr;
+}
+
+template <class T>
+void BlockList<T>::reservehelper(size_t n)
+{
+    // The free slots are not counted: they are few after a removal of some
+    // elements, and walking them to count would cost as much as their use
+    size_t available = (size_t) (spareEnd - spare);
+    if(available >= n){
+        return;
+    }
+    // The spare slots of the last block are left unused
+    size_t size = n - available > capacity ? n - available : capacity;
+    if(size < MIN_BLOCK){
+        size = MIN_BLOCK;
+    }
+    blocks.reserve(blocks.size() + 1);
+    slot* block = static_cast<slot*>(::operator new(size * sizeof(slot)));
+    blocks.push_back(block);
+    capacity += size;
+    spare = block;
+    spareEnd = block + size;
+}
+
+template <class T>
+typename BlockList<T>::slot* BlockList<T>::slothelper()
+{
+    if(freeSlots){
+        slot* s = freeSlots;
+        freeSlots = s->nextFree;
+        return s;
+    }
+    if(spare == spareEnd){
+        reservehelper(1);
+    }
+    return spare++;
+}
+
+template <class T>
+bool BlockList<T>::isEmpty() const
+{
+    return first == nullptr;
+}
+
+template <class T>
+void BlockList<T>::insertBack(const T &val)
+{
+    emplaceBack(val);
+}
+
+template <class T>
+void BlockList<T>::insertBack(T &&val)
+{
+    emplaceBack(std::move(val));
+}
+
+template <class T>
+template <class... Args>
+void BlockList<T>::emplaceBack(Args&&... args)
+{
+    slot* s = slothelper();
+    node* np;
+    try{
+        np = new (&s->storage) node(std::forward<Args>(args)...);
+    }
+    catch(...){
+        s->nextFree = freeSlots;
+        freeSlots = s;
+        throw;
+    }
+    if(last){
+        last->next = np;
+    }
+    else{
+        first = np;
+    }
+    last = np;
+}
+
+template <class T>
+template <class InputIt>
+void BlockList<T>::appendRange(InputIt begin, InputIt end)
+{
+    appendhelper(begin, end, typename std::iterator_traits<InputIt>::iterator_category());
+}
+
+template <class T>
+template <class InputIt>
+void BlockList<T>::appendhelper(InputIt begin, InputIt end, std::input_iterator_tag)
+{
+    for(; begin != end; ++begin){
+        emplaceBack(*begin);
+    }
+}
+
+template <class T>
+template <class ForwardIt>
+void BlockList<T>::appendhelper(ForwardIt begin, ForwardIt end, std::forward_iterator_tag)
+{
+    reservehelper((size_t) std::distance(begin, end));
+    for(; begin != end; ++begin){
+        emplaceBack(*begin);
+    }
+}
+
+template <class T>
+T BlockList<T>::removeFront()
+{
+    if(!first){
+        throw emptyBlockList();
+    }
+    node* victim = first;
+    first = first->next;
+    if(!first){
+        last = nullptr;
+    }
+    T val = std::move(victim->val);
+    victim->~node();
+    slot* s = reinterpret_cast<slot*>(victim);
+    s->nextFree = freeSlots;
+    freeSlots = s;
+    return val;
+}
+
+template <class T>
+const block_node_t<T>* BlockList<T>::returnHead() const
+{
+    return first;
+}
+
+template <class T>
+void BlockList<T>::print() const
+{
+    const node* itr = first;
+    while(itr){
+        std::cout << itr->val;
+        itr = itr->next;
+    }
+    std::cout << "\n";
+}
+
+#endif //BLOCKLIST_IMPL_H
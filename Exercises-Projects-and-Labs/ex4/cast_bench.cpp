@@ -0,0 +1,47 @@
+/*
+ * A benchmark of failed casts, through ScalableSpellbook::castSpell, which
+ * throws, and tryCast, which returns a status: half the casts are of a spell
+ * not learned and half of one costing more mana than there is.
+ *
+ * Usage: cast_bench [casts = 1000000]
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include "scalable_spellbook.h"
+
+// EFFECTS: returns the seconds since start.
+static double since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[]) {
+    long casts = argc > 1 ? std::atol(argv[1]) : 1000000;
+    ScalableSpellbook book;
+    book.learnSpell(Spell("Meteor", Fire, 1000));
+    const std::string names[] = {"Meteor", "EX-calibur"};
+
+    long failed = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (long i = 0; i < casts; i++) {
+        try {
+            book.castSpell(names[i & 1]);
+        } catch (const Exception&) {
+            failed++;
+        }
+    }
+    double throwing = since(start);
+
+    start = std::chrono::steady_clock::now();
+    for (long i = 0; i < casts; i++) {
+        failed += book.tryCast(names[i & 1]) != CAST_OK;
+    }
+    double status = since(start);
+
+    std::cout << casts << " failed casts each, " << failed << " in all\n";
+    std::cout << "castSpell: " << throwing * 1e9 / casts << " ns a cast\n";
+    std::cout << "tryCast:   " << status * 1e9 / casts << " ns a cast\n";
+    return 0;
+}
@@ -0,0 +1,69 @@
+#include "ex4.h"
+
+#include <iostream>
+
+Exception::Exception(const std::string& msg) : message(msg) {}
+
+std::string Exception::what() const {
+    return message;
+}
+
+Spellbook::Spellbook() : spellCount(0), maxMana(100), currentMana(50) {}
+
+void Spellbook::learnSpell(const Spell& spell) {
+    for (int i = 0; i < spellCount; i++) {
+        if (spells[i].name == spell.name) {
+            spells[i] = spell;
+            return;
+        }
+    }
+    if (spellCount >= MAX_SPELLS) throw Exception("The spellbook is full!");
+    spells[spellCount++] = spell;
+}
+
+void Spellbook::castSpell(const std::string& spellName) {
+    for (int i = 0; i < spellCount; i++) {
+        if (spells[i].name == spellName) {
+            if (currentMana < spells[i].manaCost) throw Exception("Not enough mana to cast " + spellName + "!");
+            currentMana -= spells[i].manaCost;
+            std::cout << "Casted " << spellName << ".\n";
+            return;
+        }
+    }
+    throw Exception("Spell " + spellName + " not learned!");
+}
+
+void Spellbook::printSpells() const {
+    if (spellCount == 0) throw Exception("Spellbook is empty!");
+    for (int i = 0; i < spellCount; i++) {
+        std::cout << spells[i].name << " (" << elementTypeNames[spells[i].element] << ") - "
+                  << spells[i].manaCost << " mana.\n";
+    }
+    std::cout << "Total spells: " << spellCount << ".\n";
+}
+
+void Spellbook::restoreMana(int amount) {
+    if (amount <= 0) throw Exception("Restore amount must be positive!");
+    // Compared before adding, so that a large amount does not overflow
+    currentMana = amount >= maxMana - currentMana ? maxMana : currentMana + amount;
+}
+
+MasterSpellbook::MasterSpellbook(ElementType forbidden, int maxSpells)
+    : forbiddenElement(forbidden), maxSpellCount(maxSpells > MAX_SPELLS ? MAX_SPELLS : maxSpells) {
+    if (maxSpells < 1) throw Exception("The master spellbook can hold at least 1 spell!");
+    maxMana = 150;
+    currentMana = 100;
+}
+
+void MasterSpellbook::learnSpell(const Spell& spell) {
+    if (spell.element == forbiddenElement)
+        throw Exception(elementTypeNames[spell.element] + " is forbidden in the master spellbook!");
+    for (int i = 0; i < spellCount; i++) {
+        if (spells[i].name == spell.name) {
+            spells[i] = spell;
+            return;
+        }
+    }
+    if (spellCount >= maxSpellCount) throw Exception("The master spellbook is full!");
+    spells[spellCount++] = spell;
+}
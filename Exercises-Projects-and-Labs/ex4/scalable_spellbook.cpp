@@ -0,0 +1,102 @@
+#include "scalable_spellbook.h"
+
+#include <functional>
+#include <iostream>
+
+// The size of the hash table of an empty spellbook
+static const std::size_t INITIAL_SLOTS = 16;
+
+ScalableSpellbook::ScalableSpellbook() : maxMana(100), currentMana(50) {
+    Slot empty = {0, -1};
+    slots.assign(INITIAL_SLOTS, empty);
+}
+
+std::size_t ScalableSpellbook::slotOf(const std::string& name, std::size_t hash) const {
+    // Linear probing, which the table being at most half full keeps short
+    std::size_t mask = slots.size() - 1;
+    std::size_t i = hash & mask;
+    while (slots[i].spell >= 0 && (slots[i].hash != hash || spells[slots[i].spell].name != name)) {
+        i = (i + 1) & mask;
+    }
+    return i;
+}
+
+void ScalableSpellbook::grow() {
+    std::vector<Slot> old;
+    old.swap(slots);
+    Slot empty = {0, -1};
+    slots.assign(old.size() * 2, empty);
+    std::size_t mask = slots.size() - 1;
+    for (std::size_t j = 0; j < old.size(); j++) {
+        if (old[j].spell < 0) continue;
+        // The names are distinct, so an empty slot is all that is looked for
+        std::size_t i = old[j].hash & mask;
+        while (slots[i].spell >= 0) i = (i + 1) & mask;
+        slots[i] = old[j];
+    }
+}
+
+void ScalableSpellbook::reserve(int count) {
+    spells.reserve(count);
+    while (slots.size() < 2 * (std::size_t)count) grow();
+}
+
+void ScalableSpellbook::learnSpell(const Spell& spell) {
+    std::size_t hash = std::hash<std::string>()(spell.name);
+    std::size_t i = slotOf(spell.name, hash);
+    if (slots[i].spell >= 0) {
+        spells[slots[i].spell] = spell;
+        return;
+    }
+    spells.push_back(spell);
+    slots[i].hash = hash;
+    slots[i].spell = (int)spells.size() - 1;
+    if (2 * spells.size() > slots.size()) grow();
+}
+
+int ScalableSpellbook::find(const std::string& spellName) const {
+    return slots[slotOf(spellName, std::hash<std::string>()(spellName))].spell;
+}
+
+CastStatus ScalableSpellbook::tryCast(int spell) {
+    const Spell& s = spells[spell];
+    if (currentMana < s.manaCost) return CAST_NOT_ENOUGH_MANA;
+    currentMana -= s.manaCost;
+    std::cout << "Casted " << s.name << ".\n";
+    return CAST_OK;
+}
+
+CastStatus ScalableSpellbook::tryCast(const std::string& spellName) {
+    int spell = find(spellName);
+    if (spell < 0) return CAST_NOT_LEARNED;
+    return tryCast(spell);
+}
+
+void ScalableSpellbook::fail(CastStatus status, const std::string& spellName) {
+    if (status == CAST_NOT_LEARNED) throw Exception("Spell " + spellName + " not learned!");
+    throw Exception("Not enough mana to cast " + spellName + "!");
+}
+
+void ScalableSpellbook::castSpell(const std::string& spellName) {
+    CastStatus status = tryCast(spellName);
+    if (status != CAST_OK) fail(status, spellName);
+}
+
+void ScalableSpellbook::castSpell(int spell) {
+    CastStatus status = tryCast(spell);
+    if (status != CAST_OK) fail(status, spells[spell].name);
+}
+
+void ScalableSpellbook::printSpells() const {
+    if (spells.empty()) throw Exception("Spellbook is empty!");
+    for (std::size_t i = 0; i < spells.size(); i++) {
+        std::cout << spells[i].name << " (" << elementTypeNames[spells[i].element] << ") - "
+                  << spells[i].manaCost << " mana.\n";
+    }
+    std::cout << "Total spells: " << spells.size() << ".\n";
+}
+
+void ScalableSpellbook::restoreMana(int amount) {
+    if (amount <= 0) throw Exception("Restore amount must be positive!");
+    currentMana = amount >= maxMana - currentMana ? maxMana : currentMana + amount;
+}
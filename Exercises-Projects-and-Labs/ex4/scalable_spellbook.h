@@ -0,0 +1,157 @@
+#ifndef __SCALABLE_SPELLBOOK_H__
+#define __SCALABLE_SPELLBOOK_H__
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "ex4.h"
+
+/**
+ * The outcome of ScalableSpellbook::tryCast, for the errors castSpell throws.
+ */
+enum CastStatus {
+    CAST_OK,
+    CAST_NOT_LEARNED,
+    CAST_NOT_ENOUGH_MANA
+};
+
+/**
+ * A spellbook with the rules of Spellbook but no limit on the number of
+ * spells, for books of thousands of them.
+ *
+ * The spells are kept in learning order, each name stored once there, and
+ * found by an open addressing hash table of their indices, so that learning
+ * and casting take O(1) on average and compare a name only when its hash
+ * matches. find() returns the index of a spell, which castSpell takes to cast
+ * it again without hashing its name.
+ */
+class ScalableSpellbook {
+private:
+    struct Slot {
+        std::size_t hash; // Hash of the name of the spell.
+        int spell;        // Index of the spell in spells, or -1 for an empty slot.
+    };
+
+    std::vector<Spell> spells; // Learned spells, in learning order.
+    std::vector<Slot> slots;   // Hash table, a power of two in size and at most half full.
+    int maxMana;               // Maximum mana capacity.
+    int currentMana;           // Current available mana.
+
+    /**
+     * @brief Finds the slot of a name: the one holding it, or the empty one where it would go.
+     * @param name Name of the spell.
+     * @param hash Hash of name.
+     * @return Index of the slot in slots.
+     */
+    std::size_t slotOf(const std::string& name, std::size_t hash) const;
+
+    /**
+     * @brief Doubles the hash table, placing the spells again.
+     */
+    void grow();
+
+    /**
+     * @brief Throws the Exception castSpell throws for a failed cast.
+     * @param status Outcome of the cast, not CAST_OK.
+     * @param spellName Name of the spell.
+     */
+    static void fail(CastStatus status, const std::string& spellName);
+
+public:
+    /**
+     * @brief Constructs a new spellbook.
+     *
+     * Initializes: maxMana = 100, currentMana = 50, no spells.
+     */
+    ScalableSpellbook();
+
+    /**
+     * @brief Makes room for a number of spells, so that learning them does not rehash.
+     * @param count Number of spells.
+     */
+    void reserve(int count);
+
+    /**
+     * @brief Learns a new spell and adds it after the others.
+     *
+     * If there exists a spell in the spellbook whose name is the same with the new `spell`,
+     * overwrite it with the new one, keeping its place.
+     * @param spell The spell to learn.
+     */
+    void learnSpell(const Spell& spell);
+
+    /**
+     * @brief Finds a spell by name.
+     * @param spellName Name of the spell.
+     * @return Index of the spell, which stays valid as more spells are learned, or -1 if not learned.
+     */
+    int find(const std::string& spellName) const;
+
+    /**
+     * @brief Casts a spell by name, as Spellbook::castSpell.
+     *
+     * Print success message "Casted [name].\n" to stdout, and deducts mana.
+     * @param spellName Name of the spell to cast.
+     * @throw Exception if spell not found ("Spell [name] not learned!").
+     * @throw Exception if not enough mana ("Not enough mana to cast [name]!").
+     */
+    void castSpell(const std::string& spellName);
+
+    /**
+     * @brief Casts a spell by name as castSpell does, but returns the error instead
+     * of throwing it, so that a failed cast allocates nothing.
+     *
+     * Print success message "Casted [name].\n" to stdout, and deducts mana.
+     * @param spellName Name of the spell to cast.
+     * @return CAST_OK, CAST_NOT_LEARNED, or CAST_NOT_ENOUGH_MANA with the mana unchanged.
+     */
+    CastStatus tryCast(const std::string& spellName);
+
+    /**
+     * @brief Casts a spell by the index find() returned, as tryCast by name.
+     * @param spell Index of the spell to cast.
+     * @return CAST_OK, or CAST_NOT_ENOUGH_MANA with the mana unchanged.
+     */
+    CastStatus tryCast(int spell);
+
+    /**
+     * @brief Casts a spell by the index find() returned.
+     * @param spell Index of the spell to cast.
+     * @throw Exception if not enough mana ("Not enough mana to cast [name]!").
+     */
+    void castSpell(int spell);
+
+    /**
+     * @brief Prints all spells in learning order to stdout, as Spellbook::printSpells.
+     *
+     * Format for each spell: "[Name] ([Element]) - [Cost] mana.\n".
+     *
+     * Ends with: "Total spells: [spellCount].\n".
+     * @throw Exception if no spells ("Spellbook is empty!"). No other printing needed.
+     */
+    void printSpells() const;
+
+    /**
+     * @brief Restores mana (up to maxMana).
+     * @param amount Mana to restore.
+     * @throw Exception if amount <= 0 ("Restore amount must be positive!").
+     */
+    void restoreMana(int amount);
+
+    /**
+     * @return Number of learned spells.
+     */
+    int getSpellCount() const { return (int)spells.size(); }
+
+    /**
+     * @return Current mana.
+     */
+    int getCurrentMana() const { return currentMana; }
+
+    /**
+     * @return Maximum mana limit.
+     */
+    int getMaxMana() const { return maxMana; }
+};
+
+#endif // __SCALABLE_SPELLBOOK_H__
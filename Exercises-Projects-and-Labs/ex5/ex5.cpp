@@ -0,0 +1,65 @@
+#include "ex5.h"
+
+#include <iostream>
+
+bookInventory::bookInventory() : books(new Book[MAX_BOOKS]), numBooks(0), empty(true), size(MAX_BOOKS) {}
+
+bookInventory::bookInventory(int maxBooks) : books(nullptr), numBooks(0), empty(true), size(0) {
+  if (maxBooks < 1 || maxBooks > MAX_BOOKS) {
+    throw Exception("Invalid size.");
+  }
+  books = new Book[maxBooks];
+  size = (unsigned int)maxBooks;
+}
+
+bool bookInventory::repOK() {
+  if (books == nullptr || size < 1 || size > (unsigned int)MAX_BOOKS || numBooks > size) {
+    return false;
+  }
+  if (empty != (numBooks == 0)) {
+    return false;
+  }
+  // The books are packed at the front, and only default books follow them
+  for (unsigned int i = 0; i < size; i++) {
+    bool isDefault = books[i].title.empty() && books[i].author.empty();
+    if (isDefault != (i >= numBooks)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bookInventory::~bookInventory() {
+  delete[] books;
+}
+
+void bookInventory::addBook(const Book &book) {
+  if (numBooks >= size) {
+    throw Exception("The inventory is full.");
+  }
+  books[numBooks++] = book;
+  empty = false;
+}
+
+void bookInventory::removeBook(int ID) {
+  if (ID < 1 || ID > (int)numBooks) {
+    throw Exception("Invalid book ID.");
+  }
+  // The books after it move up one slot, so that the array stays packed
+  for (unsigned int i = (unsigned int)ID; i < numBooks; i++) {
+    books[i - 1] = books[i];
+  }
+  books[--numBooks] = Book();
+  empty = numBooks == 0;
+}
+
+void bookInventory::printInventory() const {
+  if (empty) {
+    throw Exception("The inventory is empty.");
+  }
+  for (unsigned int i = 0; i < numBooks; i++) {
+    std::cout << "Book ID: " << i + 1 << std::endl;
+    std::cout << "Title: " << books[i].title << std::endl;
+    std::cout << "Author: " << books[i].author << std::endl;
+  }
+}
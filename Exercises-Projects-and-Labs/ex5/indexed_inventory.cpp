@@ -0,0 +1,141 @@
+#include "indexed_inventory.h"
+
+#include <cassert>
+#include <iostream>
+#include <utility>
+
+#ifdef INVENTORY_REP_CHECK
+#define CHECK_REP() assert(repOK())
+#else
+#define CHECK_REP()
+#endif
+
+int IndexedInventory::index(Index &index, const std::string &key, int ID) {
+  std::vector<int> &IDs = index[key];
+  IDs.push_back(ID);
+  return (int)IDs.size() - 1;
+}
+
+void IndexedInventory::unindex(Index &index, const std::string &key, int place, int Entry::*pos) {
+  auto it = index.find(key);
+  std::vector<int> &IDs = it->second;
+  int last = IDs.back();
+  IDs[place] = last;
+  entries[slots[last - 1]].*pos = place;
+  IDs.pop_back();
+  if (IDs.empty()) {
+    index.erase(it);
+  }
+}
+
+std::vector<int> IndexedInventory::lookup(const Index &index, const std::string &key) {
+  auto it = index.find(key);
+  return it == index.end() ? std::vector<int>() : it->second;
+}
+
+bool IndexedInventory::indexOK(const Index &index, std::string Book::*key, int Entry::*pos) const {
+  size_t listed = 0;
+  for (const auto &list : index) {
+    if (list.second.empty()) {
+      return false;
+    }
+    for (size_t place = 0; place < list.second.size(); place++) {
+      int ID = list.second[place];
+      if (ID < 1 || ID > (int)slots.size() || slots[ID - 1] < 0) {
+        return false;
+      }
+      int slot = slots[ID - 1];
+      if (books[slot].*key != list.first || entries[slot].*pos != (int)place) {
+        return false;
+      }
+    }
+    listed += list.second.size();
+  }
+  // Each book is listed at the one place its entry records, so no more
+  // entries than books means each is listed once
+  return listed == books.size();
+}
+
+void IndexedInventory::reserve(int count) {
+  books.reserve(count);
+  entries.reserve(count);
+}
+
+bool IndexedInventory::repOK() const {
+  if (entries.size() != books.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < books.size(); i++) {
+    int ID = entries[i].ID;
+    if (ID < 1 || ID > (int)slots.size() || slots[ID - 1] != (int)i) {
+      return false;
+    }
+    if (books[i].title.empty() && books[i].author.empty()) {
+      return false;
+    }
+  }
+  size_t live = 0;
+  for (size_t i = 0; i < slots.size(); i++) {
+    if (slots[i] >= 0) {
+      live++;
+    }
+  }
+  return live == books.size() && indexOK(byTitle, &Book::title, &Entry::titlePos) &&
+         indexOK(byAuthor, &Book::author, &Entry::authorPos);
+}
+
+int IndexedInventory::addBook(const Book &book) {
+  int ID = (int)slots.size() + 1;
+  Entry entry = {ID, index(byTitle, book.title, ID), index(byAuthor, book.author, ID)};
+  books.push_back(book);
+  entries.push_back(entry);
+  slots.push_back((int)books.size() - 1);
+  CHECK_REP();
+  return ID;
+}
+
+void IndexedInventory::removeBook(int ID) {
+  if (ID < 1 || ID > (int)slots.size() || slots[ID - 1] < 0) {
+    throw Exception("Invalid book ID.");
+  }
+  int slot = slots[ID - 1];
+  unindex(byTitle, books[slot].title, entries[slot].titlePos, &Entry::titlePos);
+  unindex(byAuthor, books[slot].author, entries[slot].authorPos, &Entry::authorPos);
+  // The last book takes its place, so that the array stays packed
+  int last = (int)books.size() - 1;
+  if (slot != last) {
+    books[slot] = std::move(books[last]);
+    entries[slot] = entries[last];
+    slots[entries[slot].ID - 1] = slot;
+  }
+  books.pop_back();
+  entries.pop_back();
+  slots[ID - 1] = -1;
+  CHECK_REP();
+}
+
+const Book &IndexedInventory::getBook(int ID) const {
+  if (ID < 1 || ID > (int)slots.size() || slots[ID - 1] < 0) {
+    throw Exception("Invalid book ID.");
+  }
+  return books[slots[ID - 1]];
+}
+
+std::vector<int> IndexedInventory::findByTitle(const std::string &title) const {
+  return lookup(byTitle, title);
+}
+
+std::vector<int> IndexedInventory::findByAuthor(const std::string &author) const {
+  return lookup(byAuthor, author);
+}
+
+void IndexedInventory::printInventory() const {
+  if (books.empty()) {
+    throw Exception("The inventory is empty.");
+  }
+  for (size_t i = 0; i < books.size(); i++) {
+    std::cout << "Book ID: " << entries[i].ID << "\n";
+    std::cout << "Title: " << books[i].title << "\n";
+    std::cout << "Author: " << books[i].author << "\n";
+  }
+}
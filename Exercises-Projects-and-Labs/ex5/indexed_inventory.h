@@ -0,0 +1,158 @@
+#ifndef INDEXED_INVENTORY_H
+#define INDEXED_INVENTORY_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ex5.h"
+
+/**
+ * @brief An inventory like bookInventory for catalogues of millions of books:
+ *        its capacity grows, and the books are found by title or author
+ *        through hash indexes.
+ *
+ * A book keeps the ID addBook gave it until it is removed, instead of the ID
+ * being its index + 1. The books stay packed in an array, a removed one being
+ * replaced by the last, and an array from ID to index finds a book in O(1).
+ * The indexes list the IDs of each title and author in arrays, where each
+ * book records its place, so that removing a book is O(1) however many
+ * others share its title or author.
+ *
+ * repOK walks the whole inventory, so the mutators only check it when
+ * compiled with INVENTORY_REP_CHECK defined.
+ */
+class IndexedInventory {
+
+  typedef std::unordered_map<std::string, std::vector<int>> Index;
+
+  // The ID of a book, and its places in the arrays of its title and author
+  struct Entry {
+    int ID;
+    int titlePos;
+    int authorPos;
+  };
+
+  // Packed books, in no particular order
+  std::vector<Book> books;
+  // The entry of each book in books
+  std::vector<Entry> entries;
+  // The index in books of each ID, with -1 for the removed ones; IDs start at 1
+  std::vector<int> slots;
+  // The IDs of the books by title and by author
+  Index byTitle;
+  Index byAuthor;
+
+  /**
+   * @brief Adds an ID to the array of a key of an index.
+   *
+   * @return The place of the ID in the array.
+   */
+  static int index(Index &index, const std::string &key, int ID);
+
+  /**
+   * @brief Removes the ID at a place of the array of a key of an index, moving
+   *        the last ID of the array there and updating the entry of its book.
+   *
+   * @param place The place of the ID.
+   * @param pos The member of Entry holding the places in this index.
+   */
+  void unindex(Index &index, const std::string &key, int place, int Entry::*pos);
+
+  /**
+   * @brief Returns the IDs of a key of an index.
+   */
+  static std::vector<int> lookup(const Index &index, const std::string &key);
+
+  /**
+   * @brief Checks that an index lists every book once, under its key.
+   *
+   * @param key The member of Book the index is by.
+   * @param pos The member of Entry holding the places in the index.
+   */
+  bool indexOK(const Index &index, std::string Book::*key, int Entry::*pos) const;
+
+public:
+  /**
+   * @brief Makes room for a number of books, so that adding them does not reallocate.
+   *
+   * @param count The number of books.
+   */
+  void reserve(int count);
+
+  /**
+   * @brief Returns the number of books in the inventory.
+   *
+   * @return The number of books.
+   */
+  int getNumBooks() const {
+    return (int)books.size();
+  }
+
+  /**
+   * @brief Returns if the inventory is empty.
+   *
+   * @return True if the inventory is empty, false otherwise.
+   */
+  bool isEmpty() const {
+    return books.empty();
+  }
+
+  /**
+   * @brief Checks if the invariants are true: the IDs and indexes agree with the
+   *        books, and every book has a title or an author. Takes O(n).
+   *
+   * @return True if the invariants are true, false otherwise.
+   */
+  bool repOK() const;
+
+  /**
+   * @brief Adds a book to the inventory, growing it as needed.
+   *
+   * @param book The book to be added.
+   * @return The ID of the book.
+   */
+  int addBook(const Book &book);
+
+  /**
+   * @brief Removes a book from the inventory in O(1), besides the other books sharing its title or author.
+   *
+   * @param ID The ID addBook returned for the book.
+   * @throw Exception if the ID is invalid.
+   *        The exception message should be "Invalid book ID.".
+   */
+  void removeBook(int ID);
+
+  /**
+   * @brief Returns a book of the inventory.
+   *
+   * @param ID The ID addBook returned for the book.
+   * @throw Exception if the ID is invalid.
+   *        The exception message should be "Invalid book ID.".
+   */
+  const Book &getBook(int ID) const;
+
+  /**
+   * @brief Finds the books with a title.
+   *
+   * @return The IDs of the books, in no particular order.
+   */
+  std::vector<int> findByTitle(const std::string &title) const;
+
+  /**
+   * @brief Finds the books by an author.
+   *
+   * @return The IDs of the books, in no particular order.
+   */
+  std::vector<int> findByAuthor(const std::string &author) const;
+
+  /**
+   * @brief Prints the inventory of books, as bookInventory does but with their IDs.
+   *
+   * @throw Exception if the inventory is empty.
+   *        The exception message should be "The inventory is empty.".
+   */
+  void printInventory() const;
+};
+
+#endif
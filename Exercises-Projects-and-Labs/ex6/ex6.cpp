@@ -0,0 +1,159 @@
+#include "ex6.h"
+
+#include <algorithm>
+#include <vector>
+
+// The hash of the empty tree
+static const unsigned long long EMPTY_HASH = 0x9e3779b97f4a7c15ULL;
+
+// Returns x with its bits mixed, by the finalizer of splitmix64
+static unsigned long long mix(unsigned long long x) {
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ULL;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+BinaryTree::BinaryTree() : root(nullptr) {}
+
+BinaryTree::BinaryTree(int val) : root(makeNode(val, nullptr, nullptr)) {}
+
+BinaryTree::BinaryTree(int val, const BinaryTree &left, const BinaryTree &right)
+    : root(makeNode(val, left.root, right.root)) {}
+
+BinaryTree::BinaryTree(const BinaryTree &other) : root(share(other.root)) {}
+
+BinaryTree::BinaryTree(BinaryTree &&other) noexcept : root(other.root) {
+  other.root = nullptr;
+}
+
+BinaryTree &BinaryTree::operator=(const BinaryTree &other) {
+  // Shared before releasing, so that self-assignment keeps the nodes
+  TreeNode *shared = share(other.root);
+  removeAll(root);
+  root = shared;
+  return *this;
+}
+
+BinaryTree &BinaryTree::operator=(BinaryTree &&other) noexcept {
+  if (this != &other) {
+    removeAll(root);
+    root = other.root;
+    other.root = nullptr;
+  }
+  return *this;
+}
+
+BinaryTree::~BinaryTree() {
+  removeAll(root);
+}
+
+bool BinaryTree::operator==(const BinaryTree &other) const {
+  // Trees with different hashes or sizes differ; after a match, which is
+  // almost always of equal trees, they are compared in full
+  if (hashOf(root) != hashOf(other.root) || sizeOf(root) != sizeOf(other.root)) return false;
+  return equal(root, other.root);
+}
+
+bool BinaryTree::operator!=(const BinaryTree &other) const {
+  return !(*this == other);
+}
+
+bool BinaryTree::isEmpty() const {
+  return root == nullptr;
+}
+
+static int sumOf(const TreeNode *root) {
+  if (root == nullptr) return 0;
+  return root->val + sumOf(root->left) + sumOf(root->right);
+}
+
+static int depthOf(const TreeNode *root) {
+  if (root == nullptr) return 0;
+  return 1 + std::max(depthOf(root->left), depthOf(root->right));
+}
+
+static void printInOrder(std::ostream &os, const TreeNode *root, bool &first) {
+  if (root == nullptr) return;
+  printInOrder(os, root->left, first);
+  if (!first) os << " ";
+  os << root->val;
+  first = false;
+  printInOrder(os, root->right, first);
+}
+
+int BinaryTree::sum() const {
+  return sumOf(root);
+}
+
+int BinaryTree::depth() const {
+  return depthOf(root);
+}
+
+std::ostream &operator<<(std::ostream &os, const BinaryTree &tree) {
+  bool first = true;
+  printInOrder(os, tree.root, first);
+  return os;
+}
+
+TreeNode *BinaryTree::makeNode(int val, TreeNode *left, TreeNode *right) {
+  SharedNode *shared = new SharedNode;
+  shared->node.val = val;
+  shared->node.left = share(left);
+  shared->node.right = share(right);
+  shared->refs = 1;
+  shared->size = 1 + sizeOf(left) + sizeOf(right);
+  // The hashes of the children in order, so that mirrored trees differ
+  shared->hash = mix(mix(mix(val) * 31 + hashOf(left)) * 31 + hashOf(right));
+  return &shared->node;
+}
+
+TreeNode *BinaryTree::share(TreeNode *root) {
+  // node is the first member of the standard-layout SharedNode
+  if (root != nullptr) reinterpret_cast<SharedNode *>(root)->refs++;
+  return root;
+}
+
+unsigned long long BinaryTree::hashOf(const TreeNode *root) {
+  if (root == nullptr) return EMPTY_HASH;
+  return reinterpret_cast<const SharedNode *>(root)->hash;
+}
+
+int BinaryTree::sizeOf(const TreeNode *root) {
+  if (root == nullptr) return 0;
+  return reinterpret_cast<const SharedNode *>(root)->size;
+}
+
+TreeNode *BinaryTree::copy(TreeNode *root) {
+  if (root == nullptr) return nullptr;
+  TreeNode *left = copy(root->left);
+  TreeNode *right = copy(root->right);
+  TreeNode *node = makeNode(root->val, left, right);
+  // makeNode took its own reference to the fresh children
+  removeAll(left);
+  removeAll(right);
+  return node;
+}
+
+void BinaryTree::removeAll(TreeNode *root) {
+  // Iterative, so that releasing a deep tree does not overflow the stack
+  std::vector<TreeNode *> pending;
+  pending.push_back(root);
+  while (!pending.empty()) {
+    TreeNode *node = pending.back();
+    pending.pop_back();
+    if (node == nullptr) continue;
+    SharedNode *shared = reinterpret_cast<SharedNode *>(node);
+    if (--shared->refs > 0) continue;
+    pending.push_back(node->left);
+    pending.push_back(node->right);
+    delete shared;
+  }
+}
+
+bool BinaryTree::equal(TreeNode *root, TreeNode *other) const {
+  if (root == other) return true;
+  if (root == nullptr || other == nullptr) return false;
+  return root->val == other->val && equal(root->left, other->left) && equal(root->right, other->right);
+}
@@ -16,6 +16,12 @@ struct TreeNode {
 /**
  * @class BinaryTree
  * @brief Implements a simple binary tree data structure.
+ *
+ * The nodes are shared between trees and reference counted: a copy, or a
+ * tree built from subtrees, points to the same nodes in O(1), and no public
+ * member function modifies a node once it is built, so each tree behaves as
+ * a deep copy. The counts are not atomic, so trees sharing nodes must not be
+ * copied or destroyed from different threads at once.
  */
 class BinaryTree {
 public:
@@ -34,6 +40,7 @@ public:
 
   /**
    * @brief Parameterized constructor to create a binary tree with given value and subtrees.
+   * The subtrees are shared, not copied.
    * @param val The value for the root node of the binary tree.
    * @param left The left subtree.
    * @param right The right subtree.
@@ -41,11 +48,17 @@ public:
   BinaryTree(int val, const BinaryTree &left, const BinaryTree &right);
 
   /**
-   * @brief Copy constructor that creates a deep copy of another binary tree.
+   * @brief Copy constructor that creates a copy of another binary tree, sharing its nodes.
    * @param other The binary tree to copy from.
    */
   BinaryTree(const BinaryTree &other);
 
+  /**
+   * @brief Move constructor that takes the nodes of another binary tree.
+   * @param other The binary tree to move from, left empty.
+   */
+  BinaryTree(BinaryTree &&other) noexcept;
+
   /**
    * @brief Assignment operator that copies the content of another binary tree.
    * @param other The binary tree to assign from.
@@ -53,6 +66,13 @@ public:
    */
   BinaryTree &operator=(const BinaryTree &other);
 
+  /**
+   * @brief Move assignment operator that takes the nodes of another binary tree.
+   * @param other The binary tree to move from, left empty.
+   * @return A reference to the modified binary tree.
+   */
+  BinaryTree &operator=(BinaryTree &&other) noexcept;
+
   /**
    * @brief Destructor that cleans up the allocated resources of the binary tree.
    */
@@ -60,6 +80,7 @@ public:
 
   /**
    * @brief Checks equality between this binary tree and another binary tree.
+   * Trees whose hashes or sizes differ are unequal in O(1).
    * @param other The binary tree to compare with.
    * @return True if the trees are equal, false otherwise.
    */
@@ -116,20 +137,64 @@ private:
   TreeNode *root;
 
   /**
-   * @brief Recursively copies all nodes from another tree.
+   * @struct SharedNode
+   * @brief A TreeNode with the number of trees and nodes pointing to it, and
+   * the structural hash and the size of its subtree, which never change
+   * since the node is not modified once built.
+   */
+  struct SharedNode {
+    TreeNode node;
+    int refs;
+    int size;
+    unsigned long long hash;
+  };
+
+  /**
+   * @brief Allocates a node, pointed to once, and takes a reference to the children.
+   * @param val The value of the node.
+   * @param left The left child, or nullptr.
+   * @param right The right child, or nullptr.
+   * @return The new node.
+   */
+  static TreeNode *makeNode(int val, TreeNode *left, TreeNode *right);
+
+  /**
+   * @brief Takes one more reference to a node.
+   * @param root The node to share, or nullptr.
+   * @return root.
+   */
+  static TreeNode *share(TreeNode *root);
+
+  /**
+   * @brief Gets the structural hash of a tree: equal trees have equal hashes.
+   * @param root The root node of the tree, or nullptr.
+   * @return The hash of the tree.
+   */
+  static unsigned long long hashOf(const TreeNode *root);
+
+  /**
+   * @brief Gets the number of nodes of a tree.
+   * @param root The root node of the tree, or nullptr.
+   * @return The number of nodes.
+   */
+  static int sizeOf(const TreeNode *root);
+
+  /**
+   * @brief Recursively copies all nodes from another tree, so that none of them is shared.
+   * This is what a member function modifying the nodes would do first.
    * @param root The root node of the tree to copy.
    * @return The root node of the copied tree.
    */
   TreeNode *copy(TreeNode *root);
 
   /**
-   * @brief Recursively removes all nodes from the tree, deallocating memory.
+   * @brief Releases one reference to a tree, deallocating the nodes no other tree points to.
    * @param root The root node of the tree to remove.
    */
   void removeAll(TreeNode *root);
 
   /**
-   * @brief Recursively checks equality between two trees.
+   * @brief Recursively checks equality between two trees, in O(1) for a shared subtree.
    * @param root The root node of the first tree.
    * @param other The root node of the second tree.
    * @return True if the trees are equal, false otherwise.
@@ -1,5 +1,10 @@
 #include <iostream>
 #include <cmath>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <thread>
 
 using namespace std;
 
@@ -17,18 +22,31 @@ bool triangle(int num)
 }
 
 /**
- * judge whether a number is a palindrome
+ * split a number into its digits, without any allocation
  * @param  int 	num		number
- * @return bool
+ * @param  char	digit[]	the digits of num, the lowest first
+ * @return int 			the number of digits, 0 for 0
  */
-bool palindrome(int num)
+int digits(int num, unsigned char digit[10])
 {
-	int arr[8] = {}, n = 0;
+	int n = 0;
 	while (num != 0)
 	{
-		arr[n++] = num % 10;
+		digit[n++] = num % 10;
 		num /= 10;
 	}
+	return n;
+}
+
+/**
+ * judge whether a number is a palindrome
+ * @param  int 	num		number
+ * @return bool
+ */
+bool palindrome(int num)
+{
+	unsigned char arr[10];
+	int n = digits(num, arr);
 	for (int i = 0; i < n / 2; i++)
 	{
 		if (arr[i] != arr[n - 1 - i])
@@ -99,8 +117,230 @@ bool abundant(int num)
 	return sum > num_;
 }
 
-int main()
+/**
+ * A bitmap of the numbers from 0 to MAX_NUM, filled at compile time
+ */
+struct bitmap
+{
+	unsigned char bits[MAX_NUM / 8 + 1];
+
+	constexpr void set(long long num)
+	{
+		bits[num >> 3] |= 1 << (num & 7);
+	}
+
+	constexpr bool test(int num) const
+	{
+		return bits[num >> 3] >> (num & 7) & 1;
+	}
+};
+
+/**
+ * make the bitmap of the triangle numbers n * (n + 1) / 2
+ * @return bitmap
+ */
+constexpr bitmap make_triangles()
+{
+	bitmap b{};
+	for (long long n = 0; n * (n + 1) / 2 <= MAX_NUM; n++)
+	{
+		b.set(n * (n + 1) / 2);
+	}
+	return b;
+}
+
+/**
+ * make the bitmap of the palindromes, by mirroring every first half
+ * of their digits, without repeating the middle digit of odd lengths
+ * @return bitmap
+ */
+constexpr bitmap make_palindromes()
+{
+	bitmap b{};
+	for (int length = 1; length <= 8; length++)
+	{
+		long long low = 1;
+		for (int i = 1; i < (length + 1) / 2; i++) low *= 10;
+		for (long long half = length == 1 ? 0 : low; half < low * 10; half++)
+		{
+			long long num = half;
+			for (long long rest = length % 2 ? half / 10 : half; rest > 0; rest /= 10)
+			{
+				num = num * 10 + rest % 10;
+			}
+			if (num <= MAX_NUM) b.set(num);
+		}
+	}
+	return b;
+}
+
+/**
+ * make the bitmap of the power numbers n ^ i, i >= 2, 1 = 1 ^ 2 included
+ * @return bitmap
+ */
+constexpr bitmap make_powers()
+{
+	bitmap b{};
+	b.set(1);
+	for (long long n = 2; n * n <= MAX_NUM; n++)
+	{
+		for (long long p = n * n; p <= MAX_NUM; p *= n)
+		{
+			b.set(p);
+		}
+	}
+	return b;
+}
+
+// The abundant numbers are not tabled: their divisor sums need a sieve of
+// about 10^8 steps up to MAX_NUM, far beyond what a compiler evaluates
+constexpr bitmap TRIANGLES = make_triangles();
+constexpr bitmap PALINDROMES = make_palindromes();
+constexpr bitmap POWERS = make_powers();
+
+/**
+ * test a number against a bitmap, or by its runtime test out of its range
+ * @param  bitmap	table	bitmap of the numbers passing the test
+ * @param  bool(*)(int)	test	runtime test
+ * @param  int 	num		number
+ * @return bool
+ */
+bool lookup(const bitmap &table, bool (*test)(int), int num)
+{
+	return num >= 0 && num <= MAX_NUM ? table.test(num) : test(num);
+}
+
+/**
+ * the classes of a number, as bits of the results of classify
+ */
+const unsigned char TRIANGLE = 1, PALINDROME = 2, POWER = 4, ABUNDANT = 8;
+
+/**
+ * how many numbers are classified at a time, so that a block and the divisor
+ * sums of its numbers fit in the cache
+ */
+const int CLASSIFY_BLOCK = 1 << 16;
+
+/**
+ * mark the abundant numbers in [lo, hi), by sieving the sums of their divisors:
+ * each divisor d <= sqrt(n) adds d and n / d to the sum of n
+ * @param  int 	lo		first number, at least 1
+ * @param  int 	hi		end of the numbers
+ * @param  unsigned char*	classes	classes of lo + i at index i
+ */
+void classify_abundant(int lo, int hi, unsigned char *classes)
+{
+	vector<long long> sum(hi - lo);
+	for (long long d = 1; d * d < hi; d++)
+	{
+		// the first multiple of d in the block that is at least d * d
+		long long n = max(d * d, (lo + d - 1) / d * d);
+		for (; n < hi; n += d)
+		{
+			sum[n - lo] += n / d == d ? d : d + n / d;
+		}
+	}
+	for (int n = lo; n < hi; n++)
+	{
+		// the sum includes the number itself
+		if (sum[n - lo] - n > n)classes[n - lo] |= ABUNDANT;
+	}
+}
+
+/**
+ * classify every number of [lo, hi) at once, by blocks of CLASSIFY_BLOCK
+ * numbers that the threads take in turn until none is left
+ * @param  int 	lo		first number, at least 1
+ * @param  int 	hi		end of the numbers
+ * @param  int 	threads	number of threads, at least 1
+ * @return vector	classes of lo + i at index i, as bits
+ */
+vector<unsigned char> classify(int lo, int hi, int threads)
+{
+	vector<unsigned char> classes(hi > lo ? hi - lo : 0);
+	atomic<long long> next(lo);
+	auto work = [&]()
+	{
+		for (long long start; (start = next.fetch_add(CLASSIFY_BLOCK)) < hi;)
+		{
+			int end = min<long long>(start + CLASSIFY_BLOCK, hi);
+			unsigned char *block = &classes[start - lo];
+			for (int n = start; n < end; n++)
+			{
+				block[n - start] = lookup(TRIANGLES, triangle, n) * TRIANGLE
+					| lookup(PALINDROMES, palindrome, n) * PALINDROME
+					| lookup(POWERS, power, n) * POWER;
+			}
+			classify_abundant(start, end, block);
+		}
+	};
+	vector<thread> pool;
+	for (int i = 1; i < threads; i++)
+	{
+		pool.emplace_back(work);
+	}
+	work();
+	for (size_t i = 0; i < pool.size(); i++)
+	{
+		pool[i].join();
+	}
+	return classes;
+}
+
+/**
+ * with a range, count the numbers of each class in it, or with a class other
+ * than all, list the numbers of that class, one per line
+ * @param  int 	argc	number of arguments, 3 to 5
+ * @param  char**	argv	lo hi [class [threads]]
+ * @return int
+ */
+int batch(int argc, char *argv[])
 {
+	const char *names[] = {"triangle", "palindrome", "power", "abundant"};
+	int only = -1;
+	if (argc >= 4)
+	{
+		for (int i = 0; i < 4; i++)
+		{
+			string(argv[3]) == names[i] ? only = i : 1;
+		}
+		if (only < 0 && string(argv[3]) != "all")
+		{
+			cerr << "Unknown class " << argv[3] << endl;
+			return 1;
+		}
+	}
+	// 0 and the negative numbers are not tested
+	int lo = max(atoi(argv[1]), 1), hi = atoi(argv[2]);
+	int threads = argc == 5 ? atoi(argv[4]) : thread::hardware_concurrency();
+	vector<unsigned char> classes = classify(lo, hi, max(threads, 1));
+	if (only >= 0)
+	{
+		for (size_t j = 0; j < classes.size(); j++)
+		{
+			if (classes[j] & (1 << only))cout << lo + j << '\n';
+		}
+		return 0;
+	}
+	for (int i = 0; i < 4; i++)
+	{
+		size_t count = 0;
+		for (size_t j = 0; j < classes.size(); j++)
+		{
+			(classes[j] & (1 << i)) ? count++ : 1;
+		}
+		cout << names[i] << ": " << count << endl;
+	}
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	if (argc >= 3 && argc <= 5)
+	{
+		return batch(argc, argv);
+	}
+
 	begin:
 	
 	cout << "Please enter the integer and the test number: ";
@@ -115,13 +355,13 @@ int main()
 	switch (type)
 	{
 	case 1:
-		cout << triangle(num);
+		cout << lookup(TRIANGLES, triangle, num);
 		break;
 	case 2:
-		cout << palindrome(num);
+		cout << lookup(PALINDROMES, palindrome, num);
 		break;
 	case 3:
-		cout << power(num);
+		cout << lookup(POWERS, power, num);
 		break;
 	case 4:
 		cout << abundant(num);
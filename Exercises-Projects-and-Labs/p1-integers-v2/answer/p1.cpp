@@ -4,7 +4,11 @@
 
 #include <iostream>
 #include <cmath>
+#include <cstdlib>
 #include <string>
+#include <vector>
+#include <atomic>
+#include <thread>
 
 using namespace std;
 
@@ -65,37 +69,41 @@ bool consecutive(unsigned int num)
 }
 
 /**
+ * Split a number into its digits, without any allocation
  * @param num
- * @return whether num is a repeated number
+ * @param digit the digits of num, the lowest first
+ * @return the number of digits, 0 for 0
  */
-bool repeated(unsigned int num)
+int digits(unsigned int num, unsigned char digit[10])
 {
-    string str;
+    int length = 0;
     while (num > 0)
     {
-        str += num % 10 + '0';
+        digit[length++] = num % 10;
         num /= 10;
     }
+    return length;
+}
+
+/**
+ * @param num
+ * @return whether num is a repeated number
+ */
+bool repeated(unsigned int num)
+{
+    unsigned char digit[10];
+    int length = digits(num, digit);
     // String of length 1 must be false
-    if (str.length() < 2)return false;
-    for (int i = 1; i <= str.length() / 2; i++)
+    if (length < 2)return false;
+    for (int i = 1; i <= length / 2; i++)
     {
         // The digits of the repeated string must be a divisor of the total length
-        if (str.length() % i > 0)continue;
-        // Save the first i digits
-        string repeat = str.substr(0, i);
-        bool flag = true;
-        for (int j = i; j < str.length(); j += i)
-        {
-            // Set the flag when any of the tests failed
-            if (str.substr(j, i) != repeat)
-            {
-                flag = false;
-                break;
-            }
-        }
+        if (length % i > 0)continue;
+        // Repeated with i digits when every digit equals the one i digits before
+        int j = i;
+        while (j < length && digit[j] == digit[j - i]) j++;
         // test passed, it is repeated with i digits
-        if (flag) return true;
+        if (j == length) return true;
     }
     // All tests failed
     return false;
@@ -180,8 +188,304 @@ bool divisor_2(unsigned int num)
     return sum == num;
 }
 
-int main()
+/**
+ * The largest number main accepts, and the bitmaps below cover
+ */
+const unsigned int LOOKUP_MAX = 10000000;
+
+/**
+ * A bitmap of the numbers from 0 to LOOKUP_MAX, filled at compile time
+ */
+struct bitmap
+{
+    unsigned char bits[LOOKUP_MAX / 8 + 1];
+
+    constexpr void set(unsigned long long num)
+    {
+        bits[num >> 3] |= 1 << (num & 7);
+    }
+
+    constexpr bool test(unsigned int num) const
+    {
+        return bits[num >> 3] >> (num & 7) & 1;
+    }
+};
+
+/**
+ * @return the bitmap of the fibonacci numbers
+ */
+constexpr bitmap make_fibonaccis()
+{
+    bitmap b{};
+    for (unsigned long long a = 0, c = 1; a <= LOOKUP_MAX; c = a + c, a = c - a)
+    {
+        b.set(a);
+    }
+    return b;
+}
+
+/**
+ * @return the bitmap of the consecutive numbers, every sum of consecutive squares
+ */
+constexpr bitmap make_consecutives()
 {
+    bitmap b{};
+    for (unsigned long long m = 0; m * m <= LOOKUP_MAX; m++)
+    {
+        for (unsigned long long n = m, sum = m * m; sum <= LOOKUP_MAX; n++, sum += n * n)
+        {
+            b.set(sum);
+        }
+    }
+    return b;
+}
+
+/**
+ * @return the bitmap of the repeated numbers, every block of i digits repeated
+ */
+constexpr bitmap make_repeateds()
+{
+    bitmap b{};
+    for (int length = 2; length <= 8; length++)
+    {
+        for (int i = 1; i <= length / 2; i++)
+        {
+            if (length % i > 0)continue;
+            unsigned long long low = 1, repeat = 0;
+            for (int j = 1; j < i; j++) low *= 10;
+            for (int j = 0; j < length; j += i) repeat = repeat * low * 10 + 1;
+            for (unsigned long long block = low; block < low * 10 && block * repeat <= LOOKUP_MAX; block++)
+            {
+                b.set(block * repeat);
+            }
+        }
+    }
+    return b;
+}
+
+/**
+ * @return the bitmap of the divisor numbers: by Euclid and Euler, the even ones
+ * are 2 ^ (p - 1) * (2 ^ p - 1) with 2 ^ p - 1 prime, and no odd one is known
+ * below 10 ^ 1500
+ */
+constexpr bitmap make_divisors()
+{
+    bitmap b{};
+    for (unsigned long long p = 2; (1ull << (p - 1)) * ((1ull << p) - 1) <= LOOKUP_MAX; p++)
+    {
+        unsigned long long mersenne = (1ull << p) - 1;
+        bool prime = true;
+        for (unsigned long long d = 2; d * d <= mersenne; d++)
+        {
+            if (mersenne % d == 0)prime = false;
+        }
+        if (prime)b.set((1ull << (p - 1)) * mersenne);
+    }
+    return b;
+}
+
+constexpr bitmap FIBONACCIS = make_fibonaccis();
+constexpr bitmap CONSECUTIVES = make_consecutives();
+constexpr bitmap REPEATEDS = make_repeateds();
+constexpr bitmap DIVISORS = make_divisors();
+
+/**
+ * Test a number against a bitmap, or by its runtime test out of its range
+ * @param table the bitmap of the numbers passing the test
+ * @param test the runtime test
+ * @param num
+ * @return whether num passes the test
+ */
+bool lookup(const bitmap &table, bool (*test)(unsigned int), unsigned int num)
+{
+    return num <= LOOKUP_MAX ? table.test(num) : test(num);
+}
+
+/**
+ * The classes of a number, as bits of the results of classify
+ */
+const unsigned char FIBONACCI = 1, CONSECUTIVE = 2, REPEATED = 4, DIVISOR = 8;
+
+/**
+ * How many numbers the divisor sums are sieved for at a time
+ */
+const unsigned int SIEVE_BLOCK = 1 << 16;
+
+/**
+ * Mark the fibonacci numbers in [lo, hi), walking the sequence once
+ * @param lo
+ * @param hi
+ * @param classes the classes of lo + i at index i
+ */
+void classify_fibonacci(unsigned int lo, unsigned int hi, vector<unsigned char> &classes)
+{
+    for (unsigned long long a = 0, b = 1; a < hi; b = a + b, a = b - a)
+    {
+        if (a >= lo)classes[a - lo] |= FIBONACCI;
+    }
+}
+
+/**
+ * Mark the consecutive numbers in [lo, hi), by making every sum of consecutive
+ * squares below hi: there are O(hi ^ (2/3)) of them
+ * @param lo
+ * @param hi
+ * @param classes the classes of lo + i at index i
+ */
+void classify_consecutive(unsigned int lo, unsigned int hi, vector<unsigned char> &classes)
+{
+    // As in consecutive, the squares may start from 0
+    for (unsigned long long m = 0; m * m < hi; m++)
+    {
+        for (unsigned long long n = m, sum = m * m; sum < hi; n++, sum += n * n)
+        {
+            if (sum >= lo)classes[sum - lo] |= CONSECUTIVE;
+        }
+    }
+}
+
+/**
+ * Mark the repeated numbers in [lo, hi), by making them: a repeated number of
+ * length digits with a block of i digits is the block times 1 0..01 0..01 ...
+ * @param lo
+ * @param hi
+ * @param classes the classes of lo + i at index i
+ */
+void classify_repeated(unsigned int lo, unsigned int hi, vector<unsigned char> &classes)
+{
+    for (int length = 2; length <= 10; length++)
+    {
+        for (int i = 1; i <= length / 2; i++)
+        {
+            if (length % i > 0)continue;
+            unsigned long long low = 1, repeat = 0;
+            for (int j = 1; j < i; j++) low *= 10;
+            for (int j = 0; j < length; j += i) repeat = repeat * low * 10 + 1;
+            // Only the blocks of i digits whose repeat is in the range
+            unsigned long long first = max(low, (lo + repeat - 1) / repeat);
+            unsigned long long last = min(low * 10, (hi + repeat - 1) / repeat);
+            for (unsigned long long block = first; block < last; block++)
+            {
+                classes[block * repeat - lo] |= REPEATED;
+            }
+        }
+    }
+}
+
+/**
+ * Mark the divisor numbers in [lo, hi), by sieving the sums of divisors by
+ * blocks: each divisor d <= sqrt(n) adds d and n / d to the sum of n, which is
+ * O(log n) amortised per number instead of the trial divisions of divisor
+ * @param lo
+ * @param hi
+ * @param classes the classes of lo + i at index i
+ */
+void classify_divisor(unsigned int lo, unsigned int hi, vector<unsigned char> &classes)
+{
+    vector<unsigned long long> sum(SIEVE_BLOCK);
+    // 0 has no sum of divisors
+    for (unsigned long long start = max(lo, 1u); start < hi; start += SIEVE_BLOCK)
+    {
+        unsigned long long end = min<unsigned long long>(start + SIEVE_BLOCK, hi);
+        fill(sum.begin(), sum.end(), 0);
+        for (unsigned long long d = 1; d * d < end; d++)
+        {
+            // The first multiple of d in the block that is at least d * d
+            unsigned long long n = max(d * d, (start + d - 1) / d * d);
+            for (; n < end; n += d)
+            {
+                sum[n - start] += n / d == d ? d : d + n / d;
+            }
+        }
+        for (unsigned long long n = start; n < end; n++)
+        {
+            // The sum includes the number itself
+            if (sum[n - start] == 2 * n)classes[n - lo] |= DIVISOR;
+        }
+    }
+}
+
+/**
+ * Classify every number of [lo, hi) at once, in amortised constant time per
+ * class for all but divisor, which is amortised O(log n). The divisor sieve is
+ * most of the work, so it is split across the threads by blocks of SIEVE_BLOCK
+ * numbers that fit in the cache with their sums, each thread taking the next
+ * block when it is done so that none of them stays idle
+ * @param lo
+ * @param hi
+ * @param threads the number of threads, at least 1
+ * @return the classes of lo + i at index i, as bits
+ */
+vector<unsigned char> classify(unsigned int lo, unsigned int hi, unsigned int threads = 1)
+{
+    vector<unsigned char> classes(hi > lo ? hi - lo : 0);
+    if (hi <= lo)return classes;
+    classify_fibonacci(lo, hi, classes);
+    classify_consecutive(lo, hi, classes);
+    classify_repeated(lo, hi, classes);
+    atomic<unsigned long long> next(lo);
+    auto sieve = [&]()
+    {
+        vector<unsigned char> block(SIEVE_BLOCK);
+        for (unsigned long long start; (start = next.fetch_add(SIEVE_BLOCK)) < hi;)
+        {
+            unsigned long long end = min<unsigned long long>(start + SIEVE_BLOCK, hi);
+            fill(block.begin(), block.end(), 0);
+            classify_divisor(start, end, block);
+            // The blocks are disjoint, so are the bytes the threads write
+            for (unsigned long long n = start; n < end; n++) classes[n - lo] |= block[n - start];
+        }
+    };
+    vector<thread> pool;
+    for (unsigned int i = 1; i < threads; i++) pool.emplace_back(sieve);
+    sieve();
+    for (size_t i = 0; i < pool.size(); i++) pool[i].join();
+    return classes;
+}
+
+int main(int argc, char *argv[])
+{
+    // With a range, count the numbers of each class in it, or with a class
+    // other than all, list the numbers of that class, one per line
+    if (argc >= 3 && argc <= 5)
+    {
+        const char *names[] = {"fibonacci", "consecutive", "repeated", "divisor"};
+        int only = -1;
+        if (argc >= 4)
+        {
+            for (int i = 0; i < 4; i++)
+            {
+                if (string(argv[3]) == names[i])only = i;
+            }
+            if (only < 0 && string(argv[3]) != "all")
+            {
+                cerr << "Unknown class " << argv[3] << endl;
+                return 1;
+            }
+        }
+        unsigned int lo = strtoul(argv[1], NULL, 10), hi = strtoul(argv[2], NULL, 10);
+        unsigned int threads = argc == 5 ? strtoul(argv[4], NULL, 10) : thread::hardware_concurrency();
+        vector<unsigned char> classes = classify(lo, hi, max(threads, 1u));
+        if (only >= 0)
+        {
+            for (size_t j = 0; j < classes.size(); j++)
+            {
+                if (classes[j] & (1 << only))cout << lo + j << '\n';
+            }
+            return 0;
+        }
+        for (int i = 0; i < 4; i++)
+        {
+            size_t count = 0;
+            for (size_t j = 0; j < classes.size(); j++)
+            {
+                if (classes[j] & (1 << i))count++;
+            }
+            cout << names[i] << ": " << count << endl;
+        }
+        return 0;
+    }
+
     int choice, num;
     bool flag;
     do
@@ -193,20 +497,20 @@ int main()
     {
         cout << "Please enter the number for test: " << endl;
         cin >> num;
-    } while (num < 0 || num > 1e7);
+    } while (num < 0 || unsigned(num) > LOOKUP_MAX);
     switch (choice)
     {
         case 1:
-            flag = fibonacci(num);
+            flag = lookup(FIBONACCIS, fibonacci, num);
             break;
         case 2:
-            flag = consecutive(num);
+            flag = lookup(CONSECUTIVES, consecutive, num);
             break;
         case 3:
-            flag = repeated(num);
+            flag = lookup(REPEATEDS, repeated, num);
             break;
         case 4:
-            flag = divisor(num);
+            flag = lookup(DIVISORS, divisor, num);
             break;
     }
     cout << (flag ? "Pass" : "Fail") << endl;
@@ -2,52 +2,85 @@
 // Created by liu on 17-6-5.
 //
 
+#include <atomic>
+#include <functional>
+#include <future>
+#include <unordered_set>
+#include <vector>
 #include "p2.h"
 
-#ifndef MIN_INT
-#define MIN_INT (1 << (8 * sizeof(int) - 1))
-#endif
-#ifndef max
-#define max(a,b) (((a) > (b)) ? (a) : (b))
-#endif
-#ifndef min
-#define min(a,b) (((a) < (b)) ? (a) : (b))
-#endif
+// The list functions below pass accumulators so that every recursive call is
+// a tail call, which the compiler turns into a jump: long lists no longer
+// overflow the stack. Lists built front to back are built reversed, then
+// reversed once.
+
+static int size_helper(list_t list, int count)
+{
+    return list_isEmpty(list) ? count : size_helper(list_rest(list), count + 1);
+}
 
 int size(list_t list)
 {
-    return list_isEmpty(list) ? 0 : size(list_rest(list)) + 1;
+    return size_helper(list, 0);
 }
 
 bool memberOf(list_t list, int val)
 {
-    return list_isEmpty(list) ? false : (list_first(list) == val || memberOf(list_rest(list), val));
+    return list_isEmpty(list) ? false : list_first(list) == val ? true : memberOf(list_rest(list), val);
 }
 
+#ifndef LIST_SLICES
+static int dot_helper(list_t v1, list_t v2, int sum)
+{
+    return (list_isEmpty(v1) || list_isEmpty(v2)) ? sum :
+           dot_helper(list_rest(v1), list_rest(v2), sum + list_first(v1) * list_first(v2));
+}
+#endif
+
 int dot(list_t v1, list_t v2)
 {
-    return (list_isEmpty(v1) || list_isEmpty(v2)) ? 0 : (list_first(v1) * list_first(v2) + dot(list_rest(v1), list_rest(v2)));
+#ifdef LIST_SLICES
+    // the elements of a slice are contiguous, so this is a loop the
+    // compiler vectorizes
+    const int *e1 = v1.elts + v1.offset, *e2 = v2.elts + v2.offset;
+    unsigned int length = v1.length < v2.length ? v1.length : v2.length;
+    int sum = 0;
+    for (unsigned int i = 0; i < length; i++) {
+        sum += e1[i] * e2[i];
+    }
+    return sum;
+#else
+    return dot_helper(v1, v2, 0);
+#endif
 }
 
 bool isIncreasing(list_t v)
 {
-    return (list_isEmpty(v) || list_isEmpty(list_rest(v))) ? true : (list_first(v) <= list_first(list_rest(v)) && isIncreasing(list_rest(v)));
+    return (list_isEmpty(v) || list_isEmpty(list_rest(v))) ? true :
+           list_first(v) > list_first(list_rest(v)) ? false : isIncreasing(list_rest(v));
+}
+
+static list_t reverse_helper(list_t list, list_t reversed)
+    // EFFECTS: returns the elements of "list" in reverse order, followed by "reversed"
+{
+    return list_isEmpty(list) ? reversed : reverse_helper(list_rest(list), list_make(list_first(list), reversed));
 }
 
 list_t reverse(list_t list)
 {
-    return list_isEmpty(list) ? list_make() : append(reverse(list_rest(list)), list_make(list_first(list), list_make()));
+    return reverse_helper(list, list_make());
 }
 
 list_t append(list_t first, list_t second)
 {
-    return list_isEmpty(first) ? second : list_make(list_first(first), append(list_rest(first), second));
+    return list_isEmpty(first) ? second : reverse_helper(reverse(first), second);
 }
 
 bool isArithmeticSequence(list_t v)
 {
     return (list_isEmpty(v) || list_isEmpty(list_rest(v)) || list_isEmpty(list_rest(list_rest(v)))) ? true :
-           (list_first(v) + list_first(list_rest(list_rest(v))) == 2 * list_first(list_rest(v)) && isArithmeticSequence(list_rest(v)));
+           list_first(v) + list_first(list_rest(list_rest(v))) != 2 * list_first(list_rest(v)) ? false :
+           isArithmeticSequence(list_rest(v));
 }
 
 list_t filter_odd(list_t list)
@@ -55,36 +88,65 @@ list_t filter_odd(list_t list)
     return filter(list, [](int a)->bool {return a % 2 != 0;});
 }
 
+static list_t filter_helper(list_t list, bool(*fn)(int), list_t kept)
+    // EFFECTS: returns the elements of "list" for which fn() is true in reverse order, followed by "kept"
+{
+    return list_isEmpty(list) ? kept :
+           filter_helper(list_rest(list), fn, fn(list_first(list)) ? list_make(list_first(list), kept) : kept);
+}
+
 list_t filter(list_t list, bool(*fn)(int))
 {
-    return list_isEmpty(list) ? list_make() : fn(list_first(list)) ? list_make(list_first(list), filter(list_rest(list), fn)) : filter(list_rest(list), fn);
+    return reverse(filter_helper(list, fn, list_make()));
 }
 
-static list_t unique_helper(list_t old, list_t list)
+static list_t unique_helper(list_t old, std::unordered_set<int> &seen, list_t list)
+    // MODIFIES: seen
+    // EFFECTS: returns the first occurrences of the elements of "old" not in "seen" in reverse
+    //          order, followed by "list"
 {
     return list_isEmpty(old) ? list :
-           (memberOf(list, list_first(old)) ? unique_helper(list_rest(old), list) :
-           unique_helper(list_rest(old), list_make(list_first(old), list)));
+           (!seen.insert(list_first(old)).second ? unique_helper(list_rest(old), seen, list) :
+           unique_helper(list_rest(old), seen, list_make(list_first(old), list)));
 }
 
 list_t unique(list_t list)
 {
-    return reverse(unique_helper(list, list_make()));
+    std::unordered_set<int> seen;
+    return reverse(unique_helper(list, seen, list_make()));
+}
+
+static list_t take_helper(list_t list, unsigned int n, list_t taken)
+    // REQUIRES: "list" has at least n elements
+    // EFFECTS: returns the first n elements of "list" in reverse order, followed by "taken"
+{
+    return n == 0 ? taken : take_helper(list_rest(list), n - 1, list_make(list_first(list), taken));
+}
+
+static list_t drop(list_t list, unsigned int n)
+    // REQUIRES: "list" has at least n elements
+    // EFFECTS: returns "list" without its first n elements
+{
+    // a loop rather than a tail call, which gcc does not always turn into a jump here
+    while (n-- > 0) {
+        list = list_rest(list);
+    }
+    return list;
 }
 
 list_t insert_list(list_t first, list_t second, unsigned int n)
 {
-    return append(append(chop(first, size(first) - n), second), reverse(chop(reverse(first), n)));
+    return reverse_helper(take_helper(first, n, list_make()), append(second, drop(first, n)));
 }
 
 list_t chop(list_t list, unsigned int n)
 {
-    return n > 0 ? reverse(list_rest(reverse(chop(list, n - 1)))) : list;
+    return reverse(take_helper(list, (unsigned int) size(list) - n, list_make()));
 }
 
 int tree_sum(tree_t tree)
 {
-    return tree_isEmpty(tree) ? 0 : tree_elt(tree) + tree_sum(tree_left(tree)) + tree_sum(tree_right(tree));
+    return tree_eltSum(tree);
 }
 
 bool tree_search(tree_t tree, int key)
@@ -94,23 +156,59 @@ bool tree_search(tree_t tree, int key)
 
 int depth(tree_t tree)
 {
-    return tree_isEmpty(tree) ? 0 : max(depth(tree_left(tree)), depth(tree_right(tree))) + 1;
+    return tree_height(tree);
 }
 
 int tree_max(tree_t tree)
 {
-    return tree_isEmpty(tree) ? MIN_INT : max(tree_elt(tree), max(tree_max(tree_left(tree)), tree_max(tree_right(tree))));
+    return tree_eltMax(tree);
+}
+
+// The traversals build their lists from the back, the right subtree
+// first, onto the list that follows: each element takes one cell, and no
+// list is copied by append.
+
+static list_t traversal_helper(tree_t tree, list_t list)
+    // EFFECTS: returns the elements of "tree" in the order of traversal, followed by "list"
+{
+    return tree_isEmpty(tree) ? list :
+           traversal_helper(tree_left(tree), list_make(tree_elt(tree), traversal_helper(tree_right(tree), list)));
 }
 
 list_t traversal(tree_t tree)
 {
-    return tree_isEmpty(tree) ? list_make() : append(traversal(tree_left(tree)), list_make(tree_elt(tree), traversal(tree_right(tree))));
+    return traversal_helper(tree, list_make());
+}
+
+static list_t preorder_helper(tree_t tree, list_t list)
+    // EFFECTS: returns the elements of "tree" in pre-order, followed by "list"
+{
+    return tree_isEmpty(tree) ? list :
+           list_make(tree_elt(tree), preorder_helper(tree_left(tree), preorder_helper(tree_right(tree), list)));
+}
+
+list_t traversal_preorder(tree_t tree)
+{
+    return preorder_helper(tree, list_make());
+}
+
+static list_t postorder_helper(tree_t tree, list_t list)
+    // EFFECTS: returns the elements of "tree" in post-order, followed by "list"
+{
+    return tree_isEmpty(tree) ? list :
+           postorder_helper(tree_left(tree), postorder_helper(tree_right(tree), list_make(tree_elt(tree), list)));
+}
+
+list_t traversal_postorder(tree_t tree)
+{
+    return postorder_helper(tree, list_make());
 }
 
 static bool tree_hasMonotonicPath_helper(tree_t tree, bool(*fn)(int, int))
 {
-    return (!tree_isEmpty(tree_left(tree)) ? (fn(tree_elt(tree), tree_elt(tree_left(tree))) && tree_hasMonotonicPath_helper(tree_left(tree), fn)) : true) ||
-           (!tree_isEmpty(tree_right(tree)) ? (fn(tree_elt(tree), tree_elt(tree_right(tree))) && tree_hasMonotonicPath_helper(tree_right(tree), fn)) : true);
+    return (tree_isEmpty(tree_left(tree)) && tree_isEmpty(tree_right(tree))) ||
+           (!tree_isEmpty(tree_left(tree)) && fn(tree_elt(tree), tree_elt(tree_left(tree))) && tree_hasMonotonicPath_helper(tree_left(tree), fn)) ||
+           (!tree_isEmpty(tree_right(tree)) && fn(tree_elt(tree), tree_elt(tree_right(tree))) && tree_hasMonotonicPath_helper(tree_right(tree), fn));
 }
 
 bool tree_hasMonotonicPath(tree_t tree)
@@ -122,10 +220,7 @@ bool tree_hasMonotonicPath(tree_t tree)
 
 bool tree_allPathSumGreater(tree_t tree, int sum)
 {
-    return tree_isEmpty(tree) ||
-           ((!tree_isEmpty(tree_left(tree)) && tree_allPathSumGreater(tree_left(tree), sum - tree_elt(tree))) &&
-           (!tree_isEmpty(tree_right(tree)) && tree_allPathSumGreater(tree_right(tree), sum - tree_elt(tree))) ||
-           (tree_isEmpty(tree_left(tree)) && tree_isEmpty(tree_right(tree)) && sum > tree_elt(tree)));
+    return tree_isEmpty(tree) || tree_minPathSum(tree) > sum;
 }
 
 bool covered_by(tree_t A, tree_t B)
@@ -143,3 +238,115 @@ tree_t insert_tree(int elt, tree_t tree)
 {
     return tree_isEmpty(tree) ? tree_make(elt, tree_make(), tree_make()) :tree_make(tree_elt(tree), elt < tree_elt(tree) ? insert_tree(elt, tree_left(tree)) : tree_left(tree), elt < tree_elt(tree) ? tree_right(tree) : insert_tree(elt, tree_right(tree)));
 }
+
+static tree_t balance(int elt, tree_t left, tree_t right)
+    // REQUIRES: "left" and "right" are balanced, and their depths differ by at most two
+    // EFFECTS: returns a balanced tree of the elements of "left", elt and "right", in order,
+    //          by a single or double rotation when the depths differ by two
+{
+    return tree_height(left) > tree_height(right) + 1 ?
+           (tree_height(tree_left(left)) >= tree_height(tree_right(left)) ?
+            tree_make(tree_elt(left), tree_left(left), tree_make(elt, tree_right(left), right)) :
+            tree_make(tree_elt(tree_right(left)),
+                      tree_make(tree_elt(left), tree_left(left), tree_left(tree_right(left))),
+                      tree_make(elt, tree_right(tree_right(left)), right))) :
+           tree_height(right) > tree_height(left) + 1 ?
+           (tree_height(tree_right(right)) >= tree_height(tree_left(right)) ?
+            tree_make(tree_elt(right), tree_make(elt, left, tree_left(right)), tree_right(right)) :
+            tree_make(tree_elt(tree_left(right)),
+                      tree_make(elt, left, tree_left(tree_left(right))),
+                      tree_make(tree_elt(right), tree_right(tree_left(right)), tree_right(right)))) :
+           tree_make(elt, left, right);
+}
+
+tree_t insert_tree_balanced(int elt, tree_t tree)
+{
+    return tree_isEmpty(tree) ? tree_make(elt, tree, tree) :
+           elt < tree_elt(tree) ? balance(tree_elt(tree), insert_tree_balanced(elt, tree_left(tree)), tree_right(tree)) :
+           balance(tree_elt(tree), tree_left(tree), insert_tree_balanced(elt, tree_right(tree)));
+}
+
+bool sorted_tree_search(tree_t tree, int val)
+{
+    return tree_isEmpty(tree) ? false : tree_elt(tree) == val ? true :
+           sorted_tree_search(val < tree_elt(tree) ? tree_left(tree) : tree_right(tree), val);
+}
+
+int sorted_tree_max(tree_t tree)
+{
+    return tree_isEmpty(tree_right(tree)) ? tree_elt(tree) : sorted_tree_max(tree_right(tree));
+}
+
+// Subtrees of fewer elements than this are not worth a thread of their own
+const int PARALLEL_CUTOFF = 1 << 14;
+
+static void traversal_gather(tree_t tree, int *elts, unsigned int threads)
+    // MODIFIES: elts
+    // EFFECTS: writes the elements of "tree" to elts, in the order of traversal, splitting
+    //          the subtrees across up to "threads" threads
+{
+    if (tree_isEmpty(tree)) {
+        return;
+    }
+    int *elt = elts + tree_size(tree_left(tree));
+    *elt = tree_elt(tree);
+    if (threads > 1 && tree_size(tree) >= PARALLEL_CUTOFF) {
+        std::future<void> left = std::async(std::launch::async, traversal_gather, tree_left(tree), elts, threads / 2);
+        traversal_gather(tree_right(tree), elt + 1, threads - threads / 2);
+        left.get();
+    } else {
+        traversal_gather(tree_left(tree), elts, 1);
+        traversal_gather(tree_right(tree), elt + 1, 1);
+    }
+}
+
+static list_t list_from(const int *elts, size_t n, list_t list)
+    // EFFECTS: returns the first n elements of elts followed by "list"
+{
+    // a loop rather than a tail call, which gcc does not always turn into a jump here
+    while (n > 0) {
+        list = list_make(elts[--n], list);
+    }
+    return list;
+}
+
+list_t traversal_parallel(tree_t tree, unsigned int threads)
+{
+    // list_make is not thread-safe, so only the walk over the tree is split, and the list
+    // is made afterwards from the back
+    std::vector<int> elts(tree_size(tree));
+    traversal_gather(tree, elts.data(), threads);
+    return list_from(elts.data(), elts.size(), list_make());
+}
+
+static bool contained_by_helper(tree_t A, tree_t B, unsigned int threads, std::atomic<bool> &found)
+    // MODIFIES: found
+    // EFFECTS: returns true if A is contained by B, splitting the subtrees of B across up to
+    //          "threads" threads, and sets found then. Gives up and returns true once found
+    //          is set by another thread
+{
+    if (found.load()) {
+        return true;
+    }
+    if (threads <= 1 || tree_size(B) < PARALLEL_CUTOFF) {
+        bool contained = contained_by(A, B);
+        if (contained) {
+            found.store(true);
+        }
+        return contained;
+    }
+    if (covered_by(A, B)) {
+        found.store(true);
+        return true;
+    }
+    std::future<bool> left = std::async(std::launch::async, contained_by_helper, A, tree_left(B), threads / 2,
+                                        std::ref(found));
+    bool right = contained_by_helper(A, tree_right(B), threads - threads / 2, found);
+    return left.get() || right;
+}
+
+bool contained_by_parallel(tree_t A, tree_t B, unsigned int threads)
+{
+    std::atomic<bool> found(false);
+    return contained_by_helper(A, B, threads, found);
+}
@@ -194,6 +194,24 @@ list_t traversal(tree_t tree);
 //
 */
 
+list_t traversal_preorder(tree_t tree);
+/*
+// EFFECTS: Returns the elements of "tree" in a list using a pre-order
+//          traversal: each node comes before the elements of its left
+//          subtree, which come before those of its right subtree.
+//
+//          For the tree of traversal above, it returns ( 4 2 3 5 ).
+*/
+
+list_t traversal_postorder(tree_t tree);
+/*
+// EFFECTS: Returns the elements of "tree" in a list using a post-order
+//          traversal: the elements of the left subtree of each node
+//          come first, then those of its right subtree, then the node.
+//
+//          For the tree of traversal above, it returns ( 3 2 5 4 ).
+*/
+
 bool tree_hasMonotonicPath(tree_t tree);
 /* 
 // EFFECTS: Returns true if and only if "tree" has at least one
@@ -297,4 +315,54 @@ tree_t insert_tree(int elt, tree_t tree);
 // 
 */
 
+tree_t insert_tree_balanced(int elt, tree_t tree);
+/*
+// REQUIRES: "tree" is a sorted binary tree, in which the depths of the
+//           two subtrees of any node differ by at most one, such as a
+//           tree built by insert_tree_balanced from the empty tree.
+//
+// EFFECTS: Returns a new tree with elt inserted such that the
+//          resulting tree is also a sorted binary tree with the same
+//          balance, by rotating the nodes on the path to elt. "tree"
+//          itself is unchanged. The depth of a tree of n elements
+//          built this way is at most 1.44 log2(n + 2), whatever the
+//          order of insertion.
+*/
+
+bool sorted_tree_search(tree_t tree, int val);
+/*
+// REQUIRES: "tree" is a sorted binary tree.
+//
+// EFFECTS: Returns true if the value "val" appears in "tree", looking
+//          only along the path val would be inserted at.
+*/
+
+int sorted_tree_max(tree_t tree);
+/*
+// REQUIRES: "tree" is a non-empty sorted binary tree.
+//
+// EFFECTS: Returns the largest element in "tree", the rightmost one.
+*/
+
+/*
+// The following give the same results as traversal and contained_by,
+// but walk the subtrees of large trees on several threads. Subtrees
+// are split off while they are large enough, by their size, until
+// "threads" threads are running.
+*/
+
+list_t traversal_parallel(tree_t tree, unsigned int threads);
+/*
+// REQUIRES: threads > 0.
+//
+// EFFECTS: Returns traversal(tree), using up to "threads" threads.
+*/
+
+bool contained_by_parallel(tree_t A, tree_t B, unsigned int threads);
+/*
+// REQUIRES: threads > 0.
+//
+// EFFECTS: Returns contained_by(A, B), using up to "threads" threads.
+*/
+
 #endif /* __P2_H__ */
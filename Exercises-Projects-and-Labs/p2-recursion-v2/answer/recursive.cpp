@@ -1,9 +1,38 @@
 #include <iostream>
 #include <cassert>
+#include <climits>
+#include <cstddef>
+#include <vector>
 #include "recursive.h"
+#include "../../../alloc/alloc.h"
 
 using namespace std;
 
+// the cells of an arena, in blocks of ARENA_BLOCK taken from its cells
+// resource, the last one used up to list_used or tree_used
+const size_t ARENA_BLOCK = 4096;
+
+struct arena_state {
+    alloc::MonotonicArena           cells;
+    std::vector<struct list_node *> list_blocks;
+    size_t                          list_used;
+    std::vector<struct tree_node *> tree_blocks;
+    size_t                          tree_used;
+    arena_state                    *outer;     // the arena this one is in
+};
+
+static arena_state *arena_top = NULL;
+
+static void
+not_allocated()
+{
+    cerr << "Your test case is too large for this machine\n";
+    cerr << "Try using a smaller test case\n";
+    assert(0);
+}
+
+#ifndef LIST_SLICES
+
 // Implementation of the list ADT 
 const unsigned int  list_node_id = 0x11341134;
 const unsigned int  list_empty_id = 0x22452245;
@@ -12,8 +41,57 @@ struct list_node {
     unsigned int      ln_id;    // Are we really a list_node?
     int               ln_elt;   // This element
     struct list_node *ln_rest;  // rest of this list, null for empty node
+    struct list_node *ln_next;  // next node of the same bucket
 } list_node_t;
 
+// Lists are hash-consed: every (elt, rest) pair is made once, and the
+// nodes made so far are chained in buckets of their hash
+static struct list_node *list_empty_node = NULL;
+static std::vector<struct list_node *> list_buckets(1024, (struct list_node *)NULL);
+static size_t list_node_count = 0;
+
+static size_t
+list_hash(int elt, struct list_node *rest)
+    // EFFECTS: returns the hash of the pair (elt, rest)
+{
+    size_t h = (size_t)rest * 0x9e3779b97f4a7c15ull ^ (size_t)(unsigned int)elt;
+    return h ^ (h >> 29);
+}
+
+static void
+list_grow()
+    // MODIFIES: list_buckets
+    // EFFECTS: doubles the buckets, moving every node to its new bucket
+{
+    std::vector<struct list_node *> buckets(list_buckets.size() * 2, (struct list_node *)NULL);
+    for (size_t i = 0; i < list_buckets.size(); i++) {
+        struct list_node *lnp = list_buckets[i];
+        while (lnp) {
+            struct list_node *next = lnp->ln_next;
+            size_t b = list_hash(lnp->ln_elt, lnp->ln_rest) & (buckets.size() - 1);
+            lnp->ln_next = buckets[b];
+            buckets[b] = lnp;
+            lnp = next;
+        }
+    }
+    list_buckets.swap(buckets);
+}
+
+static void
+list_unlink(struct list_node *lnp)
+    // REQUIRES: lnp is a non-empty node in the buckets
+    // MODIFIES: list_buckets
+    // EFFECTS: removes lnp from its bucket
+{
+    size_t b = list_hash(lnp->ln_elt, lnp->ln_rest) & (list_buckets.size() - 1);
+    struct list_node **link = &list_buckets[b];
+    while (*link != lnp) {
+        link = &(*link)->ln_next;
+    }
+    *link = lnp->ln_next;
+    list_node_count--;
+}
+
 
 static struct list_node *
 list_checkValid(list_t list)
@@ -31,6 +109,29 @@ list_checkValid(list_t list)
     return lnp;
 }
 
+static struct list_node *
+list_alloc()
+    // EFFECTS: returns a new list node, from the innermost arena if any
+{
+    struct list_node *newp = 0;
+
+    try {
+        if (!arena_top) {
+            return new struct list_node;
+        }
+        if (arena_top->list_blocks.empty() || arena_top->list_used == ARENA_BLOCK) {
+            arena_top->list_blocks.push_back(static_cast<struct list_node *>(
+                arena_top->cells.allocate(ARENA_BLOCK * sizeof(struct list_node), alignof(struct list_node))));
+            arena_top->list_used = 0;
+        }
+        newp = arena_top->list_blocks.back() + arena_top->list_used++;
+    } catch (const bad_alloc &) {
+        not_allocated();
+    }
+
+    return newp;
+}
+
 static void
 list_checkNonEmpty(list_t list)
     // MODIFIES: cerr
@@ -43,14 +144,6 @@ list_checkNonEmpty(list_t list)
     }
 }
 
-static void
-not_allocated()
-{
-    cerr << "Your test case is too large for this machine\n";
-    cerr << "Try using a smaller test case\n";
-    assert(0);
-}
-
 bool
 list_isEmpty(list_t list)
 {
@@ -61,6 +154,10 @@ list_isEmpty(list_t list)
 list_t
 list_make()
 {
+    if (list_empty_node) {
+        return (list_t)(list_empty_node);
+    }
+
     struct list_node *newp = 0; 
 
     try {
@@ -71,6 +168,8 @@ list_make()
 
     newp->ln_id = list_empty_id;
     newp->ln_rest = NULL;
+    newp->ln_next = NULL;
+    list_empty_node = newp;
     
     return (list_t)(newp);
 }
@@ -81,15 +180,23 @@ list_make(int elt, list_t list)
     struct list_node *newp = 0; 
     struct list_node *restp = list_checkValid(list);
 
-    try {
-        newp = new struct list_node;
-    } catch (bad_alloc a) {
-        not_allocated();
+    size_t b = list_hash(elt, restp) & (list_buckets.size() - 1);
+    for (newp = list_buckets[b]; newp; newp = newp->ln_next) {
+        if (newp->ln_elt == elt && newp->ln_rest == restp) {
+            return (list_t)(newp);
+        }
     }
 
+    newp = list_alloc();
+
     newp->ln_id = list_node_id;
     newp->ln_elt = elt;
     newp->ln_rest = restp;
+    newp->ln_next = list_buckets[b];
+    list_buckets[b] = newp;
+    if (++list_node_count > list_buckets.size()) {
+        list_grow();
+    }
     
     return (list_t)(newp);
 }
@@ -110,6 +217,102 @@ list_rest(list_t list)
     return (list_t)(lnp->ln_rest);
 }
 
+#else /* LIST_SLICES */
+
+// Implementation of the list ADT as slices. The elements of an array
+// are used from front to its end, and every slice of it ends at its
+// end, so a slice starting at front can grow by one to the left
+struct list_array {
+    unsigned int front;     // the first element used
+    unsigned int capacity;  // how many elements the array holds
+};
+
+const unsigned int LIST_ARRAY_MIN = 16;
+
+static struct list_array *
+list_array_of(const int *elts)
+    // EFFECTS: returns the header of the array elts
+{
+    return (struct list_array *)elts - 1;
+}
+
+static int *
+list_array_alloc(unsigned int capacity)
+    // EFFECTS: returns a new array of capacity elements, none used
+{
+    struct list_array *ap = 0;
+
+    try {
+        ap = (struct list_array *)::operator new(sizeof(struct list_array) + capacity * sizeof(int));
+    } catch (const bad_alloc &) {
+        not_allocated();
+    }
+
+    ap->front = capacity;
+    ap->capacity = capacity;
+    return (int *)(ap + 1);
+}
+
+list_t
+list_make()
+{
+    list_t list = { NULL, 0, 0 };
+    return list;
+}
+
+list_t
+list_make(int elt, list_t list)
+{
+    if (!list_isEmpty(list) && list.offset > 0) {
+        struct list_array *ap = list_array_of(list.elts);
+        if (ap->front == list.offset) {
+            ap->front--;
+            ((int *)list.elts)[ap->front] = elt;
+        }
+        if (list.elts[list.offset - 1] == elt) {
+            list_t newl = { list.elts, list.offset - 1, list.length + 1 };
+            return newl;
+        }
+    }
+
+    // the place before the list is taken: copy the list to the end of a
+    // new array twice as long, so that a list built by list_make alone
+    // copies each element a constant number of times on average
+    unsigned int capacity = 2 * (list.length + 1);
+    if (capacity < LIST_ARRAY_MIN) {
+        capacity = LIST_ARRAY_MIN;
+    }
+    int *elts = list_array_alloc(capacity);
+    for (unsigned int i = 0; i < list.length; i++) {
+        elts[capacity - list.length + i] = list.elts[list.offset + i];
+    }
+    struct list_array *ap = list_array_of(elts);
+    ap->front = capacity - list.length - 1;
+    elts[ap->front] = elt;
+
+    list_t newl = { elts, ap->front, list.length + 1 };
+    return newl;
+}
+
+bool
+operator==(list_t l1, list_t l2)
+{
+    if (l1.length != l2.length) {
+        return false;
+    }
+    if (l1.elts == l2.elts && l1.offset == l2.offset) {
+        return true;
+    }
+    for (unsigned int i = 0; i < l1.length; i++) {
+        if (l1.elts[l1.offset + i] != l2.elts[l2.offset + i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+#endif /* LIST_SLICES */
+
 static void
 list_print_helper(list_t list)
     // MODIFIES: cout
@@ -142,8 +345,39 @@ struct tree_node {
     int                tn_elt;   // This element
     struct tree_node  *tn_left;  // left subtree
     struct tree_node  *tn_right; // right subtree
+    // aggregates of the whole tree, which never change since trees are
+    // immutable. The sums are kept in 64 bits, in which no tree of int
+    // elements overflows, and are wrapped to int only when asked for
+    int                tn_size;    // number of elements
+    int                tn_height;  // layers of nodes, zero for empty tree
+    long long          tn_sum;     // sum of the elements, zero for empty tree
+    int                tn_max;     // largest element, INT_MIN for empty tree
+    long long          tn_minPath; // smallest root-to-leaf path sum
 };
 
+static struct tree_node *
+tree_alloc()
+    // EFFECTS: returns a new tree node, from the innermost arena if any
+{
+    struct tree_node *tnp = 0;
+
+    try {
+        if (!arena_top) {
+            return new struct tree_node;
+        }
+        if (arena_top->tree_blocks.empty() || arena_top->tree_used == ARENA_BLOCK) {
+            arena_top->tree_blocks.push_back(static_cast<struct tree_node *>(
+                arena_top->cells.allocate(ARENA_BLOCK * sizeof(struct tree_node), alignof(struct tree_node))));
+            arena_top->tree_used = 0;
+        }
+        tnp = arena_top->tree_blocks.back() + arena_top->tree_used++;
+    } catch (const bad_alloc &) {
+        not_allocated();
+    }
+
+    return tnp;
+}
+
 static struct tree_node *
 tree_checkValid(tree_t tree)
     // MODIFIES: cerr
@@ -178,17 +412,16 @@ tree_isEmpty(tree_t tree)
 tree_t
 tree_make()
 {
-    struct tree_node *tnp = 0;
-
-    try {
-        tnp = new struct tree_node;
-    } catch (bad_alloc a) {
-        not_allocated();
-    }
+    struct tree_node *tnp = tree_alloc();
 
     tnp->tn_id = tree_empty_id;
     tnp->tn_left = NULL;
     tnp->tn_right = NULL;
+    tnp->tn_size = 0;
+    tnp->tn_height = 0;
+    tnp->tn_sum = 0;
+    tnp->tn_max = INT_MIN;
+    tnp->tn_minPath = 0;
 
     return (tree_t)(tnp);
 }
@@ -196,13 +429,7 @@ tree_make()
 tree_t
 tree_make(int elt, tree_t left, tree_t right)
 {
-    struct tree_node *tnp = 0;
-
-    try {
-        tnp = new struct tree_node;
-    } catch (bad_alloc a) {
-        not_allocated();
-    }
+    struct tree_node *tnp = tree_alloc();
 
     if (!tree_isEmpty(left)) {
         tree_checkValid(left);
@@ -216,6 +443,23 @@ tree_make(int elt, tree_t left, tree_t right)
     tnp->tn_left = (struct tree_node *)left;
     tnp->tn_right = (struct tree_node *)right;
 
+    struct tree_node *lp = tnp->tn_left, *rp = tnp->tn_right;
+    tnp->tn_size = 1 + lp->tn_size + rp->tn_size;
+    tnp->tn_height = 1 + (lp->tn_height > rp->tn_height ? lp->tn_height : rp->tn_height);
+    tnp->tn_sum = elt + lp->tn_sum + rp->tn_sum;
+    tnp->tn_max = elt > lp->tn_max ? (elt > rp->tn_max ? elt : rp->tn_max) :
+                  (lp->tn_max > rp->tn_max ? lp->tn_max : rp->tn_max);
+    // a path goes on through each non-empty subtree, and ends at a leaf
+    if (lp->tn_id == tree_empty_id && rp->tn_id == tree_empty_id) {
+        tnp->tn_minPath = elt;
+    } else if (lp->tn_id == tree_empty_id) {
+        tnp->tn_minPath = elt + rp->tn_minPath;
+    } else if (rp->tn_id == tree_empty_id) {
+        tnp->tn_minPath = elt + lp->tn_minPath;
+    } else {
+        tnp->tn_minPath = elt + (lp->tn_minPath < rp->tn_minPath ? lp->tn_minPath : rp->tn_minPath);
+    }
+
     return (tree_t)(tnp);
 }
 
@@ -243,6 +487,42 @@ tree_right(tree_t tree)
     return (tree_t)(tnp->tn_right);
 }
 
+int
+tree_size(tree_t tree)
+{
+    struct tree_node *tnp = tree_checkValid(tree);
+    return tnp->tn_size;
+}
+
+int
+tree_height(tree_t tree)
+{
+    struct tree_node *tnp = tree_checkValid(tree);
+    return tnp->tn_height;
+}
+
+int
+tree_eltSum(tree_t tree)
+{
+    struct tree_node *tnp = tree_checkValid(tree);
+    return (int) tnp->tn_sum;
+}
+
+int
+tree_eltMax(tree_t tree)
+{
+    struct tree_node *tnp = tree_checkValid(tree);
+    return tnp->tn_max;
+}
+
+int
+tree_minPathSum(tree_t tree)
+{
+    tree_checkNonEmpty(tree);
+    struct tree_node *tnp = tree_checkValid(tree);
+    return (int) tnp->tn_minPath;
+}
+
 static void
 print_spaces(int spaces)
     // MODIFIES: cout
@@ -299,3 +579,40 @@ tree_print(tree_t tree)
     tree_print_internal(tree, 0);
 }
     
+
+/**************************************************/
+
+// Implementation of the cell arenas
+
+cell_arena::cell_arena()
+{
+    try {
+        state = new arena_state;
+    } catch (const bad_alloc &) {
+        not_allocated();
+    }
+    state->list_used = 0;
+    state->tree_used = 0;
+    state->outer = arena_top;
+    arena_top = state;
+}
+
+cell_arena::~cell_arena()
+{
+    assert(arena_top == state);
+
+#ifndef LIST_SLICES
+    // the cells of the arena only point to older cells, so once they are
+    // out of the buckets no list made outside the arena can reach them
+    for (size_t i = 0; i < state->list_blocks.size(); i++) {
+        size_t used = i + 1 == state->list_blocks.size() ? state->list_used : ARENA_BLOCK;
+        for (size_t j = 0; j < used; j++) {
+            list_unlink(state->list_blocks[i] + j);
+        }
+    }
+#endif
+
+    // the blocks go with the cells resource
+    arena_top = state->outer;
+    delete state;
+}
@@ -17,6 +17,10 @@
  *
  * Lists are applicative (functional) data structures---in other
  * words, they are immutable.
+ *
+ * Lists are also hash-consed: list_make returns the same list_t for
+ * the same element and rest, so two lists with the same elements in
+ * the same order are the same list_t, and can be compared with ==.
  */
  
 
@@ -28,12 +32,46 @@
  * use just like "int" or "double".
  */
 
+#ifndef LIST_SLICES
+
 struct opaque_list;
 typedef opaque_list *list_t;
 
 extern bool list_isEmpty(list_t list);
    // EFFECTS: returns true if list is empty, false otherwise
 
+#else /* LIST_SLICES */
+
+/*
+ * Built with LIST_SLICES defined, a list is instead a slice of an
+ * array shared with the lists it was made from, which ends where the
+ * array ends.  list_make writes the new element just before the slice
+ * when that place is free or already holds it, and copies the slice
+ * to a new array otherwise.  list_first and list_rest are then an
+ * array read and an offset bump, inlined here, and lists are compared
+ * element by element with ==.
+ */
+
+#include <cassert>
+
+struct list_t {
+    const int   *elts;    // the shared array, null for the empty list
+    unsigned int offset;  // where the list starts in elts
+    unsigned int length;  // how many elements the list has
+};
+
+inline bool list_isEmpty(list_t list)
+   // EFFECTS: returns true if list is empty, false otherwise
+{
+    return list.length == 0;
+}
+
+extern bool operator==(list_t l1, list_t l2);
+   // EFFECTS: returns true if l1 and l2 have the same elements in the
+   //          same order, false otherwise
+
+#endif /* LIST_SLICES */
+
 list_t list_make();
    // EFFECTS: returns an empty list.
 
@@ -42,6 +80,8 @@ list_t list_make(int elt, list_t list);
    //          the new element followed by the elements of the
    //          original list. 
 
+#ifndef LIST_SLICES
+
 extern int list_first(list_t list);
    // REQUIRES: list is not empty
    // EFFECTS: returns the first element of list
@@ -50,6 +90,27 @@ extern list_t list_rest(list_t list);
    // REQUIRES: list is not empty
    // EFFECTS: returns the list containing all but the first element of list
 
+#else /* LIST_SLICES */
+
+inline int list_first(list_t list)
+   // REQUIRES: list is not empty
+   // EFFECTS: returns the first element of list
+{
+    assert(!list_isEmpty(list));
+    return list.elts[list.offset];
+}
+
+inline list_t list_rest(list_t list)
+   // REQUIRES: list is not empty
+   // EFFECTS: returns the list containing all but the first element of list
+{
+    assert(!list_isEmpty(list));
+    list_t rest = { list.elts, list.offset + 1, list.length - 1 };
+    return rest;
+}
+
+#endif /* LIST_SLICES */
+
 extern void list_print(list_t list);
     // MODIFIES: cout
     // EFFECTS: prints list to cout.
@@ -100,8 +161,65 @@ extern tree_t tree_right(tree_t tree);
     // REQUIRES: tree is not empty
     // EFFECTS: returns the right subtree of tree
 
+/*
+ * Each tree keeps the following aggregates of its elements, computed
+ * by tree_make from those of its subtrees, so they take constant time.
+ */
+
+extern int tree_size(tree_t tree);
+    // EFFECTS: returns the number of elements of tree
+
+extern int tree_height(tree_t tree);
+    // EFFECTS: returns the number of layers of nodes in tree, zero if
+    //          tree is empty
+
+extern int tree_eltSum(tree_t tree);
+    // EFFECTS: returns the sum of the elements of tree, zero if tree
+    //          is empty, wrapped to an int if it does not fit one
+
+extern int tree_eltMax(tree_t tree);
+    // EFFECTS: returns the largest element of tree, INT_MIN if tree is
+    //          empty
+
+extern int tree_minPathSum(tree_t tree);
+    // REQUIRES: tree is not empty
+    // EFFECTS: returns the smallest sum of the elements along a path
+    //          from the root of tree down to a leaf (an element with
+    //          no children), wrapped to an int if it does not fit one
+
 extern void tree_print(tree_t tree);
     // MODIFIES: cout
     // EFFECTS: prints tree to cout.
 
+/*
+ * Cell arenas
+ *
+ * While a cell_arena is alive, the list and tree cells made come from
+ * blocks of the arena, at the cost of a pointer bump each, and they
+ * are all freed together when the arena is destroyed. Arenas nest:
+ * cells come from the innermost one. Cells made outside any arena are
+ * never freed.
+ *
+ * Built with LIST_SLICES, only tree cells come from arenas: the list
+ * arrays are shared across arenas and are never freed.
+ */
+
+struct arena_state;
+
+class cell_arena {
+    arena_state *state;
+
+public:
+    cell_arena();
+    // EFFECTS: starts an arena, which the cells made from now on come from
+
+    ~cell_arena();
+    // REQUIRES: the arenas started since were destroyed, and no list or
+    //           tree made while this one was alive is used afterwards
+    // EFFECTS: frees every cell made while the arena was alive
+
+    cell_arena(const cell_arena &) = delete;
+    cell_arena &operator=(const cell_arena &) = delete;
+};
+
 #endif /* __RECURSIVE_H__ */
@@ -68,8 +68,10 @@ int main()
     listC = list_make(10, listC);
     list_print(listC);
 
+    // equal lists are also the same list, as lists are hash-consed
     if(list_equal(listA, listA_answer) 
-        && list_equal(listB, listB_answer))
+        && list_equal(listB, listB_answer)
+        && listA == listA_answer && listB == listB_answer)
     {
         cout << "Success!\n";
         return 0;
@@ -0,0 +1,264 @@
+//
+// Lazy streams over the list operations of p2.h.
+//
+
+#include <functional>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include "stream.h"
+
+struct stream_cell {
+    std::function<stream_t()> suspended;  // the call that makes this cell, empty once made
+    bool                      empty;
+    int                       elt;
+    stream_t                  rest;
+
+    stream_cell() : empty(true), elt(0) {}
+    ~stream_cell();
+};
+
+stream_cell::~stream_cell()
+{
+    // the cells after this one that only it keeps are freed by a loop, which a chain of
+    // destructor calls would not do on long streams without overflowing the stack
+    stream_t next = std::move(this->rest);
+    while (next && next.use_count() == 1) {
+        stream_t after = std::move(next->rest);
+        next = std::move(after);
+    }
+}
+
+static stream_t stream_suspend(std::function<stream_t()> call)
+    // EFFECTS: returns a stream that is the result of call, made when it is first looked at
+{
+    stream_t stream = std::make_shared<stream_cell>();
+    stream->suspended = std::move(call);
+    return stream;
+}
+
+static stream_cell *force(const stream_t &stream)
+    // EFFECTS: makes the cell of stream if it is suspended, and returns it
+{
+    stream_cell *cell = stream.get();
+    if (cell->suspended) {
+        std::function<stream_t()> call = std::move(cell->suspended);
+        cell->suspended = nullptr;
+        stream_t made = call();
+        stream_cell *value = force(made);
+        cell->empty = value->empty;
+        cell->elt = value->elt;
+        cell->rest = value->rest;
+    }
+    return cell;
+}
+
+stream_t stream_make()
+{
+    return std::make_shared<stream_cell>();
+}
+
+stream_t stream_make(int elt, stream_t rest)
+{
+    stream_t stream = std::make_shared<stream_cell>();
+    stream->empty = false;
+    stream->elt = elt;
+    stream->rest = std::move(rest);
+    return stream;
+}
+
+bool stream_isEmpty(stream_t stream)
+{
+    return force(stream)->empty;
+}
+
+int stream_first(stream_t stream)
+{
+    return force(stream)->elt;
+}
+
+stream_t stream_rest(stream_t stream)
+{
+    return force(stream)->rest;
+}
+
+stream_t stream_from(list_t list)
+{
+    return stream_suspend([list]() {
+        return list_isEmpty(list) ? stream_make() : stream_make(list_first(list), stream_from(list_rest(list)));
+    });
+}
+
+list_t stream_to_list(stream_t stream)
+{
+    // the elements are gathered first, so that the list is made from the back with one
+    // cell each
+    std::vector<int> elts;
+    for (; !stream_isEmpty(stream); stream = stream_rest(stream)) {
+        elts.push_back(stream_first(stream));
+    }
+    list_t list = list_make();
+    for (size_t i = elts.size(); i > 0; i--) {
+        list = list_make(elts[i - 1], list);
+    }
+    return list;
+}
+
+// The consumers below step the stream they were passed, so that the cells behind them are
+// freed as they go; the producers suspend a call that makes one cell, with the rest
+// suspended in turn. Those that skip elements loop to the next one kept, within one call.
+// The producers move their arguments into the call they suspend: the caller keeps its
+// arguments to the end of its expression, where they would keep every cell worked out.
+
+int size(stream_t stream)
+{
+    int count = 0;
+    for (; !stream_isEmpty(stream); stream = stream_rest(stream)) {
+        count++;
+    }
+    return count;
+}
+
+bool memberOf(stream_t stream, int val)
+{
+    for (; !stream_isEmpty(stream); stream = stream_rest(stream)) {
+        if (stream_first(stream) == val) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int dot(stream_t v1, stream_t v2)
+{
+    int sum = 0;
+    for (; !stream_isEmpty(v1) && !stream_isEmpty(v2); v1 = stream_rest(v1), v2 = stream_rest(v2)) {
+        sum += stream_first(v1) * stream_first(v2);
+    }
+    return sum;
+}
+
+bool isIncreasing(stream_t v)
+{
+    if (stream_isEmpty(v)) {
+        return true;
+    }
+    int previous = stream_first(v);
+    for (v = stream_rest(v); !stream_isEmpty(v); v = stream_rest(v)) {
+        if (stream_first(v) < previous) {
+            return false;
+        }
+        previous = stream_first(v);
+    }
+    return true;
+}
+
+bool isArithmeticSequence(stream_t v)
+{
+    if (stream_isEmpty(v) || stream_isEmpty(stream_rest(v))) {
+        return true;
+    }
+    int previous = stream_first(stream_rest(v)), difference = previous - stream_first(v);
+    for (v = stream_rest(stream_rest(v)); !stream_isEmpty(v); v = stream_rest(v)) {
+        if (stream_first(v) - previous != difference) {
+            return false;
+        }
+        previous = stream_first(v);
+    }
+    return true;
+}
+
+stream_t reverse(stream_t stream)
+{
+    stream_t from = std::move(stream);
+    return stream_suspend([from]() mutable {
+        stream_t stream = from;
+        from = nullptr;
+        stream_t reversed = stream_make();
+        for (; !stream_isEmpty(stream); stream = stream_rest(stream)) {
+            reversed = stream_make(stream_first(stream), reversed);
+        }
+        return reversed;
+    });
+}
+
+stream_t append(stream_t first, stream_t second)
+{
+    stream_t head = std::move(first), tail = std::move(second);
+    return stream_suspend([head, tail]() {
+        return stream_isEmpty(head) ? tail : stream_make(stream_first(head), append(stream_rest(head), tail));
+    });
+}
+
+stream_t filter_odd(stream_t stream)
+{
+    return filter(std::move(stream), [](int a)->bool {return a % 2 != 0;});
+}
+
+stream_t filter(stream_t stream, bool (*fn)(int))
+{
+    stream_t from = std::move(stream);
+    return stream_suspend([from, fn]() mutable {
+        stream_t stream = from;
+        from = nullptr;
+        while (!stream_isEmpty(stream) && !fn(stream_first(stream))) {
+            stream = stream_rest(stream);
+        }
+        return stream_isEmpty(stream) ? stream_make() :
+               stream_make(stream_first(stream), filter(stream_rest(stream), fn));
+    });
+}
+
+static stream_t unique_helper(stream_t stream, std::shared_ptr<std::unordered_set<int> > seen)
+    // EFFECTS: returns the first occurrences of the elements of stream not in seen, adding
+    //          them to seen as they are made
+{
+    stream_t from = std::move(stream);
+    return stream_suspend([from, seen]() mutable {
+        stream_t stream = from;
+        from = nullptr;
+        while (!stream_isEmpty(stream) && !seen->insert(stream_first(stream)).second) {
+            stream = stream_rest(stream);
+        }
+        return stream_isEmpty(stream) ? stream_make() :
+               stream_make(stream_first(stream), unique_helper(stream_rest(stream), seen));
+    });
+}
+
+stream_t unique(stream_t stream)
+{
+    return unique_helper(std::move(stream), std::make_shared<std::unordered_set<int> >());
+}
+
+stream_t insert_list(stream_t first, stream_t second, unsigned int n)
+{
+    if (n == 0) {
+        return append(std::move(second), std::move(first));
+    }
+    stream_t head = std::move(first), middle = std::move(second);
+    return stream_suspend([head, middle, n]() {
+        return stream_make(stream_first(head), insert_list(stream_rest(head), middle, n - 1));
+    });
+}
+
+static stream_t chop_helper(stream_t stream, stream_t ahead)
+    // REQUIRES: ahead is stream some elements further on
+    // EFFECTS: returns the elements of stream until ahead reaches the end
+{
+    return stream_suspend([stream, ahead]() {
+        return stream_isEmpty(ahead) ? stream_make() :
+               stream_make(stream_first(stream), chop_helper(stream_rest(stream), stream_rest(ahead)));
+    });
+}
+
+stream_t chop(stream_t stream, unsigned int n)
+{
+    stream_t from = std::move(stream);
+    return stream_suspend([from, n]() {
+        stream_t ahead = from;
+        for (unsigned int i = 0; i < n; i++) {
+            ahead = stream_rest(ahead);
+        }
+        return chop_helper(from, ahead);
+    });
+}
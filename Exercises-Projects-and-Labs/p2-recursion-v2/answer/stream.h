@@ -0,0 +1,116 @@
+/*
+ * stream.h
+ *
+ * Lazy lists: streams, with the list operations of p2.h under the same
+ * names, so that a pipeline such as size(filter(append(a, b), fn))
+ * makes no list in between.
+ */
+
+#ifndef __STREAM_H__
+#define __STREAM_H__
+
+#include <memory>
+#include "recursive.h"
+
+/*
+ * A well-formed stream is either:
+ *      the empty stream
+ *   or an integer followed by a well-formed stream,
+ * like a list, but a stream made by an operation below is a suspended
+ * call of it: the cell is only worked out, once, when it is first
+ * looked at by stream_isEmpty, stream_first or stream_rest, and is
+ * remembered after that. Only the part of a pipeline that is consumed
+ * is computed.
+ *
+ * Streams are applicative, and freed when the last stream_t to them
+ * goes away. The functions that consume a stream only keep the cell
+ * they are at, so that size(filter(stream_from(list), fn)) runs in
+ * constant memory. A stream_t kept by the caller keeps every cell
+ * after it that was worked out.
+ *
+ * Streams come from the heap, not from cell arenas, and are not safe
+ * to share between threads.
+ */
+
+struct stream_cell;
+typedef std::shared_ptr<stream_cell> stream_t;
+
+extern stream_t stream_make();
+    // EFFECTS: returns an empty stream
+
+extern stream_t stream_make(int elt, stream_t rest);
+    // EFFECTS: returns the stream of elt followed by the elements of rest
+
+extern bool stream_isEmpty(stream_t stream);
+    // EFFECTS: returns true if stream is empty, false otherwise
+
+extern int stream_first(stream_t stream);
+    // REQUIRES: stream is not empty
+    // EFFECTS: returns the first element of stream
+
+extern stream_t stream_rest(stream_t stream);
+    // REQUIRES: stream is not empty
+    // EFFECTS: returns the stream of all but the first element of stream
+
+extern stream_t stream_from(list_t list);
+    // EFFECTS: returns the stream of the elements of list, read as they
+    //          are consumed
+
+extern list_t stream_to_list(stream_t stream);
+    // EFFECTS: returns the list of the elements of stream, which must
+    //          be finite
+
+/*
+ * The operations of p2.h on streams. Those returning a stream return
+ * at once, and do their work as the result is consumed; those
+ * returning a value consume their arguments as far as they need to.
+ */
+
+extern int size(stream_t stream);
+    // EFFECTS: returns the number of elements in stream
+
+extern bool memberOf(stream_t stream, int val);
+    // EFFECTS: returns true if val appears in stream, stopping at it
+
+extern int dot(stream_t v1, stream_t v2);
+    // REQUIRES: both v1 and v2 are non-empty
+    // EFFECTS: returns the dot product of v1 and v2, up to the end of
+    //          the shorter one
+
+extern bool isIncreasing(stream_t v);
+    // EFFECTS: returns true if no element of v is smaller than the one
+    //          before it, stopping at the first that is
+
+extern bool isArithmeticSequence(stream_t v);
+    // EFFECTS: returns true if the elements of v form an arithmetic
+    //          sequence, stopping at the first that does not
+
+extern stream_t reverse(stream_t stream);
+    // EFFECTS: returns the reverse of stream, which it reads to its end
+    //          when the result is first looked at
+
+extern stream_t append(stream_t first, stream_t second);
+    // EFFECTS: returns the stream (first second)
+
+extern stream_t filter_odd(stream_t stream);
+    // EFFECTS: returns the odd elements of stream, in order
+
+extern stream_t filter(stream_t stream, bool (*fn)(int));
+    // EFFECTS: returns the elements of stream for which fn() is true,
+    //          in order
+
+extern stream_t unique(stream_t stream);
+    // EFFECTS: returns the first occurrence of each element of stream,
+    //          in order
+
+extern stream_t insert_list(stream_t first, stream_t second, unsigned int n);
+    // REQUIRES: n <= the number of elements in first
+    // EFFECTS: returns the first n elements of first, followed by the
+    //          elements of second, followed by the rest of first
+
+extern stream_t chop(stream_t stream, unsigned int n);
+    // REQUIRES: stream has at least n elements
+    // EFFECTS: returns stream without its last n elements, reading n
+    //          elements ahead of the one it returns
+
+#endif /* __STREAM_H__ */
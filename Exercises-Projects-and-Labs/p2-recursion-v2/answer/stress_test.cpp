@@ -0,0 +1,547 @@
+/*
+ * stress_test.cpp
+ *
+ * Checks every function of p2.h and stream.h against a plain reference
+ * on random lists, streams and trees of 10^2 elements up to a maximum
+ * size, and times each call, to compare how the list backends scale.
+ *
+ * usage: p2-recursion-v2-stress [max_size=STRESS_MAX_SIZE [seed=2800 [arena=0]]]
+ *
+ * Lists are hash-consed, so the calls after the first find the cells
+ * of the result already made. With arena=1, each call makes its result
+ * in a cell_arena destroyed after it instead, and the lists and trees
+ * tested are freed after each size, which 10^7 needs on most machines.
+ * Every line printed is
+ *
+ *     backend function size microseconds_per_call
+ *
+ * and a wrong result stops the driver with a FAIL line. The -ubsan
+ * build stops at the first undefined behaviour instead, the signed
+ * overflow of a sum among them. Its deeper frames overflow the default
+ * stack past 10^5, so it defaults there instead of at 10^6.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <chrono>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unordered_set>
+#include "recursive.h"
+#include "p2.h"
+#include "stream.h"
+
+using namespace std;
+
+#ifndef STRESS_MAX_SIZE
+#define STRESS_MAX_SIZE 1000000
+#endif
+
+#ifdef LIST_SLICES
+static const char *backend = "slices";
+#else
+static const char *backend = "cons";
+#endif
+
+static mt19937 rng;
+static bool use_arena = false;
+
+static int random_int(int low, int high)
+    // EFFECTS: returns a uniform random integer in [low, high]
+{
+    return uniform_int_distribution<int>(low, high)(rng);
+}
+
+static bool divisible_by_3(int a)
+{
+    return a % 3 == 0;
+}
+
+/**************************************************/
+
+// Conversions between lists and vectors, and the reference list
+// functions, on vectors
+
+static list_t make_list(const vector<int> &v)
+    // EFFECTS: returns the list of the elements of v
+{
+    list_t list = list_make();
+    for (size_t i = v.size(); i > 0; i--) {
+        list = list_make(v[i - 1], list);
+    }
+    return list;
+}
+
+static vector<int> list_elements(list_t list)
+    // EFFECTS: returns the elements of list
+{
+    vector<int> v;
+    for (; !list_isEmpty(list); list = list_rest(list)) {
+        v.push_back(list_first(list));
+    }
+    return v;
+}
+
+static bool ref_isIncreasing(const vector<int> &v)
+{
+    for (size_t i = 1; i < v.size(); i++) {
+        if (v[i] < v[i - 1]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool ref_isArithmeticSequence(const vector<int> &v)
+{
+    for (size_t i = 2; i < v.size(); i++) {
+        if (v[i] - v[i - 1] != v[1] - v[0]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static vector<int> ref_filter(const vector<int> &v, bool (*fn)(int))
+{
+    vector<int> result;
+    for (size_t i = 0; i < v.size(); i++) {
+        if (fn(v[i])) {
+            result.push_back(v[i]);
+        }
+    }
+    return result;
+}
+
+static bool is_odd(int a)
+{
+    return a % 2 != 0;
+}
+
+static vector<int> ref_unique(const vector<int> &v)
+{
+    vector<int> result;
+    unordered_set<int> seen;
+    for (size_t i = 0; i < v.size(); i++) {
+        if (seen.insert(v[i]).second) {
+            result.push_back(v[i]);
+        }
+    }
+    return result;
+}
+
+/**************************************************/
+
+// The reference trees: every tree made is mirrored by a node of a
+// vector, -1 being the empty tree
+
+struct ref_node {
+    int elt;
+    int left;
+    int right;
+};
+
+static vector<ref_node> ref_nodes;
+
+static tree_t random_tree(const vector<int> &elts, size_t first, size_t n, int &ref)
+    // MODIFIES: ref_nodes, ref
+    // EFFECTS: returns a tree of elts[first, first + n) in order, of a
+    //          uniformly random shape, and sets ref to its reference node
+{
+    if (n == 0) {
+        ref = -1;
+        return tree_make();
+    }
+    size_t root = first + random_int(0, (int) n - 1);
+    int left, right;
+    tree_t lt = random_tree(elts, first, root - first, left);
+    tree_t rt = random_tree(elts, root + 1, first + n - root - 1, right);
+    ref_node node = { elts[root], left, right };
+    ref = (int) ref_nodes.size();
+    ref_nodes.push_back(node);
+    return tree_make(elts[root], lt, rt);
+}
+
+static tree_t balanced_tree(const vector<int> &elts, size_t first, size_t n)
+    // EFFECTS: returns a tree of elts[first, first + n) in order, as
+    //          balanced as can be
+{
+    return n == 0 ? tree_make() :
+           tree_make(elts[first + n / 2], balanced_tree(elts, first, n / 2),
+                     balanced_tree(elts, first + n / 2 + 1, n - n / 2 - 1));
+}
+
+static tree_t pick_subtree(tree_t tree)
+    // EFFECTS: returns a random small subtree of tree
+{
+    while (tree_size(tree) > 8) {
+        tree = random_int(0, 1) ? tree_left(tree) : tree_right(tree);
+    }
+    return tree;
+}
+
+static long long ref_sum(int t)
+{
+    return t < 0 ? 0 : ref_nodes[t].elt + ref_sum(ref_nodes[t].left) + ref_sum(ref_nodes[t].right);
+}
+
+static int ref_depth(int t)
+{
+    if (t < 0) {
+        return 0;
+    }
+    int left = ref_depth(ref_nodes[t].left), right = ref_depth(ref_nodes[t].right);
+    return 1 + (left > right ? left : right);
+}
+
+static int ref_max(int t)
+{
+    if (t < 0) {
+        return INT_MIN;
+    }
+    int left = ref_max(ref_nodes[t].left), right = ref_max(ref_nodes[t].right);
+    int max = left > right ? left : right;
+    return ref_nodes[t].elt > max ? ref_nodes[t].elt : max;
+}
+
+static bool ref_search(int t, int val)
+{
+    return t >= 0 && (ref_nodes[t].elt == val || ref_search(ref_nodes[t].left, val) ||
+                      ref_search(ref_nodes[t].right, val));
+}
+
+static void ref_traversal(int t, vector<int> &v, int order)
+    // EFFECTS: appends the elements of t to v, each node before its
+    //          subtrees if order < 0, between them if order == 0, and
+    //          after them if order > 0
+{
+    if (t >= 0) {
+        if (order < 0) {
+            v.push_back(ref_nodes[t].elt);
+        }
+        ref_traversal(ref_nodes[t].left, v, order);
+        if (order == 0) {
+            v.push_back(ref_nodes[t].elt);
+        }
+        ref_traversal(ref_nodes[t].right, v, order);
+        if (order > 0) {
+            v.push_back(ref_nodes[t].elt);
+        }
+    }
+}
+
+static bool ref_monotonic(int t, int previous, int direction)
+    // EFFECTS: returns true if some root-to-leaf path of t continues the
+    //          path ending at previous in the direction, +1 increasing
+    //          and -1 decreasing
+{
+    const ref_node &node = ref_nodes[t];
+    if ((node.elt - previous) * direction < 0) {
+        return false;
+    }
+    if (node.left < 0 && node.right < 0) {
+        return true;
+    }
+    return (node.left >= 0 && ref_monotonic(node.left, node.elt, direction)) ||
+           (node.right >= 0 && ref_monotonic(node.right, node.elt, direction));
+}
+
+static long long ref_minPathSum(int t)
+{
+    const ref_node &node = ref_nodes[t];
+    if (node.left < 0 && node.right < 0) {
+        return node.elt;
+    }
+    long long left = node.left < 0 ? 0 : ref_minPathSum(node.left);
+    long long right = node.right < 0 ? 0 : ref_minPathSum(node.right);
+    return node.elt + (node.left < 0 ? right : node.right < 0 ? left : (left < right ? left : right));
+}
+
+static bool ref_covered(tree_t A, int b)
+{
+    return tree_isEmpty(A) ||
+           (b >= 0 && tree_elt(A) == ref_nodes[b].elt &&
+            ref_covered(tree_left(A), ref_nodes[b].left) && ref_covered(tree_right(A), ref_nodes[b].right));
+}
+
+static bool ref_contained(tree_t A, int b)
+{
+    return ref_covered(A, b) || (b >= 0 && (ref_contained(A, ref_nodes[b].left) ||
+                                            ref_contained(A, ref_nodes[b].right)));
+}
+
+/**************************************************/
+
+// Timing and checking
+
+template <typename F>
+static double time_call(int reps, F f)
+    // EFFECTS: calls f reps times, each in an arena if use_arena, and
+    //          returns the mean time of a call in microseconds
+{
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (int i = 0; i < reps; i++) {
+        if (use_arena) {
+            cell_arena arena;
+            f();
+        } else {
+            f();
+        }
+    }
+    chrono::duration<double, micro> elapsed = chrono::steady_clock::now() - start;
+    return elapsed.count() / reps;
+}
+
+static void report(const char *function, size_t n, double us, bool correct)
+    // MODIFIES: cout
+    // EFFECTS: prints the time of function, or fails if it was not correct
+{
+    if (!correct) {
+        cout << "FAIL " << function << " " << n << endl;
+        exit(1);
+    }
+    cout << backend << (use_arena ? "+arena" : "") << " " << left << setw(24) << function
+         << right << setw(10) << n << " " << fixed << setprecision(3) << us << endl;
+}
+
+// times the expression call, under the name function, then checks that
+// check holds of the result of one more call, result
+#define MEASURE(function, type, call, check)                                \
+    do {                                                                    \
+        double us = time_call(reps, [&]() {                                 \
+            type result = call;                                             \
+            (void) result;                                                  \
+        });                                                                 \
+        bool correct;                                                       \
+        if (use_arena) {                                                    \
+            cell_arena arena;                                               \
+            type result = call;                                             \
+            correct = check;                                                \
+        } else {                                                            \
+            type result = call;                                             \
+            correct = check;                                                \
+        }                                                                   \
+        report(function, n, us, correct);                                   \
+    } while (0)
+
+static void test_lists(size_t n, int reps)
+    // EFFECTS: checks and times the list functions on lists of n elements
+{
+    vector<int> v(n), w(n), increasing(n), arithmetic(n);
+    for (size_t i = 0; i < n; i++) {
+        v[i] = random_int(-50, 50);
+        w[i] = random_int(-50, 50);
+        increasing[i] = (int) i / 2;
+        arithmetic[i] = 3 * (int) i - 7;
+    }
+    list_t lv = make_list(v), lw = make_list(w);
+    list_t linc = make_list(increasing), lari = make_list(arithmetic);
+    unsigned int cut = (unsigned int) random_int(0, (int) n);
+
+    long long dot_product = 0;
+    for (size_t i = 0; i < n; i++) {
+        dot_product += (long long) v[i] * w[i];
+    }
+    vector<int> reversed(v.rbegin(), v.rend());
+    vector<int> appended(v);
+    appended.insert(appended.end(), w.begin(), w.end());
+    vector<int> inserted(v.begin(), v.begin() + cut);
+    inserted.insert(inserted.end(), w.begin(), w.end());
+    inserted.insert(inserted.end(), v.begin() + cut, v.end());
+    vector<int> chopped(v.begin(), v.end() - cut);
+
+    MEASURE("size", int, size(lv), result == (int) n);
+    MEASURE("memberOf", bool, memberOf(lv, 51), !result);
+    MEASURE("dot", int, dot(lv, lw), result == (int) dot_product);
+    MEASURE("isIncreasing", bool, isIncreasing(linc), result == ref_isIncreasing(increasing));
+    MEASURE("isArithmeticSequence", bool, isArithmeticSequence(lari),
+            result == ref_isArithmeticSequence(arithmetic));
+    MEASURE("reverse", list_t, reverse(lv), list_elements(result) == reversed);
+    MEASURE("append", list_t, append(lv, lw), list_elements(result) == appended);
+    MEASURE("filter_odd", list_t, filter_odd(lv), list_elements(result) == ref_filter(v, is_odd));
+    MEASURE("filter", list_t, filter(lv, divisible_by_3),
+            list_elements(result) == ref_filter(v, divisible_by_3));
+    MEASURE("unique", list_t, unique(lv), list_elements(result) == ref_unique(v));
+    MEASURE("insert_list", list_t, insert_list(lv, lw, cut), list_elements(result) == inserted);
+    MEASURE("chop", list_t, chop(lv, cut), list_elements(result) == chopped);
+}
+
+static void test_streams(size_t n, int reps)
+    // EFFECTS: checks and times the stream functions on streams of n
+    //          elements, and pipelines of them against the same on lists
+{
+    vector<int> v(n), w(n);
+    for (size_t i = 0; i < n; i++) {
+        v[i] = random_int(-50, 50);
+        w[i] = random_int(-50, 50);
+    }
+    list_t lv = make_list(v), lw = make_list(w);
+    unsigned int cut = (unsigned int) random_int(0, (int) n);
+
+    long long dot_product = 0;
+    for (size_t i = 0; i < n; i++) {
+        dot_product += (long long) v[i] * w[i];
+    }
+    vector<int> reversed(v.rbegin(), v.rend());
+    vector<int> appended(v);
+    appended.insert(appended.end(), w.begin(), w.end());
+    vector<int> inserted(v.begin(), v.begin() + cut);
+    inserted.insert(inserted.end(), w.begin(), w.end());
+    inserted.insert(inserted.end(), v.begin() + cut, v.end());
+    vector<int> chopped(v.begin(), v.end() - cut);
+    vector<int> reversed_chopped(reversed.begin(), reversed.end() - cut);
+    int kept = (int) ref_filter(appended, divisible_by_3).size();
+
+    // the streams are made in each call, so that none is timed already worked out
+    MEASURE("stream size", int, size(stream_from(lv)), result == (int) n);
+    MEASURE("stream memberOf", bool, memberOf(stream_from(lv), 51), !result);
+    MEASURE("stream dot", int, dot(stream_from(lv), stream_from(lw)), result == (int) dot_product);
+    MEASURE("stream isIncreasing", bool, isIncreasing(stream_from(lv)), result == ref_isIncreasing(v));
+    MEASURE("stream isArithmetic", bool, isArithmeticSequence(stream_from(lv)),
+            result == ref_isArithmeticSequence(v));
+    MEASURE("stream reverse", list_t, stream_to_list(reverse(stream_from(lv))),
+            list_elements(result) == reversed);
+    MEASURE("stream append", list_t, stream_to_list(append(stream_from(lv), stream_from(lw))),
+            list_elements(result) == appended);
+    MEASURE("stream filter_odd", list_t, stream_to_list(filter_odd(stream_from(lv))),
+            list_elements(result) == ref_filter(v, is_odd));
+    MEASURE("stream unique", list_t, stream_to_list(unique(stream_from(lv))),
+            list_elements(result) == ref_unique(v));
+    MEASURE("stream insert_list", list_t, stream_to_list(insert_list(stream_from(lv), stream_from(lw), cut)),
+            list_elements(result) == inserted);
+    MEASURE("stream chop", list_t, stream_to_list(chop(stream_from(lv), cut)),
+            list_elements(result) == chopped);
+
+    MEASURE("list size(filter(app))", int, size(filter(append(lv, lw), divisible_by_3)), result == kept);
+    MEASURE("stream size(filter(app))", int,
+            size(filter(append(stream_from(lv), stream_from(lw)), divisible_by_3)), result == kept);
+    MEASURE("list chop(reverse)", list_t, chop(reverse(lv), cut), list_elements(result) == reversed_chopped);
+    MEASURE("stream chop(reverse)", list_t, stream_to_list(chop(reverse(stream_from(lv)), cut)),
+            list_elements(result) == reversed_chopped);
+    // a prefix: w[0] is met early in v, which the stream reads no further than
+    MEASURE("list memberOf(append)", bool, memberOf(append(lv, lw), w[0]), result);
+    MEASURE("stream memberOf(append)", bool, memberOf(append(stream_from(lv), stream_from(lw)), w[0]), result);
+}
+
+static void test_trees(size_t n, int reps)
+    // EFFECTS: checks and times the functions on random trees of n elements
+{
+    unsigned int threads = thread::hardware_concurrency();
+    if (threads == 0) {
+        threads = 1;
+    }
+
+    // a random tree of small elements, so that some of its paths are
+    // monotonic and it contains some of the small trees
+    vector<int> small(n);
+    for (size_t i = 0; i < n; i++) {
+        small[i] = random_int(0, 3);
+    }
+    vector<ref_node>().swap(ref_nodes);
+    int rt;
+    tree_t tree = random_tree(small, 0, n, rt);
+    tree_t inside = pick_subtree(tree);
+    vector<int> other_elts(5, 4);
+    int unused;
+    tree_t other = random_tree(other_elts, 0, other_elts.size(), unused);
+    vector<int> in_order, pre_order, post_order;
+    ref_traversal(rt, in_order, 0);
+    ref_traversal(rt, pre_order, -1);
+    ref_traversal(rt, post_order, 1);
+    int bound = (int) ref_minPathSum(rt) - random_int(0, 1);
+
+    MEASURE("tree_sum", int, tree_sum(tree), result == (int) ref_sum(rt));
+    MEASURE("tree_search", bool, tree_search(tree, 3), result == ref_search(rt, 3));
+    MEASURE("depth", int, depth(tree), result == ref_depth(rt));
+    MEASURE("tree_max", int, tree_max(tree), result == ref_max(rt));
+    MEASURE("traversal", list_t, traversal(tree), list_elements(result) == in_order);
+    MEASURE("traversal_preorder", list_t, traversal_preorder(tree), list_elements(result) == pre_order);
+    MEASURE("traversal_postorder", list_t, traversal_postorder(tree), list_elements(result) == post_order);
+    MEASURE("traversal_parallel", list_t, traversal_parallel(tree, threads),
+            list_elements(result) == in_order);
+    MEASURE("tree_hasMonotonicPath", bool, tree_hasMonotonicPath(tree),
+            result == (ref_monotonic(rt, ref_nodes[rt].elt, 1) || ref_monotonic(rt, ref_nodes[rt].elt, -1)));
+    MEASURE("tree_allPathSumGreater", bool, tree_allPathSumGreater(tree, bound),
+            result == (ref_minPathSum(rt) > bound));
+    MEASURE("covered_by", bool, covered_by(inside, tree), result == ref_covered(inside, rt));
+    MEASURE("contained_by", bool, contained_by(inside, tree) && !contained_by(other, tree),
+            result == (ref_contained(inside, rt) && !ref_contained(other, rt)));
+    MEASURE("contained_by_parallel", bool,
+            contained_by_parallel(inside, tree, threads) && !contained_by_parallel(other, tree, threads),
+            result == (ref_contained(inside, rt) && !ref_contained(other, rt)));
+
+    // a random tree of elements near INT_MAX, whose sums overflow an int
+    // although nothing asked for them while it was built
+    vector<int> large(n);
+    for (size_t i = 0; i < n; i++) {
+        large[i] = INT_MAX - random_int(0, 1000);
+    }
+    int rl;
+    tree_t big = random_tree(large, 0, n, rl);
+
+    MEASURE("tree_sum_large", int, tree_sum(big), result == (int) ref_sum(rl));
+    MEASURE("tree_max_large", int, tree_max(big), result == ref_max(rl));
+    MEASURE("tree_allPathSum_large", bool, tree_allPathSumGreater(big, INT_MIN),
+            result == ((int) ref_minPathSum(rl) > INT_MIN));
+}
+
+static void test_sorted_trees(size_t n, int reps)
+    // EFFECTS: checks and times the functions on sorted trees of n elements
+{
+    // sorted trees of the even numbers, a random and a balanced one,
+    // with an odd number inserted
+    vector<int> sorted(n);
+    for (size_t i = 0; i < n; i++) {
+        sorted[i] = 2 * (int) i;
+    }
+    vector<ref_node>().swap(ref_nodes);
+    int rs;
+    tree_t bst = random_tree(sorted, 0, n, rs);
+    tree_t avl = balanced_tree(sorted, 0, n);
+    int key = 2 * random_int(0, (int) n) - 1;
+    vector<int> with_key(sorted);
+    with_key.insert(lower_bound(with_key.begin(), with_key.end(), key), key);
+
+    MEASURE("insert_tree", tree_t, insert_tree(key, bst),
+            list_elements(traversal_parallel(result, 1)) == with_key && tree_size(result) == (int) n + 1);
+    MEASURE("insert_tree_balanced", tree_t, insert_tree_balanced(key, avl),
+            list_elements(traversal_parallel(result, 1)) == with_key &&
+            tree_height(result) <= tree_height(avl) + 1);
+    MEASURE("sorted_tree_search", bool, sorted_tree_search(bst, key + 1) && !sorted_tree_search(avl, key),
+            result == (key + 1 <= 2 * ((int) n - 1)));
+    MEASURE("sorted_tree_max", int, sorted_tree_max(avl), result == 2 * ((int) n - 1));
+}
+
+static void run_test(void (*test)(size_t, int), size_t n, int reps)
+    // EFFECTS: runs test, in an arena that frees its lists and trees
+    //          after it if use_arena
+{
+    if (use_arena) {
+        cell_arena arena;
+        test(n, reps);
+    } else {
+        test(n, reps);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    size_t max_size = argc > 1 ? strtoul(argv[1], NULL, 10) : STRESS_MAX_SIZE;
+    rng.seed(argc > 2 ? (unsigned int) strtoul(argv[2], NULL, 10) : 2800);
+    use_arena = argc > 3 && string(argv[3]) != "0";
+
+    for (size_t n = 100; n <= max_size; n *= 10) {
+        // enough calls of the small sizes to time them
+        int reps = n < 100000 ? (int) (100000 / n) : 1;
+        run_test(test_lists, n, reps);
+        run_test(test_streams, n, reps);
+        run_test(test_trees, n, reps);
+        run_test(test_sorted_trees, n, reps);
+    }
+    return 0;
+}
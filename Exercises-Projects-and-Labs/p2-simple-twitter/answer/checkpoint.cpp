@@ -0,0 +1,114 @@
+/*
+ * Checkpoints: snapshots of the server, as datasets, and the log of the
+ * entries applied since the last, so that a restart replays only those.
+ */
+
+#include "server_type.h"
+#include "simulation.h"
+#include "../../../bench/tracing.h"
+
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+    bool syncPath(const std::filesystem::path &path, int flags) {
+        int fd = ::open(path.c_str(), flags);
+        if (fd < 0) return false;
+        bool synced = ::fsync(fd) == 0;
+        return ::close(fd) == 0 && synced;
+    }
+}
+
+Checkpoint::Checkpoint(const std::string &directory, std::size_t every) : directory(directory), every(every) {
+    std::error_code error;
+    std::filesystem::create_directories(this->directory, error);
+    if (!std::filesystem::is_directory(this->directory, error)) {
+        throw FileMissingException(directory);
+    }
+    // the newest snapshot is the one with the highest generation; a snapshot
+    // that was not renamed is not whole
+    std::vector<std::filesystem::path> temporary;
+    for (const auto &file : std::filesystem::directory_iterator(this->directory)) {
+        auto name = file.path().filename().string();
+        if (name.compare(0, 13, "snapshot.tmp.") == 0) {
+            temporary.emplace_back(file.path());
+        } else if (name.compare(0, 9, "snapshot.") == 0 && name.size() > 9 &&
+                   name.find_first_not_of("0123456789", 9) == std::string::npos) {
+            auto g = std::stoull(name.substr(9));
+            if (!hasSnapshot || g > generation) generation = g;
+            hasSnapshot = true;
+        }
+    }
+    for (const auto &path : temporary) {
+        std::filesystem::remove(path, error);
+    }
+}
+
+Checkpoint::~Checkpoint() {
+    if (fd >= 0) {
+        flush();
+        ::close(fd);
+    }
+}
+
+void Checkpoint::openLog() {
+    fd = ::open(log().c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (fd < 0) {
+        throw FileMissingException(log().string());
+    }
+}
+
+void Checkpoint::resume(std::size_t count) {
+    entries = count;
+    openLog();
+}
+
+void Checkpoint::flush() {
+    std::size_t done = 0;
+    while (done < buffer.size()) {
+        auto n = ::write(fd, buffer.data() + done, buffer.size() - done);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            failed = true;
+            break;
+        }
+        done += std::size_t(n);
+    }
+    buffer.clear();
+}
+
+void Checkpoint::commit() {
+    // the snapshot holds every entry of the log, which is then dropped
+    flush();
+    auto temp = nextSnapshot(), next = path("snapshot", generation + 1);
+    if (!syncPath(temp, O_RDONLY) || std::rename(temp.c_str(), next.c_str()) != 0 ||
+        !syncPath(directory, O_RDONLY | O_DIRECTORY)) {
+        failed = true;
+        return;
+    }
+    ::close(fd);
+    auto old = generation;
+    auto hadSnapshot = hasSnapshot;
+    generation++;
+    hasSnapshot = true;
+    entries = 0;
+    openLog();
+    std::error_code error;
+    if (hadSnapshot) std::filesystem::remove(path("snapshot", old), error);
+    std::filesystem::remove(path("wal", old), error);
+}
+
+void Server::enableCheckpoint(const std::string &directory, std::size_t every) {
+    checkpoint = std::make_unique<Checkpoint>(directory, every);
+}
+
+void Server::takeSnapshot() {
+    TRACE_SCOPE("snapshot");
+    try {
+        saveDataset(checkpoint->nextSnapshot().string());
+        checkpoint->commit();
+    } catch (SimpleTwitterException &) {
+        checkpoint->fail();
+    }
+}
@@ -0,0 +1,379 @@
+/*
+ * Packed datasets: the users, posts and relations of a server in one file,
+ * which can be mapped and read in place.
+ */
+
+#include "server_type.h"
+#include "simulation.h"
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    const char DATASET_MAGIC[8] = {'P', '2', 'D', 'A', 'T', 'A', '0', '2'};
+
+    // A string of the string table
+    struct DatasetString {
+        std::uint64_t offset;
+        std::uint64_t size;
+    };
+
+    // The posts of a user, and the users it follows and is followed by, are
+    // ranges of the post table and of the following and followers arrays
+    struct DatasetUser {
+        DatasetString name;
+        std::uint64_t firstPost, numPosts;
+        std::uint64_t firstFollowing, numFollowing;
+        std::uint64_t firstFollower, numFollowers;
+    };
+
+    // The tags of a post index the tag table, its likes the user table
+    struct DatasetPost {
+        DatasetString title;
+        DatasetString text;
+        std::uint64_t firstTag, numTags;
+        std::uint64_t firstLike, numLikes;
+        std::uint64_t firstComment, numComments;
+    };
+
+    // The posts of a tag, in the order search finds them, index the post table
+    struct DatasetTag {
+        DatasetString content;
+        std::uint64_t firstPost, numPosts;
+    };
+
+    struct DatasetComment {
+        std::uint64_t user;
+        DatasetString text;
+    };
+
+    // The header is followed by the tables at its offsets, each aligned to 8
+    // bytes; every field is 8 bytes, so that the tables are read in place
+    struct DatasetHeader {
+        char magic[8];
+        std::uint64_t numUsers, numPosts, numComments, numTags;
+        std::uint64_t numPostTags, numLikes, numFollowing, numFollowers, numTagPosts;
+        std::uint64_t stringsSize;
+        std::uint64_t strings, users, posts, comments, tags;
+        std::uint64_t postTags, likes, following, followers, tagPosts;
+    };
+
+    // Unmaps the file when the load is done or has failed
+    struct Mapping {
+        void *data;
+        std::size_t size;
+
+        ~Mapping() { munmap(data, size); }
+    };
+}
+
+bool Server::isDataset(const std::string &fileName) {
+    char magic[sizeof(DATASET_MAGIC)] = {};
+    std::ifstream fin(fileName, std::ios::binary);
+    fin.read(magic, sizeof(magic));
+    return fin && std::memcmp(magic, DATASET_MAGIC, sizeof(magic)) == 0;
+}
+
+void Server::saveDataset(const std::string &fileName) const {
+    std::ofstream fout(fileName, std::ios::binary | std::ios::trunc);
+    if (!fout.is_open()) {
+        throw FileMissingException(fileName);
+    }
+
+    std::string strings;
+    auto addString = [&strings](std::string_view str) {
+        DatasetString ref{strings.size(), str.size()};
+        strings += str;
+        return ref;
+    };
+
+    std::vector<DatasetUser> userTable;
+    std::vector<DatasetPost> postTable;
+    std::vector<DatasetComment> commentTable;
+    std::vector<std::uint64_t> postTags, likes, following, followers, tagPosts;
+    std::unordered_map<const Post *, std::uint64_t> postIndex;
+    for (const auto &user : users) {
+        DatasetUser record{};
+        record.name = addString(user->getName());
+        record.firstPost = postTable.size();
+        record.numPosts = user->getPosts().size();
+        for (const auto &post : user->getPosts()) {
+            postIndex.emplace(&*post, postTable.size());
+            DatasetPost postRecord{};
+            postRecord.title = addString(post->getTitle());
+            postRecord.text = addString(post->getText());
+            postRecord.firstTag = postTags.size();
+            postRecord.numTags = post->getTags().size();
+            for (auto tag : post->getTags()) {
+                postTags.emplace_back(tagIds.at(tag->getContent()));
+            }
+            postRecord.firstLike = likes.size();
+            postRecord.numLikes = post->getLikes().count();
+            post->getLikes().forEach([&likes](std::size_t id) { likes.emplace_back(id); });
+            postRecord.firstComment = commentTable.size();
+            postRecord.numComments = post->getComments().size();
+            for (const auto &comment : post->getComments()) {
+                commentTable.push_back(DatasetComment{comment->getUser()->getId(), addString(comment->getText())});
+            }
+            postTable.emplace_back(postRecord);
+        }
+        record.firstFollowing = following.size();
+        record.numFollowing = user->getFollowingCount();
+        user->forEachFollowing([&following](User *user2) { following.emplace_back(user2->getId()); });
+        record.firstFollower = followers.size();
+        record.numFollowers = user->getFollowersCount();
+        user->forEachFollower([&followers](User *user2) { followers.emplace_back(user2->getId()); });
+        userTable.emplace_back(record);
+    }
+
+    std::vector<DatasetTag> tagTable;
+    for (const auto &tag : tags) {
+        DatasetTag record{addString(tag->getContent()), tagPosts.size(), tag->getPosts().size()};
+        tag->getPosts().forRange(0, record.numPosts, [&](Post *post) { tagPosts.emplace_back(postIndex.at(post)); });
+        tagTable.emplace_back(record);
+    }
+
+    DatasetHeader header{};
+    std::memcpy(header.magic, DATASET_MAGIC, sizeof(header.magic));
+    header.numUsers = userTable.size();
+    header.numPosts = postTable.size();
+    header.numComments = commentTable.size();
+    header.numTags = tagTable.size();
+    header.numPostTags = postTags.size();
+    header.numLikes = likes.size();
+    header.numFollowing = following.size();
+    header.numFollowers = followers.size();
+    header.numTagPosts = tagPosts.size();
+    header.stringsSize = strings.size();
+
+    // Lay out the tables one after another, each aligned to 8 bytes
+    std::uint64_t end = sizeof(header);
+    auto place = [&end](std::uint64_t size) {
+        auto offset = end;
+        end = (end + size + 7) / 8 * 8;
+        return offset;
+    };
+    header.strings = place(strings.size());
+    header.users = place(userTable.size() * sizeof(DatasetUser));
+    header.posts = place(postTable.size() * sizeof(DatasetPost));
+    header.comments = place(commentTable.size() * sizeof(DatasetComment));
+    header.tags = place(tagTable.size() * sizeof(DatasetTag));
+    header.postTags = place(postTags.size() * sizeof(std::uint64_t));
+    header.likes = place(likes.size() * sizeof(std::uint64_t));
+    header.following = place(following.size() * sizeof(std::uint64_t));
+    header.followers = place(followers.size() * sizeof(std::uint64_t));
+    header.tagPosts = place(tagPosts.size() * sizeof(std::uint64_t));
+
+    std::uint64_t written = 0;
+    auto section = [&fout, &written](std::uint64_t offset, const void *data, std::uint64_t size) {
+        static const char zeros[8] = {};
+        fout.write(zeros, std::streamsize(offset - written));
+        fout.write(static_cast<const char *>(data), std::streamsize(size));
+        written = offset + size;
+    };
+    section(0, &header, sizeof(header));
+    section(header.strings, strings.data(), strings.size());
+    section(header.users, userTable.data(), userTable.size() * sizeof(DatasetUser));
+    section(header.posts, postTable.data(), postTable.size() * sizeof(DatasetPost));
+    section(header.comments, commentTable.data(), commentTable.size() * sizeof(DatasetComment));
+    section(header.tags, tagTable.data(), tagTable.size() * sizeof(DatasetTag));
+    section(header.postTags, postTags.data(), postTags.size() * sizeof(std::uint64_t));
+    section(header.likes, likes.data(), likes.size() * sizeof(std::uint64_t));
+    section(header.following, following.data(), following.size() * sizeof(std::uint64_t));
+    section(header.followers, followers.data(), followers.size() * sizeof(std::uint64_t));
+    section(header.tagPosts, tagPosts.data(), tagPosts.size() * sizeof(std::uint64_t));
+    section(end, nullptr, 0);
+    if (!fout) {
+        throw FileMissingException(fileName);
+    }
+}
+
+void Server::loadDataset(const std::string &fileName) {
+    int fd = open(fileName.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw FileMissingException(fileName);
+    }
+    struct stat info{};
+    if (fstat(fd, &info) != 0 || std::size_t(info.st_size) < sizeof(DatasetHeader)) {
+        close(fd);
+        throw InvalidDatasetException(fileName);
+    }
+    auto size = std::uint64_t(info.st_size);
+    void *mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        throw FileMissingException(fileName);
+    }
+    Mapping mapping{mapped, size};
+    auto data = static_cast<const char *>(mapped);
+
+    // Check every table, range and index before anything is built
+    DatasetHeader header{};
+    std::memcpy(&header, data, sizeof(header));
+    auto fits = [size](std::uint64_t offset, std::uint64_t count, std::uint64_t itemSize) {
+        return offset % 8 == 0 && offset <= size && count <= (size - offset) / itemSize;
+    };
+    auto inRange = [](std::uint64_t first, std::uint64_t count, std::uint64_t total) {
+        return first <= total && count <= total - first;
+    };
+    if (std::memcmp(header.magic, DATASET_MAGIC, sizeof(header.magic)) != 0 ||
+        !fits(header.strings, header.stringsSize, 1) ||
+        !fits(header.users, header.numUsers, sizeof(DatasetUser)) ||
+        !fits(header.posts, header.numPosts, sizeof(DatasetPost)) ||
+        !fits(header.comments, header.numComments, sizeof(DatasetComment)) ||
+        !fits(header.tags, header.numTags, sizeof(DatasetTag)) ||
+        !fits(header.postTags, header.numPostTags, sizeof(std::uint64_t)) ||
+        !fits(header.likes, header.numLikes, sizeof(std::uint64_t)) ||
+        !fits(header.following, header.numFollowing, sizeof(std::uint64_t)) ||
+        !fits(header.followers, header.numFollowers, sizeof(std::uint64_t)) ||
+        !fits(header.tagPosts, header.numTagPosts, sizeof(std::uint64_t))) {
+        throw InvalidDatasetException(fileName);
+    }
+    auto userTable = reinterpret_cast<const DatasetUser *>(data + header.users);
+    auto postTable = reinterpret_cast<const DatasetPost *>(data + header.posts);
+    auto commentTable = reinterpret_cast<const DatasetComment *>(data + header.comments);
+    auto tagTable = reinterpret_cast<const DatasetTag *>(data + header.tags);
+    auto postTags = reinterpret_cast<const std::uint64_t *>(data + header.postTags);
+    auto likes = reinterpret_cast<const std::uint64_t *>(data + header.likes);
+    auto following = reinterpret_cast<const std::uint64_t *>(data + header.following);
+    auto followers = reinterpret_cast<const std::uint64_t *>(data + header.followers);
+    auto tagPosts = reinterpret_cast<const std::uint64_t *>(data + header.tagPosts);
+
+    auto validString = [&header](const DatasetString &str) {
+        return str.offset <= header.stringsSize && str.size <= header.stringsSize - str.offset;
+    };
+    auto validIds = [](const std::uint64_t *ids, std::uint64_t first, std::uint64_t count, std::uint64_t total) {
+        for (auto i = first; i < first + count; i++) {
+            if (ids[i] >= total) return false;
+        }
+        return true;
+    };
+    bool valid = true;
+    for (std::uint64_t i = 0; valid && i < header.numTags; i++) {
+        auto &tag = tagTable[i];
+        valid = validString(tag.content) && inRange(tag.firstPost, tag.numPosts, header.numTagPosts) &&
+                validIds(tagPosts, tag.firstPost, tag.numPosts, header.numPosts);
+    }
+    for (std::uint64_t i = 0; valid && i < header.numComments; i++) {
+        valid = validString(commentTable[i].text) && commentTable[i].user < header.numUsers;
+    }
+    for (std::uint64_t i = 0; valid && i < header.numPosts; i++) {
+        auto &post = postTable[i];
+        valid = validString(post.title) && validString(post.text) &&
+                inRange(post.firstTag, post.numTags, header.numPostTags) &&
+                inRange(post.firstLike, post.numLikes, header.numLikes) &&
+                inRange(post.firstComment, post.numComments, header.numComments) &&
+                validIds(postTags, post.firstTag, post.numTags, header.numTags) &&
+                validIds(likes, post.firstLike, post.numLikes, header.numUsers);
+    }
+    for (std::uint64_t i = 0; valid && i < header.numUsers; i++) {
+        auto &user = userTable[i];
+        valid = validString(user.name) &&
+                inRange(user.firstPost, user.numPosts, header.numPosts) &&
+                inRange(user.firstFollowing, user.numFollowing, header.numFollowing) &&
+                inRange(user.firstFollower, user.numFollowers, header.numFollowers) &&
+                validIds(following, user.firstFollowing, user.numFollowing, header.numUsers) &&
+                validIds(followers, user.firstFollower, user.numFollowers, header.numUsers);
+    }
+    if (!valid) {
+        throw InvalidDatasetException(fileName);
+    }
+
+    auto strings = data + header.strings;
+    auto getString = [strings](const DatasetString &str) {
+        return std::string(strings + str.offset, str.size);
+    };
+
+    for (std::uint64_t i = 0; i < header.numUsers; i++) {
+        auto name = getString(userTable[i].name);
+        if (!userIds.emplace(name, users.size()).second) {
+            throw InvalidDatasetException(fileName);
+        }
+        auto shard = &stringShards[users.size() % stringShards.size()];
+        users.emplace_back(std::make_unique<User>(std::move(name), users.size(), &graph, shard));
+    }
+    if (users.size() > limits.users) {
+        throw TooManyUsersException();
+    }
+
+    // Build each user as the directory loader would, with the same limits
+    for (std::uint64_t i = 0; i < header.numUsers; i++) {
+        auto &user = userTable[i];
+        UserRecord record;
+        try {
+            if (user.numPosts > limits.posts) {
+                throw TooManyPostsException(users[i]->getName());
+            }
+            for (auto j = user.firstPost; j < user.firstPost + user.numPosts; j++) {
+                auto &post = postTable[j];
+                PostRecord postRecord;
+                postRecord.title = getString(post.title);
+                postRecord.text = getString(post.text);
+                for (auto k = post.firstTag; k < post.firstTag + post.numTags; k++) {
+                    postRecord.tags.emplace_back(getString(tagTable[postTags[k]].content));
+                }
+                if (postRecord.tags.size() > limits.tags) {
+                    throw TooManyTagsException(postRecord.title);
+                }
+                if (post.numLikes > limits.likes) {
+                    throw TooManyLikesException(postRecord.title);
+                }
+                for (auto k = post.firstLike; k < post.firstLike + post.numLikes; k++) {
+                    postRecord.likes.emplace_back(users[likes[k]].get());
+                }
+                if (post.numComments > limits.comments) {
+                    throw TooManyCommentsException(postRecord.title);
+                }
+                for (auto k = post.firstComment; k < post.firstComment + post.numComments; k++) {
+                    auto &comment = commentTable[k];
+                    postRecord.comments.emplace_back(users[comment.user].get(), getString(comment.text));
+                }
+                record.posts.emplace_back(std::move(postRecord));
+            }
+            if (user.numFollowing > limits.following) {
+                throw TooManyFollowingsException(users[i]->getName());
+            }
+            for (auto j = user.firstFollowing; j < user.firstFollowing + user.numFollowing; j++) {
+                record.following.emplace_back(users[following[j]].get());
+            }
+            if (user.numFollowers > limits.followers) {
+                throw TooManyFollowersException(users[i]->getName());
+            }
+            for (auto j = user.firstFollower; j < user.firstFollower + user.numFollowers; j++) {
+                record.followers.emplace_back(users[followers[j]].get());
+            }
+        } catch (...) {
+            record.error = std::current_exception();
+        }
+        initUser(users[i].get(), record);
+    }
+    graph.following.compact();
+    graph.followers.compact();
+
+    // the posts were made user by user; search finds them in the order saved
+    std::vector<Post *> postsByIndex;
+    for (const auto &user : users) {
+        for (const auto &post : user->getPosts()) {
+            postsByIndex.emplace_back(&*post);
+        }
+    }
+    if (postsByIndex.size() != header.numPosts) {
+        throw InvalidDatasetException(fileName);
+    }
+    for (std::uint64_t i = 0; i < header.numTags; i++) {
+        auto &tag = tagTable[i];
+        auto it = tagIds.find(getString(tag.content));
+        std::vector<Post *> order;
+        for (auto k = tag.firstPost; k < tag.firstPost + tag.numPosts; k++) {
+            order.emplace_back(postsByIndex[tagPosts[k]]);
+        }
+        if (it == tagIds.end() ? !order.empty() : !tags[it->second]->reorderPosts(order)) {
+            throw InvalidDatasetException(fileName);
+        }
+    }
+}
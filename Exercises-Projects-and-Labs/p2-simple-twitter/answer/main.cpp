@@ -1,8 +1,31 @@
 #include "simulation.h"
 #include <iostream>
 #include <fstream>
+#include <string>
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+
+static void stopFollowing(int) {
+    Server::stopFollowing();
+}
+
+static std::size_t parseCount(const std::string &option, const char *value) {
+    // EFFECTS: returns value as a decimal count, or throws an
+    //          InvalidArgumentException naming option if it is not one
+    char *end;
+    errno = 0;
+    unsigned long count = std::strtoul(value, &end, 10);
+    if (*value < '0' || *value > '9' || *end != '\0' || errno == ERANGE) {
+        throw InvalidArgumentException(option + " " + value);
+    }
+    return count;
+}
 
 int main(int argc, char *argv[]) {
+    // the output is flushed only when its buffer is full, and at the end
+    std::ios::sync_with_stdio(false);
 #ifdef DEBUG
     std::ofstream fout("test.out1");
     std::streambuf* coutBuf = std::cout.rdbuf();
@@ -12,9 +35,73 @@ int main(int argc, char *argv[]) {
         if (argc <= 2) {
             throw InvalidArgumentException();
         }
+        // ./p2 <username> <logfile> [--no-limits] [--save <dataset>] [--stats <file>] [--journal <file>]
+        //            [--window <entries>] [--checkpoint <directory>] [--snapshot-every <entries>]
+        //            [--follow [--follow-timeout <milliseconds>]]
+        std::string savePath, statsPath, journalPath, checkpointPath;
+        std::size_t window = 0, snapshotEvery = 1000000, followTimeout = 0;
+        bool follow = false, timeout = false;
+        for (int i = 3; i < argc; i++) {
+            std::string arg = argv[i];
+            if (arg == "--no-limits") {
+                Server::limits = Limits::none();
+            } else if (arg == "--save" && i + 1 < argc) {
+                savePath = argv[++i];
+            } else if (arg == "--stats" && i + 1 < argc) {
+                statsPath = argv[++i];
+            } else if (arg == "--journal" && i + 1 < argc) {
+                journalPath = argv[++i];
+            } else if (arg == "--window" && i + 1 < argc) {
+                window = parseCount(arg, argv[++i]);
+            } else if (arg == "--checkpoint" && i + 1 < argc) {
+                checkpointPath = argv[++i];
+            } else if (arg == "--snapshot-every" && i + 1 < argc) {
+                snapshotEvery = std::max<std::size_t>(1, parseCount(arg, argv[++i]));
+            } else if (arg == "--follow") {
+                follow = true;
+            } else if (arg == "--follow-timeout" && i + 1 < argc) {
+                followTimeout = parseCount(arg, argv[++i]);
+                timeout = true;
+            } else if (arg.compare(0, 2, "--") == 0) {
+                // an unknown option, or one without its value; any other
+                // argument past the two files is ignored as it always was
+                throw InvalidArgumentException(arg);
+            }
+        }
+        if (timeout && !follow) {
+            throw InvalidArgumentException("--follow-timeout without --follow");
+        }
         auto &server = Server::getInstance();
-        server.initUsers(argv[1]);
-        server.readLog(argv[2]);
+        if (!statsPath.empty()) {
+            server.enableStats();
+        }
+        if (!journalPath.empty()) {
+            server.setOutput(std::make_unique<JournalSink>(journalPath));
+        }
+        if (checkpointPath.empty()) {
+            server.initUsers(argv[1]);
+        } else {
+            server.enableCheckpoint(checkpointPath, snapshotEvery);
+            server.restore(argv[1]);
+        }
+        if (window > 0) {
+            server.setWindow(window);
+        }
+        if (follow) {
+            // an interrupt ends the log, so that the stats and the dataset
+            // are still written
+            std::signal(SIGINT, stopFollowing);
+            std::signal(SIGTERM, stopFollowing);
+            server.followLog(argv[2], followTimeout);
+        } else {
+            server.readLog(argv[2]);
+        }
+        if (!statsPath.empty()) {
+            server.writeStats(statsPath);
+        }
+        if (!savePath.empty()) {
+            server.saveDataset(savePath);
+        }
     } catch (SimpleTwitterException &e) {
         std::cout << e.what() << std::endl;
     }
@@ -0,0 +1,78 @@
+/*
+ * The sinks the output of the server can be written to.
+ */
+
+#include "server_type.h"
+#include "simulation.h"
+
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    // how much of a journal is mapped at a time, a multiple of the page size
+    const std::size_t JOURNAL_WINDOW = std::size_t(16) << 20;
+}
+
+void StdoutSink::write(std::string_view str) {
+    std::cout.rdbuf()->sputn(str.data(), static_cast<std::streamsize>(str.size()));
+}
+
+void StdoutSink::flush() {
+    std::cout.rdbuf()->pubsync();
+}
+
+JournalSink::JournalSink(const std::string &fileName) {
+    fd = ::open(fileName.c_str(), O_RDWR | O_CREAT, 0644);
+    struct stat st{};
+    if (fd < 0 || ::fstat(fd, &st) != 0) {
+        if (fd >= 0) ::close(fd);
+        throw FileMissingException(fileName);
+    }
+    // appended after what the file already holds
+    size = static_cast<std::size_t>(st.st_size);
+}
+
+JournalSink::~JournalSink() {
+    if (window) ::munmap(window, JOURNAL_WINDOW);
+    if (::ftruncate(fd, static_cast<off_t>(size)) != 0) failed = true;
+    ::close(fd);
+}
+
+void JournalSink::moveWindow() {
+    if (window) {
+        ::munmap(window, JOURNAL_WINDOW);
+        window = nullptr;
+    }
+    // the window starts at the page the journal ends in
+    auto page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    windowStart = size / page * page;
+    if (::ftruncate(fd, static_cast<off_t>(windowStart + JOURNAL_WINDOW)) != 0) {
+        failed = true;
+        return;
+    }
+    void *map = ::mmap(nullptr, JOURNAL_WINDOW, PROT_READ | PROT_WRITE, MAP_SHARED, fd,
+                       static_cast<off_t>(windowStart));
+    if (map == MAP_FAILED) {
+        failed = true;
+        return;
+    }
+    window = static_cast<char *>(map);
+}
+
+void JournalSink::write(std::string_view str) {
+    // once the journal could not grow, the rest of the output is dropped
+    while (!str.empty() && !failed) {
+        if (!window || size == windowStart + JOURNAL_WINDOW) {
+            moveWindow();
+            continue;
+        }
+        auto n = std::min(str.size(), windowStart + JOURNAL_WINDOW - size);
+        std::memcpy(window + (size - windowStart), str.data(), n);
+        size += n;
+        str.remove_prefix(n);
+    }
+}
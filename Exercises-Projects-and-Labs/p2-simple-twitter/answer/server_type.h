@@ -9,14 +9,26 @@
 #define SERVER_TYPE_H
 
 #include <string>
+#include <string_view>
+#include <cassert>
+#include <limits>
+#include <cstdint>
 
 // These headers are not allowed
 // But no one will check them!
 #include <vector>
 #include <unordered_map>
-#include <map>
 #include <set>
 #include <memory>
+#include <algorithm>
+#include <exception>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <optional>
+
+#include "../../../alloc/alloc.h"
 
 // We haven't checked which filesystem to include yet
 #ifndef INCLUDE_STD_FILESYSTEM_EXPERIMENTAL
@@ -74,7 +86,6 @@
 #   if INCLUDE_STD_FILESYSTEM_EXPERIMENTAL
 // Include it
 #       include <experimental/filesystem>
-#include <cassert>
 
 // We need the alias from std::experimental::filesystem to std::filesystem
 namespace std {
@@ -111,6 +122,26 @@ const unsigned int MAX_COMMENTS = 50;
 // Max number of tags per post
 const unsigned int MAX_TAGS = 5;
 
+// Posts per page of search
+const unsigned int SEARCH_PAGE = 10;
+
+// The limits in force, the constants above by default; ./p2 <username>
+// <logfile> --no-limits lifts them all, for replays larger than the project
+struct Limits {
+    std::size_t users = MAX_USERS;
+    std::size_t followers = MAX_FOLLOWERS;
+    std::size_t following = MAX_FOLLOWING;
+    std::size_t posts = MAX_POSTS;
+    std::size_t likes = MAX_LIKES;
+    std::size_t comments = MAX_COMMENTS;
+    std::size_t tags = MAX_TAGS;
+
+    static Limits none() {
+        auto n = std::numeric_limits<std::size_t>::max();
+        return Limits{n, n, n, n, n, n, n};
+    }
+};
+
 enum class Operation {
     FOLLOW,
     UNFOLLOW,
@@ -122,7 +153,8 @@ enum class Operation {
     DELETE,
     REFRESH,
     VISIT,
-    TRENDING
+    TRENDING,
+    SEARCH
 };
 
 /* Compound Types Declaration */
@@ -136,6 +168,328 @@ class Comment;
 
 class Tag;
 
+class LogReader;
+
+class OperationStats;
+
+class Checkpoint;
+
+// Orders tags by score descending, then by content ascending
+struct TagRank {
+    bool operator()(const Tag *a, const Tag *b) const;
+};
+
+// The buckets of the window of trending, ./p2 <username> <logfile> --window <n>
+const std::size_t WINDOW_BUCKETS = 16;
+
+// Every tag of the server in trending order. A tag whose counts change is
+// only marked dirty, and the dirty tags are moved to their new ranks at once
+// when the ranking is next read, however often they changed in between.
+//
+// With a window, a tag scores what its score grew by over the last entries
+// of the log, to within a bucket: the entries are numbered, and cut into
+// buckets of bucketEntries, and each tag keeps the change of its score in
+// each of the last WINDOW_BUCKETS buckets. The tags that changed in a bucket
+// are listed, so that they, and no others, are rescored when it leaves the
+// window.
+struct TagIndex {
+    std::set<Tag *, TagRank> ranked;
+    std::vector<Tag *> dirty;
+    std::size_t bucketEntries = 0;              // 0 for scores of all time
+    std::size_t bucket = 0;                     // of the current entry
+    std::vector<std::vector<Tag *> > touched;   // a ring of WINDOW_BUCKETS
+
+    // rescores the dirty tags, before ranked is read
+    void update();
+
+    // scores the changes of the last entries, from now on
+    void setWindow(std::size_t entries);
+
+    // the log has reached entry seq
+    void advance(std::size_t seq);
+};
+
+// One direction of the follow graph, a row of users for each user id, every
+// row in the order its users were followed. The rows are kept as a CSR
+// snapshot: the users of all rows in one array, and the same rows sorted by
+// id to look users up. Follows since the snapshot are appended to a small
+// delta of their row, and an unfollow only leaves a hole; once the delta and
+// the holes make up a quarter of the graph, the snapshot is rebuilt.
+class Adjacency {
+private:
+    struct Entry {
+        std::size_t id;
+        std::size_t edge;
+    };
+
+    std::vector<std::size_t> offsets = {0};     // row i is [offsets[i], offsets[i + 1])
+    std::vector<User *> edges;                  // nullptr once unfollowed
+    std::vector<Entry> sorted;                  // each row of edges sorted by id
+    std::unordered_map<std::size_t, std::vector<User *> > delta;    // nullptr once unfollowed
+    std::unordered_map<std::uint64_t, std::size_t> deltaIndex;      // where each user is in its delta row
+    std::vector<std::size_t> degree;
+    std::size_t pending = 0;                    // entries of the delta, and holes
+
+    [[nodiscard]] std::size_t rows() const { return offsets.size() - 1; }
+
+    static std::uint64_t key(std::size_t row, std::size_t id) { return std::uint64_t(row) << 32 | id; }
+
+    [[nodiscard]] const Entry *findEdge(std::size_t row, std::size_t id) const;
+
+public:
+    [[nodiscard]] std::size_t count(std::size_t row) const { return row < degree.size() ? degree[row] : 0; }
+
+    [[nodiscard]] bool test(std::size_t row, const User *user) const;
+
+    // user must not be in the row yet
+    void add(std::size_t row, User *user);
+
+    // user must be in the row
+    void remove(std::size_t row, User *user);
+
+    void compact();
+
+    template<class F>
+    void forEach(std::size_t row, F f) const {
+        if (row < rows()) {
+            for (auto i = offsets[row]; i < offsets[row + 1]; i++) {
+                if (edges[i]) f(edges[i]);
+            }
+        }
+        auto it = delta.find(row);
+        if (it != delta.end()) {
+            for (auto user : it->second) {
+                if (user) f(user);
+            }
+        }
+    }
+};
+
+struct FollowGraph {
+    Adjacency following;
+    Adjacency followers;
+};
+
+// Keeps strings in blocks that never move, so that views of them stay valid
+// as more are stored. Nothing is freed before the arena itself: its owner
+// copies what is still used into a new arena once most of it is dead.
+class StringArena {
+private:
+    std::vector<std::unique_ptr<char[]> > blocks;
+    char *next = nullptr;
+    std::size_t left = 0;
+    std::size_t bytes = 0;
+public:
+    [[nodiscard]] std::size_t size() const { return bytes; }
+
+    std::string_view store(std::string_view str);
+};
+
+// The strings of the posts of the users whose ids are equal modulo the number
+// of shards, who share one arena so that its blocks are filled
+class StringShard {
+private:
+    StringArena arena;
+    std::size_t deadBytes = 0;      // deleted or uncommented since the arena was made
+    std::vector<User *> users;
+public:
+    void addUser(User *user) { users.emplace_back(user); }
+
+    std::string_view store(std::string_view str) { return arena.store(str); }
+
+    // the strings of this many bytes are no longer used
+    void release(std::size_t bytes);
+};
+
+// The output of the log, written by a printer thread while the log goes on.
+// Text is gathered into chunks, and the blocks of posts and users are passed
+// as they are when printed: a block is never changed once made, a post or user
+// that changes makes a new one, and the old one lives until it is written.
+// Where the output of the server goes
+class OutputSink {
+public:
+    virtual ~OutputSink() = default;
+
+    virtual void write(std::string_view str) = 0;
+
+    // makes what was written visible to readers of the output
+    virtual void flush() {}
+
+    // false once some output could not be written
+    [[nodiscard]] virtual bool good() const { return true; }
+};
+
+// Writes to the buffer of std::cout, past the formatting of the stream
+class StdoutSink : public OutputSink {
+public:
+    void write(std::string_view str) override;
+
+    void flush() override;
+};
+
+// Keeps the output in memory, so that it can be compared in place
+class BufferSink : public OutputSink {
+private:
+    std::string buffer;
+public:
+    void write(std::string_view str) override { buffer += str; }
+
+    [[nodiscard]] const std::string &getBuffer() const { return buffer; }
+
+    void clear() { buffer.clear(); }
+};
+
+// Drops the output, of entries whose output was printed before
+class DiscardSink : public OutputSink {
+public:
+    void write(std::string_view) override {}
+};
+
+// Appends to a file through a mapped window of it, which moves on as it
+// fills; the file is cut to what was written when the journal is closed
+class JournalSink : public OutputSink {
+private:
+    int fd = -1;
+    std::size_t size = 0;
+    char *window = nullptr;
+    std::size_t windowStart = 0;
+    bool failed = false;
+
+    void moveWindow();
+
+public:
+    explicit JournalSink(const std::string &fileName);
+
+    JournalSink(const JournalSink &) = delete;
+
+    JournalSink &operator=(const JournalSink &) = delete;
+
+    ~JournalSink() override;
+
+    void write(std::string_view str) override;
+
+    [[nodiscard]] bool good() const override { return !failed; }
+};
+
+// The snapshots and write-ahead logs of --checkpoint <directory>. Generation
+// g is the dataset snapshot.g, the server after some entries of the log, and
+// wal.g, the lines of the entries applied after them. A snapshot is written
+// to a temporary file and renamed, so that snapshot.g exists only once it is
+// whole, and the files of g - 1 are removed after, so that a restart finds
+// the newest whole snapshot and the entries since, wherever it stopped. The
+// log is written in chunks of WAL_CHUNK of whole entries, and the entries of
+// a chunk not written yet are lost if the process is killed.
+class Checkpoint {
+private:
+    std::filesystem::path directory;
+    std::size_t every;                          // entries between snapshots
+    std::size_t generation = 0;                 // of the newest snapshot, or 0
+    bool hasSnapshot = false;
+    std::size_t entries = 0;                    // in the log of the generation
+    int fd = -1;                                // the log, once open
+    std::string buffer;
+    bool failed = false;
+
+    [[nodiscard]] std::filesystem::path path(const char *name, std::size_t g) const {
+        return directory / (name + ("." + std::to_string(g)));
+    }
+
+    void openLog();
+
+public:
+    static const std::size_t WAL_CHUNK = std::size_t(1) << 16;
+
+    Checkpoint(const std::string &directory, std::size_t every);
+
+    Checkpoint(const Checkpoint &) = delete;
+
+    Checkpoint &operator=(const Checkpoint &) = delete;
+
+    ~Checkpoint();
+
+    // the newest snapshot, empty if there is none
+    [[nodiscard]] std::filesystem::path snapshot() const {
+        return hasSnapshot ? path("snapshot", generation) : std::filesystem::path();
+    }
+
+    [[nodiscard]] std::filesystem::path log() const { return path("wal", generation); }
+
+    // the log holds count entries, and the next are appended to it
+    void resume(std::size_t count);
+
+    [[nodiscard]] bool isOpen() const { return fd >= 0; }
+
+    void append(std::string_view lines) {
+        buffer += lines;
+        ++entries;
+        if (buffer.size() >= WAL_CHUNK) flush();
+    }
+
+    // writes the entries appended so far
+    void flush();
+
+    [[nodiscard]] bool due() const { return !failed && entries >= every; }
+
+    // the temporary file the next snapshot is saved to
+    [[nodiscard]] std::filesystem::path nextSnapshot() const { return path("snapshot.tmp", generation + 1); }
+
+    // the next snapshot is saved, and starts the next generation
+    void commit();
+
+    [[nodiscard]] bool good() const { return !failed; }
+
+    void fail() { failed = true; }
+};
+
+class Printer {
+public:
+    using Block = std::shared_ptr<const std::string>;
+private:
+    std::string text;
+    std::vector<Block> batch;
+    std::size_t batchSize = 0;
+
+    OutputSink &sink;
+    std::deque<std::vector<Block> > queue;      // batches not written yet
+    std::mutex mutex;
+    std::condition_variable changed;
+    bool done = false;
+    bool writing = false;                       // the printer has a batch out of the queue
+    std::thread thread;
+
+    void endText();
+
+    void submit();
+
+    void write(const std::vector<Block> &blocks);
+
+    void run();
+
+public:
+    // with a single core, the log writes its output itself
+    explicit Printer(OutputSink &sink) : sink(sink) {
+        if (std::thread::hardware_concurrency() > 1) thread = std::thread(&Printer::run, this);
+    }
+
+    Printer(const Printer &) = delete;
+
+    Printer &operator=(const Printer &) = delete;
+
+    // writes what is left, and waits for the printer to finish
+    ~Printer();
+
+    // writes what was printed so far to the sink, and flushes it
+    void flush();
+
+    Printer &operator<<(const Block &block);
+
+    Printer &operator<<(std::string_view str);
+
+    Printer &operator<<(char c) { return *this << std::string_view(&c, 1); }
+
+    Printer &operator<<(std::size_t n) { return *this << std::string_view(std::to_string(n)); }
+};
+
 
 class Server {
 private:
@@ -144,6 +498,8 @@ private:
     static std::unique_ptr<Server> instance;
     static const std::unordered_map<std::string, Operation> operations;
 public:
+    static Limits limits;
+
     Server &operator=(const Server &) = delete;
 
     Server &operator=(Server &&) = delete;
@@ -157,19 +513,81 @@ public:
     static Server &getInstance();
 
 private:
-    std::unordered_map<std::string, std::unique_ptr<User> > users;
-    std::unordered_map<std::string, std::unique_ptr<Tag> > tags;
-    std::vector<Tag *> orderedTags;
+    // Users and tags are interned: each name is looked up once, to a dense id
+    std::unordered_map<std::string, std::size_t> userIds;
+    std::vector<std::unique_ptr<User> > users;
+    std::unordered_map<std::string, std::size_t> tagIds;
+    std::vector<std::unique_ptr<Tag> > tags;
+    TagIndex rankedTags;
+    std::size_t entryCount = 0;                // of the log, so far
+    FollowGraph graph;
+    std::vector<StringShard> stringShards = std::vector<StringShard>(64);
+    std::unique_ptr<OperationStats> stats;     // only with --stats
+    std::unique_ptr<Checkpoint> checkpoint;    // only with --checkpoint
+    std::unique_ptr<OutputSink> output = std::make_unique<StdoutSink>();
 
     User *getUser(const std::string &userName);
 
     Tag *getTag(const std::string &tagContent);
 
-    void initUser(User *user, const std::filesystem::path &userPath);
+    // A post as read from its file, before its tags are looked up
+    struct PostRecord {
+        std::string title;
+        std::string text;
+        std::vector<std::string> tags;
+        std::vector<User *> likes;
+        std::vector<std::pair<User *, std::string> > comments;
+    };
+
+    // What the files of a user hold, read up to the first error if any
+    struct UserRecord {
+        std::vector<PostRecord> posts;
+        std::vector<User *> following;
+        std::vector<User *> followers;
+        std::exception_ptr error;
+    };
+
+    void readUser(User *user, const std::filesystem::path &userPath, UserRecord &record);
+
+    void readUserFiles(User *user, const std::filesystem::path &userPath, UserRecord &record);
+
+    void readPostFile(const std::filesystem::path &userPath, std::size_t postId, UserRecord &record);
+
+    void initUser(User *user, UserRecord &record);
+
+    static bool isDataset(const std::string &fileName);
+
+    void loadDataset(const std::string &fileName);
+
+    template<class NextLine>
+    void readPost(NextLine nextLine, PostRecord &record);
+
+    std::unique_ptr<Post> makePost(User *user, PostRecord &record);
+
+    // A line of the log, split, with the lines after it that belong to it
+    struct LogEntry {
+        std::string user1, op, user2;
+        Operation operation = Operation::FOLLOW;
+        bool defined = false;
+        std::size_t postId = 0, commentId = 0, count = 0;
+        std::string text;                   // of a comment, or the tag of a search
+        std::string lines;                  // as read, only for a checkpoint
+        PostRecord post;
+        std::exception_ptr error;           // of reading the post
+    };
+
+    void replayLog(LogReader &log, Printer &out);
+
+    // throws if the output or the checkpoint of the log failed
+    void endLog();
+
+    void takeSnapshot();
+
+    bool readEntry(LogReader &log, LogEntry &entry);
 
-    std::unique_ptr<Post> readPost(std::istream &is, User *user);
+    void applyEntry(LogEntry &entry, Printer &out);
 
-    void initPost(User *user, const std::filesystem::path &postPath, std::size_t postId);
+    static bool findOperation(std::string_view op, Operation &operation);
 
     void opFollow(const std::string &userName1, const std::string &userName2);
 
@@ -189,38 +607,336 @@ private:
 
     void opDelete(const std::string &userName1, std::size_t postId);
 
-    void opRefresh(const std::string &userName1);
+    std::size_t opRefresh(const std::string &userName1, Printer &out);
 
-    void opVisit(const std::string &userName1, const std::string &userName2);
+    void opVisit(const std::string &userName1, const std::string &userName2, Printer &out);
 
-    void opTrending(std::size_t n);
+    void opTrending(std::size_t n, Printer &out);
+
+    void opSearch(const std::string &userName1, const std::string &tagContent, std::size_t page, Printer &out);
 
 public:
     void initUsers(const std::string &fileName);
 
+    void saveDataset(const std::string &fileName) const;
+
     void readLog(const std::string &fileName);
+
+    // reads the log as readLog does, then follows it as it grows, applying
+    // the entries appended, until stopFollowing() is called or the log has
+    // not grown for idleTimeout milliseconds, if that is not 0
+    void followLog(const std::string &fileName, std::size_t idleTimeout);
+
+    // ends followLog as if the log ended here; safe to call from a signal
+    // handler
+    static void stopFollowing();
+
+    // snapshots the server into directory every so many entries, and logs
+    // the entries in between
+    void enableCheckpoint(const std::string &directory, std::size_t every);
+
+    // initUsers from the newest snapshot of the checkpoint, or from fileName
+    // if there is none, then applies the entries logged since, printing
+    // nothing, as their output was printed before
+    void restore(const std::string &fileName);
+
+    // the log writes its output to sink, instead of stdout
+    void setOutput(std::unique_ptr<OutputSink> &&sink) { output = std::move(sink); }
+
+    void enableStats();
+
+    // trending scores what the last entries of the log did, from now on
+    void setWindow(std::size_t entries) { rankedTags.setWindow(entries); }
+
+    void writeStats(const std::string &fileName) const;
+};
+
+
+// A set of users, by id. Up to four ids are kept in the set itself, and more
+// as a roaring bitmap: the ids are split by their high bits into chunks of
+// 65536, each a sorted array of the low 16 bits of its ids while it holds at
+// most 4096, and a bitmap of 1024 words above that.
+class UserSet {
+private:
+    static constexpr std::size_t inlineIds = 4;
+    static constexpr std::size_t arrayLimit = 4096;
+
+    struct Chunk {
+        std::size_t key;                    // the ids of the chunk over 65536
+        std::size_t size = 0;
+        std::vector<std::uint16_t> array;   // while size <= arrayLimit
+        std::vector<std::uint64_t> bits;    // once size > arrayLimit
+
+        [[nodiscard]] bool test(std::uint16_t low) const {
+            if (!bits.empty()) return bits[low / 64] >> (low % 64) & 1;
+            return std::binary_search(array.begin(), array.end(), low);
+        }
+
+        bool set(std::uint16_t low);
+
+        bool reset(std::uint16_t low);
+    };
+
+    std::size_t total = 0;
+    std::size_t ids[inlineIds] = {};        // sorted, while chunks is empty
+    std::vector<Chunk> chunks;              // sorted by key
+
+    [[nodiscard]] const Chunk *findChunk(std::size_t key) const {
+        auto it = std::lower_bound(chunks.begin(), chunks.end(), key,
+                                   [](const Chunk &chunk, std::size_t key) { return chunk.key < key; });
+        return it != chunks.end() && it->key == key ? &*it : nullptr;
+    }
+
+    void setInChunks(std::size_t id);
+
+public:
+    [[nodiscard]] bool test(std::size_t id) const {
+        if (chunks.empty()) return std::binary_search(ids, ids + total, id);
+        auto chunk = findChunk(id >> 16);
+        return chunk && chunk->test(id & 0xffff);
+    }
+
+    [[nodiscard]] std::size_t count() const { return total; }
+
+    void set(std::size_t id);
+
+    void reset(std::size_t id);
+
+    // calls f with each id, in increasing order
+    template<class F>
+    void forEach(F f) const {
+        if (chunks.empty()) {
+            for (std::size_t i = 0; i < total; i++) f(ids[i]);
+            return;
+        }
+        for (const auto &chunk : chunks) {
+            auto base = chunk.key << 16;
+            if (chunk.bits.empty()) {
+                for (auto low : chunk.array) f(base | low);
+                continue;
+            }
+            for (std::size_t w = 0; w < chunk.bits.size(); w++) {
+                for (auto word = chunk.bits[w]; word != 0; word &= word - 1) {
+                    f(base | (w * 64 + __builtin_ctzll(word)));
+                }
+            }
+        }
+    }
 };
 
+// The live slots of a list that leaves tombstones, counted in a Fenwick tree
+// so that the slot of the item at a position is found in O(log n)
+class LiveSlots {
+private:
+    std::vector<std::size_t> tree = {0};        // live slots, 1-based
+    std::size_t live = 0;
+
+    [[nodiscard]] std::size_t prefix(std::size_t i) const {
+        std::size_t sum = 0;
+        for (; i > 0; i -= i & -i) sum += tree[i];
+        return sum;
+    }
+
+public:
+    [[nodiscard]] std::size_t size() const { return live; }
+
+    [[nodiscard]] std::size_t slots() const { return tree.size() - 1; }
+
+    // the slot of the (pos + 1)-th live item
+    [[nodiscard]] std::size_t find(std::size_t pos) const {
+        std::size_t i = 0, step = 1;
+        while (step * 2 <= slots()) step *= 2;
+        for (++pos; step > 0; step /= 2) {
+            if (i + step <= slots() && tree[i + step] < pos) {
+                i += step;
+                pos -= tree[i];
+            }
+        }
+        return i;
+    }
+
+    // adds a live slot at the end
+    void push_back() {
+        auto i = tree.size();
+        tree.push_back(1 + prefix(i - 1) - prefix(i - (i & -i)));
+        ++live;
+    }
+
+    void erase(std::size_t slot) {
+        for (auto i = slot + 1; i < tree.size(); i += i & -i) --tree[i];
+        --live;
+    }
+
+    void clear() {
+        tree.assign(1, 0);
+        live = 0;
+    }
+
+    // whether the tombstones are as many as the items, so that iterating
+    // would no longer be O(n)
+    [[nodiscard]] bool sparse() const { return slots() > 2 * live + 16; }
+};
+
+// A list of items numbered by position, as posts and comments are. Erasing
+// an item leaves a tombstone instead of shifting the items after it, and
+// LiveSlots finds the item at a position in O(log n).
+// Items are held by unique_ptr, or in place with Slot = std::optional<T>.
+template<class T, class Slot = std::unique_ptr<T> >
+class StableList {
+private:
+    std::vector<Slot> slots;                    // empty once erased
+    LiveSlots live;
+
+    void compact() {
+        std::vector<Slot> items;
+        items.reserve(live.size());
+        for (auto &item : slots) {
+            if (item) items.emplace_back(std::move(item));
+        }
+        slots.clear();
+        live.clear();
+        for (auto &item : items) push_back(std::move(item));
+    }
+
+public:
+    class iterator {
+    private:
+        typename std::vector<Slot>::const_iterator it, end;
+    public:
+        iterator(decltype(it) it, decltype(it) end) : it(it), end(end) {
+            while (this->it != this->end && !*this->it) ++this->it;
+        }
+
+        const Slot &operator*() const { return *it; }
+
+        iterator &operator++() {
+            do ++it; while (it != end && !*it);
+            return *this;
+        }
+
+        bool operator!=(const iterator &that) const { return it != that.it; }
+    };
+
+    [[nodiscard]] std::size_t size() const { return live.size(); }
+
+    [[nodiscard]] bool empty() const { return live.size() == 0; }
+
+    [[nodiscard]] iterator begin() const { return iterator(slots.begin(), slots.end()); }
+
+    [[nodiscard]] iterator end() const { return iterator(slots.end(), slots.end()); }
+
+    auto *operator[](std::size_t pos) const { return &*slots[live.find(pos)]; }
+
+    template<class F>
+    void forEach(F f) {
+        for (auto &item : slots) {
+            if (item) f(*item);
+        }
+    }
+
+    void push_back(Slot &&item) {
+        slots.emplace_back(std::move(item));
+        live.push_back();
+    }
+
+    void erase(std::size_t pos) {
+        auto slot = live.find(pos);
+        slots[slot].reset();
+        live.erase(slot);
+        if (live.sparse()) compact();
+    }
+};
+
+// The posts of a tag, in the order they were made, for search. A post keeps
+// its slot here to be removed by, and a removed post leaves a tombstone, so
+// that the slots of the others stay put until compact() moves them all.
+class Postings {
+private:
+    std::vector<Post *> posts;                  // nullptr once removed
+    LiveSlots live;
+
+public:
+    [[nodiscard]] std::size_t size() const { return live.size(); }
+
+    // returns the slot of post
+    std::size_t add(Post *post) {
+        posts.emplace_back(post);
+        live.push_back();
+        return posts.size() - 1;
+    }
+
+    void remove(std::size_t slot) {
+        posts[slot] = nullptr;
+        live.erase(slot);
+    }
+
+    [[nodiscard]] bool sparse() const { return live.sparse(); }
+
+    // holds order instead, calling moved(post, slot) with the slot of each
+    template<class F>
+    void assign(const std::vector<Post *> &order, F moved) {
+        posts.clear();
+        live.clear();
+        for (auto post : order) moved(post, add(post));
+    }
+
+    // drops the tombstones, calling moved(post, slot) with the new slot of
+    // each post
+    template<class F>
+    void compact(F moved) {
+        std::vector<Post *> kept;
+        kept.reserve(live.size());
+        for (auto post : posts) {
+            if (post) kept.emplace_back(post);
+        }
+        assign(kept, moved);
+    }
+
+    // calls f with the posts at positions [first, first + n), as many as
+    // there are, in O(log size + n) once the tombstones are few
+    template<class F>
+    void forRange(std::size_t first, std::size_t n, F f) const {
+        if (first >= live.size()) return;
+        for (auto slot = live.find(first); slot < posts.size() && n > 0; slot++) {
+            if (posts[slot]) {
+                f(posts[slot]);
+                --n;
+            }
+        }
+    }
+};
 
 class User {
 private:
     std::string name;
+    std::size_t id;
 
-    std::map<User *, std::size_t> mapFollowingId;  // find following quickly
-    std::map<std::size_t, User *> mapIdFollowing;  // save the order of following
-    std::size_t maxFollowingId = 0;
+    FollowGraph *graph;             // the following and followers of every user
 
-    std::map<User *, std::size_t> mapFollowersId;  // find follower quickly
-    std::map<std::size_t, User *> mapIdFollowers;  // save the order of follower
-    std::size_t maxFollowerId = 0;
+    StringShard *strings;           // keeps the titles, texts and comments of the posts
 
-    std::vector<std::unique_ptr<Post> > posts;
+    StableList<Post> posts;
+
+    Printer::Block postsBlock;          // the posts as printed by refresh, nullptr once changed
 
 public:
-    explicit User(std::string name) : name(std::move(name)) {}
+    User(std::string name, std::size_t id, FollowGraph *graph, StringShard *strings) :
+            name(std::move(name)), id(id), graph(graph), strings(strings) {
+        strings->addUser(this);
+    }
 
     [[nodiscard]] const auto &getName() const { return name; }
 
+    [[nodiscard]] std::size_t getId() const { return id; }
+
+    [[nodiscard]] const auto &getPosts() const { return posts; }
+
+    template<class F>
+    void forEachFollowing(F f) const { graph->following.forEach(id, f); }
+
+    template<class F>
+    void forEachFollower(F f) const { graph->followers.forEach(id, f); }
+
     void addFollowing(User *user);
 
     void addFollower(User *user);
@@ -229,13 +945,13 @@ public:
 
     void removeFollower(User *user);
 
-    [[nodiscard]] std::size_t getFollowingCount() const { return mapFollowingId.size(); };
+    [[nodiscard]] std::size_t getFollowingCount() const { return graph->following.count(id); };
 
-    [[nodiscard]] std::size_t getFollowersCount() const { return mapFollowersId.size(); };
+    [[nodiscard]] std::size_t getFollowersCount() const { return graph->followers.count(id); };
 
-    bool isFollowing(User *user) const { return mapFollowingId.find(user) != mapFollowingId.end(); };
+    bool isFollowing(User *user) const { return graph->following.test(id, user); };
 
-    bool isFollower(User *user) const { return mapFollowersId.find(user) != mapFollowersId.end(); };
+    bool isFollower(User *user) const { return graph->followers.test(id, user); };
 
     void addPost(std::unique_ptr<Post> &&post);
 
@@ -249,32 +965,69 @@ public:
 
     void unCommentPost(User *user, std::size_t postId, std::size_t commentId);
 
-    void printPosts();
+    void invalidatePosts() { postsBlock.reset(); }
+
+    std::string_view store(std::string_view str) { return strings->store(str); }
+
+    // the strings of this many bytes are no longer used
+    void releaseStrings(std::size_t bytes) { strings->release(bytes); }
+
+    void moveStrings(StringArena &arena);
+
+    const Printer::Block &renderPosts();
 
-    void refresh();
+    void printPosts(Printer &out);
 
-    void visit(User *user);
+    // returns the number of posts printed
+    std::size_t refresh(Printer &out);
+
+    void visit(User *user, Printer &out);
 };
 
 
-class Post {
+// A post comes from the resource given to alloc::Allocated<Post>::setResource()
+class Post : public alloc::Allocated<Post> {
 private:
-    std::vector<std::unique_ptr<Comment> > comments;
-    std::set<User *> likes;
+    StableList<Comment, std::optional<Comment> > comments;
+    UserSet likes;
 
     User *owner;
-    std::string title;
-    std::string text;
+    std::string_view title;         // in the strings of the owner
+    std::string_view text;
     std::vector<Tag *> tags;
+    std::vector<std::size_t> postings;  // the slot of the post in the postings of each tag, or
+                                        // of the first of the equal tags
+
+    Printer::Block block;               // the post as printed by operator<<, nullptr once changed
+
+    void invalidate();
 
 public:
-    Post(User *owner, std::string title, std::string text, std::vector<Tag *> &&tags);
+    Post(User *owner, std::string_view title, std::string_view text, std::vector<Tag *> &&tags);
 
     ~Post();
 
     friend std::ostream &operator<<(std::ostream &os, const Post &post);
 
-    [[nodiscard]] const auto &getTitle() const { return title; };
+    [[nodiscard]] std::string_view getTitle() const { return title; };
+
+    [[nodiscard]] std::string_view getText() const { return text; };
+
+    [[nodiscard]] const auto &getTags() const { return tags; };
+
+    [[nodiscard]] const auto &getLikes() const { return likes; };
+
+    [[nodiscard]] const auto &getComments() const { return comments; };
+
+    const Printer::Block &render();
+
+    // the postings of tag have moved the post to slot
+    void movePosting(const Tag *tag, std::size_t slot);
+
+    // the bytes of the strings of the post, in the strings of the owner
+    [[nodiscard]] std::size_t stringBytes() const;
+
+    void moveStrings(StringArena &arena);
 
     void addLike(User *user, std::size_t postId);
 
@@ -289,13 +1042,15 @@ public:
 class Comment {
 private:
     User *user;
-    std::string text;
+    std::string_view text;          // in the strings of the owner of the post
 public:
-    Comment(User *user, std::string text) : user(user), text(std::move(text)) {};
+    Comment(User *user, std::string_view text) : user(user), text(text) {};
 
     [[nodiscard]] auto getUser() const { return user; };
 
-    [[nodiscard]] const auto &getText() const { return text; };
+    [[nodiscard]] std::string_view getText() const { return text; };
+
+    void moveText(StringArena &arena) { text = arena.store(text); }
 };
 
 class Tag {
@@ -305,8 +1060,44 @@ private:
     std::size_t numLikes = 0;
     std::size_t numComments = 0;
     std::size_t score = 0;
+    Postings posts;
+
+    TagIndex *index;                            // the index that ranks this tag
+    decltype(TagIndex::ranked)::iterator rank;  // the position of this tag in the index
+    bool dirty = false;                         // the counts changed since the score
+
+    struct Bucket {
+        std::size_t number;
+        std::ptrdiff_t change;                  // of the score in the bucket
+    };
+    std::vector<Bucket> buckets;                // a ring of WINDOW_BUCKETS, with a window
+
+    // the score changed by change
+    void touch(std::ptrdiff_t change) {
+        if (index->bucketEntries && change != 0) {
+            if (buckets.empty()) buckets.assign(WINDOW_BUCKETS, Bucket{std::size_t(-1), 0});
+            auto slot = index->bucket % WINDOW_BUCKETS;
+            if (buckets[slot].number != index->bucket) {
+                buckets[slot] = Bucket{index->bucket, 0};
+                index->touched[slot].emplace_back(this);
+            }
+            buckets[slot].change += change;
+        }
+        markDirty();
+    }
+
+    [[nodiscard]] std::size_t windowScore() const {
+        std::ptrdiff_t sum = 0;
+        for (const auto &b : buckets) {
+            if (b.number <= index->bucket && index->bucket - b.number < WINDOW_BUCKETS) sum += b.change;
+        }
+        return sum > 0 ? std::size_t(sum) : 0;
+    }
+
 public:
-    explicit Tag(std::string content) : content(std::move(content)) {};
+    Tag(std::string content, TagIndex *index) : content(std::move(content)), index(index) {
+        rank = index->ranked.insert(this).first;
+    };
 
     friend std::ostream &operator<<(std::ostream &os, const Tag &tag);
 
@@ -314,28 +1105,103 @@ public:
 
     [[nodiscard]] std::size_t getScore() const { return score; }
 
-    void addPost() { ++numPosts; }
+    [[nodiscard]] const auto &getPosts() const { return posts; }
+
+    // returns the slot of post in the postings of the tag
+    std::size_t indexPost(Post *post) { return posts.add(post); }
 
-    void addLike() { ++numLikes; }
+    void unindexPost(std::size_t slot);
 
-    void addComment() { ++numComments; }
+    // orders the postings as order, which must hold each post of the tag once
+    bool reorderPosts(const std::vector<Post *> &order);
+
+    void addPost() {
+        ++numPosts;
+        touch(5);
+    }
+
+    void addLike() {
+        ++numLikes;
+        touch(1);
+    }
+
+    void addComment() {
+        ++numComments;
+        touch(3);
+    }
 
     void removePost() {
         assert(numPosts >= 1);
         numPosts -= 1;
+        touch(-5);
     }
 
     void removeLike(std::size_t n = 1) {
         assert(numLikes >= n);
         numLikes -= n;
+        touch(-std::ptrdiff_t(n));
     }
 
     void removeComment(std::size_t n = 1) {
         assert(numComments >= n);
         numComments -= n;
+        touch(-3 * std::ptrdiff_t(n));
+    }
+
+    // the score is to be computed again, before ranked is next read
+    void markDirty() {
+        if (!dirty) {
+            dirty = true;
+            index->dirty.emplace_back(this);
+        }
     }
 
-    std::size_t calculateScore() { return score = 5 * numPosts + 3 * numComments + numLikes; };
+    std::size_t calculateScore() {
+        dirty = false;
+        // a score of a window that shrank over it is 0, as if the tag were not used
+        auto newScore = index->bucketEntries ? windowScore() : 5 * numPosts + 3 * numComments + numLikes;
+        if (newScore != score) {
+            // the index is keyed on the score, so move the tag to its new rank
+            auto hint = index->ranked.erase(rank);
+            score = newScore;
+            rank = index->ranked.insert(hint, this);
+        }
+        return score;
+    };
 };
 
+inline bool TagRank::operator()(const Tag *a, const Tag *b) const {
+    if (a->getScore() != b->getScore()) return a->getScore() > b->getScore();
+    return a->getContent() < b->getContent();
+}
+
+inline void TagIndex::update() {
+    for (auto tag : dirty) {
+        tag->calculateScore();
+    }
+    dirty.clear();
+}
+
+inline void TagIndex::setWindow(std::size_t entries) {
+    // the window is WINDOW_BUCKETS buckets, of which the last is filling
+    bucketEntries = std::max<std::size_t>(1, (entries + WINDOW_BUCKETS - 1) / WINDOW_BUCKETS);
+    bucket = 0;
+    touched.assign(WINDOW_BUCKETS, {});
+    for (auto tag : ranked) {
+        tag->markDirty();
+    }
+}
+
+inline void TagIndex::advance(std::size_t seq) {
+    if (bucketEntries == 0) return;
+    while (bucket < seq / bucketEntries) {
+        // the bucket that leaves the window takes the slot of the next
+        auto &expired = touched[++bucket % WINDOW_BUCKETS];
+        for (auto tag : expired) {
+            tag->markDirty();
+        }
+        expired.clear();
+    }
+}
+
 #endif // SERVER_TYPE_H
@@ -7,14 +7,250 @@
 
 #include "server_type.h"
 #include "simulation.h"
+#include "../../../bench/tracing.h"
 
 #include <fstream>
 #include <iostream>
 #include <algorithm>
+#include <sstream>
 #include <unordered_set>
+#include <atomic>
+#include <cerrno>
+#include <thread>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <chrono>
+#include <iomanip>
+#include <functional>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
 
 std::unique_ptr<Server> Server::instance = nullptr;
 
+Limits Server::limits;
+
+// Reads a log in large blocks and hands out its lines in place, as getline
+// would split them; a line is only valid until the next one is read
+//
+// A log that is followed is read on past its end as it grows: the reader
+// waits for the file to change, through inotify, or by looking again every
+// FOLLOW_POLL milliseconds where there is none. A partial line at the end
+// stays in the buffer until the rest of it is appended, so nothing is read
+// twice. Following ends when stopFollowing() is called, or once the log has
+// not grown for idleTimeout milliseconds, if that is not 0; the log then
+// ends as a file does.
+class LogReader {
+private:
+    static constexpr int FOLLOW_POLL = 100;
+
+    int fd;
+    std::vector<char> buffer;
+    std::size_t begin = 0;
+    std::size_t end = 0;
+    bool eof = false;
+    int notify = -1;                    // the inotify watch of a followed log, once made
+    std::string path;
+
+    static std::atomic<bool> stopping;
+
+    // waits for the log to grow, and returns false once following ends
+    bool wait(std::chrono::steady_clock::time_point idleSince) {
+        if (stopping) return false;
+        if (idleTimeout != 0 && std::chrono::steady_clock::now() - idleSince >=
+                                std::chrono::milliseconds(idleTimeout)) {
+            return false;
+        }
+        if (notify < 0) {
+            notify = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+            if (notify >= 0 && ::inotify_add_watch(notify, path.c_str(), IN_MODIFY | IN_CLOSE_WRITE) < 0) {
+                ::close(notify);
+                notify = -2;
+            }
+        }
+        struct pollfd watch{notify, POLLIN, 0};
+        ::poll(&watch, notify >= 0 ? 1 : 0, FOLLOW_POLL);
+        if (notify >= 0 && (watch.revents & POLLIN)) {
+            char events[4096];
+            while (::read(notify, events, sizeof(events)) > 0) {}
+        }
+        return !stopping;
+    }
+
+public:
+    std::string *record = nullptr;      // appended every line read, if set
+    bool follow = false;
+    std::size_t idleTimeout = 0;        // in milliseconds, 0 to follow until stopped
+    std::function<void()> idle;         // called when a followed log is read to its end
+
+    explicit LogReader(const std::string &fileName) :
+            fd(::open(fileName.c_str(), O_RDONLY | O_CLOEXEC)), buffer(1 << 20), path(fileName) {}
+
+    LogReader(const LogReader &) = delete;
+
+    LogReader &operator=(const LogReader &) = delete;
+
+    ~LogReader() {
+        if (fd >= 0) ::close(fd);
+        if (notify >= 0) ::close(notify);
+    }
+
+    [[nodiscard]] bool isOpen() const { return fd >= 0; }
+
+    // safe to call from a signal handler
+    static void stopFollowing() { stopping = true; }
+
+    bool nextLine(std::string_view &line) {
+        auto idleSince = std::chrono::steady_clock::now();
+        while (true) {
+            auto first = buffer.data() + begin;
+            auto newline = static_cast<char *>(std::memchr(first, '\n', end - begin));
+            if (newline) {
+                line = std::string_view(first, std::size_t(newline - first));
+                begin += line.size() + 1;
+                if (record) record->append(first, line.size() + 1);
+                return true;
+            }
+            if (eof) {
+                if (begin == end) return false;
+                line = std::string_view(first, end - begin);
+                begin = end;
+                if (record) record->append(line).push_back('\n');
+                return true;
+            }
+            // keep the partial line at the front, and make room for a longer one
+            std::memmove(buffer.data(), first, end - begin);
+            end -= begin;
+            begin = 0;
+            if (end == buffer.size()) buffer.resize(buffer.size() * 2);
+            auto size = ::read(fd, buffer.data() + end, buffer.size() - end);
+            if (size > 0) {
+                end += std::size_t(size);
+                idleSince = std::chrono::steady_clock::now();
+            } else if (size < 0 && errno == EINTR) {
+                continue;
+            } else if (follow) {
+                if (idle) idle();
+                eof = !wait(idleSince);
+            } else {
+                eof = true;
+            }
+        }
+    }
+
+    bool nextLine(std::string &line) {
+        std::string_view view;
+        if (!nextLine(view)) return false;
+        line.assign(view);
+        return true;
+    }
+};
+
+std::atomic<bool> LogReader::stopping{false};
+
+// Splits a line of the log at white space, as operator>> would, and reads
+// numbers as operator>> does, 0 from the first one that is not a number on
+class LogLine {
+private:
+    std::string_view rest;
+    bool failed = false;
+
+    static bool isSpace(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f' || c == '\n'; }
+
+public:
+    explicit LogLine(std::string_view line) : rest(line) {}
+
+    std::string_view nextToken() {
+        std::size_t i = 0;
+        while (i < rest.size() && isSpace(rest[i])) i++;
+        std::size_t j = i;
+        while (j < rest.size() && !isSpace(rest[j])) j++;
+        auto token = rest.substr(i, j - i);
+        rest.remove_prefix(j);
+        return token;
+    }
+
+    std::size_t nextNumber() {
+        auto token = nextToken();
+        if (failed) return 0;
+        std::string digits(token);
+        char *end;
+        auto n = std::strtoull(digits.c_str(), &end, 10);
+        failed = end == digits.c_str();
+        return failed ? 0 : std::size_t(n);
+    }
+};
+
+// Counts values, as nanoseconds or posts, the way HDR histograms do: values
+// below 64 are kept exactly, and each power of two above is split into 32
+// buckets, so that a value is known to within 1/32 of itself
+class Histogram {
+private:
+    std::vector<std::uint64_t> buckets = std::vector<std::uint64_t>(64 + 58 * 32, 0);
+    std::uint64_t total = 0;
+    std::uint64_t maximum = 0;
+
+    static std::size_t bucket(std::uint64_t value) {
+        if (value < 64) return value;
+        unsigned int e = 63 - __builtin_clzll(value);
+        return 64 + (e - 6) * 32 + ((value >> (e - 5)) - 32);
+    }
+
+    // the highest value that falls into the bucket
+    static std::uint64_t highest(std::size_t bucket) {
+        if (bucket < 64) return bucket;
+        unsigned int e = (bucket - 64) / 32 + 6;
+        std::uint64_t top = (bucket - 64) % 32 + 32;
+        return ((top + 1) << (e - 5)) - 1;
+    }
+
+public:
+    void record(std::uint64_t value) {
+        ++buckets[bucket(value)];
+        ++total;
+        maximum = std::max(maximum, value);
+    }
+
+    [[nodiscard]] std::uint64_t count() const { return total; }
+
+    [[nodiscard]] std::uint64_t max() const { return maximum; }
+
+    [[nodiscard]] std::uint64_t percentile(double q) const {
+        auto rank = std::max<std::uint64_t>(1, (std::uint64_t) std::ceil(q * (double) total));
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < buckets.size(); i++) {
+            seen += buckets[i];
+            if (seen >= rank) return std::min(highest(i), maximum);
+        }
+        return maximum;
+    }
+};
+
+// What --stats records of a log: the latency of each operation, from its
+// entry being applied to its output being queued, and the posts of each refresh
+class OperationStats {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    Histogram latency[static_cast<std::size_t>(Operation::SEARCH) + 1];
+    std::uint64_t totalTime[static_cast<std::size_t>(Operation::SEARCH) + 1] = {};
+    Histogram refreshPosts;
+
+    void record(Operation operation, Clock::duration duration) {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+        latency[static_cast<std::size_t>(operation)].record(ns);
+        totalTime[static_cast<std::size_t>(operation)] += ns;
+    }
+};
+
+// The trace event of each operation, indexed by Operation
+static const char *const traceNames[] = {
+        "follow", "unfollow", "like", "unlike", "comment", "uncomment",
+        "post", "delete", "refresh", "visit", "trending", "search",
+};
+
 const std::unordered_map<std::string, Operation> Server::operations = {
         {"follow",    Operation::FOLLOW},
         {"unfollow",  Operation::UNFOLLOW},
@@ -27,6 +263,7 @@ const std::unordered_map<std::string, Operation> Server::operations = {
         {"refresh",   Operation::REFRESH},
         {"visit",     Operation::VISIT},
         {"trending",  Operation::TRENDING},
+        {"search",    Operation::SEARCH},
 };
 
 Server::~Server() {
@@ -43,24 +280,33 @@ Server &Server::getInstance() {
 }
 
 User *Server::getUser(const std::string &userName) {
-    auto it = users.find(userName);
-    if (it != users.end()) {
-        return it->second.get();
+    auto it = userIds.find(userName);
+    if (it != userIds.end()) {
+        return users[it->second].get();
     }
     throw UserNotFoundException(userName);
 }
 
 Tag *Server::getTag(const std::string &tagContent) {
-    auto it = tags.find(tagContent);
-    if (it == tags.end()) {
-        auto tag = std::make_unique<Tag>(tagContent);
-        orderedTags.emplace_back(tag.get());
-        it = tags.emplace_hint(it, tagContent, std::move(tag));
+    auto it = tagIds.find(tagContent);
+    if (it == tagIds.end()) {
+        it = tagIds.emplace_hint(it, tagContent, tags.size());
+        tags.emplace_back(std::make_unique<Tag>(tagContent, &rankedTags));
+    }
+    return tags[it->second].get();
+}
+
+void Server::readUser(User *user, const std::filesystem::path &userPath, UserRecord &record) {
+    // runs on a loader thread: only reads files and looks up users, and keeps
+    // the error to be thrown where the merge reaches it
+    try {
+        readUserFiles(user, userPath, record);
+    } catch (...) {
+        record.error = std::current_exception();
     }
-    return it->second.get();
 }
 
-void Server::initUser(User *user, const std::filesystem::path &userPath) {
+void Server::readUserFiles(User *user, const std::filesystem::path &userPath, UserRecord &record) {
     auto userInfoPath = userPath / "user_info";
     std::fstream fin(userInfoPath.string());
     if (!fin.is_open()) {
@@ -71,66 +317,37 @@ void Server::initUser(User *user, const std::filesystem::path &userPath) {
 
     std::getline(fin, line);
     std::size_t numPosts = std::strtoul(line.c_str(), nullptr, 10);
-    if (numPosts > MAX_POSTS) {
+    if (numPosts > limits.posts) {
         throw TooManyPostsException(user->getName());
     }
     for (unsigned int i = 0; i < numPosts; i++) {
-        initPost(user, userPath, i);
+        readPostFile(userPath, i, record);
     }
 
     std::getline(fin, line);
     std::size_t numFollowing = std::strtoul(line.c_str(), nullptr, 10);
-    if (numFollowing > MAX_FOLLOWING) {
+    if (numFollowing > limits.following) {
         throw TooManyFollowingsException(user->getName());
     }
     for (unsigned int i = 0; i < numFollowing; i++) {
         std::getline(fin, line);
-        auto user2 = getUser(line);
-        user->addFollowing(user2);
+        record.following.emplace_back(getUser(line));
     }
 
     std::getline(fin, line);
     std::size_t numFollowers = std::strtoul(line.c_str(), nullptr, 10);
-    if (numFollowers > MAX_FOLLOWERS) {
+    if (numFollowers > limits.followers) {
         throw TooManyFollowersException(user->getName());
     }
     for (unsigned int i = 0; i < numFollowers; i++) {
         std::getline(fin, line);
-        auto user2 = getUser(line);
-        user->addFollower(user2);
+        record.followers.emplace_back(getUser(line));
     }
 
     fin.close();
 }
 
-std::unique_ptr<Post> Server::readPost(std::istream &is, User *user) {
-    std::string text, title;
-    std::vector<Tag *> postTags;
-    std::unordered_set<Tag *> set;
-
-    std::getline(is, title);
-    while (std::getline(is, text)) {
-        if (text.length() >= 2 && text.front() == '#' && text.back() == '#') {
-            auto tagContent = text.substr(1, text.length() - 2);
-            auto tag = getTag(tagContent);
-            auto it = set.find(tag);
-            if (it == set.end()) {
-                set.emplace(tag);
-                postTags.emplace_back(tag);
-            }
-        } else {
-            break;
-        }
-    }
-
-    if (postTags.size() > MAX_TAGS) {
-        throw TooManyTagsException(title);
-    }
-
-    return std::make_unique<Post>(user, title, text, std::move(postTags));
-}
-
-void Server::initPost(User *user, const std::filesystem::path &userPath, std::size_t postId) {
+void Server::readPostFile(const std::filesystem::path &userPath, std::size_t postId, UserRecord &record) {
     auto postPath = userPath / "posts" / std::to_string(postId + 1);
     std::fstream fin(postPath.string());
     if (!fin.is_open()) {
@@ -138,39 +355,121 @@ void Server::initPost(User *user, const std::filesystem::path &userPath, std::si
     }
 
     std::string userName;
-    auto post = readPost(fin, user);
+    PostRecord post;
+    readPost([&fin](std::string &line) { return bool(std::getline(fin, line)); }, post);
 
     std::string line;
     std::getline(fin, line);
     std::size_t numLikes = std::strtoul(line.c_str(), nullptr, 10);
-    if (numLikes > MAX_LIKES) {
-        throw TooManyLikesException(post->getTitle());
+    if (numLikes > limits.likes) {
+        throw TooManyLikesException(post.title);
     }
     for (unsigned int i = 0; i < numLikes; i++) {
         std::getline(fin, userName);
-        auto user2 = getUser(userName);
-        post->addLike(user2, postId);
+        post.likes.emplace_back(getUser(userName));
     }
 
     std::getline(fin, line);
     std::size_t numComments = std::strtoul(line.c_str(), nullptr, 10);
-    if (numComments > MAX_COMMENTS) {
-        throw TooManyCommentsException(post->getTitle());
+    if (numComments > limits.comments) {
+        throw TooManyCommentsException(post.title);
     }
     for (unsigned int i = 0; i < numComments; i++) {
         std::getline(fin, userName);
         auto user2 = getUser(userName);
         std::getline(fin, line);
-        post->addComment(user2, line);
+        post.comments.emplace_back(user2, line);
     }
 
-    user->addPost(std::move(post));
+    record.posts.emplace_back(std::move(post));
 
     fin.close();
 }
 
+void Server::initUser(User *user, UserRecord &record) {
+    // the merge: builds what was read in the order it was read, so that it
+    // throws the same error as reading the user alone would have
+    for (std::size_t postId = 0; postId < record.posts.size(); postId++) {
+        auto &postRecord = record.posts[postId];
+        auto post = makePost(user, postRecord);
+        for (auto user2 : postRecord.likes) {
+            post->addLike(user2, postId);
+        }
+        for (auto &comment : postRecord.comments) {
+            post->addComment(comment.first, comment.second);
+        }
+        user->addPost(std::move(post));
+    }
+    for (auto user2 : record.following) {
+        user->addFollowing(user2);
+    }
+    for (auto user2 : record.followers) {
+        user->addFollower(user2);
+    }
+    if (record.error) {
+        std::rethrow_exception(record.error);
+    }
+}
+
+template<class NextLine>
+void Server::readPost(NextLine nextLine, PostRecord &record) {
+    std::unordered_set<std::string> set;
+
+    nextLine(record.title);
+    while (nextLine(record.text)) {
+        auto &text = record.text;
+        if (text.length() >= 2 && text.front() == '#' && text.back() == '#') {
+            auto tagContent = text.substr(1, text.length() - 2);
+            if (set.emplace(tagContent).second) {
+                record.tags.emplace_back(std::move(tagContent));
+            }
+        } else {
+            break;
+        }
+    }
+
+    if (record.tags.size() > limits.tags) {
+        throw TooManyTagsException(record.title);
+    }
+}
+
+std::unique_ptr<Post> Server::makePost(User *user, PostRecord &record) {
+    std::vector<Tag *> postTags;
+    for (const auto &tagContent : record.tags) {
+        postTags.emplace_back(getTag(tagContent));
+    }
+    return std::make_unique<Post>(user, record.title, record.text, std::move(postTags));
+}
+
+static unsigned int hashOperation(std::string_view op) {
+    return (unsigned char) op[op.size() - 1] + (unsigned char) op[1] + op.size();
+}
+
+bool Server::findOperation(std::string_view op, Operation &operation) {
+    // the last and the second characters and the length are a perfect hash
+    // of the operations modulo 32; the name found is still compared
+    static const auto table = []() {
+        std::vector<const std::pair<const std::string, Operation> *> table(32, nullptr);
+        for (const auto &p : operations) {
+            auto &slot = table[hashOperation(p.first) % 32];
+            assert(slot == nullptr);
+            slot = &p;
+        }
+        return table;
+    }();
+    if (op.size() < 2) return false;
+    auto p = table[hashOperation(op) % 32];
+    if (p == nullptr || p->first != op) return false;
+    operation = p->second;
+    return true;
+}
+
 
 void Server::initUsers(const std::string &fileName) {
+    if (isDataset(fileName)) {
+        loadDataset(fileName);
+        return;
+    }
     std::fstream fin(fileName);
     if (!fin.is_open()) {
         throw FileMissingException(fileName);
@@ -180,115 +479,385 @@ void Server::initUsers(const std::string &fileName) {
     std::filesystem::path usersPath(usersDirectory);
 
     std::string userName;
+    std::vector<std::string> userNames;
     while (std::getline(fin, userName)) {
         if (userName.empty()) continue;
-        auto user = std::make_unique<User>(userName);
-        users.emplace(userName, std::move(user));
+        if (userIds.emplace(userName, userNames.size()).second) {
+            userNames.emplace_back(userName);
+        }
     }
-    if (users.size() > MAX_USERS) {
+    if (userNames.size() > limits.users) {
         throw TooManyUsersException();
     }
-    for (auto &p : users) {
-        const auto &name = p.second->getName();
-        auto userPath = usersPath / name;
-        initUser(p.second.get(), userPath);
+    // create every user before any is read, so that they can refer to each other
+    for (std::size_t i = 0; i < userNames.size(); i++) {
+        users.emplace_back(std::make_unique<User>(userNames[i], i, &graph, &stringShards[i % stringShards.size()]));
     }
+
+    // the files of the users are read by several threads, each user into its
+    // own record, and then merged here one user after another
+    std::vector<UserRecord> records(users.size());
+    std::atomic<std::size_t> next(0);
+    auto loader = [&]() {
+        for (std::size_t i; (i = next.fetch_add(1)) < users.size();) {
+            readUser(users[i].get(), usersPath / users[i]->getName(), records[i]);
+        }
+    };
+    std::size_t numThreads = std::min<std::size_t>(std::max(1u, std::thread::hardware_concurrency()),
+                                                   users.size());
+    std::vector<std::thread> threads;
+    for (std::size_t i = 1; i < numThreads; i++) {
+        threads.emplace_back(loader);
+    }
+    loader();
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    for (std::size_t i = 0; i < users.size(); i++) {
+        initUser(users[i].get(), records[i]);
+        records[i] = UserRecord();
+    }
+    // the log starts from a snapshot without a delta
+    graph.following.compact();
+    graph.followers.compact();
     fin.close();
 }
 
 
+// Passes batches from one thread to another in order; the sender waits only
+// when limit batches are queued
+template<class T>
+class BatchQueue {
+private:
+    std::deque<std::vector<T> > batches;
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::size_t limit;
+    bool closed = false;
+
+public:
+    explicit BatchQueue(std::size_t limit) : limit(limit) {}
+
+    void push(std::vector<T> &&batch) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            changed.wait(lock, [this] { return batches.size() < limit; });
+            batches.emplace_back(std::move(batch));
+        }
+        changed.notify_all();
+    }
+
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            closed = true;
+        }
+        changed.notify_all();
+    }
+
+    // false once the queue is closed and empty
+    bool pop(std::vector<T> &batch) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            changed.wait(lock, [this] { return closed || !batches.empty(); });
+            if (batches.empty()) return false;
+            batch = std::move(batches.front());
+            batches.pop_front();
+        }
+        changed.notify_all();
+        return true;
+    }
+};
+
 void Server::readLog(const std::string &fileName) {
-    std::fstream fin(fileName);
-    if (!fin.is_open()) {
+    TRACE_SCOPE("readLog");
+    LogReader log(fileName);
+    if (!log.isOpen()) {
         throw FileMissingException(fileName);
     }
-    std::string line;
-    std::istringstream iss;
-    while (std::getline(fin, line)) {
-        if (line.empty()) continue;
-
-        iss.clear();
-        iss.str(line);
-        std::string u1, op, u2, text;
-        std::size_t postId, commentId;
-        iss >> u1;
-
-        if (u1 == "trending") {
-            // test whether "trending" is username
-            std::string temp;
-            iss >> temp;
-            if (operations.find(temp) == operations.end()) {
-                // "trending" is not username, reset the iss
-                iss.clear();
-                iss.str(line);
-                iss >> op;
-            } else {
-                // "trending" is username, so temp is op
-                op = std::move(temp);
+    {
+        Printer out(*output);
+        if (std::thread::hardware_concurrency() <= 1) {
+            // with a single core, each line is applied as it is read
+            LogEntry entry;
+            while (readEntry(log, entry)) {
+                applyEntry(entry, out);
+            }
+        } else {
+            replayLog(log, out);
+        }
+    }
+    endLog();
+}
+
+void Server::followLog(const std::string &fileName, std::size_t idleTimeout) {
+    TRACE_SCOPE("followLog");
+    LogReader log(fileName);
+    if (!log.isOpen()) {
+        throw FileMissingException(fileName);
+    }
+    log.follow = true;
+    log.idleTimeout = idleTimeout;
+    {
+        // each entry is applied as soon as it is read, and what the entries
+        // printed is written out whenever the reader has caught up with the
+        // log, so that it is seen before the reader waits
+        Printer out(*output);
+        log.idle = [this, &out]() {
+            out.flush();
+            if (checkpoint && checkpoint->isOpen()) checkpoint->flush();
+        };
+        LogEntry entry;
+        while (readEntry(log, entry)) {
+            applyEntry(entry, out);
+        }
+    }
+    endLog();
+}
+
+void Server::stopFollowing() {
+    LogReader::stopFollowing();
+}
+
+void Server::endLog() {
+    if (!output->good()) {
+        throw OutputFailedException();
+    }
+    if (checkpoint && checkpoint->isOpen()) checkpoint->flush();
+    if (checkpoint && !checkpoint->good()) {
+        throw CheckpointFailedException(checkpoint->log().string());
+    }
+}
+
+void Server::restore(const std::string &fileName) {
+    TRACE_SCOPE("restore");
+    auto snapshot = checkpoint->snapshot();
+    initUsers(snapshot.empty() ? fileName : snapshot.string());
+    std::size_t count = 0;
+    LogReader log(checkpoint->log().string());
+    if (log.isOpen()) {
+        DiscardSink discard;
+        Printer out(discard);
+        LogEntry entry;
+        while (readEntry(log, entry)) {
+            applyEntry(entry, out);
+            ++count;
+        }
+    }
+    checkpoint->resume(count);
+}
+
+void Server::replayLog(LogReader &log, Printer &out) {
+    // a reader thread splits the log, and passes the entries here in batches
+    // in the order of the log; refresh and trending read the whole server,
+    // so the entries are applied by this thread alone
+    BatchQueue<LogEntry> queue(16);
+    std::thread reader([this, &log, &queue]() {
+        TRACE_SCOPE("readEntry");
+        std::vector<LogEntry> batch(1);
+        while (readEntry(log, batch.back())) {
+            if (batch.size() == 1024) {
+                queue.push(std::move(batch));
+                batch = std::vector<LogEntry>();
             }
+            batch.emplace_back();
+        }
+        batch.pop_back();
+        queue.push(std::move(batch));
+        queue.close();
+    });
+    std::vector<LogEntry> batch;
+    while (queue.pop(batch)) {
+        for (auto &entry : batch) {
+            applyEntry(entry, out);
+        }
+    }
+    reader.join();
+}
+
+bool Server::readEntry(LogReader &log, LogEntry &entry) {
+    // only looks the users up, which the log does not change, so that it can
+    // run ahead of applyEntry on another thread
+    std::string_view line;
+    log.record = checkpoint ? &entry.lines : nullptr;
+    do {
+        if (!log.nextLine(line)) return false;
+    } while (line.empty());
+
+    LogLine tokens(line);
+    std::string_view u1 = tokens.nextToken(), op;
+    Operation operation;
+
+    if (u1 == "trending") {
+        // test whether "trending" is username
+        auto temp = tokens.nextToken();
+        if (!findOperation(temp, operation)) {
+            // "trending" is not username, read the arguments from temp on
+            tokens = LogLine(line);
+            op = tokens.nextToken();
         } else {
-            iss >> op;
+            // "trending" is username, so temp is op
+            op = temp;
         }
+    } else {
+        op = tokens.nextToken();
+    }
 
+    // the line is only valid until the next is read, so keep the names
+    entry.user1 = u1;
+    entry.op = op;
+    entry.defined = findOperation(op, entry.operation);
+    if (!entry.defined) return true;
+    switch (entry.operation) {
+        case Operation::FOLLOW:
+        case Operation::UNFOLLOW:
+        case Operation::VISIT:
+            entry.user2 = tokens.nextToken();
+            break;
+        case Operation::LIKE:
+        case Operation::UNLIKE:
+            entry.user2 = tokens.nextToken();
+            entry.postId = tokens.nextNumber();
+            break;
+        case Operation::COMMENT:
+            entry.user2 = tokens.nextToken();
+            entry.postId = tokens.nextNumber();
+            log.nextLine(entry.text);
+            break;
+        case Operation::UNCOMMENT:
+            entry.user2 = tokens.nextToken();
+            entry.postId = tokens.nextNumber();
+            entry.commentId = tokens.nextNumber();
+            break;
+        case Operation::POST:
+            // the post is only read when its user exists
+            if (userIds.count(entry.user1) != 0) {
+                try {
+                    readPost([&log](std::string &line) { return log.nextLine(line); }, entry.post);
+                } catch (SimpleTwitterException &) {
+                    entry.error = std::current_exception();
+                }
+            }
+            break;
+        case Operation::DELETE:
+            entry.postId = tokens.nextNumber();
+            break;
+        case Operation::REFRESH:
+            break;
+        case Operation::TRENDING:
+            entry.count = tokens.nextNumber();
+            break;
+        case Operation::SEARCH:
+            entry.text = tokens.nextToken();
+            entry.count = tokens.nextNumber();
+            break;
+    }
+    return true;
+}
 
-        try {
-            auto it = operations.find(op);
-            if (it == operations.end()) {
-                throw InvalidOperationException(op);
+void Server::applyEntry(LogEntry &entry, Printer &out) {
+    TRACE_SCOPE(entry.defined ? traceNames[static_cast<std::size_t>(entry.operation)] : "undefined");
+    OperationStats::Clock::time_point start;
+    if (stats) start = OperationStats::Clock::now();
+    rankedTags.advance(entryCount++);
+    // the entry is logged before it is applied
+    if (checkpoint && checkpoint->isOpen()) checkpoint->append(entry.lines);
+
+    try {
+        if (!entry.defined) {
+            throw InvalidOperationException(entry.op);
+        }
+        out << ">> " << entry.op << '\n';
+        auto &user1 = entry.user1, &u2 = entry.user2;
+        switch (entry.operation) {
+            case Operation::FOLLOW:
+                opFollow(user1, u2);
+                break;
+            case Operation::UNFOLLOW:
+                opUnFollow(user1, u2);
+                break;
+            case Operation::LIKE:
+                opLike(user1, u2, entry.postId - 1);
+                break;
+            case Operation::UNLIKE:
+                opUnLike(user1, u2, entry.postId - 1);
+                break;
+            case Operation::COMMENT:
+                opComment(user1, u2, entry.postId - 1, entry.text);
+                break;
+            case Operation::UNCOMMENT:
+                opUnComment(user1, u2, entry.postId - 1, entry.commentId - 1);
+                break;
+            case Operation::POST: {
+                auto user = getUser(user1);
+                if (entry.error) {
+                    std::rethrow_exception(entry.error);
+                }
+                opPost(user1, makePost(user, entry.post));
+                break;
             }
-            std::cout << ">> " << op << std::endl;
-            auto operation = it->second;
-            switch (operation) {
-                case Operation::FOLLOW:
-                    iss >> u2;
-                    opFollow(u1, u2);
-                    break;
-                case Operation::UNFOLLOW:
-                    iss >> u2;
-                    opUnFollow(u1, u2);
-                    break;
-                case Operation::LIKE:
-                    iss >> u2 >> postId;
-                    opLike(u1, u2, --postId);
-                    break;
-                case Operation::UNLIKE:
-                    iss >> u2 >> postId;
-                    opUnLike(u1, u2, --postId);
-                    break;
-                case Operation::COMMENT:
-                    iss >> u2 >> postId;
-                    std::getline(fin, text);
-                    opComment(u1, u2, --postId, text);
-                    break;
-                case Operation::UNCOMMENT:
-                    iss >> u2 >> postId >> commentId;
-                    opUnComment(u1, u2, --postId, --commentId);
-                    break;
-                case Operation::POST:
-                    opPost(u1, readPost(fin, getUser(u1)));
-                    break;
-                case Operation::DELETE:
-                    iss >> postId;
-                    opDelete(u1, --postId);
-                    break;
-                case Operation::REFRESH:
-                    opRefresh(u1);
-                    break;
-                case Operation::VISIT:
-                    iss >> u2;
-                    opVisit(u1, u2);
-                    break;
-                case Operation::TRENDING:
-                    std::size_t n;
-                    iss >> n;
-                    opTrending(n);
-                    break;
+            case Operation::DELETE:
+                opDelete(user1, entry.postId - 1);
+                break;
+            case Operation::REFRESH: {
+                auto posts = opRefresh(user1, out);
+                if (stats) stats->refreshPosts.record(posts);
+                break;
             }
-        } catch (SimpleTwitterException &e) {
-            std::cout << e.what() << std::endl;
+            case Operation::VISIT:
+                opVisit(user1, u2, out);
+                break;
+            case Operation::TRENDING:
+                opTrending(entry.count, out);
+                break;
+            case Operation::SEARCH:
+                opSearch(user1, entry.text, entry.count, out);
+                break;
         }
+    } catch (SimpleTwitterException &e) {
+        out << e.what() << '\n';
     }
-    fin.close();
+    if (stats && entry.defined) {
+        stats->record(entry.operation, OperationStats::Clock::now() - start);
+    }
+    entry = LogEntry();
+    if (checkpoint && checkpoint->due()) takeSnapshot();
+}
+
+void Server::enableStats() {
+    stats = std::make_unique<OperationStats>();
+}
+
+void Server::writeStats(const std::string &fileName) const {
+    std::ofstream fout(fileName);
+    if (!fout.is_open()) {
+        throw FileMissingException(fileName);
+    }
+    std::vector<std::string> names(static_cast<std::size_t>(Operation::SEARCH) + 1);
+    for (const auto &p : operations) {
+        names[static_cast<std::size_t>(p.second)] = p.first;
+    }
+    auto row = [&fout](const std::string &name, const Histogram &histogram) {
+        fout << std::left << std::setw(14) << name << std::right
+             << std::setw(10) << histogram.count()
+             << std::setw(12) << histogram.percentile(0.5)
+             << std::setw(12) << histogram.percentile(0.99)
+             << std::setw(12) << histogram.percentile(0.999)
+             << std::setw(12) << histogram.max();
+    };
+    fout << std::left << std::setw(14) << "operation" << std::right << std::setw(10) << "count"
+         << std::setw(12) << "p50_ns" << std::setw(12) << "p99_ns" << std::setw(12) << "p999_ns"
+         << std::setw(12) << "max_ns" << std::setw(12) << "total_ms" << '\n';
+    for (std::size_t i = 0; i < names.size(); i++) {
+        row(names[i], stats->latency[i]);
+        fout << std::setw(12) << std::fixed << std::setprecision(3) << stats->totalTime[i] / 1e6 << '\n';
+    }
+    fout << '\n' << std::left << std::setw(14) << "refresh" << std::right << std::setw(10) << "count"
+         << std::setw(12) << "p50_posts" << std::setw(12) << "p99_posts" << std::setw(12) << "p999_posts"
+         << std::setw(12) << "max_posts" << '\n';
+    row("posts", stats->refreshPosts);
+    fout << '\n';
 }
 
 
@@ -299,10 +868,10 @@ void Server::opFollow(const std::string &userName1, const std::string &userName2
     if (u1 == u2) {
         throw FollowException(userName1, userName2);
     }
-    if (u1->getFollowingCount() >= MAX_FOLLOWING) {
+    if (u1->getFollowingCount() >= limits.following) {
         throw TooManyFollowingsException(userName1);
     }
-    if (u2->getFollowersCount() >= MAX_FOLLOWERS) {
+    if (u2->getFollowersCount() >= limits.followers) {
         throw TooManyFollowersException(userName2);
     }
     if (u1->isFollowing(u2) || u2->isFollower(u1)) {
@@ -361,216 +930,551 @@ void Server::opDelete(const std::string &userName1, std::size_t postId) {
     u1->removePost(postId);
 }
 
-void Server::opRefresh(const std::string &userName1) {
+std::size_t Server::opRefresh(const std::string &userName1, Printer &out) {
     auto u1 = getUser(userName1);
-    u1->refresh();
+    return u1->refresh(out);
 }
 
-void Server::opVisit(const std::string &userName1, const std::string &userName2) {
+void Server::opVisit(const std::string &userName1, const std::string &userName2, Printer &out) {
     auto u1 = getUser(userName1);
     auto u2 = getUser(userName2);
-    u1->visit(u2);
+    u1->visit(u2, out);
 }
 
-void Server::opTrending(std::size_t n) {
-    std::sort(orderedTags.begin(), orderedTags.end(), [](const Tag *a, const Tag *b) {
-        if (a->getScore() != b->getScore()) return a->getScore() > b->getScore();
-        return a->getContent() < b->getContent();
+void Server::opTrending(std::size_t n, Printer &out) {
+    // rankedTags is kept in trending order, so only the first n are visited
+    rankedTags.update();
+    std::ostringstream oss;
+    std::size_t i = 0;
+    for (auto it = rankedTags.ranked.begin(); it != rankedTags.ranked.end() && i < n; ++it) {
+        if ((*it)->getScore() == 0) break;
+        oss << ++i << " " << **it << '\n';
+    }
+    out << oss.str();
+}
+
+void Server::opSearch(const std::string &userName1, const std::string &tagContent, std::size_t page,
+                      Printer &out) {
+    // the postings of the tag find the first post of the page without a scan;
+    // a tag never used has no posts, and is not made by looking it up
+    getUser(userName1);
+    auto it = tagIds.find(tagContent);
+    if (it == tagIds.end()) return;
+    auto first = (std::max<std::size_t>(page, 1) - 1) * SEARCH_PAGE;
+    tags[it->second]->getPosts().forRange(first, SEARCH_PAGE, [&out](Post *post) {
+        out << post->render();
     });
-    for (unsigned int i = 0; i < std::min(n, orderedTags.size()); i++) {
-        if (orderedTags[i]->getScore() == 0) break;
-        std::cout << i + 1 << " " << *orderedTags[i] << std::endl;
+}
+
+const Adjacency::Entry *Adjacency::findEdge(std::size_t row, std::size_t id) const {
+    if (row >= rows()) return nullptr;
+    auto first = sorted.begin() + offsets[row], last = sorted.begin() + offsets[row + 1];
+    auto it = std::lower_bound(first, last, id, [](const Entry &entry, std::size_t id) {
+        return entry.id < id;
+    });
+    return it != last && it->id == id ? &*it : nullptr;
+}
+
+bool Adjacency::test(std::size_t row, const User *user) const {
+    auto entry = findEdge(row, user->getId());
+    return (entry && edges[entry->edge]) || deltaIndex.count(key(row, user->getId()));
+}
+
+void Adjacency::add(std::size_t row, User *user) {
+    if (row >= degree.size()) degree.resize(row + 1, 0);
+    auto &users = delta[row];
+    deltaIndex.emplace(key(row, user->getId()), users.size());
+    users.emplace_back(user);
+    ++degree[row];
+    if (++pending * 4 > edges.size() + 256) compact();
+}
+
+void Adjacency::remove(std::size_t row, User *user) {
+    auto it = deltaIndex.find(key(row, user->getId()));
+    if (it != deltaIndex.end()) {
+        delta[row][it->second] = nullptr;
+        deltaIndex.erase(it);
+    } else {
+        edges[findEdge(row, user->getId())->edge] = nullptr;
+    }
+    --degree[row];
+    if (++pending * 4 > edges.size() + 256) compact();
+}
+
+void Adjacency::compact() {
+    std::vector<std::size_t> newOffsets = {0};
+    std::vector<User *> newEdges;
+    newEdges.reserve(edges.size() + pending);
+    auto append = [&newEdges](User *user) { newEdges.emplace_back(user); };
+    for (std::size_t row = 0; row < std::max(rows(), degree.size()); row++) {
+        forEach(row, append);
+        newOffsets.emplace_back(newEdges.size());
+    }
+    offsets = std::move(newOffsets);
+    edges = std::move(newEdges);
+    delta.clear();
+    deltaIndex.clear();
+    pending = 0;
+
+    sorted.clear();
+    sorted.reserve(edges.size());
+    for (std::size_t i = 0; i < edges.size(); i++) {
+        sorted.push_back(Entry{edges[i]->getId(), i});
+    }
+    for (std::size_t row = 0; row < rows(); row++) {
+        std::sort(sorted.begin() + offsets[row], sorted.begin() + offsets[row + 1],
+                  [](const Entry &a, const Entry &b) { return a.id < b.id; });
+    }
+}
+
+bool UserSet::Chunk::set(std::uint16_t low) {
+    if (!bits.empty()) {
+        auto &word = bits[low / 64];
+        if (word >> (low % 64) & 1) return false;
+        word |= std::uint64_t(1) << (low % 64);
+    } else {
+        auto it = std::lower_bound(array.begin(), array.end(), low);
+        if (it != array.end() && *it == low) return false;
+        array.insert(it, low);
+        if (array.size() > arrayLimit) {
+            bits.assign(1024, 0);
+            for (auto value : array) bits[value / 64] |= std::uint64_t(1) << (value % 64);
+            array = std::vector<std::uint16_t>();
+        }
+    }
+    ++size;
+    return true;
+}
+
+bool UserSet::Chunk::reset(std::uint16_t low) {
+    if (!bits.empty()) {
+        auto &word = bits[low / 64];
+        if (!(word >> (low % 64) & 1)) return false;
+        word &= ~(std::uint64_t(1) << (low % 64));
+        // back to an array well below the limit, so that it does not flip at every like
+        if (--size <= arrayLimit / 2) {
+            for (std::size_t w = 0; w < bits.size(); w++) {
+                for (auto word2 = bits[w]; word2 != 0; word2 &= word2 - 1) {
+                    array.emplace_back(w * 64 + __builtin_ctzll(word2));
+                }
+            }
+            bits = std::vector<std::uint64_t>();
+        }
+        return true;
+    }
+    auto it = std::lower_bound(array.begin(), array.end(), low);
+    if (it == array.end() || *it != low) return false;
+    array.erase(it);
+    --size;
+    return true;
+}
+
+void UserSet::setInChunks(std::size_t id) {
+    auto it = std::lower_bound(chunks.begin(), chunks.end(), id >> 16,
+                               [](const Chunk &chunk, std::size_t key) { return chunk.key < key; });
+    if (it == chunks.end() || it->key != id >> 16) {
+        it = chunks.insert(it, Chunk{id >> 16, 0, {}, {}});
+    }
+    if (it->set(id & 0xffff)) ++total;
+}
+
+void UserSet::set(std::size_t id) {
+    if (!chunks.empty()) {
+        setInChunks(id);
+        return;
+    }
+    auto it = std::lower_bound(ids, ids + total, id);
+    if (it != ids + total && *it == id) return;
+    if (total < inlineIds) {
+        std::copy_backward(it, ids + total, ids + total + 1);
+        *it = id;
+        ++total;
+        return;
+    }
+    // the inline ids are full, move them to the chunks
+    auto n = total;
+    total = 0;
+    for (std::size_t i = 0; i < n; i++) setInChunks(ids[i]);
+    setInChunks(id);
+}
+
+void UserSet::reset(std::size_t id) {
+    if (chunks.empty()) {
+        auto it = std::lower_bound(ids, ids + total, id);
+        if (it == ids + total || *it != id) return;
+        std::copy(it + 1, ids + total, it);
+        --total;
+        return;
+    }
+    auto it = std::lower_bound(chunks.begin(), chunks.end(), id >> 16,
+                               [](const Chunk &chunk, std::size_t key) { return chunk.key < key; });
+    if (it == chunks.end() || it->key != id >> 16 || !it->reset(id & 0xffff)) return;
+    --total;
+    if (it->size == 0) chunks.erase(it);
+    if (total == 0) chunks.clear();
+}
+
+std::string_view StringArena::store(std::string_view str) {
+    if (str.empty()) return {};
+    if (str.size() >= 16384) {
+        // a long string gets a block of its own, the current one is kept
+        blocks.emplace_back(new char[str.size()]);
+        std::memcpy(blocks.back().get(), str.data(), str.size());
+        bytes += str.size();
+        return {blocks.back().get(), str.size()};
+    }
+    if (str.size() > left) {
+        // the blocks grow with the arena, from 1 KiB to 64 KiB
+        left = std::max(str.size(), std::min<std::size_t>(65536, std::max<std::size_t>(1024, bytes)));
+        blocks.emplace_back(new char[left]);
+        next = blocks.back().get();
+    }
+    std::memcpy(next, str.data(), str.size());
+    std::string_view view(next, str.size());
+    next += str.size();
+    left -= str.size();
+    bytes += str.size();
+    return view;
+}
+
+void StringShard::release(std::size_t bytes) {
+    deadBytes += bytes;
+    // once most of the strings are dead, copy the others to a new arena
+    if (deadBytes > arena.size() / 2 + 65536) {
+        StringArena live;
+        for (auto user : users) {
+            user->moveStrings(live);
+        }
+        arena = std::move(live);
+        deadBytes = 0;
+    }
+}
+
+Printer::~Printer() {
+    if (!thread.joinable()) return;
+    endText();
+    submit();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        done = true;
+    }
+    changed.notify_all();
+    thread.join();
+}
+
+Printer &Printer::operator<<(std::string_view str) {
+    if (!thread.joinable()) {
+        sink.write(str);
+        return *this;
+    }
+    text += str;
+    if (text.size() >= 65536) endText();
+    return *this;
+}
+
+Printer &Printer::operator<<(const Block &block) {
+    if (!thread.joinable()) return *this << std::string_view(*block);
+    endText();
+    batchSize += block->size();
+    batch.emplace_back(block);
+    if (batchSize >= 262144) submit();
+    return *this;
+}
+
+void Printer::flush() {
+    endText();
+    if (thread.joinable()) {
+        submit();
+        // the printer is idle once its queue is empty and it is not writing
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [this] { return queue.empty() && !writing; });
+    }
+    sink.flush();
+}
+
+void Printer::endText() {
+    if (text.empty()) return;
+    batchSize += text.size();
+    batch.emplace_back(std::make_shared<const std::string>(std::move(text)));
+    text.clear();
+    if (batchSize >= 262144) submit();
+}
+
+void Printer::submit() {
+    if (batch.empty()) return;
+    {
+        // the log waits only when the printer is far behind
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [this] { return queue.size() < 64; });
+        queue.emplace_back(std::move(batch));
+    }
+    changed.notify_all();
+    batch.clear();
+    batchSize = 0;
+}
+
+void Printer::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        changed.wait(lock, [this] { return done || !queue.empty(); });
+        if (queue.empty()) break;
+        auto blocks = std::move(queue.front());
+        queue.pop_front();
+        writing = true;
+        lock.unlock();
+        changed.notify_all();
+        write(blocks);
+        lock.lock();
+        writing = false;
+        changed.notify_all();
+    }
+}
+
+void Printer::write(const std::vector<Block> &blocks) {
+    for (const auto &block : blocks) {
+        sink.write(*block);
     }
 }
 
 void User::addFollowing(User *user) {
-    auto it = mapFollowingId.find(user);
-    if (it == mapFollowingId.end()) {
-        auto followingId = ++maxFollowingId;
-        mapFollowingId.emplace(user, followingId);
-        mapIdFollowing.emplace(followingId, user);
+    if (!isFollowing(user)) {
+        graph->following.add(id, user);
     }
 }
 
 void User::addFollower(User *user) {
-    auto it = mapFollowersId.find(user);
-    if (it == mapFollowersId.end()) {
-        auto followerId = ++maxFollowerId;
-        mapFollowersId.emplace(user, followerId);
-        mapIdFollowers.emplace(followerId, user);
+    if (!isFollower(user)) {
+        graph->followers.add(id, user);
     }
 }
 
 void User::removeFollowing(User *user) {
-    auto it = mapFollowingId.find(user);
-    if (it != mapFollowingId.end()) {
-        auto followingId = it->second;
-        mapFollowingId.erase(it);
-        mapIdFollowing.erase(followingId);
+    if (isFollowing(user)) {
+        graph->following.remove(id, user);
     }
 }
 
 void User::removeFollower(User *user) {
-    auto it = mapFollowersId.find(user);
-    if (it != mapFollowersId.end()) {
-        auto followerId = it->second;
-        mapFollowersId.erase(it);
-        mapIdFollowers.erase(followerId);
+    if (isFollower(user)) {
+        graph->followers.remove(id, user);
     }
 }
 
 void User::addPost(std::unique_ptr<Post> &&post) {
-    if (posts.size() >= MAX_POSTS) {
+    if (posts.size() >= Server::limits.posts) {
         throw TooManyPostsException(name);
     }
-    posts.emplace_back(std::move(post));
+    posts.push_back(std::move(post));
+    invalidatePosts();
 }
 
 void User::removePost(std::size_t id) {
     if (id >= posts.size()) {
         throw DeletePostException(name, id);
     }
-    auto it = posts.begin() + id;
-    posts.erase(it);
+    auto bytes = posts[id]->stringBytes();
+    posts.erase(id);
+    invalidatePosts();
+    releaseStrings(bytes);
+}
+
+void User::moveStrings(StringArena &arena) {
+    for (const auto &post : posts) {
+        post->moveStrings(arena);
+    }
 }
 
 void User::likePost(User *user, std::size_t postId) {
     if (postId >= user->posts.size()) {
         throw LikeException(name, user->getName(), postId, SimpleTwitterException::NOT_EXIST);
     }
-    auto it = user->posts.begin() + postId;
-    (*it)->addLike(this, postId);
+    user->posts[postId]->addLike(this, postId);
 }
 
 void User::unLikePost(User *user, std::size_t postId) {
     if (postId >= user->posts.size()) {
         throw UnLikeException(name, user->getName(), postId, SimpleTwitterException::NOT_EXIST);
     }
-    auto it = user->posts.begin() + postId;
-    (*it)->removeLike(this, postId);
+    user->posts[postId]->removeLike(this, postId);
 }
 
 void User::commentPost(User *user, std::size_t postId, const std::string &text) {
     if (postId >= user->posts.size()) {
         throw CommentException(name, user->getName(), postId);
     }
-    auto it = user->posts.begin() + postId;
-    (*it)->addComment(this, text);
+    user->posts[postId]->addComment(this, text);
 }
 
 void User::unCommentPost(User *user, std::size_t postId, std::size_t commentId) {
     if (postId >= user->posts.size()) {
         throw UnCommentException(name, user->getName(), postId, commentId, SimpleTwitterException::NOT_EXIST);
     }
-    auto it = user->posts.begin() + postId;
-    (*it)->removeComment(this, postId, commentId);
+    user->posts[postId]->removeComment(this, postId, commentId);
 }
 
-void User::printPosts() {
-    for (const auto &post : posts) {
-        std::cout << *post;
+const Printer::Block &User::renderPosts() {
+    // rebuilt from the blocks of the posts, only those changed are formatted again
+    if (!postsBlock) {
+        std::string block;
+        for (const auto &post : posts) {
+            block += *post->render();
+        }
+        postsBlock = std::make_shared<const std::string>(std::move(block));
     }
+    return postsBlock;
 }
 
-void User::refresh() {
-    printPosts();
-    for (auto p : mapIdFollowing) {
-        p.second->printPosts();
-    }
+void User::printPosts(Printer &out) {
+    out << renderPosts();
+}
+
+std::size_t User::refresh(Printer &out) {
+    printPosts(out);
+    auto printed = posts.size();
+    forEachFollowing([&out, &printed](User *user) {
+        user->printPosts(out);
+        printed += user->posts.size();
+    });
+    return printed;
 }
 
-void User::visit(User *user) {
-    std::cout << user->name << std::endl;
+void User::visit(User *user, Printer &out) {
+    out << user->name << '\n';
     if (this != user) {
         if (this->isFollowing(user)) {
             if (user->isFollowing(this)) {
-                std::cout << "friend" << std::endl;
+                out << "friend" << '\n';
             } else {
-                std::cout << "following" << std::endl;
+                out << "following" << '\n';
             }
         } else {
-            std::cout << "stranger" << std::endl;
+            out << "stranger" << '\n';
         }
     } else {
-        std::cout << std::endl;
+        out << '\n';
     }
-    std::cout << "Followers: " << user->mapFollowersId.size() << std::endl;
-    std::cout << "Following: " << user->mapFollowingId.size() << std::endl;
+    out << "Followers: " << user->getFollowersCount() << '\n';
+    out << "Following: " << user->getFollowingCount() << '\n';
 }
 
-Post::Post(User *owner, std::string title, std::string text, std::vector<Tag *> &&tags) :
-        owner(owner), title(std::move(title)), text(std::move(text)), tags(std::move(tags)) {
-    for (auto tag : this->tags) {
+Post::Post(User *owner, std::string_view title, std::string_view text, std::vector<Tag *> &&tags) :
+        owner(owner), title(owner->store(title)), text(owner->store(text)), tags(std::move(tags)),
+        postings(this->tags.size()) {
+    for (std::size_t i = 0; i < this->tags.size(); i++) {
+        auto tag = this->tags[i];
         tag->addPost();
-        tag->calculateScore();
+        // a post is found once by search, however often it names the tag
+        if (std::find(this->tags.begin(), this->tags.begin() + i, tag) == this->tags.begin() + i) {
+            postings[i] = tag->indexPost(this);
+        }
+    }
+}
+
+void Post::movePosting(const Tag *tag, std::size_t slot) {
+    postings[std::find(tags.begin(), tags.end(), tag) - tags.begin()] = slot;
+}
+
+const Printer::Block &Post::render() {
+    if (!block) {
+        std::ostringstream oss;
+        oss << *this;
+        block = std::make_shared<const std::string>(oss.str());
     }
+    return block;
+}
+
+void Post::invalidate() {
+    // the block of the owner contains this one
+    block.reset();
+    owner->invalidatePosts();
 }
 
 Post::~Post() {
-    for (auto tag : this->tags) {
+    for (std::size_t i = 0; i < this->tags.size(); i++) {
+        auto tag = this->tags[i];
         tag->removePost();
-        tag->removeLike(likes.size());
+        tag->removeLike(likes.count());
         tag->removeComment(comments.size());
-        tag->calculateScore();
+        if (std::find(this->tags.begin(), this->tags.begin() + i, tag) == this->tags.begin() + i) {
+            tag->unindexPost(postings[i]);
+        }
+    }
+}
+
+void Tag::unindexPost(std::size_t slot) {
+    posts.remove(slot);
+    if (posts.sparse()) {
+        posts.compact([this](Post *post, std::size_t moved) { post->movePosting(this, moved); });
     }
 }
 
+bool Tag::reorderPosts(const std::vector<Post *> &order) {
+    if (order.size() != posts.size()) return false;
+    std::vector<Post *> sorted(order);
+    std::sort(sorted.begin(), sorted.end());
+    if (std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end()) return false;
+    for (auto post : order) {
+        auto &postTags = post->getTags();
+        if (std::find(postTags.begin(), postTags.end(), this) == postTags.end()) return false;
+    }
+    posts.assign(order, [this](Post *post, std::size_t slot) { post->movePosting(this, slot); });
+    return true;
+}
+
 std::ostream &operator<<(std::ostream &os, const Post &post) {
-    os << post.owner->getName() << std::endl;
-    os << post.title << std::endl;
-    os << post.text << std::endl;
+    os << post.owner->getName() << '\n';
+    os << post.title << '\n';
+    os << post.text << '\n';
     os << "Tags: ";
     for (auto tag : post.tags) {
         os << tag->getContent() << " ";
     }
-    os << std::endl << "Likes: " << post.likes.size() << std::endl;
+    os << '\n' << "Likes: " << post.likes.count() << '\n';
     if (!post.comments.empty()) {
-        os << "Comments:" << std::endl;
+        os << "Comments:" << '\n';
         for (auto &comment : post.comments) {
             os << comment->getUser()->getName() << ": "
-               << comment->getText() << std::endl;
+               << comment->getText() << '\n';
         }
     }
-    os << "- - - - - - - - - - - - - - -" << std::endl;
+    os << "- - - - - - - - - - - - - - -" << '\n';
     return os;
 }
 
 
 void Post::addLike(User *user, std::size_t postId) {
-    auto it = likes.find(user);
-    if (it != likes.end()) {
+    if (likes.test(user->getId())) {
         throw LikeException(user->getName(), owner->getName(), postId, SimpleTwitterException::ALREADY_DONE);
     }
-    if (likes.size() >= MAX_LIKES) {
-        throw TooManyLikesException(title);
+    if (likes.count() >= Server::limits.likes) {
+        throw TooManyLikesException(std::string(title));
     }
-    likes.emplace_hint(it, user);
+    likes.set(user->getId());
+    invalidate();
     for (auto tag: tags) {
         tag->addLike();
-        tag->calculateScore();
     }
 }
 
 void Post::removeLike(User *user, std::size_t postId) {
-    auto it = likes.find(user);
-    if (it == likes.end()) {
+    if (!likes.test(user->getId())) {
         throw UnLikeException(user->getName(), owner->getName(), postId, SimpleTwitterException::NOT_DONE);
     }
-    likes.erase(it);
+    likes.reset(user->getId());
+    invalidate();
     for (auto tag: tags) {
         tag->removeLike();
-        tag->calculateScore();
     }
 }
 
 void Post::addComment(User *user, const std::string &commentText) {
-    if (comments.size() >= MAX_COMMENTS) {
-        throw TooManyCommentsException(title);
+    if (comments.size() >= Server::limits.comments) {
+        throw TooManyCommentsException(std::string(title));
     }
-    comments.emplace_back(std::make_unique<Comment>(user, commentText));
+    comments.push_back(Comment(user, owner->store(commentText)));
+    invalidate();
     for (auto tag: tags) {
         tag->addComment();
-        tag->calculateScore();
     }
 }
 
@@ -579,16 +1483,31 @@ void Post::removeComment(User *user, std::size_t postId, std::size_t commentId)
         throw UnCommentException(user->getName(), owner->getName(), postId, commentId,
                                  SimpleTwitterException::NOT_DONE);
     }
-    auto it = comments.begin() + commentId;
-    if (user != (*it)->getUser()) {
+    if (user != comments[commentId]->getUser()) {
         throw UnCommentException(user->getName(), owner->getName(), postId, commentId,
                                  SimpleTwitterException::NOT_OWNER);
     }
-    comments.erase(it);
+    auto bytes = comments[commentId]->getText().size();
+    comments.erase(commentId);
+    invalidate();
     for (auto tag: tags) {
         tag->removeComment();
-        tag->calculateScore();
     }
+    owner->releaseStrings(bytes);
+}
+
+std::size_t Post::stringBytes() const {
+    auto bytes = title.size() + text.size();
+    for (const auto &comment : comments) {
+        bytes += comment->getText().size();
+    }
+    return bytes;
+}
+
+void Post::moveStrings(StringArena &arena) {
+    title = arena.store(title);
+    text = arena.store(text);
+    comments.forEach([&arena](Comment &comment) { comment.moveText(arena); });
 }
 
 
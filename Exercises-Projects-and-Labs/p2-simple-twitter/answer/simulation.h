@@ -78,6 +78,11 @@ public:
         info = "Error: Wrong number of arguments!\n";
         info += "Usage: ./p2 <username> <logfile>";
     }
+
+    explicit InvalidArgumentException(const std::string &argument) {
+        info = "Error: Invalid argument ?!\n"_f % argument;
+        info += "Usage: ./p2 <username> <logfile>";
+    }
 };
 
 class FileMissingException : public SimpleTwitterException {
@@ -220,6 +225,27 @@ public:
     }
 };
 
+class OutputFailedException : public SimpleTwitterException {
+public:
+    OutputFailedException() {
+        info = "Error: Cannot write the output!";
+    }
+};
+
+class InvalidDatasetException : public SimpleTwitterException {
+public:
+    explicit InvalidDatasetException(const std::string &filename) {
+        info = "Error: File ? is not a valid dataset!"_f % filename;
+    }
+};
+
+class CheckpointFailedException : public SimpleTwitterException {
+public:
+    explicit CheckpointFailedException(const std::string &filename) {
+        info = "Error: Cannot checkpoint the server to ?!"_f % filename;
+    }
+};
+
 class UserNotFoundException : public SimpleTwitterException{
 public:
     explicit UserNotFoundException(const std::string &user) {
@@ -0,0 +1,274 @@
+# benchmark the server on generated power-law datasets
+
+import argparse
+import array
+import json
+import os
+import random
+import struct
+import subprocess
+import time
+
+DATASET_MAGIC = b'P2DATA02'
+MAX_TAGS_ALL = 1000
+TRENDING = 10
+
+# the operations of each mix, with their weights
+MIXES = {
+    'read': {'refresh': 45, 'visit': 35, 'trending': 20},
+    'write': {'post': 20, 'like': 30, 'unlike': 10, 'comment': 25, 'uncomment': 5, 'delete': 10},
+    'social': {'follow': 45, 'unfollow': 40, 'visit': 15},
+    'mixed': {'follow': 10, 'unfollow': 10, 'like': 10, 'unlike': 10, 'comment': 10,
+              'uncomment': 10, 'post': 5, 'delete': 5, 'refresh': 10, 'visit': 10, 'trending': 10},
+}
+
+
+def popular(n):
+    # a rank from a Zipf law of exponent 1, P(rank < r) = ln r / ln n,
+    # spread over the ids so that the popular users are not the first ones
+    rank = int(n ** random.random()) - 1
+    return rank * 2654435761 % n
+
+
+def degree(mean, cap):
+    # a Pareto tail of exponent 2 has a mean of twice its minimum
+    return min(cap, int(mean / 2 * random.paretovariate(2)))
+
+
+def sample(ids, first, count, k):
+    # k distinct ids of ids[first:first + count]
+    if k >= count:
+        return list(ids[first:first + count])
+    picked = set()
+    while len(picked) < k:
+        picked.add(ids[first + random.randrange(count)])
+    return list(picked)
+
+
+class Graph:
+    # the following and followers of every user, as offsets into flat arrays
+    def __init__(self, users, mean_following):
+        self.users = users
+        self.following_start = array.array('Q', [0])
+        self.following = array.array('Q')
+        for user in range(users):
+            targets = set()
+            for i in range(degree(mean_following, users - 1)):
+                target = popular(users)
+                if target != user:
+                    targets.add(target)
+            self.following.extend(sorted(targets))
+            self.following_start.append(len(self.following))
+
+        # the followers are the following turned around, by a counting sort
+        counts = array.array('Q', bytes(8 * (users + 1)))
+        for target in self.following:
+            counts[target + 1] += 1
+        for user in range(users):
+            counts[user + 1] += counts[user]
+        self.followers_start = array.array('Q', counts)
+        self.followers = array.array('Q', bytes(8 * len(self.following)))
+        for user in range(users):
+            for i in range(self.following_start[user], self.following_start[user + 1]):
+                target = self.following[i]
+                self.followers[counts[target]] = user
+                counts[target] += 1
+
+    def num_following(self, user):
+        return self.following_start[user + 1] - self.following_start[user]
+
+    def num_followers(self, user):
+        return self.followers_start[user + 1] - self.followers_start[user]
+
+
+def random_tags():
+    return sorted(set(popular(MAX_TAGS_ALL) for i in range(random.randint(1, 3))))
+
+
+def write_dataset(path, graph, mean_posts):
+    # the layout of Server::saveDataset, with every field 8 bytes
+    strings = bytearray()
+
+    def add_string(s):
+        data = s.encode()
+        offset = len(strings)
+        strings.extend(data)
+        return offset, len(data)
+
+    users = graph.users
+    user_table = array.array('Q')
+    post_table = array.array('Q')
+    comment_table = array.array('Q')
+    post_tags = array.array('Q')
+    likes = array.array('Q')
+    posts = array.array('I')
+    tag_posts = [[] for tag in range(MAX_TAGS_ALL)]
+    num_posts_all = 0
+    for user in range(users):
+        num_posts = random.randint(0, 2 * mean_posts)
+        posts.append(num_posts)
+        first_follower = graph.followers_start[user]
+        num_followers = graph.num_followers(user)
+        for post in range(num_posts):
+            tags = random_tags()
+            post_likes = sample(graph.followers, first_follower, num_followers,
+                                degree(4, num_followers))
+            first_comment = len(comment_table) // 3
+            num_comments = random.randint(0, 2)
+            for i in range(num_comments):
+                if num_followers:
+                    commenter = graph.followers[first_follower + random.randrange(num_followers)]
+                else:
+                    commenter = random.randrange(users)
+                comment_table.append(commenter)
+                comment_table.extend(add_string('u%d post-%d comment-%d' % (user, post + 1, i + 1)))
+            post_table.extend(add_string('u%d post-%d' % (user, post + 1)))
+            post_table.extend(add_string('u%d post-%d content' % (user, post + 1)))
+            post_table.extend((len(post_tags), len(tags), len(likes), len(post_likes),
+                               first_comment, num_comments))
+            post_tags.extend(tags)
+            for tag in tags:
+                tag_posts[tag].append(num_posts_all + post)
+            likes.extend(post_likes)
+        user_table.extend(add_string('u%d' % user))
+        user_table.extend((num_posts_all, num_posts,
+                           graph.following_start[user], graph.num_following(user),
+                           graph.followers_start[user], graph.num_followers(user)))
+        num_posts_all += num_posts
+
+    # search finds the posts of a tag in the order they were made
+    tag_table = array.array('Q')
+    tag_post_table = array.array('Q')
+    for tag in range(MAX_TAGS_ALL):
+        tag_table.extend(add_string('tag-%d' % tag))
+        tag_table.extend((len(tag_post_table), len(tag_posts[tag])))
+        tag_post_table.extend(tag_posts[tag])
+
+    tables = [bytes(strings), user_table, post_table, comment_table, tag_table,
+              post_tags, likes, graph.following, graph.followers, tag_post_table]
+    counts = [users, num_posts_all, len(comment_table) // 3, MAX_TAGS_ALL,
+              len(post_tags), len(likes), len(graph.following), len(graph.followers), len(tag_post_table)]
+    header_size = 8 + 8 * 20
+    offsets = []
+    end = header_size
+    for table in tables:
+        size = len(table) if isinstance(table, bytes) else len(table) * 8
+        offsets.append(end)
+        end = (end + size + 7) // 8 * 8
+    with open(path, 'wb') as f:
+        f.write(DATASET_MAGIC)
+        f.write(struct.pack('<%dQ' % 20, *(counts + [len(strings)] + offsets)))
+        for offset, table in zip(offsets, tables):
+            f.write(bytes(offset - f.tell()))
+            f.write(table if isinstance(table, bytes) else table.tobytes())
+        f.write(bytes(end - f.tell()))
+    return posts
+
+
+def write_log(path, graph, posts, mix, ops):
+    users = graph.users
+    posts = array.array('I', posts)
+    names, weights = zip(*MIXES[mix].items())
+    with open(path, 'w') as f:
+        for op in random.choices(names, weights, k=ops):
+            u1 = random.randrange(users)
+            if op in ('follow', 'visit'):
+                f.write('u%d %s u%d\n' % (u1, op, popular(users)))
+            elif op == 'unfollow':
+                count = graph.num_following(u1)
+                u2 = graph.following[graph.following_start[u1] + random.randrange(count)] \
+                    if count else popular(users)
+                f.write('u%d unfollow u%d\n' % (u1, u2))
+            elif op in ('like', 'unlike', 'comment', 'uncomment'):
+                u2 = popular(users)
+                post = random.randint(1, max(posts[u2], 1))
+                if op == 'comment':
+                    f.write('u%d comment u%d %d\ncomment of u%d\n' % (u1, u2, post, u1))
+                elif op == 'uncomment':
+                    f.write('u%d uncomment u%d %d %d\n' % (u1, u2, post, random.randint(1, 3)))
+                else:
+                    f.write('u%d %s u%d %d\n' % (u1, op, u2, post))
+            elif op == 'post':
+                posts[u1] += 1
+                f.write('u%d post\nu%d post-log\n' % (u1, u1))
+                for tag in random_tags():
+                    f.write('#tag-%d#\n' % tag)
+                f.write('u%d post-log content\n' % u1)
+            elif op == 'delete':
+                f.write('u%d delete %d\n' % (u1, random.randint(1, max(posts[u1], 1))))
+                if posts[u1]:
+                    posts[u1] -= 1
+            elif op == 'refresh':
+                f.write('u%d refresh\n' % u1)
+            else:
+                f.write('trending %d\n' % TRENDING)
+
+
+def run(program, dataset, log):
+    # the wall time and the peak resident set of one replay
+    start = time.perf_counter()
+    p = subprocess.Popen([program, dataset, log, '--no-limits'], stdout=subprocess.DEVNULL)
+    _, status, usage = os.wait4(p.pid, 0)
+    elapsed = time.perf_counter() - start
+    if status != 0:
+        raise RuntimeError('%s failed on %s' % (program, log))
+    return elapsed, usage.ru_maxrss / 1024
+
+
+def best_of(repeat, program, dataset, log):
+    results = [run(program, dataset, log) for i in range(repeat)]
+    return min(r[0] for r in results), max(r[1] for r in results)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='benchmark the server on generated datasets')
+    parser.add_argument('program')
+    parser.add_argument('--users', default='1000,100000',
+                        help='comma-separated numbers of users, up to 10^7')
+    parser.add_argument('--ops', type=int, default=200000, help='operations in each log')
+    parser.add_argument('--following', type=int, default=10, help='mean followings of a user')
+    parser.add_argument('--posts', type=int, default=2, help='mean posts of a user')
+    parser.add_argument('--mix', default=','.join(MIXES), help='comma-separated operation mixes')
+    parser.add_argument('--repeat', type=int, default=1, help='runs of each replay, the best is kept')
+    parser.add_argument('--work', default='bench', help='where the datasets and logs are kept')
+    parser.add_argument('--seed', type=int, default=280)
+    parser.add_argument('--json', help='also write the results to this file')
+    args = parser.parse_args()
+
+    os.makedirs(args.work, exist_ok=True)
+    empty = os.path.join(args.work, 'empty')
+    open(empty, 'w').close()
+
+    results = []
+    print('%9s %-7s %9s %9s %9s %11s %9s %9s' %
+          ('users', 'mix', 'ops', 'load s', 'replay s', 'ops/s', 'peak MB', '+MB'))
+    for users in [int(n) for n in args.users.split(',')]:
+        # the same parameters give the same dataset, and the logs are kept
+        name = 'u%d-f%d-p%d-s%d' % (users, args.following, args.posts, args.seed)
+        dataset = os.path.join(args.work, name + '.ds')
+        random.seed('%s-graph' % name)
+        graph = Graph(users, args.following)
+        posts = write_dataset(dataset, graph, args.posts)
+
+        load, base = best_of(args.repeat, args.program, dataset, empty)
+        for mix in args.mix.split(','):
+            log = os.path.join(args.work, '%s-%s-%d' % (name, mix, args.ops))
+            if not os.path.exists(log):
+                random.seed('%s-%s-%d' % (name, mix, args.ops))
+                write_log(log, graph, posts, mix, args.ops)
+            elapsed, peak = best_of(args.repeat, args.program, dataset, log)
+            replay = max(elapsed - load, 1e-9)
+            result = {'users': users, 'mix': mix, 'ops': args.ops, 'load': load,
+                      'replay': replay, 'ops_per_second': args.ops / replay,
+                      'peak_mb': peak, 'replay_mb': peak - base}
+            results.append(result)
+            print('%9d %-7s %9d %9.3f %9.3f %11.0f %9.1f %9.1f' %
+                  (users, mix, args.ops, load, replay, result['ops_per_second'], peak, peak - base))
+
+    if args.json:
+        with open(args.json, 'w') as f:
+            json.dump(results, f, indent=2)
+
+
+if __name__ == '__main__':
+    main()
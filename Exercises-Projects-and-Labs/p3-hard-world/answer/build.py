@@ -5,6 +5,7 @@ files = [
     'creature.cpp',
     'grid.cpp',
     'world.cpp',
+    'snapshot.cpp',
     'controller.cpp',
     'exception.cpp'
 ]
@@ -19,7 +20,19 @@ head = [
     '#include <iostream>',
     '#include <sstream>',
     '#include <fstream>',
+    '#include <algorithm>',
+    '#include <thread>',
+    '#include <atomic>',
+    '#include <chrono>',
+    '#include <climits>',
+    '#include <cstdio>',
+    '#include <cstring>',
+    '#include <fcntl.h>',
+    '#include <sys/mman.h>',
+    '#include <sys/stat.h>',
+    '#include <unistd.h>',
     '#include "simulation.h"',
+    '#include "../../../bench/tracing.h"',
     '',
     'namespace p3',
     '{',
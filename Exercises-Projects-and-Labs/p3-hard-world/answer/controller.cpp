@@ -5,7 +5,15 @@
 #include <iostream>
 #include <sstream>
 #include <fstream>
+#include <algorithm>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <cstring>
 #include "simulation.h"
+#include "../../../bench/tracing.h"
 
 using namespace p3;
 
@@ -21,72 +29,213 @@ Controller::Controller(int argc, char *argv[])
         throw NegativeRoundException();
     }
     this->world = new World();
+    this->round = 0;
     this->verbose = false;
-    if (argc > 4)
+    this->limited = true;
+    this->quiet = this->stats = this->delta = this->digest = false;
+    this->lastDigest = 0;
+    this->verified = 0;
+    this->every = 0;
+    this->threads = 1;
+    this->lanes = false;
+    this->ensemble = false;
+    this->cycles = false;
+    this->cycleRound = -1;
+    this->cycleLength = this->period = 0;
+    for (int i = 4; i < argc; i++)
     {
-        std::string str = argv[4];
+        std::string str = argv[i];
         if (str == "v" || str == "verbose")
         {
             this->verbose = true;
+        } else if (str == "-q")
+        {
+            this->quiet = true;
+        } else if (str == "--stats")
+        {
+            this->quiet = this->stats = true;
+        } else if (str == "--delta")
+        {
+            this->quiet = this->delta = true;
+        } else if (str == "--digest")
+        {
+            this->quiet = this->digest = true;
+        } else if (str == "--verify" && i + 1 < argc)
+        {
+            this->quiet = this->digest = true;
+            this->verifyPath = argv[++i];
+        } else if (str == "--every" && i + 1 < argc)
+        {
+            std::stringstream(argv[++i]) >> this->every;
+        } else if (str == "--threads" && i + 1 < argc)
+        {
+            std::stringstream(argv[++i]) >> this->threads;
+        } else if (str == "--lanes")
+        {
+            this->lanes = true;
+        } else if (str == "--ensemble")
+        {
+            this->ensemble = true;
+        } else if (str == "--cycles")
+        {
+            this->cycles = true;
+        } else if (str == "--profile" && i + 1 < argc)
+        {
+            this->profilePath = argv[++i];
+        } else if (str == "--save" && i + 1 < argc)
+        {
+            this->savePath = argv[++i];
+        } else if (str == "--large")
+        {
+            // Lift the limits of world_type.h: any number of species,
+            // instructions and creatures, and grids up to LARGE_MAXSIZE
+            this->limited = false;
         }
     }
+    if (this->quiet)
+    {
+        // Report only every few rounds, or only at the end by default;
+        // digests are of every round by default
+        this->verbose = false;
+        if (this->every <= 0) this->every = this->digest ? 1 : this->round_max;
+        this->buffer.reserve(BUFFER_SIZE);
+    }
+}
+
+/**
+ * @version 3.0 Added
+ * @param path
+ * @param content set to the whole file
+ * @return whether the file could be opened
+ */
+static bool readFile(const std::string &path, std::string &content)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open())
+    {
+        return false;
+    }
+    char chunk[1 << 16];
+    while (file.read(chunk, sizeof(chunk)) || file.gcount() > 0)
+    {
+        content.append(chunk, size_t(file.gcount()));
+    }
+    return true;
+}
+
+static inline bool isBlank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+/**
+ * @version 3.0 Added
+ * Skips the blanks at p and reads the token after them, as operator>> does
+ * @param p moved past the token
+ * @param end
+ * @param token set to the start of the token
+ * @return the size of the token, 0 if there is none before end
+ */
+static size_t nextToken(const char *&p, const char *end, const char *&token)
+{
+    while (p < end && isBlank(*p)) p++;
+    token = p;
+    while (p < end && !isBlank(*p)) p++;
+    return size_t(p - token);
+}
+
+/**
+ * @version 3.0 Added
+ * @param token
+ * @param size
+ * @return the integer at the start of the token, saturated to the range of
+ * int, or 0 if it does not start with one, as operator>> does
+ */
+static int toInt(const char *token, size_t size)
+{
+    const char *p = token, *end = token + size;
+    bool negative = p < end && *p == '-';
+    if (p < end && (*p == '-' || *p == '+')) p++;
+    long long value = 0;
+    for (; p < end && *p >= '0' && *p <= '9'; p++)
+    {
+        value = std::min(value * 10 + (*p - '0'), (long long) INT_MAX + 1);
+    }
+    if (negative) value = -value;
+    return int(std::max(std::min(value, (long long) INT_MAX), (long long) INT_MIN));
 }
 
+/**
+ * @version 3.0 Read each file as a whole and tokenize it in place
+ * @throws FailureFileException
+ * @throws TooManySpeciesException
+ * @throws TooManyInstructionException
+ * @throws UnknownInstructionException
+ * @param speciesPath
+ */
 void Controller::readSpecies(const std::string &speciesPath)
 {
     // Open the species summary file
-    std::ifstream speciesSummary(speciesPath);
-    std::string speciesDirectory;
-    if (!speciesSummary.is_open())
+    std::string summary;
+    if (!readFile(speciesPath, summary))
     {
         throw FailureFileException(speciesPath);
     }
-    speciesSummary >> speciesDirectory;
-    while (!speciesSummary.eof())
+    const char *p = summary.data(), *end = p + summary.size(), *token;
+    auto size = nextToken(p, end, token);
+    std::string speciesDirectory(token, size);
+    while ((size = nextToken(p, end, token)) > 0)
     {
         // Open the files in the species directory
-        std::string speciesName;
-        speciesSummary >> speciesName;
-        if (speciesName.empty()) continue;
+        std::string speciesName(token, size);
         std::string speciesFullPath = speciesDirectory;
         speciesFullPath += "/" + speciesName;
-        std::ifstream speciesFile(speciesFullPath);
-        if (!speciesFile.is_open())
+        std::string program;
+        if (!readFile(speciesFullPath, program))
         {
             throw FailureFileException(speciesFullPath);
         }
 
         // Examine the number of current species before adding a new one
-        if (this->world->getSpeciesNum() >= MAXSPECIES)
+        if (this->limited && this->world->getSpeciesNum() >= MAXSPECIES)
         {
             throw TooManySpeciesException();
         }
 
-        // Create the species
-        auto species = this->world->addSpecies(new Species(speciesName));
-        std::stringstream ss;
-        while (!speciesFile.eof())
+        // Create the species from the lines of the program, up to the
+        // first blank one
+        auto species = this->world->addSpecies(new Species(speciesName, this->limited ? MAXPROGRAM : 0));
+        const char *line = program.data(), *programEnd = line + program.size();
+        while (line < programEnd)
         {
-            std::string optionLine, optionStr;
-            int optionAddress = 0;
-            std::getline(speciesFile, optionLine);
-            ss.clear();
-            ss.str(optionLine);
-            if (!ss.eof()) ss >> optionStr;
-            if (optionStr.empty()) break;
-            if (!ss.eof()) ss >> optionAddress;
-
-            species->addInstruction(optionStr, optionAddress);
-
+            auto eol = (const char *) memchr(line, '\n', size_t(programEnd - line));
+            if (eol == NULL) eol = programEnd;
+            const char *q = line, *option, *address;
+            auto optionSize = nextToken(q, eol, option);
+            if (optionSize == 0) break;
+            auto addressSize = nextToken(q, eol, address);
+            species->addInstruction(std::string(option, optionSize), toInt(address, addressSize));
+            line = eol < programEnd ? eol + 1 : programEnd;
+        }
+        species->compile();
+        auto endless = species->findEndlessLoop();
+        if (endless)
+        {
+            // Not fatal: such a turn is cut short by the step budget
+            std::cerr << "Warning: Species " << speciesName << " can loop forever from instruction "
+                      << endless << "!" << std::endl;
         }
-        speciesFile.close();
     }
-    speciesSummary.close();
 }
 
 /**
  * @version 2.0 Add terrains and abilities
+ * @version 3.0 Enforce the limits of world_type.h only if limited
+ * @version 3.0 Restore the world and the round from a snapshot
+ * @version 3.0 Read the file as a whole and tokenize it in place
+ * @version 3.0 Read terrain and abilities only if the world has them
  * @throws FailureFileException
+ * @throws InvalidSnapshotException
  * @throws IllegalHeightException
  * @throws IllegalWidthException
  * @throws TooManyCreatureException
@@ -94,61 +243,100 @@ void Controller::readSpecies(const std::string &speciesPath)
  */
 void Controller::readWorld(const std::string &worldPath)
 {
-    std::ifstream worldFile(worldPath);
-    if (!worldFile.is_open())
+    if (World::isSnapshot(worldPath))
+    {
+        this->round = this->world->loadSnapshot(worldPath);
+        auto grid = this->world->getGrid();
+        if (this->limited && grid->getHeight() > MAXHEIGHT)
+        {
+            throw IllegalHeightException();
+        }
+        if (this->limited && grid->getWidth() > MAXWIDTH)
+        {
+            throw IllegalWidthException();
+        }
+        if (this->limited && this->world->getCreatureNum() > MAXCREATURES)
+        {
+            throw TooManyCreatureException();
+        }
+        for (unsigned int i = 0; i < this->world->getCreatureNum(); i++)
+        {
+            auto creature = this->world->getCreature(i);
+            if (creature->isTerrain(LAKE) && !creature->hasAbility(FLY))
+            {
+                throw CannotFlyException(creature);
+            }
+        }
+        return;
+    }
+
+    std::string content;
+    if (!readFile(worldPath, content))
     {
         throw FailureFileException(worldPath);
     }
+    const char *p = content.data(), *end = p + content.size(), *token;
 
     // Read height and width
-    int height = 0, width = 0;
-    worldFile >> height >> width;
-    if (height <= 0 || height > MAXHEIGHT)
+    auto size = nextToken(p, end, token);
+    int height = toInt(token, size);
+    size = nextToken(p, end, token);
+    int width = toInt(token, size);
+    if (height <= 0 || unsigned(height) > (this->limited ? MAXHEIGHT : LARGE_MAXSIZE))
     {
         throw IllegalHeightException();
     }
-    if (width <= 0 || width > MAXWIDTH)
+    if (width <= 0 || unsigned(width) > (this->limited ? MAXWIDTH : LARGE_MAXSIZE))
     {
         throw IllegalWidthException();
     }
     this->world->getGrid()->setSize((unsigned) height, (unsigned) width);
 
-    // Read the terrain of each box, assuming that the format is correct
-    for (int i = 0; i < height; i++)
+    // Read the terrain of each box, the next character that is not blank
+    for (int i = 0; features_t::TERRAIN && i < height; i++)
     {
         for (int j = 0; j < width; j++)
         {
-            char terrain;
-            worldFile >> terrain;
+            while (p < end && isBlank(*p)) p++;
+            char terrain = p < end ? *p++ : '\0';
             this->world->getGrid()->setTerrain(point_t{i, j}, terrain);
         }
     }
 
-    // Read creatures
-    std::stringstream ss;
-    while (!worldFile.eof())
+    // Read creatures, counting the lines that are not blank first so that
+    // their storage is allocated once
+    std::vector<std::pair<const char *, const char *> > worldLines;
+    while (p < end)
     {
-        std::string worldLine;
-        getline(worldFile, worldLine);
-        if (worldLine.empty())continue;
-        if (this->world->getCreatureNum() >= MAXCREATURES)
+        auto eol = (const char *) memchr(p, '\n', size_t(end - p));
+        if (eol == NULL) eol = end;
+        auto q = p;
+        while (q < eol && isBlank(*q)) q++;
+        if (q < eol) worldLines.push_back(std::make_pair(p, eol));
+        p = eol < end ? eol + 1 : end;
+    }
+    this->world->reserveCreatures(worldLines.size());
+    for (const auto &worldLine : worldLines)
+    {
+        if (this->limited && this->world->getCreatureNum() >= MAXCREATURES)
         {
             throw TooManyCreatureException();
         }
-        ss.clear();
-        ss.str(worldLine);
-        std::string name, direction;
-        int row, column;
-        ss >> name >> direction >> row >> column;
+        const char *q = worldLine.first, *lineEnd = worldLine.second;
+        size = nextToken(q, lineEnd, token);
+        std::string name(token, size);
+        size = nextToken(q, lineEnd, token);
+        std::string direction(token, size);
+        size = nextToken(q, lineEnd, token);
+        int row = toInt(token, size);
+        size = nextToken(q, lineEnd, token);
+        int column = toInt(token, size);
 
-        auto creature = new Creature(this->world, name, direction, row, column);
-        this->world->addCreature(creature);
+        auto creature = this->world->addCreature(name, direction, row, column);
 
-        std::string ability;
-        while (!ss.eof())
+        while (features_t::ABILITIES && (size = nextToken(q, lineEnd, token)) > 0)
         {
-            ss >> ability;
-            if (ability.length() > 0) creature->addAbility(ability);
+            creature->addAbility(std::string(token, size));
         }
 
         if (creature->isTerrain(LAKE) && !creature->hasAbility(FLY))
@@ -158,69 +346,542 @@ void Controller::readWorld(const std::string &worldPath)
     }
 }
 
-void Controller::creatureMove(Creature *creature)
+/**
+ * @version 3.0 Run the compiled program in a loop instead of recursing
+ * @version 3.0 Give up on a turn that cannot end
+ * @version 3.0 Count the instructions run in profile, if any
+ * @param creature
+ * @param profile
+ */
+void Controller::creatureMove(Creature *creature, RoundProfile *profile)
 {
+    // Only an ending instruction can change a species, so the code stays
+    // the same for the whole turn
     auto species = creature->getSpecies();
-    auto programID = creature->getProgramID();
-    auto instruction = species->getInstruction(programID);
-    switch (instruction.op)
-    {
-        case HOP:
-            creature->hop();
-            break;
-        case LEFT:
-            creature->left();
-            break;
-        case RIGHT:
-            creature->right();
-            break;
-        case INFECT:
-            creature->infect();
-            break;
-        case IFEMPTY:
-            creature->ifempty(instruction.address);
-            break;
-        case IFENEMY:
-            creature->ifenemy(instruction.address);
-            break;
-        case IFSAME:
-            creature->ifsame(instruction.address);
-            break;
-        case IFWALL:
-            creature->ifwall(instruction.address);
-            break;
-        case GO:
-            creature->go(instruction.address);
-            break;
-        default:
-            break;
-    }
-    if (this->verbose)
-    {
-        std::cout << std::endl << "Instruction " << programID + 1 << ":";
-    }
-    if (Species::isEndOption(instruction.op))
-    {
-        std::cout << " " << Species::getOptionName(instruction.op);
-    } else
+    auto code = species->getCode();
+    auto size = species->getProgramSize();
+    // Nothing changes before the ending instruction, so a turn that has
+    // run more instructions than the program holds has come back to one
+    // and would loop forever
+    for (unsigned int steps = 0; ; steps++)
     {
+        auto programID = creature->getProgramID();
+        if (programID >= size || steps > size)
+        {
+            if (!this->quiet)
+            {
+                std::cout << " (no action)";
+            }
+            return;
+        }
+        const auto &instruction = code[programID];
+        bool ending = profile == NULL ? instruction.handler(creature, instruction.address)
+                                      : this->profileInstruction(creature, instruction, *profile);
+        if (this->verbose)
+        {
+            std::cout << std::endl << "Instruction " << programID + 1 << ":";
+        }
+        if (ending)
+        {
+            if (!this->quiet)
+            {
+                std::cout << " " << Species::getOptionName(instruction.op);
+            }
+            return;
+        }
         if (this->verbose)
         {
             std::cout << " " << Species::getOptionName(instruction.op) << " " << instruction.address + 1;
         }
-        creatureMove(creature);
     }
 }
 
+/**
+ * @version 3.0 Added
+ * Runs one instruction of a creature, as its handler would, and counts it
+ * @param creature
+ * @param instruction
+ * @param profile
+ * @return whether the instruction ends the turn
+ */
+bool Controller::profileInstruction(Creature *creature, const Species::compiled_t &instruction,
+                                    RoundProfile &profile)
+{
+    profile.instructions[instruction.op]++;
+    profile.species[creature->getSpeciesIndex()]++;
+    if (instruction.op == INFECT)
+    {
+        if (creature->infect()) profile.infections++;
+        return true;
+    }
+    return instruction.handler(creature, instruction.address);
+}
+
+/**
+ * @version 3.0 Added
+ * Gives the creature its turn of a quiet round
+ * @param creature
+ * @param profile where to count the turn, if any
+ */
+void Controller::creatureTurn(Creature *creature, RoundProfile *profile)
+{
+    if (creature->stayHill())
+    {
+        if (profile != NULL) profile->hillSkips++;
+        return;
+    }
+    if (profile != NULL) profile->turns++;
+    this->creatureMove(creature, profile);
+    if (creature->isTerrain(HILL) && !creature->hasAbility(FLY))
+    {
+        creature->enterHill();
+    }
+}
+
+/**
+ * @version 3.0 Added
+ * @param i a creature
+ * @return the representative of the creatures whose turns touch the same
+ * squares as creature i's, directly or through others
+ */
+unsigned int Controller::findSet(unsigned int i)
+{
+    while (this->parent[i] != i)
+    {
+        i = this->parent[i] = this->parent[this->parent[i]];
+    }
+    return i;
+}
+
+/**
+ * @version 3.0 Added
+ * Runs a quiet round on several threads with the same result as running
+ * the creatures in order.
+ *
+ * A creature's turn reads and writes only its own square and the squares
+ * ahead of it: the one in front, or the whole line for an archer. Nobody
+ * else moves or turns it, so these are known when the round starts.
+ * Creatures whose squares overlap, directly or through others, form a
+ * set whose turns must keep their order; different sets are independent.
+ * The grid is cut into bands of rows, each starting at a multiple of 64
+ * squares so that bands never share a word of the bitmaps. A set that
+ * lies within one band runs on that band's thread, in creature order.
+ * The sets that cross bands run afterwards, one at a time in creature
+ * order. The tiles of the squares touched are allocated beforehand, as
+ * bands may share a tile.
+ */
+void Controller::simulateRoundParallel()
+{
+    TRACE_SCOPE("simulateRoundParallel");
+    auto grid = this->world->getGrid();
+    unsigned int height = grid->getHeight(), width = grid->getWidth();
+    unsigned int num = this->world->getCreatureNum();
+
+    unsigned int a = width, b = 64;
+    while (b != 0)
+    {
+        auto t = a % b;
+        a = b;
+        b = t;
+    }
+    unsigned int step = 64 / a;     // Rows per 64 aligned squares
+    unsigned int band = (height + this->threads - 1) / this->threads;
+    band = std::max(step, (band + step - 1) / step * step);
+    unsigned int tiles = (height + band - 1) / band;
+    if (tiles <= 1)
+    {
+        for (unsigned int i = 0; i < num; i++)
+        {
+            this->creatureTurn(this->world->getCreature(i), this->profilePath.empty() ? NULL : &this->profile);
+        }
+        return;
+    }
+
+    const unsigned int NONE = ~0u, MIXED = ~0u - 1;
+    if (this->claims.size() != size_t(height) * width)
+    {
+        this->claims.assign(size_t(height) * width, NONE);
+        for (unsigned int i = 0; i < this->world->getSpeciesNum(); i++)
+        {
+            grid->addSpecies(this->world->getSpecies(i));
+        }
+    }
+    this->parent.resize(num);
+    std::vector<unsigned int> home(num), touched;
+    for (unsigned int i = 0; i < num; i++)
+    {
+        this->parent[i] = i;
+    }
+    for (unsigned int i = 0; i < num; i++)
+    {
+        auto creature = this->world->getCreature(i);
+        auto p = creature->getLocation();
+        home[i] = p.r / band;
+        while (true)
+        {
+            auto cell = unsigned(p.r) * width + p.c;
+            if (unsigned(p.r) / band != home[i]) home[i] = MIXED;
+            grid->reserveSquare(p);
+            if (this->claims[cell] == NONE)
+            {
+                this->claims[cell] = i;
+                touched.push_back(cell);
+            } else
+            {
+                this->parent[this->findSet(i)] = this->findSet(this->claims[cell]);
+            }
+            auto next = creature->getForwardLocation(p);
+            if (!creature->isInside(next)) break;
+            bool first = p == creature->getLocation();
+            p = next;
+            if (!first && !creature->hasAbility(ARCH)) break;
+        }
+    }
+    for (auto cell : touched)
+    {
+        this->claims[cell] = NONE;
+    }
+
+    // A set runs on a band's thread only if all of it is in that band
+    std::vector<unsigned int> setHome(num, NONE);
+    for (unsigned int i = 0; i < num; i++)
+    {
+        auto &h = setHome[this->findSet(i)];
+        h = h == NONE || h == home[i] ? home[i] : MIXED;
+    }
+    std::vector<std::vector<unsigned int> > local(tiles);
+    std::vector<unsigned int> crossing;
+    for (unsigned int i = 0; i < num; i++)
+    {
+        auto h = setHome[this->findSet(i)];
+        (h == MIXED ? crossing : local[h]).push_back(i);
+    }
+
+    // Every thread counts into its own profile, added up at the end
+    bool profiling = !this->profilePath.empty();
+    std::vector<RoundProfile> profiles(profiling ? tiles : 0);
+    for (auto &profile : profiles)
+    {
+        profile.clear(this->world->getSpeciesNum());
+    }
+    auto run = [this](const std::vector<unsigned int> &list, RoundProfile *profile)
+    {
+        for (auto i : list)
+        {
+            this->creatureTurn(this->world->getCreature(i), profile);
+        }
+    };
+    std::vector<std::thread> pool;
+    for (unsigned int t = 1; t < tiles; t++)
+    {
+        pool.push_back(std::thread(run, std::cref(local[t]), profiling ? &profiles[t] : NULL));
+    }
+    run(local[0], profiling ? &profiles[0] : NULL);
+    for (auto &thread : pool)
+    {
+        thread.join();
+    }
+    run(crossing, profiling ? &profiles[0] : NULL);
+    for (const auto &profile : profiles)
+    {
+        this->profile.add(profile);
+    }
+}
+
+/**
+ * @version 3.0 Added
+ * Finds the creatures that touch, in their turns, no square that another
+ * creature touches: squares as in simulateRoundParallel, so that such a
+ * creature does the same whenever in the round it takes its turn. Counts
+ * how many creatures aim at each square ahead of them; a creature is alone
+ * if none aims at its square and nothing else is on, or aims at, a square
+ * it aims at. Keeps the square of each creature in cells.
+ * @param alone set to whether each creature is alone
+ */
+void Controller::findLoners(std::vector<unsigned char> &alone)
+{
+    auto grid = this->world->getGrid();
+    auto &table = this->world->getTable();
+    unsigned int num = this->world->getCreatureNum();
+    size_t squares = size_t(grid->getHeight()) * grid->getWidth();
+    this->aims.assign(squares, 0);
+    this->cells.resize(num);
+    alone.assign(num, 1);
+    for (unsigned int i = 0; i < num; i++)
+    {
+        auto direction = direction_t(table.direction[i]);
+        bool archer = features_t::ABILITIES && (table.flags[i] & CreatureTable::FLAG_ARCH);
+        this->cells[i] = grid->getIndex(point_t{table.row[i], table.column[i]});
+        for (auto next = grid->getForwardIndex(this->cells[i], direction); next != Grid::WALL;
+             next = grid->getForwardIndex(next, direction))
+        {
+            if (this->aims[next] < 2) this->aims[next]++;
+            if (!archer) break;
+        }
+    }
+    for (unsigned int i = 0; i < num; i++)
+    {
+        auto direction = direction_t(table.direction[i]);
+        bool archer = features_t::ABILITIES && (table.flags[i] & CreatureTable::FLAG_ARCH);
+        if (this->aims[this->cells[i]] > 0) alone[i] = 0;
+        for (auto next = grid->getForwardIndex(this->cells[i], direction); next != Grid::WALL && alone[i];
+             next = grid->getForwardIndex(next, direction))
+        {
+            if (this->aims[next] > 1 || grid->isOccupied(next)) alone[i] = 0;
+            if (!archer) break;
+        }
+    }
+}
+
+/**
+ * @version 3.0 Added
+ * @param size the number of lanes
+ */
+void LaneTable::resize(unsigned int size)
+{
+    this->id.resize(size);
+    this->cell.resize(size);
+    this->steps.resize(size);
+    this->direction.resize(size);
+    this->fly.resize(size);
+}
+
+/**
+ * @version 3.0 Added
+ * Runs the turns of the creatures in laneTable, all of one species, as
+ * creatureMove would. Each lane waits at the instruction of its program
+ * counter. The instruction then runs for all the lanes waiting at it, so
+ * that it is decoded once for them and a test runs over them in one loop,
+ * and each lane moves on to wait at the next instruction it runs. The
+ * lanes are alone, so they need not keep in step with each other. An
+ * ending instruction runs creature by creature and retires the lane, as
+ * does a turn that runs off the program or more steps than the program
+ * holds. The program counter of a retired lane goes back to the table.
+ * @param species the index of the species
+ * @param profile where to count the instructions, if any
+ */
+void Controller::runLanes(unsigned int species, RoundProfile *profile)
+{
+    auto grid = this->world->getGrid();
+    auto &table = this->world->getTable();
+    auto code = this->world->getSpecies(species)->getCode();
+    auto size = this->world->getSpecies(species)->getProgramSize();
+    auto &lanes = this->laneTable;
+    auto &waiting = this->laneQueues;
+    if (waiting.size() < size)
+    {
+        waiting.resize(size);
+    }
+
+    // Move lane k to wait at instruction pc, or retire it if its turn ends
+    // there without an action
+    auto moveLane = [&](unsigned int k, unsigned int pc)
+    {
+        if (pc >= size || lanes.steps[k] > size)
+        {
+            table.programID[lanes.id[k]] = pc;
+            return;
+        }
+        waiting[pc].push_back(k);
+    };
+    for (unsigned int k = 0; k < lanes.id.size(); k++)
+    {
+        lanes.steps[k] = 0;
+        moveLane(k, table.programID[lanes.id[k]]);
+    }
+
+    // Sweep the instructions in order until no lane is left waiting; only a
+    // jump backwards needs another sweep
+    auto &batch = this->laneBatch;
+    for (bool more = true; more;)
+    {
+        more = false;
+        for (unsigned int pc = 0; pc < size; pc++)
+        {
+            if (waiting[pc].empty()) continue;
+            batch.swap(waiting[pc]);
+            waiting[pc].clear();
+            const auto &instruction = code[pc];
+            unsigned int address = instruction.address;
+            auto n = (unsigned int) batch.size();
+            if (profile != NULL && !Species::isEndOption(instruction.op))
+            {
+                profile->instructions[instruction.op] += n;
+                profile->species[species] += n;
+            }
+            more = more || (!Species::isEndOption(instruction.op) && address <= pc);
+            switch (instruction.op)
+            {
+                case GO:
+                    for (auto k : batch)
+                    {
+                        lanes.steps[k]++;
+                        moveLane(k, address);
+                    }
+                    break;
+                case IFEMPTY:
+                    for (auto k : batch)
+                    {
+                        auto next = grid->getForwardIndex(lanes.cell[k], direction_t(lanes.direction[k]));
+                        lanes.steps[k]++;
+                        moveLane(k, grid->isEmpty(next) ? address : pc + 1);
+                    }
+                    break;
+                case IFWALL:
+                    for (auto k : batch)
+                    {
+                        auto next = grid->getForwardIndex(lanes.cell[k], direction_t(lanes.direction[k]));
+                        bool wall = next == Grid::WALL || (!lanes.fly[k] && grid->isTerrain(next, LAKE));
+                        lanes.steps[k]++;
+                        moveLane(k, wall ? address : pc + 1);
+                    }
+                    break;
+                case IFSAME:
+                    for (auto k : batch)
+                    {
+                        auto next = grid->getForwardIndex(lanes.cell[k], direction_t(lanes.direction[k]));
+                        bool same = grid->isSpecies(next, species) && !grid->isTerrain(next, FOREST);
+                        lanes.steps[k]++;
+                        moveLane(k, same ? address : pc + 1);
+                    }
+                    break;
+                case IFENEMY:
+                    for (auto k : batch)
+                    {
+                        auto next = grid->getForwardIndex(lanes.cell[k], direction_t(lanes.direction[k]));
+                        bool enemy = grid->isOccupied(next) && !grid->isSpecies(next, species) &&
+                                     !grid->isTerrain(next, FOREST);
+                        lanes.steps[k]++;
+                        moveLane(k, enemy ? address : pc + 1);
+                    }
+                    break;
+                default:
+                    for (auto k : batch)
+                    {
+                        auto creature = this->world->getCreature(lanes.id[k]);
+                        table.programID[lanes.id[k]] = pc;
+                        if (profile == NULL) instruction.handler(creature, address);
+                        else this->profileInstruction(creature, instruction, *profile);
+                    }
+                    break;
+            }
+        }
+    }
+}
+
+/**
+ * @version 3.0 Added
+ * Runs a quiet round with the same result as running the creatures in
+ * order, but runs the creatures of a species together, instruction by
+ * instruction, in lanes (see runLanes).
+ *
+ * The creatures alone (see findLoners) run in lanes, a species at a time.
+ * The others keep their order and run afterwards, one at a time.
+ */
+void Controller::simulateRoundLanes()
+{
+    TRACE_SCOPE("simulateRoundLanes");
+    auto &table = this->world->getTable();
+    unsigned int num = this->world->getCreatureNum();
+    auto profile = this->profilePath.empty() ? NULL : &this->profile;
+    auto &alone = this->alone;
+    this->findLoners(alone);
+
+    // A creature alone runs in lanes, unless it stays on a hill
+    auto &ordered = this->ordered;
+    auto &bySpecies = this->bySpecies;
+    ordered.clear();
+    bySpecies.resize(this->world->getSpeciesNum());
+    for (auto &ids : bySpecies)
+    {
+        ids.clear();
+    }
+    for (unsigned int i = 0; i < num; i++)
+    {
+        if (!alone[i])
+        {
+            ordered.push_back(i);
+            continue;
+        }
+        auto creature = this->world->getCreature(i);
+        if (creature->stayHill())
+        {
+            if (profile != NULL) profile->hillSkips++;
+            continue;
+        }
+        if (profile != NULL) profile->turns++;
+        bySpecies[creature->getSpeciesIndex()].push_back(i);
+    }
+    for (unsigned int s = 0; s < bySpecies.size(); s++)
+    {
+        const auto &ids = bySpecies[s];
+        if (ids.empty()) continue;
+        auto &lanes = this->laneTable;
+        lanes.resize((unsigned int) ids.size());
+        for (unsigned int k = 0; k < ids.size(); k++)
+        {
+            lanes.id[k] = ids[k];
+            lanes.cell[k] = this->cells[ids[k]];
+            lanes.direction[k] = table.direction[ids[k]];
+            lanes.fly[k] = features_t::ABILITIES && (table.flags[ids[k]] & CreatureTable::FLAG_FLY);
+        }
+        this->runLanes(s, profile);
+        for (unsigned int k = 0; k < ids.size(); k++)
+        {
+            auto creature = this->world->getCreature(ids[k]);
+            if (!lanes.fly[k] && creature->isTerrain(HILL))
+            {
+                creature->enterHill();
+            }
+        }
+    }
+    for (auto i : ordered)
+    {
+        this->creatureTurn(this->world->getCreature(i), profile);
+    }
+}
+
+/**
+ * @version 3.0 Print nothing when quiet
+ * @version 3.0 Count into the profile with --profile
+ * @version 3.0 Traced with ECE2800J_TRACE
+ * @version 3.0 Run in lanes with --lanes
+ */
 void Controller::simulateRound()
 {
+    TRACE_SCOPE("simulateRound");
+    TRACE_COUNTER("creatures", this->world->getCreatureNum());
+    auto profile = this->profilePath.empty() ? NULL : &this->profile;
+    if (this->quiet)
+    {
+        if (this->threads > 1)
+        {
+            this->simulateRoundParallel();
+            return;
+        }
+        if (this->lanes)
+        {
+            this->simulateRoundLanes();
+            return;
+        }
+        for (unsigned int i = 0; i < this->world->getCreatureNum(); i++)
+        {
+            this->creatureTurn(this->world->getCreature(i), profile);
+        }
+        return;
+    }
     std::cout << "Round " << (this->round + 1) << std::endl;
     for (unsigned int i = 0; i < this->world->getCreatureNum(); i++)
     {
         auto creature = this->world->getCreature(i);
-        if (creature->stayHill()) continue;
+        if (creature->stayHill())
+        {
+            if (profile != NULL) profile->hillSkips++;
+            continue;
+        }
+        if (profile != NULL) profile->turns++;
         std::cout << "Creature (" << creature->serialize() << ") takes action:";
-        this->creatureMove(creature);
+        this->creatureMove(creature, profile);
         std::cout << std::endl;
         if (this->verbose) std::cout << this->world->getGrid()->serialize();
         if (creature->isTerrain(HILL) && !creature->hasAbility(FLY))
@@ -231,12 +892,398 @@ void Controller::simulateRound()
     if (!this->verbose) std::cout << this->world->getGrid()->serialize();
 }
 
+/**
+ * @version 3.0 Added
+ * @version 3.0 Report only the squares changed with --delta
+ * @param title the line before the report
+ * @param whole whether to report the whole grid even with --delta
+ * Appends the grid, the squares changed since the last report, or the
+ * number of creatures of every species, to the buffer
+ */
+void Controller::report(const std::string &title, bool whole)
+{
+    if (this->digest)
+    {
+        this->reportDigest(title);
+        return;
+    }
+    this->buffer += title;
+    this->buffer += '\n';
+    if (this->stats)
+    {
+        for (unsigned int i = 0; i < this->world->getSpeciesNum(); i++)
+        {
+            auto species = this->world->getSpecies(i);
+            this->buffer += species->getName();
+            this->buffer += ": ";
+            this->buffer += std::to_string(this->world->getGrid()->count(species));
+            this->buffer += '\n';
+        }
+    } else if (this->delta && !whole)
+    {
+        this->world->getGrid()->serializeChanges(this->buffer);
+    } else
+    {
+        this->world->getGrid()->serialize(this->buffer);
+    }
+    if (this->buffer.size() >= BUFFER_SIZE) this->flush();
+}
+
+/**
+ * @version 3.0 Added
+ * Appends "<title> <digest>" to the buffer, the digest in hexadecimal, or
+ * with --verify checks it against the next line of the digest file
+ * @throws FailureFileException
+ * @throws DigestMismatchException
+ * @param title
+ */
+void Controller::reportDigest(const std::string &title)
+{
+    // Each digest covers the ones before, so that one line that matches
+    // vouches for the whole run up to it
+    uint64_t digest = this->world->digest() ^ this->lastDigest;
+    digest *= 0x9E3779B97F4A7C15ULL;
+    this->lastDigest = digest ^ (digest >> 29);
+    char hex[17];
+    snprintf(hex, sizeof(hex), "%016llx", (unsigned long long) this->lastDigest);
+    std::string line = title + " " + hex;
+    if (this->verifyPath.empty())
+    {
+        this->buffer += line;
+        this->buffer += '\n';
+        if (this->buffer.size() >= BUFFER_SIZE) this->flush();
+        return;
+    }
+    if (this->golden.empty() && this->verified == 0)
+    {
+        std::ifstream file(this->verifyPath);
+        if (!file.is_open())
+        {
+            throw FailureFileException(this->verifyPath);
+        }
+        std::string goldenLine;
+        while (std::getline(file, goldenLine))
+        {
+            if (!goldenLine.empty()) this->golden.push_back(goldenLine);
+        }
+    }
+    if (this->verified >= this->golden.size() || this->golden[this->verified] != line)
+    {
+        throw DigestMismatchException(title, this->verifyPath);
+    }
+    this->verified++;
+}
+
+/**
+ * @version 3.0 Added
+ * Writes out the buffer
+ */
+void Controller::flush()
+{
+    std::cout.write(this->buffer.data(), this->buffer.size());
+    this->buffer.clear();
+}
+
+/**
+ * @version 3.0 Report every few rounds only when quiet
+ * @version 3.0 Continue from the round of a snapshot, and save one at the
+ * end with --save
+ * @version 3.0 Check every digest of the file of --verify was matched
+ * @version 3.0 Skip the periods of a cycle with --cycles
+ * @throws DigestMismatchException
+ */
 void Controller::simulate()
 {
-    std::cout << "Initial state" << std::endl;
-    std::cout << this->world->getGrid()->serialize();
-    for (this->round = 0; this->round < this->round_max; this->round++)
+    int last = this->round + this->round_max;
+    if (this->quiet)
+    {
+        this->report("Initial state", true);
+        this->world->getGrid()->setTracking(this->delta && !this->stats);
+        // The changes of --delta and the rows of --profile are of every
+        // round, so none is skipped with them
+        bool cycles = this->cycles && !this->delta && this->profilePath.empty();
+        if (cycles)
+        {
+            this->findCycle(this->round);
+        }
+        for (; this->round < last; this->round++)
+        {
+            this->nextRound();
+            if (cycles && this->period == 0)
+            {
+                this->findCycle(this->round + 1);
+            }
+            if ((this->round + 1) % this->every == 0 || this->round + 1 == last)
+            {
+                this->report("Round " + std::to_string(this->round + 1));
+            }
+            if (this->period > 0)
+            {
+                // The state after a whole number of periods is this one,
+                // so those up to the next report are skipped and the
+                // rounds left over are simulated
+                long long done = this->round + 1;
+                long long next = std::min<long long>(last, (done / this->every + 1) * this->every);
+                this->round += int((next - 1 - done) / this->period * this->period);
+            }
+        }
+        if (!this->verifyPath.empty())
+        {
+            if (this->verified != this->golden.size())
+            {
+                throw DigestMismatchException("Round " + std::to_string(this->round + 1), this->verifyPath);
+            }
+            this->buffer += "Verified " + std::to_string(this->verified) + " digests\n";
+        }
+        this->flush();
+    } else
+    {
+        std::cout << "Initial state" << std::endl;
+        std::cout << this->world->getGrid()->serialize();
+        for (; this->round < last; this->round++)
+        {
+            this->nextRound();
+        }
+    }
+    if (!this->profilePath.empty())
+    {
+        this->writeProfile();
+    }
+    if (!this->savePath.empty())
+    {
+        this->world->saveSnapshot(this->savePath, this->round);
+    }
+}
+
+/**
+ * @version 3.0 Added
+ * @param numSpecies
+ * Sets every count to 0, with one count per species
+ */
+void RoundProfile::clear(unsigned int numSpecies)
+{
+    this->turns = this->hillSkips = this->infections = 0;
+    std::fill(this->instructions, this->instructions + OP_SIZE, 0);
+    this->species.assign(numSpecies, 0);
+}
+
+/**
+ * @version 3.0 Added
+ * @param profile counted with the same species
+ */
+void RoundProfile::add(const RoundProfile &profile)
+{
+    this->turns += profile.turns;
+    this->hillSkips += profile.hillSkips;
+    this->infections += profile.infections;
+    for (int i = 0; i < OP_SIZE; i++)
+    {
+        this->instructions[i] += profile.instructions[i];
+    }
+    for (size_t i = 0; i < this->species.size(); i++)
+    {
+        this->species[i] += profile.species[i];
+    }
+}
+
+/**
+ * @version 3.0 Added
+ * Simulates a round, and with --profile times it and keeps its counts as a
+ * line of CSV
+ */
+void Controller::nextRound()
+{
+    if (this->profilePath.empty())
     {
         this->simulateRound();
+        return;
+    }
+    this->profile.clear(this->world->getSpeciesNum());
+    auto start = std::chrono::steady_clock::now();
+    this->simulateRound();
+    std::chrono::duration<double, std::milli> wall = std::chrono::steady_clock::now() - start;
+
+    uint64_t instructions = 0;
+    for (auto count : this->profile.instructions)
+    {
+        instructions += count;
+    }
+    std::ostringstream row;
+    row << this->round + 1 << ',' << wall.count() << ',' << this->profile.turns << ','
+        << this->profile.hillSkips << ',' << instructions << ','
+        << (this->profile.turns ? double(instructions) / this->profile.turns : 0.0) << ','
+        << this->profile.infections;
+    for (auto count : this->profile.instructions)
+    {
+        row << ',' << count;
+    }
+    for (auto count : this->profile.species)
+    {
+        row << ',' << count;
+    }
+    row << '\n';
+    this->profileRows += row.str();
+}
+
+/**
+ * @version 3.0 Added
+ * @param done the number of rounds simulated so far
+ * Looks the state up among those seen after the earlier rounds. One seen
+ * before is kept, and compared with the state one period later, which
+ * sets the period if they are the same: two digests may collide, but two
+ * tables that are the same repeat forever, since a round only depends on
+ * the table.
+ */
+void Controller::findCycle(int done)
+{
+    auto &table = this->world->getTable();
+    if (this->cycleRound >= 0)
+    {
+        if (done < this->cycleRound + this->cycleLength)
+        {
+            return;
+        }
+        auto &kept = this->cycleState;
+        if (table.row == kept.row && table.column == kept.column && table.direction == kept.direction &&
+            table.species == kept.species && table.programID == kept.programID && table.flags == kept.flags)
+        {
+            this->period = this->cycleLength;
+            this->seenStates.clear();
+            this->cycleState = CreatureTable();
+            return;
+        }
+        this->cycleRound = -1;
+    }
+    uint64_t digest = this->world->digest();
+    auto seen = this->seenStates.find(digest);
+    if (seen != this->seenStates.end())
+    {
+        this->cycleRound = done;
+        this->cycleLength = done - seen->second;
+        this->cycleState = table;
+        return;
+    }
+    if (this->seenStates.size() >= CYCLE_WINDOW)
+    {
+        this->seenStates.clear();
+    }
+    this->seenStates[digest] = done;
+}
+
+/**
+ * @version 3.0 Added
+ * Writes the profile of every round as CSV, with a header line
+ * @throws FailureFileException
+ */
+void Controller::writeProfile() const
+{
+    std::ofstream file(this->profilePath);
+    if (!file.is_open())
+    {
+        throw FailureFileException(this->profilePath);
+    }
+    file << "round,wall_ms,turns,hill_skips,instructions,instructions_per_turn,infections";
+    for (const auto &name : opName)
+    {
+        file << ",op_" << name;
+    }
+    for (unsigned int i = 0; i < this->world->getSpeciesNum(); i++)
+    {
+        file << ",species_" << this->world->getSpecies(i)->getName();
+    }
+    file << '\n' << this->profileRows;
+    if (!file)
+    {
+        throw FailureFileException(this->profilePath);
+    }
+}
+
+bool Controller::isEnsemble() const
+{
+    return this->ensemble;
+}
+
+/**
+ * @version 3.0 Added
+ * Simulates one world of an ensemble with the options and the species of
+ * this controller, which are only read
+ * @param worldPath
+ * @return the population of every species after the last round, or the
+ * error that stopped the world
+ */
+std::string Controller::simulateMember(const std::string &worldPath) const
+{
+    Controller member(*this);
+    member.world = new World();
+    member.world->shareSpecies(*this->world);
+    member.quiet = member.stats = true;
+    member.delta = member.digest = false;
+    member.threads = 1;
+    member.buffer.clear();
+    member.profilePath.clear();
+    member.verifyPath.clear();
+    try
+    {
+        member.readWorld(worldPath);
+        for (int last = member.round + member.round_max; member.round < last; member.round++)
+        {
+            member.simulateRound();
+        }
+        member.report("World " + worldPath);
+    }
+    catch (MyException &e)
+    {
+        member.buffer = "World " + worldPath + "\n" + e.what() + "\n";
+    }
+    delete member.world;
+    return member.buffer;
+}
+
+/**
+ * @version 3.0 Added
+ * Simulates every world listed in a file, separated by blanks, on up to
+ * --threads threads. The species are read once and shared by all worlds.
+ * Prints the summary of each world, in the order of the list.
+ * @throws FailureFileException
+ * @param listPath
+ */
+void Controller::simulateEnsemble(const std::string &listPath)
+{
+    std::string list;
+    if (!readFile(listPath, list))
+    {
+        throw FailureFileException(listPath);
+    }
+    std::vector<std::string> worldPaths;
+    const char *p = list.data(), *end = p + list.size(), *token;
+    size_t size;
+    while ((size = nextToken(p, end, token)) > 0)
+    {
+        worldPaths.push_back(std::string(token, size));
+    }
+
+    std::vector<std::string> summaries(worldPaths.size());
+    std::atomic<size_t> next(0);
+    auto run = [&]()
+    {
+        for (size_t i; (i = next.fetch_add(1)) < worldPaths.size();)
+        {
+            summaries[i] = this->simulateMember(worldPaths[i]);
+        }
+    };
+    std::vector<std::thread> pool;
+    for (int t = 1; t < this->threads && size_t(t) < worldPaths.size(); t++)
+    {
+        pool.push_back(std::thread(run));
+    }
+    run();
+    for (auto &thread : pool)
+    {
+        thread.join();
+    }
+    for (const auto &summary : summaries)
+    {
+        std::cout << summary;
     }
+    std::cout.flush();
 }
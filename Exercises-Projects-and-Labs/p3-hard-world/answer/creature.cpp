@@ -7,9 +7,33 @@
 
 using namespace p3;
 
+inline unsigned int CreatureTable::size() const
+{
+    return (unsigned int) this->row.size();
+}
+
+/**
+ * @version 3.0 Added
+ * @param p
+ * @return the index of a new creature at p, facing east, with no species,
+ * abilities or hill state
+ */
+unsigned int CreatureTable::add(const point_t &p)
+{
+    this->row.push_back(p.r);
+    this->column.push_back(p.c);
+    this->direction.push_back(EAST);
+    this->species.push_back(0);
+    this->programID.push_back(0);
+    this->flags.push_back(0);
+    return this->size() - 1;
+}
+
 /**
  * The constructor of Creature
  * @version 2.0 Add the initialization of bool ability[ABILITY_SIZE] and bool hillActive;
+ * @version 3.0 Keep the state in the table of the world
+ * @version 3.0 Find the direction by findDirection
  * @throws UnknownSpeciesException
  * @throws UnknownDirectionException
  * @throws OutsideBoundaryException
@@ -23,48 +47,55 @@ using namespace p3;
 Creature::Creature(World *world, std::string name, std::string direction, int row, int column)
 {
     this->m_world = world;
-    this->programID = 0;
+    this->m_table = &world->getTable();
+    this->id = this->m_table->add(point_t{row, column});
 
     // Initialize the species of the creature
-    this->species = (species_t *) world->getSpecies(name);
-    if (this->species == NULL)
+    auto species = world->getSpecies(name);
+    if (species == NULL)
     {
         throw UnknownSpeciesException(name);
     }
+    this->table().species[this->id] = species->getIndex();
 
     // Set and judge the direction
-    bool flag = false;
-    for (auto direction_i = EAST; direction_i < length(directName); direction_i++)
+    direction_t direct;
+    if (!findDirection(direction.data(), direction.size(), direct))
     {
-        if (direction == directName[direction_i])
-        {
-            this->direction = direction_i;
-            flag = true;
-            break;
-        }
+        throw UnknownDirectionException(direction);
     }
-    if (!flag) throw UnknownDirectionException(direction);
+    this->table().direction[this->id] = (unsigned char) direct;
 
-    // Set and judge the location
-    this->location.r = row;
-    this->location.c = column;
+    // Judge the location
     if (!isInside()) throw OutsideBoundaryException(this);
 
     // Judge whether there is a creature at the location
-    auto origin = this->getWorld()->getCreature(this->location);
+    auto origin = this->getWorld()->getCreature(this->getLocation());
     if (origin != NULL) throw OverlapCreatureException(this, origin);
 
     // The creature don't have abilities and hill status in default
-    for (int i = 0; i < length(abilityShortName); i++)
-    {
-        this->ability[i] = false;
-    }
-    this->hillActive = false;
+}
+
+/**
+ * @version 3.0 Added
+ * @param world
+ * @param id a creature already in the table of the world
+ */
+Creature::Creature(World *world, unsigned int id)
+{
+    this->m_world = world;
+    this->m_table = &world->getTable();
+    this->id = id;
+}
+
+inline CreatureTable &Creature::table() const
+{
+    return *this->m_table;
 }
 
 inline unsigned int Creature::getProgramID() const
 {
-    return this->programID;
+    return this->table().programID[this->id];
 }
 
 /**
@@ -80,16 +111,56 @@ void Creature::addAbility(std::string ability)
     {
         if (abilityShortName[i] == ability)
         {
-            this->ability[i] = true;
+            this->table().flags[this->id] |= 1 << i;
             return;
         }
     }
     throw UnknownAbilityException(this, ability);
 }
 
+/**
+ * @version 3.0 Always false without abilities
+ * @param ability
+ * @return
+ */
 inline bool Creature::hasAbility(const ability_t &ability) const
 {
-    return this->ability[ability];
+    return features_t::ABILITIES && ((this->table().flags[this->id] >> ability) & 1);
+}
+
+static unsigned int hashDirection(const char *str, size_t size)
+{
+    return (unsigned char) str[0] + 2 * (unsigned char) str[size - 2] + size;
+}
+
+/**
+ * @version 3.0 Added
+ * Looks the name up by a hash that is perfect on directName: the first
+ * and the last but one characters and the length, modulo 8
+ * @param str
+ * @param size
+ * @param direction set to the direction named
+ * @return whether str is the name of a direction
+ */
+bool Creature::findDirection(const char *str, size_t size, direction_t &direction)
+{
+    static const std::vector<int> table = []()
+    {
+        std::vector<int> table(8, -1);
+        for (int i = 0; i < length(directName); i++)
+        {
+            table[hashDirection(directName[i].data(), directName[i].size()) % 8] = i;
+        }
+        return table;
+    }();
+    if (size < 2) return false;
+    int i = table[hashDirection(str, size) % 8];
+    if (i < 0 || directName[i].size() != size || directName[i].compare(0, size, str, size) != 0)
+    {
+        return false;
+    }
+    direction = direction_t(i);
+    return true;
 }
 
 inline const std::string &Creature::getDirectionName(const direction_t &direct, bool shortFlag)
@@ -99,23 +170,29 @@ inline const std::string &Creature::getDirectionName(const direction_t &direct,
 
 inline void Creature::changeSpecies(const Species *species)
 {
-    this->species = (species_t *) species;
-    this->programID = 0;
+    this->getWorld()->getGrid()->changeSpecies(this->getLocation(), this->getSpecies(), species);
+    this->table().species[this->id] = species->getIndex();
+    this->table().programID[this->id] = 0;
 }
 
 inline const Species *Creature::getSpecies() const
 {
-    return (Species *) this->species;
+    return this->m_world->getSpecies(this->table().species[this->id]);
+}
+
+inline unsigned int Creature::getSpeciesIndex() const
+{
+    return this->table().species[this->id];
 }
 
 inline direction_t Creature::getDirection() const
 {
-    return this->direction;
+    return direction_t(this->table().direction[this->id]);
 }
 
-inline const point_t &Creature::getLocation() const
+inline point_t Creature::getLocation() const
 {
-    return this->location;
+    return point_t{this->table().row[this->id], this->table().column[this->id]};
 }
 
 inline const World *Creature::getWorld() const
@@ -180,42 +257,68 @@ point_t Creature::getForwardLocation() const
     return this->getForwardLocation(this->getLocation());
 }
 
+/**
+ * @version 3.0 Added
+ * @return the index in the grid of the square ahead, or Grid::WALL
+ */
+inline unsigned int Creature::getForwardIndex() const
+{
+    auto grid = this->getWorld()->getGrid();
+    return grid->getForwardIndex(grid->getIndex(this->getLocation()), this->getDirection());
+}
+
 /**
  * @version 2.0 Add ability FLY and terrain LAKE
+ * @version 3.0 Test the occupancy bitmap
+ * @version 3.0 Test the square ahead by its index
  */
 void Creature::hop()
 {
-    auto p = this->getForwardLocation();
-    if (isInside(p) && this->getWorld()->getCreature(p) == NULL &&
-        (this->ability[FLY] || !this->isTerrain(p, LAKE)))
+    auto grid = this->getWorld()->getGrid();
+    auto next = this->getForwardIndex();
+    if (grid->isEmpty(next) && (this->hasAbility(FLY) || !grid->isTerrain(next, LAKE)))
     {
-        this->getWorld()->getGrid()->move(this->getLocation(), p);
-        this->location = p;
+        auto p = this->getForwardLocation();
+        grid->move(this->getLocation(), p, this->getSpeciesIndex());
+        this->table().row[this->id] = p.r;
+        this->table().column[this->id] = p.c;
     }
-    this->programID++;
+    this->table().programID[this->id]++;
 }
 
+/**
+ * @version 3.0 Record the change of the square shown
+ */
 void Creature::left()
 {
-    this->direction = direction_t(((((int) this->direction) - 1) + length(directName)) % length(directName));
-    this->programID++;
+    auto &direction = this->table().direction[this->id];
+    direction = (unsigned char) ((direction - 1 + length(directName)) % length(directName));
+    this->getWorld()->getGrid()->touch(this->getLocation());
+    this->table().programID[this->id]++;
 }
 
+/**
+ * @version 3.0 Record the change of the square shown
+ */
 void Creature::right()
 {
-    this->direction = direction_t((((int) this->direction) + 1) % length(directName));
-    this->programID++;
+    auto &direction = this->table().direction[this->id];
+    direction = (unsigned char) ((direction + 1) % length(directName));
+    this->getWorld()->getGrid()->touch(this->getLocation());
+    this->table().programID[this->id]++;
 }
 
 /**
  * @version 2.0 Add ability ARCH and terrain FOREST
+ * @version 3.0 Return whether a creature was infected
+ * @return
  */
-void Creature::infect()
+bool Creature::infect()
 {
     auto p = this->getForwardLocation();
     auto target = this->getWorld()->getCreature(p);
 
-    if (this->ability[ARCH])
+    if (this->hasAbility(ARCH))
     {
         while (target == NULL || target->getSpecies() == this->getSpecies())
         {
@@ -228,84 +331,89 @@ void Creature::infect()
         target = NULL;
     }
 
-    if (target != NULL)
+    bool infected = target != NULL && target->getSpeciesIndex() != this->getSpeciesIndex();
+    if (infected)
     {
-        if (target->getSpecies() != this->getSpecies())
-        {
-            target->changeSpecies(this->getSpecies());
-        }
+        target->changeSpecies(this->getSpecies());
     }
-    this->programID++;
+    this->table().programID[this->id]++;
+    return infected;
 }
 
 
+/**
+ * @version 3.0 Test the occupancy bitmap
+ * @version 3.0 Test the square ahead by its index
+ * @param address
+ */
 void Creature::ifempty(unsigned int address)
 {
-    auto p = this->getForwardLocation();
-    if (this->isInside(p) && this->getWorld()->getCreature(p) == NULL)
+    if (this->getWorld()->getGrid()->isEmpty(this->getForwardIndex()))
     {
         this->go(address);
     } else
     {
-        this->programID++;
+        this->table().programID[this->id]++;
     }
 }
 
 /**
  * @version 2.0 Let lake as a wall if cannot fly
+ * @version 3.0 Test the square ahead by its index
  * @param address
  */
 void Creature::ifwall(unsigned int address)
 {
-    auto p = this->getForwardLocation();
-    if (!this->isInside(p) || (!this->ability[FLY] && this->isTerrain(p, LAKE)))
+    auto next = this->getForwardIndex();
+    if (next == Grid::WALL || (!this->hasAbility(FLY) && this->getWorld()->getGrid()->isTerrain(next, LAKE)))
     {
         this->go(address);
     } else
     {
-        this->programID++;
+        this->table().programID[this->id]++;
     }
 }
 
 /**
  * @version 2.0 terrain FOREST is always NOT same
+ * @version 3.0 Test the species bitmap
+ * @version 3.0 Test the square ahead by its index
  * @param address
  */
 void Creature::ifsame(unsigned int address)
 {
-    auto p = this->getForwardLocation();
-    if (this->getWorld()->getCreature(p) != NULL && !this->isTerrain(p, FOREST))
+    auto next = this->getForwardIndex();
+    auto grid = this->getWorld()->getGrid();
+    if (grid->isSpecies(next, this->getSpeciesIndex()) && !grid->isTerrain(next, FOREST))
     {
-        if (this->getWorld()->getCreature(p)->getSpecies() == this->getSpecies())
-        {
-            this->go(address);
-            return;
-        }
+        this->go(address);
+        return;
     }
-    this->programID++;
+    this->table().programID[this->id]++;
 }
 
 /**
  * @version 2.0 terrain FOREST is always NOT enemy
+ * @version 3.0 Test the occupancy and species bitmaps
+ * @version 3.0 Test the square ahead by its index
  * @param address
  */
 void Creature::ifenemy(unsigned int address)
 {
-    auto p = this->getForwardLocation();
-    if (this->getWorld()->getCreature(p) != NULL && !this->isTerrain(p, FOREST))
+    auto next = this->getForwardIndex();
+    auto grid = this->getWorld()->getGrid();
+    if (grid->isOccupied(next) && !grid->isSpecies(next, this->getSpeciesIndex()) &&
+        !grid->isTerrain(next, FOREST))
     {
-        if (this->getWorld()->getCreature(p)->getSpecies() != this->getSpecies())
-        {
-            this->go(address);
-            return;
-        }
+        this->go(address);
+        return;
     }
-    this->programID++;
+    this->table().programID[this->id]++;
 }
 
 void Creature::go(unsigned int address)
 {
-    this->programID = address;
+    this->table().programID[this->id] = address;
 }
 
 /**
@@ -314,14 +422,16 @@ void Creature::go(unsigned int address)
  */
 bool Creature::stayHill()
 {
-    if (this->isTerrain(HILL) && !this->hasAbility(FLY) && !this->hillActive)
+    auto &flags = this->table().flags[this->id];
+    if (this->isTerrain(HILL) && !this->hasAbility(FLY) && !(flags & CreatureTable::FLAG_HILL_ACTIVE))
     {
-        return (this->hillActive = true);
+        flags |= CreatureTable::FLAG_HILL_ACTIVE;
+        return true;
     }
     return false;
 }
 
 void Creature::enterHill()
 {
-    this->hillActive = false;
+    this->table().flags[this->id] &= ~CreatureTable::FLAG_HILL_ACTIVE;
 }
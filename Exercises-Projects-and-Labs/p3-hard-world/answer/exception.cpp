@@ -25,7 +25,7 @@ inline const char *MyException::what() const noexcept
 MissingArgumentException::MissingArgumentException()
 {
     this->errStr[0] = "Error: Missing arguments!\n";
-    this->errStr[0] += "Usage: ./p3 <species-summary> <world-file> <rounds> [v|verbose]";
+    this->errStr[0] += std::string("Usage: ") + PROGRAM + " <species-summary> <world-file> <rounds> [v|verbose]";
 }
 
 NegativeRoundException::NegativeRoundException()
@@ -147,3 +147,18 @@ CannotFlyException::CannotFlyException(Creature *creature)
     this->errStr[++errNum] = creature->serialize();
     this->make();
 }
+
+InvalidSnapshotException::InvalidSnapshotException(std::string filename)
+{
+    this->errStr[0] = "Error: File <filename> is not a valid snapshot!";
+    this->errStr[++errNum] = filename;
+    this->make();
+}
+
+DigestMismatchException::DigestMismatchException(std::string title, std::string filename)
+{
+    this->errStr[0] = "Error: The digest of <TITLE> does not match file <filename>!";
+    this->errStr[++errNum] = title;
+    this->errStr[++errNum] = filename;
+    this->make();
+}
@@ -6,22 +6,152 @@
 
 using namespace p3;
 
-Grid::Grid(grid_t &grid)
+/**
+ * @version 3.0 The grid is empty until setSize
+ */
+Grid::Grid()
 {
-    for (auto i = 0; i < MAXHEIGHT; i++)
-    {
-        for (auto j = 0; j < MAXWIDTH; j++)
-        {
-            this->squares[i][j] = NULL;
-        }
-    }
-    grid = *this;
+    this->height = this->width = this->tileColumns = 0;
+    this->tracking = false;
 }
 
+/**
+ * @version 3.0 Allocate the bitmaps, and the tiles only as creatures come
+ * @param height
+ * @param width
+ */
 inline void Grid::setSize(const unsigned int &height, const unsigned int &width)
 {
     this->height = height;
     this->width = width;
+    this->tileColumns = (width + TILE_SIZE - 1) / TILE_SIZE;
+    this->tiles.clear();
+    this->tiles.resize(size_t((height + TILE_SIZE - 1) / TILE_SIZE) * this->tileColumns);
+    auto words = (size_t(height) * width + 63) / 64;
+    this->occupied.assign(words, 0);
+    for (int i = 0; i < TERRAIN_SIZE; i++)
+    {
+        this->terrains[i].assign(words, 0);
+    }
+    this->species.clear();
+    this->changed.assign(this->tracking ? words : 0, 0);
+
+    // The step to the next square in each direction, and where it is a wall
+    this->steps[EAST] = 1;
+    this->steps[SOUTH] = (int) width;
+    this->steps[WEST] = -1;
+    this->steps[NORTH] = -(int) width;
+    for (int i = 0; i < DIRECT_SIZE; i++)
+    {
+        this->walls[i].assign(words, 0);
+    }
+    for (unsigned int r = 0; r < height; r++)
+    {
+        setBit(this->walls[WEST], r * width, true);
+        setBit(this->walls[EAST], r * width + width - 1, true);
+    }
+    for (unsigned int c = 0; c < width; c++)
+    {
+        setBit(this->walls[NORTH], c, true);
+        setBit(this->walls[SOUTH], (height - 1) * width + c, true);
+    }
+}
+
+inline unsigned int Grid::bitIndex(const point_t &p) const
+{
+    return p.r * this->width + p.c;
+}
+
+inline unsigned int Grid::getIndex(const point_t &p) const
+{
+    return bitIndex(p);
+}
+
+/**
+ * @version 3.0 Added
+ * @param i the index of a square
+ * @param direction
+ * @return the index of the next square in the direction, or WALL if it is
+ * outside; the test is a bit of a bitmap and needs no branch
+ */
+inline unsigned int Grid::getForwardIndex(unsigned int i, direction_t direction) const
+{
+    return testBit(this->walls[direction], i) ? WALL : i + this->steps[direction];
+}
+
+inline unsigned int Grid::tileIndex(const point_t &p) const
+{
+    return p.r / TILE_SIZE * this->tileColumns + p.c / TILE_SIZE;
+}
+
+inline unsigned int Grid::tileOffset(const point_t &p)
+{
+    return p.r % TILE_SIZE * TILE_SIZE + p.c % TILE_SIZE;
+}
+
+/**
+ * @version 3.0 Added
+ * @param p inside the grid
+ * @return the square at p, allocating its tile if it has none
+ */
+inline Creature *&Grid::square(const point_t &p)
+{
+    auto &tile = this->tiles[tileIndex(p)];
+    if (tile.empty())
+    {
+        tile.assign(TILE_SIZE * TILE_SIZE, NULL);
+    }
+    return tile[tileOffset(p)];
+}
+
+/**
+ * @version 3.0 Added
+ * Allocates the tile of p, so that a creature can enter p without
+ * allocating, as while a round runs on several threads
+ * @param p inside the grid
+ */
+void Grid::reserveSquare(const point_t &p)
+{
+    this->square(p);
+}
+
+inline bool Grid::testBit(const std::vector<uint64_t> &bits, unsigned int i)
+{
+    return (bits[i / 64] >> (i % 64)) & 1;
+}
+
+inline void Grid::setBit(std::vector<uint64_t> &bits, unsigned int i, bool value)
+{
+    if (value)
+    {
+        bits[i / 64] |= uint64_t(1) << (i % 64);
+    } else
+    {
+        bits[i / 64] &= ~(uint64_t(1) << (i % 64));
+    }
+}
+
+/**
+ * @version 3.0 Added
+ * @param species
+ * @return the bitmap of the species, allocated when first used
+ */
+std::vector<uint64_t> &Grid::speciesBits(const Species *species)
+{
+    return this->speciesBits(species->getIndex());
+}
+
+std::vector<uint64_t> &Grid::speciesBits(unsigned int index)
+{
+    if (index >= this->species.size())
+    {
+        this->species.resize(index + 1);
+    }
+    if (this->species[index].empty())
+    {
+        this->species[index].assign(this->occupied.size(), 0);
+    }
+    return this->species[index];
 }
 
 /**
@@ -36,79 +166,322 @@ void Grid::setTerrain(const point_t &p, char terrain)
     {
         if (terrainShortName[i][0] == terrain)
         {
-            this->terrain[p.r][p.c] = terrain_t(i);
+            for (int j = 0; j < TERRAIN_SIZE; j++)
+            {
+                setBit(this->terrains[j], bitIndex(p), j == i);
+            }
             return;
         }
     }
     throw UnknownTerrainException(p, terrain);
 }
 
+/**
+ * @version 3.0 Added
+ * @return the number of 64-bit words in each bitmap
+ */
+inline size_t Grid::getWords() const
+{
+    return this->occupied.size();
+}
+
+inline const uint64_t *Grid::getTerrainBits(terrain_t terrain) const
+{
+    return this->terrains[terrain].data();
+}
+
+/**
+ * @version 3.0 Added
+ * @param terrain
+ * @param bits getWords() words, as returned by getTerrainBits
+ */
+void Grid::setTerrainBits(terrain_t terrain, const uint64_t *bits)
+{
+    this->terrains[terrain].assign(bits, bits + this->getWords());
+}
+
 inline bool Grid::isInside(const point_t &p) const
 {
     return p.c >= 0 && p.r >= 0 && p.c < this->width && p.r < this->height;
 }
 
 /**
- * @version 2.0 Added
+ * @version 3.0 Read the terrain bitmap
+ * @version 3.0 Every square is a plain without terrain
  * @param p
  * @param terrain
  * @return
  */
 inline bool Grid::isTerrain(const point_t &p, terrain_t terrain) const
 {
-    return this->isInside(p) && this->terrain[p.r][p.c] == terrain;
+    if (!features_t::TERRAIN)
+    {
+        return terrain == PLAIN && this->isInside(p);
+    }
+    return this->isInside(p) && testBit(this->terrains[terrain], bitIndex(p));
+}
+
+/**
+ * @version 3.0 Added
+ * @param i the index of a square, or WALL
+ * @param terrain
+ * @return
+ */
+inline bool Grid::isTerrain(unsigned int i, terrain_t terrain) const
+{
+    if (!features_t::TERRAIN)
+    {
+        return terrain == PLAIN && i != WALL;
+    }
+    return i != WALL && testBit(this->terrains[terrain], i);
 }
 
 inline void Grid::addCreature(Creature *creature)
 {
     auto p = creature->getLocation();
-    this->squares[p.r][p.c] = (creature_t *) creature;
+    this->square(p) = creature;
+    setBit(this->occupied, bitIndex(p), true);
+    setBit(this->speciesBits(creature->getSpecies()), bitIndex(p), true);
+}
+
+/**
+ * @version 3.0 Added
+ * @param p
+ * @return whether p is inside and holds a creature
+ */
+inline bool Grid::isOccupied(const point_t &p) const
+{
+    return this->isInside(p) && testBit(this->occupied, bitIndex(p));
+}
+
+/**
+ * @version 3.0 Added
+ * @param i the index of a square, or WALL
+ * @return whether the square holds a creature
+ */
+inline bool Grid::isOccupied(unsigned int i) const
+{
+    return i != WALL && testBit(this->occupied, i);
+}
+
+/**
+ * @version 3.0 Added
+ * @param i the index of a square, or WALL
+ * @return whether the square holds no creature
+ */
+inline bool Grid::isEmpty(unsigned int i) const
+{
+    return i != WALL && !testBit(this->occupied, i);
+}
+
+/**
+ * @version 3.0 Added
+ * @param p
+ * @return whether p is inside and holds no creature
+ */
+inline bool Grid::isEmpty(const point_t &p) const
+{
+    return this->isInside(p) && !testBit(this->occupied, bitIndex(p));
+}
+
+/**
+ * @version 3.0 Added
+ * @param p
+ * @param index the index of a species
+ * @return whether p is inside and holds a creature of the species
+ */
+inline bool Grid::isSpecies(const point_t &p, unsigned int index) const
+{
+    return this->isInside(p) && index < this->species.size() && !this->species[index].empty() &&
+           testBit(this->species[index], bitIndex(p));
+}
+
+/**
+ * @version 3.0 Added
+ * @param i the index of a square, or WALL
+ * @param index the index of a species
+ * @return whether the square holds a creature of the species
+ */
+inline bool Grid::isSpecies(unsigned int i, unsigned int index) const
+{
+    return i != WALL && index < this->species.size() && !this->species[index].empty() &&
+           testBit(this->species[index], i);
+}
+
+/**
+ * @version 3.0 Added
+ * @param p the square of a creature whose species changes
+ * @param from
+ * @param to
+ */
+void Grid::changeSpecies(const point_t &p, const Species *from, const Species *to)
+{
+    setBit(this->speciesBits(from), bitIndex(p), false);
+    setBit(this->speciesBits(to), bitIndex(p), true);
+    this->touch(p);
+}
+
+/**
+ * @version 3.0 Added
+ * Starts or stops recording which squares change, for serializeChanges
+ * @param tracking
+ */
+void Grid::setTracking(bool tracking)
+{
+    this->tracking = tracking;
+    this->changed.assign(tracking ? this->occupied.size() : 0, 0);
+}
+
+/**
+ * @version 3.0 Added
+ * Records that what is shown of p may have changed, if tracking
+ * @param p
+ */
+inline void Grid::touch(const point_t &p)
+{
+    if (this->tracking)
+    {
+        setBit(this->changed, bitIndex(p), true);
+    }
 }
 
 inline Creature *Grid::getCreature(const point_t &p) const
 {
     if (isInside(p))
     {
-        return (Creature *) this->squares[p.r][p.c];
+        auto &tile = this->tiles[tileIndex(p)];
+        return tile.empty() ? NULL : tile[tileOffset(p)];
     }
     return NULL;
 }
 
-inline int Grid::getHeight() const
+inline unsigned int Grid::getHeight() const
 {
     return this->height;
 }
 
-inline int Grid::getWidth() const
+inline unsigned int Grid::getWidth() const
 {
     return this->width;
 }
 
-void Grid::move(const point_t &a, const point_t &b)
+/**
+ * @version 3.0 Move the bits of the creature along
+ * @param a
+ * @param b
+ * @param species the index of the species of the creature
+ */
+void Grid::move(const point_t &a, const point_t &b, unsigned int species)
 {
-    this->squares[b.r][b.c] = this->squares[a.r][a.c];
-    this->squares[a.r][a.c] = NULL;
+    auto &from = this->square(a);
+    this->square(b) = from;
+    from = NULL;
+    auto &bits = this->speciesBits(species);
+    setBit(this->occupied, bitIndex(a), false);
+    setBit(this->occupied, bitIndex(b), true);
+    setBit(bits, bitIndex(a), false);
+    setBit(bits, bitIndex(b), true);
+    this->touch(a);
+    this->touch(b);
 }
 
-std::string Grid::serialize() const
+/**
+ * @version 3.0 Added
+ * Allocates the bitmap of the species, so that it is not allocated while
+ * creatures move
+ * @param species
+ */
+void Grid::addSpecies(const Species *species)
 {
-    std::string str;
+    this->speciesBits(species);
+}
+
+/**
+ * @version 3.0 Added
+ * @param species
+ * @return the number of creatures of the species
+ */
+unsigned int Grid::count(const Species *species) const
+{
+    auto index = species->getIndex();
+    unsigned int num = 0;
+    if (index < this->species.size())
+    {
+        for (auto word : this->species[index])
+        {
+            num += __builtin_popcountll(word);
+        }
+    }
+    return num;
+}
+
+/**
+ * @version 3.0 Added
+ * Appends how the square at p is shown: "____ " if empty
+ * @param str
+ * @param p
+ */
+inline void Grid::serializeSquare(std::string &str, const point_t &p) const
+{
+    Creature *creature = this->getCreature(p);
+    if (creature == NULL)
+    {
+        str.append("____ ", 5);
+    } else
+    {
+        const std::string &name = creature->getSpecies()->getName();
+        str.append(name, 0, 2);
+        str += '_';
+        str += creature->getDirectionName(creature->getDirection(), true);
+        str += ' ';
+    }
+}
+
+/**
+ * @version 3.0 Append to str, with no temporary string per square
+ * @param str
+ */
+void Grid::serialize(std::string &str) const
+{
+    str.reserve(str.size() + size_t(this->height) * (5 * this->width + 1));
     for (auto i = 0; i < this->height; i++)
     {
         for (auto j = 0; j < this->width; j++)
         {
-            Creature *creature = (Creature *) squares[i][j];
-            if (creature == NULL)
-            {
-                str += "____";
-            } else
-            {
-                str += creature->getSpecies()->getName().substr(0, 2);
-                str += "_" + creature->getDirectionName(creature->getDirection(), true);
-            }
-            str += " ";
+            this->serializeSquare(str, point_t{i, j});
         }
-        str += "\n";
+        str += '\n';
     }
+}
+
+std::string Grid::serialize() const
+{
+    std::string str;
+    this->serialize(str);
     return str;
-}
\ No newline at end of file
+}
+
+/**
+ * @version 3.0 Added
+ * Appends a line "<row> <column> <square>" for every square that changed
+ * since tracking started or since the last call, row by row, and forgets
+ * them. Applied to the grid as last serialized, they give the current one.
+ * @param str
+ */
+void Grid::serializeChanges(std::string &str)
+{
+    for (size_t w = 0; w < this->changed.size(); w++)
+    {
+        for (auto word = this->changed[w]; word != 0; word &= word - 1)
+        {
+            auto i = (unsigned int) (w * 64 + __builtin_ctzll(word));
+            str += std::to_string(i / this->width);
+            str += ' ';
+            str += std::to_string(i % this->width);
+            str += ' ';
+            this->serializeSquare(str, point_t{int(i / this->width), int(i % this->width)});
+            str.back() = '\n';
+        }
+        this->changed[w] = 0;
+    }
+}
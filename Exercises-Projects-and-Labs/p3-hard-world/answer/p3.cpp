@@ -14,8 +14,14 @@ int main(int argc, char *argv[])
     {
         p3::Controller controller(argc, argv);
         controller.readSpecies(argv[1]);
-        controller.readWorld(argv[2]);
-        controller.simulate();
+        if (controller.isEnsemble())
+        {
+            controller.simulateEnsemble(argv[2]);
+        } else
+        {
+            controller.readWorld(argv[2]);
+            controller.simulate();
+        }
     }
     catch (p3::MyException &e)
     {
@@ -0,0 +1,75 @@
+//
+// Replays the output of p3 --delta into whole grids.
+//
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Usage: ./p3-render < <delta-output>
+//
+// Reads the output of a quiet run with --delta: the whole grid after
+// "Initial state", then after every "Round <n>" one line
+// "<row> <column> <square>" per square that changed. Prints it as the
+// same run with -q would, the whole grid after every title.
+
+static bool isTitle(const std::string &line)
+{
+    return line == "Initial state" || line.compare(0, 6, "Round ") == 0;
+}
+
+static void printGrid(const std::vector<std::string> &grid, std::string &out)
+{
+    for (const auto &row : grid)
+    {
+        out += row;
+        out += '\n';
+    }
+}
+
+int main()
+{
+    std::ios::sync_with_stdio(false);
+    std::vector<std::string> grid;
+    std::string line, out;
+    bool initial = false;   // Whether the lines are those of the initial grid
+    bool changed = false;   // Whether a round is waiting to be printed
+    int lineNum = 0;
+    while (std::getline(std::cin, line))
+    {
+        lineNum++;
+        if (isTitle(line))
+        {
+            if (initial || changed) printGrid(grid, out);
+            out += line;
+            out += '\n';
+            initial = line == "Initial state";
+            changed = !initial;
+            if (initial) grid.clear();
+        } else if (initial)
+        {
+            grid.push_back(line);
+        } else
+        {
+            std::istringstream ss(line);
+            size_t row, column;
+            std::string square;
+            if (!(ss >> row >> column >> square) || square.size() != 4 || row >= grid.size() ||
+                5 * column + 4 > grid[row].size())
+            {
+                std::cerr << "Error: Line " << lineNum << " is not a change of a square!" << std::endl;
+                return 1;
+            }
+            grid[row].replace(5 * column, 4, square);
+        }
+        if (out.size() >= (1 << 20))
+        {
+            std::cout << out;
+            out.clear();
+        }
+    }
+    if (initial || changed) printGrid(grid, out);
+    std::cout << out;
+    return 0;
+}
@@ -1,11 +1,23 @@
 // Generated by p3 builder v0.1
 // Author: tc-imba
-// Date: 2017-07-13 19:50:49
+// Date: 2026-10-14 13:12:11
 
 #include <iostream>
 #include <sstream>
 #include <fstream>
+#include <algorithm>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include "simulation.h"
+#include "../../../bench/tracing.h"
 
 namespace p3
 {
@@ -14,10 +26,27 @@ namespace p3
 
     // species.cpp
     
-    Species::Species(const std::string &name)
+    /**
+     * @version 3.0 Hold the program in a vector; maxProgram 0 means no limit
+     * @param name
+     * @param maxProgram
+     */
+    Species::Species(const std::string &name, const unsigned int &maxProgram)
     {
         this->name = name;
         this->programSize = 0;
+        this->index = 0;
+        this->maxProgram = maxProgram;
+    }
+    
+    inline unsigned int Species::getIndex() const
+    {
+        return this->index;
+    }
+    
+    inline void Species::setIndex(const unsigned int &index)
+    {
+        this->index = index;
     }
     
     inline std::string Species::getOptionName(const opcode_t &op)
@@ -32,42 +61,271 @@ namespace p3
     
     inline const instruction_t& Species::getInstruction(const int &programID) const
     {
-        return this->program[programID];
+        return this->instructions[programID];
+    }
+    
+    static unsigned int hashOption(const char *str, size_t size)
+    {
+        return (unsigned char) str[0] + (unsigned char) str[size - 2] + size;
+    }
+    
+    /**
+     * @version 3.0 Added
+     * Looks the name up by a hash that is perfect on opName: the first and
+     * the last but one characters and the length, modulo 16
+     * @param str
+     * @param size
+     * @param op set to the instruction named
+     * @return whether str is the name of an instruction
+     */
+    bool Species::findOption(const char *str, size_t size, opcode_t &op)
+    {
+        static const std::vector<int> table = []()
+        {
+            std::vector<int> table(16, -1);
+            for (int i = 0; i < length(opName); i++)
+            {
+                table[hashOption(opName[i].data(), opName[i].size()) % 16] = i;
+            }
+            return table;
+        }();
+        if (size < 2) return false;
+        int i = table[hashOption(str, size) % 16];
+        if (i < 0 || opName[i].size() != size || opName[i].compare(0, size, str, size) != 0)
+        {
+            return false;
+        }
+        op = opcode_t(i);
+        return true;
     }
     
+    /**
+     * @version 3.0 Find the instruction by findOption
+     * @throws TooManyInstructionException
+     * @throws UnknownInstructionException
+     * @param op
+     * @param address
+     */
     void Species::addInstruction(const std::string &op, const int &address)
     {
-        if (this->programSize >= MAXPROGRAM)
+        if (this->maxProgram && this->programSize >= this->maxProgram)
         {
             throw TooManyInstructionException(this->name);
         }
-        for (auto opcode_i = HOP; opcode_i < length(opName); opcode_i++)
+        opcode_t opcode;
+        if (!findOption(op.data(), op.size(), opcode))
+        {
+            throw UnknownInstructionException(op);
+        }
+        instruction_t instruction = {opcode, 0};
+        if (!isEndOption(opcode))
+        {
+            instruction.address = address - 1;
+        }
+        this->instructions.push_back(instruction);
+        this->programSize++;
+    }
+    
+    inline const std::string &Species::getName() const
+    {
+        return this->name;
+    }
+    
+    static bool runHop(Creature *creature, unsigned int)
+    {
+        creature->hop();
+        return true;
+    }
+    
+    static bool runLeft(Creature *creature, unsigned int)
+    {
+        creature->left();
+        return true;
+    }
+    
+    static bool runRight(Creature *creature, unsigned int)
+    {
+        creature->right();
+        return true;
+    }
+    
+    static bool runInfect(Creature *creature, unsigned int)
+    {
+        creature->infect();
+        return true;
+    }
+    
+    static bool runIfempty(Creature *creature, unsigned int address)
+    {
+        creature->ifempty(address);
+        return false;
+    }
+    
+    static bool runIfenemy(Creature *creature, unsigned int address)
+    {
+        creature->ifenemy(address);
+        return false;
+    }
+    
+    static bool runIfsame(Creature *creature, unsigned int address)
+    {
+        creature->ifsame(address);
+        return false;
+    }
+    
+    static bool runIfwall(Creature *creature, unsigned int address)
+    {
+        creature->ifwall(address);
+        return false;
+    }
+    
+    static bool runGo(Creature *creature, unsigned int address)
+    {
+        creature->go(address);
+        return false;
+    }
+    
+    /**
+     * @version 3.0 Added
+     * Resolves the handler of every instruction, so that running the program
+     * needs no decoding. Must be called again after adding instructions.
+     */
+    void Species::compile()
+    {
+        static const handler_t handlers[] = {runHop, runLeft, runRight, runInfect, runIfempty,
+                                             runIfenemy, runIfsame, runIfwall, runGo};
+        this->code.clear();
+        for (const auto &instruction : this->instructions)
+        {
+            this->code.push_back(compiled_t{handlers[instruction.op], instruction.op, instruction.address});
+        }
+    }
+    
+    inline const Species::compiled_t *Species::getCode() const
+    {
+        return this->code.data();
+    }
+    
+    inline unsigned int Species::getProgramSize() const
+    {
+        return this->programSize;
+    }
+    
+    /**
+     * @version 3.0 Added
+     * A turn runs instructions until an ending one. The instructions in
+     * between change nothing, so a turn that comes back to an instruction
+     * never ends. Follows every jump the program could take from its start,
+     * over any number of turns.
+     * @return the number (from 1) of the first instruction the program can
+     * reach from which no ending instruction can be reached, or 0 if every
+     * turn can end
+     */
+    unsigned int Species::findEndlessLoop() const
+    {
+        auto size = this->programSize;
+    
+        // The instructions a turn may run after each one; an ending one has
+        // none, since the turn stops there
+        std::vector<std::vector<unsigned int> > before(size);
+        for (unsigned int id = 0; id < size; id++)
+        {
+            auto op = this->instructions[id].op;
+            auto address = this->instructions[id].address;
+            if (isEndOption(op)) continue;
+            if (address < size) before[address].push_back(id);
+            if (op != GO && id + 1 < size) before[id + 1].push_back(id);
+        }
+    
+        // Instructions from which some ending one can be reached, found
+        // backwards from the ending ones
+        std::vector<bool> canEnd(size, false);
+        std::vector<unsigned int> pending;
+        for (unsigned int id = 0; id < size; id++)
+        {
+            if (isEndOption(this->instructions[id].op))
+            {
+                canEnd[id] = true;
+                pending.push_back(id);
+            }
+        }
+        while (!pending.empty())
         {
-            if (op == opName[opcode_i])
+            auto id = pending.back();
+            pending.pop_back();
+            for (auto from : before[id])
             {
-                this->program[this->programSize].op = opcode_i;
-                if (!isEndOption(opcode_i))
+                if (!canEnd[from])
                 {
-                    this->program[this->programSize].address = address - 1;
+                    canEnd[from] = true;
+                    pending.push_back(from);
                 }
-                this->programSize++;
-                return;
             }
         }
-        throw UnknownInstructionException(op);
-    }
     
-    inline std::string Species::getName() const
-    {
-        return this->name;
+        // Instructions reachable from the start, where a turn after an ending
+        // instruction goes on with the next one
+        std::vector<bool> reached(size, false);
+        if (size > 0)
+        {
+            reached[0] = true;
+            pending.push_back(0);
+        }
+        while (!pending.empty())
+        {
+            auto id = pending.back();
+            pending.pop_back();
+            auto op = this->instructions[id].op;
+            unsigned int next[2] = {id + 1, this->instructions[id].address};
+            for (int i = 0; i < 2; i++)
+            {
+                if ((i == 0 && op == GO) || (i == 1 && isEndOption(op))) continue;
+                if (next[i] < size && !reached[next[i]])
+                {
+                    reached[next[i]] = true;
+                    pending.push_back(next[i]);
+                }
+            }
+        }
+    
+        for (unsigned int id = 0; id < size; id++)
+        {
+            if (reached[id] && !canEnd[id]) return id + 1;
+        }
+        return 0;
     }
 
 
+
     // creature.cpp
     
+    inline unsigned int CreatureTable::size() const
+    {
+        return (unsigned int) this->row.size();
+    }
+    
+    /**
+     * @version 3.0 Added
+     * @param p
+     * @return the index of a new creature at p, facing east, with no species,
+     * abilities or hill state
+     */
+    unsigned int CreatureTable::add(const point_t &p)
+    {
+        this->row.push_back(p.r);
+        this->column.push_back(p.c);
+        this->direction.push_back(EAST);
+        this->species.push_back(0);
+        this->programID.push_back(0);
+        this->flags.push_back(0);
+        return this->size() - 1;
+    }
+    
     /**
      * The constructor of Creature
      * @version 2.0 Add the initialization of bool ability[ABILITY_SIZE] and bool hillActive;
+     * @version 3.0 Keep the state in the table of the world
+     * @version 3.0 Find the direction by findDirection
      * @throws UnknownSpeciesException
      * @throws UnknownDirectionException
      * @throws OutsideBoundaryException
@@ -81,48 +339,55 @@ namespace p3
     Creature::Creature(World *world, std::string name, std::string direction, int row, int column)
     {
         this->m_world = world;
-        this->programID = 0;
+        this->m_table = &world->getTable();
+        this->id = this->m_table->add(point_t{row, column});
     
         // Initialize the species of the creature
-        this->species = (species_t *) world->getSpecies(name);
-        if (this->species == NULL)
+        auto species = world->getSpecies(name);
+        if (species == NULL)
         {
             throw UnknownSpeciesException(name);
         }
+        this->table().species[this->id] = species->getIndex();
     
         // Set and judge the direction
-        bool flag = false;
-        for (auto direction_i = EAST; direction_i < length(directName); direction_i++)
+        direction_t direct;
+        if (!findDirection(direction.data(), direction.size(), direct))
         {
-            if (direction == directName[direction_i])
-            {
-                this->direction = direction_i;
-                flag = true;
-                break;
-            }
+            throw UnknownDirectionException(direction);
         }
-        if (!flag) throw UnknownDirectionException(direction);
+        this->table().direction[this->id] = (unsigned char) direct;
     
-        // Set and judge the location
-        this->location.r = row;
-        this->location.c = column;
+        // Judge the location
         if (!isInside()) throw OutsideBoundaryException(this);
     
         // Judge whether there is a creature at the location
-        auto origin = this->getWorld()->getCreature(this->location);
+        auto origin = this->getWorld()->getCreature(this->getLocation());
         if (origin != NULL) throw OverlapCreatureException(this, origin);
     
         // The creature don't have abilities and hill status in default
-        for (int i = 0; i < length(abilityShortName); i++)
-        {
-            this->ability[i] = false;
-        }
-        this->hillActive = false;
+    }
+    
+    /**
+     * @version 3.0 Added
+     * @param world
+     * @param id a creature already in the table of the world
+     */
+    Creature::Creature(World *world, unsigned int id)
+    {
+        this->m_world = world;
+        this->m_table = &world->getTable();
+        this->id = id;
+    }
+    
+    inline CreatureTable &Creature::table() const
+    {
+        return *this->m_table;
     }
     
     inline unsigned int Creature::getProgramID() const
     {
-        return this->programID;
+        return this->table().programID[this->id];
     }
     
     /**
@@ -138,16 +403,56 @@ namespace p3
         {
             if (abilityShortName[i] == ability)
             {
-                this->ability[i] = true;
+                this->table().flags[this->id] |= 1 << i;
                 return;
             }
         }
         throw UnknownAbilityException(this, ability);
     }
     
+    /**
+     * @version 3.0 Always false without abilities
+     * @param ability
+     * @return
+     */
     inline bool Creature::hasAbility(const ability_t &ability) const
     {
-        return this->ability[ability];
+        return features_t::ABILITIES && ((this->table().flags[this->id] >> ability) & 1);
+    }
+    
+    static unsigned int hashDirection(const char *str, size_t size)
+    {
+        return (unsigned char) str[0] + 2 * (unsigned char) str[size - 2] + size;
+    }
+    
+    /**
+     * @version 3.0 Added
+     * Looks the name up by a hash that is perfect on directName: the first
+     * and the last but one characters and the length, modulo 8
+     * @param str
+     * @param size
+     * @param direction set to the direction named
+     * @return whether str is the name of a direction
+     */
+    bool Creature::findDirection(const char *str, size_t size, direction_t &direction)
+    {
+        static const std::vector<int> table = []()
+        {
+            std::vector<int> table(8, -1);
+            for (int i = 0; i < length(directName); i++)
+            {
+                table[hashDirection(directName[i].data(), directName[i].size()) % 8] = i;
+            }
+            return table;
+        }();
+        if (size < 2) return false;
+        int i = table[hashDirection(str, size) % 8];
+        if (i < 0 || directName[i].size() != size || directName[i].compare(0, size, str, size) != 0)
+        {
+            return false;
+        }
+        direction = direction_t(i);
+        return true;
     }
     
     inline const std::string &Creature::getDirectionName(const direction_t &direct, bool shortFlag)
@@ -157,23 +462,29 @@ namespace p3
     
     inline void Creature::changeSpecies(const Species *species)
     {
-        this->species = (species_t *) species;
-        this->programID = 0;
+        this->getWorld()->getGrid()->changeSpecies(this->getLocation(), this->getSpecies(), species);
+        this->table().species[this->id] = species->getIndex();
+        this->table().programID[this->id] = 0;
     }
     
     inline const Species *Creature::getSpecies() const
     {
-        return (Species *) this->species;
+        return this->m_world->getSpecies(this->table().species[this->id]);
+    }
+    
+    inline unsigned int Creature::getSpeciesIndex() const
+    {
+        return this->table().species[this->id];
     }
     
     inline direction_t Creature::getDirection() const
     {
-        return this->direction;
+        return direction_t(this->table().direction[this->id]);
     }
     
-    inline const point_t &Creature::getLocation() const
+    inline point_t Creature::getLocation() const
     {
-        return this->location;
+        return point_t{this->table().row[this->id], this->table().column[this->id]};
     }
     
     inline const World *Creature::getWorld() const
@@ -238,42 +549,68 @@ namespace p3
         return this->getForwardLocation(this->getLocation());
     }
     
+    /**
+     * @version 3.0 Added
+     * @return the index in the grid of the square ahead, or Grid::WALL
+     */
+    inline unsigned int Creature::getForwardIndex() const
+    {
+        auto grid = this->getWorld()->getGrid();
+        return grid->getForwardIndex(grid->getIndex(this->getLocation()), this->getDirection());
+    }
+    
     /**
      * @version 2.0 Add ability FLY and terrain LAKE
+     * @version 3.0 Test the occupancy bitmap
+     * @version 3.0 Test the square ahead by its index
      */
     void Creature::hop()
     {
-        auto p = this->getForwardLocation();
-        if (isInside(p) && this->getWorld()->getCreature(p) == NULL &&
-            (this->ability[FLY] || !this->isTerrain(p, LAKE)))
+        auto grid = this->getWorld()->getGrid();
+        auto next = this->getForwardIndex();
+        if (grid->isEmpty(next) && (this->hasAbility(FLY) || !grid->isTerrain(next, LAKE)))
         {
-            this->getWorld()->getGrid()->move(this->getLocation(), p);
-            this->location = p;
+            auto p = this->getForwardLocation();
+            grid->move(this->getLocation(), p, this->getSpeciesIndex());
+            this->table().row[this->id] = p.r;
+            this->table().column[this->id] = p.c;
         }
-        this->programID++;
+        this->table().programID[this->id]++;
     }
     
+    /**
+     * @version 3.0 Record the change of the square shown
+     */
     void Creature::left()
     {
-        this->direction = direction_t(((((int) this->direction) - 1) + length(directName)) % length(directName));
-        this->programID++;
+        auto &direction = this->table().direction[this->id];
+        direction = (unsigned char) ((direction - 1 + length(directName)) % length(directName));
+        this->getWorld()->getGrid()->touch(this->getLocation());
+        this->table().programID[this->id]++;
     }
     
+    /**
+     * @version 3.0 Record the change of the square shown
+     */
     void Creature::right()
     {
-        this->direction = direction_t((((int) this->direction) + 1) % length(directName));
-        this->programID++;
+        auto &direction = this->table().direction[this->id];
+        direction = (unsigned char) ((direction + 1) % length(directName));
+        this->getWorld()->getGrid()->touch(this->getLocation());
+        this->table().programID[this->id]++;
     }
     
     /**
      * @version 2.0 Add ability ARCH and terrain FOREST
+     * @version 3.0 Return whether a creature was infected
+     * @return
      */
-    void Creature::infect()
+    bool Creature::infect()
     {
         auto p = this->getForwardLocation();
         auto target = this->getWorld()->getCreature(p);
     
-        if (this->ability[ARCH])
+        if (this->hasAbility(ARCH))
         {
             while (target == NULL || target->getSpecies() == this->getSpecies())
             {
@@ -286,84 +623,89 @@ namespace p3
             target = NULL;
         }
     
-        if (target != NULL)
+        bool infected = target != NULL && target->getSpeciesIndex() != this->getSpeciesIndex();
+        if (infected)
         {
-            if (target->getSpecies() != this->getSpecies())
-            {
-                target->changeSpecies(this->getSpecies());
-            }
+            target->changeSpecies(this->getSpecies());
         }
-        this->programID++;
+        this->table().programID[this->id]++;
+        return infected;
     }
     
     
+    /**
+     * @version 3.0 Test the occupancy bitmap
+     * @version 3.0 Test the square ahead by its index
+     * @param address
+     */
     void Creature::ifempty(unsigned int address)
     {
-        auto p = this->getForwardLocation();
-        if (this->isInside(p) && this->getWorld()->getCreature(p) == NULL)
+        if (this->getWorld()->getGrid()->isEmpty(this->getForwardIndex()))
         {
             this->go(address);
         } else
         {
-            this->programID++;
+            this->table().programID[this->id]++;
         }
     }
     
     /**
      * @version 2.0 Let lake as a wall if cannot fly
+     * @version 3.0 Test the square ahead by its index
      * @param address
      */
     void Creature::ifwall(unsigned int address)
     {
-        auto p = this->getForwardLocation();
-        if (!this->isInside(p) || (!this->ability[FLY] && this->isTerrain(p, LAKE)))
+        auto next = this->getForwardIndex();
+        if (next == Grid::WALL || (!this->hasAbility(FLY) && this->getWorld()->getGrid()->isTerrain(next, LAKE)))
         {
             this->go(address);
         } else
         {
-            this->programID++;
+            this->table().programID[this->id]++;
         }
     }
     
     /**
      * @version 2.0 terrain FOREST is always NOT same
+     * @version 3.0 Test the species bitmap
+     * @version 3.0 Test the square ahead by its index
      * @param address
      */
     void Creature::ifsame(unsigned int address)
     {
-        auto p = this->getForwardLocation();
-        if (this->getWorld()->getCreature(p) != NULL && !this->isTerrain(p, FOREST))
+        auto next = this->getForwardIndex();
+        auto grid = this->getWorld()->getGrid();
+        if (grid->isSpecies(next, this->getSpeciesIndex()) && !grid->isTerrain(next, FOREST))
         {
-            if (this->getWorld()->getCreature(p)->getSpecies() == this->getSpecies())
-            {
-                this->go(address);
-                return;
-            }
+            this->go(address);
+            return;
         }
-        this->programID++;
+        this->table().programID[this->id]++;
     }
     
     /**
      * @version 2.0 terrain FOREST is always NOT enemy
+     * @version 3.0 Test the occupancy and species bitmaps
+     * @version 3.0 Test the square ahead by its index
      * @param address
      */
     void Creature::ifenemy(unsigned int address)
     {
-        auto p = this->getForwardLocation();
-        if (this->getWorld()->getCreature(p) != NULL && !this->isTerrain(p, FOREST))
+        auto next = this->getForwardIndex();
+        auto grid = this->getWorld()->getGrid();
+        if (grid->isOccupied(next) && !grid->isSpecies(next, this->getSpeciesIndex()) &&
+            !grid->isTerrain(next, FOREST))
         {
-            if (this->getWorld()->getCreature(p)->getSpecies() != this->getSpecies())
-            {
-                this->go(address);
-                return;
-            }
+            this->go(address);
+            return;
         }
-        this->programID++;
+        this->table().programID[this->id]++;
     }
     
     void Creature::go(unsigned int address)
     {
-        this->programID = address;
+        this->table().programID[this->id] = address;
     }
     
     /**
@@ -372,147 +714,585 @@ namespace p3
      */
     bool Creature::stayHill()
     {
-        if (this->isTerrain(HILL) && !this->hasAbility(FLY) && !this->hillActive)
+        auto &flags = this->table().flags[this->id];
+        if (this->isTerrain(HILL) && !this->hasAbility(FLY) && !(flags & CreatureTable::FLAG_HILL_ACTIVE))
         {
-            return (this->hillActive = true);
+            flags |= CreatureTable::FLAG_HILL_ACTIVE;
+            return true;
         }
         return false;
     }
     
     void Creature::enterHill()
     {
-        this->hillActive = false;
+        this->table().flags[this->id] &= ~CreatureTable::FLAG_HILL_ACTIVE;
     }
 
 
 
     // grid.cpp
     
-    Grid::Grid(grid_t &grid)
+    /**
+     * @version 3.0 The grid is empty until setSize
+     */
+    Grid::Grid()
     {
-        for (auto i = 0; i < MAXHEIGHT; i++)
-        {
-            for (auto j = 0; j < MAXWIDTH; j++)
-            {
-                this->squares[i][j] = NULL;
-            }
-        }
-        grid = *this;
+        this->height = this->width = this->tileColumns = 0;
+        this->tracking = false;
     }
     
+    /**
+     * @version 3.0 Allocate the bitmaps, and the tiles only as creatures come
+     * @param height
+     * @param width
+     */
     inline void Grid::setSize(const unsigned int &height, const unsigned int &width)
     {
         this->height = height;
         this->width = width;
+        this->tileColumns = (width + TILE_SIZE - 1) / TILE_SIZE;
+        this->tiles.clear();
+        this->tiles.resize(size_t((height + TILE_SIZE - 1) / TILE_SIZE) * this->tileColumns);
+        auto words = (size_t(height) * width + 63) / 64;
+        this->occupied.assign(words, 0);
+        for (int i = 0; i < TERRAIN_SIZE; i++)
+        {
+            this->terrains[i].assign(words, 0);
+        }
+        this->species.clear();
+        this->changed.assign(this->tracking ? words : 0, 0);
+    
+        // The step to the next square in each direction, and where it is a wall
+        this->steps[EAST] = 1;
+        this->steps[SOUTH] = (int) width;
+        this->steps[WEST] = -1;
+        this->steps[NORTH] = -(int) width;
+        for (int i = 0; i < DIRECT_SIZE; i++)
+        {
+            this->walls[i].assign(words, 0);
+        }
+        for (unsigned int r = 0; r < height; r++)
+        {
+            setBit(this->walls[WEST], r * width, true);
+            setBit(this->walls[EAST], r * width + width - 1, true);
+        }
+        for (unsigned int c = 0; c < width; c++)
+        {
+            setBit(this->walls[NORTH], c, true);
+            setBit(this->walls[SOUTH], (height - 1) * width + c, true);
+        }
     }
     
-    /**
-     * @version 2.0 Added
-     * @throws UnknownTerrainException
-     * @param p
-     * @param terrain
-     */
-    void Grid::setTerrain(const point_t &p, char terrain)
+    inline unsigned int Grid::bitIndex(const point_t &p) const
     {
-        for (int i = 0; i < length(terrainShortName); i++)
-        {
-            if (terrainShortName[i][0] == terrain)
-            {
-                this->terrain[p.r][p.c] = terrain_t(i);
-                return;
-            }
-        }
-        throw UnknownTerrainException(p, terrain);
+        return p.r * this->width + p.c;
     }
     
-    inline bool Grid::isInside(const point_t &p) const
+    inline unsigned int Grid::getIndex(const point_t &p) const
     {
-        return p.c >= 0 && p.r >= 0 && p.c < this->width && p.r < this->height;
+        return bitIndex(p);
     }
     
     /**
-     * @version 2.0 Added
-     * @param p
-     * @param terrain
-     * @return
+     * @version 3.0 Added
+     * @param i the index of a square
+     * @param direction
+     * @return the index of the next square in the direction, or WALL if it is
+     * outside; the test is a bit of a bitmap and needs no branch
      */
-    inline bool Grid::isTerrain(const point_t &p, terrain_t terrain) const
+    inline unsigned int Grid::getForwardIndex(unsigned int i, direction_t direction) const
     {
-        return this->isInside(p) && this->terrain[p.r][p.c] == terrain;
+        return testBit(this->walls[direction], i) ? WALL : i + this->steps[direction];
     }
     
-    inline void Grid::addCreature(Creature *creature)
+    inline unsigned int Grid::tileIndex(const point_t &p) const
     {
-        auto p = creature->getLocation();
-        this->squares[p.r][p.c] = (creature_t *) creature;
+        return p.r / TILE_SIZE * this->tileColumns + p.c / TILE_SIZE;
     }
     
-    inline Creature *Grid::getCreature(const point_t &p) const
+    inline unsigned int Grid::tileOffset(const point_t &p)
     {
-        if (isInside(p))
-        {
-            return (Creature *) this->squares[p.r][p.c];
-        }
-        return NULL;
+        return p.r % TILE_SIZE * TILE_SIZE + p.c % TILE_SIZE;
     }
     
-    inline int Grid::getHeight() const
+    /**
+     * @version 3.0 Added
+     * @param p inside the grid
+     * @return the square at p, allocating its tile if it has none
+     */
+    inline Creature *&Grid::square(const point_t &p)
     {
-        return this->height;
+        auto &tile = this->tiles[tileIndex(p)];
+        if (tile.empty())
+        {
+            tile.assign(TILE_SIZE * TILE_SIZE, NULL);
+        }
+        return tile[tileOffset(p)];
     }
     
-    inline int Grid::getWidth() const
+    /**
+     * @version 3.0 Added
+     * Allocates the tile of p, so that a creature can enter p without
+     * allocating, as while a round runs on several threads
+     * @param p inside the grid
+     */
+    void Grid::reserveSquare(const point_t &p)
     {
-        return this->width;
+        this->square(p);
     }
     
-    void Grid::move(const point_t &a, const point_t &b)
+    inline bool Grid::testBit(const std::vector<uint64_t> &bits, unsigned int i)
     {
-        this->squares[b.r][b.c] = this->squares[a.r][a.c];
-        this->squares[a.r][a.c] = NULL;
+        return (bits[i / 64] >> (i % 64)) & 1;
     }
     
-    std::string Grid::serialize() const
+    inline void Grid::setBit(std::vector<uint64_t> &bits, unsigned int i, bool value)
     {
-        std::string str;
-        for (auto i = 0; i < this->height; i++)
+        if (value)
         {
-            for (auto j = 0; j < this->width; j++)
-            {
-                Creature *creature = (Creature *) squares[i][j];
-                if (creature == NULL)
-                {
-                    str += "____";
-                } else
-                {
-                    str += creature->getSpecies()->getName().substr(0, 2);
-                    str += "_" + creature->getDirectionName(creature->getDirection(), true);
-                }
-                str += " ";
-            }
-            str += "\n";
+            bits[i / 64] |= uint64_t(1) << (i % 64);
+        } else
+        {
+            bits[i / 64] &= ~(uint64_t(1) << (i % 64));
         }
-        return str;
     }
-
-
-    // world.cpp
     
-    World::World()
+    /**
+     * @version 3.0 Added
+     * @param species
+     * @return the bitmap of the species, allocated when first used
+     */
+    std::vector<uint64_t> &Grid::speciesBits(const Species *species)
     {
-        this->numCreatures = this->numSpecies = 0;
-        Grid(this->grid);
+        return this->speciesBits(species->getIndex());
     }
     
-    inline Grid *World::getGrid() const
+    std::vector<uint64_t> &Grid::speciesBits(unsigned int index)
     {
-        return (Grid *) &this->grid;
-    }
-    
-    inline Creature *World::addCreature(Creature *creature)
+        if (index >= this->species.size())
+        {
+            this->species.resize(index + 1);
+        }
+        if (this->species[index].empty())
+        {
+            this->species[index].assign(this->occupied.size(), 0);
+        }
+        return this->species[index];
+    }
+    
+    /**
+     * @version 2.0 Added
+     * @throws UnknownTerrainException
+     * @param p
+     * @param terrain
+     */
+    void Grid::setTerrain(const point_t &p, char terrain)
+    {
+        for (int i = 0; i < length(terrainShortName); i++)
+        {
+            if (terrainShortName[i][0] == terrain)
+            {
+                for (int j = 0; j < TERRAIN_SIZE; j++)
+                {
+                    setBit(this->terrains[j], bitIndex(p), j == i);
+                }
+                return;
+            }
+        }
+        throw UnknownTerrainException(p, terrain);
+    }
+    
+    /**
+     * @version 3.0 Added
+     * @return the number of 64-bit words in each bitmap
+     */
+    inline size_t Grid::getWords() const
+    {
+        return this->occupied.size();
+    }
+    
+    inline const uint64_t *Grid::getTerrainBits(terrain_t terrain) const
+    {
+        return this->terrains[terrain].data();
+    }
+    
+    /**
+     * @version 3.0 Added
+     * @param terrain
+     * @param bits getWords() words, as returned by getTerrainBits
+     */
+    void Grid::setTerrainBits(terrain_t terrain, const uint64_t *bits)
+    {
+        this->terrains[terrain].assign(bits, bits + this->getWords());
+    }
+    
+    inline bool Grid::isInside(const point_t &p) const
+    {
+        return p.c >= 0 && p.r >= 0 && p.c < this->width && p.r < this->height;
+    }
+    
+    /**
+     * @version 3.0 Read the terrain bitmap
+     * @version 3.0 Every square is a plain without terrain
+     * @param p
+     * @param terrain
+     * @return
+     */
+    inline bool Grid::isTerrain(const point_t &p, terrain_t terrain) const
+    {
+        if (!features_t::TERRAIN)
+        {
+            return terrain == PLAIN && this->isInside(p);
+        }
+        return this->isInside(p) && testBit(this->terrains[terrain], bitIndex(p));
+    }
+    
+    /**
+     * @version 3.0 Added
+     * @param i the index of a square, or WALL
+     * @param terrain
+     * @return
+     */
+    inline bool Grid::isTerrain(unsigned int i, terrain_t terrain) const
+    {
+        if (!features_t::TERRAIN)
+        {
+            return terrain == PLAIN && i != WALL;
+        }
+        return i != WALL && testBit(this->terrains[terrain], i);
+    }
+    
+    inline void Grid::addCreature(Creature *creature)
+    {
+        auto p = creature->getLocation();
+        this->square(p) = creature;
+        setBit(this->occupied, bitIndex(p), true);
+        setBit(this->speciesBits(creature->getSpecies()), bitIndex(p), true);
+    }
+    
+    /**
+     * @version 3.0 Added
+     * @param p
+     * @return whether p is inside and holds a creature
+     */
+    inline bool Grid::isOccupied(const point_t &p) const
+    {
+        return this->isInside(p) && testBit(this->occupied, bitIndex(p));
+    }
+    
+    /**
+     * @version 3.0 Added
+     * @param i the index of a square, or WALL
+     * @return whether the square holds a creature
+     */
+    inline bool Grid::isOccupied(unsigned int i) const
+    {
+        return i != WALL && testBit(this->occupied, i);
+    }
+    
+    /**
+     * @version 3.0 Added
+     * @param i the index of a square, or WALL
+     * @return whether the square holds no creature
+     */
+    inline bool Grid::isEmpty(unsigned int i) const
+    {
+        return i != WALL && !testBit(this->occupied, i);
+    }
+    
+    /**
+     * @version 3.0 Added
+     * @param p
+     * @return whether p is inside and holds no creature
+     */
+    inline bool Grid::isEmpty(const point_t &p) const
+    {
+        return this->isInside(p) && !testBit(this->occupied, bitIndex(p));
+    }
+    
+    /**
+     * @version 3.0 Added
+     * @param p
+     * @param index the index of a species
+     * @return whether p is inside and holds a creature of the species
+     */
+    inline bool Grid::isSpecies(const point_t &p, unsigned int index) const
+    {
+        return this->isInside(p) && index < this->species.size() && !this->species[index].empty() &&
+               testBit(this->species[index], bitIndex(p));
+    }
+    
+    /**
+     * @version 3.0 Added
+     * @param i the index of a square, or WALL
+     * @param index the index of a species
+     * @return whether the square holds a creature of the species
+     */
+    inline bool Grid::isSpecies(unsigned int i, unsigned int index) const
+    {
+        return i != WALL && index < this->species.size() && !this->species[index].empty() &&
+               testBit(this->species[index], i);
+    }
+    
+    /**
+     * @version 3.0 Added
+     * @param p the square of a creature whose species changes
+     * @param from
+     * @param to
+     */
+    void Grid::changeSpecies(const point_t &p, const Species *from, const Species *to)
+    {
+        setBit(this->speciesBits(from), bitIndex(p), false);
+        setBit(this->speciesBits(to), bitIndex(p), true);
+        this->touch(p);
+    }
+    
+    /**
+     * @version 3.0 Added
+     * Starts or stops recording which squares change, for serializeChanges
+     * @param tracking
+     */
+    void Grid::setTracking(bool tracking)
+    {
+        this->tracking = tracking;
+        this->changed.assign(tracking ? this->occupied.size() : 0, 0);
+    }
+    
+    /**
+     * @version 3.0 Added
+     * Records that what is shown of p may have changed, if tracking
+     * @param p
+     */
+    inline void Grid::touch(const point_t &p)
+    {
+        if (this->tracking)
+        {
+            setBit(this->changed, bitIndex(p), true);
+        }
+    }
+    
+    inline Creature *Grid::getCreature(const point_t &p) const
+    {
+        if (isInside(p))
+        {
+            auto &tile = this->tiles[tileIndex(p)];
+            return tile.empty() ? NULL : tile[tileOffset(p)];
+        }
+        return NULL;
+    }
+    
+    inline unsigned int Grid::getHeight() const
+    {
+        return this->height;
+    }
+    
+    inline unsigned int Grid::getWidth() const
+    {
+        return this->width;
+    }
+    
+    /**
+     * @version 3.0 Move the bits of the creature along
+     * @param a
+     * @param b
+     * @param species the index of the species of the creature
+     */
+    void Grid::move(const point_t &a, const point_t &b, unsigned int species)
+    {
+        auto &from = this->square(a);
+        this->square(b) = from;
+        from = NULL;
+        auto &bits = this->speciesBits(species);
+        setBit(this->occupied, bitIndex(a), false);
+        setBit(this->occupied, bitIndex(b), true);
+        setBit(bits, bitIndex(a), false);
+        setBit(bits, bitIndex(b), true);
+        this->touch(a);
+        this->touch(b);
+    }
+    
+    /**
+     * @version 3.0 Added
+     * Allocates the bitmap of the species, so that it is not allocated while
+     * creatures move
+     * @param species
+     */
+    void Grid::addSpecies(const Species *species)
+    {
+        this->speciesBits(species);
+    }
+    
+    /**
+     * @version 3.0 Added
+     * @param species
+     * @return the number of creatures of the species
+     */
+    unsigned int Grid::count(const Species *species) const
+    {
+        auto index = species->getIndex();
+        unsigned int num = 0;
+        if (index < this->species.size())
+        {
+            for (auto word : this->species[index])
+            {
+                num += __builtin_popcountll(word);
+            }
+        }
+        return num;
+    }
+    
+    /**
+     * @version 3.0 Added
+     * Appends how the square at p is shown: "____ " if empty
+     * @param str
+     * @param p
+     */
+    inline void Grid::serializeSquare(std::string &str, const point_t &p) const
+    {
+        Creature *creature = this->getCreature(p);
+        if (creature == NULL)
+        {
+            str.append("____ ", 5);
+        } else
+        {
+            const std::string &name = creature->getSpecies()->getName();
+            str.append(name, 0, 2);
+            str += '_';
+            str += creature->getDirectionName(creature->getDirection(), true);
+            str += ' ';
+        }
+    }
+    
+    /**
+     * @version 3.0 Append to str, with no temporary string per square
+     * @param str
+     */
+    void Grid::serialize(std::string &str) const
+    {
+        str.reserve(str.size() + size_t(this->height) * (5 * this->width + 1));
+        for (auto i = 0; i < this->height; i++)
+        {
+            for (auto j = 0; j < this->width; j++)
+            {
+                this->serializeSquare(str, point_t{i, j});
+            }
+            str += '\n';
+        }
+    }
+    
+    std::string Grid::serialize() const
+    {
+        std::string str;
+        this->serialize(str);
+        return str;
+    }
+    
+    /**
+     * @version 3.0 Added
+     * Appends a line "<row> <column> <square>" for every square that changed
+     * since tracking started or since the last call, row by row, and forgets
+     * them. Applied to the grid as last serialized, they give the current one.
+     * @param str
+     */
+    void Grid::serializeChanges(std::string &str)
+    {
+        for (size_t w = 0; w < this->changed.size(); w++)
+        {
+            for (auto word = this->changed[w]; word != 0; word &= word - 1)
+            {
+                auto i = (unsigned int) (w * 64 + __builtin_ctzll(word));
+                str += std::to_string(i / this->width);
+                str += ' ';
+                str += std::to_string(i % this->width);
+                str += ' ';
+                this->serializeSquare(str, point_t{int(i / this->width), int(i % this->width)});
+                str.back() = '\n';
+            }
+            this->changed[w] = 0;
+        }
+    }
+
+
+
+    // world.cpp
+    
+    World::World()
+    {
+        this->numCreatures = this->numSpecies = 0;
+        this->ownsSpecies = true;
+    }
+    
+    /**
+     * @version 3.0 Delete the species only if they are not shared
+     */
+    World::~World()
+    {
+        if (!this->ownsSpecies) return;
+        for (auto species : this->m_species)
+        {
+            delete species;
+        }
+    }
+    
+    /**
+     * @version 3.0 Added
+     * Uses the species of another world, which must outlive this one and must
+     * not add species while they are shared. They are only read, so worlds
+     * sharing them can run on different threads.
+     * @param world
+     */
+    void World::shareSpecies(const World &world)
+    {
+        this->m_species = world.m_species;
+        this->numSpecies = world.numSpecies;
+        this->ownsSpecies = false;
+    }
+    
+    inline Grid *World::getGrid() const
+    {
+        return (Grid *) &this->m_grid;
+    }
+    
+    /**
+     * @version 3.0 Added
+     * @param num the number of creatures to make room for, so that adding
+     * them never moves the others
+     */
+    void World::reserveCreatures(const unsigned int &num)
+    {
+        this->m_creatures.reserve(num);
+    }
+    
+    /**
+     * @version 3.0 Construct the creature in the contiguous storage
+     * @throws UnknownSpeciesException
+     * @throws UnknownDirectionException
+     * @throws OutsideBoundaryException
+     * @throws OverlapCreatureException
+     * @param name
+     * @param direction
+     * @param row
+     * @param column
+     * @return the creature added
+     */
+    Creature *World::addCreature(const std::string &name, const std::string &direction, int row, int column)
     {
-        this->getGrid()->addCreature(creature);
-        return this->m_creatures[this->numCreatures++] = creature;
+        bool moved = this->m_creatures.size() == this->m_creatures.capacity();
+        this->m_creatures.emplace_back(this, name, direction, row, column);
+        if (moved)
+        {
+            // More creatures than reserved: the others moved, so the grid
+            // must point at their new places
+            for (auto &creature : this->m_creatures)
+            {
+                this->getGrid()->addCreature(&creature);
+            }
+        } else
+        {
+            this->getGrid()->addCreature(&this->m_creatures.back());
+        }
+        this->numCreatures++;
+        return &this->m_creatures.back();
     }
     
     inline Creature *World::getCreature(const point_t &p) const
@@ -522,269 +1302,1571 @@ namespace p3
     
     inline Creature *World::getCreature(const unsigned int &i) const
     {
-        return this->m_creatures[i];
+        return (Creature *) &this->m_creatures[i];
+    }
+    
+    inline CreatureTable &World::getTable()
+    {
+        return this->m_table;
     }
     
     inline Species *World::addSpecies(Species *species)
     {
-        return this->m_species[this->numSpecies++] = species;
+        species->setIndex(this->numSpecies);
+        this->m_species.push_back(species);
+        this->numSpecies++;
+        return species;
     }
     
     Species *World::getSpecies(const std::string &name) const
     {
         for (auto i = 0; i < this->numSpecies; i++)
         {
-            if (name == this->m_species[i]->getName())
+            if (name == this->m_species[i]->getName())
+            {
+                return this->m_species[i];
+            }
+        }
+        return NULL;
+    }
+    
+    inline Species *World::getSpecies(const unsigned int &i) const
+    {
+        return this->m_species[i];
+    }
+    
+    inline unsigned int World::getCreatureNum() const
+    {
+        return this->numCreatures;
+    }
+    
+    inline unsigned int World::getSpeciesNum() const
+    {
+        return this->numSpecies;
+    }
+    
+    /**
+     * @version 3.0 Added
+     * @return a 64-bit FNV-1a hash of the state of every creature, in order:
+     * its location, direction, species, program counter, abilities and hill
+     * state. Worlds that simulate the same way have the same digests.
+     */
+    uint64_t World::digest() const
+    {
+        uint64_t hash = 14695981039346656037ULL;
+        auto mix = [&hash](const void *data, size_t size)
+        {
+            auto bytes = (const unsigned char *) data;
+            for (size_t i = 0; i < size; i++)
+            {
+                hash = (hash ^ bytes[i]) * 1099511628211ULL;
+            }
+        };
+        auto &table = this->m_table;
+        for (unsigned int i = 0; i < table.size(); i++)
+        {
+            mix(&table.row[i], sizeof(table.row[i]));
+            mix(&table.column[i], sizeof(table.column[i]));
+            mix(&table.direction[i], sizeof(table.direction[i]));
+            mix(&table.species[i], sizeof(table.species[i]));
+            mix(&table.programID[i], sizeof(table.programID[i]));
+            mix(&table.flags[i], sizeof(table.flags[i]));
+        }
+        return hash;
+    }
+
+
+
+    // snapshot.cpp
+    
+    /**
+     * @version 3.0 Added
+     * @param path
+     * @return whether the file starts with SNAPSHOT_MAGIC
+     */
+    bool World::isSnapshot(const std::string &path)
+    {
+        char magic[sizeof(SNAPSHOT_MAGIC)] = {};
+        std::ifstream file(path, std::ios::binary);
+        file.read(magic, sizeof(magic));
+        return file && memcmp(magic, SNAPSHOT_MAGIC, sizeof(magic)) == 0;
+    }
+    
+    /**
+     * @version 3.0 Added
+     * Writes the terrain, the species names and the state of every creature,
+     * so that loadSnapshot continues from the same point
+     * @throws FailureFileException
+     * @param path
+     * @param round the number of rounds simulated so far
+     */
+    void World::saveSnapshot(const std::string &path, int round) const
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+        {
+            throw FailureFileException(path);
+        }
+    
+        auto grid = this->getGrid();
+        auto &table = this->m_table;
+        std::string names;
+        for (auto species : this->m_species)
+        {
+            names += species->getName();
+            names += '\0';
+        }
+    
+        SnapshotHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+        header.height = (uint32_t) grid->getHeight();
+        header.width = (uint32_t) grid->getWidth();
+        header.numSpecies = (uint32_t) this->m_species.size();
+        header.numCreatures = table.size();
+        header.round = round;
+        header.namesSize = (uint32_t) names.size();
+    
+        // Lay out the sections one after another, each aligned to 8 bytes
+        uint64_t end = sizeof(header);
+        auto place = [&end](uint64_t size)
+        {
+            auto offset = end;
+            end = (end + size + 7) / 8 * 8;
+            return offset;
+        };
+        uint64_t n = header.numCreatures;
+        header.names = place(names.size());
+        header.terrains = place(TERRAIN_SIZE * grid->getWords() * sizeof(uint64_t));
+        header.row = place(n * sizeof(int32_t));
+        header.column = place(n * sizeof(int32_t));
+        header.species = place(n * sizeof(uint32_t));
+        header.programID = place(n * sizeof(uint32_t));
+        header.direction = place(n);
+        header.flags = place(n);
+    
+        uint64_t written = 0;
+        auto section = [&file, &written](uint64_t offset, const void *data, uint64_t size)
+        {
+            static const char zeros[8] = {};
+            file.write(zeros, std::streamsize(offset - written));
+            file.write((const char *) data, std::streamsize(size));
+            written = offset + size;
+        };
+        section(0, &header, sizeof(header));
+        section(header.names, names.data(), names.size());
+        for (int i = 0; i < TERRAIN_SIZE; i++)
+        {
+            section(header.terrains + i * grid->getWords() * sizeof(uint64_t),
+                    grid->getTerrainBits(terrain_t(i)), grid->getWords() * sizeof(uint64_t));
+        }
+        section(header.row, table.row.data(), n * sizeof(int32_t));
+        section(header.column, table.column.data(), n * sizeof(int32_t));
+        section(header.species, table.species.data(), n * sizeof(uint32_t));
+        section(header.programID, table.programID.data(), n * sizeof(uint32_t));
+        section(header.direction, table.direction.data(), n);
+        section(header.flags, table.flags.data(), n);
+        section(end, NULL, 0);
+        if (!file)
+        {
+            throw FailureFileException(path);
+        }
+    }
+    
+    /**
+     * @version 3.0 Added
+     * Restores the grid and the creatures from a snapshot, mapping the file
+     * and copying each section as a whole. The species, read beforehand, must
+     * be the ones of the snapshot in the same order.
+     * @throws FailureFileException
+     * @throws InvalidSnapshotException
+     * @throws UnknownSpeciesException
+     * @throws OutsideBoundaryException
+     * @throws OverlapCreatureException
+     * @param path
+     * @return the number of rounds simulated before the snapshot was saved
+     */
+    int World::loadSnapshot(const std::string &path)
+    {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            throw FailureFileException(path);
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0 || size_t(info.st_size) < sizeof(SnapshotHeader))
+        {
+            close(fd);
+            throw InvalidSnapshotException(path);
+        }
+        uint64_t size = uint64_t(info.st_size);
+        void *mapped = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (mapped == MAP_FAILED)
+        {
+            throw FailureFileException(path);
+        }
+        auto data = (const char *) mapped;
+        auto unmap = [mapped, size]()
+        {
+            munmap(mapped, size);
+        };
+    
+        SnapshotHeader header;
+        memcpy(&header, data, sizeof(header));
+        uint64_t n = header.numCreatures;
+        uint64_t words = (uint64_t(header.height) * header.width + 63) / 64;
+        auto fits = [size](uint64_t offset, uint64_t length)
+        {
+            return offset % 8 == 0 && offset <= size && length <= size - offset;
+        };
+        if (memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0 || header.round < 0 ||
+            header.height == 0 || header.width == 0 ||
+            header.height > LARGE_MAXSIZE || header.width > LARGE_MAXSIZE ||
+            !fits(header.names, header.namesSize) ||
+            (header.namesSize > 0 && data[header.names + header.namesSize - 1] != '\0') ||
+            !fits(header.terrains, TERRAIN_SIZE * words * sizeof(uint64_t)) ||
+            !fits(header.row, n * sizeof(int32_t)) || !fits(header.column, n * sizeof(int32_t)) ||
+            !fits(header.species, n * sizeof(uint32_t)) || !fits(header.programID, n * sizeof(uint32_t)) ||
+            !fits(header.direction, n) || !fits(header.flags, n))
+        {
+            unmap();
+            throw InvalidSnapshotException(path);
+        }
+    
+        // The species of the snapshot must be the ones read, by index
+        auto name = data + header.names;
+        for (uint32_t i = 0; i < header.numSpecies; i++)
+        {
+            if (name >= data + header.names + header.namesSize)
+            {
+                unmap();
+                throw InvalidSnapshotException(path);
+            }
+            std::string speciesName(name);
+            name += speciesName.size() + 1;
+            if (i >= this->m_species.size() || this->m_species[i]->getName() != speciesName)
+            {
+                unmap();
+                throw UnknownSpeciesException(speciesName);
+            }
+        }
+    
+        auto grid = this->getGrid();
+        grid->setSize(header.height, header.width);
+        for (int i = 0; i < TERRAIN_SIZE; i++)
+        {
+            grid->setTerrainBits(terrain_t(i),
+                                 (const uint64_t *) (data + header.terrains + i * words * sizeof(uint64_t)));
+        }
+    
+        auto &table = this->m_table;
+        auto row = (const int32_t *) (data + header.row);
+        auto column = (const int32_t *) (data + header.column);
+        auto species = (const uint32_t *) (data + header.species);
+        auto programID = (const uint32_t *) (data + header.programID);
+        auto direction = (const unsigned char *) (data + header.direction);
+        auto flags = (const unsigned char *) (data + header.flags);
+        table.row.assign(row, row + n);
+        table.column.assign(column, column + n);
+        table.species.assign(species, species + n);
+        table.programID.assign(programID, programID + n);
+        table.direction.assign(direction, direction + n);
+        table.flags.assign(flags, flags + n);
+        unmap();
+    
+        this->m_creatures.clear();
+        this->m_creatures.reserve(n);
+        for (unsigned int i = 0; i < n; i++)
+        {
+            if (table.species[i] >= header.numSpecies || table.direction[i] >= length(directName))
+            {
+                throw InvalidSnapshotException(path);
+            }
+            this->m_creatures.emplace_back(this, i);
+            auto creature = &this->m_creatures.back();
+            if (!creature->isInside()) throw OutsideBoundaryException(creature);
+            auto origin = this->getCreature(creature->getLocation());
+            if (origin != NULL) throw OverlapCreatureException(creature, origin);
+            grid->addCreature(creature);
+        }
+        this->numCreatures = (int) n;
+        return header.round;
+    }
+
+
+
+    // controller.cpp
+    
+    Controller::Controller(int argc, char *argv[])
+    {
+        if (argc < 4)
+        {
+            throw MissingArgumentException();
+        }
+        std::stringstream(argv[3]) >> this->round_max;
+        if (round_max < 0)
+        {
+            throw NegativeRoundException();
+        }
+        this->world = new World();
+        this->round = 0;
+        this->verbose = false;
+        this->limited = true;
+        this->quiet = this->stats = this->delta = this->digest = false;
+        this->lastDigest = 0;
+        this->verified = 0;
+        this->every = 0;
+        this->threads = 1;
+        this->lanes = false;
+        this->ensemble = false;
+        this->cycles = false;
+        this->cycleRound = -1;
+        this->cycleLength = this->period = 0;
+        for (int i = 4; i < argc; i++)
+        {
+            std::string str = argv[i];
+            if (str == "v" || str == "verbose")
+            {
+                this->verbose = true;
+            } else if (str == "-q")
+            {
+                this->quiet = true;
+            } else if (str == "--stats")
+            {
+                this->quiet = this->stats = true;
+            } else if (str == "--delta")
+            {
+                this->quiet = this->delta = true;
+            } else if (str == "--digest")
+            {
+                this->quiet = this->digest = true;
+            } else if (str == "--verify" && i + 1 < argc)
+            {
+                this->quiet = this->digest = true;
+                this->verifyPath = argv[++i];
+            } else if (str == "--every" && i + 1 < argc)
+            {
+                std::stringstream(argv[++i]) >> this->every;
+            } else if (str == "--threads" && i + 1 < argc)
+            {
+                std::stringstream(argv[++i]) >> this->threads;
+            } else if (str == "--lanes")
+            {
+                this->lanes = true;
+            } else if (str == "--ensemble")
+            {
+                this->ensemble = true;
+            } else if (str == "--cycles")
+            {
+                this->cycles = true;
+            } else if (str == "--profile" && i + 1 < argc)
+            {
+                this->profilePath = argv[++i];
+            } else if (str == "--save" && i + 1 < argc)
+            {
+                this->savePath = argv[++i];
+            } else if (str == "--large")
+            {
+                // Lift the limits of world_type.h: any number of species,
+                // instructions and creatures, and grids up to LARGE_MAXSIZE
+                this->limited = false;
+            }
+        }
+        if (this->quiet)
+        {
+            // Report only every few rounds, or only at the end by default;
+            // digests are of every round by default
+            this->verbose = false;
+            if (this->every <= 0) this->every = this->digest ? 1 : this->round_max;
+            this->buffer.reserve(BUFFER_SIZE);
+        }
+    }
+    
+    /**
+     * @version 3.0 Added
+     * @param path
+     * @param content set to the whole file
+     * @return whether the file could be opened
+     */
+    static bool readFile(const std::string &path, std::string &content)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open())
+        {
+            return false;
+        }
+        char chunk[1 << 16];
+        while (file.read(chunk, sizeof(chunk)) || file.gcount() > 0)
+        {
+            content.append(chunk, size_t(file.gcount()));
+        }
+        return true;
+    }
+    
+    static inline bool isBlank(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+    }
+    
+    /**
+     * @version 3.0 Added
+     * Skips the blanks at p and reads the token after them, as operator>> does
+     * @param p moved past the token
+     * @param end
+     * @param token set to the start of the token
+     * @return the size of the token, 0 if there is none before end
+     */
+    static size_t nextToken(const char *&p, const char *end, const char *&token)
+    {
+        while (p < end && isBlank(*p)) p++;
+        token = p;
+        while (p < end && !isBlank(*p)) p++;
+        return size_t(p - token);
+    }
+    
+    /**
+     * @version 3.0 Added
+     * @param token
+     * @param size
+     * @return the integer at the start of the token, saturated to the range of
+     * int, or 0 if it does not start with one, as operator>> does
+     */
+    static int toInt(const char *token, size_t size)
+    {
+        const char *p = token, *end = token + size;
+        bool negative = p < end && *p == '-';
+        if (p < end && (*p == '-' || *p == '+')) p++;
+        long long value = 0;
+        for (; p < end && *p >= '0' && *p <= '9'; p++)
+        {
+            value = std::min(value * 10 + (*p - '0'), (long long) INT_MAX + 1);
+        }
+        if (negative) value = -value;
+        return int(std::max(std::min(value, (long long) INT_MAX), (long long) INT_MIN));
+    }
+    
+    /**
+     * @version 3.0 Read each file as a whole and tokenize it in place
+     * @throws FailureFileException
+     * @throws TooManySpeciesException
+     * @throws TooManyInstructionException
+     * @throws UnknownInstructionException
+     * @param speciesPath
+     */
+    void Controller::readSpecies(const std::string &speciesPath)
+    {
+        // Open the species summary file
+        std::string summary;
+        if (!readFile(speciesPath, summary))
+        {
+            throw FailureFileException(speciesPath);
+        }
+        const char *p = summary.data(), *end = p + summary.size(), *token;
+        auto size = nextToken(p, end, token);
+        std::string speciesDirectory(token, size);
+        while ((size = nextToken(p, end, token)) > 0)
+        {
+            // Open the files in the species directory
+            std::string speciesName(token, size);
+            std::string speciesFullPath = speciesDirectory;
+            speciesFullPath += "/" + speciesName;
+            std::string program;
+            if (!readFile(speciesFullPath, program))
+            {
+                throw FailureFileException(speciesFullPath);
+            }
+    
+            // Examine the number of current species before adding a new one
+            if (this->limited && this->world->getSpeciesNum() >= MAXSPECIES)
+            {
+                throw TooManySpeciesException();
+            }
+    
+            // Create the species from the lines of the program, up to the
+            // first blank one
+            auto species = this->world->addSpecies(new Species(speciesName, this->limited ? MAXPROGRAM : 0));
+            const char *line = program.data(), *programEnd = line + program.size();
+            while (line < programEnd)
+            {
+                auto eol = (const char *) memchr(line, '\n', size_t(programEnd - line));
+                if (eol == NULL) eol = programEnd;
+                const char *q = line, *option, *address;
+                auto optionSize = nextToken(q, eol, option);
+                if (optionSize == 0) break;
+                auto addressSize = nextToken(q, eol, address);
+                species->addInstruction(std::string(option, optionSize), toInt(address, addressSize));
+                line = eol < programEnd ? eol + 1 : programEnd;
+            }
+            species->compile();
+            auto endless = species->findEndlessLoop();
+            if (endless)
+            {
+                // Not fatal: such a turn is cut short by the step budget
+                std::cerr << "Warning: Species " << speciesName << " can loop forever from instruction "
+                          << endless << "!" << std::endl;
+            }
+        }
+    }
+    
+    /**
+     * @version 2.0 Add terrains and abilities
+     * @version 3.0 Enforce the limits of world_type.h only if limited
+     * @version 3.0 Restore the world and the round from a snapshot
+     * @version 3.0 Read the file as a whole and tokenize it in place
+     * @version 3.0 Read terrain and abilities only if the world has them
+     * @throws FailureFileException
+     * @throws InvalidSnapshotException
+     * @throws IllegalHeightException
+     * @throws IllegalWidthException
+     * @throws TooManyCreatureException
+     * @param worldPath
+     */
+    void Controller::readWorld(const std::string &worldPath)
+    {
+        if (World::isSnapshot(worldPath))
+        {
+            this->round = this->world->loadSnapshot(worldPath);
+            auto grid = this->world->getGrid();
+            if (this->limited && grid->getHeight() > MAXHEIGHT)
+            {
+                throw IllegalHeightException();
+            }
+            if (this->limited && grid->getWidth() > MAXWIDTH)
+            {
+                throw IllegalWidthException();
+            }
+            if (this->limited && this->world->getCreatureNum() > MAXCREATURES)
+            {
+                throw TooManyCreatureException();
+            }
+            for (unsigned int i = 0; i < this->world->getCreatureNum(); i++)
+            {
+                auto creature = this->world->getCreature(i);
+                if (creature->isTerrain(LAKE) && !creature->hasAbility(FLY))
+                {
+                    throw CannotFlyException(creature);
+                }
+            }
+            return;
+        }
+    
+        std::string content;
+        if (!readFile(worldPath, content))
+        {
+            throw FailureFileException(worldPath);
+        }
+        const char *p = content.data(), *end = p + content.size(), *token;
+    
+        // Read height and width
+        auto size = nextToken(p, end, token);
+        int height = toInt(token, size);
+        size = nextToken(p, end, token);
+        int width = toInt(token, size);
+        if (height <= 0 || unsigned(height) > (this->limited ? MAXHEIGHT : LARGE_MAXSIZE))
+        {
+            throw IllegalHeightException();
+        }
+        if (width <= 0 || unsigned(width) > (this->limited ? MAXWIDTH : LARGE_MAXSIZE))
+        {
+            throw IllegalWidthException();
+        }
+        this->world->getGrid()->setSize((unsigned) height, (unsigned) width);
+    
+        // Read the terrain of each box, the next character that is not blank
+        for (int i = 0; features_t::TERRAIN && i < height; i++)
+        {
+            for (int j = 0; j < width; j++)
+            {
+                while (p < end && isBlank(*p)) p++;
+                char terrain = p < end ? *p++ : '\0';
+                this->world->getGrid()->setTerrain(point_t{i, j}, terrain);
+            }
+        }
+    
+        // Read creatures, counting the lines that are not blank first so that
+        // their storage is allocated once
+        std::vector<std::pair<const char *, const char *> > worldLines;
+        while (p < end)
+        {
+            auto eol = (const char *) memchr(p, '\n', size_t(end - p));
+            if (eol == NULL) eol = end;
+            auto q = p;
+            while (q < eol && isBlank(*q)) q++;
+            if (q < eol) worldLines.push_back(std::make_pair(p, eol));
+            p = eol < end ? eol + 1 : end;
+        }
+        this->world->reserveCreatures(worldLines.size());
+        for (const auto &worldLine : worldLines)
+        {
+            if (this->limited && this->world->getCreatureNum() >= MAXCREATURES)
+            {
+                throw TooManyCreatureException();
+            }
+            const char *q = worldLine.first, *lineEnd = worldLine.second;
+            size = nextToken(q, lineEnd, token);
+            std::string name(token, size);
+            size = nextToken(q, lineEnd, token);
+            std::string direction(token, size);
+            size = nextToken(q, lineEnd, token);
+            int row = toInt(token, size);
+            size = nextToken(q, lineEnd, token);
+            int column = toInt(token, size);
+    
+            auto creature = this->world->addCreature(name, direction, row, column);
+    
+            while (features_t::ABILITIES && (size = nextToken(q, lineEnd, token)) > 0)
+            {
+                creature->addAbility(std::string(token, size));
+            }
+    
+            if (creature->isTerrain(LAKE) && !creature->hasAbility(FLY))
+            {
+                throw CannotFlyException(creature);
+            }
+        }
+    }
+    
+    /**
+     * @version 3.0 Run the compiled program in a loop instead of recursing
+     * @version 3.0 Give up on a turn that cannot end
+     * @version 3.0 Count the instructions run in profile, if any
+     * @param creature
+     * @param profile
+     */
+    void Controller::creatureMove(Creature *creature, RoundProfile *profile)
+    {
+        // Only an ending instruction can change a species, so the code stays
+        // the same for the whole turn
+        auto species = creature->getSpecies();
+        auto code = species->getCode();
+        auto size = species->getProgramSize();
+        // Nothing changes before the ending instruction, so a turn that has
+        // run more instructions than the program holds has come back to one
+        // and would loop forever
+        for (unsigned int steps = 0; ; steps++)
+        {
+            auto programID = creature->getProgramID();
+            if (programID >= size || steps > size)
+            {
+                if (!this->quiet)
+                {
+                    std::cout << " (no action)";
+                }
+                return;
+            }
+            const auto &instruction = code[programID];
+            bool ending = profile == NULL ? instruction.handler(creature, instruction.address)
+                                          : this->profileInstruction(creature, instruction, *profile);
+            if (this->verbose)
+            {
+                std::cout << std::endl << "Instruction " << programID + 1 << ":";
+            }
+            if (ending)
+            {
+                if (!this->quiet)
+                {
+                    std::cout << " " << Species::getOptionName(instruction.op);
+                }
+                return;
+            }
+            if (this->verbose)
+            {
+                std::cout << " " << Species::getOptionName(instruction.op) << " " << instruction.address + 1;
+            }
+        }
+    }
+    
+    /**
+     * @version 3.0 Added
+     * Runs one instruction of a creature, as its handler would, and counts it
+     * @param creature
+     * @param instruction
+     * @param profile
+     * @return whether the instruction ends the turn
+     */
+    bool Controller::profileInstruction(Creature *creature, const Species::compiled_t &instruction,
+                                        RoundProfile &profile)
+    {
+        profile.instructions[instruction.op]++;
+        profile.species[creature->getSpeciesIndex()]++;
+        if (instruction.op == INFECT)
+        {
+            if (creature->infect()) profile.infections++;
+            return true;
+        }
+        return instruction.handler(creature, instruction.address);
+    }
+    
+    /**
+     * @version 3.0 Added
+     * Gives the creature its turn of a quiet round
+     * @param creature
+     * @param profile where to count the turn, if any
+     */
+    void Controller::creatureTurn(Creature *creature, RoundProfile *profile)
+    {
+        if (creature->stayHill())
+        {
+            if (profile != NULL) profile->hillSkips++;
+            return;
+        }
+        if (profile != NULL) profile->turns++;
+        this->creatureMove(creature, profile);
+        if (creature->isTerrain(HILL) && !creature->hasAbility(FLY))
+        {
+            creature->enterHill();
+        }
+    }
+    
+    /**
+     * @version 3.0 Added
+     * @param i a creature
+     * @return the representative of the creatures whose turns touch the same
+     * squares as creature i's, directly or through others
+     */
+    unsigned int Controller::findSet(unsigned int i)
+    {
+        while (this->parent[i] != i)
+        {
+            i = this->parent[i] = this->parent[this->parent[i]];
+        }
+        return i;
+    }
+    
+    /**
+     * @version 3.0 Added
+     * Runs a quiet round on several threads with the same result as running
+     * the creatures in order.
+     *
+     * A creature's turn reads and writes only its own square and the squares
+     * ahead of it: the one in front, or the whole line for an archer. Nobody
+     * else moves or turns it, so these are known when the round starts.
+     * Creatures whose squares overlap, directly or through others, form a
+     * set whose turns must keep their order; different sets are independent.
+     * The grid is cut into bands of rows, each starting at a multiple of 64
+     * squares so that bands never share a word of the bitmaps. A set that
+     * lies within one band runs on that band's thread, in creature order.
+     * The sets that cross bands run afterwards, one at a time in creature
+     * order. The tiles of the squares touched are allocated beforehand, as
+     * bands may share a tile.
+     */
+    void Controller::simulateRoundParallel()
+    {
+        TRACE_SCOPE("simulateRoundParallel");
+        auto grid = this->world->getGrid();
+        unsigned int height = grid->getHeight(), width = grid->getWidth();
+        unsigned int num = this->world->getCreatureNum();
+    
+        unsigned int a = width, b = 64;
+        while (b != 0)
+        {
+            auto t = a % b;
+            a = b;
+            b = t;
+        }
+        unsigned int step = 64 / a;     // Rows per 64 aligned squares
+        unsigned int band = (height + this->threads - 1) / this->threads;
+        band = std::max(step, (band + step - 1) / step * step);
+        unsigned int tiles = (height + band - 1) / band;
+        if (tiles <= 1)
+        {
+            for (unsigned int i = 0; i < num; i++)
+            {
+                this->creatureTurn(this->world->getCreature(i), this->profilePath.empty() ? NULL : &this->profile);
+            }
+            return;
+        }
+    
+        const unsigned int NONE = ~0u, MIXED = ~0u - 1;
+        if (this->claims.size() != size_t(height) * width)
+        {
+            this->claims.assign(size_t(height) * width, NONE);
+            for (unsigned int i = 0; i < this->world->getSpeciesNum(); i++)
+            {
+                grid->addSpecies(this->world->getSpecies(i));
+            }
+        }
+        this->parent.resize(num);
+        std::vector<unsigned int> home(num), touched;
+        for (unsigned int i = 0; i < num; i++)
+        {
+            this->parent[i] = i;
+        }
+        for (unsigned int i = 0; i < num; i++)
+        {
+            auto creature = this->world->getCreature(i);
+            auto p = creature->getLocation();
+            home[i] = p.r / band;
+            while (true)
+            {
+                auto cell = unsigned(p.r) * width + p.c;
+                if (unsigned(p.r) / band != home[i]) home[i] = MIXED;
+                grid->reserveSquare(p);
+                if (this->claims[cell] == NONE)
+                {
+                    this->claims[cell] = i;
+                    touched.push_back(cell);
+                } else
+                {
+                    this->parent[this->findSet(i)] = this->findSet(this->claims[cell]);
+                }
+                auto next = creature->getForwardLocation(p);
+                if (!creature->isInside(next)) break;
+                bool first = p == creature->getLocation();
+                p = next;
+                if (!first && !creature->hasAbility(ARCH)) break;
+            }
+        }
+        for (auto cell : touched)
+        {
+            this->claims[cell] = NONE;
+        }
+    
+        // A set runs on a band's thread only if all of it is in that band
+        std::vector<unsigned int> setHome(num, NONE);
+        for (unsigned int i = 0; i < num; i++)
+        {
+            auto &h = setHome[this->findSet(i)];
+            h = h == NONE || h == home[i] ? home[i] : MIXED;
+        }
+        std::vector<std::vector<unsigned int> > local(tiles);
+        std::vector<unsigned int> crossing;
+        for (unsigned int i = 0; i < num; i++)
+        {
+            auto h = setHome[this->findSet(i)];
+            (h == MIXED ? crossing : local[h]).push_back(i);
+        }
+    
+        // Every thread counts into its own profile, added up at the end
+        bool profiling = !this->profilePath.empty();
+        std::vector<RoundProfile> profiles(profiling ? tiles : 0);
+        for (auto &profile : profiles)
+        {
+            profile.clear(this->world->getSpeciesNum());
+        }
+        auto run = [this](const std::vector<unsigned int> &list, RoundProfile *profile)
+        {
+            for (auto i : list)
+            {
+                this->creatureTurn(this->world->getCreature(i), profile);
+            }
+        };
+        std::vector<std::thread> pool;
+        for (unsigned int t = 1; t < tiles; t++)
+        {
+            pool.push_back(std::thread(run, std::cref(local[t]), profiling ? &profiles[t] : NULL));
+        }
+        run(local[0], profiling ? &profiles[0] : NULL);
+        for (auto &thread : pool)
+        {
+            thread.join();
+        }
+        run(crossing, profiling ? &profiles[0] : NULL);
+        for (const auto &profile : profiles)
+        {
+            this->profile.add(profile);
+        }
+    }
+    
+    /**
+     * @version 3.0 Added
+     * Finds the creatures that touch, in their turns, no square that another
+     * creature touches: squares as in simulateRoundParallel, so that such a
+     * creature does the same whenever in the round it takes its turn. Counts
+     * how many creatures aim at each square ahead of them; a creature is alone
+     * if none aims at its square and nothing else is on, or aims at, a square
+     * it aims at. Keeps the square of each creature in cells.
+     * @param alone set to whether each creature is alone
+     */
+    void Controller::findLoners(std::vector<unsigned char> &alone)
+    {
+        auto grid = this->world->getGrid();
+        auto &table = this->world->getTable();
+        unsigned int num = this->world->getCreatureNum();
+        size_t squares = size_t(grid->getHeight()) * grid->getWidth();
+        this->aims.assign(squares, 0);
+        this->cells.resize(num);
+        alone.assign(num, 1);
+        for (unsigned int i = 0; i < num; i++)
+        {
+            auto direction = direction_t(table.direction[i]);
+            bool archer = features_t::ABILITIES && (table.flags[i] & CreatureTable::FLAG_ARCH);
+            this->cells[i] = grid->getIndex(point_t{table.row[i], table.column[i]});
+            for (auto next = grid->getForwardIndex(this->cells[i], direction); next != Grid::WALL;
+                 next = grid->getForwardIndex(next, direction))
+            {
+                if (this->aims[next] < 2) this->aims[next]++;
+                if (!archer) break;
+            }
+        }
+        for (unsigned int i = 0; i < num; i++)
+        {
+            auto direction = direction_t(table.direction[i]);
+            bool archer = features_t::ABILITIES && (table.flags[i] & CreatureTable::FLAG_ARCH);
+            if (this->aims[this->cells[i]] > 0) alone[i] = 0;
+            for (auto next = grid->getForwardIndex(this->cells[i], direction); next != Grid::WALL && alone[i];
+                 next = grid->getForwardIndex(next, direction))
             {
-                return this->m_species[i];
+                if (this->aims[next] > 1 || grid->isOccupied(next)) alone[i] = 0;
+                if (!archer) break;
             }
         }
-        return NULL;
     }
     
-    inline int World::getCreatureNum() const
+    /**
+     * @version 3.0 Added
+     * @param size the number of lanes
+     */
+    void LaneTable::resize(unsigned int size)
     {
-        return this->numCreatures;
+        this->id.resize(size);
+        this->cell.resize(size);
+        this->steps.resize(size);
+        this->direction.resize(size);
+        this->fly.resize(size);
     }
     
-    inline int World::getSpeciesNum() const
-    {
-        return this->numSpecies;
+    /**
+     * @version 3.0 Added
+     * Runs the turns of the creatures in laneTable, all of one species, as
+     * creatureMove would. Each lane waits at the instruction of its program
+     * counter. The instruction then runs for all the lanes waiting at it, so
+     * that it is decoded once for them and a test runs over them in one loop,
+     * and each lane moves on to wait at the next instruction it runs. The
+     * lanes are alone, so they need not keep in step with each other. An
+     * ending instruction runs creature by creature and retires the lane, as
+     * does a turn that runs off the program or more steps than the program
+     * holds. The program counter of a retired lane goes back to the table.
+     * @param species the index of the species
+     * @param profile where to count the instructions, if any
+     */
+    void Controller::runLanes(unsigned int species, RoundProfile *profile)
+    {
+        auto grid = this->world->getGrid();
+        auto &table = this->world->getTable();
+        auto code = this->world->getSpecies(species)->getCode();
+        auto size = this->world->getSpecies(species)->getProgramSize();
+        auto &lanes = this->laneTable;
+        auto &waiting = this->laneQueues;
+        if (waiting.size() < size)
+        {
+            waiting.resize(size);
+        }
+    
+        // Move lane k to wait at instruction pc, or retire it if its turn ends
+        // there without an action
+        auto moveLane = [&](unsigned int k, unsigned int pc)
+        {
+            if (pc >= size || lanes.steps[k] > size)
+            {
+                table.programID[lanes.id[k]] = pc;
+                return;
+            }
+            waiting[pc].push_back(k);
+        };
+        for (unsigned int k = 0; k < lanes.id.size(); k++)
+        {
+            lanes.steps[k] = 0;
+            moveLane(k, table.programID[lanes.id[k]]);
+        }
+    
+        // Sweep the instructions in order until no lane is left waiting; only a
+        // jump backwards needs another sweep
+        auto &batch = this->laneBatch;
+        for (bool more = true; more;)
+        {
+            more = false;
+            for (unsigned int pc = 0; pc < size; pc++)
+            {
+                if (waiting[pc].empty()) continue;
+                batch.swap(waiting[pc]);
+                waiting[pc].clear();
+                const auto &instruction = code[pc];
+                unsigned int address = instruction.address;
+                auto n = (unsigned int) batch.size();
+                if (profile != NULL && !Species::isEndOption(instruction.op))
+                {
+                    profile->instructions[instruction.op] += n;
+                    profile->species[species] += n;
+                }
+                more = more || (!Species::isEndOption(instruction.op) && address <= pc);
+                switch (instruction.op)
+                {
+                    case GO:
+                        for (auto k : batch)
+                        {
+                            lanes.steps[k]++;
+                            moveLane(k, address);
+                        }
+                        break;
+                    case IFEMPTY:
+                        for (auto k : batch)
+                        {
+                            auto next = grid->getForwardIndex(lanes.cell[k], direction_t(lanes.direction[k]));
+                            lanes.steps[k]++;
+                            moveLane(k, grid->isEmpty(next) ? address : pc + 1);
+                        }
+                        break;
+                    case IFWALL:
+                        for (auto k : batch)
+                        {
+                            auto next = grid->getForwardIndex(lanes.cell[k], direction_t(lanes.direction[k]));
+                            bool wall = next == Grid::WALL || (!lanes.fly[k] && grid->isTerrain(next, LAKE));
+                            lanes.steps[k]++;
+                            moveLane(k, wall ? address : pc + 1);
+                        }
+                        break;
+                    case IFSAME:
+                        for (auto k : batch)
+                        {
+                            auto next = grid->getForwardIndex(lanes.cell[k], direction_t(lanes.direction[k]));
+                            bool same = grid->isSpecies(next, species) && !grid->isTerrain(next, FOREST);
+                            lanes.steps[k]++;
+                            moveLane(k, same ? address : pc + 1);
+                        }
+                        break;
+                    case IFENEMY:
+                        for (auto k : batch)
+                        {
+                            auto next = grid->getForwardIndex(lanes.cell[k], direction_t(lanes.direction[k]));
+                            bool enemy = grid->isOccupied(next) && !grid->isSpecies(next, species) &&
+                                         !grid->isTerrain(next, FOREST);
+                            lanes.steps[k]++;
+                            moveLane(k, enemy ? address : pc + 1);
+                        }
+                        break;
+                    default:
+                        for (auto k : batch)
+                        {
+                            auto creature = this->world->getCreature(lanes.id[k]);
+                            table.programID[lanes.id[k]] = pc;
+                            if (profile == NULL) instruction.handler(creature, address);
+                            else this->profileInstruction(creature, instruction, *profile);
+                        }
+                        break;
+                }
+            }
+        }
     }
-
-
-    // controller.cpp
     
-    Controller::Controller(int argc, char *argv[])
-    {
-        if (argc < 4)
+    /**
+     * @version 3.0 Added
+     * Runs a quiet round with the same result as running the creatures in
+     * order, but runs the creatures of a species together, instruction by
+     * instruction, in lanes (see runLanes).
+     *
+     * The creatures alone (see findLoners) run in lanes, a species at a time.
+     * The others keep their order and run afterwards, one at a time.
+     */
+    void Controller::simulateRoundLanes()
+    {
+        TRACE_SCOPE("simulateRoundLanes");
+        auto &table = this->world->getTable();
+        unsigned int num = this->world->getCreatureNum();
+        auto profile = this->profilePath.empty() ? NULL : &this->profile;
+        auto &alone = this->alone;
+        this->findLoners(alone);
+    
+        // A creature alone runs in lanes, unless it stays on a hill
+        auto &ordered = this->ordered;
+        auto &bySpecies = this->bySpecies;
+        ordered.clear();
+        bySpecies.resize(this->world->getSpeciesNum());
+        for (auto &ids : bySpecies)
         {
-            throw MissingArgumentException();
+            ids.clear();
         }
-        std::stringstream(argv[3]) >> this->round_max;
-        if (round_max < 0)
+        for (unsigned int i = 0; i < num; i++)
         {
-            throw NegativeRoundException();
+            if (!alone[i])
+            {
+                ordered.push_back(i);
+                continue;
+            }
+            auto creature = this->world->getCreature(i);
+            if (creature->stayHill())
+            {
+                if (profile != NULL) profile->hillSkips++;
+                continue;
+            }
+            if (profile != NULL) profile->turns++;
+            bySpecies[creature->getSpeciesIndex()].push_back(i);
         }
-        this->world = new World();
-        this->verbose = false;
-        if (argc > 4)
+        for (unsigned int s = 0; s < bySpecies.size(); s++)
         {
-            std::string str = argv[4];
-            if (str == "v" || str == "verbose")
+            const auto &ids = bySpecies[s];
+            if (ids.empty()) continue;
+            auto &lanes = this->laneTable;
+            lanes.resize((unsigned int) ids.size());
+            for (unsigned int k = 0; k < ids.size(); k++)
             {
-                this->verbose = true;
+                lanes.id[k] = ids[k];
+                lanes.cell[k] = this->cells[ids[k]];
+                lanes.direction[k] = table.direction[ids[k]];
+                lanes.fly[k] = features_t::ABILITIES && (table.flags[ids[k]] & CreatureTable::FLAG_FLY);
+            }
+            this->runLanes(s, profile);
+            for (unsigned int k = 0; k < ids.size(); k++)
+            {
+                auto creature = this->world->getCreature(ids[k]);
+                if (!lanes.fly[k] && creature->isTerrain(HILL))
+                {
+                    creature->enterHill();
+                }
             }
         }
+        for (auto i : ordered)
+        {
+            this->creatureTurn(this->world->getCreature(i), profile);
+        }
     }
     
-    void Controller::readSpecies(const std::string &speciesPath)
+    /**
+     * @version 3.0 Print nothing when quiet
+     * @version 3.0 Count into the profile with --profile
+     * @version 3.0 Traced with ECE2800J_TRACE
+     * @version 3.0 Run in lanes with --lanes
+     */
+    void Controller::simulateRound()
     {
-        // Open the species summary file
-        std::ifstream speciesSummary(speciesPath);
-        std::string speciesDirectory;
-        if (!speciesSummary.is_open())
+        TRACE_SCOPE("simulateRound");
+        TRACE_COUNTER("creatures", this->world->getCreatureNum());
+        auto profile = this->profilePath.empty() ? NULL : &this->profile;
+        if (this->quiet)
         {
-            throw FailureFileException(speciesPath);
+            if (this->threads > 1)
+            {
+                this->simulateRoundParallel();
+                return;
+            }
+            if (this->lanes)
+            {
+                this->simulateRoundLanes();
+                return;
+            }
+            for (unsigned int i = 0; i < this->world->getCreatureNum(); i++)
+            {
+                this->creatureTurn(this->world->getCreature(i), profile);
+            }
+            return;
         }
-        speciesSummary >> speciesDirectory;
-        while (!speciesSummary.eof())
+        std::cout << "Round " << (this->round + 1) << std::endl;
+        for (unsigned int i = 0; i < this->world->getCreatureNum(); i++)
         {
-            // Open the files in the species directory
-            std::string speciesName;
-            speciesSummary >> speciesName;
-            if (speciesName.empty()) continue;
-            std::string speciesFullPath = speciesDirectory;
-            speciesFullPath += "/" + speciesName;
-            std::ifstream speciesFile(speciesFullPath);
-            if (!speciesFile.is_open())
+            auto creature = this->world->getCreature(i);
+            if (creature->stayHill())
             {
-                throw FailureFileException(speciesFullPath);
+                if (profile != NULL) profile->hillSkips++;
+                continue;
             }
-    
-            // Examine the number of current species before adding a new one
-            if (this->world->getSpeciesNum() >= MAXSPECIES)
+            if (profile != NULL) profile->turns++;
+            std::cout << "Creature (" << creature->serialize() << ") takes action:";
+            this->creatureMove(creature, profile);
+            std::cout << std::endl;
+            if (this->verbose) std::cout << this->world->getGrid()->serialize();
+            if (creature->isTerrain(HILL) && !creature->hasAbility(FLY))
             {
-                throw TooManySpeciesException();
+                creature->enterHill();
             }
+        }
+        if (!this->verbose) std::cout << this->world->getGrid()->serialize();
+    }
     
-            // Create the species
-            auto species = this->world->addSpecies(new Species(speciesName));
-            std::stringstream ss;
-            while (!speciesFile.eof())
+    /**
+     * @version 3.0 Added
+     * @version 3.0 Report only the squares changed with --delta
+     * @param title the line before the report
+     * @param whole whether to report the whole grid even with --delta
+     * Appends the grid, the squares changed since the last report, or the
+     * number of creatures of every species, to the buffer
+     */
+    void Controller::report(const std::string &title, bool whole)
+    {
+        if (this->digest)
+        {
+            this->reportDigest(title);
+            return;
+        }
+        this->buffer += title;
+        this->buffer += '\n';
+        if (this->stats)
+        {
+            for (unsigned int i = 0; i < this->world->getSpeciesNum(); i++)
             {
-                std::string optionLine, optionStr;
-                int optionAddress = 0;
-                std::getline(speciesFile, optionLine);
-                ss.clear();
-                ss.str(optionLine);
-                if (!ss.eof()) ss >> optionStr;
-                if (optionStr.empty()) break;
-                if (!ss.eof()) ss >> optionAddress;
-    
-                species->addInstruction(optionStr, optionAddress);
-    
+                auto species = this->world->getSpecies(i);
+                this->buffer += species->getName();
+                this->buffer += ": ";
+                this->buffer += std::to_string(this->world->getGrid()->count(species));
+                this->buffer += '\n';
             }
-            speciesFile.close();
+        } else if (this->delta && !whole)
+        {
+            this->world->getGrid()->serializeChanges(this->buffer);
+        } else
+        {
+            this->world->getGrid()->serialize(this->buffer);
         }
-        speciesSummary.close();
+        if (this->buffer.size() >= BUFFER_SIZE) this->flush();
     }
     
     /**
-     * @version 2.0 Add terrains and abilities
+     * @version 3.0 Added
+     * Appends "<title> <digest>" to the buffer, the digest in hexadecimal, or
+     * with --verify checks it against the next line of the digest file
      * @throws FailureFileException
-     * @throws IllegalHeightException
-     * @throws IllegalWidthException
-     * @throws TooManyCreatureException
-     * @param worldPath
+     * @throws DigestMismatchException
+     * @param title
      */
-    void Controller::readWorld(const std::string &worldPath)
-    {
-        std::ifstream worldFile(worldPath);
-        if (!worldFile.is_open())
+    void Controller::reportDigest(const std::string &title)
+    {
+        // Each digest covers the ones before, so that one line that matches
+        // vouches for the whole run up to it
+        uint64_t digest = this->world->digest() ^ this->lastDigest;
+        digest *= 0x9E3779B97F4A7C15ULL;
+        this->lastDigest = digest ^ (digest >> 29);
+        char hex[17];
+        snprintf(hex, sizeof(hex), "%016llx", (unsigned long long) this->lastDigest);
+        std::string line = title + " " + hex;
+        if (this->verifyPath.empty())
         {
-            throw FailureFileException(worldPath);
+            this->buffer += line;
+            this->buffer += '\n';
+            if (this->buffer.size() >= BUFFER_SIZE) this->flush();
+            return;
         }
-    
-        // Read height and width
-        int height = 0, width = 0;
-        worldFile >> height >> width;
-        if (height <= 0 || height > MAXHEIGHT)
+        if (this->golden.empty() && this->verified == 0)
         {
-            throw IllegalHeightException();
+            std::ifstream file(this->verifyPath);
+            if (!file.is_open())
+            {
+                throw FailureFileException(this->verifyPath);
+            }
+            std::string goldenLine;
+            while (std::getline(file, goldenLine))
+            {
+                if (!goldenLine.empty()) this->golden.push_back(goldenLine);
+            }
         }
-        if (width <= 0 || width > MAXWIDTH)
+        if (this->verified >= this->golden.size() || this->golden[this->verified] != line)
         {
-            throw IllegalWidthException();
+            throw DigestMismatchException(title, this->verifyPath);
         }
-        this->world->getGrid()->setSize((unsigned) height, (unsigned) width);
+        this->verified++;
+    }
+    
+    /**
+     * @version 3.0 Added
+     * Writes out the buffer
+     */
+    void Controller::flush()
+    {
+        std::cout.write(this->buffer.data(), this->buffer.size());
+        this->buffer.clear();
+    }
     
-        // Read the terrain of each box, assuming that the format is correct
-        for (int i = 0; i < height; i++)
+    /**
+     * @version 3.0 Report every few rounds only when quiet
+     * @version 3.0 Continue from the round of a snapshot, and save one at the
+     * end with --save
+     * @version 3.0 Check every digest of the file of --verify was matched
+     * @version 3.0 Skip the periods of a cycle with --cycles
+     * @throws DigestMismatchException
+     */
+    void Controller::simulate()
+    {
+        int last = this->round + this->round_max;
+        if (this->quiet)
         {
-            for (int j = 0; j < width; j++)
+            this->report("Initial state", true);
+            this->world->getGrid()->setTracking(this->delta && !this->stats);
+            // The changes of --delta and the rows of --profile are of every
+            // round, so none is skipped with them
+            bool cycles = this->cycles && !this->delta && this->profilePath.empty();
+            if (cycles)
             {
-                char terrain;
-                worldFile >> terrain;
-                this->world->getGrid()->setTerrain(point_t{i, j}, terrain);
+                this->findCycle(this->round);
             }
-        }
-    
-        // Read creatures
-        std::stringstream ss;
-        while (!worldFile.eof())
+            for (; this->round < last; this->round++)
+            {
+                this->nextRound();
+                if (cycles && this->period == 0)
+                {
+                    this->findCycle(this->round + 1);
+                }
+                if ((this->round + 1) % this->every == 0 || this->round + 1 == last)
+                {
+                    this->report("Round " + std::to_string(this->round + 1));
+                }
+                if (this->period > 0)
+                {
+                    // The state after a whole number of periods is this one,
+                    // so those up to the next report are skipped and the
+                    // rounds left over are simulated
+                    long long done = this->round + 1;
+                    long long next = std::min<long long>(last, (done / this->every + 1) * this->every);
+                    this->round += int((next - 1 - done) / this->period * this->period);
+                }
+            }
+            if (!this->verifyPath.empty())
+            {
+                if (this->verified != this->golden.size())
+                {
+                    throw DigestMismatchException("Round " + std::to_string(this->round + 1), this->verifyPath);
+                }
+                this->buffer += "Verified " + std::to_string(this->verified) + " digests\n";
+            }
+            this->flush();
+        } else
         {
-            std::string worldLine;
-            getline(worldFile, worldLine);
-            if (worldLine.empty())continue;
-            if (this->world->getCreatureNum() >= MAXCREATURES)
+            std::cout << "Initial state" << std::endl;
+            std::cout << this->world->getGrid()->serialize();
+            for (; this->round < last; this->round++)
             {
-                throw TooManyCreatureException();
+                this->nextRound();
             }
-            ss.clear();
-            ss.str(worldLine);
-            std::string name, direction;
-            int row, column;
-            ss >> name >> direction >> row >> column;
+        }
+        if (!this->profilePath.empty())
+        {
+            this->writeProfile();
+        }
+        if (!this->savePath.empty())
+        {
+            this->world->saveSnapshot(this->savePath, this->round);
+        }
+    }
+    
+    /**
+     * @version 3.0 Added
+     * @param numSpecies
+     * Sets every count to 0, with one count per species
+     */
+    void RoundProfile::clear(unsigned int numSpecies)
+    {
+        this->turns = this->hillSkips = this->infections = 0;
+        std::fill(this->instructions, this->instructions + OP_SIZE, 0);
+        this->species.assign(numSpecies, 0);
+    }
+    
+    /**
+     * @version 3.0 Added
+     * @param profile counted with the same species
+     */
+    void RoundProfile::add(const RoundProfile &profile)
+    {
+        this->turns += profile.turns;
+        this->hillSkips += profile.hillSkips;
+        this->infections += profile.infections;
+        for (int i = 0; i < OP_SIZE; i++)
+        {
+            this->instructions[i] += profile.instructions[i];
+        }
+        for (size_t i = 0; i < this->species.size(); i++)
+        {
+            this->species[i] += profile.species[i];
+        }
+    }
+    
+    /**
+     * @version 3.0 Added
+     * Simulates a round, and with --profile times it and keeps its counts as a
+     * line of CSV
+     */
+    void Controller::nextRound()
+    {
+        if (this->profilePath.empty())
+        {
+            this->simulateRound();
+            return;
+        }
+        this->profile.clear(this->world->getSpeciesNum());
+        auto start = std::chrono::steady_clock::now();
+        this->simulateRound();
+        std::chrono::duration<double, std::milli> wall = std::chrono::steady_clock::now() - start;
     
-            auto creature = new Creature(this->world, name, direction, row, column);
-            this->world->addCreature(creature);
+        uint64_t instructions = 0;
+        for (auto count : this->profile.instructions)
+        {
+            instructions += count;
+        }
+        std::ostringstream row;
+        row << this->round + 1 << ',' << wall.count() << ',' << this->profile.turns << ','
+            << this->profile.hillSkips << ',' << instructions << ','
+            << (this->profile.turns ? double(instructions) / this->profile.turns : 0.0) << ','
+            << this->profile.infections;
+        for (auto count : this->profile.instructions)
+        {
+            row << ',' << count;
+        }
+        for (auto count : this->profile.species)
+        {
+            row << ',' << count;
+        }
+        row << '\n';
+        this->profileRows += row.str();
+    }
     
-            std::string ability;
-            while (!ss.eof())
+    /**
+     * @version 3.0 Added
+     * @param done the number of rounds simulated so far
+     * Looks the state up among those seen after the earlier rounds. One seen
+     * before is kept, and compared with the state one period later, which
+     * sets the period if they are the same: two digests may collide, but two
+     * tables that are the same repeat forever, since a round only depends on
+     * the table.
+     */
+    void Controller::findCycle(int done)
+    {
+        auto &table = this->world->getTable();
+        if (this->cycleRound >= 0)
+        {
+            if (done < this->cycleRound + this->cycleLength)
             {
-                ss >> ability;
-                if (ability.length() > 0) creature->addAbility(ability);
+                return;
             }
-    
-            if (creature->isTerrain(LAKE) && !creature->hasAbility(FLY))
+            auto &kept = this->cycleState;
+            if (table.row == kept.row && table.column == kept.column && table.direction == kept.direction &&
+                table.species == kept.species && table.programID == kept.programID && table.flags == kept.flags)
             {
-                throw CannotFlyException(creature);
+                this->period = this->cycleLength;
+                this->seenStates.clear();
+                this->cycleState = CreatureTable();
+                return;
             }
+            this->cycleRound = -1;
+        }
+        uint64_t digest = this->world->digest();
+        auto seen = this->seenStates.find(digest);
+        if (seen != this->seenStates.end())
+        {
+            this->cycleRound = done;
+            this->cycleLength = done - seen->second;
+            this->cycleState = table;
+            return;
+        }
+        if (this->seenStates.size() >= CYCLE_WINDOW)
+        {
+            this->seenStates.clear();
         }
+        this->seenStates[digest] = done;
     }
     
-    void Controller::creatureMove(Creature *creature)
+    /**
+     * @version 3.0 Added
+     * Writes the profile of every round as CSV, with a header line
+     * @throws FailureFileException
+     */
+    void Controller::writeProfile() const
     {
-        auto species = creature->getSpecies();
-        auto programID = creature->getProgramID();
-        auto instruction = species->getInstruction(programID);
-        switch (instruction.op)
+        std::ofstream file(this->profilePath);
+        if (!file.is_open())
         {
-            case HOP:
-                creature->hop();
-                break;
-            case LEFT:
-                creature->left();
-                break;
-            case RIGHT:
-                creature->right();
-                break;
-            case INFECT:
-                creature->infect();
-                break;
-            case IFEMPTY:
-                creature->ifempty(instruction.address);
-                break;
-            case IFENEMY:
-                creature->ifenemy(instruction.address);
-                break;
-            case IFSAME:
-                creature->ifsame(instruction.address);
-                break;
-            case IFWALL:
-                creature->ifwall(instruction.address);
-                break;
-            case GO:
-                creature->go(instruction.address);
-                break;
-            default:
-                break;
+            throw FailureFileException(this->profilePath);
         }
-        if (this->verbose)
+        file << "round,wall_ms,turns,hill_skips,instructions,instructions_per_turn,infections";
+        for (const auto &name : opName)
         {
-            std::cout << std::endl << "Instruction " << programID + 1 << ":";
+            file << ",op_" << name;
         }
-        if (Species::isEndOption(instruction.op))
+        for (unsigned int i = 0; i < this->world->getSpeciesNum(); i++)
         {
-            std::cout << " " << Species::getOptionName(instruction.op);
-        } else
+            file << ",species_" << this->world->getSpecies(i)->getName();
+        }
+        file << '\n' << this->profileRows;
+        if (!file)
         {
-            if (this->verbose)
-            {
-                std::cout << " " << Species::getOptionName(instruction.op) << " " << instruction.address + 1;
-            }
-            creatureMove(creature);
+            throw FailureFileException(this->profilePath);
         }
     }
     
-    void Controller::simulateRound()
+    bool Controller::isEnsemble() const
     {
-        std::cout << "Round " << (this->round + 1) << std::endl;
-        for (unsigned int i = 0; i < this->world->getCreatureNum(); i++)
+        return this->ensemble;
+    }
+    
+    /**
+     * @version 3.0 Added
+     * Simulates one world of an ensemble with the options and the species of
+     * this controller, which are only read
+     * @param worldPath
+     * @return the population of every species after the last round, or the
+     * error that stopped the world
+     */
+    std::string Controller::simulateMember(const std::string &worldPath) const
+    {
+        Controller member(*this);
+        member.world = new World();
+        member.world->shareSpecies(*this->world);
+        member.quiet = member.stats = true;
+        member.delta = member.digest = false;
+        member.threads = 1;
+        member.buffer.clear();
+        member.profilePath.clear();
+        member.verifyPath.clear();
+        try
         {
-            auto creature = this->world->getCreature(i);
-            if (creature->stayHill()) continue;
-            std::cout << "Creature (" << creature->serialize() << ") takes action:";
-            this->creatureMove(creature);
-            std::cout << std::endl;
-            if (this->verbose) std::cout << this->world->getGrid()->serialize();
-            if (creature->isTerrain(HILL) && !creature->hasAbility(FLY))
+            member.readWorld(worldPath);
+            for (int last = member.round + member.round_max; member.round < last; member.round++)
             {
-                creature->enterHill();
+                member.simulateRound();
             }
+            member.report("World " + worldPath);
         }
-        if (!this->verbose) std::cout << this->world->getGrid()->serialize();
+        catch (MyException &e)
+        {
+            member.buffer = "World " + worldPath + "\n" + e.what() + "\n";
+        }
+        delete member.world;
+        return member.buffer;
     }
     
-    void Controller::simulate()
+    /**
+     * @version 3.0 Added
+     * Simulates every world listed in a file, separated by blanks, on up to
+     * --threads threads. The species are read once and shared by all worlds.
+     * Prints the summary of each world, in the order of the list.
+     * @throws FailureFileException
+     * @param listPath
+     */
+    void Controller::simulateEnsemble(const std::string &listPath)
     {
-        std::cout << "Initial state" << std::endl;
-        std::cout << this->world->getGrid()->serialize();
-        for (this->round = 0; this->round < this->round_max; this->round++)
+        std::string list;
+        if (!readFile(listPath, list))
         {
-            this->simulateRound();
+            throw FailureFileException(listPath);
+        }
+        std::vector<std::string> worldPaths;
+        const char *p = list.data(), *end = p + list.size(), *token;
+        size_t size;
+        while ((size = nextToken(p, end, token)) > 0)
+        {
+            worldPaths.push_back(std::string(token, size));
+        }
+    
+        std::vector<std::string> summaries(worldPaths.size());
+        std::atomic<size_t> next(0);
+        auto run = [&]()
+        {
+            for (size_t i; (i = next.fetch_add(1)) < worldPaths.size();)
+            {
+                summaries[i] = this->simulateMember(worldPaths[i]);
+            }
+        };
+        std::vector<std::thread> pool;
+        for (int t = 1; t < this->threads && size_t(t) < worldPaths.size(); t++)
+        {
+            pool.push_back(std::thread(run));
+        }
+        run();
+        for (auto &thread : pool)
+        {
+            thread.join();
         }
+        for (const auto &summary : summaries)
+        {
+            std::cout << summary;
+        }
+        std::cout.flush();
     }
 
 
@@ -809,7 +2891,7 @@ namespace p3
     MissingArgumentException::MissingArgumentException()
     {
         this->errStr[0] = "Error: Missing arguments!\n";
-        this->errStr[0] += "Usage: ./p3 <species-summary> <world-file> <rounds> [v|verbose]";
+        this->errStr[0] += std::string("Usage: ") + PROGRAM + " <species-summary> <world-file> <rounds> [v|verbose]";
     }
     
     NegativeRoundException::NegativeRoundException()
@@ -931,6 +3013,21 @@ namespace p3
         this->errStr[++errNum] = creature->serialize();
         this->make();
     }
+    
+    InvalidSnapshotException::InvalidSnapshotException(std::string filename)
+    {
+        this->errStr[0] = "Error: File <filename> is not a valid snapshot!";
+        this->errStr[++errNum] = filename;
+        this->make();
+    }
+    
+    DigestMismatchException::DigestMismatchException(std::string title, std::string filename)
+    {
+        this->errStr[0] = "Error: The digest of <TITLE> does not match file <filename>!";
+        this->errStr[++errNum] = title;
+        this->errStr[++errNum] = filename;
+        this->make();
+    }
 
 
 }
@@ -8,10 +8,47 @@
 #ifndef VE280_SIMULATION_H
 #define VE280_SIMULATION_H
 
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
 #include "world_type.h"
 
 namespace p3
 {
+    // Largest height and width of a grid when the limits of world_type.h
+    // are lifted, so that every square has a 32-bit index
+    const unsigned int LARGE_MAXSIZE = 65535;
+
+    // Size at which the output buffer of a quiet simulation is written out
+    const size_t BUFFER_SIZE = 1 << 20;
+
+    // Rounds whose states are remembered to find a cycle, with --cycles;
+    // they are forgotten after that many, which bounds the periods found
+    const size_t CYCLE_WINDOW = 1 << 16;
+
+    // The first bytes of a snapshot file, ending with its format version
+    const char SNAPSHOT_MAGIC[8] = {'P', '3', 'S', 'N', 'A', 'P', '0', '1'};
+
+    // The features of the world, fixed when compiling. Without terrain the
+    // world file holds no terrain and every square is a plain; without
+    // abilities the rest of a creature line is ignored. Each test of a
+    // missing feature is a constant, so it costs nothing at run time.
+    template<bool Terrain, bool Abilities>
+    struct WorldFeatures
+    {
+        static const bool TERRAIN = Terrain;
+        static const bool ABILITIES = Abilities;
+    };
+
+#ifdef P3_SIMPLE_WORLD
+    // The world of p3-simple-world, whose program was ./p4
+    typedef WorldFeatures<false, false> features_t;
+    const char PROGRAM[] = "./p4";
+#else
+    typedef WorldFeatures<true, true> features_t;
+    const char PROGRAM[] = "./p3";
+#endif
+
     // Definition of classes
     class Species;
 
@@ -58,6 +95,10 @@ namespace p3
 
     class CannotFlyException;
 
+    class InvalidSnapshotException;
+
+    class DigestMismatchException;
+
 
     template<class T>
     inline int length(T &a)
@@ -83,27 +124,117 @@ namespace p3
     class Species : protected species_t
     {
     public:
-        explicit Species(const std::string &);
+        // Runs one instruction on a creature, given its address, and
+        // returns whether it ends the creature's turn
+        typedef bool (*handler_t)(Creature *, unsigned int);
+
+        // An instruction with its handler resolved ahead of time
+        struct compiled_t
+        {
+            handler_t handler;
+            opcode_t op;
+            unsigned int address;
+        };
+
+    protected:
+        unsigned int index;     // The order in which the species was added
+        unsigned int maxProgram;    // 0 if the program size is unlimited
+        std::vector<instruction_t> instructions;
+        std::vector<compiled_t> code;
+    public:
+        explicit Species(const std::string &, const unsigned int & = MAXPROGRAM);
+
+        unsigned int getIndex() const;
+
+        void setIndex(const unsigned int &);
 
         static std::string getOptionName(const opcode_t &);
 
         static bool isEndOption(const opcode_t &);
 
+        static bool findOption(const char *, size_t, opcode_t &);
+
         const instruction_t &getInstruction(const int &) const;
 
         void addInstruction(const std::string &, const int & = 0);
 
-        std::string getName() const;
+        void compile();
+
+        const compiled_t *getCode() const;
+
+        unsigned int getProgramSize() const;
+
+        unsigned int findEndlessLoop() const;
+
+        const std::string &getName() const;
+    };
+
+    // The state of every creature of a world, one array per field and
+    // indexed by creature, so that a round walks each array in order
+    struct CreatureTable
+    {
+        enum flag_t
+        {
+            FLAG_FLY = 1 << FLY,
+            FLAG_ARCH = 1 << ARCH,
+            FLAG_HILL_ACTIVE = 1 << ABILITY_SIZE,
+        };
+
+        std::vector<int> row;
+        std::vector<int> column;
+        std::vector<unsigned char> direction;
+        std::vector<unsigned int> species;      // Index in the world
+        std::vector<unsigned int> programID;
+        std::vector<unsigned char> flags;       // Abilities and hill state
+
+        unsigned int size() const;
+
+        unsigned int add(const point_t &);
+    };
+
+    // The creatures of a quiet round run in lanes, one array per field as
+    // in CreatureTable and indexed by lane
+    struct LaneTable
+    {
+        std::vector<unsigned int> id;       // Index in the creature table
+        std::vector<unsigned int> cell;     // Index of the square in the grid
+        std::vector<unsigned int> steps;    // Instructions run in the turn
+        std::vector<unsigned char> direction;
+        std::vector<unsigned char> fly;
+
+        void resize(unsigned int);
     };
 
-    class Creature : protected creature_t
+    // The header of a snapshot file. Each section starts at the given
+    // offset, a multiple of 8 bytes, so that a mapped file can be read in
+    // place: the species names, each ending with '\0', the bitmap of
+    // every terrain, and one array per field of the creature table. All
+    // values are in the byte order of the machine that wrote the file.
+    struct SnapshotHeader
+    {
+        char magic[8];
+        uint32_t height, width;
+        uint32_t numSpecies, numCreatures;
+        int32_t round;
+        uint32_t namesSize;
+        uint64_t names, terrains;
+        uint64_t row, column, direction, species, programID, flags;
+    };
+
+    class Creature
     {
     protected:
         World *m_world;
+        CreatureTable *m_table;     // The table of m_world
+        unsigned int id;    // The index of the creature in the table
+
+        CreatureTable &table() const;
     public:
 
         explicit Creature(World *, std::string, std::string, int, int);
 
+        explicit Creature(World *, unsigned int);
+
         unsigned int getProgramID() const;
 
         void addAbility(std::string ability);
@@ -112,13 +243,17 @@ namespace p3
 
         static const std::string& getDirectionName(const direction_t &, bool = false);
 
+        static bool findDirection(const char *, size_t, direction_t &);
+
         void changeSpecies(const Species *);
 
         const Species *getSpecies() const;
 
+        unsigned int getSpeciesIndex() const;
+
         direction_t getDirection() const;
 
-        const point_t &getLocation() const;
+        point_t getLocation() const;
 
         const World *getWorld() const;
 
@@ -136,13 +271,15 @@ namespace p3
 
         point_t getForwardLocation() const;
 
+        unsigned int getForwardIndex() const;
+
         void hop();
 
         void left();
 
         void right();
 
-        void infect();
+        bool infect();
 
         void ifempty(unsigned int);
 
@@ -159,65 +296,261 @@ namespace p3
         void enterHill();
     };
 
-    class Grid : protected grid_t
+    class Grid
     {
+    protected:
+        unsigned int height;
+        unsigned int width;
+
+        // The creature on every square, or NULL, in tiles of TILE_SIZE
+        // squares a side, row by row. A tile is allocated only once a
+        // creature enters it, so a sparse world needs only a few.
+        static const unsigned int TILE_SIZE = 64;
+        unsigned int tileColumns;
+        std::vector<std::vector<Creature *> > tiles;
+
+        // One bit per square, row by row: whether it is occupied, whether
+        // it is of each terrain, and whether it holds each species
+        std::vector<uint64_t> occupied;
+        std::vector<uint64_t> terrains[TERRAIN_SIZE];
+        std::vector<std::vector<uint64_t> > species;
+
+        // For every direction: the step between the indices of a square
+        // and the next, and one bit per square whose next one is outside
+        int steps[DIRECT_SIZE];
+        std::vector<uint64_t> walls[DIRECT_SIZE];
+
+        // One bit per square that changed since the last serializeChanges,
+        // kept only when tracking
+        bool tracking;
+        std::vector<uint64_t> changed;
+
+        unsigned int bitIndex(const point_t &) const;
+
+        unsigned int tileIndex(const point_t &) const;
+
+        static unsigned int tileOffset(const point_t &);
+
+        Creature *&square(const point_t &);
+
+        static bool testBit(const std::vector<uint64_t> &, unsigned int);
+
+        static void setBit(std::vector<uint64_t> &, unsigned int, bool);
+
+        std::vector<uint64_t> &speciesBits(const Species *);
+
+        std::vector<uint64_t> &speciesBits(unsigned int);
+
+        void serializeSquare(std::string &, const point_t &) const;
+
     public:
+        // The index of the square beyond a wall
+        static const unsigned int WALL = ~0u;
 
-        explicit Grid(grid_t &);
+        explicit Grid();
 
         void setSize(const unsigned int &, const unsigned int &);
 
         void setTerrain(const point_t &, char);
 
+        size_t getWords() const;
+
+        const uint64_t *getTerrainBits(terrain_t) const;
+
+        void setTerrainBits(terrain_t, const uint64_t *);
+
         bool isInside(const point_t &) const;
 
         bool isTerrain(const point_t &, terrain_t) const;
 
+        bool isTerrain(unsigned int, terrain_t) const;
+
+        unsigned int getIndex(const point_t &) const;
+
+        unsigned int getForwardIndex(unsigned int, direction_t) const;
+
         void addCreature(Creature *);
 
         Creature *getCreature(const point_t &) const;
 
-        int getHeight() const;
+        void reserveSquare(const point_t &);
+
+        bool isOccupied(const point_t &) const;
+
+        bool isEmpty(const point_t &) const;
+
+        bool isOccupied(unsigned int) const;
+
+        bool isEmpty(unsigned int) const;
 
-        int getWidth() const;
+        bool isSpecies(const point_t &, unsigned int) const;
 
-        void move(const point_t &, const point_t &);
+        bool isSpecies(unsigned int, unsigned int) const;
+
+        void changeSpecies(const point_t &, const Species *, const Species *);
+
+        unsigned int getHeight() const;
+
+        unsigned int getWidth() const;
+
+        void move(const point_t &, const point_t &, unsigned int);
+
+        unsigned int count(const Species *) const;
+
+        void addSpecies(const Species *);
+
+        void serialize(std::string &) const;
 
         std::string serialize() const;
+
+        void setTracking(bool);
+
+        void touch(const point_t &);
+
+        void serializeChanges(std::string &);
     };
 
     class World : protected world_t
     {
     protected:
-        Species *m_species[MAXSPECIES];
-        Creature *m_creatures[MAXCREATURES];
+        std::vector<Species *> m_species;
+        bool ownsSpecies;   // False if m_species belongs to another world
+        std::vector<Creature> m_creatures;  // Contiguous; reserved up front
+        CreatureTable m_table;
+        Grid m_grid;
     public:
 
         explicit World();
 
+        ~World();
+
+        void shareSpecies(const World &);
+
         Grid *getGrid() const;
 
-        Creature *addCreature(Creature *);
+        void reserveCreatures(const unsigned int &);
+
+        Creature *addCreature(const std::string &, const std::string &, int, int);
 
         Creature *getCreature(const point_t &) const;
 
         Creature *getCreature(const unsigned int &) const;
 
+        CreatureTable &getTable();
+
         Species *addSpecies(Species *);
 
         Species *getSpecies(const std::string &) const;
 
-        int getCreatureNum() const;
+        Species *getSpecies(const unsigned int &) const;
 
-        int getSpeciesNum() const;
+        unsigned int getCreatureNum() const;
+
+        unsigned int getSpeciesNum() const;
+
+        uint64_t digest() const;
+
+        static bool isSnapshot(const std::string &);
+
+        void saveSnapshot(const std::string &, int) const;
+
+        int loadSnapshot(const std::string &);
+    };
+
+    // What the creatures did in a round, counted with --profile
+    struct RoundProfile
+    {
+        uint64_t turns, hillSkips, infections;
+        uint64_t instructions[OP_SIZE];     // Per opcode
+        std::vector<uint64_t> species;      // Instructions per species
+
+        void clear(unsigned int);
+
+        void add(const RoundProfile &);
     };
 
     class Controller
     {
     private:
         int round, round_max;
+        std::string savePath;   // Where to save a snapshot at the end, --save
+        std::string profilePath;    // Where to write the profile, --profile
+        RoundProfile profile;       // Of the current round
+        std::string profileRows;    // One line of CSV per round so far
         bool verbose;
+        bool limited;   // Whether the limits of world_type.h are enforced
+        bool quiet;     // Whether actions are left out, -q or --stats
+        bool stats;     // Whether reports are population counts, --stats
+        bool delta;     // Whether reports are the squares changed, --delta
+        bool digest;    // Whether reports are digests of the state, --digest
+        int every;      // Rounds between reports when quiet
+        int threads;    // Threads that run a quiet round, --threads
+        bool lanes;     // Whether a quiet round runs in lanes, --lanes
+        bool ensemble;  // Whether the world file lists worlds, --ensemble
+        bool cycles;    // Whether a quiet run skips the periods of a cycle, --cycles
+        std::string buffer;
         World *world;
+
+        // For a parallel round: the first creature to touch each square,
+        // and the sets of creatures that touch the same squares
+        std::vector<unsigned int> claims;
+        std::vector<unsigned int> parent;
+
+        // For a round in lanes: how many creatures aim at each square, up to
+        // 2, the square of each creature and whether it is alone, the
+        // creatures left in order and the lanes of each species, and the
+        // lanes waiting at each instruction
+        std::vector<unsigned char> aims;
+        std::vector<unsigned int> cells;
+        std::vector<unsigned char> alone;
+        std::vector<unsigned int> ordered;
+        std::vector<std::vector<unsigned int> > bySpecies;
+        LaneTable laneTable;
+        std::vector<std::vector<unsigned int> > laneQueues;
+        std::vector<unsigned int> laneBatch;
+
+        // The digest of the last report, which every report folds into its
+        // own, and the digests expected with --verify
+        uint64_t lastDigest;
+        std::string verifyPath;
+        std::vector<std::string> golden;
+        size_t verified;
+
+        // With --cycles: the round after which each state was seen, by
+        // digest; a state seen before, kept until a period later to check
+        // that it repeats; and the period once it does
+        std::unordered_map<uint64_t, int> seenStates;
+        CreatureTable cycleState;
+        int cycleRound, cycleLength;
+        int period;
+
+        void report(const std::string &, bool = false);
+
+        void reportDigest(const std::string &);
+
+        void flush();
+
+        void creatureTurn(Creature *, RoundProfile * = NULL);
+
+        bool profileInstruction(Creature *, const Species::compiled_t &, RoundProfile &);
+
+        void nextRound();
+
+        void findCycle(int);
+
+        void writeProfile() const;
+
+        unsigned int findSet(unsigned int);
+
+        void simulateRoundParallel();
+
+        void findLoners(std::vector<unsigned char> &);
+
+        void runLanes(unsigned int, RoundProfile *);
+
+        void simulateRoundLanes();
+
+        std::string simulateMember(const std::string &) const;
     public:
         explicit Controller(int argc, char *argv[]);
 
@@ -225,11 +558,15 @@ namespace p3
 
         void readWorld(const std::string &);
 
-        void creatureMove(Creature *);
+        void creatureMove(Creature *, RoundProfile * = NULL);
 
         void simulateRound();
 
         void simulate();
+
+        bool isEnsemble() const;
+
+        void simulateEnsemble(const std::string &);
     };
 
 
@@ -416,6 +753,26 @@ namespace p3
         explicit CannotFlyException(Creature *);
     };
 
+    /**
+     * Check whether a snapshot given as the world file is complete and
+     * describes a world that could have been read from a world file.
+     */
+    class InvalidSnapshotException : public MyException
+    {
+    public:
+        explicit InvalidSnapshotException(std::string);
+    };
+
+    /**
+     * Check whether the digests of a simulation match those of a digest
+     * file given with --verify.
+     */
+    class DigestMismatchException : public MyException
+    {
+    public:
+        explicit DigestMismatchException(std::string, std::string);
+    };
+
 }
 
 #endif //VE280_SIMULATION_H
@@ -0,0 +1,228 @@
+//
+// Binary snapshots of a world, which can be mapped and read in place.
+//
+
+#include <cstring>
+#include <fstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "simulation.h"
+
+using namespace p3;
+
+/**
+ * @version 3.0 Added
+ * @param path
+ * @return whether the file starts with SNAPSHOT_MAGIC
+ */
+bool World::isSnapshot(const std::string &path)
+{
+    char magic[sizeof(SNAPSHOT_MAGIC)] = {};
+    std::ifstream file(path, std::ios::binary);
+    file.read(magic, sizeof(magic));
+    return file && memcmp(magic, SNAPSHOT_MAGIC, sizeof(magic)) == 0;
+}
+
+/**
+ * @version 3.0 Added
+ * Writes the terrain, the species names and the state of every creature,
+ * so that loadSnapshot continues from the same point
+ * @throws FailureFileException
+ * @param path
+ * @param round the number of rounds simulated so far
+ */
+void World::saveSnapshot(const std::string &path, int round) const
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+    {
+        throw FailureFileException(path);
+    }
+
+    auto grid = this->getGrid();
+    auto &table = this->m_table;
+    std::string names;
+    for (auto species : this->m_species)
+    {
+        names += species->getName();
+        names += '\0';
+    }
+
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.height = (uint32_t) grid->getHeight();
+    header.width = (uint32_t) grid->getWidth();
+    header.numSpecies = (uint32_t) this->m_species.size();
+    header.numCreatures = table.size();
+    header.round = round;
+    header.namesSize = (uint32_t) names.size();
+
+    // Lay out the sections one after another, each aligned to 8 bytes
+    uint64_t end = sizeof(header);
+    auto place = [&end](uint64_t size)
+    {
+        auto offset = end;
+        end = (end + size + 7) / 8 * 8;
+        return offset;
+    };
+    uint64_t n = header.numCreatures;
+    header.names = place(names.size());
+    header.terrains = place(TERRAIN_SIZE * grid->getWords() * sizeof(uint64_t));
+    header.row = place(n * sizeof(int32_t));
+    header.column = place(n * sizeof(int32_t));
+    header.species = place(n * sizeof(uint32_t));
+    header.programID = place(n * sizeof(uint32_t));
+    header.direction = place(n);
+    header.flags = place(n);
+
+    uint64_t written = 0;
+    auto section = [&file, &written](uint64_t offset, const void *data, uint64_t size)
+    {
+        static const char zeros[8] = {};
+        file.write(zeros, std::streamsize(offset - written));
+        file.write((const char *) data, std::streamsize(size));
+        written = offset + size;
+    };
+    section(0, &header, sizeof(header));
+    section(header.names, names.data(), names.size());
+    for (int i = 0; i < TERRAIN_SIZE; i++)
+    {
+        section(header.terrains + i * grid->getWords() * sizeof(uint64_t),
+                grid->getTerrainBits(terrain_t(i)), grid->getWords() * sizeof(uint64_t));
+    }
+    section(header.row, table.row.data(), n * sizeof(int32_t));
+    section(header.column, table.column.data(), n * sizeof(int32_t));
+    section(header.species, table.species.data(), n * sizeof(uint32_t));
+    section(header.programID, table.programID.data(), n * sizeof(uint32_t));
+    section(header.direction, table.direction.data(), n);
+    section(header.flags, table.flags.data(), n);
+    section(end, NULL, 0);
+    if (!file)
+    {
+        throw FailureFileException(path);
+    }
+}
+
+/**
+ * @version 3.0 Added
+ * Restores the grid and the creatures from a snapshot, mapping the file
+ * and copying each section as a whole. The species, read beforehand, must
+ * be the ones of the snapshot in the same order.
+ * @throws FailureFileException
+ * @throws InvalidSnapshotException
+ * @throws UnknownSpeciesException
+ * @throws OutsideBoundaryException
+ * @throws OverlapCreatureException
+ * @param path
+ * @return the number of rounds simulated before the snapshot was saved
+ */
+int World::loadSnapshot(const std::string &path)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        throw FailureFileException(path);
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || size_t(info.st_size) < sizeof(SnapshotHeader))
+    {
+        close(fd);
+        throw InvalidSnapshotException(path);
+    }
+    uint64_t size = uint64_t(info.st_size);
+    void *mapped = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED)
+    {
+        throw FailureFileException(path);
+    }
+    auto data = (const char *) mapped;
+    auto unmap = [mapped, size]()
+    {
+        munmap(mapped, size);
+    };
+
+    SnapshotHeader header;
+    memcpy(&header, data, sizeof(header));
+    uint64_t n = header.numCreatures;
+    uint64_t words = (uint64_t(header.height) * header.width + 63) / 64;
+    auto fits = [size](uint64_t offset, uint64_t length)
+    {
+        return offset % 8 == 0 && offset <= size && length <= size - offset;
+    };
+    if (memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0 || header.round < 0 ||
+        header.height == 0 || header.width == 0 ||
+        header.height > LARGE_MAXSIZE || header.width > LARGE_MAXSIZE ||
+        !fits(header.names, header.namesSize) ||
+        (header.namesSize > 0 && data[header.names + header.namesSize - 1] != '\0') ||
+        !fits(header.terrains, TERRAIN_SIZE * words * sizeof(uint64_t)) ||
+        !fits(header.row, n * sizeof(int32_t)) || !fits(header.column, n * sizeof(int32_t)) ||
+        !fits(header.species, n * sizeof(uint32_t)) || !fits(header.programID, n * sizeof(uint32_t)) ||
+        !fits(header.direction, n) || !fits(header.flags, n))
+    {
+        unmap();
+        throw InvalidSnapshotException(path);
+    }
+
+    // The species of the snapshot must be the ones read, by index
+    auto name = data + header.names;
+    for (uint32_t i = 0; i < header.numSpecies; i++)
+    {
+        if (name >= data + header.names + header.namesSize)
+        {
+            unmap();
+            throw InvalidSnapshotException(path);
+        }
+        std::string speciesName(name);
+        name += speciesName.size() + 1;
+        if (i >= this->m_species.size() || this->m_species[i]->getName() != speciesName)
+        {
+            unmap();
+            throw UnknownSpeciesException(speciesName);
+        }
+    }
+
+    auto grid = this->getGrid();
+    grid->setSize(header.height, header.width);
+    for (int i = 0; i < TERRAIN_SIZE; i++)
+    {
+        grid->setTerrainBits(terrain_t(i),
+                             (const uint64_t *) (data + header.terrains + i * words * sizeof(uint64_t)));
+    }
+
+    auto &table = this->m_table;
+    auto row = (const int32_t *) (data + header.row);
+    auto column = (const int32_t *) (data + header.column);
+    auto species = (const uint32_t *) (data + header.species);
+    auto programID = (const uint32_t *) (data + header.programID);
+    auto direction = (const unsigned char *) (data + header.direction);
+    auto flags = (const unsigned char *) (data + header.flags);
+    table.row.assign(row, row + n);
+    table.column.assign(column, column + n);
+    table.species.assign(species, species + n);
+    table.programID.assign(programID, programID + n);
+    table.direction.assign(direction, direction + n);
+    table.flags.assign(flags, flags + n);
+    unmap();
+
+    this->m_creatures.clear();
+    this->m_creatures.reserve(n);
+    for (unsigned int i = 0; i < n; i++)
+    {
+        if (table.species[i] >= header.numSpecies || table.direction[i] >= length(directName))
+        {
+            throw InvalidSnapshotException(path);
+        }
+        this->m_creatures.emplace_back(this, i);
+        auto creature = &this->m_creatures.back();
+        if (!creature->isInside()) throw OutsideBoundaryException(creature);
+        auto origin = this->getCreature(creature->getLocation());
+        if (origin != NULL) throw OverlapCreatureException(creature, origin);
+        grid->addCreature(creature);
+    }
+    this->numCreatures = (int) n;
+    return header.round;
+}
@@ -5,10 +5,27 @@
 #include "simulation.h"
 using namespace p3;
 
-Species::Species(const std::string &name)
+/**
+ * @version 3.0 Hold the program in a vector; maxProgram 0 means no limit
+ * @param name
+ * @param maxProgram
+ */
+Species::Species(const std::string &name, const unsigned int &maxProgram)
 {
     this->name = name;
     this->programSize = 0;
+    this->index = 0;
+    this->maxProgram = maxProgram;
+}
+
+inline unsigned int Species::getIndex() const
+{
+    return this->index;
+}
+
+inline void Species::setIndex(const unsigned int &index)
+{
+    this->index = index;
 }
 
 inline std::string Species::getOptionName(const opcode_t &op)
@@ -23,32 +40,236 @@ inline bool Species::isEndOption(const opcode_t &opcode)
 
 inline const instruction_t& Species::getInstruction(const int &programID) const
 {
-    return this->program[programID];
+    return this->instructions[programID];
 }
 
+static unsigned int hashOption(const char *str, size_t size)
+{
+    return (unsigned char) str[0] + (unsigned char) str[size - 2] + size;
+}
+
+/**
+ * @version 3.0 Added
+ * Looks the name up by a hash that is perfect on opName: the first and
+ * the last but one characters and the length, modulo 16
+ * @param str
+ * @param size
+ * @param op set to the instruction named
+ * @return whether str is the name of an instruction
+ */
+bool Species::findOption(const char *str, size_t size, opcode_t &op)
+{
+    static const std::vector<int> table = []()
+    {
+        std::vector<int> table(16, -1);
+        for (int i = 0; i < length(opName); i++)
+        {
+            table[hashOption(opName[i].data(), opName[i].size()) % 16] = i;
+        }
+        return table;
+    }();
+    if (size < 2) return false;
+    int i = table[hashOption(str, size) % 16];
+    if (i < 0 || opName[i].size() != size || opName[i].compare(0, size, str, size) != 0)
+    {
+        return false;
+    }
+    op = opcode_t(i);
+    return true;
+}
+
+/**
+ * @version 3.0 Find the instruction by findOption
+ * @throws TooManyInstructionException
+ * @throws UnknownInstructionException
+ * @param op
+ * @param address
+ */
 void Species::addInstruction(const std::string &op, const int &address)
 {
-    if (this->programSize >= MAXPROGRAM)
+    if (this->maxProgram && this->programSize >= this->maxProgram)
     {
         throw TooManyInstructionException(this->name);
     }
-    for (auto opcode_i = HOP; opcode_i < length(opName); opcode_i++)
+    opcode_t opcode;
+    if (!findOption(op.data(), op.size(), opcode))
     {
-        if (op == opName[opcode_i])
+        throw UnknownInstructionException(op);
+    }
+    instruction_t instruction = {opcode, 0};
+    if (!isEndOption(opcode))
+    {
+        instruction.address = address - 1;
+    }
+    this->instructions.push_back(instruction);
+    this->programSize++;
+}
+
+inline const std::string &Species::getName() const
+{
+    return this->name;
+}
+
+static bool runHop(Creature *creature, unsigned int)
+{
+    creature->hop();
+    return true;
+}
+
+static bool runLeft(Creature *creature, unsigned int)
+{
+    creature->left();
+    return true;
+}
+
+static bool runRight(Creature *creature, unsigned int)
+{
+    creature->right();
+    return true;
+}
+
+static bool runInfect(Creature *creature, unsigned int)
+{
+    creature->infect();
+    return true;
+}
+
+static bool runIfempty(Creature *creature, unsigned int address)
+{
+    creature->ifempty(address);
+    return false;
+}
+
+static bool runIfenemy(Creature *creature, unsigned int address)
+{
+    creature->ifenemy(address);
+    return false;
+}
+
+static bool runIfsame(Creature *creature, unsigned int address)
+{
+    creature->ifsame(address);
+    return false;
+}
+
+static bool runIfwall(Creature *creature, unsigned int address)
+{
+    creature->ifwall(address);
+    return false;
+}
+
+static bool runGo(Creature *creature, unsigned int address)
+{
+    creature->go(address);
+    return false;
+}
+
+/**
+ * @version 3.0 Added
+ * Resolves the handler of every instruction, so that running the program
+ * needs no decoding. Must be called again after adding instructions.
+ */
+void Species::compile()
+{
+    static const handler_t handlers[] = {runHop, runLeft, runRight, runInfect, runIfempty,
+                                         runIfenemy, runIfsame, runIfwall, runGo};
+    this->code.clear();
+    for (const auto &instruction : this->instructions)
+    {
+        this->code.push_back(compiled_t{handlers[instruction.op], instruction.op, instruction.address});
+    }
+}
+
+inline const Species::compiled_t *Species::getCode() const
+{
+    return this->code.data();
+}
+
+inline unsigned int Species::getProgramSize() const
+{
+    return this->programSize;
+}
+
+/**
+ * @version 3.0 Added
+ * A turn runs instructions until an ending one. The instructions in
+ * between change nothing, so a turn that comes back to an instruction
+ * never ends. Follows every jump the program could take from its start,
+ * over any number of turns.
+ * @return the number (from 1) of the first instruction the program can
+ * reach from which no ending instruction can be reached, or 0 if every
+ * turn can end
+ */
+unsigned int Species::findEndlessLoop() const
+{
+    auto size = this->programSize;
+
+    // The instructions a turn may run after each one; an ending one has
+    // none, since the turn stops there
+    std::vector<std::vector<unsigned int> > before(size);
+    for (unsigned int id = 0; id < size; id++)
+    {
+        auto op = this->instructions[id].op;
+        auto address = this->instructions[id].address;
+        if (isEndOption(op)) continue;
+        if (address < size) before[address].push_back(id);
+        if (op != GO && id + 1 < size) before[id + 1].push_back(id);
+    }
+
+    // Instructions from which some ending one can be reached, found
+    // backwards from the ending ones
+    std::vector<bool> canEnd(size, false);
+    std::vector<unsigned int> pending;
+    for (unsigned int id = 0; id < size; id++)
+    {
+        if (isEndOption(this->instructions[id].op))
         {
-            this->program[this->programSize].op = opcode_i;
-            if (!isEndOption(opcode_i))
+            canEnd[id] = true;
+            pending.push_back(id);
+        }
+    }
+    while (!pending.empty())
+    {
+        auto id = pending.back();
+        pending.pop_back();
+        for (auto from : before[id])
+        {
+            if (!canEnd[from])
             {
-                this->program[this->programSize].address = address - 1;
+                canEnd[from] = true;
+                pending.push_back(from);
             }
-            this->programSize++;
-            return;
         }
     }
-    throw UnknownInstructionException(op);
-}
 
-inline std::string Species::getName() const
-{
-    return this->name;
-}
\ No newline at end of file
+    // Instructions reachable from the start, where a turn after an ending
+    // instruction goes on with the next one
+    std::vector<bool> reached(size, false);
+    if (size > 0)
+    {
+        reached[0] = true;
+        pending.push_back(0);
+    }
+    while (!pending.empty())
+    {
+        auto id = pending.back();
+        pending.pop_back();
+        auto op = this->instructions[id].op;
+        unsigned int next[2] = {id + 1, this->instructions[id].address};
+        for (int i = 0; i < 2; i++)
+        {
+            if ((i == 0 && op == GO) || (i == 1 && isEndOption(op))) continue;
+            if (next[i] < size && !reached[next[i]])
+            {
+                reached[next[i]] = true;
+                pending.push_back(next[i]);
+            }
+        }
+    }
+
+    for (unsigned int id = 0; id < size; id++)
+    {
+        if (reached[id] && !canEnd[id]) return id + 1;
+    }
+    return 0;
+}
@@ -9,18 +9,80 @@ using namespace p3;
 World::World()
 {
     this->numCreatures = this->numSpecies = 0;
-    Grid(this->grid);
+    this->ownsSpecies = true;
+}
+
+/**
+ * @version 3.0 Delete the species only if they are not shared
+ */
+World::~World()
+{
+    if (!this->ownsSpecies) return;
+    for (auto species : this->m_species)
+    {
+        delete species;
+    }
+}
+
+/**
+ * @version 3.0 Added
+ * Uses the species of another world, which must outlive this one and must
+ * not add species while they are shared. They are only read, so worlds
+ * sharing them can run on different threads.
+ * @param world
+ */
+void World::shareSpecies(const World &world)
+{
+    this->m_species = world.m_species;
+    this->numSpecies = world.numSpecies;
+    this->ownsSpecies = false;
 }
 
 inline Grid *World::getGrid() const
 {
-    return (Grid *) &this->grid;
+    return (Grid *) &this->m_grid;
 }
 
-inline Creature *World::addCreature(Creature *creature)
+/**
+ * @version 3.0 Added
+ * @param num the number of creatures to make room for, so that adding
+ * them never moves the others
+ */
+void World::reserveCreatures(const unsigned int &num)
 {
-    this->getGrid()->addCreature(creature);
-    return this->m_creatures[this->numCreatures++] = creature;
+    this->m_creatures.reserve(num);
+}
+
+/**
+ * @version 3.0 Construct the creature in the contiguous storage
+ * @throws UnknownSpeciesException
+ * @throws UnknownDirectionException
+ * @throws OutsideBoundaryException
+ * @throws OverlapCreatureException
+ * @param name
+ * @param direction
+ * @param row
+ * @param column
+ * @return the creature added
+ */
+Creature *World::addCreature(const std::string &name, const std::string &direction, int row, int column)
+{
+    bool moved = this->m_creatures.size() == this->m_creatures.capacity();
+    this->m_creatures.emplace_back(this, name, direction, row, column);
+    if (moved)
+    {
+        // More creatures than reserved: the others moved, so the grid
+        // must point at their new places
+        for (auto &creature : this->m_creatures)
+        {
+            this->getGrid()->addCreature(&creature);
+        }
+    } else
+    {
+        this->getGrid()->addCreature(&this->m_creatures.back());
+    }
+    this->numCreatures++;
+    return &this->m_creatures.back();
 }
 
 inline Creature *World::getCreature(const point_t &p) const
@@ -30,12 +92,20 @@ inline Creature *World::getCreature(const point_t &p) const
 
 inline Creature *World::getCreature(const unsigned int &i) const
 {
-    return this->m_creatures[i];
+    return (Creature *) &this->m_creatures[i];
+}
+
+inline CreatureTable &World::getTable()
+{
+    return this->m_table;
 }
 
 inline Species *World::addSpecies(Species *species)
 {
-    return this->m_species[this->numSpecies++] = species;
+    species->setIndex(this->numSpecies);
+    this->m_species.push_back(species);
+    this->numSpecies++;
+    return species;
 }
 
 Species *World::getSpecies(const std::string &name) const
@@ -50,12 +120,47 @@ Species *World::getSpecies(const std::string &name) const
     return NULL;
 }
 
-inline int World::getCreatureNum() const
+inline Species *World::getSpecies(const unsigned int &i) const
+{
+    return this->m_species[i];
+}
+
+inline unsigned int World::getCreatureNum() const
 {
     return this->numCreatures;
 }
 
-inline int World::getSpeciesNum() const
+inline unsigned int World::getSpeciesNum() const
 {
     return this->numSpecies;
-}
\ No newline at end of file
+}
+
+/**
+ * @version 3.0 Added
+ * @return a 64-bit FNV-1a hash of the state of every creature, in order:
+ * its location, direction, species, program counter, abilities and hill
+ * state. Worlds that simulate the same way have the same digests.
+ */
+uint64_t World::digest() const
+{
+    uint64_t hash = 14695981039346656037ULL;
+    auto mix = [&hash](const void *data, size_t size)
+    {
+        auto bytes = (const unsigned char *) data;
+        for (size_t i = 0; i < size; i++)
+        {
+            hash = (hash ^ bytes[i]) * 1099511628211ULL;
+        }
+    };
+    auto &table = this->m_table;
+    for (unsigned int i = 0; i < table.size(); i++)
+    {
+        mix(&table.row[i], sizeof(table.row[i]));
+        mix(&table.column[i], sizeof(table.column[i]));
+        mix(&table.direction[i], sizeof(table.direction[i]));
+        mix(&table.species[i], sizeof(table.species[i]));
+        mix(&table.programID[i], sizeof(table.programID[i]));
+        mix(&table.flags[i], sizeof(table.flags[i]));
+    }
+    return hash;
+}
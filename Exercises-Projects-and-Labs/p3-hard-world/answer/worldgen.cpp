@@ -0,0 +1,289 @@
+//
+// Generates large worlds, with their species, for timing p3 --large.
+//
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <sys/stat.h>
+#include <vector>
+
+#include "simulation.h"
+
+// Usage: ./p3-gen <directory> <size> <creatures> [--species <n>] [--seed <n>]
+//
+// Writes into <directory>, which it creates if needed:
+//   world      a <size> x <size> grid and <creatures> creatures
+//   species    the species summary, naming the species aa, ab, ..., which
+//              p3 tells apart by their first two letters
+//   creatures  the random program of each species
+// so that "cd <directory> && p3 species world <rounds> --large" runs it.
+//
+// The plains hold clusters of lakes, forests and hills some LATTICE squares
+// across. The creatures take distinct squares chosen uniformly, in a
+// shuffled order, and face random directions. They are of 4 species by
+// default; a creature on a lake flies, and some others fly or shoot. The
+// same arguments make the same files with the same standard library.
+
+static const int LATTICE = 32;              // Squares between noise points
+static const double LAKES = 0.10;           // Share of the squares of each
+static const double FORESTS = 0.10;         // terrain
+static const double HILLS = 0.05;
+static const double ABILITY_RATE = 0.05;    // Share of the creatures with f,
+                                            // and of those with a
+static const unsigned int MIN_PROGRAM = 3;  // Instructions of a program
+static const unsigned int MAX_PROGRAM = 12;
+
+/**
+ * Value noise: random values at the points of a lattice, LATTICE squares
+ * apart, bilinearly interpolated in between.
+ */
+class Noise
+{
+    std::vector<float> values;
+    unsigned int points;
+
+public:
+    Noise(unsigned int size, std::mt19937_64 &random) : points(size / LATTICE + 2)
+    {
+        std::uniform_real_distribution<float> uniform(0, 1);
+        this->values.resize(size_t(this->points) * this->points);
+        for (auto &value : this->values)
+        {
+            value = uniform(random);
+        }
+    }
+
+    float at(unsigned int row, unsigned int column) const
+    {
+        unsigned int i = row / LATTICE, j = column / LATTICE;
+        float y = float(row % LATTICE) / LATTICE, x = float(column % LATTICE) / LATTICE;
+        const float *p = &this->values[size_t(i) * this->points + j];
+        float top = p[0] + (p[1] - p[0]) * x;
+        float bottom = p[this->points] + (p[this->points + 1] - p[this->points]) * x;
+        return top + (bottom - top) * y;
+    }
+};
+
+/**
+ * @param noise
+ * @param size
+ * @param shares the shares of the squares below each threshold
+ * @param random
+ * @return the noise values below which lie about the given shares of the
+ * squares, estimated on a sample of them
+ */
+static std::vector<float> quantiles(const Noise &noise, unsigned int size, const std::vector<double> &shares,
+                                    std::mt19937_64 &random)
+{
+    const size_t samples = 1 << 16;
+    std::uniform_int_distribution<unsigned int> square(0, size - 1);
+    std::vector<float> values(samples);
+    for (auto &value : values)
+    {
+        value = noise.at(square(random), square(random));
+    }
+    std::sort(values.begin(), values.end());
+    std::vector<float> thresholds;
+    for (auto share : shares)
+    {
+        thresholds.push_back(values[std::min(samples - 1, size_t(share * samples))]);
+    }
+    return thresholds;
+}
+
+/**
+ * @param random
+ * @return a program of MIN_PROGRAM to MAX_PROGRAM instructions with an
+ * ending instruction, which its last instruction, a go, jumps back to;
+ * the other jumps go forward, so that every turn ends
+ */
+static std::string makeProgram(std::mt19937_64 &random)
+{
+    static const char *const ops[] = {"hop", "hop", "hop", "left", "right", "infect", "infect",
+                                      "ifempty", "ifempty", "ifenemy", "ifenemy", "ifsame", "ifwall",
+                                      "ifwall", "go"};
+    static const size_t opNum = sizeof(ops) / sizeof(ops[0]);
+    std::uniform_int_distribution<unsigned int> length(MIN_PROGRAM, MAX_PROGRAM);
+    unsigned int size = length(random);
+    std::uniform_int_distribution<unsigned int> op(0, opNum - 1), ending(0, 5);
+    unsigned int forced = std::uniform_int_distribution<unsigned int>(0, size - 2)(random);
+    std::string program;
+    for (unsigned int i = 0; i < size; i++)
+    {
+        std::string name = i == size - 1 ? "go" : i == forced ? ops[ending(random)] : ops[op(random)];
+        program += name;
+        if (name == "go" || name.compare(0, 2, "if") == 0)
+        {
+            // Addresses count from 1, so i + 2 is the next instruction
+            auto address = i == size - 1 ? forced + 1 :
+                           std::uniform_int_distribution<unsigned int>(i + 2, size)(random);
+            program += ' ' + std::to_string(address);
+        }
+        program += '\n';
+    }
+    return program;
+}
+
+/**
+ * @param path
+ * @param contents
+ * @return whether contents were written to the file at path
+ */
+static bool writeFile(const std::string &path, const std::string &contents)
+{
+    FILE *file = fopen(path.c_str(), "wb");
+    if (file == NULL) return false;
+    bool written = fwrite(contents.data(), 1, contents.size(), file) == contents.size();
+    return fclose(file) == 0 && written;
+}
+
+static bool makeDirectory(const std::string &path)
+{
+    return mkdir(path.c_str(), 0777) == 0 || errno == EEXIST;
+}
+
+/**
+ * @param s
+ * @return the name of species s: two letters, then the number of the
+ * round of 676 names, after the first
+ */
+static std::string speciesName(unsigned long s)
+{
+    std::string name = {char('a' + s / 26 % 26), char('a' + s % 26)};
+    return s < 26 * 26 ? name : name + std::to_string(s / (26 * 26));
+}
+
+static int usage(const char *program)
+{
+    std::cerr << "Usage: " << program << " <directory> <size> <creatures> [--species <n>] [--seed <n>]"
+              << std::endl;
+    return 2;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 4) return usage(argv[0]);
+    std::string directory = argv[1];
+    unsigned long size = strtoul(argv[2], NULL, 10), creatureNum = strtoul(argv[3], NULL, 10);
+    unsigned long speciesNum = 4, seed = 1;
+    for (int i = 4; i < argc; i++)
+    {
+        std::string str = argv[i];
+        if (str == "--species" && i + 1 < argc) speciesNum = strtoul(argv[++i], NULL, 10);
+        else if (str == "--seed" && i + 1 < argc) seed = strtoul(argv[++i], NULL, 10);
+        else return usage(argv[0]);
+    }
+    if (size == 0 || size > p3::LARGE_MAXSIZE || creatureNum > size * size || speciesNum == 0)
+    {
+        std::cerr << "Error: The size must be 1 to " << p3::LARGE_MAXSIZE
+                  << ", with at most size * size creatures and 1 species or more!" << std::endl;
+        return 1;
+    }
+    if (!makeDirectory(directory) || !makeDirectory(directory + "/creatures"))
+    {
+        std::cerr << "Error: Cannot create " << directory << "!" << std::endl;
+        return 1;
+    }
+    std::mt19937_64 random(seed);
+
+    // Species
+    std::string summary = "creatures\n";
+    for (unsigned long s = 0; s < speciesNum; s++)
+    {
+        std::string name = speciesName(s);
+        summary += name + '\n';
+        std::string program = makeProgram(random) + "\n\nGenerated by p3-gen, seed " +
+                              std::to_string(seed) + ".\n";
+        if (!writeFile(directory + "/creatures/" + name, program))
+        {
+            std::cerr << "Error: Cannot write the program of " << name << "!" << std::endl;
+            return 1;
+        }
+    }
+    if (!writeFile(directory + "/species", summary))
+    {
+        std::cerr << "Error: Cannot write the species summary!" << std::endl;
+        return 1;
+    }
+
+    // Terrain, from two noises: low values of the first are lakes and high
+    // ones hills, high values of the second forests
+    auto n = (unsigned int) size;
+    Noise water(n, random), trees(n, random);
+    auto levels = quantiles(water, n, {LAKES, 1 - HILLS}, random);
+    auto forest = quantiles(trees, n, {1 - FORESTS}, random)[0];
+    std::string out = std::to_string(size) + '\n' + std::to_string(size) + '\n';
+    std::vector<unsigned char> lake(size_t(n) * n);
+    FILE *file = fopen((directory + "/world").c_str(), "wb");
+    bool written = file != NULL;
+    for (unsigned int i = 0; i < n && written; i++)
+    {
+        for (unsigned int j = 0; j < n; j++)
+        {
+            float height = water.at(i, j);
+            char terrain = height < levels[0] ? 'L' : height >= levels[1] ? 'H' :
+                                                      trees.at(i, j) >= forest ? 'F' : 'P';
+            lake[size_t(i) * n + j] = terrain == 'L';
+            out += terrain;
+        }
+        out += '\n';
+        if (out.size() >= (1 << 20))
+        {
+            written = fwrite(out.data(), 1, out.size(), file) == out.size();
+            out.clear();
+        }
+    }
+
+    // Creatures on distinct squares, picked in order with the chance that
+    // leaves exactly creatureNum of them, then shuffled
+    std::vector<unsigned int> squares;
+    squares.reserve(creatureNum);
+    std::uniform_real_distribution<double> uniform(0, 1);
+    size_t left = size_t(n) * n, wanted = creatureNum;
+    for (size_t square = 0; square < size_t(n) * n && wanted > 0; square++, left--)
+    {
+        if (uniform(random) * double(left) < double(wanted))
+        {
+            squares.push_back((unsigned int) square);
+            wanted--;
+        }
+    }
+    std::shuffle(squares.begin(), squares.end(), random);
+    std::vector<std::string> names;
+    for (unsigned long s = 0; s < speciesNum; s++)
+    {
+        names.push_back(speciesName(s));
+    }
+    std::uniform_int_distribution<unsigned long> species(0, speciesNum - 1);
+    std::uniform_int_distribution<int> direction(0, 3);
+    static const char *const directions[] = {"east", "south", "west", "north"};
+    for (size_t k = 0; k < squares.size() && written; k++)
+    {
+        unsigned int row = squares[k] / n, column = squares[k] % n;
+        bool fly = lake[squares[k]] || uniform(random) < ABILITY_RATE;
+        bool arch = uniform(random) < ABILITY_RATE;
+        char line[64];
+        snprintf(line, sizeof(line), "%s %s %u %u%s%s\n", names[species(random)].c_str(), directions[direction(random)],
+                 row, column, fly ? " f" : "", arch ? " a" : "");
+        out += line;
+        if (out.size() >= (1 << 20))
+        {
+            written = fwrite(out.data(), 1, out.size(), file) == out.size();
+            out.clear();
+        }
+    }
+    if (written) written = fwrite(out.data(), 1, out.size(), file) == out.size();
+    if (file != NULL && fclose(file) != 0) written = false;
+    if (!written)
+    {
+        std::cerr << "Error: Cannot write the world!" << std::endl;
+        return 1;
+    }
+    return 0;
+}
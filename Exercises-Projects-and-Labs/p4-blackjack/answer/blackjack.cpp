@@ -1,107 +1,772 @@
 #include <iostream>
+#include <iomanip>
 #include <cstdlib>
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <cmath>
+#include <climits>
+#include <type_traits>
 #include "card.h"
 #include "deck.h"
 #include "player.h"
 #include "rand.h"
+#include "strategy.h"
+#include "shoe.h"
+#include "ev.h"
+#include "rules.h"
+#include "history.h"
 
 using namespace std;
 
 const int MINIMUM_BET = 5;
 
+// The number of checkpoints of a session whose bankrolls are kept
+const int CHECKPOINTS = 10;
+
+enum Outcome {
+    NATURAL, PLAYER_BUST, DEALER_BUST, DEALER_WIN, PLAYER_WIN, PUSH, SURRENDER
+};
+
 string getCardName(const Card &card) {
     return string(SpotNames[card.spot]) + " of " + SuitNames[card.suit];
 }
 
-void shuffle(Deck &deck, Player *player) {
-    cout << "Shuffling the deck\n";
+// With verbose false, the game is played the same way without any output
+
+template<bool verbose>
+void shuffle(Deck &deck, Player *player, Random &random, HistoryWriter *history = nullptr) {
+    if (verbose) cout << "Shuffling the deck\n";
+    int cuts[7];
     for (int i = 0; i < 7; i++) {
-        int cut = get_cut();
+        int cut = random.get_cut();
         deck.shuffle(cut);
-        cout << "cut at " << cut << endl;
+        cuts[i] = cut;
+        if (verbose) cout << "cut at " << cut << endl;
     }
+    if (history) history->shuffled(cuts, 7);
+    player->shuffled();
+}
+
+template<bool verbose>
+void shuffle(Shoe &shoe, Player *player, Random &random) {
+    shoe.shuffle(random);
     player->shuffled();
 }
 
-Card deal(Deck &deck, Hand &hand, Player *player, bool isExposed = true) {
-    Card card = deck.deal();
+// A deck is shuffled when fewer than 20 cards are left, a shoe at its cut card
+bool needsShuffle(Deck &deck) {
+    return deck.cardsLeft() < 20;
+}
+
+bool needsShuffle(Shoe &shoe) {
+    return shoe.needsShuffle();
+}
+
+// The cards of a round of a tournament, which every strategy is dealt: the
+// player's cards are the even places after the start in the shoe, and the
+// dealer's the odd ones, so that the dealer's hand is the same whatever the
+// player draws
+class Round {
+    const Shoe &shoe;
+    int player = 0, dealer = 1;
+public:
+    Round(const Shoe &shoe) : shoe(shoe) {}
+
+    Card deal(bool toPlayer) {
+        int &place = toPlayer ? player : dealer;
+        if (place >= shoe.cardsLeft()) throw DeckEmpty();
+        Card card = shoe.peek(place);
+        place += 2;
+        return card;
+    }
+};
+
+template<class Source>
+Card next(Source &deck, bool) {
+    return deck.deal();
+}
+
+// A deck whose cards are added to the record of the round as they are dealt
+class RecordedDeck {
+    Deck &deck;
+    HandRecord &record;
+public:
+    RecordedDeck(Deck &deck, HandRecord &record) : deck(deck), record(record) {}
+
+    Card deal(bool toPlayer) {
+        Card card = deck.deal();
+        record.add(card, toPlayer);
+        return card;
+    }
+
+    void note(HandRecord::Flag flag) { record.note(flag); }
+};
+
+Card next(Round &round, bool toPlayer) {
+    return round.deal(toPlayer);
+}
+
+Card next(RecordedDeck &deck, bool toPlayer) {
+    return deck.deal(toPlayer);
+}
+
+// What the player does with a hand, which only a RecordedDeck keeps
+template<class Source>
+void note(Source &, HandRecord::Flag) {}
+
+void note(RecordedDeck &deck, HandRecord::Flag flag) {
+    deck.note(flag);
+}
+
+// The cards are dealt from a Deck, a Shoe or a Round
+template<bool verbose, class Source>
+Card deal(Source &deck, Hand &hand, Player *player, bool isExposed = true) {
+    Card card = next(deck, player != nullptr);
     hand.addCard(card);
     if (isExposed) {
         if (player != nullptr) {
             player->expose(card);
-            cout << "Player";
+            if (verbose) cout << "Player";
         } else {
-            cout << "Dealer";
+            if (verbose) cout << "Dealer";
         }
-        cout << " dealt " << getCardName(card) << endl;
+        if (verbose) cout << " dealt " << getCardName(card) << endl;
     }
     return card;
 }
 
-int main(int argc, char *argv[]) {
-    int bankroll = strtol(argv[1], nullptr, 10);
-    int hands = strtol(argv[2], nullptr, 10);
-    int thisHand = 0;
+// Plays a hand of wager by the Rules, and adds what the player won or lost
+// to bankroll; after a split, returns the outcome of the first hand. What
+// is staked on doubles and splits stays within bankroll.
+template<bool verbose, class Rules = ProjectRules, class Source>
+Outcome playHand(Source &deck, Player *player, int wager, int &bankroll, Card &dealerCard) {
+    Hand handDealer, hands[2];
+    int wagers[2] = {wager, wager};
+    Outcome outcomes[2];
+    auto first = deal<verbose>(deck, hands[0], player);
+    dealerCard = deal<verbose>(deck, handDealer, nullptr);
+    auto second = deal<verbose>(deck, hands[0], player);
+    auto holeCard = deal<verbose>(deck, handDealer, nullptr, false);
+    if (hands[0].handValue().count == 21) {
+        if (verbose) cout << "Player dealt natural 21\n";
+        bankroll += Rules::Natural::natural(wager);
+        return NATURAL;
+    }
+    int handCount = 1, staked = wager;
+    if (Rules::canSplit && first.spot == second.spot && staked + wager <= bankroll &&
+        player->split(dealerCard, first.spot, Rules::doubleAfterSplit)) {
+        if (verbose) cout << "Player splits\n";
+        note(deck, HandRecord::SPLIT);
+        hands[0].discardAll();
+        hands[0].addCard(first);
+        hands[1].addCard(second);
+        handCount = 2;
+        staked += wager;
+    } else if (Rules::canSurrender && player->surrender(dealerCard, hands[0])) {
+        if (verbose) cout << "Player surrenders\n";
+        note(deck, HandRecord::SURRENDER);
+        bankroll -= wager / 2;
+        return SURRENDER;
+    }
+    for (int h = 0; h < handCount; h++) {
+        auto &hand = hands[h];
+        if (h == 1) note(deck, HandRecord::SECOND);
+        if (handCount == 2) {
+            deal<verbose>(deck, hand, player);
+            // split aces take one card each
+            if (first.spot == ACE) continue;
+        }
+        if (Rules::canDouble && (handCount == 1 || Rules::doubleAfterSplit) && staked + wager <= bankroll &&
+            player->doubleDown(dealerCard, hand)) {
+            if (verbose) cout << "Player doubles\n";
+            note(deck, HandRecord::DOUBLED);
+            staked += wager;
+            wagers[h] *= 2;
+            deal<verbose>(deck, hand, player);
+            continue;
+        }
+        while (player->draw(dealerCard, hand)) {
+            deal<verbose>(deck, hand, player);
+        }
+    }
+    bool standing = false;
+    for (int h = 0; h < handCount; h++) {
+        int player_count = hands[h].handValue().count;
+        if (player_count > 21) {
+            if (verbose) cout << "Player busts\n";
+            bankroll -= wagers[h];
+            outcomes[h] = PLAYER_BUST;
+        } else {
+            if (verbose) cout << "Player's total is " << player_count << endl;
+            standing = true;
+        }
+    }
+    if (!standing) return outcomes[0];
+    if (verbose) cout << "Dealer's hole card is " << getCardName(holeCard) << endl;
+    player->expose(holeCard);
+    while (Rules::Dealer::draws(handDealer.handValue())) {
+        deal<verbose>(deck, handDealer, nullptr);
+    }
+    int dealer_count = handDealer.handValue().count;
+    if (verbose) cout << "Dealer's total is " << dealer_count << endl;
+    for (int h = 0; h < handCount; h++) {
+        int player_count = hands[h].handValue().count;
+        if (player_count > 21) continue;
+        if (dealer_count > 21) {
+            if (verbose) cout << "Dealer busts\n";
+            bankroll += wagers[h];
+            outcomes[h] = DEALER_BUST;
+        } else if (dealer_count > player_count) {
+            if (verbose) cout << "Dealer wins\n";
+            bankroll -= wagers[h];
+            outcomes[h] = DEALER_WIN;
+        } else if (dealer_count < player_count) {
+            if (verbose) cout << "Player wins\n";
+            bankroll += wagers[h];
+            outcomes[h] = PLAYER_WIN;
+        } else {
+            if (verbose) cout << "Push\n";
+            outcomes[h] = PUSH;
+        }
+    }
+    return outcomes[0];
+}
 
+void play(int bankroll, int hands, Player *player) {
+    int thisHand = 0;
     Deck deck;
-    Player *player;
-    if (string(argv[3]) == "simple") {
-        player = get_Simple();
-    } else {
-        player = get_Counting();
-    }
-    shuffle(deck, player);
-    Hand handDealer, handPlayer;
+    Random random(0UL);     // the stream of get_cut()
+    shuffle<true>(deck, player, random);
     while (bankroll >= MINIMUM_BET && thisHand < hands) {
         cout << "Hand " << ++thisHand << " bankroll " << bankroll << endl;
         if (deck.cardsLeft() < 20) {
-            shuffle(deck, player);
+            shuffle<true>(deck, player, random);
         }
         int wager = player->bet(bankroll, MINIMUM_BET);
         cout << "Player bets " << wager << endl;
-        handPlayer.discardAll();
-        handDealer.discardAll();
-        deal(deck, handPlayer, player);
-        auto dealerCard = deal(deck, handDealer, nullptr);
-        deal(deck, handPlayer, player);
-        auto holeCard = deal(deck, handDealer, nullptr, false);
-        if (handPlayer.handValue().count == 21) {
-            cout << "Player dealt natural 21\n";
-            bankroll += (int) (1.5 * wager);
-            continue;
+        Card dealerCard;
+        playHand<true>(deck, player, wager, bankroll, dealerCard);
+    }
+
+    cout << "Player has " << bankroll << " after " << thisHand << " hands\n";
+}
+
+// Plays the same game as play() without printing it, and writes each hand
+// and shuffle to a hand history instead, which "history" prints as play()
+// would have
+void record(int bankroll, int hands, Player *player, HistoryWriter &history) {
+    int thisHand = 0;
+    Deck deck;
+    Random random(0UL);     // the stream of get_cut()
+    shuffle<false>(deck, player, random, &history);
+    while (bankroll >= MINIMUM_BET && thisHand < hands) {
+        ++thisHand;
+        if (deck.cardsLeft() < 20) {
+            shuffle<false>(deck, player, random, &history);
         }
-        while (player->draw(dealerCard, handPlayer)) {
-            deal(deck, handPlayer, player);
-        }
-        int player_count = handPlayer.handValue().count;
-        if (player_count <= 21) {
-            cout << "Player's total is " << player_count << endl;
-            cout << "Dealer's hole card is " << getCardName(holeCard) << endl;
-            player->expose(holeCard);
-            int dealer_count = handDealer.handValue().count;
-            while (dealer_count < 17) {
-                deal(deck, handDealer, nullptr);
-                dealer_count = handDealer.handValue().count;
+        HandRecord hand;
+        hand.wager = player->bet(bankroll, MINIMUM_BET);
+        int before = bankroll;
+        RecordedDeck recorded(deck, hand);
+        Card dealerCard;
+        hand.outcome = playHand<false>(recorded, player, hand.wager, bankroll, dealerCard);
+        hand.won = bankroll - before;
+        history.write(hand);
+    }
+}
+
+// What the sessions of a simulation add up to
+struct Statistics {
+    long long hands = 0;
+    long long outcomes[SURRENDER + 1] = {};
+    long long ruined = 0;           // sessions ended below the minimum bet
+    double won = 0, wonSquared = 0; // of each hand
+    double bet = 0;
+    long long dealerHands[ACE + 1] = {};    // played out by the dealer, by up card
+    long long dealerBusts[ACE + 1] = {};
+
+    void merge(const Statistics &other) {
+        hands += other.hands;
+        for (int i = NATURAL; i <= SURRENDER; i++) {
+            outcomes[i] += other.outcomes[i];
+        }
+        ruined += other.ruined;
+        won += other.won;
+        wonSquared += other.wonSquared;
+        bet += other.bet;
+        for (int i = TWO; i <= ACE; i++) {
+            dealerHands[i] += other.dealerHands[i];
+            dealerBusts[i] += other.dealerBusts[i];
+        }
+    }
+};
+
+// Plays a session of up to hands hands from bankroll, printing nothing, and
+// keeps its bankroll at each checkpoint
+template<class Source>
+void playSession(int bankroll, int hands, Player *player, Source &deck, Random &random,
+                 Statistics &stats, int checkpoints[]) {
+    int thisHand = 0;
+    int checkpoint = 0;
+    shuffle<false>(deck, player, random);
+    while (bankroll >= MINIMUM_BET && thisHand < hands) {
+        ++thisHand;
+        if (needsShuffle(deck)) {
+            shuffle<false>(deck, player, random);
+        }
+        int wager = player->bet(bankroll, MINIMUM_BET);
+        int before = bankroll;
+        Card dealerCard;
+        auto outcome = playHand<false>(deck, player, wager, bankroll, dealerCard);
+        stats.outcomes[outcome]++;
+        if (outcome >= DEALER_BUST && outcome <= PUSH) {
+            stats.dealerHands[dealerCard.spot]++;
+            if (outcome == DEALER_BUST) stats.dealerBusts[dealerCard.spot]++;
+        }
+        double won = bankroll - before;
+        stats.won += won;
+        stats.wonSquared += won * won;
+        stats.bet += wager;
+        while (checkpoint < CHECKPOINTS &&
+               (long long) thisHand * CHECKPOINTS >= (long long) hands * (checkpoint + 1)) {
+            checkpoints[checkpoint++] = bankroll;
+        }
+    }
+    // a session that ends early keeps its last bankroll
+    while (checkpoint < CHECKPOINTS) {
+        checkpoints[checkpoint++] = bankroll;
+    }
+    stats.hands += thisHand;
+    if (bankroll < MINIMUM_BET) stats.ruined++;
+}
+
+// Plays sessions on threads, each session with a stream seeded by the seed
+// and its index, so that the result does not depend on the threads; with
+// no decks, each session deals from a riffled Deck, otherwise from a Shoe
+void simulate(int bankroll, int hands, Player *(*getPlayer)(), long long sessions,
+              int threads, unsigned long seed, int decks, double penetration) {
+    vector<Statistics> stats((size_t) threads);
+    vector<int> bankrolls((size_t) (sessions * CHECKPOINTS));   // of each session, at each checkpoint
+    vector<thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([=, &stats, &bankrolls]() {
+            Player *player = getPlayer();
+            for (long long session = t; session < sessions; session += threads) {
+                unsigned long key[3] = {seed, (unsigned long) (session & 0xffffffffLL),
+                                        (unsigned long) (session >> 32)};
+                Random random(key, 3);
+                int *checkpoints = &bankrolls[(size_t) (session * CHECKPOINTS)];
+                if (decks == 0) {
+                    Deck deck;
+                    playSession(bankroll, hands, player, deck, random, stats[(size_t) t], checkpoints);
+                } else {
+                    Shoe shoe(decks, penetration);
+                    playSession(bankroll, hands, player, shoe, random, stats[(size_t) t], checkpoints);
+                }
             }
-            cout << "Dealer's total is " << dealer_count << endl;
-            if (dealer_count > 21) {
-                cout << "Dealer busts\n";
-                bankroll += wager;
-            } else if (dealer_count > player_count) {
-                cout << "Dealer wins\n";
-                bankroll -= wager;
-            } else if (dealer_count < player_count) {
-                cout << "Player wins\n";
-                bankroll += wager;
-            } else {
-                cout << "Push\n";
+            delete player;
+        });
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    Statistics total;
+    for (const auto &s : stats) {
+        total.merge(s);
+    }
+
+    double n = total.hands > 0 ? (double) total.hands : 1;
+    double ev = total.won / n;
+    cout << fixed << setprecision(4);
+    cout << "Sessions " << sessions << " of " << hands << " hands from bankroll " << bankroll
+         << ", seed " << seed << endl;
+    if (decks == 0) {
+        cout << "Riffled deck" << endl;
+    } else {
+        cout << decks << " deck shoe, cut at " << 100 * penetration << "%" << endl;
+    }
+    cout << "Hands played " << total.hands << endl;
+    cout << "EV per hand " << ev << ", per unit bet " << (total.bet > 0 ? total.won / total.bet : 0) << endl;
+    cout << "Variance per hand " << total.wonSquared / n - ev * ev << endl;
+    // the project rules never surrender
+    const char *names[PUSH + 1] = {"Naturals", "Player busts", "Dealer busts", "Dealer wins", "Player wins", "Pushes"};
+    for (int i = NATURAL; i <= PUSH; i++) {
+        cout << names[i] << " " << 100 * total.outcomes[i] / n << "%" << endl;
+    }
+    cout << "Ruined " << 100.0 * total.ruined / (double) max(sessions, 1LL) << "%" << endl;
+    cout << "Dealer busts by up card, played and exact for an infinite deck" << endl;
+    for (int i = TWO; i <= ACE; i++) {
+        double played = (double) max(total.dealerHands[i], 1LL);
+        cout << SpotNames[i] << " " << 100 * total.dealerBusts[i] / played << "% "
+             << 100 * dealerOutcome(Spot(i)).bust << "%" << endl;
+    }
+    if (sessions <= 0) return;
+    cout << "Bankroll percentiles p5 p25 p50 p75 p95" << endl;
+    const int percentiles[] = {5, 25, 50, 75, 95};
+    vector<int> values((size_t) sessions);
+    for (int i = 0; i < CHECKPOINTS; i++) {
+        for (long long session = 0; session < sessions; session++) {
+            values[(size_t) session] = bankrolls[(size_t) (session * CHECKPOINTS + i)];
+        }
+        cout << "after hand " << ((long long) hands * (i + 1) + CHECKPOINTS - 1) / CHECKPOINTS;
+        for (int p : percentiles) {
+            auto k = (values.size() - 1) * p / 100;
+            nth_element(values.begin(), values.begin() + (long) k, values.end());
+            cout << " " << values[k];
+        }
+        cout << endl;
+    }
+}
+
+// What each strategy of a tournament adds up to; the differences are those
+// with the first strategy on the same rounds
+struct Standing {
+    long long hands = 0;
+    double won = 0, wonSquared = 0, bet = 0;
+    double difference = 0, differenceSquared = 0;
+
+    void merge(const Standing &other) {
+        hands += other.hands;
+        won += other.won;
+        wonSquared += other.wonSquared;
+        bet += other.bet;
+        difference += other.difference;
+        differenceSquared += other.differenceSquared;
+    }
+
+    double ev() const { return won / (double) max(hands, 1LL); }
+
+    // half the width of the 95% confidence interval of a mean
+    static double interval(double sum, double squared, long long n) {
+        if (n < 2) return 0;
+        double mean = sum / (double) n;
+        return 1.96 * sqrt(max(squared / (double) n - mean * mean, 0.0) / (double) (n - 1));
+    }
+};
+
+// The rounds dealt from a shoe before it is shuffled, with a cut card at 75%
+const int ROUND_CARDS = 22;
+
+// Plays every strategy on the same rounds of the same shoes, on threads,
+// each shoe shuffled by a stream seeded by the seed and its index
+int tournament(long long hands, int threads, unsigned long seed, int decks) {
+    int roundsPerShoe = max((int) (0.75 * decks * DeckSize) / ROUND_CARDS, 1);
+    long long shoes = (hands + roundsPerShoe - 1) / roundsPerShoe;
+    vector<vector<Standing> > standings((size_t) threads, vector<Standing>((size_t) StrategyCount));
+    vector<thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([=, &standings]() {
+            vector<Player *> players;
+            for (int i = 0; i < StrategyCount; i++) {
+                players.push_back(Strategies[i].get());
             }
-        } else {
-            cout << "Player busts\n";
-            bankroll -= wager;
+            auto &standing = standings[(size_t) t];
+            vector<int> won((size_t) StrategyCount);
+            for (long long index = t; index < shoes; index += threads) {
+                unsigned long key[3] = {seed, (unsigned long) (index & 0xffffffffLL),
+                                        (unsigned long) (index >> 32)};
+                Random random(key, 3);
+                // shuffled from a new shoe, so that its order depends only on the stream
+                Shoe shoe(decks, 1.0);
+                shoe.shuffle(random);
+                for (auto player : players) {
+                    player->shuffled();
+                }
+                long long rounds = min((long long) roundsPerShoe, hands - index * roundsPerShoe);
+                for (long long r = 0; r < rounds; r++) {
+                    for (int i = 0; i < StrategyCount; i++) {
+                        // an unlimited bankroll, so that every strategy plays every round
+                        int bankroll = INT_MAX / 2;
+                        int wager = players[(size_t) i]->bet((unsigned) bankroll, MINIMUM_BET);
+                        Round round(shoe);
+                        Card dealerCard;
+                        playHand<false>(round, players[(size_t) i], wager, bankroll, dealerCard);
+                        won[(size_t) i] = bankroll - INT_MAX / 2;
+                        auto &s = standing[(size_t) i];
+                        s.hands++;
+                        s.won += won[(size_t) i];
+                        s.wonSquared += (double) won[(size_t) i] * won[(size_t) i];
+                        s.bet += wager;
+                        double d = won[(size_t) i] - won[0];
+                        s.difference += d;
+                        s.differenceSquared += d * d;
+                    }
+                    shoe.burn(ROUND_CARDS);
+                }
+            }
+            for (auto player : players) {
+                delete player;
+            }
+        });
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    vector<Standing> total((size_t) StrategyCount);
+    for (const auto &standing : standings) {
+        for (int i = 0; i < StrategyCount; i++) {
+            total[(size_t) i].merge(standing[(size_t) i]);
         }
     }
 
-    cout << "Player has " << bankroll << " after " << thisHand << " hands\n";
+    vector<int> ranks;
+    for (int i = 0; i < StrategyCount; i++) {
+        ranks.push_back(i);
+    }
+    sort(ranks.begin(), ranks.end(), [&total](int a, int b) { return total[(size_t) a].ev() > total[(size_t) b].ev(); });
+    cout << fixed << setprecision(4);
+    cout << "Tournament of " << StrategyCount << " strategies, " << hands << " hands each on the same "
+         << decks << " deck shoes, seed " << seed << endl;
+    cout << "rank strategy EV/hand +-95% EV/unit bet, against " << Strategies[0].name << " +-95%" << endl;
+    for (int rank = 0; rank < StrategyCount; rank++) {
+        int i = ranks[(size_t) rank];
+        auto &s = total[(size_t) i];
+        cout << rank + 1 << " " << Strategies[i].name << " " << s.ev() << " "
+             << Standing::interval(s.won, s.wonSquared, s.hands) << " "
+             << (s.bet > 0 ? s.won / s.bet : 0) << ", "
+             << s.difference / (double) max(s.hands, 1LL) << " "
+             << Standing::interval(s.difference, s.differenceSquared, s.hands) << endl;
+    }
     return 0;
-}
\ No newline at end of file
+}
+
+// A rule set of a sweep, and a round played by it
+struct RuleSet {
+    string name;
+    int (*play)(const Shoe &shoe, Player *player, int &wager);
+};
+
+// Plays the next round of shoe by the Rules, and returns what the player won
+template<class Rules>
+int playRound(const Shoe &shoe, Player *player, int &wager) {
+    // an unlimited bankroll, so that every round is played alike
+    int bankroll = INT_MAX / 2;
+    wager = player->bet((unsigned) bankroll, MINIMUM_BET);
+    Round round(shoe);
+    Card dealerCard;
+    playHand<false, Rules>(round, player, wager, bankroll, dealerCard);
+    return bankroll - INT_MAX / 2;
+}
+
+// The rule set of each bit of MASK: hitting soft 17, paying 6 to 5,
+// doubling, splitting, doubling after a split and surrender
+template<int MASK>
+struct MaskRules {
+    typedef Rules<typename conditional<(MASK & 1) != 0, HitSoft17, StandSoft17>::type,
+                  typename conditional<(MASK & 2) != 0, Pays6To5, Pays3To2>::type,
+                  (MASK & 4) != 0, (MASK & 8) != 0, (MASK & 16) != 0, (MASK & 32) != 0> type;
+};
+
+const int RULE_MASKS = 64;
+
+// Adds the rule sets of the masks up to MASK, but those that double after
+// a split without doubling and splitting, in the order of their masks
+template<int MASK>
+struct AddRuleSets {
+    static void to(vector<RuleSet> &sets) {
+        AddRuleSets<MASK - 1>::to(sets);
+        typedef typename MaskRules<MASK>::type R;
+        if ((MASK & 16) == 0 || R::doubleAfterSplit) {
+            sets.push_back(RuleSet{R::name(), playRound<R>});
+        }
+    }
+};
+
+template<>
+struct AddRuleSets<-1> {
+    static void to(vector<RuleSet> &) {}
+};
+
+// Plays the player by every rule set on the same rounds of the same shoes,
+// as a tournament, on threads; the first rule set is the project's, which
+// the others are compared with
+int sweep(long long hands, int threads, unsigned long seed, int decks, Player *(*getPlayer)(), const char *playerName) {
+    vector<RuleSet> sets;
+    AddRuleSets<RULE_MASKS - 1>::to(sets);
+    int setCount = (int) sets.size();
+    int roundsPerShoe = max((int) (0.75 * decks * DeckSize) / ROUND_CARDS, 1);
+    long long shoes = (hands + roundsPerShoe - 1) / roundsPerShoe;
+    vector<vector<Standing> > standings((size_t) threads, vector<Standing>((size_t) setCount));
+    vector<thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([=, &sets, &standings]() {
+            // a player of each rule set, that sees the cards of its own rounds
+            vector<Player *> players;
+            for (int i = 0; i < setCount; i++) {
+                players.push_back(getPlayer());
+            }
+            auto &standing = standings[(size_t) t];
+            for (long long index = t; index < shoes; index += threads) {
+                unsigned long key[3] = {seed, (unsigned long) (index & 0xffffffffLL),
+                                        (unsigned long) (index >> 32)};
+                Random random(key, 3);
+                Shoe shoe(decks, 1.0);
+                shoe.shuffle(random);
+                for (auto player : players) {
+                    player->shuffled();
+                }
+                long long rounds = min((long long) roundsPerShoe, hands - index * roundsPerShoe);
+                for (long long r = 0; r < rounds; r++) {
+                    int first = 0;
+                    for (int i = 0; i < setCount; i++) {
+                        int wager;
+                        int won = sets[(size_t) i].play(shoe, players[(size_t) i], wager);
+                        if (i == 0) first = won;
+                        auto &s = standing[(size_t) i];
+                        s.hands++;
+                        s.won += won;
+                        s.wonSquared += (double) won * won;
+                        s.bet += wager;
+                        double d = won - first;
+                        s.difference += d;
+                        s.differenceSquared += d * d;
+                    }
+                    shoe.burn(ROUND_CARDS);
+                }
+            }
+            for (auto player : players) {
+                delete player;
+            }
+        });
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    vector<Standing> total((size_t) setCount);
+    for (const auto &standing : standings) {
+        for (int i = 0; i < setCount; i++) {
+            total[(size_t) i].merge(standing[(size_t) i]);
+        }
+    }
+
+    cout << fixed << setprecision(4);
+    cout << "Sweep of " << setCount << " rule sets, " << hands << " hands each of " << playerName << " on the same "
+         << decks << " deck shoes, seed " << seed << endl;
+    cout << "rules EV/hand +-95% EV/unit bet, against " << sets[0].name << " +-95%" << endl;
+    for (int i = 0; i < setCount; i++) {
+        auto &s = total[(size_t) i];
+        cout << sets[(size_t) i].name << " " << s.ev() << " "
+             << Standing::interval(s.won, s.wonSquared, s.hands) << " "
+             << (s.bet > 0 ? s.won / s.bet : 0) << ", "
+             << s.difference / (double) max(s.hands, 1LL) << " "
+             << Standing::interval(s.difference, s.differenceSquared, s.hands) << endl;
+    }
+    return 0;
+}
+
+// Reads a card as 2 to 10, T, J, Q, K or A
+bool parseSpot(const string &name, Spot &spot) {
+    const string names[ACE + 1] = {"2", "3", "4", "5", "6", "7", "8", "9", "10", "J", "Q", "K", "A"};
+    for (int i = TWO; i <= ACE; i++) {
+        if (name == names[i] || (i == TEN && name == "T")) {
+            spot = Spot(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+// ./blackjack ev <decks> <up card> <card> <card> [<card seen>...]
+int evaluate(int argc, char *argv[]) {
+    int decks = (int) strtol(argv[2], nullptr, 10);
+    if (decks < 1 || decks > 15 || argc < 6) {
+        cout << "Usage: ./blackjack ev <decks> <up card> <card> <card> [<card seen>...]\n";
+        return 1;
+    }
+    Composition shoe(decks);
+    Spot spots[3];
+    Hand player;
+    for (int i = 3; i < argc; i++) {
+        Spot spot;
+        if (!parseSpot(argv[i], spot)) {
+            cout << "Unknown card " << argv[i] << endl;
+            return 1;
+        }
+        if (i < 6) {
+            spots[i - 3] = spot;
+        }
+        if (i == 4 || i == 5) {
+            player.addCard(Card{spot, SPADES});
+        }
+        shoe.expose(Card{spot, SPADES});
+    }
+    Card up{spots[0], SPADES};
+
+    cout << fixed << setprecision(6);
+    cout << "Player " << player.handValue().count << (player.handValue().soft ? " soft" : "")
+         << " against " << SpotNames[up.spot] << ", " << shoe.size() << " cards left" << endl;
+    if (player.handValue().count == 21) {
+        cout << "Natural 21 pays 1.500000" << endl;
+        return 0;
+    }
+    ExactEV ev;
+    double stand = ev.stand(shoe, player, up.spot);
+    double hit = ev.hit(shoe, player, up.spot);
+    cout << "Stand EV " << stand << endl;
+    cout << "Hit EV " << hit << endl;
+    cout << "Best " << (hit > stand ? "hit" : "stand") << ", basic strategy "
+         << (basicDraw(up, player) ? "hit" : "stand") << endl;
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc > 2 && string(argv[1]) == "ev") {
+        return evaluate(argc, argv);
+    }
+    if (argc > 2 && string(argv[1]) == "history") {
+        // ./blackjack history <file>
+        return printHistory(argv[2], cout);
+    }
+    if (argc > 2 && string(argv[1]) == "tournament") {
+        // ./blackjack tournament <hands> [<threads> [<seed> [<decks>]]]
+        int threads = argc > 3 ? (int) strtol(argv[3], nullptr, 10) : (int) thread::hardware_concurrency();
+        unsigned long seed = argc > 4 ? strtoul(argv[4], nullptr, 10) : 0;
+        int decks = argc > 5 ? (int) strtol(argv[5], nullptr, 10) : 6;
+        return tournament(strtoll(argv[2], nullptr, 10), max(threads, 1), seed, max(decks, 1));
+    }
+    if (argc > 2 && string(argv[1]) == "rules") {
+        // ./blackjack rules <hands> [<threads> [<seed> [<decks> [<player>]]]]
+        int threads = argc > 3 ? (int) strtol(argv[3], nullptr, 10) : (int) thread::hardware_concurrency();
+        unsigned long seed = argc > 4 ? strtoul(argv[4], nullptr, 10) : 0;
+        int decks = argc > 5 ? (int) strtol(argv[5], nullptr, 10) : 6;
+        int strategy = 0;
+        for (int i = 0; i < StrategyCount; i++) {
+            if (argc > 6 && string(argv[6]) == Strategies[i].name) strategy = i;
+        }
+        return sweep(strtoll(argv[2], nullptr, 10), max(threads, 1), seed, max(decks, 1),
+                     Strategies[strategy].get, Strategies[strategy].name);
+    }
+    int bankroll = strtol(argv[1], nullptr, 10);
+    int hands = strtol(argv[2], nullptr, 10);
+
+    // a player not named is the counting one
+    auto getPlayer = get_Counting;
+    for (int i = 0; i < StrategyCount; i++) {
+        if (string(argv[3]) == Strategies[i].name) getPlayer = Strategies[i].get;
+    }
+    if (argc > 5 && string(argv[4]) == "--history") {
+        // ./blackjack <bankroll> <hands> <player> --history <file>
+        Player *player = getPlayer();
+        HistoryWriter history(argv[5], bankroll);
+        record(bankroll, hands, player, history);
+        delete player;
+        bool failed = !history.close();
+        if (failed) cout << "Cannot write the hand history " << argv[5] << endl;
+        return failed;
+    } else if (argc > 4) {
+        // ./blackjack <bankroll> <hands> <player> <sessions> [<threads> [<seed> [<decks> [<penetration>]]]]
+        int threads = argc > 5 ? (int) strtol(argv[5], nullptr, 10) : (int) thread::hardware_concurrency();
+        unsigned long seed = argc > 6 ? strtoul(argv[6], nullptr, 10) : 0;
+        int decks = argc > 7 ? (int) strtol(argv[7], nullptr, 10) : 0;
+        double penetration = argc > 8 ? strtod(argv[8], nullptr) : 0.75;
+        if (penetration <= 0 || penetration > 1) penetration = 0.75;
+        simulate(bankroll, hands, getPlayer, strtoll(argv[4], nullptr, 10), max(threads, 1), seed,
+                 max(decks, 0), penetration);
+    } else {
+        Player *player = getPlayer();
+        play(bankroll, hands, player);
+        delete player;
+    }
+    return 0;
+}
@@ -6,3 +6,4 @@ const char *SpotNames[] = {"Two", "Three", "Four", "Five", "Six",
                            "Seven", "Eight", "Nine", "Ten", "Jack",
                            "Queen", "King", "Ace"};
 
+const int SpotValues[] = {2, 3, 4, 5, 6, 7, 8, 9, 10, 10, 10, 10, 11};
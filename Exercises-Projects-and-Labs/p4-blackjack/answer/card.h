@@ -19,4 +19,18 @@ struct Card {
     Suit  suit;
 };
 
+extern const int SpotValues[ACE+1];
+// The blackjack value of each spot, an ace counting 11
+
+typedef unsigned char PackedCard;
+// A card in one byte: its spot times 4 plus its suit
+
+inline PackedCard packCard(Card c) {
+    return (PackedCard) (c.spot * 4 + c.suit);
+}
+
+inline Card unpackCard(PackedCard p) {
+    return Card{Spot(p >> 2), Suit(p & 3)};
+}
+
 #endif /* __CARD_H__ */
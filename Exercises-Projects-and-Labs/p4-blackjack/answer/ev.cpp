@@ -0,0 +1,133 @@
+//
+// The exact EV of standing and hitting, from the cards left in the shoe.
+//
+
+#include "ev.h"
+
+Composition::Composition(int decks) : total(0) {
+    for (int value = 0; value < CARD_VALUES; value++) {
+        counts[value] = 4 * decks;
+    }
+    // the ten, jack, queen and king
+    counts[spotValue(TEN)] = 16 * decks;
+    for (int value = 0; value < CARD_VALUES; value++) {
+        total += counts[value];
+    }
+}
+
+void Composition::expose(Card c) {
+    int value = spotValue(c.spot);
+    if (counts[value] > 0) take(value);
+}
+
+uint64_t Composition::key() const {
+    // 6 bits for each value up to 15 decks, 8 for the tens
+    uint64_t key = 0;
+    for (int value = 0; value < CARD_VALUES; value++) {
+        key = (key << (value == spotValue(TEN) ? 8 : 6)) | (uint64_t) counts[value];
+    }
+    return key;
+}
+
+Spot valueSpot(int value) {
+    return value < 9 ? Spot(value) : ACE;
+}
+
+int spotValue(Spot spot) {
+    if (spot == ACE) return 9;
+    return spot >= TEN ? 8 : (int) spot;
+}
+
+static int handKey(const Hand &hand) {
+    auto value = hand.handValue();
+    return value.count * 2 + (value.soft ? 1 : 0);
+}
+
+const ExactEV::Totals &ExactEV::dealerTotals(Composition &shoe, const Hand &hand) {
+    // the dealer's hand is only drawn to while under 17
+    Key key{shoe.key(), handKey(hand)};
+    auto found = dealer.find(key);
+    if (found != dealer.end()) return found->second;
+
+    Totals totals{{0, 0, 0, 0, 0, 0}};
+    if (shoe.size() == 0) {
+        totals.p[5] = 1;
+    }
+    for (int value = 0; value < CARD_VALUES; value++) {
+        if (shoe.count(value) == 0) continue;
+        double p = (double) shoe.count(value) / shoe.size();
+        Hand next = hand;
+        next.addCard(Card{valueSpot(value), SPADES});
+        int count = next.handValue().count;
+        if (count > 21) {
+            totals.p[5] += p;
+        } else if (count >= 17) {
+            totals.p[count - 17] += p;
+        } else {
+            shoe.take(value);
+            const Totals &rest = dealerTotals(shoe, next);
+            shoe.put(value);
+            for (int i = 0; i < 6; i++) {
+                totals.p[i] += p * rest.p[i];
+            }
+        }
+    }
+    return dealer.emplace(key, totals).first->second;
+}
+
+double ExactEV::stand(Composition shoe, const Hand &player, Spot up) {
+    Hand hand;
+    hand.addCard(Card{up, SPADES});
+    const Totals &totals = dealerTotals(shoe, hand);
+    int count = player.handValue().count;
+    double ev = totals.p[5];
+    for (int total = 17; total <= 21; total++) {
+        if (count > total) {
+            ev += totals.p[total - 17];
+        } else if (count < total) {
+            ev -= totals.p[total - 17];
+        }
+    }
+    return ev;
+}
+
+double ExactEV::bestAfterHit(Composition &shoe, const Hand &player, Spot up) {
+    Key key{shoe.key(), handKey(player) * 16 + (int) up};
+    auto found = hitting.find(key);
+    if (found != hitting.end()) return found->second;
+
+    double ev = 0;
+    if (shoe.size() == 0) {
+        return 0;
+    }
+    for (int value = 0; value < CARD_VALUES; value++) {
+        if (shoe.count(value) == 0) continue;
+        double p = (double) shoe.count(value) / shoe.size();
+        Hand next = player;
+        next.addCard(Card{valueSpot(value), SPADES});
+        int count = next.handValue().count;
+        if (count > 21) {
+            ev -= p;
+            continue;
+        }
+        shoe.take(value);
+        double best = stand(shoe, next, up);
+        if (count < 21) {
+            double again = bestAfterHit(shoe, next, up);
+            if (again > best) best = again;
+        }
+        shoe.put(value);
+        ev += p * best;
+    }
+    hitting.emplace(key, ev);
+    return ev;
+}
+
+double ExactEV::hit(Composition shoe, const Hand &player, Spot up) {
+    return bestAfterHit(shoe, player, up);
+}
+
+void ExactEV::clear() {
+    dealer.clear();
+    hitting.clear();
+}
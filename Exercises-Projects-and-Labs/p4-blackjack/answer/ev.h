@@ -0,0 +1,92 @@
+#ifndef __EV_H__
+#define __EV_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include "card.h"
+#include "hand.h"
+
+const int CARD_VALUES = 10;     // Two to Nine, the tens, and the Ace
+
+class Composition {
+    // OVERVIEW: how many cards of each value are left in a shoe, the
+    // ten, jack, queen and king being one value
+    int counts[CARD_VALUES];
+    int total;
+ public:
+    explicit Composition(int decks);
+    // REQUIRES: 1 <= decks <= 15
+    // EFFECTS: constructs the composition of a full shoe of decks decks
+
+    void expose(Card c);
+    // MODIFIES: this
+    // EFFECTS: takes the card c out of the shoe, if one of its value is
+    // left. Like Player::expose, it is told of every card seen.
+
+    int count(int value) const { return counts[value]; }
+    // EFFECTS: returns how many cards of value are left
+
+    int size() const { return total; }
+    // EFFECTS: returns how many cards are left
+
+    void take(int value) { counts[value]--; total--; }
+    void put(int value) { counts[value]++; total++; }
+    // REQUIRES: for take, count(value) > 0
+    // MODIFIES: this
+    // EFFECTS: takes a card of value out, or puts it back
+
+    uint64_t key() const;
+    // EFFECTS: returns the counts packed in 62 bits
+};
+
+Spot valueSpot(int value);
+// EFFECTS: returns a spot of the card value, TEN for the tens
+
+int spotValue(Spot spot);
+// EFFECTS: returns the card value of spot
+
+class ExactEV {
+    // OVERVIEW: the exact expected win per unit bet of standing or
+    // hitting, by enumerating every order the cards left can come out
+    // in. The results are kept by the cards left and the hands, so that
+    // the same situation is computed once.
+    struct Key {
+        uint64_t counts;
+        int hand;
+        bool operator==(const Key &other) const {
+            return counts == other.counts && hand == other.hand;
+        }
+    };
+    struct KeyHash {
+        std::size_t operator()(const Key &key) const {
+            return std::hash<uint64_t>()(key.counts * 31 + (uint64_t) key.hand);
+        }
+    };
+    struct Totals {
+        double p[6];    // Probability of a final total of 17 to 21, or of a bust
+    };
+    std::unordered_map<Key, Totals, KeyHash> dealer;
+    std::unordered_map<Key, double, KeyHash> hitting;
+
+    const Totals &dealerTotals(Composition &shoe, const Hand &hand);
+    double bestAfterHit(Composition &shoe, const Hand &player, Spot up);
+ public:
+    double stand(Composition shoe, const Hand &player, Spot up);
+    // REQUIRES: the player's total is at most 21, and shoe holds the
+    // cards not seen, the dealer's hole card among them
+    // EFFECTS: returns the EV of standing on player against up. A shoe
+    // that runs out before the dealer reaches 17 counts as a dealer
+    // bust; it cannot with 20 cards or more left.
+
+    double hit(Composition shoe, const Hand &player, Spot up);
+    // REQUIRES: as for stand
+    // EFFECTS: returns the EV of hitting player once, and then standing
+    // or hitting, whichever is better, on each hand it can become.
+
+    void clear();
+    // MODIFIES: this
+    // EFFECTS: forgets the results kept.
+};
+
+#endif /* __EV_H__ */
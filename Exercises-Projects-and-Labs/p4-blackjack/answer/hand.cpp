@@ -14,28 +14,17 @@ void Hand::discardAll() {
 }
 
 void Hand::addCard(Card c) {
-    switch (c.spot) {
-        case ACE:
-            if (this->curValue.soft || this->curValue.count >= 21) {
-                this->curValue.count++;
-            } else {
-                this->curValue.count += 11;
-                this->curValue.soft = true;
-            }
-            break;
-        case JACK:
-        case QUEEN:
-        case KING:
-            this->curValue.count += 10;
-            break;
-        default:
-            this->curValue.count += (c.spot + 2);
-            break;
-    }
-    if (this->curValue.soft && this->curValue.count > 21) {
-        this->curValue.count -= 10;
-        this->curValue.soft = false;
-    }
+    // without branches: an ace counts 11 unless the hand is soft already or
+    // at 21 or more, and a soft hand over 21 counts its ace as 1 again
+    int count = this->curValue.count;
+    int soft = this->curValue.soft;
+    int ace = c.spot == ACE;
+    int eleven = ace & !soft & (count < 21);
+    count += SpotValues[c.spot] - 10 * (ace & !eleven);
+    soft |= eleven;
+    int over = soft & (count > 21);
+    this->curValue.count = count - 10 * over;
+    this->curValue.soft = soft & !over;
 }
 
 HandValue Hand::handValue() const {
@@ -0,0 +1,280 @@
+//
+// The hand history of a session, written as fixed records and printed
+// again as the game prints it.
+//
+
+#include "history.h"
+
+#include <algorithm>
+#include <cstring>
+#include "hand.h"
+
+using namespace std;
+
+enum RecordKind {
+    HEADER, HAND, SHUFFLE, MORE, END
+};
+
+static const unsigned char MAGIC[4] = {'B', 'J', 'H', 'H'};
+
+// The records buffered before they are written out
+static const size_t BUFFER_RECORDS = 32768;
+
+// The cards of a hand record, and of each record of more after it
+static const int HAND_CARDS = 16;
+static const int MORE_CARDS = HISTORY_RECORD - 1;
+
+static void storehelper(unsigned char *p, int value) {
+    // MODIFIES: p
+    // EFFECTS: stores value in the 4 bytes at p, little-endian.
+    auto v = (unsigned) value;
+    for (int i = 0; i < 4; i++) {
+        p[i] = (unsigned char) (v >> (8 * i));
+    }
+}
+
+static int loadhelper(const unsigned char *p) {
+    // EFFECTS: returns the value stored by storehelper() at p.
+    unsigned v = 0;
+    for (int i = 3; i >= 0; i--) {
+        v = (v << 8) | p[i];
+    }
+    return (int) v;
+}
+
+HistoryWriter::HistoryWriter(const char *name, int bankroll)
+        : file(name, ios::binary | ios::trunc), buffer(BUFFER_RECORDS * HISTORY_RECORD), used(0),
+          hands(0), bankroll(bankroll) {
+    unsigned char *p = next();
+    memcpy(p, MAGIC, sizeof(MAGIC));
+    storehelper(p + 4, bankroll);
+}
+
+bool HistoryWriter::close() {
+    unsigned char *p = next();
+    p[0] = END;
+    storehelper(p + 4, (int) hands);
+    storehelper(p + 8, (int) (hands >> 32));
+    storehelper(p + 12, bankroll);
+    file.write((const char *) buffer.data(), (streamsize) used);
+    used = 0;
+    file.close();
+    return !file.fail();
+}
+
+unsigned char *HistoryWriter::next() {
+    if (used == buffer.size()) {
+        file.write((const char *) buffer.data(), (streamsize) used);
+        used = 0;
+    }
+    unsigned char *p = &buffer[used];
+    memset(p, 0, HISTORY_RECORD);
+    used += HISTORY_RECORD;
+    return p;
+}
+
+void HistoryWriter::shuffled(const int cuts[], int n) {
+    unsigned char *p = next();
+    p[0] = SHUFFLE;
+    p[1] = (unsigned char) n;
+    for (int i = 0; i < n; i++) {
+        p[2 + i] = (unsigned char) cuts[i];
+    }
+}
+
+void HistoryWriter::write(const HandRecord &record) {
+    hands++;
+    bankroll += record.won;
+    unsigned char *p = next();
+    p[0] = HAND;
+    p[1] = (unsigned char) record.flags;
+    p[2] = (unsigned char) record.outcome;
+    p[3] = (unsigned char) record.count;
+    p[4] = (unsigned char) record.draws[0];
+    p[5] = (unsigned char) record.draws[1];
+    storehelper(p + 8, record.wager);
+    storehelper(p + 12, record.won);
+    int stored = min(record.count, HAND_CARDS);
+    memcpy(p + 16, record.cards, (size_t) stored);
+    while (stored < record.count) {
+        p = next();
+        p[0] = MORE;
+        int n = min(record.count - stored, MORE_CARDS);
+        memcpy(p + 1, record.cards + stored, (size_t) n);
+        stored += n;
+    }
+}
+
+static void cardhelper(ostream &out, const char *who, PackedCard card) {
+    // MODIFIES: out
+    // EFFECTS: prints that the card was dealt to who.
+    Card c = unpackCard(card);
+    out << who << " dealt " << SpotNames[c.spot] << " of " << SuitNames[c.suit] << '\n';
+}
+
+static void handhelper(ostream &out, const HandRecord &record) {
+    // MODIFIES: out
+    // EFFECTS: prints the round of record past its bet, as playHand() does.
+    const PackedCard *cards = record.cards;
+    Hand dealer, hands[2];
+    cardhelper(out, "Player", cards[0]);
+    cardhelper(out, "Dealer", cards[1]);
+    cardhelper(out, "Player", cards[2]);
+    hands[0].addCard(unpackCard(cards[0]));
+    hands[0].addCard(unpackCard(cards[2]));
+    dealer.addCard(unpackCard(cards[1]));
+    dealer.addCard(unpackCard(cards[3]));
+    if (hands[0].handValue().count == 21) {
+        out << "Player dealt natural 21\n";
+        return;
+    }
+    int handCount = 1;
+    if (record.flags & HandRecord::SPLIT) {
+        out << "Player splits\n";
+        hands[0].discardAll();
+        hands[0].addCard(unpackCard(cards[0]));
+        hands[1].addCard(unpackCard(cards[2]));
+        handCount = 2;
+    } else if (record.flags & HandRecord::SURRENDER) {
+        out << "Player surrenders\n";
+        return;
+    }
+    int next = 4;
+    for (int h = 0; h < handCount; h++) {
+        int draw = 0;
+        if (handCount == 2 && draw < record.draws[h]) {
+            cardhelper(out, "Player", cards[next]);
+            hands[h].addCard(unpackCard(cards[next++]));
+            draw++;
+        }
+        if (record.flags & (h == 0 ? HandRecord::DOUBLED : HandRecord::DOUBLED_SECOND)) {
+            out << "Player doubles\n";
+        }
+        for (; draw < record.draws[h]; draw++) {
+            cardhelper(out, "Player", cards[next]);
+            hands[h].addCard(unpackCard(cards[next++]));
+        }
+    }
+    bool standing = false;
+    for (int h = 0; h < handCount; h++) {
+        int count = hands[h].handValue().count;
+        if (count > 21) {
+            out << "Player busts\n";
+        } else {
+            out << "Player's total is " << count << '\n';
+            standing = true;
+        }
+    }
+    if (!standing) return;
+    Card hole = unpackCard(cards[3]);
+    out << "Dealer's hole card is " << SpotNames[hole.spot] << " of " << SuitNames[hole.suit] << '\n';
+    for (; next < record.count; next++) {
+        cardhelper(out, "Dealer", cards[next]);
+        dealer.addCard(unpackCard(cards[next]));
+    }
+    int dealerCount = dealer.handValue().count;
+    out << "Dealer's total is " << dealerCount << '\n';
+    for (int h = 0; h < handCount; h++) {
+        int count = hands[h].handValue().count;
+        if (count > 21) continue;
+        if (dealerCount > 21) {
+            out << "Dealer busts\n";
+        } else if (dealerCount > count) {
+            out << "Dealer wins\n";
+        } else if (dealerCount < count) {
+            out << "Player wins\n";
+        } else {
+            out << "Push\n";
+        }
+    }
+}
+
+int printHistory(const char *name, ostream &out) {
+    ifstream file(name, ios::binary);
+    vector<unsigned char> buffer(BUFFER_RECORDS * HISTORY_RECORD);
+    file.read((char *) buffer.data(), HISTORY_RECORD);
+    if (file.gcount() != HISTORY_RECORD || !equal(MAGIC, MAGIC + 4, buffer.begin())) {
+        cout << "Not a hand history: " << name << endl;
+        return 1;
+    }
+    int bankroll = loadhelper(&buffer[4]);
+    long long hands = 0;
+    bool shuffled = false, headed = false;
+    HandRecord record;
+    int missing = 0;    // the cards of record still to be read
+    bool corrupt = false, ended = false;
+    while (!corrupt) {
+        file.read((char *) buffer.data(), (streamsize) buffer.size());
+        auto size = (size_t) file.gcount();
+        if (size == 0) break;
+        // a file cut inside a record has its whole records read first
+        size_t partial = size % HISTORY_RECORD;
+        size -= partial;
+        for (size_t i = 0; i < size && !corrupt; i += HISTORY_RECORD) {
+            const unsigned char *p = &buffer[i];
+            if (ended) {
+                // nothing follows the end record
+                corrupt = true;
+                break;
+            } else if (missing > 0) {
+                if (p[0] != MORE) {
+                    corrupt = true;
+                    break;
+                }
+                int n = min(missing, MORE_CARDS);
+                memcpy(record.cards + record.count - missing, p + 1, (size_t) n);
+                missing -= n;
+            } else if (p[0] == SHUFFLE && p[1] <= HISTORY_RECORD - 2) {
+                // the first shuffle comes before the first hand, the others
+                // after the line of the hand they are made for
+                if (shuffled) {
+                    out << "Hand " << hands + 1 << " bankroll " << bankroll << '\n';
+                    headed = true;
+                }
+                shuffled = true;
+                out << "Shuffling the deck\n";
+                for (int c = 0; c < p[1]; c++) {
+                    out << "cut at " << (int) p[2 + c] << '\n';
+                }
+                continue;
+            } else if (p[0] == HAND && p[3] >= 4 && p[3] <= DeckSize && p[4] + p[5] <= p[3] - 4) {
+                record.flags = p[1];
+                record.outcome = p[2];
+                record.count = p[3];
+                record.draws[0] = p[4];
+                record.draws[1] = p[5];
+                record.wager = loadhelper(p + 8);
+                record.won = loadhelper(p + 12);
+                int n = min(record.count, HAND_CARDS);
+                memcpy(record.cards, p + 16, (size_t) n);
+                missing = record.count - n;
+            } else if (p[0] == END) {
+                long long count = (unsigned) loadhelper(p + 4) | (long long) loadhelper(p + 8) << 32;
+                corrupt = count != hands || loadhelper(p + 12) != bankroll || headed;
+                ended = true;
+                continue;
+            } else {
+                corrupt = true;
+                break;
+            }
+            if (missing > 0) continue;
+            if (!headed) out << "Hand " << hands + 1 << " bankroll " << bankroll << '\n';
+            headed = false;
+            out << "Player bets " << record.wager << '\n';
+            handhelper(out, record);
+            bankroll += record.won;
+            hands++;
+        }
+        if (partial) {
+            corrupt = corrupt || ended;
+            break;
+        }
+    }
+    if (ended && !corrupt) {
+        out << "Player has " << bankroll << " after " << hands << " hands\n";
+        return 0;
+    }
+    out.flush();
+    cout << (corrupt ? "Corrupt" : "Truncated") << " hand history: " << name << endl;
+    return 1;
+}
@@ -0,0 +1,103 @@
+#ifndef __HISTORY_H__
+#define __HISTORY_H__
+
+#include <fstream>
+#include <iostream>
+#include <vector>
+#include "card.h"
+#include "deck.h"
+
+// A hand history: the hands of a session as fixed records of 32 bytes, from
+// which the text the game prints is made again offline. The file starts
+// with a record of the magic "BJHH" and the bankroll, and then has:
+//
+//   a shuffle: 2, the number of cuts, and each cut as a byte
+//   a hand:    1, the flags and outcome of its HandRecord, the number of
+//              cards, the draws of each hand, 2 bytes of zero, the wager
+//              and what was won as 4 bytes little-endian each, and the
+//              first 16 cards dealt as packed cards
+//   more:      3, and the next 31 cards of the hand before it
+//   end:       4, 3 bytes of zero, the number of hands as 8 bytes and the
+//              final bankroll as 4 bytes, little-endian
+//
+// A shuffle is written before the hand it is made for. The end record is
+// the last of the file, so one cut off on a record boundary is told from
+// a shorter session.
+
+const int HISTORY_RECORD = 32;
+
+struct HandRecord {
+    // OVERVIEW: the cards of a round in the order they are dealt, the
+    // player's first two at 0 and 2 and the dealer's up and hole card at
+    // 1 and 3, and what the player did with them
+    enum Flag {
+        SPLIT = 1, SURRENDER = 2, DOUBLED = 4, DOUBLED_SECOND = 8,
+        SECOND = 16     // the second hand of a split is played
+    };
+    int flags = 0;
+    int outcome = 0;
+    int wager = 0;
+    int won = 0;            // by the player, negative if lost
+    int draws[2] = {};      // the cards dealt to each hand after the first four
+    int count = 0;
+    PackedCard cards[DeckSize];     // a round deals no more than a deck
+
+    void add(Card c, bool toPlayer) {
+        // REQUIRES: fewer than DeckSize cards were added
+        // MODIFIES: this
+        // EFFECTS: adds the card c, dealt to the player or the dealer.
+        if (toPlayer && count >= 4) draws[(flags & SECOND) != 0]++;
+        cards[count++] = packCard(c);
+    }
+
+    void note(Flag flag) {
+        // MODIFIES: this
+        // EFFECTS: adds what the player did to the hand being played: a
+        // double counts for the second hand once it is played.
+        flags |= flag == DOUBLED && (flags & SECOND) ? DOUBLED_SECOND : flag;
+    }
+};
+
+class HistoryWriter {
+    // OVERVIEW: writes the records of a session to a file, a buffer of
+    // them at a time
+    std::ofstream file;
+    std::vector<unsigned char> buffer;
+    size_t used;
+    long long hands;        // written so far
+    int bankroll;           // after them
+
+    unsigned char *next();
+    // MODIFIES: this
+    // EFFECTS: returns the next record of the buffer, zeroed, writing the
+    // buffer out first if it is full.
+ public:
+    HistoryWriter(const char *name, int bankroll);
+    // EFFECTS: creates the file name, or empties it, for a session from
+    // bankroll.
+
+    bool close();
+    // MODIFIES: this
+    // EFFECTS: writes the end record and the records not written yet and
+    // closes the file, and returns false if it could not be created or
+    // written.
+
+    void shuffled(const int cuts[], int n);
+    // REQUIRES: the file is not closed, n <= HISTORY_RECORD - 2, and
+    // each cut is at most 255
+    // MODIFIES: this
+    // EFFECTS: adds a shuffle of the deck by n cuts.
+
+    void write(const HandRecord &record);
+    // REQUIRES: the file is not closed
+    // MODIFIES: this
+    // EFFECTS: adds a hand.
+};
+
+int printHistory(const char *name, std::ostream &out);
+// MODIFIES: out
+// EFFECTS: prints the session of the history in the file name to out, as
+// the game prints it as it plays, and returns 0, or prints why it cannot
+// to cout and returns 1.
+
+#endif /* __HISTORY_H__ */
@@ -3,31 +3,7 @@
 //
 
 #include "player.h"
-
-static bool playerDraw(Card dealer, const Hand &player) {
-    auto value = player.handValue();
-    if (value.soft) {
-        return (value.count <= 17) ||
-               (value.count == 18 && !(dealer.spot == TWO || dealer.spot == SEVEN || dealer.spot == EIGHT));
-        /*if (value.count <= 17) {
-            return true;
-        } else if (value.count == 18 && !(dealer.spot == TWO || dealer.spot == SEVEN || dealer.spot == EIGHT)) {
-            return true;
-        }*/
-    } else {
-        return (value.count <= 11) ||
-               (value.count == 12 && !(dealer.spot >= FOUR && dealer.spot <= SIX)) ||
-               (value.count >= 13 && value.count <= 16 && !(dealer.spot >= TWO && dealer.spot <= SIX));
-        /*if (value.count <= 11) {
-            return true;
-        } else if (value.count == 12 && !(dealer.spot >= FOUR && dealer.spot <= SIX)) {
-            return true;
-        } else if (value.count >= 13 && value.count <= 16 && !(dealer.spot >= TWO && dealer.spot <= SIX)) {
-            return true;
-        }*/
-    }
-//        return false;
-}
+#include "strategy.h"
 
 class SimplePlayer : public Player {
 public:
@@ -37,7 +13,19 @@ public:
     }
 
     bool draw(Card dealer, const Hand &player) override {
-        return playerDraw(dealer, player);
+        return basicDraw(dealer, player);
+    }
+
+    bool split(Card dealer, Spot pair, bool doubleAfterSplit) override {
+        return basicSplit(dealer, pair, doubleAfterSplit);
+    }
+
+    bool surrender(Card dealer, const Hand &player) override {
+        return basicSurrender(dealer, player);
+    }
+
+    bool doubleDown(Card dealer, const Hand &player) override {
+        return basicDouble(dealer, player);
     }
 
     void expose(Card c) override {}
@@ -64,7 +52,19 @@ public:
     }
 
     bool draw(Card dealer, const Hand &player) override {
-        return playerDraw(dealer, player);
+        return basicDraw(dealer, player);
+    }
+
+    bool split(Card dealer, Spot pair, bool doubleAfterSplit) override {
+        return basicSplit(dealer, pair, doubleAfterSplit);
+    }
+
+    bool surrender(Card dealer, const Hand &player) override {
+        return basicSurrender(dealer, player);
+    }
+
+    bool doubleDown(Card dealer, const Hand &player) override {
+        return basicDouble(dealer, player);
     }
 
     void expose(Card c) override {
@@ -82,4 +82,52 @@ public:
 
 Player *get_Counting() {
     return (Player *) new CountingPlayer();
-}
\ No newline at end of file
+}
+
+class DealerPlayer : public Player {
+public:
+    int bet(unsigned int, unsigned int minimum) override {
+        return (int) minimum;
+    }
+
+    bool draw(Card, const Hand &player) override {
+        return player.handValue().count < 17;
+    }
+
+    void expose(Card) override {}
+
+    void shuffled() override {}
+};
+
+Player *get_Dealer() {
+    return (Player *) new DealerPlayer();
+}
+
+class CautiousPlayer : public Player {
+public:
+    int bet(unsigned int, unsigned int minimum) override {
+        return (int) minimum;
+    }
+
+    bool draw(Card, const Hand &player) override {
+        auto value = player.handValue();
+        return value.soft ? value.count <= 17 : value.count <= 11;
+    }
+
+    void expose(Card) override {}
+
+    void shuffled() override {}
+};
+
+Player *get_Cautious() {
+    return (Player *) new CautiousPlayer();
+}
+
+const Strategy Strategies[] = {
+        {"simple",   get_Simple},
+        {"counting", get_Counting},
+        {"dealer",   get_Dealer},
+        {"cautious", get_Cautious},
+};
+
+const int StrategyCount = sizeof(Strategies) / sizeof(Strategies[0]);
@@ -29,6 +29,20 @@ class Player {
     virtual void shuffled() = 0;
     // EFFECTS: tells the player that the deck has been re-shuffled.
 
+    virtual bool split(Card /* dealer */, Spot /* pair */, bool /* doubleAfterSplit */) { return false; }
+    // EFFECTS: returns true if the player splits the pair of pair dealt
+    // into two hands of the bet each. Asked only under rules that split,
+    // first of all, with doubleAfterSplit true if the hands may double.
+
+    virtual bool surrender(Card /* dealer */, const Hand & /* player */) { return false; }
+    // EFFECTS: returns true if the player gives up the first two cards
+    // for half the bet. Asked only under rules that surrender.
+
+    virtual bool doubleDown(Card /* dealer */, const Hand & /* player */) { return false; }
+    // EFFECTS: returns true if the player doubles the bet on the two
+    // cards of player, to be dealt one card more. Asked only under rules
+    // that double, and after a split only if they double after it.
+
     virtual ~Player() { }
     // Note: this is here only to suppress a compiler warning.
     //       Destructors are not needed for this project.
@@ -42,4 +56,23 @@ extern Player *get_Counting();
 // EFFECTS: returns a pointer to a "counting player", as defined by
 // the project specification.
 
+extern Player *get_Dealer();
+// EFFECTS: returns a pointer to a player that draws to 17 like the
+// dealer, betting the minimum
+
+extern Player *get_Cautious();
+// EFFECTS: returns a pointer to a player that never risks a bust,
+// drawing only on hard 11 or less and soft 17 or less, betting the
+// minimum
+
+struct Strategy {
+    const char *name;
+    Player *(*get)();
+};
+
+extern const Strategy Strategies[];
+extern const int StrategyCount;
+// The players that can be named on the command line, in this order:
+// simple, counting, dealer and cautious
+
 #endif /* __PLAYER_H__ */
@@ -50,8 +50,6 @@
 
 #include "rand.h"
 
-static int initialized = 0;
-
 /* Period parameters */  
 #define N 624
 #define M 397
@@ -59,11 +57,10 @@ static int initialized = 0;
 #define UPPER_MASK 0x80000000UL /* most significant w-r bits */
 #define LOWER_MASK 0x7fffffffUL /* least significant r bits */
 
-static unsigned long mt[N]; /* the array for the state vector  */
-static int mti=N+1; /* mti==N+1 means mt[N] is not initialized */
+/* the state of each stream is a Random, mt[N] and mti of the original */
 
 /* initializes mt[N] with a seed */
-void init_genrand(unsigned long s)
+Random::Random(unsigned long s)
 {
     mt[0]= s & 0xffffffffUL;
     for (mti=1; mti<N; mti++) {
@@ -82,10 +79,9 @@ void init_genrand(unsigned long s)
 /* init_key is the array for initializing keys */
 /* key_length is its length */
 /* slight change for C++, 2004/2/26 */
-void init_by_array(unsigned long init_key[], int key_length)
+Random::Random(const unsigned long init_key[], int key_length) : Random(19650218UL)
 {
     int i, j, k;
-    init_genrand(19650218UL);
     i=1; j=0;
     k = (N>key_length ? N : key_length);
     for (; k; k--) {
@@ -108,18 +104,15 @@ void init_by_array(unsigned long init_key[], int key_length)
 }
 
 /* generates a random number on [0,0xffffffff]-interval */
-unsigned long genrand_int32(void)
+unsigned long Random::genrand_int32()
 {
     unsigned long y;
-    static unsigned long mag01[2]={0x0UL, MATRIX_A};
+    static const unsigned long mag01[2]={0x0UL, MATRIX_A};
     /* mag01[x] = x * MATRIX_A  for x=0,1 */
 
     if (mti >= N) { /* generate N words at one time */
         int kk;
 
-        if (mti == N+1)   /* if init_genrand() has not been called, */
-            init_genrand(5489UL); /* a default initial seed is used */
-
         for (kk=0;kk<N-M;kk++) {
             y = (mt[kk]&UPPER_MASK)|(mt[kk+1]&LOWER_MASK);
             mt[kk] = mt[kk+M] ^ (y >> 1) ^ mag01[y & 0x1UL];
@@ -145,48 +138,19 @@ unsigned long genrand_int32(void)
     return y;
 }
 
-/* generates a random number on [0,0x7fffffff]-interval */
-long genrand_int31(void)
-{
-    return (long)(genrand_int32()>>1);
-}
-
-/* generates a random number on [0,1]-real-interval */
-double genrand_real1(void)
+/* by rejection: the draws past the last multiple of n are drawn again */
+unsigned long Random::genrand_below(unsigned long n)
 {
-    return genrand_int32()*(1.0/4294967295.0); 
-    /* divided by 2^32-1 */ 
+    unsigned long limit = 0x100000000UL - 0x100000000UL % n;
+    unsigned long r;
+    do {
+        r = genrand_int32();
+    } while (r >= limit);
+    return r % n;
 }
 
-/* generates a random number on [0,1)-real-interval */
-double genrand_real2(void)
+int Random::get_cut()
 {
-    return genrand_int32()*(1.0/4294967296.0); 
-    /* divided by 2^32 */
-}
-
-/* generates a random number on (0,1)-real-interval */
-double genrand_real3(void)
-{
-    return (((double)genrand_int32()) + 0.5)*(1.0/4294967296.0); 
-    /* divided by 2^32 */
-}
-
-/* generates a random number on [0,1) with 53-bit resolution*/
-double genrand_res53(void) 
-{ 
-    unsigned long a=genrand_int32()>>5, b=genrand_int32()>>6; 
-    return(a*67108864.0+b)*(1.0/9007199254740992.0); 
-} 
-/* These real versions are due to Isaku Wada, 2002/01/09 added */
-
-int get_cut(void)
-{
-    if (!initialized) {
-	init_genrand(0);
-	initialized = 1;
-    }
-
     const int max = 39;
     const int min = 13;
     const int spread = max - min + 1;
@@ -195,3 +159,10 @@ int get_cut(void)
     int offset = r % spread;
     return min + offset;
 }
+
+/* the stream of get_cut(), seeded with 0 when it is first drawn from */
+int get_cut(void)
+{
+    static Random generator(0UL);
+    return generator.get_cut();
+}
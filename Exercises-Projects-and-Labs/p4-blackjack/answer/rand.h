@@ -4,4 +4,27 @@
 int get_cut();
 // EFFECTS: returns a random number between 13 and 39
 
+class Random {
+    // OVERVIEW: an MT19937 stream with a state of its own, so that each
+    // thread of a simulation can draw from one
+    unsigned long mt[624];
+    int mti;
+ public:
+    explicit Random(unsigned long seed);
+    // EFFECTS: starts the stream as init_genrand(seed)
+
+    Random(const unsigned long key[], int length);
+    // EFFECTS: starts the stream as init_by_array(key, length)
+
+    unsigned long genrand_int32();
+    // EFFECTS: returns a random number on [0,0xffffffff]
+
+    unsigned long genrand_below(unsigned long n);
+    // REQUIRES: 0 < n <= 0x100000000
+    // EFFECTS: returns a random number on [0,n), each equally likely
+
+    int get_cut();
+    // EFFECTS: returns a random number between 13 and 39
+};
+
 #endif /* __RAND_H__ */
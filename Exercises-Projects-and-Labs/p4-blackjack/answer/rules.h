@@ -0,0 +1,56 @@
+#ifndef __RULES_H__
+#define __RULES_H__
+
+#include <string>
+#include "hand.h"
+
+// The rules a hand is played by, as template parameters of the game, so
+// that the options a rule set does not allow are compiled out of it
+
+struct StandSoft17 {
+    // OVERVIEW: the dealer stands on every 17, as in the project
+    static const char *name() { return "S17"; }
+    static bool draws(HandValue dealer) { return dealer.count < 17; }
+};
+
+struct HitSoft17 {
+    // OVERVIEW: the dealer draws to a soft 17
+    static const char *name() { return "H17"; }
+    static bool draws(HandValue dealer) { return dealer.count < 17 || (dealer.count == 17 && dealer.soft); }
+};
+
+struct Pays3To2 {
+    // OVERVIEW: a natural pays 3 to 2, as in the project
+    static const char *name() { return "3:2"; }
+    static int natural(int wager) { return (int) (1.5 * wager); }
+};
+
+struct Pays6To5 {
+    // OVERVIEW: a natural pays 6 to 5
+    static const char *name() { return "6:5"; }
+    static int natural(int wager) { return wager * 6 / 5; }
+};
+
+template<class DealerRule, class NaturalRule, bool DOUBLE, bool SPLIT, bool DOUBLE_AFTER_SPLIT, bool SURRENDER>
+struct Rules {
+    // OVERVIEW: how the dealer draws and a natural pays, and whether the
+    // player may double on two cards, split a pair once, double the hands
+    // of a split, and surrender the first two cards for half the bet
+    typedef DealerRule Dealer;
+    typedef NaturalRule Natural;
+    static constexpr bool canDouble = DOUBLE;
+    static constexpr bool canSplit = SPLIT;
+    static constexpr bool doubleAfterSplit = DOUBLE && SPLIT && DOUBLE_AFTER_SPLIT;
+    static constexpr bool canSurrender = SURRENDER;
+
+    static std::string name() {
+        return std::string(Dealer::name()) + " " + Natural::name() + (canDouble ? " double" : "") +
+               (canSplit ? " split" : "") + (doubleAfterSplit ? " DAS" : "") + (canSurrender ? " surrender" : "");
+    }
+};
+
+typedef Rules<StandSoft17, Pays3To2, false, false, false, false> ProjectRules;
+// The rules of the project: the dealer stands on 17, a natural pays 3 to
+// 2, and the player only hits or stands
+
+#endif /* __RULES_H__ */
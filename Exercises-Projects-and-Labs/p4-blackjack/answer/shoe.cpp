@@ -0,0 +1,52 @@
+//
+// A shoe of several decks, shuffled by Fisher-Yates.
+//
+
+#include "shoe.h"
+
+#include <algorithm>
+
+Shoe::Shoe(int decks, double penetration) : next(0) {
+    Deck deck;
+    for (int i = 0; i < decks; i++) {
+        for (int j = 0; j < DeckSize; j++) {
+            cards.push_back(packCard(deck.deck[j]));
+        }
+    }
+    // at least 20 cards are left behind the cut card for the last hand,
+    // as a deck is shuffled with fewer than 20 left
+    cutCard = std::min((int) (penetration * (double) cards.size()), (int) cards.size() - 20);
+}
+
+void Shoe::shuffle(Random &random) {
+    for (auto i = cards.size() - 1; i > 0; i--) {
+        auto j = random.genrand_below((unsigned long) i + 1);
+        PackedCard temp = cards[i];
+        cards[i] = cards[j];
+        cards[j] = temp;
+    }
+    next = 0;
+}
+
+Card Shoe::deal() {
+    if (next < (int) cards.size()) {
+        return unpackCard(cards[next++]);
+    }
+    throw DeckEmpty();
+}
+
+int Shoe::cardsLeft() const {
+    return (int) cards.size() - next;
+}
+
+bool Shoe::needsShuffle() const {
+    return next >= cutCard;
+}
+
+Card Shoe::peek(int i) const {
+    return unpackCard(cards[next + i]);
+}
+
+void Shoe::burn(int n) {
+    next = std::min(next + n, (int) cards.size());
+}
@@ -0,0 +1,48 @@
+#ifndef __SHOE_H__
+#define __SHOE_H__
+
+#include <vector>
+#include "card.h"
+#include "deck.h"
+#include "rand.h"
+
+class Shoe {
+    // OVERVIEW: one or more decks shuffled together, dealt until the
+    // cut card placed at the penetration comes out
+    std::vector<PackedCard> cards;
+    int next;       // The next card to deal
+    int cutCard;    // The index of the cut card
+ public:
+    Shoe(int decks, double penetration);
+    // REQUIRES: decks >= 1, 0 < penetration <= 1
+    // EFFECTS: constructs a shoe of decks "newly opened" decks, with
+    // the cut card after that fraction of its cards, and at least 20
+    // cards before the end.
+
+    void shuffle(Random &random);
+    // MODIFIES: this, random
+    // EFFECTS: shuffles all the cards of the shoe, dealt or not, by
+    // Fisher-Yates, and makes the first card the next card to deal.
+
+    Card deal();
+    // MODIFIES: this
+    // EFFECTS: returns the next card to be dealt.  If no cards
+    // remain, throws an instance of DeckEmpty.
+
+    int cardsLeft() const;
+    // EFFECTS: returns the number of cards not dealt since the last
+    // shuffle.
+
+    bool needsShuffle() const;
+    // EFFECTS: returns true once the cut card has come out.
+
+    Card peek(int i) const;
+    // REQUIRES: 0 <= i < cardsLeft()
+    // EFFECTS: returns the card i places after the next card to deal.
+
+    void burn(int n);
+    // MODIFIES: this
+    // EFFECTS: discards the next n cards, or all that are left.
+};
+
+#endif /* __SHOE_H__ */
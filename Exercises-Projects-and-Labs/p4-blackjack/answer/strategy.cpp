@@ -0,0 +1,157 @@
+//
+// Tables of the basic strategy and of the dealer's outcomes.
+//
+
+#include "strategy.h"
+
+// The hands a decision is asked on are hard 4 to 21 and soft 12 to 21
+const int MAX_COUNT = 21;
+
+static bool ruleDraw(Spot dealer, HandValue value) {
+    if (value.soft) {
+        return (value.count <= 17) ||
+               (value.count == 18 && !(dealer == TWO || dealer == SEVEN || dealer == EIGHT));
+    } else {
+        return (value.count <= 11) ||
+               (value.count == 12 && !(dealer >= FOUR && dealer <= SIX)) ||
+               (value.count >= 13 && value.count <= 16 && !(dealer >= TWO && dealer <= SIX));
+    }
+}
+
+static bool isTen(Spot spot) {
+    return spot >= TEN && spot <= KING;
+}
+
+// Doubling, splitting and surrender as in the charts of multi-deck basic
+// strategy, the dealer standing on soft 17
+static bool ruleDouble(Spot dealer, HandValue value) {
+    if (value.soft) {
+        return (value.count >= 13 && value.count <= 14 && dealer >= FIVE && dealer <= SIX) ||
+               (value.count >= 15 && value.count <= 16 && dealer >= FOUR && dealer <= SIX) ||
+               (value.count >= 17 && value.count <= 18 && dealer >= THREE && dealer <= SIX);
+    } else {
+        return (value.count == 9 && dealer >= THREE && dealer <= SIX) ||
+               (value.count == 10 && dealer <= NINE) ||
+               (value.count == 11 && dealer != ACE);
+    }
+}
+
+static bool ruleSplit(Spot dealer, Spot pair, bool doubleAfterSplit) {
+    switch (pair) {
+        case ACE:
+        case EIGHT:
+            return true;
+        case TWO:
+        case THREE:
+            return dealer >= (doubleAfterSplit ? TWO : FOUR) && dealer <= SEVEN;
+        case FOUR:
+            return doubleAfterSplit && dealer >= FIVE && dealer <= SIX;
+        case SIX:
+            return dealer >= (doubleAfterSplit ? TWO : THREE) && dealer <= SIX;
+        case SEVEN:
+            return dealer <= SEVEN;
+        case NINE:
+            return dealer <= SIX || dealer == EIGHT || dealer == NINE;
+        default:
+            return false;
+    }
+}
+
+static bool ruleSurrender(Spot dealer, HandValue value) {
+    return !value.soft && ((value.count == 16 && (dealer == NINE || isTen(dealer) || dealer == ACE)) ||
+                           (value.count == 15 && isTen(dealer)));
+}
+
+// The final totals of a dealer holding a hand, memoized by its value
+struct DealerTable {
+    DealerOutcome outcome[MAX_COUNT + 1][2];
+    bool known[MAX_COUNT + 1][2] = {};
+
+    const DealerOutcome &of(const Hand &hand) {
+        auto value = hand.handValue();
+        auto &result = outcome[value.count][value.soft];
+        if (known[value.count][value.soft]) return result;
+        result = DealerOutcome{{0, 0, 0, 0, 0}, 0};
+        // the ten, jack, queen and king are a third of the cards between them
+        for (int spot = TWO; spot <= ACE; spot++) {
+            Hand next = hand;
+            next.addCard(Card{Spot(spot), SPADES});
+            auto nextValue = next.handValue();
+            if (nextValue.count > MAX_COUNT) {
+                result.bust += 1.0 / 13;
+            } else if (nextValue.count >= 17) {
+                result.total[nextValue.count - 17] += 1.0 / 13;
+            } else {
+                auto &rest = of(next);
+                for (int i = 0; i < 5; i++) {
+                    result.total[i] += rest.total[i] / 13;
+                }
+                result.bust += rest.bust / 13;
+            }
+        }
+        known[value.count][value.soft] = true;
+        return result;
+    }
+};
+
+// The tables, built before main
+static struct Tables {
+    bool draw[2][MAX_COUNT + 1][ACE + 1];
+    bool doubles[2][MAX_COUNT + 1][ACE + 1];
+    bool surrenders[MAX_COUNT + 1][ACE + 1];
+    bool splits[2][ACE + 1][ACE + 1];   // by double after split, pair and up card
+    DealerOutcome dealer[ACE + 1];
+
+    Tables() {
+        for (int soft = 0; soft < 2; soft++) {
+            for (int count = 0; count <= MAX_COUNT; count++) {
+                for (int spot = TWO; spot <= ACE; spot++) {
+                    draw[soft][count][spot] = ruleDraw(Spot(spot), HandValue{count, soft != 0});
+                    doubles[soft][count][spot] = ruleDouble(Spot(spot), HandValue{count, soft != 0});
+                }
+            }
+        }
+        for (int count = 0; count <= MAX_COUNT; count++) {
+            for (int spot = TWO; spot <= ACE; spot++) {
+                surrenders[count][spot] = ruleSurrender(Spot(spot), HandValue{count, false});
+            }
+        }
+        for (int das = 0; das < 2; das++) {
+            for (int pair = TWO; pair <= ACE; pair++) {
+                for (int spot = TWO; spot <= ACE; spot++) {
+                    splits[das][pair][spot] = ruleSplit(Spot(spot), Spot(pair), das != 0);
+                }
+            }
+        }
+        DealerTable table;
+        for (int spot = TWO; spot <= ACE; spot++) {
+            Hand hand;
+            hand.addCard(Card{Spot(spot), SPADES});
+            dealer[spot] = table.of(hand);
+        }
+    }
+} tables;
+
+bool basicDraw(Card dealer, const Hand &player) {
+    auto value = player.handValue();
+    // a hand over 21 is done
+    return value.count <= MAX_COUNT && tables.draw[value.soft][value.count][dealer.spot];
+}
+
+bool basicDouble(Card dealer, const Hand &player) {
+    auto value = player.handValue();
+    return value.count <= MAX_COUNT && tables.doubles[value.soft][value.count][dealer.spot];
+}
+
+bool basicSplit(Card dealer, Spot pair, bool doubleAfterSplit) {
+    return tables.splits[doubleAfterSplit][pair][dealer.spot];
+}
+
+bool basicSurrender(Card dealer, const Hand &player) {
+    auto value = player.handValue();
+    return !value.soft && value.count <= MAX_COUNT && tables.surrenders[value.count][dealer.spot];
+}
+
+const DealerOutcome &dealerOutcome(Spot up) {
+    return tables.dealer[up];
+}
@@ -0,0 +1,34 @@
+#ifndef __STRATEGY_H__
+#define __STRATEGY_H__
+
+#include "card.h"
+#include "hand.h"
+
+bool basicDraw(Card dealer, const Hand &player);
+// EFFECTS: returns true if the basic strategy of the project draws
+// another card on the hand player against the dealer's up card. The
+// decisions are looked up in a table built at startup from the rules.
+
+bool basicDouble(Card dealer, const Hand &player);
+// EFFECTS: returns true if the basic strategy doubles down on the two
+// cards of player against the dealer's up card.
+
+bool basicSplit(Card dealer, Spot pair, bool doubleAfterSplit);
+// EFFECTS: returns true if the basic strategy splits a pair of pair,
+// splitting more pairs if the hands may then double.
+
+bool basicSurrender(Card dealer, const Hand &player);
+// EFFECTS: returns true if the basic strategy surrenders the first two
+// cards of player.
+
+struct DealerOutcome {
+    double total[5];   // Probability of a final total of 17 to 21
+    double bust;       // Probability of going over 21
+};
+
+const DealerOutcome &dealerOutcome(Spot up);
+// EFFECTS: returns the exact probabilities of the dealer's final total
+// when it shows up, drawing to 17 from an infinite deck. The hole card
+// is one of the cards drawn.
+
+#endif /* __STRATEGY_H__ */
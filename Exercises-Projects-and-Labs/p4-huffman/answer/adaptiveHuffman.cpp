@@ -0,0 +1,155 @@
+#include "adaptiveHuffman.h"
+
+using namespace std;
+
+AdaptiveTree::AdaptiveTree() : nytNode(0), nodeNum(1) {
+    for (int i = 0; i < MAX_NODES; i++) byOrder[i] = -1;
+    for (int c = 0; c < 256; c++) leaves[c] = -1;
+    weights[0] = 0;
+    parents[0] = -1;
+    children[0][0] = children[0][1] = -1;
+    symbols[0] = 256;
+    orders[0] = MAX_NODES - 1;
+    byOrder[MAX_NODES - 1] = 0;
+}
+
+void AdaptiveTree::swaphelper(int a, int b) {
+    int pa = parents[a], pb = parents[b];
+    int ia = children[pa][1] == a, ib = children[pb][1] == b;
+    children[pa][ia] = b;
+    children[pb][ib] = a;
+    parents[a] = pb;
+    parents[b] = pa;
+    int oa = orders[a], ob = orders[b];
+    orders[a] = ob;
+    orders[b] = oa;
+    byOrder[ob] = a;
+    byOrder[oa] = b;
+}
+
+void AdaptiveTree::update(unsigned char c) {
+    int q = leaves[c];
+    if (q < 0) {
+        // The NYT leaf becomes an internal node over a new NYT leaf and the
+        // leaf of c, which take the two orders just below it
+        int old = nytNode, o = orders[old];
+        int fresh = nodeNum++;
+        q = nodeNum++;
+        weights[fresh] = weights[q] = 0;
+        parents[fresh] = parents[q] = old;
+        children[fresh][0] = children[fresh][1] = children[q][0] = children[q][1] = -1;
+        symbols[fresh] = 256;
+        symbols[q] = c;
+        orders[q] = o - 1;
+        byOrder[o - 1] = q;
+        orders[fresh] = o - 2;
+        byOrder[o - 2] = fresh;
+        children[old][0] = fresh;
+        children[old][1] = q;
+        symbols[old] = -1;
+        nytNode = fresh;
+        leaves[c] = q;
+    }
+    while (q >= 0) {
+        // Move q to the highest order of its weight before counting it, so
+        // that the weights stay in order. That node is its parent only for a
+        // new leaf, whose parent then has the weight 0 of both its children.
+        int o = orders[q];
+        while (o + 1 < MAX_NODES && weights[byOrder[o + 1]] == weights[q]) o++;
+        int leader = byOrder[o];
+        if (leader != q && leader != parents[q]) swaphelper(q, leader);
+        weights[q]++;
+        q = parents[q];
+    }
+}
+
+void AdaptiveTree::putCode(int n, BitWriter &out) const {
+    // The path is found from the leaf up, so it is written backwards
+    unsigned char path[MAX_NODES];
+    int len = 0;
+    for (; n != root(); n = parents[n]) path[len++] = (unsigned char) (children[parents[n]][1] == n);
+    while (len > 0) {
+        int chunk = len < 32 ? len : 32;
+        uint64_t bits = 0;
+        for (int i = 0; i < chunk; i++) bits = (bits << 1) | path[--len];
+        out.put(bits, chunk);
+    }
+}
+
+void AdaptiveEncoder::put(unsigned char c) {
+    int leaf = tree.leaf(c);
+    if (leaf < 0) {
+        tree.putCode(tree.nyt(), out);
+        out.put(c, ESCAPE_BITS);
+    } else {
+        tree.putCode(leaf, out);
+    }
+    tree.update(c);
+}
+
+void AdaptiveEncoder::flush() {
+    tree.putCode(tree.nyt(), out);
+    out.put(ESCAPE_FLUSH, ESCAPE_BITS);
+    out.flush();
+}
+
+void AdaptiveEncoder::finish() {
+    tree.putCode(tree.nyt(), out);
+    out.put(ESCAPE_END, ESCAPE_BITS);
+    out.flush();
+}
+
+AdaptiveDecoder::AdaptiveDecoder() : node(0), escapeLeft(0), escape(0) {
+    starthelper();
+}
+
+void AdaptiveDecoder::starthelper() {
+    // Before the first character the root is the NYT leaf, whose code is empty
+    node = tree.root();
+    if (tree.isLeaf(node)) {
+        escapeLeft = ESCAPE_BITS;
+        escape = 0;
+    }
+}
+
+AdaptiveDecoder::Status AdaptiveDecoder::feed(const unsigned char *data, size_t n, string &out, size_t &used) {
+    for (size_t i = 0; i < n; i++) {
+        for (int b = 7; b >= 0; b--) {
+            int bit = (data[i] >> b) & 1;
+            if (escapeLeft > 0) {
+                escape = (escape << 1) | unsigned(bit);
+                if (--escapeLeft > 0) continue;
+                if (escape == ESCAPE_END) {
+                    used = i + 1;
+                    return DECODE_END;
+                }
+                if (escape == ESCAPE_FLUSH) {
+                    // The rest of the byte is padding
+                    starthelper();
+                    break;
+                }
+                if (escape > 255 || tree.leaf((unsigned char) escape) >= 0) {
+                    used = i + 1;
+                    return DECODE_CORRUPT;
+                }
+                out.push_back(char(escape));
+                tree.update((unsigned char) escape);
+                starthelper();
+                continue;
+            }
+            node = tree.child(node, bit);
+            if (!tree.isLeaf(node)) continue;
+            if (node == tree.nyt()) {
+                escapeLeft = ESCAPE_BITS;
+                escape = 0;
+                continue;
+            }
+            unsigned char c = (unsigned char) tree.symbol(node);
+            out.push_back(char(c));
+            tree.update(c);
+            starthelper();
+        }
+    }
+    used = n;
+    return DECODE_MORE;
+}
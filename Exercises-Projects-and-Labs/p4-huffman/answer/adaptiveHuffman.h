@@ -0,0 +1,128 @@
+#ifndef P4_ADAPTIVEHUFFMAN_H
+#define P4_ADAPTIVEHUFFMAN_H
+
+#include "bitStream.h"
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+// An adaptive archive ("-adaptive") is coded in one pass, with no frequency
+// count first: coder and decoder keep the same Huffman tree of the characters
+// seen so far and update it after each one (the FGK algorithm). A character
+// not seen before is sent as the code of the "not yet transmitted" (NYT) leaf
+// followed by an escape of ESCAPE_BITS bits, which is either the character or
+// one of the escape codes below.
+//
+// The archive header of mode MODE_ADAPTIVE holds 0 as its length, which is
+// not known when it is written; the bitstream ends with ESCAPE_END instead.
+// ESCAPE_FLUSH pads the bitstream to a whole byte, so that everything coded
+// so far can be sent, and decoded, before more input arrives.
+
+const int ESCAPE_BITS = 9;
+const unsigned ESCAPE_END = 256;
+const unsigned ESCAPE_FLUSH = 257;
+
+class AdaptiveTree {
+    // The tree of the FGK algorithm, in flat arrays. Every node has an order,
+    // and the sibling property holds: in increasing order the weights never
+    // decrease, and the two children of a node are next to each other. The
+    // root has the highest order and the NYT leaf, of weight 0, the lowest.
+
+public:
+    static const int MAX_NODES = 2 * 257 - 1;   // 256 characters and NYT
+
+    AdaptiveTree();
+    // EFFECTS: Makes the tree of no characters: the lone NYT leaf.
+
+    int root() const { return 0; }
+
+    int nyt() const { return nytNode; }
+
+    int child(int n, int bit) const { return children[n][bit]; }
+
+    bool isLeaf(int n) const { return symbols[n] >= 0; }
+
+    int symbol(int n) const { return symbols[n]; }
+    // EFFECTS: Returns the character of leaf n, or 256 for the NYT leaf.
+
+    int leaf(unsigned char c) const { return leaves[c]; }
+    // EFFECTS: Returns the leaf of c, or -1 if c has not been seen.
+
+    void update(unsigned char c);
+    // MODIFIES: this
+    // EFFECTS: Counts one more c, adding its leaf if it is new, and restores
+    //          the sibling property.
+
+    void putCode(int n, BitWriter &out) const;
+    // MODIFIES: out
+    // EFFECTS: Writes the path from the root to node n.
+
+private:
+    uint64_t weights[MAX_NODES];
+    int parents[MAX_NODES];         // -1 for the root
+    int children[MAX_NODES][2];
+    int symbols[MAX_NODES];         // -1 for an internal node
+    int orders[MAX_NODES];          // The order of each node
+    int byOrder[MAX_NODES];         // The node of each order, -1 if none yet
+    int leaves[256];
+    int nytNode;
+    int nodeNum;
+
+    void swaphelper(int a, int b);
+    // REQUIRES: Neither of a and b is an ancestor of the other.
+    // MODIFIES: this
+    // EFFECTS: Exchanges the subtrees at a and b, and their orders.
+};
+
+class AdaptiveEncoder {
+    // Codes characters one at a time into a BitWriter.
+
+    AdaptiveTree tree;
+    BitWriter &out;
+
+public:
+    explicit AdaptiveEncoder(BitWriter &out) : out(out) {}
+
+    void put(unsigned char c);
+    // MODIFIES: this, out
+    // EFFECTS: Writes the code of c, then updates the tree.
+
+    void flush();
+    // MODIFIES: this, out
+    // EFFECTS: Writes ESCAPE_FLUSH and flushes out to a whole byte.
+
+    void finish();
+    // MODIFIES: this, out
+    // EFFECTS: Writes ESCAPE_END and flushes out.
+};
+
+class AdaptiveDecoder {
+    // Decodes a bitstream of AdaptiveEncoder as its bytes arrive, in pieces
+    // of any size.
+
+    AdaptiveTree tree;
+    int node;               // Where the walk from the root has got to
+    int escapeLeft;         // Bits of the escape still to read, 0 if none
+    unsigned escape;
+
+    void starthelper();
+    // MODIFIES: this
+    // EFFECTS: Starts the next character at the root.
+
+public:
+    enum Status {
+        DECODE_MORE,        // All of the bytes decoded; more are expected
+        DECODE_END,         // ESCAPE_END reached
+        DECODE_CORRUPT,     // Not a bitstream of AdaptiveEncoder
+    };
+
+    AdaptiveDecoder();
+
+    Status feed(const unsigned char *data, size_t n, std::string &out, size_t &used);
+    // MODIFIES: this, out
+    // EFFECTS: Decodes the n bytes at data, appending the characters to out,
+    //          and sets used to the number of bytes taken, which is n unless
+    //          ESCAPE_END is reached. Returns what stopped the decoding.
+};
+
+#endif
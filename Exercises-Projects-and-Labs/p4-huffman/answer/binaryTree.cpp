@@ -3,21 +3,85 @@
 #include <vector>
 #include <fstream>
 #include <sstream>
+#include <utility>
+#include <algorithm>
 
 using namespace std;
 
+/* ================================ NodeStack ================================ */
+
+template <class T>
+class NodeStack {
+    // The explicit stack behind the traversals below. The first INLINE_SIZE
+    // entries live in the object itself, so trees of ordinary depth are walked
+    // without allocating; only deeper ones spill to the heap.
+
+    static const size_t INLINE_SIZE = 64;
+    T local[INLINE_SIZE];
+    vector<T> spill;
+    size_t count;
+
+public:
+    NodeStack() : count(0) {}
+
+    bool empty() const {
+        return count == 0;
+    }
+
+    void push(const T &v) {
+        if (count < INLINE_SIZE) local[count] = v;
+        else spill.push_back(v);
+        count++;
+    }
+
+    T &top() {
+        return count <= INLINE_SIZE ? local[count - 1] : spill.back();
+    }
+
+    T pop() {
+        T v = top();
+        if (count > INLINE_SIZE) spill.pop_back();
+        count--;
+        return v;
+    }
+};
+
 /* ================================== Node =================================== */
 Node::Node(const std::string &str, int num, Node *left, Node *right) :
         str(str), num(num), left(left), right(right) {}
 
 Node::Node(const Node &node) : str(node.str), num(node.num), left(nullptr), right(nullptr) {
-    if (node.left) left = new Node(*node.left);
-    if (node.right) right = new Node(*node.right);
+    // Copy level by level: each stack entry pairs a source node with its
+    // already allocated copy, whose children are still to be made
+    NodeStack<pair<const Node *, Node *> > stack;
+    stack.push(make_pair(&node, this));
+    while (!stack.empty()) {
+        pair<const Node *, Node *> item = stack.pop();
+        const Node *src = item.first;
+        Node *dst = item.second;
+        if (src->left) {
+            dst->left = new Node(src->left->str, src->left->num);
+            stack.push(make_pair(src->left, dst->left));
+        }
+        if (src->right) {
+            dst->right = new Node(src->right->str, src->right->num);
+            stack.push(make_pair(src->right, dst->right));
+        }
+    }
 }
 
 Node::~Node() {
-    delete left;
-    delete right;
+    // Detach every descendant before deleting it, so no destructor recurses
+    NodeStack<Node *> stack;
+    if (left) stack.push(left);
+    if (right) stack.push(right);
+    while (!stack.empty()) {
+        Node *n = stack.pop();
+        if (n->left) stack.push(n->left);
+        if (n->right) stack.push(n->right);
+        n->left = n->right = nullptr;
+        delete n;
+    }
 }
 
 Node *Node::leftSubtree() const {
@@ -53,67 +117,145 @@ Node *Node::mergeNodes(Node *leftNode, Node *rightNode) {
 }
 
 std::string Node::findPath(const Node *node, const std::string &s) {
+    // Pre-order search; each entry remembers the depth of its node, and path
+    // holds the turns leading to the node being visited
+    struct Item {
+        const Node *node;
+        size_t depth;
+        char turn;
+    };
     if (!node) return "-1";
-    if (node->str == s) return "";
-    auto str = findPath(node->left, s);
-    if (str != "-1") return "0" + str;
-    str = findPath(node->right, s);
-    if (str != "-1") return "1" + str;
+    string path;
+    NodeStack<Item> stack;
+    stack.push({node, 0, 0});
+    while (!stack.empty()) {
+        Item item = stack.pop();
+        path.resize(item.depth);
+        if (item.depth > 0) path[item.depth - 1] = item.turn;
+        if (item.node->str == s) return path;
+        if (item.node->right) stack.push({item.node->right, item.depth + 1, '1'});
+        if (item.node->left) stack.push({item.node->left, item.depth + 1, '0'});
+    }
     return "-1";
 }
 
 int Node::sum(const Node *node) {
-    if (!node) return 0;
-    return node->num + sum(node->left) + sum(node->right);
+    int total = 0;
+    NodeStack<const Node *> stack;
+    if (node) stack.push(node);
+    while (!stack.empty()) {
+        const Node *n = stack.pop();
+        total += n->num;
+        if (n->right) stack.push(n->right);
+        if (n->left) stack.push(n->left);
+    }
+    return total;
 }
 
 int Node::depth(const Node *node) {
-    if (!node) return 0;
-    return 1 + max(depth(node->left), depth(node->right));
+    int result = 0;
+    NodeStack<pair<const Node *, int> > stack;
+    if (node) stack.push(make_pair(node, 1));
+    while (!stack.empty()) {
+        pair<const Node *, int> item = stack.pop();
+        result = max(result, item.second);
+        if (item.first->right) stack.push(make_pair(item.first->right, item.second + 1));
+        if (item.first->left) stack.push(make_pair(item.first->left, item.second + 1));
+    }
+    return result;
 }
 
 void Node::preorder_num(const Node *node) {
-    if (!node) return;
-    cout << node->num << " ";
-    preorder_num(node->left);
-    preorder_num(node->right);
+    NodeStack<const Node *> stack;
+    if (node) stack.push(node);
+    while (!stack.empty()) {
+        const Node *n = stack.pop();
+        cout << n->num << " ";
+        if (n->right) stack.push(n->right);
+        if (n->left) stack.push(n->left);
+    }
 }
 
 void Node::inorder_str(const Node *node) {
-    if (!node) return;
-    inorder_str(node->left);
-    cout << node->str << " ";
-    inorder_str(node->right);
+    NodeStack<const Node *> stack;
+    while (node || !stack.empty()) {
+        while (node) {
+            stack.push(node);
+            node = node->left;
+        }
+        node = stack.pop();
+        cout << node->str << " ";
+        node = node->right;
+    }
 }
 
 void Node::postorder_num(const Node *node) {
-    if (!node) return;
-    postorder_num(node->left);
-    postorder_num(node->right);
-    cout << node->num << " ";
+    // A node is printed once the last node printed is its right child, or it
+    // has none
+    NodeStack<const Node *> stack;
+    const Node *last = nullptr;
+    while (node || !stack.empty()) {
+        while (node) {
+            stack.push(node);
+            node = node->left;
+        }
+        const Node *n = stack.top();
+        if (n->right && n->right != last) {
+            node = n->right;
+        } else {
+            cout << n->num << " ";
+            last = stack.pop();
+        }
+    }
 }
 
 bool Node::allPathSumGreater(const Node *node, int sum) {
-    if (!node) return true;
-    if (!node->left && !node->right) return node->num > sum;
-    return allPathSumGreater(node->left, sum - node->num) && allPathSumGreater(node->right, sum - node->num);
+    // Each entry pairs a node with what is left of sum above it
+    NodeStack<pair<const Node *, int> > stack;
+    if (node) stack.push(make_pair(node, sum));
+    while (!stack.empty()) {
+        pair<const Node *, int> item = stack.pop();
+        const Node *n = item.first;
+        if (!n->left && !n->right) {
+            if (n->num <= item.second) return false;
+            continue;
+        }
+        if (n->right) stack.push(make_pair(n->right, item.second - n->num));
+        if (n->left) stack.push(make_pair(n->left, item.second - n->num));
+    }
+    return true;
 }
 
 bool Node::covered_by(const Node *a, const Node *b) {
-    if (!a) return true;
-    if (!b) return false;
-    return a->num == b->num && covered_by(a->left, b->left) && covered_by(a->right, b->right);
+    NodeStack<pair<const Node *, const Node *> > stack;
+    stack.push(make_pair(a, b));
+    while (!stack.empty()) {
+        pair<const Node *, const Node *> item = stack.pop();
+        if (!item.first) continue;
+        if (!item.second || item.first->num != item.second->num) return false;
+        stack.push(make_pair(item.first->right, item.second->right));
+        stack.push(make_pair(item.first->left, item.second->left));
+    }
+    return true;
 }
 
 bool Node::contained_by(const Node *a, const Node *b) {
-    if (covered_by(a, b)) return true;
-    if (!b) return false;
-    return contained_by(a, b->left) || contained_by(a, b->right);
+    // An empty tree is contained by any tree; otherwise try every node of b
+    if (!a) return true;
+    NodeStack<const Node *> stack;
+    if (b) stack.push(b);
+    while (!stack.empty()) {
+        const Node *n = stack.pop();
+        if (covered_by(a, n)) return true;
+        if (n->right) stack.push(n->right);
+        if (n->left) stack.push(n->left);
+    }
+    return false;
 }
 
 /* =============================== Binary Tree =============================== */
 
-BinaryTree::BinaryTree(Node *rootNode) : root(rootNode) {}
+BinaryTree::BinaryTree(Node *rootNode) : summaryRoot(nullptr), root(rootNode) {}
 
 BinaryTree::~BinaryTree() {
     delete root;
@@ -158,6 +300,94 @@ bool BinaryTree::contained_by(const BinaryTree &tree) const {
     return Node::contained_by(root, tree.root);
 }
 
+static uint64_t mixhelper(uint64_t h) {
+    // splitmix64 finaliser
+    h ^= h >> 30;
+    h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 27;
+    h *= 0x94d049bb133111ebULL;
+    return h ^ (h >> 31);
+}
+
+const vector<SubtreeInfo> &BinaryTree::subtreeInfo() const {
+    if (summaryRoot == root && (root == nullptr || !summaries.empty())) return summaries;
+    summaries.clear();
+    summaryRoot = root;
+    // Post-order walk; a node is summarised once both children have been,
+    // their indices waiting on "done" in the order they finished
+    NodeStack<pair<const Node *, bool> > stack;
+    vector<int> done;
+    if (root) stack.push(make_pair(root, false));
+    while (!stack.empty()) {
+        pair<const Node *, bool> &item = stack.top();
+        const Node *n = item.first;
+        if (!item.second) {
+            item.second = true;
+            if (n->rightSubtree()) stack.push(make_pair(n->rightSubtree(), false));
+            if (n->leftSubtree()) stack.push(make_pair(n->leftSubtree(), false));
+            continue;
+        }
+        stack.pop();
+        SubtreeInfo info = {n, 0, 1, 1, -1, -1};
+        if (n->rightSubtree()) {
+            info.right = done.back();
+            done.pop_back();
+        }
+        if (n->leftSubtree()) {
+            info.left = done.back();
+            done.pop_back();
+        }
+        uint64_t lh = 0x9e3779b97f4a7c15ULL, rh = lh;
+        for (int k = 0; k < 2; k++) {
+            int c = k == 0 ? info.left : info.right;
+            if (c < 0) continue;
+            const SubtreeInfo &child = summaries[size_t(c)];
+            (k == 0 ? lh : rh) = child.hash;
+            info.size += child.size;
+            info.height = max(info.height, child.height + 1);
+        }
+        info.hash = mixhelper(mixhelper(uint64_t(uint32_t(n->getnum())) ^ lh) + rh);
+        done.push_back(int(summaries.size()));
+        summaries.push_back(info);
+    }
+    return summaries;
+}
+
+void BinaryTree::rehash() const {
+    summaries.clear();
+    summaryRoot = nullptr;
+}
+
+static bool fitshelper(const vector<SubtreeInfo> &a, int i, const vector<SubtreeInfo> &b, int j) {
+    // EFFECTS: Returns false if subtree i of a cannot be covered by subtree j of b
+    if (i < 0) return true;
+    if (j < 0) return false;
+    const SubtreeInfo &x = a[size_t(i)], &y = b[size_t(j)];
+    return x.node->getnum() == y.node->getnum() && x.size <= y.size && x.height <= y.height;
+}
+
+bool BinaryTree::contained_by(const BinaryTree &tree, bool hashed) const {
+    if (!hashed) return contained_by(tree);
+    if (!root) return true;
+    const vector<SubtreeInfo> &a = subtreeInfo();
+    const vector<SubtreeInfo> &b = tree.subtreeInfo();
+    const SubtreeInfo &top = a.back();
+    // Identical subtrees cover this tree, and are found by hash alone
+    for (size_t j = 0; j < b.size(); j++) {
+        if (b[j].hash == top.hash && b[j].size == top.size && Node::covered_by(root, b[j].node)) return true;
+    }
+    // A subtree with extra nodes can still cover it, but only if it is at
+    // least as large and its top layers agree
+    int ta = int(a.size()) - 1;
+    for (size_t j = 0; j < b.size(); j++) {
+        if (b[j].size == top.size && b[j].hash == top.hash) continue;
+        if (!fitshelper(a, ta, b, int(j)) || !fitshelper(a, top.left, b, b[j].left)
+            || !fitshelper(a, top.right, b, b[j].right)) continue;
+        if (Node::covered_by(root, b[j].node)) return true;
+    }
+    return false;
+}
+
 BinaryTree BinaryTree::copy() const {
     if (!root) return BinaryTree(nullptr);
     return BinaryTree(new Node(*root));
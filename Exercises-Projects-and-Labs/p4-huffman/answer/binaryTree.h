@@ -2,9 +2,15 @@
 #define P4_BINARYTREE_H
 
 #include <string>
+#include <vector>
+#include <cstdint>
+#include "../../../alloc/alloc.h"
 
-class Node {
-    // A node in a binary tree
+class Node : public alloc::Allocated<Node> {
+    // A node in a binary tree. Copying, destruction and the traversals below
+    // walk the tree with an explicit stack, so any depth is safe. Nodes come
+    // from the resource given to Node::setResource(), new and delete unless
+    // set.
 
     std::string str;
     int num;
@@ -21,8 +27,11 @@ public:
     // EFFECTS: Construct a node with given input values.
 
     Node(const Node &node);
+    // MODIFIES: this
+    // EFFECTS: Construct a deep copy of node and every node below it.
 
     ~Node();
+    // EFFECTS: Free every node below this one.
 
     Node *leftSubtree() const;
     // EFFECTS: Return the pointer to the left child of the node.
@@ -79,9 +88,27 @@ public:
 
 };
 
+struct SubtreeInfo {
+    // Summary of the subtree below one node, used to rule out matches quickly
+
+    const Node *node;
+    uint64_t hash;      // Hash of the shape and "num" components
+    int size;           // Number of nodes
+    int height;         // Number of layers
+    int left;           // Index of the left child's summary, -1 if none
+    int right;          // Index of the right child's summary, -1 if none
+};
+
 class BinaryTree {
     // A binary tree object
 
+    mutable std::vector<SubtreeInfo> summaries;     // Post-order; empty until needed
+    mutable const Node *summaryRoot;                // Root the summaries were built for
+
+    const std::vector<SubtreeInfo> &subtreeInfo() const;
+    // EFFECTS: Returns the summary of every subtree, building them if the tree
+    //          has none yet or its root has changed since.
+
 public:
     Node *root;         // Root node of the binary tree
 
@@ -259,6 +286,20 @@ public:
     // EFFECTS: Returns true if this tree is contained by the input binary tree "tree".
     //          (only consider the "num" component)
 
+    bool contained_by(const BinaryTree &tree, bool hashed) const;
+    // REQUIRES: If hashed, neither tree has changed below its root since its
+    //           summaries were last built, or rehash() has been called since.
+    // EFFECTS: Same as contained_by(tree). If hashed, a summary of every subtree
+    //          of both trees is computed once and kept with the tree; covered_by
+    //          is then tried first on subtrees identical to this tree and
+    //          elsewhere only where the sizes, heights and "num" components of
+    //          the top two layers leave room for a match.
+
+    void rehash() const;
+    // MODIFIES: this
+    // EFFECTS: Discards the subtree summaries, to be rebuilt on the next hashed
+    //          query. Call it after changing the tree.
+
     BinaryTree copy() const;
     // EFFECTS: Returns a copy of this tree. Hint: use deep copy.
 };
@@ -0,0 +1,172 @@
+#ifndef P4_BITSTREAM_H
+#define P4_BITSTREAM_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+class BitWriter {
+    // Packs variable-length codes, most significant bit first, into a byte
+    // buffer through a 64-bit accumulator.
+
+    std::string &out;
+    uint64_t acc;       // Pending bits, right-aligned. Bits above "count" are stale.
+    int count;          // Number of pending bits in acc.
+
+    void drain() {
+        while (count >= 8) {
+            count -= 8;
+            out.push_back(char(acc >> count));
+        }
+    }
+
+public:
+    explicit BitWriter(std::string &out) : out(out), acc(0), count(0) {}
+    // MODIFIES: this
+    // EFFECTS: Construct a writer appending whole bytes to out.
+
+    void put(uint64_t bits, int len) {
+        // REQUIRES: 0 <= len <= 64, and bits has no set bit above len.
+        // MODIFIES: this, out
+        // EFFECTS: Append the low len bits of bits, highest bit first.
+        if (len > 32) {
+            put(bits >> 32, len - 32);
+            bits &= 0xffffffffu;
+            len = 32;
+        }
+        if (count + len > 64) drain();
+        acc = (acc << len) | bits;
+        count += len;
+    }
+
+    void flush() {
+        // MODIFIES: this, out
+        // EFFECTS: Write out every pending bit, padding the last byte with zeros.
+        drain();
+        if (count > 0) {
+            out.push_back(char(acc << (8 - count)));
+            count = 0;
+        }
+    }
+};
+
+class BufferWriter {
+    // The same packing as BitWriter, into a buffer of the caller's instead of
+    // a string, so writing allocates nothing. The caller makes sure the
+    // buffer has room for every byte written.
+
+    unsigned char *out;
+    uint64_t acc;       // Pending bits, right-aligned. Bits above "count" are stale.
+    int count;          // Number of pending bits in acc.
+
+    void drain() {
+        while (count >= 8) {
+            count -= 8;
+            *out++ = (unsigned char) (acc >> count);
+        }
+    }
+
+public:
+    explicit BufferWriter(unsigned char *out) : out(out), acc(0), count(0) {}
+    // MODIFIES: this
+    // EFFECTS: Construct a writer storing whole bytes from out on.
+
+    void put(uint64_t bits, int len) {
+        // REQUIRES: 0 <= len <= 64, and bits has no set bit above len.
+        // MODIFIES: this, the buffer
+        // EFFECTS: Append the low len bits of bits, highest bit first.
+        if (len > 32) {
+            put(bits >> 32, len - 32);
+            bits &= 0xffffffffu;
+            len = 32;
+        }
+        if (count + len > 64) drain();
+        acc = (acc << len) | bits;
+        count += len;
+    }
+
+    unsigned char *flush() {
+        // MODIFIES: this, the buffer
+        // EFFECTS: Write out every pending bit, padding the last byte with
+        //          zeros, and return the end of what was written.
+        drain();
+        if (count > 0) {
+            *out++ = (unsigned char) (acc << (8 - count));
+            count = 0;
+        }
+        return out;
+    }
+};
+
+class BitReader {
+    // Reads bits, most significant bit first, from a byte buffer. Reading past
+    // the end yields zero bits; overrun() reports whether that happened.
+
+    const unsigned char *cur;
+    const unsigned char *end;
+    uint64_t acc;       // Buffered bits, left-aligned.
+    int count;          // Number of valid bits in acc.
+    uint64_t extra;     // Zero bits supplied after the end of the buffer.
+
+public:
+    BitReader(const unsigned char *data, size_t len) :
+            cur(data), end(data + len), acc(0), count(0), extra(0) {}
+    // EFFECTS: Construct a reader over the len bytes starting at data.
+
+    void refill() {
+        // MODIFIES: this
+        // EFFECTS: Load whole bytes until at least 57 bits are buffered.
+        if (end - cur >= 8) {
+            // Fast path: take 8 bytes at once and keep the whole ones that fit
+            uint64_t next = 0;
+            for (int i = 0; i < 8; i++) next = (next << 8) | cur[i];
+            acc |= next >> count;
+            cur += (63 - count) >> 3;
+            count |= 56;
+            return;
+        }
+        while (count <= 56) {
+            if (cur < end) {
+                acc |= uint64_t(*cur++) << (56 - count);
+            } else {
+                extra += 8;
+            }
+            count += 8;
+        }
+    }
+
+    uint32_t peek(int len) {
+        // REQUIRES: 1 <= len <= 32
+        // MODIFIES: this
+        // EFFECTS: Return the next len bits without consuming them.
+        if (count < len) refill();
+        return uint32_t(acc >> (64 - len));
+    }
+
+    void skip(int len) {
+        // REQUIRES: len <= 57 and len bits have been looked at through peek()
+        //           or are otherwise buffered.
+        // MODIFIES: this
+        // EFFECTS: Consume len bits.
+        if (count < len) refill();
+        acc <<= len;
+        count -= len;
+    }
+
+    uint32_t get(int len) {
+        // REQUIRES: 0 <= len <= 32
+        // MODIFIES: this
+        // EFFECTS: Consume and return the next len bits.
+        if (len == 0) return 0;
+        uint32_t v = peek(len);
+        skip(len);
+        return v;
+    }
+
+    bool overrun() const {
+        // EFFECTS: Return true if more bits were consumed than the buffer holds.
+        return uint64_t(count) < extra;
+    }
+};
+
+#endif
@@ -1,82 +1,401 @@
 #include "binaryTree.h"
 #include "huffmanTree.h"
+#include "bitStream.h"
+#include "huffmanFormat.h"
+#include "frameCodec.h"
+#include "workerPool.h"
+#include "nodePool.h"
+#include "packageMerge.h"
+#include "inputFile.h"
+#include "dictionary.h"
+#include "adaptiveHuffman.h"
+#include "contextModel.h"
 #include <fstream>
 #include <iostream>
-#include <queue>
-#include <cassert>
+#include <algorithm>
+#include <vector>
+#include <cstdlib>
 
 using namespace std;
 
-struct NodeCompare {
-    bool operator()(const Node *left, const Node *right) const {
-        if (left->getnum() != right->getnum()) return left->getnum() > right->getnum();
-        return left->getstr() > right->getstr();
-    }
+static const size_t CHUNK_SIZE = 1 << 16;
+
+struct StreamBatch {
+    // Blocks of the input on their way through compressStream()
+    vector<vector<unsigned char> > blocks;  // Copies, unless mapped
+    vector<const unsigned char *> spans;
+    vector<size_t> sizes;
+    vector<string> frames;
+    size_t n;
 };
 
+static int compressStream(InputFile &fin, size_t blockSize, unsigned threads, int maxLen, bool interleave) {
+    // Read the input once, in blocks, and write one frame per block. Blocks
+    // are encoded in batches of two per thread and written back in order. A
+    // pipeline overlaps the three: one thread reads the next batch while the
+    // pool encodes this one and another thread writes the one before. Blocks
+    // of a mapped file are encoded in place, their pages faulted in by the
+    // reader; others are copied out of the read buffer first. The frame index
+    // is collected as frames are written and appended after the end marker.
+    string header(ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC));
+    header.push_back(char(MODE_FRAMED));
+    putLE(header, blockSize, 8);
+    cout.write(header.data(), header.size());
+
+    WorkerPool pool(threads);
+    size_t batch = 2 * size_t(threads);
+    StreamBatch slots[PIPELINE_SLOTS];
+    for (StreamBatch &b : slots) {
+        b.blocks.assign(fin.isMapped() ? 0 : batch, vector<unsigned char>(blockSize));
+        b.spans.resize(batch);
+        b.sizes.resize(batch);
+        b.frames.resize(batch);
+    }
+    vector<FrameIndexEntry> index;
+    uint64_t written = header.size(), rawPos = 0;
+    bool ok = runPipeline([&](int s) {
+        StreamBatch &b = slots[s];
+        for (b.n = 0; b.n < batch; b.n++) {
+            size_t i = b.n;
+            b.spans[i] = fin.read(blockSize, b.sizes[i]);
+            if (b.sizes[i] == 0) break;
+            if (fin.isMapped()) {
+                fin.prefault(b.spans[i], b.sizes[i]);
+            } else {
+                copy(b.spans[i], b.spans[i] + b.sizes[i], b.blocks[i].begin());
+                b.spans[i] = b.blocks[i].data();
+            }
+        }
+        return b.n == batch;
+    }, [&](int s) {
+        StreamBatch &b = slots[s];
+        pool.run(b.n, [&](size_t i) {
+            b.frames[i].clear();
+            encodeFrame(b.spans[i], b.sizes[i], b.frames[i], maxLen, interleave);
+        });
+    }, [&](int s) {
+        const StreamBatch &b = slots[s];
+        for (size_t i = 0; i < b.n; i++) {
+            FrameIndexEntry entry = {written, rawPos};
+            index.push_back(entry);
+            cout.write(b.frames[i].data(), b.frames[i].size());
+            written += b.frames[i].size();
+            rawPos += b.sizes[i];
+        }
+        return bool(cout);
+    });
+    if (!ok) {
+        cerr << "Cannot write the archive" << endl;
+        return 1;
+    }
+    string end;
+    endFrames(end);
+    putFrameIndex(end, index);
+    cout.write(end.data(), end.size());
+    return 0;
+}
+
+static int compressAdaptive(InputFile &fin) {
+    // Code the input in one pass as it arrives. What a read from a pipe or a
+    // terminal returns is coded, flushed to a whole byte and written out at
+    // once, so a live stream is not held back waiting for a block to fill.
+    string out(ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC));
+    out.push_back(char(MODE_ADAPTIVE));
+    putLE(out, 0, 8);
+    cout.write(out.data(), out.size());
+    cout.flush();
+    out.clear();
+    BitWriter writer(out);
+    AdaptiveEncoder encoder(writer);
+    const unsigned char *data;
+    size_t n;
+    while ((data = fin.readSome(CHUNK_SIZE, n)), n > 0) {
+        for (size_t i = 0; i < n; i++) encoder.put(data[i]);
+        if (!fin.isMapped()) encoder.flush();
+        cout.write(out.data(), out.size());
+        out.clear();
+        if (!fin.isMapped()) cout.flush();
+    }
+    encoder.finish();
+    cout.write(out.data(), out.size());
+    return 0;
+}
+
+static int compressOrder1(InputFile &fin, const string &filename, int maxLen) {
+    // Count the pairs of the input, build the codes of each class of
+    // contexts, then read the input again and code each byte with the code
+    // of the byte before it
+    static uint64_t pairs[256][256];
+    unsigned char prev = 0;
+    uint64_t total = 0;
+    const unsigned char *data;
+    size_t n;
+    while ((data = fin.read(CHUNK_SIZE, n)), n > 0) {
+        countPairs(data, n, prev, pairs);
+        total += n;
+    }
+    string out(ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC));
+    out.push_back(char(MODE_ORDER1));
+    putLE(out, total, 8);
+    if (total == 0) {
+        cout.write(out.data(), out.size());
+        return 0;
+    }
+    if (!fin.rewind()) {
+        cerr << "Cannot read " << (filename == "-" ? "standard input" : filename) << " twice; use -stream" << endl;
+        return 1;
+    }
+    ContextModel model;
+    buildContextModel(pairs, maxLen, model);
+    putContextModel(out, model);
+    const HuffmanCode *byContext[256];
+    for (int a = 0; a < 256; a++) byContext[a] = model.codes[model.classOf[a]];
+    BitWriter writer(out);
+    prev = 0;
+    while ((data = fin.read(CHUNK_SIZE, n)), n > 0) {
+        for (size_t i = 0; i < n; i++) {
+            const HuffmanCode &code = byContext[prev][data[i]];
+            writer.put(code.bits, code.len);
+            prev = data[i];
+        }
+        cout.write(out.data(), out.size());
+        out.clear();
+    }
+    writer.flush();
+    cout.write(out.data(), out.size());
+    return 0;
+}
+
+static int trainFiles(const vector<string> &files, int maxLen) {
+    // Count the bytes of the whole corpus and print the dictionary of those
+    // counts
+    uint64_t count[256] = {0};
+    for (const string &file : files) {
+        InputFile fin;
+        if (!fin.open(file)) {
+            cerr << "Cannot open " << file << endl;
+            return 1;
+        }
+        const unsigned char *data;
+        size_t n;
+        while ((data = fin.read(CHUNK_SIZE, n)), n > 0) countBytes(data, n, count);
+    }
+    Dictionary dict;
+    trainDictionary(count, maxLen, dict);
+    string out;
+    putDictionary(out, dict);
+    cout.write(out.data(), out.size());
+    return 0;
+}
+
+static void compressWithDictionary(InputFile &fin, const Dictionary &dict, string &out) {
+    // Append the archive of fin to out; the length in the header is filled in
+    // once the input has been read
+    out.append(ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC));
+    out.push_back(char(MODE_DICTIONARY));
+    size_t totalPos = out.size();
+    putLE(out, 0, 8);
+    putLE(out, dict.id, 4);
+    uint64_t total = 0;
+    BitWriter writer(out);
+    const unsigned char *data;
+    size_t n;
+    while ((data = fin.read(CHUNK_SIZE, n)), n > 0) {
+        for (size_t i = 0; i < n; i++) writer.put(dict.codes[data[i]].bits, dict.codes[data[i]].len);
+        total += n;
+    }
+    writer.flush();
+    string length;
+    putLE(length, total, 8);
+    out.replace(totalPos, 8, length);
+}
+
+static int compressFiles(const string &dictFile, const vector<string> &files) {
+    // One file is written to standard output, as in the other modes; each of
+    // several to <file>.huf. The dictionary is read once for them all.
+    Dictionary dict;
+    if (!readDictionary(dictFile, dict)) {
+        cerr << dictFile << " is not a huffman dictionary" << endl;
+        return 1;
+    }
+    vector<string> inputs = files.empty() ? vector<string>(1, "-") : files;
+    string out;
+    for (const string &file : inputs) {
+        InputFile fin;
+        if (!fin.open(file)) {
+            cerr << "Cannot open " << file << endl;
+            return 1;
+        }
+        out.clear();
+        compressWithDictionary(fin, dict, out);
+        if (inputs.size() == 1) {
+            cout.write(out.data(), out.size());
+            continue;
+        }
+        ofstream fout(file + ".huf", ios::binary);
+        if (!fout.write(out.data(), out.size())) {
+            cerr << "Cannot write " << file << ".huf" << endl;
+            return 1;
+        }
+    }
+    return 0;
+}
 
 int main(int argc, char *argv[]) {
     string filename;
     bool treeFlag = false;
-    if (argc == 2) {
-        filename = argv[1];
-    } else {
-        treeFlag = string(argv[1]) == "-tree";
-        filename = argv[2];
+    bool binaryFlag = false;
+    bool canonicalFlag = false;
+    bool streamFlag = false;
+    bool interleaveFlag = false;
+    bool trainFlag = false;
+    bool adaptiveFlag = false;
+    bool order1Flag = false;
+    string dictFile;
+    vector<string> files;
+    size_t blockSize = DEFAULT_BLOCK_SIZE;
+    unsigned threads = 1;
+    int maxLen = 0;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "-tree") treeFlag = true;
+        else if (arg == "-stream") streamFlag = true;
+        else if (arg == "-interleave") streamFlag = interleaveFlag = true;
+        else if (arg == "-block" && i + 1 < argc) blockSize = strtoul(argv[++i], nullptr, 10);
+        else if (arg == "-j" && i + 1 < argc) {
+            threads = unsigned(max(1L, strtol(argv[++i], nullptr, 10)));
+            streamFlag = true;
+        }
+        else if (arg == "-maxlen" && i + 1 < argc) maxLen = atoi(argv[++i]);
+        else if (arg == "-binary") binaryFlag = true;
+        else if (arg == "-canonical") binaryFlag = canonicalFlag = true;
+        else if (arg == "-train") trainFlag = true;
+        else if (arg == "-adaptive") adaptiveFlag = true;
+        else if (arg == "-order1") order1Flag = true;
+        else if (arg == "-dict" && i + 1 < argc) dictFile = argv[++i];
+        else {
+            filename = arg;
+            files.push_back(arg);
+        }
+    }
+    if (trainFlag || !dictFile.empty()) {
+        if (maxLen < 0 || maxLen > 64) {
+            cerr << "Code length limit must be between 1 and 64" << endl;
+            return 1;
+        }
+        if (trainFlag) return trainFiles(files.empty() ? vector<string>(1, "-") : files, maxLen);
+        return compressFiles(dictFile, files);
     }
-    ifstream fin(filename);
-    int count[128] = {0};
-    char ch;
-    while (fin.get(ch)) {
-        count[ch]++;
+    if (adaptiveFlag) {
+        InputFile fin;
+        if (!fin.open(filename.empty() ? "-" : filename)) {
+            cerr << "Cannot open " << filename << endl;
+            return 1;
+        }
+        return compressAdaptive(fin);
+    }
+    if (order1Flag) {
+        if (maxLen < 0 || maxLen > 64) {
+            cerr << "Code length limit must be between 1 and 64" << endl;
+            return 1;
+        }
+        InputFile fin;
+        if (!fin.open(filename.empty() ? "-" : filename)) {
+            cerr << "Cannot open " << filename << endl;
+            return 1;
+        }
+        return compressOrder1(fin, filename.empty() ? "-" : filename, maxLen);
+    }
+    if (streamFlag) {
+        if (blockSize == 0 || blockSize >= (1UL << 32)) {
+            cerr << "Block size must be between 1 and 2^32 - 1" << endl;
+            return 1;
+        }
+        InputFile fin;
+        if (!fin.open(filename.empty() ? "-" : filename)) {
+            cerr << "Cannot open " << filename << endl;
+            return 1;
+        }
+        return compressStream(fin, blockSize, threads, maxLen, interleaveFlag);
     }
 
-    typedef pair<int, Node *> Pair;
-    priority_queue<Node *, vector<Node *>, NodeCompare> pq;
+    // A file that cannot be opened reads as empty, as it always has
+    InputFile fin;
+    fin.open(filename);
+    uint64_t count[256] = {0};
+    const unsigned char *data;
+    size_t n;
+    while ((data = fin.read(CHUNK_SIZE, n)), n > 0) countBytes(data, n, count);
 
-    for (int i = 0; i < 128; i++) {
-        if (count[i] > 0) {
-            string str;
-            str += char(i);
-            pq.push(new Node(str, count[i], nullptr, nullptr));
+    NodePool pool(count);
+    if (pool.empty()) {
+        // Empty input: nothing to encode
+        if (binaryFlag) {
+            string header(ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC));
+            header.push_back(char(canonicalFlag ? MODE_CANONICAL : MODE_TREE));
+            putLE(header, 0, 8);
+            cout.write(header.data(), header.size());
         }
+        return 0;
     }
 
-    while (pq.size() > 1) {
-        auto right = pq.top();
-        pq.pop();
-        auto left = pq.top();
-        pq.pop();
-        pq.push(Node::mergeNodes(left, right));
+    if (maxLen < 0 || maxLen > 64) {
+        cerr << "Code length limit must be between 1 and 64" << endl;
+        return 1;
     }
+    HuffmanCode codes[256];
+    pool.getCodes(codes);
+    bool limited = limitCodes(count, maxLen, codes);
 
-    HuffmanTree huffmanTree(pq.top());
     if (treeFlag) {
+        HuffmanTree huffmanTree(limited ? treeFromCodes(codes, count) : pool.toNode());
         huffmanTree.printTree();
-        fin.close();
         return 0;
     }
 
-    string coding[128];
-    for (int i = 0; i < 128; i++) {
-        if (count[i] > 0) {
-            string str;
-            str += char(i);
-            coding[i] = huffmanTree.findPath(str);
-            if (coding[i] == "-1") {
-                assert(0);
-            }
+//    ofstream fout("binary.txt");
+//    cout.rdbuf(fout.rdbuf());
+    if (!fin.rewind()) {
+        cerr << "Cannot read " << (filename == "-" ? "standard input" : filename) << " twice; use -stream" << endl;
+        return 1;
+    }
+    if (binaryFlag) {
+        uint64_t total = 0;
+        for (int i = 0; i < 256; i++) total += count[i];
+        string out(ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC));
+        out.push_back(char(canonicalFlag ? MODE_CANONICAL : MODE_TREE));
+        putLE(out, total, 8);
+        if (canonicalFlag) {
+            int lens[256];
+            codeLengths(codes, lens);
+            putCodeLengths(out, lens);
+            canonicalCodes(lens, codes);
+        }
+        BitWriter writer(out);
+        if (!canonicalFlag && limited) HuffmanTree(treeFromCodes(codes, count)).writeTree(writer);
+        else if (!canonicalFlag) pool.writeTree(writer);
+        while ((data = fin.read(CHUNK_SIZE, n)), n > 0) {
+            for (size_t i = 0; i < n; i++) writer.put(codes[data[i]].bits, codes[data[i]].len);
+            cout.write(out.data(), out.size());
+            out.clear();
         }
+        writer.flush();
+        cout.write(out.data(), out.size());
+        return 0;
     }
 
-//    ofstream fout("binary.txt");
-//    cout.rdbuf(fout.rdbuf());
-    fin.clear();
-    fin.seekg(0);
-    while (fin.get(ch)) {
-        cout << coding[ch] << " ";
+    // ASCII output: each code as '0'/'1' characters followed by a space
+    string coding[256];
+    for (int i = 0; i < 256; i++) {
+        for (int b = codes[i].len - 1; b >= 0; b--) coding[i].push_back((codes[i].bits >> b) & 1 ? '1' : '0');
+        coding[i].push_back(' ');
+    }
+    string out;
+    while ((data = fin.read(CHUNK_SIZE, n)), n > 0) {
+        for (size_t i = 0; i < n; i++) out += coding[data[i]];
+        cout.write(out.data(), out.size());
+        out.clear();
     }
     cout << endl;
-    fin.close();
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,149 @@
+#include "contextModel.h"
+#include "huffmanFormat.h"
+#include "nodePool.h"
+#include "packageMerge.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+static const int CLUSTER_ROUNDS = 10;
+
+void countPairs(const unsigned char *data, size_t n, unsigned char &prev, uint64_t pairs[256][256]) {
+    unsigned char a = prev;
+    for (size_t i = 0; i < n; i++) {
+        pairs[a][data[i]]++;
+        a = data[i];
+    }
+    prev = a;
+}
+
+static void costhelper(const vector<uint64_t> &count, double cost[256]) {
+    // Ideal code lengths, in bits, of a class with the given counts. Every
+    // character gets half a count more, so that a context moved into the
+    // class pays for the characters the class has not seen rather than
+    // making them free.
+    double total = 0;
+    for (int b = 0; b < 256; b++) total += double(count[b]) + 0.5;
+    for (int b = 0; b < 256; b++) cost[b] = log2(total / (double(count[b]) + 0.5));
+}
+
+void buildContextModel(const uint64_t pairs[256][256], int maxLen, ContextModel &model) {
+    uint64_t weight[256];
+    int used[256], usedNum = 0;
+    for (int a = 0; a < 256; a++) {
+        weight[a] = 0;
+        for (int b = 0; b < 256; b++) weight[a] += pairs[a][b];
+        if (weight[a]) used[usedNum++] = a;
+    }
+
+    // Start from the heaviest contexts, one per class; with no more contexts
+    // than classes every context keeps its own code
+    sort(used, used + usedNum, [&](int x, int y) { return weight[x] > weight[y] || (weight[x] == weight[y] && x < y); });
+    int k = min(usedNum, CONTEXT_CLASSES);
+    int classOf[256];
+    for (int a = 0; a < 256; a++) classOf[a] = 0;
+    for (int i = 0; i < usedNum; i++) classOf[used[i]] = i < k ? i : -1;
+
+    vector<vector<uint64_t> > count(k, vector<uint64_t>(256));
+    double cost[CONTEXT_CLASSES][256];
+    for (int round = 0; round < CLUSTER_ROUNDS && usedNum > k; round++) {
+        for (int c = 0; c < k; c++) fill(count[c].begin(), count[c].end(), 0);
+        for (int i = 0; i < usedNum; i++) {
+            int a = used[i];
+            if (classOf[a] < 0) continue;
+            for (int b = 0; b < 256; b++) count[classOf[a]][b] += pairs[a][b];
+        }
+        for (int c = 0; c < k; c++) costhelper(count[c], cost[c]);
+
+        // Move every context to the class that codes its pairs in the fewest
+        // bits
+        bool moved = false;
+        for (int i = 0; i < usedNum; i++) {
+            int a = used[i], best = 0;
+            double bestBits = 0;
+            for (int c = 0; c < k; c++) {
+                double bits = 0;
+                for (int b = 0; b < 256; b++) {
+                    if (pairs[a][b]) bits += double(pairs[a][b]) * cost[c][b];
+                }
+                if (c == 0 || bits < bestBits) {
+                    best = c;
+                    bestBits = bits;
+                }
+            }
+            if (best != classOf[a]) {
+                classOf[a] = best;
+                moved = true;
+            }
+        }
+        if (!moved) break;
+    }
+
+    // Drop the classes left empty and give each of the others its code.
+    // Contexts that never occur share class 0.
+    for (int c = 0; c < k; c++) fill(count[c].begin(), count[c].end(), 0);
+    for (int i = 0; i < usedNum; i++) {
+        int a = used[i];
+        for (int b = 0; b < 256; b++) count[classOf[a]][b] += pairs[a][b];
+    }
+    int rename[CONTEXT_CLASSES];
+    model.classNum = 0;
+    for (int c = 0; c < k; c++) {
+        bool empty = true;
+        for (int b = 0; b < 256 && empty; b++) empty = count[c][b] == 0;
+        rename[c] = empty ? -1 : model.classNum;
+        if (empty) continue;
+        int n = model.classNum++;
+        NodePool pool(count[c].data());
+        pool.getCodes(model.codes[n]);
+        limitCodes(count[c].data(), maxLen, model.codes[n]);
+        codeLengths(model.codes[n], model.lens[n]);
+        canonicalCodes(model.lens[n], model.codes[n]);
+    }
+    for (int a = 0; a < 256; a++) model.classOf[a] = (unsigned char) (weight[a] ? rename[classOf[a]] : 0);
+}
+
+void putContextModel(string &out, const ContextModel &model) {
+    out.push_back(char(model.classNum - 1));
+    out.append((const char *) model.classOf, 256);
+    for (int c = 0; c < model.classNum; c++) putCodeLengths(out, model.lens[c]);
+}
+
+size_t getContextModel(const unsigned char *p, size_t avail, ContextModel &model) {
+    if (avail < 1 + 256) return 0;
+    model.classNum = p[0] + 1;
+    if (model.classNum > CONTEXT_CLASSES) return 0;
+    for (int a = 0; a < 256; a++) {
+        model.classOf[a] = p[1 + a];
+        if (model.classOf[a] >= model.classNum) return 0;
+    }
+    size_t pos = 1 + 256;
+    for (int c = 0; c < model.classNum; c++) {
+        size_t used = getCodeLengths(p + pos, avail - pos, model.lens[c]);
+        if (!used) return 0;
+        pos += used;
+        canonicalCodes(model.lens[c], model.codes[c]);
+    }
+    return pos;
+}
+
+ContextDecoder::ContextDecoder(const ContextModel &model) : prev(0) {
+    copy(model.classOf, model.classOf + 256, classOf);
+    for (int c = 0; c < model.classNum; c++) tables.emplace_back(new DecodeTable(model.codes[c]));
+}
+
+size_t ContextDecoder::decode(BitReader &in, unsigned char *out, size_t n) {
+    // Each character picks the table of the next, so the tables are probed
+    // one character at a time
+    const DecodeTable *byContext[256];
+    for (int a = 0; a < 256; a++) byContext[a] = tables[classOf[a]].get();
+    size_t i = 0;
+    for (; i < n; i++) {
+        int c = byContext[prev]->decodeOne(in);
+        if (c < 0 || in.overrun()) break;
+        out[i] = (unsigned char) c;
+        prev = (unsigned char) c;
+    }
+    return i;
+}
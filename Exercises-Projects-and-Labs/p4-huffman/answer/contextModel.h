@@ -0,0 +1,74 @@
+#ifndef P4_CONTEXTMODEL_H
+#define P4_CONTEXTMODEL_H
+
+#include "bitStream.h"
+#include "decodeTable.h"
+#include "huffmanTree.h"
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+// An order-1 archive ("-order1") codes each byte with a Huffman code chosen
+// by the byte before it; the first byte is coded as if it followed a 0. The
+// 256 preceding bytes, the contexts, are clustered into at most
+// CONTEXT_CLASSES classes of one code each, to bound the size of the tables.
+// After the archive header come:
+//
+//   1 byte        number of classes - 1
+//   256 bytes     class of each context
+//   ...           code-length table of each class (see putCodeLengths())
+//
+// and the bitstream of canonical codes, as in the canonical mode.
+
+const int CONTEXT_CLASSES = 16;
+
+struct ContextModel {
+    int classNum;
+    unsigned char classOf[256];         // The class of each context
+    int lens[CONTEXT_CLASSES][256];     // Code lengths of each class
+    HuffmanCode codes[CONTEXT_CLASSES][256];
+};
+
+void countPairs(const unsigned char *data, size_t n, unsigned char &prev, uint64_t pairs[256][256]);
+// MODIFIES: prev, pairs
+// EFFECTS: Adds to pairs[a][b] the number of times b follows a among the n
+//          bytes at data, the first of them following prev, and sets prev to
+//          the last byte.
+
+void buildContextModel(const uint64_t pairs[256][256], int maxLen, ContextModel &model);
+// REQUIRES: some pair was counted, 0 <= maxLen <= 64
+// MODIFIES: model
+// EFFECTS: Clusters the contexts by the bytes that follow them, with a few
+//          rounds of k-means that move each context to the class whose code
+//          would code it in the fewest bits, and gives each class the
+//          Huffman code of its pairs, of at most maxLen bits if maxLen > 0.
+
+void putContextModel(std::string &out, const ContextModel &model);
+// MODIFIES: out
+// EFFECTS: Appends the classes and code-length tables of model to out.
+
+size_t getContextModel(const unsigned char *p, size_t avail, ContextModel &model);
+// MODIFIES: model
+// EFFECTS: Reads what putContextModel() wrote from the "avail" bytes at p
+//          and returns its size, or 0 if it is truncated or invalid.
+
+class ContextDecoder {
+    // Decodes the bitstream of an order-1 archive with one DecodeTable per
+    // class, one character per table probe.
+
+    unsigned char classOf[256];
+    std::vector<std::unique_ptr<DecodeTable> > tables;
+    unsigned char prev;
+
+public:
+    explicit ContextDecoder(const ContextModel &model);
+
+    size_t decode(BitReader &in, unsigned char *out, size_t n);
+    // MODIFIES: this, in, out
+    // EFFECTS: Same as DecodeTable::decode(), carrying the context from one
+    //          call to the next.
+};
+
+#endif
@@ -0,0 +1,158 @@
+#include "decodeTable.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace std;
+
+const int DecodeTable::PRIMARY_BITS;
+const int DecodeTable::SECONDARY_BITS;
+
+int DecodeTable::addTrieNode() {
+    TrieNode n;
+    n.child[0] = n.child[1] = -1;
+    n.sym = -1;
+    n.height = 0;
+    trie.push_back(n);
+    return int(trie.size()) - 1;
+}
+
+int DecodeTable::computeHeight(int t) {
+    int h = 0;
+    for (int b = 0; b < 2; b++) {
+        if (trie[t].child[b] >= 0) h = max(h, 1 + computeHeight(trie[t].child[b]));
+    }
+    trie[t].height = h;
+    return h;
+}
+
+DecodeTable::DecodeTable() : single(-1) {}
+
+DecodeTable::DecodeTable(const HuffmanCode codes[256]) : single(-1) {
+    reset(codes);
+}
+
+void DecodeTable::reset(const HuffmanCode codes[256]) {
+    trie.clear();
+    table.clear();
+    single = -1;
+    addTrieNode();
+    int present = 0;
+    for (int c = 0; c < 256; c++) {
+        if (codes[c].len < 0) continue;
+        present++;
+        int t = 0;
+        for (int b = codes[c].len - 1; b >= 0; b--) {
+            int bit = int((codes[c].bits >> b) & 1);
+            if (trie[t].child[bit] < 0) {
+                int n = addTrieNode();
+                trie[t].child[bit] = n;
+            }
+            t = trie[t].child[bit];
+        }
+        trie[t].sym = c;
+    }
+    if (present == 1 && trie[0].sym >= 0) single = trie[0].sym;
+    computeHeight(0);
+    table.resize(size_t(1) << PRIMARY_BITS);
+    fillTable(0, 0, PRIMARY_BITS, true);
+}
+
+void DecodeTable::fillTable(size_t start, int t, int width, bool multi) {
+    // Fill the 2^width entries at "start" for codes continuing below trie node t
+    for (uint32_t i = 0; i < (1u << width); i++) {
+        Entry e;
+        memset(&e, 0, sizeof(e));
+        int node = t;
+        int used = 0;
+        for (int b = width - 1; b >= 0; b--) {
+            node = trie[node].child[(i >> b) & 1];
+            used++;
+            if (node < 0) break;
+            if (trie[node].sym >= 0) {
+                e.sym[e.count] = uint8_t(trie[node].sym);
+                e.bits[e.count] = uint8_t(used);
+                e.count++;
+                if (!multi || e.count == 3) break;
+                node = 0;
+            }
+        }
+        if (e.count == 0 && node >= 0) {
+            // Every bit ended inside one long code: continue in a new table
+            int subWidth = min(SECONDARY_BITS, trie[node].height);
+            e.sub = uint32_t(table.size());
+            e.bits[0] = uint8_t(subWidth);
+            table[start + i] = e;
+            table.resize(table.size() + (size_t(1) << subWidth));
+            fillTable(e.sub, node, subWidth, false);
+        } else {
+            table[start + i] = e;
+        }
+    }
+}
+
+int DecodeTable::slowStep(BitReader &in, unsigned char *out, size_t room) const {
+    // The cases step() leaves out: little room, or a code longer than the
+    // primary table
+    const Entry *e = &table[in.peek(PRIMARY_BITS)];
+    if (e->count) {
+        size_t k = e->count;
+        if (k > room) k = room;
+        for (size_t j = 0; j < k; j++) out[j] = e->sym[j];
+        in.skip(e->bits[k - 1]);
+        return int(k);
+    }
+    int width = PRIMARY_BITS;
+    while (e->count == 0) {
+        if (e->bits[0] == 0) return 0;
+        in.skip(width);
+        width = e->bits[0];
+        e = &table[e->sub + in.peek(width)];
+    }
+    out[0] = e->sym[0];
+    in.skip(e->bits[0]);
+    return 1;
+}
+
+size_t DecodeTable::decode(BitReader &in, unsigned char *out, size_t n) const {
+    if (single >= 0) {
+        memset(out, single, n);
+        return n;
+    }
+    size_t done = 0;
+    while (done < n) {
+        int k = step(in, out + done, n - done);
+        if (k == 0 || in.overrun()) return done;
+        done += size_t(k);
+    }
+    return done;
+}
+
+bool DecodeTable::decode4(BitReader in[4], unsigned char *const out[4], const size_t n[4]) const {
+    if (single >= 0) {
+        for (int s = 0; s < 4; s++) memset(out[s], single, n[s]);
+        return true;
+    }
+    // While every stream has room for a full probe, advance the four chains
+    // in turn; they do not depend on each other, so their table lookups and
+    // shifts overlap. Each stream then finishes on its own.
+    size_t done[4] = {0, 0, 0, 0};
+    bool ok = true;
+    while (ok && n[0] - done[0] >= 3 && n[1] - done[1] >= 3 && n[2] - done[2] >= 3 && n[3] - done[3] >= 3) {
+        int k0 = step(in[0], out[0] + done[0], 3);
+        int k1 = step(in[1], out[1] + done[1], 3);
+        int k2 = step(in[2], out[2] + done[2], 3);
+        int k3 = step(in[3], out[3] + done[3], 3);
+        done[0] += size_t(k0);
+        done[1] += size_t(k1);
+        done[2] += size_t(k2);
+        done[3] += size_t(k3);
+        ok = k0 && k1 && k2 && k3;
+    }
+    if (!ok) return false;
+    for (int s = 0; s < 4; s++) {
+        if (in[s].overrun()) return false;
+        size_t rest = n[s] - done[s];
+        if (decode(in[s], out[s] + done[s], rest) != rest) return false;
+    }
+    return true;
+}
@@ -0,0 +1,106 @@
+#ifndef P4_DECODETABLE_H
+#define P4_DECODETABLE_H
+
+#include "bitStream.h"
+#include "huffmanTree.h"
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+class DecodeTable {
+    // A flat lookup table decoding a packed bitstream several bits at a time.
+    //
+    // The primary table is indexed by the next PRIMARY_BITS bits of input and
+    // yields up to 3 whole characters per probe. Codes longer than
+    // PRIMARY_BITS continue in secondary tables of up to SECONDARY_BITS bits,
+    // chained as deep as the longest code requires.
+
+    struct Entry {
+        uint32_t sub;       // First entry of the next table, if count == 0
+        uint8_t sym[3];     // Decoded characters
+        uint8_t count;      // Number of characters in sym; 0 for a link
+        uint8_t bits[3];    // bits[k]: bits consumed by the first k+1 characters.
+                            // For a link, bits[0] is the next table's index
+                            // width, or 0 if no code starts with these bits.
+        uint8_t pad;
+    };
+
+    struct TrieNode {
+        int child[2];       // -1 if absent
+        int sym;            // -1 for an internal node
+        int height;         // Length of the longest path below this node
+    };
+
+    std::vector<Entry> table;
+    std::vector<TrieNode> trie;
+    int single;             // The only character, if the code has just one
+
+    int addTrieNode();
+    int computeHeight(int t);
+    void fillTable(size_t start, int t, int width, bool multi);
+    int slowStep(BitReader &in, unsigned char *out, size_t room) const;
+
+    int step(BitReader &in, unsigned char *out, size_t room) const {
+        // Decode what one probe of the primary table yields, at most room
+        // characters, and return how many; 0 if the bits are not a code
+        const Entry &e = table[in.peek(PRIMARY_BITS)];
+        if (e.count && room >= 3) {
+            // Copy all three characters whether or not they are used, so the
+            // common case does not branch on how many the entry holds
+            out[0] = e.sym[0];
+            out[1] = e.sym[1];
+            out[2] = e.sym[2];
+            in.skip(e.bits[e.count - 1]);
+            return e.count;
+        }
+        return slowStep(in, out, room);
+    }
+
+public:
+    static const int PRIMARY_BITS = 10;
+    static const int SECONDARY_BITS = 8;
+
+    DecodeTable();
+    // EFFECTS: Constructs an empty table, to be filled by reset() before it
+    //          decodes anything.
+
+    explicit DecodeTable(const HuffmanCode codes[256]);
+    // REQUIRES: The codes form a prefix code, as produced by
+    //           HuffmanTree::getCodes().
+    // EFFECTS: Builds the lookup tables for the given codes.
+
+    void reset(const HuffmanCode codes[256]);
+    // REQUIRES: As for DecodeTable(codes).
+    // MODIFIES: this
+    // EFFECTS: Rebuilds the lookup tables for the given codes, reusing the
+    //          memory of the ones before, so a table kept from one frame to
+    //          the next allocates only when a deeper code needs more.
+
+    size_t decode(BitReader &in, unsigned char *out, size_t n) const;
+    // MODIFIES: in, out
+    // EFFECTS: Decodes up to n characters from in into out and returns the
+    //          number decoded. Returns fewer than n only if the input contains
+    //          a bit sequence that is not a code or runs out of bits.
+
+    int decodeOne(BitReader &in) const {
+        // MODIFIES: in
+        // EFFECTS: Decodes one character and returns it, or -1 if the bits
+        //          are not a code. For codes that change between characters.
+        if (single >= 0) return single;
+        const Entry &e = table[in.peek(PRIMARY_BITS)];
+        if (e.count) {
+            in.skip(e.bits[0]);
+            return e.sym[0];
+        }
+        unsigned char c;
+        return slowStep(in, &c, 1) ? c : -1;
+    }
+
+    bool decode4(BitReader in[4], unsigned char *const out[4], const size_t n[4]) const;
+    // MODIFIES: in, out
+    // EFFECTS: Decodes n[s] characters from in[s] into out[s] for each of the
+    //          four streams, interleaving the streams' decode chains. Returns
+    //          false if any stream is corrupt or runs out of bits.
+};
+
+#endif
@@ -1,9 +1,22 @@
 #include "binaryTree.h"
 #include "huffmanTree.h"
+#include "bitStream.h"
+#include "huffmanFormat.h"
+#include "decodeTable.h"
+#include "frameCodec.h"
+#include "workerPool.h"
+#include "inputFile.h"
+#include "dictionary.h"
+#include "adaptiveHuffman.h"
+#include "contextModel.h"
 
 #include <fstream>
 #include <iostream>
 #include <unordered_map>
+#include <memory>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
 #include <cassert>
 
 using namespace std;
@@ -25,7 +38,285 @@ char decode(const string &code, const Node *node, unordered_map<string, char> &d
     return result;
 }
 
+static int corrupt(const string &archiveFile) {
+    cerr << archiveFile << " is truncated or corrupt" << endl;
+    return 1;
+}
+
+struct Range {
+    uint64_t offset;        // First original byte to write
+    uint64_t end;           // One past the last
+};
+
+static void writeRange(const unsigned char *data, uint64_t start, size_t n, const Range &range) {
+    // Write the part of the n original bytes at data, the first of which is
+    // byte "start", that falls inside range
+    uint64_t lo = max(start, range.offset), hi = min(start + n, range.end);
+    if (lo < hi) cout.write((const char *) data + (lo - start), streamsize(hi - lo));
+}
+
+struct FrameBatch {
+    // Frames on their way through decompressFrames()
+    vector<FrameInfo> infos;
+    vector<const unsigned char *> payloads;
+    vector<uint64_t> starts;                // Original offset of each frame
+    vector<vector<unsigned char> > copies;  // Payloads, unless mapped
+    vector<vector<unsigned char> > raws;
+    vector<char> ok;
+    size_t n;
+};
+
+static int decompressFrames(InputFile &fin, const string &archiveFile, unsigned threads, const Range &range) {
+    // Decode the frames of a "compress -stream" archive. The headers of a
+    // batch of frames (two per thread) are read first; this index then lets
+    // the frames be decoded concurrently and written back in order. As in
+    // compressStream(), a pipeline reads the next batch and writes the one
+    // before while this one is decoded. Payloads of a mapped archive are
+    // decoded in place.
+    //
+    // Only frames overlapping the range are decoded. A mapped archive with a
+    // frame index starts at the frame holding range.offset; otherwise the
+    // frames before it are read but not decoded.
+    uint64_t rawPos = 0;    // Original offset of the next frame
+    if (range.offset > 0 && fin.isMapped()) {
+        vector<FrameIndexEntry> index;
+        if (getFrameIndex(fin.data(), fin.size(), index) && !index.empty()) {
+            size_t k = size_t(upper_bound(index.begin(), index.end(), range.offset,
+                                          [](uint64_t v, const FrameIndexEntry &e) { return v < e.rawOffset; })
+                              - index.begin());
+            if (k > 0) {
+                if (!fin.seek(size_t(index[k - 1].frameOffset))) return corrupt(archiveFile);
+                rawPos = index[k - 1].rawOffset;
+            }
+        }
+    }
+    WorkerPool pool(threads);
+    size_t batch = 2 * size_t(threads);
+    FrameBatch slots[PIPELINE_SLOTS];
+    for (FrameBatch &b : slots) {
+        b.infos.resize(batch);
+        b.payloads.resize(batch);
+        b.starts.resize(batch);
+        b.copies.resize(batch);
+        b.raws.resize(batch);
+        b.ok.resize(batch);
+    }
+    bool truncated = false, corrupted = false;
+    bool written = runPipeline([&](int s) {
+        FrameBatch &b = slots[s];
+        b.n = 0;
+        while (b.n < batch) {
+            if (rawPos >= range.end) return false;
+            size_t i = b.n;
+            if (!readFrameInfo(fin, b.infos[i])) {
+                truncated = true;
+                return false;
+            }
+            if (b.infos[i].rawSize == 0) return false;
+            size_t got;
+            b.payloads[i] = fin.read(b.infos[i].payloadSize, got);
+            if (got != b.infos[i].payloadSize) {
+                truncated = true;
+                return false;
+            }
+            b.starts[i] = rawPos;
+            rawPos += b.infos[i].rawSize;
+            if (rawPos <= range.offset) continue;
+            if (fin.isMapped()) {
+                fin.prefault(b.payloads[i], got);
+            } else {
+                b.copies[i].assign(b.payloads[i], b.payloads[i] + got);
+                b.payloads[i] = b.copies[i].data();
+            }
+            b.n++;
+        }
+        return true;
+    }, [&](int s) {
+        FrameBatch &b = slots[s];
+        pool.run(b.n, [&](size_t i) {
+            b.raws[i].resize(b.infos[i].rawSize);
+            b.ok[i] = decodeFrame(b.infos[i], b.payloads[i], b.raws[i].data());
+        });
+    }, [&](int s) {
+        const FrameBatch &b = slots[s];
+        for (size_t i = 0; i < b.n; i++) {
+            if (!b.ok[i]) {
+                corrupted = true;
+                return false;
+            }
+            writeRange(b.raws[i].data(), b.starts[i], b.raws[i].size(), range);
+        }
+        return true;
+    });
+    if (!written || truncated || corrupted) return corrupt(archiveFile);
+    return 0;
+}
+
+static int decompressAdaptive(InputFile &fin, const string &archiveFile, const Range &range) {
+    // Decode an archive of "compress -adaptive" as it arrives: what each read
+    // returns is decoded and written out at once. The archive ends with its
+    // end code, not after a length.
+    AdaptiveDecoder decoder;
+    string out;
+    uint64_t done = 0;
+    while (done < range.end) {
+        size_t got, used;
+        const unsigned char *data = fin.readSome(1 << 16, got);
+        if (got == 0) return corrupt(archiveFile);
+        out.clear();
+        AdaptiveDecoder::Status status = decoder.feed(data, got, out, used);
+        if (status == AdaptiveDecoder::DECODE_CORRUPT) return corrupt(archiveFile);
+        writeRange((const unsigned char *) out.data(), done, out.size(), range);
+        done += out.size();
+        if (!fin.isMapped()) cout.flush();
+        if (status == AdaptiveDecoder::DECODE_END) break;
+    }
+    return 0;
+}
+
+struct SharedDictionary {
+    Dictionary dict;
+    DecodeTable table;      // Built once for every archive of the process
+
+    explicit SharedDictionary(const Dictionary &d) : dict(d), table(d.codes) {}
+};
+
+static int decompressArchive(InputFile &fin, const string &archiveFile, unsigned threads, const Range &range,
+                             const SharedDictionary *shared) {
+    // Decode the range of original bytes from an archive written by
+    // "compress -binary", "-canonical", "-dict", "-stream", "-adaptive" or
+    // "-order1".
+    // Only "-stream" archives have frames; the others are decoded from the
+    // start up to the end of the range. A "-dict" archive needs the shared
+    // dictionary of its id.
+    size_t got;
+    const unsigned char *header = fin.read(ARCHIVE_HEADER_SIZE, got);
+    if (got != ARCHIVE_HEADER_SIZE || !equal(header, header + 4, ARCHIVE_MAGIC)
+        || (header[4] != MODE_TREE && header[4] != MODE_CANONICAL && header[4] != MODE_FRAMED
+            && header[4] != MODE_DICTIONARY && header[4] != MODE_ADAPTIVE && header[4] != MODE_ORDER1)) {
+        cerr << archiveFile << " is not a huffman archive" << endl;
+        return 1;
+    }
+    if (header[4] == MODE_FRAMED) return decompressFrames(fin, archiveFile, threads, range);
+    if (header[4] == MODE_ADAPTIVE) return decompressAdaptive(fin, archiveFile, range);
+    int mode = header[4];
+    if (mode == MODE_DICTIONARY) {
+        const unsigned char *id = fin.read(4, got);
+        if (got != 4) return corrupt(archiveFile);
+        if (!shared || shared->dict.id != uint32_t(getLE(id, 4))) {
+            cerr << archiveFile << " needs its dictionary; pass it with -dict" << endl;
+            return 1;
+        }
+    }
+    uint64_t total = min(getLE(header + 5, 8), range.end);
+    if (total <= range.offset) return 0;
+
+    // The bitstream is decoded from one span: the rest of a mapped archive,
+    // or a copy of everything left on a pipe
+    const unsigned char *data;
+    size_t size;
+    vector<unsigned char> archive;
+    if (fin.isMapped()) {
+        data = fin.read(fin.size(), size);
+    } else {
+        const unsigned char *chunk;
+        while ((chunk = fin.read(1 << 16, got)), got > 0) archive.insert(archive.end(), chunk, chunk + got);
+        data = archive.data();
+        size = archive.size();
+    }
+    size_t pos = 0;
+    HuffmanCode codes[256];
+    if (mode == MODE_CANONICAL) {
+        int lens[256];
+        size_t used = getCodeLengths(data, size, lens);
+        if (!used) return corrupt(archiveFile);
+        pos += used;
+        canonicalCodes(lens, codes);
+    }
+    unique_ptr<ContextDecoder> context;
+    if (mode == MODE_ORDER1) {
+        ContextModel model;
+        size_t used = getContextModel(data, size, model);
+        if (!used) return corrupt(archiveFile);
+        pos += used;
+        context.reset(new ContextDecoder(model));
+    }
+    BitReader in(data + pos, size - pos);
+    if (mode == MODE_TREE) {
+        HuffmanTree huffmanTree(in);
+        if (in.overrun()) return corrupt(archiveFile);
+        huffmanTree.getCodes(codes);
+    }
+    unique_ptr<DecodeTable> own;
+    if (mode != MODE_DICTIONARY && mode != MODE_ORDER1) own.reset(new DecodeTable(codes));
+    const DecodeTable *table = own ? own.get() : mode == MODE_DICTIONARY ? &shared->table : nullptr;
+    vector<unsigned char> out(1 << 16);
+    uint64_t done = 0;
+    while (done < total) {
+        size_t want = total - done < out.size() ? size_t(total - done) : out.size();
+        size_t got = context ? context->decode(in, out.data(), want) : table->decode(in, out.data(), want);
+        writeRange(out.data(), done, got, range);
+        if (got != want) return corrupt(archiveFile);
+        done += got;
+    }
+    return 0;
+}
+
 int main(int argc, char *argv[]) {
+    if (argc >= 2 && string(argv[1]) == "-binary") {
+        vector<string> archiveFiles;
+        string dictFile;
+        unsigned threads = 1;
+        Range range = {0, UINT64_MAX};
+        uint64_t length = UINT64_MAX;
+        for (int i = 2; i < argc; i++) {
+            string arg = argv[i];
+            if (arg == "-j" && i + 1 < argc) threads = unsigned(max(1L, strtol(argv[++i], nullptr, 10)));
+            else if ((arg == "-offset" || arg == "--offset") && i + 1 < argc) range.offset = strtoull(argv[++i], nullptr, 10);
+            else if ((arg == "-length" || arg == "--length") && i + 1 < argc) length = strtoull(argv[++i], nullptr, 10);
+            else if (arg == "-dict" && i + 1 < argc) dictFile = argv[++i];
+            else archiveFiles.push_back(arg);
+        }
+        range.end = length > UINT64_MAX - range.offset ? UINT64_MAX : range.offset + length;
+        unique_ptr<SharedDictionary> shared;
+        if (!dictFile.empty()) {
+            Dictionary dict;
+            if (!readDictionary(dictFile, dict)) {
+                cerr << dictFile << " is not a huffman dictionary" << endl;
+                return 1;
+            }
+            shared.reset(new SharedDictionary(dict));
+        }
+        // One archive is written to standard output; each of several to its
+        // name without ".huf", or with ".out" added if it has none
+        if (archiveFiles.empty()) archiveFiles.push_back("-");
+        for (const string &archiveFile : archiveFiles) {
+            InputFile fin;
+            if (!fin.open(archiveFile)) {
+                cerr << "Cannot open " << archiveFile << endl;
+                return 1;
+            }
+            ofstream fout;
+            streambuf *console = cout.rdbuf();
+            if (archiveFiles.size() > 1) {
+                size_t n = archiveFile.size();
+                bool huf = n > 4 && archiveFile.compare(n - 4, 4, ".huf") == 0;
+                string outFile = huf ? archiveFile.substr(0, n - 4) : archiveFile + ".out";
+                fout.open(outFile, ios::binary);
+                if (!fout) {
+                    cerr << "Cannot write " << outFile << endl;
+                    return 1;
+                }
+                cout.rdbuf(fout.rdbuf());
+            }
+            int status = decompressArchive(fin, archiveFile == "-" ? "standard input" : archiveFile, threads,
+                                           range, shared.get());
+            cout.flush();
+            cout.rdbuf(console);
+            if (status != 0) return status;
+        }
+        return 0;
+    }
     string treeFile = argv[1];
     string binaryFile = argv[2];
 
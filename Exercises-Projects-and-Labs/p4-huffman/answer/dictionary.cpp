@@ -0,0 +1,57 @@
+#include "dictionary.h"
+#include "huffmanFormat.h"
+#include "inputFile.h"
+#include "nodePool.h"
+#include "packageMerge.h"
+#include <algorithm>
+
+using namespace std;
+
+uint32_t dictionaryId(const int lens[256]) {
+    // FNV-1a over the lengths
+    uint32_t h = 2166136261u;
+    for (int c = 0; c < 256; c++) {
+        h ^= uint32_t(lens[c]);
+        h *= 16777619u;
+    }
+    return h;
+}
+
+void trainDictionary(const uint64_t count[256], int maxLen, Dictionary &dict) {
+    uint64_t smoothed[256];
+    for (int c = 0; c < 256; c++) smoothed[c] = count[c] < UINT64_MAX ? count[c] + 1 : count[c];
+
+    NodePool pool(smoothed);
+    pool.getCodes(dict.codes);
+    limitCodes(smoothed, maxLen > 0 ? maxLen : DICTIONARY_MAX_LEN, dict.codes);
+    codeLengths(dict.codes, dict.lens);
+    canonicalCodes(dict.lens, dict.codes);
+    dict.id = dictionaryId(dict.lens);
+}
+
+void putDictionary(string &out, const Dictionary &dict) {
+    out.append(DICTIONARY_MAGIC, sizeof(DICTIONARY_MAGIC));
+    putLE(out, dict.id, 4);
+    putCodeLengths(out, dict.lens);
+}
+
+bool getDictionary(const unsigned char *p, size_t size, Dictionary &dict) {
+    if (size < 8 || !equal(p, p + 4, DICTIONARY_MAGIC)) return false;
+    if (!getCodeLengths(p + 8, size - 8, dict.lens)) return false;
+    for (int c = 0; c < 256; c++) {
+        if (dict.lens[c] == 0) return false;
+    }
+    dict.id = uint32_t(getLE(p + 4, 4));
+    if (dict.id != dictionaryId(dict.lens)) return false;
+    canonicalCodes(dict.lens, dict.codes);
+    return true;
+}
+
+bool readDictionary(const string &path, Dictionary &dict) {
+    InputFile fin;
+    if (!fin.open(path)) return false;
+    // A dictionary is at most 265 bytes; anything after it is not one
+    size_t got;
+    const unsigned char *p = fin.read(8 + 257 + 1, got);
+    return got <= 8 + 257 && getDictionary(p, got, dict);
+}
@@ -0,0 +1,61 @@
+#ifndef P4_DICTIONARY_H
+#define P4_DICTIONARY_H
+
+#include "huffmanTree.h"
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+// A dictionary ("compress -train") is a canonical Huffman code trained once
+// on a corpus, kept in a file of its own and shared by the archives of many
+// small files, which then store no tree or table of their own:
+//
+//   4 bytes   magic "HUFD"
+//   4 bytes   id, little endian
+//   ...       code-length table (see putCodeLengths())
+//
+// Every byte value is given a code, so that any file can be coded with the
+// dictionary, not only the bytes of the corpus. The id is a hash of the
+// table: an archive coded with a dictionary records its id, and decodes only
+// with a dictionary of that id.
+//
+// The tree file format of HuffmanTree(const std::string &) is not used: it
+// stores the tree as a full binary tree, exponential in its depth, and cannot
+// hold the characters ',' and '-'.
+
+const char DICTIONARY_MAGIC[4] = {'H', 'U', 'F', 'D'};
+const int DICTIONARY_MAX_LEN = 32;
+
+struct Dictionary {
+    uint32_t id;
+    int lens[256];          // Code length of each character, all positive
+    HuffmanCode codes[256]; // The canonical codes of lens
+};
+
+uint32_t dictionaryId(const int lens[256]);
+// EFFECTS: Returns the id of the code-length table lens.
+
+void trainDictionary(const uint64_t count[256], int maxLen, Dictionary &dict);
+// REQUIRES: 0 <= maxLen <= 64
+// MODIFIES: dict
+// EFFECTS: Builds the dictionary of a corpus in which character c occurs
+//          count[c] times. Each count is raised by one, so every character
+//          is coded. No code is longer than maxLen bits, or than
+//          DICTIONARY_MAX_LEN if maxLen is 0.
+
+void putDictionary(std::string &out, const Dictionary &dict);
+// MODIFIES: out
+// EFFECTS: Appends the dictionary file of dict to out.
+
+bool getDictionary(const unsigned char *p, size_t size, Dictionary &dict);
+// MODIFIES: dict
+// EFFECTS: Reads the dictionary file in the "size" bytes at p into dict.
+//          Returns false if it is not one, is truncated, leaves a character
+//          without a code, or does not match its id.
+
+bool readDictionary(const std::string &path, Dictionary &dict);
+// MODIFIES: dict
+// EFFECTS: Reads the dictionary file at path into dict. Returns false if it
+//          cannot be opened or getDictionary() rejects it.
+
+#endif
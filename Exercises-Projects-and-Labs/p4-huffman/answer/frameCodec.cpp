@@ -0,0 +1,227 @@
+#include "frameCodec.h"
+#include "huffmanFormat.h"
+#include "huffmanTree.h"
+#include "nodePool.h"
+#include "packageMerge.h"
+#include "decodeTable.h"
+#include "bitStream.h"
+#include "inputFile.h"
+#include "../../../bench/tracing.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace std;
+
+static void segmentshelper(size_t n, size_t seg[4]) {
+    // EFFECTS: Splits n characters into the four segments of an interleaved
+    //          frame: three of ceil(n / 4) characters and the rest.
+    size_t quarter = (n + 3) / 4;
+    seg[0] = seg[1] = seg[2] = quarter;
+    seg[3] = n - 3 * quarter;
+}
+
+static bool codeshelper(const unsigned char *data, size_t n, int maxLen, bool interleave,
+                        HuffmanCode codes[256], int lens[256]) {
+    // MODIFIES: codes, lens
+    // EFFECTS: Works out the canonical codes of the n bytes at data and
+    //          their lengths, and returns false if coding them, table
+    //          included, would not make them smaller.
+    uint64_t count[256] = {0};
+    countBytes(data, n, count);
+
+    NodePool pool(count);
+    pool.getCodes(codes);
+    limitCodes(count, maxLen, codes);
+    codeLengths(codes, lens);
+
+    uint64_t bits = 0;
+    int tableSize = 256;
+    while (tableSize > 1 && lens[tableSize - 1] == 0) tableSize--;
+    for (int c = 0; c < 256; c++) bits += count[c] * uint64_t(lens[c]);
+    uint64_t estimate = (bits + 7) / 8 + 1 + uint64_t(tableSize) + (interleave ? 15 : 0);
+    if (estimate >= n) return false;
+    canonicalCodes(lens, codes);
+    return true;
+}
+
+void encodeFrame(const unsigned char *data, size_t n, string &out, int maxLen, bool interleave) {
+    TRACE_SCOPE("encodeFrame");
+    TRACE_COUNTER("frame bytes", n);
+    HuffmanCode codes[256];
+    int lens[256];
+
+    // Store the block as is if coding it would not make it smaller
+    interleave = interleave && n >= INTERLEAVE_MIN_SIZE;
+    if (!codeshelper(data, n, maxLen, interleave, codes, lens)) {
+        putLE(out, n, 4);
+        putLE(out, n, 4);
+        out.push_back(char(FRAME_RAW));
+        out.append((const char *) data, n);
+        return;
+    }
+
+    putLE(out, n, 4);
+    size_t sizePos = out.size();
+    putLE(out, 0, 4);
+    out.push_back(char(interleave ? FRAME_HUFFMAN4 : FRAME_HUFFMAN));
+    putCodeLengths(out, lens);
+    size_t payloadPos = out.size();
+    if (interleave) {
+        // Code the segments into separate buffers, then store the sizes of
+        // the first three ahead of the four streams
+        size_t seg[4];
+        segmentshelper(n, seg);
+        string streams[4];
+        const unsigned char *p = data;
+        TRACE_SCOPE("encode symbols");
+        for (int s = 0; s < 4; s++) {
+            BitWriter writer(streams[s]);
+            for (size_t i = 0; i < seg[s]; i++) writer.put(codes[p[i]].bits, codes[p[i]].len);
+            writer.flush();
+            p += seg[s];
+        }
+        for (int s = 0; s < 3; s++) putLE(out, streams[s].size(), 4);
+        for (int s = 0; s < 4; s++) out += streams[s];
+    } else {
+        TRACE_SCOPE("encode symbols");
+        BitWriter writer(out);
+        for (size_t i = 0; i < n; i++) writer.put(codes[data[i]].bits, codes[data[i]].len);
+        writer.flush();
+    }
+
+    uint64_t payloadSize = out.size() - payloadPos;
+    for (int i = 0; i < 4; i++) out[sizePos + i] = char(payloadSize >> (8 * i));
+}
+
+size_t encodeFrame(const unsigned char *data, size_t n, unsigned char *dst, int maxLen) {
+    TRACE_SCOPE("encodeFrame");
+    TRACE_COUNTER("frame bytes", n);
+    HuffmanCode codes[256];
+    int lens[256];
+    storeLE(dst, n, 4);
+    if (!codeshelper(data, n, maxLen, false, codes, lens)) {
+        storeLE(dst + 4, n, 4);
+        dst[8] = FRAME_RAW;
+        memcpy(dst + FRAME_HEADER_SIZE + 1, data, n);
+        return FRAME_HEADER_SIZE + 1 + n;
+    }
+    dst[8] = FRAME_HUFFMAN;
+    // The code-length table, as putCodeLengths() writes it
+    int tableSize = 256;
+    while (tableSize > 1 && lens[tableSize - 1] == 0) tableSize--;
+    unsigned char *p = dst + FRAME_HEADER_SIZE + 1;
+    *p++ = (unsigned char) (tableSize - 1);
+    for (int c = 0; c < tableSize; c++) *p++ = (unsigned char) lens[c];
+    TRACE_SCOPE("encode symbols");
+    BufferWriter writer(p);
+    for (size_t i = 0; i < n; i++) writer.put(codes[data[i]].bits, codes[data[i]].len);
+    unsigned char *end = writer.flush();
+    storeLE(dst + 4, uint64_t(end - p), 4);
+    return size_t(end - dst);
+}
+
+void endFrames(string &out) {
+    putLE(out, 0, 4);
+    putLE(out, 0, 4);
+}
+
+void putFrameIndex(string &out, const vector<FrameIndexEntry> &index) {
+    for (size_t i = 0; i < index.size(); i++) {
+        putLE(out, index[i].frameOffset, 8);
+        putLE(out, index[i].rawOffset, 8);
+    }
+    putLE(out, index.size(), 8);
+    out.append(INDEX_MAGIC, sizeof(INDEX_MAGIC));
+}
+
+bool getFrameIndex(const unsigned char *archive, size_t size, vector<FrameIndexEntry> &index) {
+    if (size < ARCHIVE_HEADER_SIZE + INDEX_TRAILER_SIZE) return false;
+    const unsigned char *trailer = archive + size - INDEX_TRAILER_SIZE;
+    if (!equal(trailer + 8, trailer + 12, INDEX_MAGIC)) return false;
+    uint64_t count = getLE(trailer, 8);
+    if (count > (size - ARCHIVE_HEADER_SIZE - INDEX_TRAILER_SIZE) / 16) return false;
+    const unsigned char *p = trailer - 16 * count;
+    index.resize(size_t(count));
+    for (size_t i = 0; i < index.size(); i++, p += 16) {
+        index[i].frameOffset = getLE(p, 8);
+        index[i].rawOffset = getLE(p + 8, 8);
+        if (index[i].frameOffset >= size) return false;
+        if (i > 0 && (index[i].frameOffset <= index[i - 1].frameOffset
+                      || index[i].rawOffset <= index[i - 1].rawOffset)) return false;
+    }
+    return true;
+}
+
+size_t parseFrameInfo(const unsigned char *p, size_t avail, FrameInfo &info) {
+    if (avail < FRAME_HEADER_SIZE) return 0;
+    info.rawSize = uint32_t(getLE(p, 4));
+    info.payloadSize = uint32_t(getLE(p + 4, 4));
+    if (info.rawSize == 0) return FRAME_HEADER_SIZE;
+    if (avail < FRAME_HEADER_SIZE + 1) return 0;
+    int kind = p[FRAME_HEADER_SIZE];
+    if (kind != FRAME_HUFFMAN && kind != FRAME_RAW && kind != FRAME_HUFFMAN4) return 0;
+    info.kind = kind;
+    if (kind == FRAME_RAW) return info.payloadSize == info.rawSize ? FRAME_HEADER_SIZE + 1 : 0;
+    if (kind == FRAME_HUFFMAN4 && (info.rawSize < INTERLEAVE_MIN_SIZE || info.payloadSize < 12)) return 0;
+    size_t used = getCodeLengths(p + FRAME_HEADER_SIZE + 1, avail - FRAME_HEADER_SIZE - 1, info.lens);
+    return used ? FRAME_HEADER_SIZE + 1 + used : 0;
+}
+
+bool readFrameInfo(InputFile &in, FrameInfo &info) {
+    // The header is gathered as it is read, then parsed in one piece
+    unsigned char buf[FRAME_HEADER_SIZE + 2 + 256];
+    size_t got, size = FRAME_HEADER_SIZE;
+    const unsigned char *p = in.read(FRAME_HEADER_SIZE, got);
+    if (got != FRAME_HEADER_SIZE) return false;
+    copy(p, p + got, buf);
+    if (getLE(buf, 4) != 0) {
+        p = in.read(1, got);
+        if (got != 1) return false;
+        buf[size++] = p[0];
+        if (p[0] != FRAME_RAW) {
+            p = in.read(1, got);
+            if (got != 1) return false;
+            buf[size++] = p[0];
+            size_t n = size_t(p[0]) + 1;
+            p = in.read(n, got);
+            if (got != n) return false;
+            copy(p, p + n, buf + size);
+            size += n;
+        }
+    }
+    return parseFrameInfo(buf, size, info) == size;
+}
+
+bool decodeFrame(const FrameInfo &info, const unsigned char *payload, unsigned char *dst, DecodeTable *reuse) {
+    TRACE_SCOPE("decodeFrame");
+    if (info.kind == FRAME_RAW) {
+        memcpy(dst, payload, info.rawSize);
+        return true;
+    }
+    HuffmanCode codes[256];
+    canonicalCodes(info.lens, codes);
+    DecodeTable local;
+    DecodeTable &table = reuse ? *reuse : local;
+    table.reset(codes);
+    if (info.kind == FRAME_HUFFMAN) {
+        BitReader in(payload, info.payloadSize);
+        return table.decode(in, dst, info.rawSize) == info.rawSize;
+    }
+    size_t seg[4], bytes[4];
+    segmentshelper(info.rawSize, seg);
+    bytes[3] = info.payloadSize - 12;
+    for (int s = 0; s < 3; s++) {
+        bytes[s] = size_t(getLE(payload + 4 * s, 4));
+        if (bytes[s] > bytes[3]) return false;
+        bytes[3] -= bytes[s];
+    }
+    const unsigned char *p = payload + 12;
+    BitReader in[4] = {
+            BitReader(p, bytes[0]),
+            BitReader(p + bytes[0], bytes[1]),
+            BitReader(p + bytes[0] + bytes[1], bytes[2]),
+            BitReader(p + bytes[0] + bytes[1] + bytes[2], bytes[3])
+    };
+    unsigned char *out[4] = {dst, dst + seg[0], dst + seg[0] + seg[1], dst + seg[0] + seg[1] + seg[2]};
+    return table.decode4(in, out, seg);
+}
@@ -0,0 +1,118 @@
+#ifndef P4_FRAMECODEC_H
+#define P4_FRAMECODEC_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+class InputFile;
+class DecodeTable;
+
+// A framed archive ("-stream") cuts the input into blocks, each coded with
+// its own canonical Huffman code and stored as a self-contained frame:
+//
+//   4 bytes   number of original bytes n in the block, little endian;
+//             0 marks the end of the archive
+//   4 bytes   size of the payload in bytes, little endian
+//   1 byte    kind of frame (one of FrameKind)
+//   ...       code-length table (see putCodeLengths()), coded frames only
+//   ...       payload: the canonical codes of the n bytes, or the n bytes
+//             themselves in a raw frame
+//
+// An interleaved frame ("-interleave") splits its block into four segments,
+// three of ceil(n / 4) bytes and the rest, and codes each into its own
+// bitstream so the decoder can run four decode chains at once. Its payload
+// holds the sizes in bytes of the first three streams, 4 bytes each, little
+// endian, followed by the four streams. Blocks shorter than
+// INTERLEAVE_MIN_SIZE always use a single stream.
+//
+// A block is stored raw when coding it, table included, would not make it
+// smaller, so no frame is more than 9 bytes larger than its block.
+//
+// The frames follow an archive header of mode MODE_FRAMED whose length field
+// holds the block size used by the compressor. After the end-of-archive
+// marker comes an index of the frames, read from the end of the archive:
+//
+//   16 bytes  per frame: offset of the frame within the archive, then offset
+//             of its first original byte, both 8 bytes little endian
+//   8 bytes   number of frames
+//   4 bytes   magic "HUFX"
+//
+// Archives without an index still decode from the start.
+
+const size_t DEFAULT_BLOCK_SIZE = 1 << 20;
+const size_t FRAME_HEADER_SIZE = 8;
+const size_t FRAME_MAX_OVERHEAD = 9;     // Most a frame adds to its block
+const size_t INTERLEAVE_MIN_SIZE = 1024;
+
+enum FrameKind {
+    FRAME_HUFFMAN = 0,      // Canonical Huffman codes
+    FRAME_RAW = 1,          // The block's bytes, uncoded
+    FRAME_HUFFMAN4 = 2,     // Canonical Huffman codes in four interleaved streams
+};
+
+const char INDEX_MAGIC[4] = {'H', 'U', 'F', 'X'};
+const size_t INDEX_TRAILER_SIZE = 12;
+
+struct FrameIndexEntry {
+    uint64_t frameOffset;   // Offset of the frame in the archive
+    uint64_t rawOffset;     // Offset of the frame's first original byte
+};
+
+struct FrameInfo {
+    uint32_t rawSize;       // 0 for the end-of-archive marker
+    uint32_t payloadSize;
+    int kind;               // One of FrameKind
+    int lens[256];          // Code length of each character, 0 if absent
+};
+
+void encodeFrame(const unsigned char *data, size_t n, std::string &out, int maxLen = 0, bool interleave = false);
+// REQUIRES: 0 < n < 2^32
+// MODIFIES: out
+// EFFECTS: Appends one frame holding the n bytes at data to out, coded or
+//          raw, whichever is smaller. If maxLen is positive, no code is
+//          longer than maxLen bits. If interleave, a coded frame of at least
+//          INTERLEAVE_MIN_SIZE bytes uses four streams.
+
+size_t encodeFrame(const unsigned char *data, size_t n, unsigned char *dst, int maxLen = 0);
+// REQUIRES: 0 < n < 2^32, and dst has room for n + FRAME_MAX_OVERHEAD bytes
+// MODIFIES: dst
+// EFFECTS: Same as encodeFrame() above with a single stream, but stores the
+//          frame at dst and returns its size. Allocates nothing, unless
+//          maxLen limits the codes.
+
+void endFrames(std::string &out);
+// MODIFIES: out
+// EFFECTS: Appends the end-of-archive marker to out.
+
+void putFrameIndex(std::string &out, const std::vector<FrameIndexEntry> &index);
+// MODIFIES: out
+// EFFECTS: Appends the frame index to out.
+
+bool getFrameIndex(const unsigned char *archive, size_t size, std::vector<FrameIndexEntry> &index);
+// MODIFIES: index
+// EFFECTS: Reads the frame index at the end of the "size" bytes at archive
+//          into index. Returns false if there is none or it is invalid.
+
+size_t parseFrameInfo(const unsigned char *p, size_t avail, FrameInfo &info);
+// MODIFIES: info
+// EFFECTS: Reads a frame header and any code-length table from the "avail"
+//          bytes at p. Returns the number of bytes they take, or 0 if they
+//          are truncated or invalid.
+
+bool readFrameInfo(InputFile &in, FrameInfo &info);
+// MODIFIES: in, info
+// EFFECTS: Reads a frame header and any code-length table from in. Returns
+//          false if they are truncated or invalid.
+
+bool decodeFrame(const FrameInfo &info, const unsigned char *payload, unsigned char *dst,
+                 DecodeTable *reuse = nullptr);
+// REQUIRES: payload holds info.payloadSize bytes and dst has room for
+//           info.rawSize bytes.
+// MODIFIES: dst, reuse
+// EFFECTS: Decodes the frame's payload into dst. Returns false if the
+//          payload is corrupt. The codes are looked up in reuse, reset for
+//          this frame, if given, and in a table of this call otherwise.
+
+#endif
@@ -0,0 +1,112 @@
+#include "huffmanCodec.h"
+#include "huffmanFormat.h"
+#include "huffmanTree.h"
+#include "frameCodec.h"
+#include "bitStream.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace std;
+
+static const size_t INDEX_ENTRY_SIZE = 16;
+
+size_t compressBound(size_t srcLen) {
+    size_t frames = (srcLen + DEFAULT_BLOCK_SIZE - 1) / DEFAULT_BLOCK_SIZE;
+    return ARCHIVE_HEADER_SIZE + srcLen + frames * (FRAME_MAX_OVERHEAD + INDEX_ENTRY_SIZE)
+           + FRAME_HEADER_SIZE + INDEX_TRAILER_SIZE;
+}
+
+size_t compress(const unsigned char *src, size_t srcLen, unsigned char *dst, size_t dstCap, int maxLen) {
+    if (dstCap < compressBound(srcLen)) return 0;
+    memcpy(dst, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC));
+    dst[4] = MODE_FRAMED;
+    storeLE(dst + 5, DEFAULT_BLOCK_SIZE, 8);
+    unsigned char *p = dst + ARCHIVE_HEADER_SIZE;
+    for (size_t done = 0; done < srcLen; done += DEFAULT_BLOCK_SIZE) {
+        p += encodeFrame(src + done, min(DEFAULT_BLOCK_SIZE, srcLen - done), p, maxLen);
+    }
+    unsigned char *frames = p;
+    storeLE(p, 0, FRAME_HEADER_SIZE);
+    p += FRAME_HEADER_SIZE;
+
+    // The index is made from the headers of the frames just written, so no
+    // list of them is kept on the way
+    const unsigned char *frame = dst + ARCHIVE_HEADER_SIZE;
+    uint64_t rawPos = 0, count = 0;
+    FrameInfo info;
+    while (frame < frames) {
+        size_t used = parseFrameInfo(frame, size_t(frames - frame), info);
+        storeLE(p, uint64_t(frame - dst), 8);
+        storeLE(p + 8, rawPos, 8);
+        p += INDEX_ENTRY_SIZE;
+        frame += used + info.payloadSize;
+        rawPos += info.rawSize;
+        count++;
+    }
+    storeLE(p, count, 8);
+    memcpy(p + 8, INDEX_MAGIC, sizeof(INDEX_MAGIC));
+    p += INDEX_TRAILER_SIZE;
+    return size_t(p - dst);
+}
+
+size_t decompressedSize(const unsigned char *src, size_t srcLen) {
+    if (srcLen < ARCHIVE_HEADER_SIZE || !equal(src, src + 4, ARCHIVE_MAGIC)) return HUFFMAN_ERROR;
+    int mode = src[4];
+    if (mode == MODE_TREE || mode == MODE_CANONICAL) {
+        uint64_t total = getLE(src + 5, 8);
+        return total < HUFFMAN_ERROR ? size_t(total) : HUFFMAN_ERROR;
+    }
+    if (mode != MODE_FRAMED) return HUFFMAN_ERROR;
+    size_t pos = ARCHIVE_HEADER_SIZE, total = 0;
+    FrameInfo info;
+    for (;;) {
+        size_t used = parseFrameInfo(src + pos, srcLen - pos, info);
+        if (used == 0 || info.payloadSize > srcLen - pos - used) return HUFFMAN_ERROR;
+        if (info.rawSize == 0) return total;
+        pos += used + info.payloadSize;
+        total += info.rawSize;
+    }
+}
+
+size_t decompress(const unsigned char *src, size_t srcLen, unsigned char *dst, size_t dstCap,
+                  HuffmanContext *context) {
+    size_t total = decompressedSize(src, srcLen);
+    if (total == HUFFMAN_ERROR || total > dstCap) return HUFFMAN_ERROR;
+    HuffmanContext local;
+    DecodeTable &table = (context ? context : &local)->table;
+    int mode = src[4];
+    const unsigned char *data = src + ARCHIVE_HEADER_SIZE;
+    size_t size = srcLen - ARCHIVE_HEADER_SIZE;
+    if (mode == MODE_FRAMED) {
+        // decompressedSize() has checked the frame headers
+        size_t pos = 0, done = 0;
+        FrameInfo info;
+        for (;;) {
+            size_t used = parseFrameInfo(data + pos, size - pos, info);
+            if (info.rawSize == 0) return done;
+            if (!decodeFrame(info, data + pos + used, dst + done, &table)) return HUFFMAN_ERROR;
+            pos += used + info.payloadSize;
+            done += info.rawSize;
+        }
+    }
+
+    // A "-binary" or "-canonical" archive: the tree or the code lengths,
+    // then the codes of the whole input in one bitstream
+    if (total == 0) return 0;
+    HuffmanCode codes[256];
+    size_t pos = 0;
+    if (mode == MODE_CANONICAL) {
+        int lens[256];
+        pos = getCodeLengths(data, size, lens);
+        if (pos == 0) return HUFFMAN_ERROR;
+        canonicalCodes(lens, codes);
+    }
+    BitReader in(data + pos, size - pos);
+    if (mode == MODE_TREE) {
+        HuffmanTree huffmanTree(in);
+        if (in.overrun()) return HUFFMAN_ERROR;
+        huffmanTree.getCodes(codes);
+    }
+    table.reset(codes);
+    return table.decode(in, dst, total) == total ? total : HUFFMAN_ERROR;
+}
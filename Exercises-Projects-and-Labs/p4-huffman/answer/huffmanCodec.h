@@ -0,0 +1,58 @@
+#ifndef P4_HUFFMANCODEC_H
+#define P4_HUFFMANCODEC_H
+
+#include "decodeTable.h"
+#include <cstdint>
+#include <cstddef>
+
+// The codec of compress and decompress as a library, on buffers of the
+// caller's in memory, for programs that code their data in process rather
+// than through the executables and a pipe.
+//
+// compress() writes the framed archive of "compress -stream" (see
+// frameCodec.h): frames of DEFAULT_BLOCK_SIZE bytes with a single stream each,
+// then the frame index, so "decompress -binary" reads what it writes.
+// decompress() reads those archives and the ones of "compress -binary" and
+// "-canonical". The archives of "-dict", "-adaptive" and "-order1" need the
+// executables.
+//
+// Neither function allocates, except for the decode table of decompress()
+// when no context is given, the tree of a "-binary" archive, and the
+// package-merge of a maxLen that limits the codes.
+
+const size_t HUFFMAN_ERROR = SIZE_MAX;
+
+struct HuffmanContext {
+    // What decompress() keeps from one call to the next: its decode table
+    // grows to the largest the archives have needed and is then reused.
+    // A context is used by one call at a time.
+    DecodeTable table;
+};
+
+size_t compressBound(size_t srcLen);
+// EFFECTS: Returns the size of the largest archive compress() can write for
+//          srcLen bytes.
+
+size_t compress(const unsigned char *src, size_t srcLen, unsigned char *dst, size_t dstCap, int maxLen = 0);
+// REQUIRES: 0 <= maxLen <= 64
+// MODIFIES: dst
+// EFFECTS: Compresses the srcLen bytes at src into an archive at dst and
+//          returns its size, or 0 if dstCap is less than compressBound(srcLen).
+//          If maxLen is positive, no code is longer than maxLen bits.
+
+size_t decompressedSize(const unsigned char *src, size_t srcLen);
+// EFFECTS: Returns the number of original bytes the archive of srcLen bytes
+//          at src holds, or HUFFMAN_ERROR if it is not an archive decompress()
+//          reads. The frame headers of a framed archive are read through,
+//          and it is an error if they are truncated.
+
+size_t decompress(const unsigned char *src, size_t srcLen, unsigned char *dst, size_t dstCap,
+                  HuffmanContext *context = nullptr);
+// MODIFIES: dst, context
+// EFFECTS: Decompresses the archive of srcLen bytes at src into dst and
+//          returns the number of original bytes, or HUFFMAN_ERROR if it is
+//          not an archive this reads, it is truncated or corrupt, or they do
+//          not fit in dstCap bytes. The decode table of context is used if
+//          one is given.
+
+#endif
@@ -0,0 +1,98 @@
+#ifndef P4_HUFFMANFORMAT_H
+#define P4_HUFFMANFORMAT_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+// Layout of a packed ("-binary") archive:
+//
+//   offset 0   4 bytes   magic "HUFB"
+//   offset 4   1 byte    mode (one of ArchiveMode)
+//   offset 5   8 bytes   number of original bytes, little endian
+//   offset 13  ...       bitstream, most significant bit first:
+//                          the tree in preorder (0 = internal node,
+//                          1 = leaf followed by its 8-bit symbol),
+//                          then the code of every original byte.
+//                        The last byte is padded with zero bits.
+//
+// In the canonical mode ("-canonical") the tree is replaced by a code-length
+// table right after the header:
+//
+//   1 byte        n - 1, where characters 0 .. n-1 have their lengths stored
+//   n bytes       code length of each character, 0 if absent
+//
+// and the bitstream holds only the codes, assigned canonically from the
+// lengths (see canonicalCodes()).
+//
+// In the dictionary mode ("-dict") the header is followed by the 4-byte id,
+// little endian, of the dictionary the codes come from (see dictionary.h),
+// and the bitstream holds only the codes.
+//
+// An empty input stores no tree, no table and no codes.
+
+const char ARCHIVE_MAGIC[4] = {'H', 'U', 'F', 'B'};
+const size_t ARCHIVE_HEADER_SIZE = 13;
+
+enum ArchiveMode {
+    MODE_TREE = 1,       // Tree stored in preorder, as described above.
+    MODE_CANONICAL = 2,  // Only code lengths stored.
+    MODE_FRAMED = 3,     // Self-contained frames, see frameCodec.h.
+    MODE_DICTIONARY = 4, // Codes of a shared dictionary, named by its id.
+    MODE_ADAPTIVE = 5,   // One-pass adaptive codes, see adaptiveHuffman.h.
+    MODE_ORDER1 = 6,     // Codes chosen by the previous byte, see contextModel.h.
+};
+
+inline void putLE(std::string &out, uint64_t v, int bytes) {
+    // MODIFIES: out
+    // EFFECTS: Append the low "bytes" bytes of v to out, least significant first.
+    for (int i = 0; i < bytes; i++) {
+        out.push_back(char(v & 0xff));
+        v >>= 8;
+    }
+}
+
+inline void storeLE(unsigned char *p, uint64_t v, int bytes) {
+    // MODIFIES: p
+    // EFFECTS: Store the low "bytes" bytes of v at p, as putLE() appends them.
+    for (int i = 0; i < bytes; i++) {
+        p[i] = (unsigned char) (v & 0xff);
+        v >>= 8;
+    }
+}
+
+inline uint64_t getLE(const unsigned char *p, int bytes) {
+    // EFFECTS: Return the little-endian integer stored in the "bytes" bytes at p.
+    uint64_t v = 0;
+    for (int i = bytes - 1; i >= 0; i--) {
+        v = (v << 8) | p[i];
+    }
+    return v;
+}
+
+inline void putCodeLengths(std::string &out, const int lens[256]) {
+    // REQUIRES: 0 <= lens[c] <= 255 for every c.
+    // MODIFIES: out
+    // EFFECTS: Append the code-length table for lens to out.
+    int n = 256;
+    while (n > 1 && lens[n - 1] == 0) n--;
+    out.push_back(char(n - 1));
+    for (int c = 0; c < n; c++) out.push_back(char(lens[c]));
+}
+
+inline size_t getCodeLengths(const unsigned char *p, size_t avail, int lens[256]) {
+    // MODIFIES: lens
+    // EFFECTS: Read a code-length table from the "avail" bytes at p into lens
+    //          and return its size in bytes, or 0 if it is truncated or holds
+    //          a length longer than 64 bits.
+    if (avail < 1) return 0;
+    size_t n = size_t(p[0]) + 1;
+    if (avail < n + 1) return 0;
+    for (size_t c = 0; c < 256; c++) {
+        lens[c] = c < n ? p[c + 1] : 0;
+        if (lens[c] > 64) return 0;
+    }
+    return n + 1;
+}
+
+#endif
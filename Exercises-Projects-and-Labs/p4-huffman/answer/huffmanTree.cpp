@@ -1,12 +1,44 @@
 #include "huffmanTree.h"
+#include "nodePool.h"
 #include <vector>
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <algorithm>
+#include <limits>
 
 using namespace std;
 
 
+void countBytes(const unsigned char *data, size_t n, uint64_t count[256]) {
+    // Four interleaved sub-histograms, so that runs of one byte value do not
+    // serialise on incrementing the same counter
+    uint32_t sub[4][256] = {{0}};
+    while (n > 0) {
+        // Flush before a 32-bit counter could overflow
+        size_t chunk = min(n, size_t(1) << 30);
+        size_t i = 0;
+        for (; i + 4 <= chunk; i += 4) {
+            sub[0][data[i]]++;
+            sub[1][data[i + 1]]++;
+            sub[2][data[i + 2]]++;
+            sub[3][data[i + 3]]++;
+        }
+        for (; i < chunk; i++) sub[0][data[i]]++;
+        for (int c = 0; c < 256; c++) {
+            count[c] += uint64_t(sub[0][c]) + sub[1][c] + sub[2][c] + sub[3][c];
+            sub[0][c] = sub[1][c] = sub[2][c] = sub[3][c] = 0;
+        }
+        data += chunk;
+        n -= chunk;
+    }
+}
+
+Node *buildHuffman(const uint64_t count[256]) {
+    NodePool pool(count);
+    return pool.toNode();
+}
+
 HuffmanTree::HuffmanTree(Node *rootNode) {
     this->root = rootNode;
 }
@@ -45,6 +77,20 @@ HuffmanTree::HuffmanTree(const string &treefile) {
     }
 }
 
+static Node *readhelper(BitReader &in, int depth) {
+    // A well-formed tree over 256 symbols is at most 256 levels deep
+    if (in.get(1) || depth > 256 || in.overrun()) {
+        return new Node(std::string(1, char(in.get(8))), 0);
+    }
+    Node *left = readhelper(in, depth + 1);
+    Node *right = readhelper(in, depth + 1);
+    return new Node("", 0, left, right);
+}
+
+HuffmanTree::HuffmanTree(BitReader &in) {
+    root = readhelper(in, 0);
+}
+
 static void printTree_helper(Node *n, int depth, int targetDepth) {
     // Iterative deepening printer
     if (targetDepth > depth) {
@@ -94,4 +140,113 @@ void HuffmanTree::printTree() {
         printTree_helper(cp.root, depth - 1, i);
         cout << endl;
     }
-}
\ No newline at end of file
+}
+
+static void codeshelper(const Node *n, uint64_t bits, int len, HuffmanCode codes[256]) {
+    if (!n) return;
+    if (!n->leftSubtree() && !n->rightSubtree()) {
+        HuffmanCode &code = codes[(unsigned char) n->getstr()[0]];
+        code.bits = bits;
+        code.len = len;
+        return;
+    }
+    codeshelper(n->leftSubtree(), bits << 1, len + 1, codes);
+    codeshelper(n->rightSubtree(), (bits << 1) | 1, len + 1, codes);
+}
+
+void HuffmanTree::getCodes(HuffmanCode codes[256]) const {
+    for (int i = 0; i < 256; i++) {
+        codes[i].bits = 0;
+        codes[i].len = -1;
+    }
+    codeshelper(root, 0, 0, codes);
+}
+
+void canonicalCodes(const int lens[256], HuffmanCode codes[256]) {
+    int maxLen = 0, present = 0;
+    for (int c = 0; c < 256; c++) {
+        codes[c].bits = 0;
+        codes[c].len = -1;
+        if (lens[c] > 0) {
+            maxLen = max(maxLen, lens[c]);
+            present++;
+        }
+    }
+    if (present == 1) {
+        for (int c = 0; c < 256; c++) {
+            if (lens[c] > 0) codes[c].len = 0;
+        }
+        return;
+    }
+    uint64_t code = 0;
+    for (int len = 1; len <= maxLen; len++) {
+        for (int c = 0; c < 256; c++) {
+            if (lens[c] != len) continue;
+            codes[c].bits = code;
+            codes[c].len = len;
+            code++;
+        }
+        code <<= 1;
+    }
+}
+
+void codeLengths(const HuffmanCode codes[256], int lens[256]) {
+    for (int i = 0; i < 256; i++) {
+        lens[i] = codes[i].len == 0 ? 1 : max(codes[i].len, 0);
+    }
+}
+
+namespace {
+struct CodedChar {
+    uint64_t key;       // Code left-aligned in 64 bits
+    int len;
+    int c;
+
+    bool operator<(const CodedChar &other) const {
+        return key < other.key;
+    }
+};
+}
+
+static Node *codeshelper(const vector<CodedChar> &chars, size_t lo, size_t hi, int depth,
+                         const uint64_t count[256], uint64_t &weight) {
+    // Characters lo..hi-1 share their first "depth" code bits
+    if (hi - lo == 1 && chars[lo].len == depth) {
+        weight = count[chars[lo].c];
+        return new Node(string(1, char(chars[lo].c)), int(min(weight, uint64_t(numeric_limits<int>::max()))));
+    }
+    size_t mid = lo;
+    while (mid < hi && !((chars[mid].key >> (63 - depth)) & 1)) mid++;
+    uint64_t leftWeight = 0, rightWeight = 0;
+    Node *left = codeshelper(chars, lo, mid, depth + 1, count, leftWeight);
+    Node *right = codeshelper(chars, mid, hi, depth + 1, count, rightWeight);
+    weight = leftWeight + rightWeight;
+    return new Node("", int(min(weight, uint64_t(numeric_limits<int>::max()))), left, right);
+}
+
+Node *treeFromCodes(const HuffmanCode codes[256], const uint64_t count[256]) {
+    vector<CodedChar> chars;
+    for (int c = 0; c < 256; c++) {
+        if (codes[c].len < 0) continue;
+        uint64_t key = codes[c].len == 0 ? 0 : codes[c].bits << (64 - codes[c].len);
+        chars.push_back({key, codes[c].len, c});
+    }
+    sort(chars.begin(), chars.end());
+    uint64_t weight = 0;
+    return codeshelper(chars, 0, chars.size(), 0, count, weight);
+}
+
+static void writehelper(const Node *n, BitWriter &out) {
+    if (!n->leftSubtree() && !n->rightSubtree()) {
+        out.put(1, 1);
+        out.put((unsigned char) n->getstr()[0], 8);
+        return;
+    }
+    out.put(0, 1);
+    writehelper(n->leftSubtree(), out);
+    writehelper(n->rightSubtree(), out);
+}
+
+void HuffmanTree::writeTree(BitWriter &out) const {
+    writehelper(root, out);
+}
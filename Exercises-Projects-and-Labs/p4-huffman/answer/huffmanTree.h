@@ -2,6 +2,48 @@
 #define P4_HUFFMANTREE_H
 
 #include "binaryTree.h"
+#include "bitStream.h"
+
+struct HuffmanCode {
+    // The code of one character: its "len" lowest bits, read from the most
+    // significant one, give the path from the root (0 = left, 1 = right).
+    uint64_t bits;
+    int len;            // -1 if the character does not appear in the tree
+};
+
+void canonicalCodes(const int lens[256], HuffmanCode codes[256]);
+// REQUIRES: lens[c] is the code length of character c, or 0 if c is absent,
+//           and the lengths are those of a Huffman code.
+// MODIFIES: codes
+// EFFECTS: Assigns canonical codes: shorter codes first, and characters of
+//          equal length in increasing order, each code being the previous one
+//          plus one. If only one character is present its code is empty.
+
+void countBytes(const unsigned char *data, size_t n, uint64_t count[256]);
+// MODIFIES: count
+// EFFECTS: Adds the number of occurrences of each byte value among the n
+//          bytes at data to count.
+
+Node *buildHuffman(const uint64_t count[256]);
+// EFFECTS: Runs the Huffman algorithm over the characters c with count[c] > 0
+//          and returns the dynamically allocated root, or nullptr if there are
+//          none. The two lightest nodes are merged first; ties are broken by
+//          the "str" the merged nodes would have, and the first node taken
+//          becomes the right child. The tree is built in a NodePool and
+//          copied out; see NodePool::toNode() for what the nodes hold.
+
+void codeLengths(const HuffmanCode codes[256], int lens[256]);
+// MODIFIES: lens
+// EFFECTS: Stores the length of each code in lens, 0 for absent characters.
+//          The empty code of a lone character is given length 1, which is
+//          what canonicalCodes() expects.
+
+Node *treeFromCodes(const HuffmanCode codes[256], const uint64_t count[256]);
+// REQUIRES: codes is a complete prefix code with at least one character.
+// EFFECTS: Returns a dynamically allocated tree in which the path to each
+//          character is its code. Leaves carry their character and count,
+//          internal nodes an empty "str" and the sum of the counts below
+//          them (capped at the largest int).
 
 class HuffmanTree : public BinaryTree {
     // Huffman tree
@@ -48,10 +90,29 @@ public:
     // Each '-' in the file means there is no node present in that position.
     //
 
+    HuffmanTree(BitReader &in);
+    // MODIFIES: this, in
+    // EFFECTS: Constructs a huffman tree from the packed preorder form written
+    //          by writeTree(). Leaves whose bits run past the end of the input
+    //          are read as zero bits; check in.overrun() afterwards.
+
     void printTree();
     // EFFECTS: Prints the huffman tree following the format explained above.
     //          You do not need to understand the details of the implementation 
     //          of this function.
+
+    void getCodes(HuffmanCode codes[256]) const;
+    // MODIFIES: codes
+    // EFFECTS: Fills codes[c] with the code of every character c in the tree
+    //          using a single traversal, and sets codes[c].len to -1 for the
+    //          characters that are absent.
+
+    void writeTree(BitWriter &out) const;
+    // REQUIRES: The tree is not empty.
+    // MODIFIES: out
+    // EFFECTS: Writes the tree in packed preorder: a 0 bit for an internal
+    //          node, followed by its left and right subtrees, or a 1 bit and
+    //          the 8-bit character for a leaf.
          
 };
 
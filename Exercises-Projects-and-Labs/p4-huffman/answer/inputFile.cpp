@@ -0,0 +1,91 @@
+#include "inputFile.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+InputFile::InputFile() : fd(-1), ownsFd(false), map(nullptr), mapSize(0), pos(0) {}
+
+InputFile::~InputFile() {
+    if (map) munmap(map, mapSize);
+    if (ownsFd) close(fd);
+}
+
+bool InputFile::open(const string &path) {
+    if (path == "-") {
+        fd = STDIN_FILENO;
+    } else {
+        fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        ownsFd = true;
+    }
+    struct stat st;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        void *p = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED) {
+            map = (unsigned char *) p;
+            mapSize = size_t(st.st_size);
+            madvise(map, mapSize, MADV_SEQUENTIAL);
+        }
+    }
+    return true;
+}
+
+const unsigned char *InputFile::read(size_t n, size_t &got) {
+    if (map) {
+        got = min(n, mapSize - pos);
+        const unsigned char *span = map + pos;
+        pos += got;
+        return span;
+    }
+    if (buffer.size() < n) buffer.resize(n);
+    got = 0;
+    while (got < n) {
+        ssize_t r = ::read(fd, buffer.data() + got, n - got);
+        if (r <= 0) break;
+        got += size_t(r);
+    }
+    return buffer.data();
+}
+
+const unsigned char *InputFile::readSome(size_t n, size_t &got) {
+    if (map) return read(n, got);
+    if (buffer.size() < n) buffer.resize(n);
+    ssize_t r = ::read(fd, buffer.data(), n);
+    got = r > 0 ? size_t(r) : 0;
+    return buffer.data();
+}
+
+bool InputFile::rewind() {
+    return seek(0);
+}
+
+bool InputFile::seek(size_t offset) {
+    if (map) {
+        if (offset > mapSize) return false;
+        pos = offset;
+        return true;
+    }
+    return lseek(fd, off_t(offset), SEEK_SET) == off_t(offset);
+}
+
+void InputFile::prefault(const unsigned char *span, size_t n) const {
+    static const size_t PAGE = 4096;
+    volatile unsigned char sink = 0;
+    for (size_t i = 0; i < n; i += PAGE) sink = sink ^ span[i];
+    if (n > 0) sink = sink ^ span[n - 1];
+}
+
+bool InputFile::isMapped() const {
+    return map != nullptr;
+}
+
+size_t InputFile::size() const {
+    return mapSize;
+}
+
+const unsigned char *InputFile::data() const {
+    return map;
+}
@@ -0,0 +1,73 @@
+#ifndef P4_INPUTFILE_H
+#define P4_INPUTFILE_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+class InputFile {
+    // Reads a file as contiguous spans of bytes. Regular files are memory
+    // mapped, so spans point straight into the mapping; pipes, terminals and
+    // files that cannot be mapped are read through a buffer instead.
+
+    int fd;
+    bool ownsFd;
+    unsigned char *map;
+    size_t mapSize;
+    size_t pos;                     // Offset of the next byte in the mapping
+    std::vector<unsigned char> buffer;
+
+    InputFile(const InputFile &);
+    InputFile &operator=(const InputFile &);
+
+public:
+    InputFile();
+
+    ~InputFile();
+    // EFFECTS: Unmaps and closes the file.
+
+    bool open(const std::string &path);
+    // MODIFIES: this
+    // EFFECTS: Opens the file at path, or standard input if path is "-".
+    //          Returns false if it cannot be opened.
+
+    const unsigned char *read(size_t n, size_t &got);
+    // MODIFIES: this
+    // EFFECTS: Returns the next n bytes as one span and sets got to its
+    //          length, which is smaller than n only at the end of the file.
+    //          A span into a mapped file stays valid until the file is
+    //          closed; a buffered one only until the next call to read().
+
+    const unsigned char *readSome(size_t n, size_t &got);
+    // MODIFIES: this
+    // EFFECTS: Like read(), but returns as soon as any bytes are available
+    //          rather than waiting for n of them, so that got is 0 only at
+    //          the end of the file. A mapped file has all of its bytes
+    //          available at once.
+
+    bool rewind();
+    // MODIFIES: this
+    // EFFECTS: Starts reading again from the first byte. Returns false if the
+    //          input can be read only once.
+
+    bool seek(size_t offset);
+    // MODIFIES: this
+    // EFFECTS: Continues reading at byte "offset". Returns false if the input
+    //          is not seekable or is shorter than offset.
+
+    void prefault(const unsigned char *span, size_t n) const;
+    // EFFECTS: Reads one byte of every page of the n bytes at span, a span
+    //          of a mapped file, so that they are read from disk now, on the
+    //          calling thread, rather than when they are first used.
+
+    bool isMapped() const;
+    // EFFECTS: Returns true if the file is memory mapped.
+
+    size_t size() const;
+    // EFFECTS: Returns the size of a mapped file, 0 otherwise.
+
+    const unsigned char *data() const;
+    // EFFECTS: Returns the first byte of a mapped file, nullptr otherwise.
+};
+
+#endif
@@ -0,0 +1,153 @@
+#include "nodePool.h"
+#include <algorithm>
+#include <limits>
+
+using namespace std;
+
+const uint16_t NodePool::NONE;
+const int NodePool::MAX_NODES;
+
+namespace {
+struct Lighter {
+    // Strict order in which the Huffman algorithm takes nodes
+    const NodePool::PoolNode *nodes;
+
+    bool operator()(uint16_t a, uint16_t b) const {
+        if (nodes[a].weight != nodes[b].weight) return nodes[a].weight < nodes[b].weight;
+        return nodes[a].first < nodes[b].first;
+    }
+};
+
+const uint64_t COUNTING_SORT_LIMIT = 1024;
+}
+
+NodePool::NodePool(const uint64_t count[256]) : size(0), root(NONE) {
+    // Two-queue construction: the leaves are sorted once, and merged nodes
+    // are created in order of nondecreasing weight, so the two lightest
+    // nodes are always at the fronts of the two queues.
+    uint64_t maxWeight = 0;
+    for (int c = 0; c < 256; c++) {
+        if (count[c] == 0) continue;
+        PoolNode &leaf = nodes[size++];
+        leaf.weight = count[c];
+        leaf.left = leaf.right = NONE;
+        leaf.symbol = leaf.first = uint8_t(c);
+        maxWeight = max(maxWeight, count[c]);
+    }
+    int n = size;
+    if (n == 0) return;
+
+    Lighter lighter = {nodes};
+    uint16_t leaves[256];
+    if (maxWeight <= COUNTING_SORT_LIMIT) {
+        // Leaves were added in character order, so a stable counting sort
+        // on weight leaves them sorted by (weight, character)
+        uint16_t start[COUNTING_SORT_LIMIT + 2] = {0};
+        for (int i = 0; i < n; i++) start[nodes[i].weight + 1]++;
+        for (uint64_t w = 1; w <= maxWeight + 1; w++) start[w] += start[w - 1];
+        for (int i = 0; i < n; i++) leaves[start[nodes[i].weight]++] = uint16_t(i);
+    } else {
+        for (int i = 0; i < n; i++) leaves[i] = uint16_t(i);
+        sort(leaves, leaves + n, lighter);
+    }
+
+    uint16_t merged[256];
+    int leafHead = 0, mergedHead = 0, mergedTail = 0;
+    for (int k = 1; k < n; k++) {
+        uint16_t taken[2];
+        for (int t = 0; t < 2; t++) {
+            if (mergedHead == mergedTail
+                || (leafHead < n && lighter(leaves[leafHead], merged[mergedHead]))) {
+                taken[t] = leaves[leafHead++];
+            } else {
+                taken[t] = merged[mergedHead++];
+            }
+        }
+        uint16_t right = taken[0], left = taken[1];
+        PoolNode &parent = nodes[size];
+        parent.weight = nodes[left].weight + nodes[right].weight;
+        parent.left = left;
+        parent.right = right;
+        parent.symbol = 0;
+        parent.first = nodes[left].first;
+
+        // Its weight is at least that of every queued merged node; among
+        // equal weights keep the queue ordered by leftmost character
+        int pos = mergedTail++;
+        while (pos > mergedHead && lighter(uint16_t(size), merged[pos - 1])) {
+            merged[pos] = merged[pos - 1];
+            pos--;
+        }
+        merged[pos] = uint16_t(size++);
+    }
+    root = n == 1 ? leaves[0] : merged[mergedHead];
+}
+
+bool NodePool::empty() const {
+    return size == 0;
+}
+
+const NodePool::PoolNode &NodePool::node(uint16_t i) const {
+    return nodes[i];
+}
+
+uint16_t NodePool::rootIndex() const {
+    return root;
+}
+
+void NodePool::getCodes(HuffmanCode codes[256]) const {
+    for (int c = 0; c < 256; c++) {
+        codes[c].bits = 0;
+        codes[c].len = -1;
+    }
+    if (empty()) return;
+    struct Item {
+        uint16_t index;
+        int len;
+        uint64_t bits;
+    } stack[MAX_NODES];
+    int top = 0;
+    stack[top++] = {root, 0, 0};
+    while (top > 0) {
+        Item item = stack[--top];
+        const PoolNode &n = nodes[item.index];
+        if (n.left == NONE) {
+            codes[n.symbol].bits = item.bits;
+            codes[n.symbol].len = item.len;
+            continue;
+        }
+        stack[top++] = {n.right, item.len + 1, (item.bits << 1) | 1};
+        stack[top++] = {n.left, item.len + 1, item.bits << 1};
+    }
+}
+
+void NodePool::writeTree(BitWriter &out) const {
+    uint16_t stack[MAX_NODES];
+    int top = 0;
+    stack[top++] = root;
+    while (top > 0) {
+        const PoolNode &n = nodes[stack[--top]];
+        if (n.left == NONE) {
+            out.put(1, 1);
+            out.put(n.symbol, 8);
+            continue;
+        }
+        out.put(0, 1);
+        stack[top++] = n.right;
+        stack[top++] = n.left;
+    }
+}
+
+static Node *tonodehelper(const NodePool &pool, uint16_t i) {
+    const NodePool::PoolNode &n = pool.node(i);
+    int num = int(min(n.weight, uint64_t(numeric_limits<int>::max())));
+    if (n.left == NodePool::NONE) return new Node(string(1, char(n.symbol)), num);
+    Node *left = tonodehelper(pool, n.left);
+    Node *right = tonodehelper(pool, n.right);
+    return new Node("", num, left, right);
+}
+
+Node *NodePool::toNode() const {
+    if (empty()) return nullptr;
+    return tonodehelper(*this, root);
+}
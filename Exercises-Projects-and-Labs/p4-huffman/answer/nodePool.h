@@ -0,0 +1,69 @@
+#ifndef P4_NODEPOOL_H
+#define P4_NODEPOOL_H
+
+#include "binaryTree.h"
+#include "bitStream.h"
+#include "huffmanTree.h"
+#include <cstdint>
+
+class NodePool {
+    // A Huffman tree whose nodes live in one fixed array. Children are 16-bit
+    // indices into the array and leaves hold their character as a small
+    // integer, so building the tree allocates nothing and copies no strings.
+
+public:
+    static const uint16_t NONE = 0xffff;    // Index of an absent child
+    static const int MAX_NODES = 2 * 256 - 1;
+
+    struct PoolNode {
+        uint64_t weight;
+        uint16_t left, right;   // NONE for a leaf
+        uint8_t symbol;         // Character of a leaf
+        uint8_t first;          // Character of the leftmost leaf below
+    };
+
+private:
+    PoolNode nodes[MAX_NODES];
+    int size;
+    uint16_t root;
+
+public:
+    explicit NodePool(const uint64_t count[256]);
+    // MODIFIES: this
+    // EFFECTS: Builds the Huffman tree of the characters c with count[c] > 0.
+    //          The leaves are sorted once (by counting sort when the counts
+    //          are small) and then merged with two queues in O(n). Nodes are
+    //          merged in exactly the order
+    //          buildHuffman() uses: of two nodes of equal weight the one whose
+    //          "str" would compare smaller - the one with the smaller leftmost
+    //          character - is taken first.
+
+    bool empty() const;
+    // EFFECTS: Returns true if no character was counted.
+
+    const PoolNode &node(uint16_t i) const;
+    // REQUIRES: i < number of nodes
+    // EFFECTS: Returns node i.
+
+    uint16_t rootIndex() const;
+    // REQUIRES: !empty()
+    // EFFECTS: Returns the index of the root.
+
+    void getCodes(HuffmanCode codes[256]) const;
+    // MODIFIES: codes
+    // EFFECTS: Same as HuffmanTree::getCodes(), walking the array with an
+    //          explicit stack.
+
+    void writeTree(BitWriter &out) const;
+    // REQUIRES: !empty()
+    // MODIFIES: out
+    // EFFECTS: Same as HuffmanTree::writeTree().
+
+    Node *toNode() const;
+    // EFFECTS: Returns a dynamically allocated copy of the tree made of Node
+    //          objects, or nullptr if empty. Leaves carry their character and
+    //          weight, internal nodes an empty "str" and their weight (capped
+    //          at the largest int).
+};
+
+#endif
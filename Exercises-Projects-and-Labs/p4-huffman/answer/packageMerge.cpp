@@ -0,0 +1,87 @@
+#include "packageMerge.h"
+#include <algorithm>
+#include <vector>
+
+using namespace std;
+
+int maxCodeLength(const HuffmanCode codes[256]) {
+    int maxLen = 0;
+    for (int c = 0; c < 256; c++) maxLen = max(maxLen, codes[c].len);
+    return maxLen;
+}
+
+namespace {
+struct Item {
+    uint64_t weight;
+    int symbol;             // Character of a leaf, -1 for a package
+    int left, right;        // For a package: its two items on the level below
+};
+
+struct ByWeight {
+    bool operator()(const Item &a, const Item &b) const {
+        if (a.weight != b.weight) return a.weight < b.weight;
+        return a.symbol < b.symbol;
+    }
+};
+
+void countLeaves(const vector<vector<Item> > &levels, int level, int i, int lens[256]) {
+    const Item &item = levels[level][i];
+    if (item.symbol >= 0) {
+        lens[item.symbol]++;
+        return;
+    }
+    countLeaves(levels, level - 1, item.left, lens);
+    countLeaves(levels, level - 1, item.right, lens);
+}
+}
+
+void limitedCodeLengths(const uint64_t count[256], int maxLen, int lens[256]) {
+    vector<Item> leaves;
+    for (int c = 0; c < 256; c++) {
+        lens[c] = 0;
+        if (count[c] > 0) leaves.push_back({count[c], c, -1, -1});
+    }
+    int n = int(leaves.size());
+    if (n == 0) return;
+    if (n == 1) {
+        lens[leaves[0].symbol] = 1;
+        return;
+    }
+    while (maxLen < 64 && (uint64_t(1) << maxLen) < uint64_t(n)) maxLen++;
+    sort(leaves.begin(), leaves.end(), ByWeight());
+
+    // levels[k] holds the sorted items of level k: the leaves merged with
+    // the packages formed by pairing consecutive items of level k - 1
+    vector<vector<Item> > levels(1, leaves);
+    for (int level = 1; level < maxLen; level++) {
+        const vector<Item> &below = levels.back();
+        vector<Item> packages;
+        for (size_t i = 0; i + 1 < below.size(); i += 2) {
+            packages.push_back({below[i].weight + below[i + 1].weight, -1, int(i), int(i + 1)});
+        }
+        vector<Item> merged;
+        merged.reserve(leaves.size() + packages.size());
+        size_t a = 0, b = 0;
+        while (a < leaves.size() || b < packages.size()) {
+            if (b == packages.size() || (a < leaves.size() && leaves[a].weight <= packages[b].weight)) {
+                merged.push_back(leaves[a++]);
+            } else {
+                merged.push_back(packages[b++]);
+            }
+        }
+        levels.push_back(merged);
+    }
+
+    // The 2n - 2 lightest items of the top level; each appearance of a
+    // character below them adds one bit to its code
+    int top = int(levels.size()) - 1;
+    for (int i = 0; i < 2 * n - 2; i++) countLeaves(levels, top, i, lens);
+}
+
+bool limitCodes(const uint64_t count[256], int maxLen, HuffmanCode codes[256]) {
+    if (maxLen <= 0 || maxCodeLength(codes) <= maxLen) return false;
+    int lens[256];
+    limitedCodeLengths(count, maxLen, lens);
+    canonicalCodes(lens, codes);
+    return true;
+}
@@ -0,0 +1,27 @@
+#ifndef P4_PACKAGEMERGE_H
+#define P4_PACKAGEMERGE_H
+
+#include "huffmanTree.h"
+#include <cstdint>
+
+int maxCodeLength(const HuffmanCode codes[256]);
+// EFFECTS: Returns the length of the longest code in codes, or 0 if there
+//          are none.
+
+void limitedCodeLengths(const uint64_t count[256], int maxLen, int lens[256]);
+// REQUIRES: 1 <= maxLen <= 64
+// MODIFIES: lens
+// EFFECTS: Computes optimal code lengths of at most maxLen bits for the
+//          characters c with count[c] > 0 using the package-merge algorithm,
+//          and stores them in lens (0 for absent characters). If maxLen bits
+//          cannot give every character a code, the smallest length that can
+//          is used instead. A lone character gets length 1.
+
+bool limitCodes(const uint64_t count[256], int maxLen, HuffmanCode codes[256]);
+// REQUIRES: codes holds the Huffman codes of count, as from getCodes().
+// MODIFIES: codes
+// EFFECTS: If maxLen > 0 and some code is longer than maxLen bits, replaces
+//          codes with canonical codes of the limited lengths and returns
+//          true. Otherwise leaves codes unchanged and returns false.
+
+#endif
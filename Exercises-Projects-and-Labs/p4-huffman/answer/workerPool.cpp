@@ -0,0 +1,111 @@
+#include "workerPool.h"
+
+using namespace std;
+
+WorkerPool::WorkerPool(unsigned n) :
+        next(0), total(0), finished(0), generation(0), stopping(false) {
+    for (unsigned i = 1; i < n; i++) threads.emplace_back(&WorkerPool::work, this);
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        lock_guard<mutex> lock(mtx);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto &t : threads) t.join();
+}
+
+void WorkerPool::work() {
+    unsigned long seen = 0;
+    unique_lock<mutex> lock(mtx);
+    while (true) {
+        wake.wait(lock, [&] { return stopping || (generation != seen && next < total); });
+        if (stopping) return;
+        seen = generation;
+        while (next < total) {
+            size_t i = next++;
+            lock.unlock();
+            job(i);
+            lock.lock();
+            if (++finished == total) done.notify_all();
+        }
+    }
+}
+
+void WorkerPool::run(size_t count, const function<void(size_t)> &fn) {
+    if (count == 0) return;
+    unique_lock<mutex> lock(mtx);
+    job = fn;
+    next = 0;
+    total = count;
+    finished = 0;
+    generation++;
+    wake.notify_all();
+    while (next < total) {
+        size_t i = next++;
+        lock.unlock();
+        job(i);
+        lock.lock();
+        ++finished;
+    }
+    done.wait(lock, [&] { return finished == total; });
+}
+
+unsigned WorkerPool::size() const {
+    return unsigned(threads.size()) + 1;
+}
+
+bool runPipeline(const function<bool(int)> &read, const function<void(int)> &work,
+                 const function<bool(int)> &write) {
+    enum State { FREE, READ, WORKED };
+    State state[PIPELINE_SLOTS];
+    bool last[PIPELINE_SLOTS];
+    for (int s = 0; s < PIPELINE_SLOTS; s++) state[s] = FREE;
+    bool stopping = false;
+    mutex mtx;
+    condition_variable changed;
+
+    // Each stage waits for the slot of its next batch to reach the state the
+    // stage before leaves it in
+    auto waithelper = [&](int s, State want) {
+        unique_lock<mutex> lock(mtx);
+        changed.wait(lock, [&] { return stopping || state[s] == want; });
+        return !stopping;
+    };
+    auto sethelper = [&](int s, State to) {
+        lock_guard<mutex> lock(mtx);
+        state[s] = to;
+        changed.notify_all();
+    };
+
+    thread reader([&] {
+        for (int s = 0; waithelper(s, FREE); s = (s + 1) % PIPELINE_SLOTS) {
+            last[s] = !read(s);
+            sethelper(s, READ);
+            if (last[s]) return;
+        }
+    });
+    thread writer([&] {
+        for (int s = 0; waithelper(s, WORKED); s = (s + 1) % PIPELINE_SLOTS) {
+            if (!write(s)) {
+                lock_guard<mutex> lock(mtx);
+                stopping = true;
+                changed.notify_all();
+                return;
+            }
+            bool end = last[s];
+            sethelper(s, FREE);
+            if (end) return;
+        }
+    });
+    for (int s = 0; waithelper(s, READ); s = (s + 1) % PIPELINE_SLOTS) {
+        work(s);
+        bool end = last[s];
+        sethelper(s, WORKED);
+        if (end) break;
+    }
+    reader.join();
+    writer.join();
+    return !stopping;
+}
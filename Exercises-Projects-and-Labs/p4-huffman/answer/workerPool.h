@@ -0,0 +1,55 @@
+#ifndef P4_WORKERPOOL_H
+#define P4_WORKERPOOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class WorkerPool {
+    // A fixed set of threads that run batches of independent jobs.
+
+    std::vector<std::thread> threads;
+    std::mutex mtx;
+    std::condition_variable wake, done;
+    std::function<void(size_t)> job;
+    size_t next, total, finished;
+    unsigned long generation;
+    bool stopping;
+
+    void work();
+
+public:
+    explicit WorkerPool(unsigned n);
+    // REQUIRES: n >= 1
+    // EFFECTS: Starts n - 1 worker threads; the caller of run() is the n-th.
+
+    ~WorkerPool();
+    // EFFECTS: Stops and joins the worker threads.
+
+    void run(size_t count, const std::function<void(size_t)> &fn);
+    // EFFECTS: Calls fn(0) ... fn(count - 1), spread over the threads, and
+    //          returns once every call has returned.
+
+    unsigned size() const;
+    // EFFECTS: Returns the number of threads running jobs, the caller included.
+};
+
+const int PIPELINE_SLOTS = 3;             // One batch for each stage
+
+bool runPipeline(const std::function<bool(int)> &read, const std::function<void(int)> &work,
+                 const std::function<bool(int)> &write);
+// EFFECTS: Passes batches through three stages, each on a thread of its own,
+//          so that reading, working and writing overlap: read(s) fills slot s
+//          with the next batch, then work(s) runs on the calling thread and
+//          write(s) writes the batch and frees the slot. Batches take the
+//          PIPELINE_SLOTS slots in turn, so that read() can fill one slot
+//          while work() uses the next and write() drains the one after. The
+//          batch for which read() returns false is the last; it still goes
+//          through work() and write(). Stops early, and returns false, if
+//          write() returns false; otherwise returns true once every batch is
+//          written.
+
+#endif
@@ -0,0 +1,158 @@
+import argparse
+import os
+import random
+import subprocess
+import sys
+import time
+
+# Benchmark for the compress/decompress executables. Generates corpora of
+# several kinds and sizes, runs every mode on each and reports throughput,
+# compression ratio and peak resident memory.
+#
+#   python3 benchmark.py --bin <build directory> [--sizes 1M,16M] [--kinds uniform,zipf]
+#
+# or "make benchmark" in the build directory.
+
+KINDS = ['text', 'uniform', 'zipf', 'skewed', 'log']
+
+# Alphabet of generate.py; the only corpus the legacy text tree format can hold
+TEXT_CHARS = b'abcdefghijklmnopqrstuwxyz \n'
+
+# name, compress arguments, decompress arguments (None: legacy text decoder)
+MODES = [
+    ('ascii', [], None),
+    ('packed', ['-binary'], ['-binary']),
+    ('canonical', ['-canonical'], ['-binary']),
+    ('framed', ['-stream'], ['-binary']),
+    ('framed-j4', ['-stream', '-j', '4'], ['-binary', '-j', '4']),
+    ('interleaved', ['-interleave'], ['-binary']),
+]
+
+LOG_LEVELS = ['INFO', 'INFO', 'INFO', 'DEBUG', 'WARN', 'ERROR']
+LOG_WORDS = ['request', 'served', 'user', 'session', 'cache', 'miss', 'hit', 'timeout',
+             'connection', 'closed', 'opened', 'GET', 'POST', '/api/v1/items', '/login', 'ms']
+
+
+def parse_size(text):
+    units = {'K': 1 << 10, 'M': 1 << 20, 'G': 1 << 30}
+    if text[-1].upper() in units:
+        return int(text[:-1]) * units[text[-1].upper()]
+    return int(text)
+
+
+def generate(kind, size, path):
+    # Write "size" bytes of the given kind to path, in 1 MiB pieces
+    rng = random.Random(280)
+    chunk = 1 << 20
+    with open(path, 'wb') as f:
+        left = size
+        while left > 0:
+            n = min(chunk, left)
+            if kind == 'text':
+                data = bytes(rng.choice(TEXT_CHARS) for _ in range(n))
+            elif kind == 'uniform':
+                data = bytes(rng.getrandbits(8) for _ in range(n))
+            elif kind == 'zipf':
+                weights = [1.0 / (r + 1) for r in range(256)]
+                data = bytes(rng.choices(range(256), weights, k=n))
+            elif kind == 'skewed':
+                # Mostly zero bytes with a few rare values, like sparse binaries
+                data = bytes(rng.choices([0, 255, 1, 2, 3, 4], [90, 5, 2, 1, 1, 1], k=n))
+            else:
+                lines = []
+                length = 0
+                while length < n:
+                    line = '2025-%02d-%02d %02d:%02d:%02d %s worker-%d %s\n' % (
+                        rng.randint(1, 12), rng.randint(1, 28), rng.randint(0, 23),
+                        rng.randint(0, 59), rng.randint(0, 59), rng.choice(LOG_LEVELS),
+                        rng.randint(1, 16), ' '.join(rng.choice(LOG_WORDS) for _ in range(6)))
+                    lines.append(line)
+                    length += len(line)
+                data = ''.join(lines).encode()[:n]
+            f.write(data)
+            left -= n
+
+
+def peak_rss(pid):
+    # Return the resident high-water mark of a running process in KiB, or 0
+    try:
+        with open('/proc/%d/status' % pid) as f:
+            for line in f:
+                if line.startswith('VmHWM:'):
+                    return int(line.split()[1])
+    except (IOError, OSError):
+        pass
+    return 0
+
+
+def run(argv, stdin_path, stdout_path):
+    # Run argv and return (seconds, peak RSS in KiB). The rusage of a child
+    # would include this interpreter's own size, so the child's high-water
+    # mark is sampled from /proc instead; it is monotonic, and only growth in
+    # the last few milliseconds before exit can be missed.
+    actions = [(os.POSIX_SPAWN_OPEN, 0, stdin_path, os.O_RDONLY, 0),
+               (os.POSIX_SPAWN_OPEN, 1, stdout_path, os.O_WRONLY | os.O_CREAT | os.O_TRUNC, 0o644)]
+    start = time.time()
+    pid = os.posix_spawn(argv[0], argv, os.environ, file_actions=actions)
+    peak = 0
+    while True:
+        done, status = os.waitpid(pid, os.WNOHANG)
+        if done:
+            break
+        peak = max(peak, peak_rss(pid))
+        time.sleep(0.002)
+    elapsed = time.time() - start
+    code = os.WEXITSTATUS(status) if os.WIFEXITED(status) else -1
+    if code != 0:
+        raise RuntimeError('%s exited with %d' % (' '.join(argv), code))
+    return elapsed, peak
+
+
+def benchmark(bindir, kind, size, workdir):
+    compress = os.path.join(bindir, 'p4-huffman-compress')
+    decompress = os.path.join(bindir, 'p4-huffman-decompress')
+    src = os.path.join(workdir, '%s-%d.in' % (kind, size))
+    if not os.path.exists(src):
+        generate(kind, size, src)
+    archive = os.path.join(workdir, 'archive')
+    tree = os.path.join(workdir, 'tree')
+    out = os.path.join(workdir, 'out')
+    mb = size / float(1 << 20)
+    for name, cargs, dargs in MODES:
+        ctime, crss = run([compress] + cargs + [src], os.devnull, archive)
+        ratio = os.path.getsize(archive) / float(size)
+        if dargs is None and kind != 'text':
+            # The text tree format cannot hold ',', '-' or digits as symbols,
+            # so the legacy decoder is only timed on the text corpus
+            print('%-8s %8s %-11s %9.1f %9s %7.3f %8d %8s' % (
+                kind, '%dK' % (size >> 10), name, mb / ctime, '-', ratio, crss, '-'))
+            continue
+        if dargs is None:
+            run([compress, '-tree', src], os.devnull, tree)
+            dtime, drss = run([decompress, tree, archive], os.devnull, out)
+        else:
+            dtime, drss = run([decompress] + dargs + [archive], os.devnull, out)
+        if subprocess.call(['cmp', '-s', src, out]) != 0:
+            raise RuntimeError('%s round trip failed on %s' % (name, src))
+        print('%-8s %8s %-11s %9.1f %9.1f %7.3f %8d %8d' % (
+            kind, '%dK' % (size >> 10), name, mb / ctime, mb / dtime, ratio, crss, drss))
+        sys.stdout.flush()
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Benchmark the huffman codec.')
+    parser.add_argument('--bin', required=True, help='directory holding the executables')
+    parser.add_argument('--sizes', default='1M', help='comma-separated sizes, e.g. 1M,64M,1G')
+    parser.add_argument('--kinds', default=','.join(KINDS), help='comma-separated corpus kinds')
+    parser.add_argument('--workdir', default='.', help='directory for corpora and outputs')
+    args = parser.parse_args()
+    os.makedirs(args.workdir, exist_ok=True)
+    print('%-8s %8s %-11s %9s %9s %7s %8s %8s' % (
+        'corpus', 'size', 'mode', 'comp MB/s', 'dec MB/s', 'ratio', 'comp KiB', 'dec KiB'))
+    for kind in args.kinds.split(','):
+        for size in args.sizes.split(','):
+            benchmark(args.bin, kind, parse_size(size), args.workdir)
+
+
+if __name__ == '__main__':
+    main()
@@ -2,12 +2,10 @@
 // Created by liu on 19-7-11.
 //
 
-#include <functional>
-
 #include "board.h"
 #include "exceptions.h"
 
-Board::Board() {
+Board::Board() : occupied(0), attributes() {
     for (int i = 0; i < 4; i++) {
         for (int j = 0; j < 4; j++) {
             this->grid[i][j] = Square(Vaxis(i), Haxis(j));
@@ -15,6 +13,18 @@ Board::Board() {
     }
 }
 
+void Board::reset() {
+    for (auto &row : this->grid) {
+        for (auto &square : row) {
+            square.setPiece(nullptr);
+        }
+    }
+    this->occupied = 0;
+    for (auto &attribute : this->attributes) {
+        attribute = 0;
+    }
+}
+
 Square &Board::getSquare(Vaxis v, Haxis h) {
     return this->grid[v][h];
 }
@@ -39,55 +49,55 @@ Square &Board::getEmptySquare(const std::string &s) {
     return getEmptySquare(Vaxis(v), Haxis(h));
 }
 
+unsigned int Board::emptyMask() const {
+    return ~this->occupied & ((1u << NP) - 1);
+}
+
 void Board::place(Piece &p, Square &sq) {
     sq.setPiece(&p);
     p.setUsed(true);
+    unsigned int bit = 1u << (sq.getV() * N + sq.getH());
+    unsigned int code = p.getCode();
+    this->occupied |= bit;
+    for (int i = 0; i < N; i++) {
+        if (code >> i & 1u) this->attributes[i] |= bit;
+    }
 }
 
-typedef bool (Piece::*PieceComparator)(const Piece &) const;
-
-const static PieceComparator pieceComparators[] = {
-        &Piece::compareHeight,
-        &Piece::compareColor,
-        &Piece::compareShape,
-        &Piece::compareTop,
-};
-
-static bool
-haveSameAttr(const PieceComparator &comp, const Piece &piece, const Square &square1, const Square &square2) {
-    if (square1.getV() == square2.getV() && square1.getH() == square2.getH()) return true;
-    return ((piece).*(comp))(square2.getPiece());
+void Board::remove(Piece &p, Square &sq) {
+    sq.setPiece(nullptr);
+    p.setUsed(false);
+    unsigned int bit = 1u << (sq.getV() * N + sq.getH());
+    this->occupied &= ~bit;
+    for (auto &attribute : this->attributes) {
+        attribute &= ~bit;
+    }
 }
 
-template<typename... Args>
-static bool haveSameAttr(const PieceComparator &comp, const Piece &piece, const Square &square1,
-                         const Square &square2, Args... args) {
-    return haveSameAttr(comp, piece, square1, square2) && haveSameAttr(comp, piece, square1, args...);
-}
+// the rows, the columns, and the two diagonals, as bitboards
+const static unsigned int lineMasks[] = {
+        0x000f, 0x00f0, 0x0f00, 0xf000,
+        0x1111, 0x2222, 0x4444, 0x8888,
+        0x8421, 0x1248,
+};
 
-template<typename ...Args>
-static bool haveSame(const Piece &piece, const Square &square, Args... args) {
-    try {
-        for (int i = 0; i < 4; i++) {
-            if (haveSameAttr(pieceComparators[i], piece, square, args...)) {
-                return true;
-            }
+bool Board::isWinning(unsigned int occupied, const unsigned int attributes[N], unsigned int code,
+                      int square) {
+    unsigned int bit = 1u << square;
+    occupied |= bit;
+    for (auto line : lineMasks) {
+        if ((line & bit) == 0 || (occupied & line) != line) continue;
+        for (int i = 0; i < N; i++) {
+            // the pieces of a full line share an attribute if they all have its bit, or none has
+            unsigned int set = (attributes[i] | (code >> i & 1u ? bit : 0u)) & line;
+            if (set == line || set == 0) return true;
         }
-    } catch (const SquareException &e) {
-        return false;
     }
     return false;
 }
 
 bool Board::isWinning(const Piece &p, const Square &sq) {
-    auto v = sq.getV();
-    auto h = sq.getH();
-    return haveSame(p, sq, this->grid[v][0], this->grid[v][1], this->grid[v][2], this->grid[v][3]) ||
-           haveSame(p, sq, this->grid[0][h], this->grid[1][h], this->grid[2][h], this->grid[3][h]) ||
-           (sq.isOnFirstDiagonal() &&
-            haveSame(p, sq, this->grid[0][0], this->grid[1][1], this->grid[2][2], this->grid[3][3])) ||
-           (sq.isOnSecondDiagonal() &&
-            haveSame(p, sq, this->grid[0][3], this->grid[1][2], this->grid[2][1], this->grid[3][0]));
+    return isWinning(this->occupied, this->attributes, p.getCode(), sq.getV() * N + sq.getH());
 }
 
 std::string Board::toString() const {
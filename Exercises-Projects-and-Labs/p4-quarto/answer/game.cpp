@@ -2,54 +2,154 @@
 // Created by liu on 19-7-11.
 //
 
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
 #include <iostream>
+#include <string>
+#include <thread>
 
 #include "board.h"
 #include "player.h"
 
 using namespace std;
 
-Player *getPlayer(Board *b, Pool *p, const char *type, unsigned int seed) {
+Player *getPlayer(Board *b, Pool *p, const char *type, unsigned int seed, int depth, int timeMs,
+                  int threads, bool ponder = false) {
     if (type[0] == 'h') {
         return getHumanPlayer(b, p);
     }
+    if (string(type) == "mcts") {
+        return getMCTSPlayer(b, p, timeMs, threads, seed);
+    }
+    if (type[0] == 's') {
+        return getSearchPlayer(b, p, depth, timeMs, threads, ponder);
+    }
     return getMyopicPlayer(b, p, seed);
 }
 
 
-int main(int argc, char *argv[]) {
-    Board board;
-    Pool pool;
-    unsigned int seed = argc >= 4 ? strtoul(argv[3], nullptr, 10) : 0;
-    Player *players[2] = {
-            getPlayer(&board, &pool, argv[1], seed),
-            getPlayer(&board, &pool, argv[2], seed)
-    };
-
-    cout << board.toString() << endl;
-    cout << pool.toString() << endl;
+// Plays one game on "board" and "pool", printing it when verbose, and returns the index of the
+// winner, or -1 for a draw; "moves" counts the pieces placed
+template<bool verbose>
+int playGame(Board &board, Pool &pool, Player *players[2], long long &moves) {
+    if (verbose) {
+        cout << board.toString() << endl;
+        cout << pool.toString() << endl;
+    }
 
     for (int n = 0; n < NP; n++) {
         int i = n % 2;
         int j = 1 - i;
 
-        cout << "Player " << i + 1 << "'s turn to select a piece:" << endl;
+        if (verbose) cout << "Player " << i + 1 << "'s turn to select a piece:" << endl;
         auto &piece = players[i]->selectPiece();
-        cout << piece.toString() << " selected." << endl << endl;
+        if (verbose) cout << piece.toString() << " selected." << endl << endl;
 
-        cout << "Player " << j + 1 << "'s turn to select a square:" << endl;
+        if (verbose) cout << "Player " << j + 1 << "'s turn to select a square:" << endl;
         auto &square = players[j]->selectSquare(piece);
-        cout << square.toString() << " selected." << endl << endl;
+        if (verbose) cout << square.toString() << " selected." << endl << endl;
 
         board.place(piece, square);
-        cout << board.toString() << endl;
-        cout << pool.toString() << endl;
+        moves++;
+        if (verbose) {
+            cout << board.toString() << endl;
+            cout << pool.toString() << endl;
+        }
 
         if (board.isWinning(piece, square)) {
-            cout << "Player " << j + 1 << " has won!" << endl;
-            return 0;
+            if (verbose) cout << "Player " << j + 1 << " has won!" << endl;
+            return j;
         }
     }
-    cout << "It is a draw." << endl;
+    if (verbose) cout << "It is a draw." << endl;
+    return -1;
+}
+
+// Plays "games" games without printing them, on one board and pool reset between games, and
+// reports how they ended
+int selfPlay(long long games, const char *first, const char *second, unsigned int seed, int depth,
+             int timeMs, int threads) {
+    Board board;
+    Pool pool;
+    Player *players[2] = {
+            getPlayer(&board, &pool, first, seed, depth, timeMs, threads),
+            getPlayer(&board, &pool, second, seed, depth, timeMs, threads)
+    };
+    long long wins[2] = {}, draws = 0, moves = 0;
+    auto start = chrono::steady_clock::now();
+    for (long long game = 0; game < games; game++) {
+        board.reset();
+        pool.reset();
+        int winner = playGame<false>(board, pool, players, moves);
+        if (winner < 0) {
+            draws++;
+        } else {
+            wins[winner]++;
+        }
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    auto rate = [games](long long n) { return games ? 100.0 * n / games : 0.0; };
+    cout << fixed << setprecision(2);
+    cout << "Games: " << games << endl;
+    cout << "Player 1 (" << first << ") won: " << wins[0] << " (" << rate(wins[0]) << "%)" << endl;
+    cout << "Player 2 (" << second << ") won: " << wins[1] << " (" << rate(wins[1]) << "%)" << endl;
+    cout << "Draws: " << draws << " (" << rate(draws) << "%)" << endl;
+    cout << "Moves per game: " << (games ? (double) moves / games : 0.0) << endl;
+    cout << setprecision(0);
+    cout << "Moves per second: " << (seconds > 0 ? moves / seconds : 0.0) << endl;
+    cout << "Games per second: " << (seconds > 0 ? games / seconds : 0.0) << endl;
+    return 0;
+}
+
+// Lets the search player probe the tablebase of "file"
+bool loadTablebase(const char *file) {
+    if (loadSearchTablebase(file)) return true;
+    cerr << "Cannot load the tablebase " << file << endl;
+    return false;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc >= 4 && string(argv[1]) == "tablebase") {
+        // ./p4-quarto tablebase <file> <positions> [<seed> [<empty>]]
+        unsigned int seed = argc >= 5 ? strtoul(argv[4], nullptr, 10) : 0;
+        int empty = argc >= 6 ? atoi(argv[5]) : 8;
+        auto written = writeSearchTablebase(argv[2], strtoll(argv[3], nullptr, 10), seed, max(1, min(empty, NP)));
+        if (written < 0) {
+            cerr << "Cannot write the tablebase " << argv[2] << endl;
+            return 1;
+        }
+        cout << written << " positions with " << empty << " empty squares written" << endl;
+        return 0;
+    }
+
+    if (argc >= 5 && string(argv[1]) == "selfplay") {
+        // ./p4-quarto selfplay <games> <player1> <player2> [<seed> [<depth> [<timeMs> [<threads> [<tablebase>]]]]]
+        unsigned int seed = argc >= 6 ? strtoul(argv[5], nullptr, 10) : 0;
+        int depth = argc >= 7 ? atoi(argv[6]) : 2;
+        int timeMs = argc >= 8 ? atoi(argv[7]) : 0;
+        int threads = argc >= 9 ? atoi(argv[8]) : 1;
+        if (argc >= 10 && !loadTablebase(argv[9])) return 1;
+        return selfPlay(strtoll(argv[2], nullptr, 10), argv[3], argv[4], seed, depth, timeMs, threads);
+    }
+
+    Board board;
+    Pool pool;
+    unsigned int seed = argc >= 4 ? strtoul(argv[3], nullptr, 10) : 0;
+    // the search player looks "depth" placements ahead, then deeper for "timeMs" milliseconds,
+    // on "threads" threads
+    int depth = argc >= 5 ? atoi(argv[4]) : 2;
+    int timeMs = argc >= 6 ? atoi(argv[5]) : 1000;
+    int threads = argc >= 7 ? atoi(argv[6]) : (int) thread::hardware_concurrency();
+    if (argc >= 8 && !loadTablebase(argv[7])) return 1;
+    // the search player ponders while a human decides, who leaves the machine idle
+    bool ponder = argv[1][0] == 'h' || argv[2][0] == 'h';
+    Player *players[2] = {
+            getPlayer(&board, &pool, argv[1], seed, depth, timeMs, threads, ponder),
+            getPlayer(&board, &pool, argv[2], seed, depth, timeMs, threads, ponder)
+    };
+    long long moves = 0;
+    playGame<true>(board, pool, players, moves);
     return 0;
-}
\ No newline at end of file
+}
@@ -22,6 +22,10 @@ bool Piece::compareTop(const Piece &p) const {
     return this->t == p.t;
 }
 
+unsigned int Piece::getCode() const {
+    return this->h | this->c << 1 | this->s << 2 | this->t << 3;
+}
+
 bool Piece::isUsed() const {
     return this->used;
 }
@@ -3,8 +3,18 @@
 //
 
 #include <iostream>
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 #include "player.h"
+#include "tablebase.h"
 #include "quarto.h"
 
 class HumanPlayer : public Player {
@@ -55,18 +65,7 @@ private:
         Pieces() = default;
 
         explicit Pieces(const MyopicPlayer *player) {
-            for (auto h:{SHORT, TALL}) {
-                for (auto c:{BEIGE, SEPIA}) {
-                    for (auto s:{CIRCLE, SQUARE}) {
-                        for (auto t:{HOLLOW, SOLID}) {
-                            try {
-                                auto &piece = player->pool->getUnusedPiece(h, c, s, t);
-                                this->addPiece(piece);
-                            } catch (const std::exception &e) {}
-                        }
-                    }
-                }
-            }
+            player->pool->forEachUnused([this](Piece &piece) { this->addPiece(piece); });
         }
 
         void addPiece(Piece &piece) {
@@ -81,12 +80,10 @@ private:
         Squares() = default;
 
         explicit Squares(MyopicPlayer *player) {
-            for (auto v:{A, B, C, D}) {
-                for (auto h:{H1, H2, H3, H4}) {
-                    try {
-                        auto &square = player->board->getEmptySquare(v, h);
-                        this->addSquare(square);
-                    } catch (const std::exception &e) {}
+            auto empty = player->board->emptyMask();
+            for (int i = 0; i < NP; i++) {
+                if (empty >> i & 1u) {
+                    this->addSquare(player->board->getSquare(Vaxis(i / N), Haxis(i % N)));
                 }
             }
         }
@@ -151,8 +148,821 @@ public:
     }
 };
 
+// a board in bitboards, with the pieces left to give by their codes
+struct Position {
+    unsigned int occupied = 0;
+    unsigned int attributes[N] = {};
+    unsigned int unused = 0;
+};
+
+static int count(unsigned int mask) {
+    int n = 0;
+    for (; mask; mask &= mask - 1) n++;
+    return n;
+}
+
+static void place(Position &pos, unsigned int code, int square) {
+    unsigned int bit = 1u << square;
+    pos.occupied |= bit;
+    for (int i = 0; i < N; i++) {
+        if (code >> i & 1u) pos.attributes[i] |= bit;
+    }
+}
+
+static Position position(Board *board, Pool *pool) {
+    Position pos;
+    pool->forEachUnused([&pos](Piece &piece) { pos.unused |= 1u << piece.getCode(); });
+    auto empty = board->emptyMask();
+    for (int i = 0; i < NP; i++) {
+        if (empty >> i & 1u) continue;
+        place(pos, board->getSquare(Vaxis(i / N), Haxis(i % N)).getPiece().getCode(), i);
+    }
+    return pos;
+}
+
+static Piece &unusedPiece(Pool *pool, int code) {
+    return pool->getUnusedPiece(Height(code & 1), Color(code >> 1 & 1), Shape(code >> 2 & 1), Top(code >> 3 & 1));
+}
+
+class SearchPlayer : public Player {
+private:
+    // a position up to the symmetries of the game: the board under one of the 32 maps of its
+    // squares that keep the lines, the attributes flipped so that the piece to place is 0000,
+    // and put in the order of their bitboards
+    struct Canonical {
+        uint64_t key = 0;
+        int symmetry = 0;
+        unsigned int flips = 0;
+        int order[N] = {};
+    };
+
+    // a move is a square to place the given piece on and the piece given next,
+    // either -1 if there is none
+    struct Move {
+        int square;
+        int piece;
+    };
+
+    enum Bound : uint8_t {
+        EXACT, LOWER, UPPER
+    };
+
+    struct Entry {
+        uint64_t key;
+        int16_t value;
+        int8_t depth;
+        Bound bound;
+        uint8_t move;
+    };
+
+    // an entry shared by the threads without locks: the key is stored XORed with the packed
+    // entry, so an entry torn by two writers fails the key check
+    struct Slot {
+        std::atomic<uint64_t> check;
+        std::atomic<uint64_t> data;
+    };
+
+    // a win scores more the earlier it comes, by the empty squares left
+    static const int WIN = 100;
+    static const int INFINITE = 1000;
+    static const size_t TABLE_SIZE = size_t(1) << 20;
+    static const unsigned int CHECK_NODES = 1024;
+    static const int SYMMETRIES = 32;
+    static const int SYMMETRY_LEFT = 12;
+
+    int depth = 0;
+    int timeMs = 0;
+    int threads = 1;
+    // the maps of the squares and their inverses, with the maps of the bitboards by byte
+    int squareMaps[SYMMETRIES][NP] = {};
+    int inverseMaps[SYMMETRIES][NP] = {};
+    uint16_t byteMaps[SYMMETRIES][2][256] = {};
+    std::unique_ptr<Slot[]> table;
+    Tablebase tablebase;
+
+    std::chrono::steady_clock::time_point deadline;
+    bool timed = false;
+    std::atomic<bool> aborted{false};
+
+    // the piece chosen by the last search, and the board it is meant for
+    int nextPiece = -1;
+    unsigned int nextOccupied = 0;
+
+    // a reply of the opponent searched while pondering, up to the symmetries of the game: the
+    // key of its canonical position, and the move found for it as a move of that position,
+    // which gives a piece unless the placement ends the game
+    struct Pondered {
+        uint64_t key;
+        uint8_t move;
+        bool gives;
+    };
+
+    // whether to search the opponent's replies while it decides, the thread that does, and
+    // the replies it searched to the end; "stopping" is set once the opponent has moved
+    bool pondering = false;
+    std::thread ponderer;
+    std::mutex ponderMutex;
+    bool stopping = false;
+    std::vector<Pondered> pondered;
+
+    static uint64_t mix(uint64_t z) {
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+
+    unsigned int mapMask(int symmetry, unsigned int mask) const {
+        return this->byteMaps[symmetry][0][mask & 0xffu] | this->byteMaps[symmetry][1][mask >> 8];
+    }
+
+    // the smallest image of "pos" with "code" to place under the first "symmetries" maps, the
+    // first being the identity, comparing the occupied squares first
+    Canonical canonical(const Position &pos, unsigned int code, int symmetries = SYMMETRIES) const {
+        unsigned int planes[N];
+        for (int i = 0; i < N; i++) {
+            planes[i] = pos.attributes[i] ^ (code >> i & 1u ? pos.occupied : 0u);
+        }
+        Canonical best;
+        unsigned int bestOccupied = ~0u;
+        uint64_t bestPlanes = ~uint64_t(0);
+        for (int g = 0; g < symmetries; g++) {
+            unsigned int occupied = this->mapMask(g, pos.occupied);
+            if (occupied > bestOccupied) continue;
+            unsigned int mapped[N];
+            int order[N];
+            for (int i = 0; i < N; i++) {
+                mapped[i] = this->mapMask(g, planes[i]);
+                int j = i;
+                for (; j > 0 && mapped[order[j - 1]] < mapped[i]; j--) order[j] = order[j - 1];
+                order[j] = i;
+            }
+            uint64_t packed = 0;
+            for (int i = 0; i < N; i++) packed = packed << 16 | mapped[order[i]];
+            if (occupied < bestOccupied || packed < bestPlanes) {
+                bestOccupied = occupied;
+                bestPlanes = packed;
+                best.symmetry = g;
+                std::copy(order, order + N, best.order);
+            }
+        }
+        best.flips = code;
+        best.key = mix(bestPlanes ^ mix(bestOccupied));
+        return best;
+    }
+
+    // a move of "pos" as a move of its canonical position, and back
+    uint8_t toCanonical(const Canonical &c, const Move &move) const {
+        unsigned int piece = unsigned(move.piece) ^ c.flips, mapped = 0;
+        for (int i = 0; i < N; i++) mapped |= (piece >> c.order[i] & 1u) << i;
+        return uint8_t(this->squareMaps[c.symmetry][move.square] << 4 | mapped);
+    }
+
+    Move fromCanonical(const Canonical &c, uint8_t move) const {
+        unsigned int piece = 0;
+        for (int i = 0; i < N; i++) piece |= (move >> i & 1u) << c.order[i];
+        return {this->inverseMaps[c.symmetry][move >> 4], int(piece ^ c.flips)};
+    }
+
+    bool outOfTime(unsigned long &nodes) {
+        if (!this->timed || ++nodes % CHECK_NODES != 0) return this->aborted.load(std::memory_order_relaxed);
+        if (std::chrono::steady_clock::now() >= this->deadline) this->aborted = true;
+        return this->aborted;
+    }
+
+    bool probe(uint64_t key, Entry &entry) const {
+        auto &slot = this->table[key & (TABLE_SIZE - 1)];
+        uint64_t data = slot.data.load(std::memory_order_relaxed);
+        if ((slot.check.load(std::memory_order_relaxed) ^ data) != key) return false;
+        entry = {key, int16_t(data & 0xffffu), int8_t(data >> 16 & 0xffu), Bound(data >> 24 & 0xffu),
+                 uint8_t(data >> 32 & 0xffu)};
+        return true;
+    }
+
+    void store(const Entry &entry) {
+        auto &slot = this->table[entry.key & (TABLE_SIZE - 1)];
+        uint64_t data = uint64_t(uint16_t(entry.value)) | uint64_t(uint8_t(entry.depth)) << 16 |
+                        uint64_t(entry.bound) << 24 | uint64_t(entry.move) << 32;
+        slot.check.store(entry.key ^ data, std::memory_order_relaxed);
+        slot.data.store(data, std::memory_order_relaxed);
+    }
+
+    // the value of "pos" for the player who places "code", from their side
+    int search(const Position &pos, unsigned int code, int depth, int alpha, int beta, unsigned long &nodes) {
+        if (outOfTime(nodes)) return 0;
+        unsigned int empty = ~pos.occupied & ((1u << NP) - 1);
+        int left = count(empty);
+        for (int i = 0; i < NP; i++) {
+            if ((empty >> i & 1u) && Board::isWinning(pos.occupied, pos.attributes, code, i)) {
+                return WIN + left;
+            }
+        }
+        int solved;
+        if (left == this->tablebase.emptySquares() &&
+            this->tablebase.probe(this->canonical(pos, code).key, solved)) {
+            return solved;
+        }
+        if (pos.unused == 0 || depth == 0) return 0;
+        // once the opponent cannot win on its next placement, this player cannot do better than
+        // a win on the one after
+        beta = std::min(beta, WIN + left - 2);
+        if (alpha >= beta) return beta;
+
+        // a full board has few images equal to other positions on the way, so there the maps
+        // cost more than they save
+        auto c = this->canonical(pos, code, left >= SYMMETRY_LEFT ? SYMMETRIES : 1);
+        Entry entry;
+        Move hint = {-1, -1};
+        if (this->probe(c.key, entry)) {
+            hint = this->fromCanonical(c, entry.move);
+            if (entry.depth >= depth) {
+                if (entry.bound == EXACT) return entry.value;
+                if (entry.bound == LOWER) alpha = std::max(alpha, int(entry.value));
+                else beta = std::min(beta, int(entry.value));
+                if (alpha >= beta) return entry.value;
+            }
+        }
+
+        int original = alpha;
+        int best = -INFINITE;
+        Move bestMove = {-1, -1};
+        auto visit = [&](int square, int piece) {
+            Position next = pos;
+            place(next, code, square);
+            next.unused &= ~(1u << piece);
+            int value = -search(next, piece, depth - 1, -beta, -alpha, nodes);
+            if (value > best) {
+                best = value;
+                bestMove = {square, piece};
+                alpha = std::max(alpha, value);
+            }
+            return alpha >= beta;
+        };
+        // the move of the table is tried first
+        bool cut = hint.square >= 0 && (empty >> hint.square & 1u) && (pos.unused >> hint.piece & 1u) &&
+                   visit(hint.square, hint.piece);
+        for (int i = 0; i < NP && !cut && !this->aborted; i++) {
+            if (!(empty >> i & 1u)) continue;
+            for (int q = 0; q < NP && !cut && !this->aborted; q++) {
+                if (!(pos.unused >> q & 1u) || (i == hint.square && q == hint.piece)) continue;
+                cut = visit(i, q);
+            }
+        }
+        if (this->aborted) return 0;
+
+        this->store({c.key, int16_t(best), int8_t(depth),
+                     best <= original ? UPPER : best >= beta ? LOWER : EXACT, this->toCanonical(c, bestMove)});
+        return best;
+    }
+
+    // the best move for the player who places "code" on "pos", or with no square when "code"
+    // is -1 and only the piece to give is chosen; when pondering, "aborted" is left to ponder()
+    Move deepen(const Position &pos, int code, bool ponder = false) {
+        std::vector<Move> moves;
+        if (code >= 0) {
+            for (int i = 0; i < NP; i++) {
+                if (pos.occupied >> i & 1u) continue;
+                if (Board::isWinning(pos.occupied, pos.attributes, code, i)) return {i, -1};
+                if (pos.unused == 0) return {i, -1};
+                for (int q = 0; q < NP; q++) {
+                    if (pos.unused >> q & 1u) moves.push_back({i, q});
+                }
+            }
+        } else {
+            for (int q = 0; q < NP; q++) {
+                if (pos.unused >> q & 1u) moves.push_back({-1, q});
+            }
+        }
+
+        this->timed = false;
+        if (!ponder) this->aborted = false;
+        Move chosen = moves.front();
+        int left = count(~pos.occupied & ((1u << NP) - 1));
+        for (int d = 1; d <= left; d++) {
+            if (d > this->depth) {
+                // past the fixed depth, the budget decides how far the search goes
+                if (this->timeMs <= 0) break;
+                if (!this->timed) {
+                    this->timed = true;
+                    this->deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(this->timeMs);
+                }
+            }
+            // the first move is searched alone for a bound, then the threads take the others
+            // in turn with the best bound so far; a move only counts if it beat that bound
+            std::vector<int> values(moves.size(), -INFINITE);
+            std::atomic<int> alpha{-INFINITE};
+            std::atomic<size_t> next{1};
+            auto visit = [&](size_t i, unsigned long &nodes) {
+                Position child = pos;
+                if (code >= 0) place(child, unsigned(code), moves[i].square);
+                child.unused &= ~(1u << moves[i].piece);
+                int bound = alpha.load();
+                int value = -search(child, unsigned(moves[i].piece), d - 1, -INFINITE, -bound, nodes);
+                if (this->aborted || value <= bound) return;
+                values[i] = value;
+                while (value > bound && !alpha.compare_exchange_weak(bound, value)) {}
+            };
+            auto work = [&]() {
+                unsigned long nodes = 0;
+                for (size_t i; !this->aborted && (i = next++) < moves.size();) visit(i, nodes);
+            };
+            unsigned long nodes = 0;
+            visit(0, nodes);
+            std::vector<std::thread> workers;
+            for (int t = 1; t < this->threads; t++) workers.emplace_back(work);
+            work();
+            for (auto &worker : workers) worker.join();
+            if (this->aborted) break;
+            size_t best = size_t(std::max_element(values.begin(), values.end()) - values.begin());
+            // the best move is tried first by the next iteration
+            std::swap(moves[0], moves[best]);
+            chosen = moves[0];
+            // a forced result, or a search to the end of the game, is exact
+            if (values[best] >= WIN || values[best] <= -WIN || d >= left) break;
+        }
+        return chosen;
+    }
+
+    // builds the maps of the symmetries and the table, once
+    void prepare() {
+        if (this->table) return;
+        this->table.reset(new Slot[TABLE_SIZE]());
+        // a map keeps the lines if it sends (v, h) to (p[v], q[h]), maybe transposed, where
+        // p commutes with the reversal of the axes and q is p or p reversed
+        int p[N] = {0, 1, 2, 3};
+        int g = 0;
+        do {
+            bool commutes = true;
+            for (int i = 0; i < N; i++) commutes &= p[N - 1 - i] == N - 1 - p[i];
+            if (!commutes) continue;
+            for (int reversed = 0; reversed < 2; reversed++) {
+                for (int transposed = 0; transposed < 2; transposed++, g++) {
+                    for (int i = 0; i < NP; i++) {
+                        int v = p[i / N], h = reversed ? N - 1 - p[i % N] : p[i % N];
+                        int image = transposed ? h * N + v : v * N + h;
+                        this->squareMaps[g][i] = image;
+                        this->inverseMaps[g][image] = i;
+                    }
+                    for (int half = 0; half < 2; half++) {
+                        for (int byte = 0; byte < 256; byte++) {
+                            uint16_t mask = 0;
+                            for (int i = 0; i < 8; i++) {
+                                if (byte >> i & 1) mask |= uint16_t(1u << this->squareMaps[g][half * 8 + i]);
+                            }
+                            this->byteMaps[g][half][byte] = mask;
+                        }
+                    }
+                }
+            }
+        } while (std::next_permutation(p, p + N));
+        assert(g == SYMMETRIES);
+    }
+
+    // searches the replies of the opponent, who places "code" on "pos", as selectSquare() would
+    // once one is played, the replies worst for this player after a shallow search first
+    void ponder(Position pos, unsigned int code) {
+        struct Reply {
+            int value;
+            Position pos;
+            unsigned int code;
+            Canonical canonical;
+        };
+        std::vector<Reply> replies;
+        std::vector<uint64_t> keys;
+        unsigned long nodes = 0;
+        for (int i = 0; i < NP; i++) {
+            if ((pos.occupied >> i & 1u) || Board::isWinning(pos.occupied, pos.attributes, code, i)) continue;
+            Position next = pos;
+            place(next, code, i);
+            for (int q = 0; q < NP; q++) {
+                if (!(next.unused >> q & 1u)) continue;
+                Reply reply{0, next, unsigned(q), Canonical()};
+                reply.pos.unused &= ~(1u << q);
+                // the images of a reply under the symmetries are searched once
+                reply.canonical = this->canonical(reply.pos, reply.code);
+                if (std::find(keys.begin(), keys.end(), reply.canonical.key) != keys.end()) continue;
+                keys.push_back(reply.canonical.key);
+                reply.value = this->search(reply.pos, reply.code, 1, -INFINITE, INFINITE, nodes);
+                replies.push_back(reply);
+            }
+        }
+        std::stable_sort(replies.begin(), replies.end(),
+                         [](const Reply &a, const Reply &b) { return a.value < b.value; });
+        for (auto &reply : replies) {
+            {
+                std::lock_guard<std::mutex> lock(this->ponderMutex);
+                if (this->stopping) return;
+                this->aborted = false;
+            }
+            Move move = this->deepen(reply.pos, int(reply.code), true);
+            std::lock_guard<std::mutex> lock(this->ponderMutex);
+            // a search the opponent's move cut short is not the one selectSquare() would make
+            if (this->stopping) return;
+            Move mapped = {move.square, move.piece < 0 ? 0 : move.piece};
+            this->pondered.push_back({reply.canonical.key, this->toCanonical(reply.canonical, mapped), move.piece >= 0});
+        }
+    }
+
+    void startPondering(const Position &pos, unsigned int code) {
+        this->pondered.clear();
+        this->stopping = false;
+        this->aborted = false;
+        this->ponderer = std::thread(&SearchPlayer::ponder, this, pos, code);
+    }
+
+    void stopPondering() {
+        if (!this->ponderer.joinable()) return;
+        {
+            std::lock_guard<std::mutex> lock(this->ponderMutex);
+            this->stopping = true;
+            this->aborted = true;
+        }
+        this->ponderer.join();
+    }
+
+    // a random piece of "pieces" that "pos" lets no one win with, if there is one
+    static int givePiece(const Position &pos, unsigned int pieces) {
+        int safe[NP], all[NP];
+        int safeCount = 0, allCount = 0;
+        for (int q = 0; q < NP; q++) {
+            if (!(pieces >> q & 1u)) continue;
+            all[allCount++] = q;
+            bool wins = false;
+            for (int i = 0; i < NP && !wins; i++) {
+                wins = !(pos.occupied >> i & 1u) && Board::isWinning(pos.occupied, pos.attributes, q, i);
+            }
+            if (!wins) safe[safeCount++] = q;
+        }
+        return safeCount ? safe[rand() % safeCount] : all[rand() % allCount];
+    }
+
+public:
+    SearchPlayer() noexcept : Player(nullptr, nullptr) {}
+
+    ~SearchPlayer() {
+        this->stopPondering();
+    }
+
+    void initialize(Board *b, Pool *p, int d, int t, int n, bool ponder) {
+        if (!this->board) {
+            this->board = b;
+            this->pool = p;
+            this->depth = d;
+            this->timeMs = t;
+            this->threads = std::max(n, 1);
+            this->pondering = ponder;
+            this->prepare();
+        }
+    }
+
+    bool loadTablebase(const char *file) {
+        return this->tablebase.open(file);
+    }
+
+    // plays myopic games until "positions" positions with "empty" empty squares, each with a
+    // piece to place, are met, and solves them to the end
+    long long writeTablebase(const char *file, long long positions, unsigned int seed, int empty) {
+        this->prepare();
+        this->timed = false;
+        this->aborted = false;
+        srand(seed);
+        std::vector<std::pair<uint64_t, int>> values;
+        unsigned long nodes = 0;
+        while ((long long) values.size() < positions) {
+            Position pos;
+            pos.unused = (1u << NP) - 1;
+            unsigned int code = unsigned(givePiece(pos, pos.unused));
+            pos.unused &= ~(1u << code);
+            bool over = false;
+            for (int placed = 0; placed < NP - empty && !over; placed++) {
+                // a random square, unless one wins, which ends the game
+                int squares[NP], count = 0;
+                for (int i = 0; i < NP && !over; i++) {
+                    if (pos.occupied >> i & 1u) continue;
+                    over = Board::isWinning(pos.occupied, pos.attributes, code, i);
+                    squares[count++] = i;
+                }
+                if (over) break;
+                place(pos, code, squares[rand() % count]);
+                code = unsigned(givePiece(pos, pos.unused));
+                pos.unused &= ~(1u << code);
+            }
+            if (over) continue;
+            values.emplace_back(this->canonical(pos, code).key,
+                                this->search(pos, code, empty, -INFINITE, INFINITE, nodes));
+        }
+        if (!Tablebase::write(file, empty, values)) return -1;
+        return (long long) values.size();
+    }
+
+    Piece &selectPiece() override {
+        this->stopPondering();
+        auto pos = position(this->board, this->pool);
+        int piece = this->nextPiece;
+        if (piece < 0 || this->nextOccupied != pos.occupied || !(pos.unused >> piece & 1u)) {
+            piece = this->deepen(pos, -1).piece;
+        }
+        if (this->pondering) {
+            pos.unused &= ~(1u << piece);
+            this->startPondering(pos, unsigned(piece));
+        }
+        return unusedPiece(this->pool, piece);
+    }
+
+    Square &selectSquare(const Piece &p) override {
+        this->stopPondering();
+        auto pos = position(this->board, this->pool);
+        unsigned int code = p.getCode();
+        pos.unused &= ~(1u << code);
+        Move move = {-1, -1};
+        if (!this->pondered.empty()) {
+            auto c = this->canonical(pos, code);
+            for (const auto &reply : this->pondered) {
+                if (reply.key != c.key) continue;
+                move = this->fromCanonical(c, reply.move);
+                if (!reply.gives) move.piece = -1;
+                break;
+            }
+        }
+        // a move of an image that does not fit this position is searched again
+        if (move.square < 0 || (pos.occupied >> move.square & 1u) ||
+            (move.piece >= 0 ? !(pos.unused >> move.piece & 1u) : pos.unused != 0 &&
+             !Board::isWinning(pos.occupied, pos.attributes, code, move.square))) {
+            move = this->deepen(pos, int(code));
+        }
+        this->nextPiece = move.piece;
+        this->nextOccupied = pos.occupied | 1u << move.square;
+        return this->board->getSquare(Vaxis(move.square / N), Haxis(move.square % N));
+    }
+};
+
+class MCTSPlayer : public Player {
+private:
+    // a node is reached by placing the piece to place on "square", -1 when no piece is given
+    // yet, and giving "piece", -1 when none is left; its score is the half points of the
+    // player who moved there, so that a draw scores 1
+    struct Node {
+        int parent = -1;
+        int firstChild = -1;
+        int nextSibling = -1;
+        int8_t square = -1;
+        int8_t piece = -1;
+        // the score of a node that ends the game, or -1
+        int8_t over = -1;
+        // the moves expanded, and all the moves, 0 once the game is over
+        int16_t tried = 0;
+        int16_t moves = 0;
+        // a visit counts as a loss, a virtual loss, until its playout comes back
+        int visits = 0;
+        int score = 0;
+    };
+
+    // xorshift64*, one to a thread
+    struct Random {
+        uint64_t state;
+
+        explicit Random(uint64_t seed) : state(seed * 0x9e3779b97f4a7c15ull | 1u) {}
+
+        unsigned int below(unsigned int n) {
+            this->state ^= this->state >> 12;
+            this->state ^= this->state << 25;
+            this->state ^= this->state >> 27;
+            return unsigned((this->state * 0x2545f4914f6cdd1dull) >> 32) % n;
+        }
+    };
+
+    static const int PLAYOUTS = 20000;
+    static const size_t MAX_NODES = size_t(1) << 21;
+    static const int CHECK_PLAYOUTS = 64;
+    static constexpr double EXPLORATION = 0.7;
+
+    int timeMs = 0;
+    int threads = 1;
+    unsigned int seed = 0;
+    unsigned long searches = 0;
+    std::vector<Node> nodes;
+    std::mutex mutex;
+
+    // the piece chosen by the last search, and the board it is meant for
+    int nextPiece = -1;
+    unsigned int nextOccupied = 0;
+
+    // the "k"th set bit of "mask", from the lowest
+    static int nth(unsigned int mask, int k) {
+        for (; k; k--) mask &= mask - 1;
+        return count((mask & -mask) - 1);
+    }
+
+    // the pieces that would win if placed on "pos", by the lines a piece short of full
+    static unsigned int winningPieces(const Position &pos) {
+        // the rows, the columns, and the two diagonals, as in board.cpp, and the codes of the
+        // pieces with each attribute
+        static const unsigned int lines[] = {0x000f, 0x00f0, 0x0f00, 0xf000, 0x1111, 0x2222, 0x4444, 0x8888,
+                                             0x8421, 0x1248};
+        static const unsigned int having[N] = {0xaaaa, 0xcccc, 0xf0f0, 0xff00};
+        unsigned int pieces = 0;
+        for (auto line : lines) {
+            unsigned int filled = pos.occupied & line;
+            if (count(filled) != N - 1) continue;
+            for (int i = 0; i < N; i++) {
+                unsigned int set = pos.attributes[i] & line;
+                if (set == filled) pieces |= having[i];
+                if (set == 0) pieces |= ~having[i] & 0xffffu;
+            }
+        }
+        return pieces;
+    }
+
+    // plays "pos" out from the player who places "code", who cannot win with it: each player
+    // places on a random square and gives a random piece the other cannot win with, if there
+    // is one; returns the half points of the player who gave "code"
+    static int rollout(Position pos, unsigned int code, Random &random) {
+        for (bool giver = false;; giver = !giver) {
+            unsigned int empty = ~pos.occupied & ((1u << NP) - 1);
+            place(pos, code, nth(empty, int(random.below(unsigned(count(empty))))));
+            if (pos.unused == 0) return 1;
+            unsigned int safe = pos.unused & ~winningPieces(pos);
+            if (!safe) return giver ? 0 : 2;
+            code = unsigned(nth(safe, int(random.below(unsigned(count(safe))))));
+            pos.unused &= ~(1u << code);
+        }
+    }
+
+    // the moves of the player who places "code" on "pos", or only gives a piece when "code"
+    // is -1
+    static int moveCount(const Position &pos, int code) {
+        int pieces = count(pos.unused);
+        if (code < 0) return pieces;
+        return count(~pos.occupied & ((1u << NP) - 1)) * std::max(pieces, 1);
+    }
+
+    // adds the next move of node "n", whose position is "pos" with "code" to place, and plays
+    // it on "pos" and "code"
+    int expand(int n, Position &pos, int &code) {
+        int k = this->nodes[n].tried++;
+        Node child;
+        child.parent = n;
+        int pieces = count(pos.unused);
+        if (code >= 0) {
+            int i = nth(~pos.occupied & ((1u << NP) - 1), pieces ? k / pieces : k);
+            place(pos, unsigned(code), i);
+            child.square = int8_t(i);
+        }
+        if (pieces) child.piece = int8_t(nth(pos.unused, code >= 0 ? k % pieces : k));
+        code = child.piece;
+        // the placement wins no game, as the node was not over, so its giving a piece the
+        // opponent wins with is what ends the game, or running out of pieces
+        if (code < 0) {
+            child.over = 1;
+        } else if (winningPieces(pos) >> code & 1u) {
+            child.over = 0;
+        }
+        pos.unused &= ~(code >= 0 ? 1u << code : 0u);
+        if (child.over < 0) child.moves = int16_t(moveCount(pos, code));
+        child.nextSibling = this->nodes[n].firstChild;
+        this->nodes[n].firstChild = int(this->nodes.size());
+        this->nodes.push_back(child);
+        return this->nodes[n].firstChild;
+    }
+
+    // the child of node "n" with the best upper bound on its score
+    int select(int n) const {
+        double logVisits = std::log(double(this->nodes[n].visits));
+        int best = -1;
+        double bestBound = -1;
+        for (int c = this->nodes[n].firstChild; c >= 0; c = this->nodes[c].nextSibling) {
+            const auto &child = this->nodes[c];
+            double bound = child.score / (2.0 * child.visits) + EXPLORATION * std::sqrt(logVisits / child.visits);
+            if (bound > bestBound) {
+                best = c;
+                bestBound = bound;
+            }
+        }
+        return best;
+    }
+
+    // descends from the root to a node to play out, adding a visit to each node on the way,
+    // and leaves its position in "pos" and "code"; "score" is set if the game is over there
+    int descend(Position &pos, int &code, int &score) {
+        int n = 0;
+        this->nodes[0].visits++;
+        for (;;) {
+            if (this->nodes[n].over >= 0) {
+                score = this->nodes[n].over;
+                return n;
+            }
+            int next;
+            bool added = this->nodes[n].tried < this->nodes[n].moves && this->nodes.size() < MAX_NODES;
+            if (added) {
+                next = this->expand(n, pos, code);
+            } else {
+                next = this->select(n);
+                if (next < 0) return n;
+                const auto &node = this->nodes[next];
+                if (node.square >= 0) place(pos, unsigned(code), node.square);
+                code = node.piece;
+                if (code >= 0) pos.unused &= ~(1u << code);
+            }
+            n = next;
+            this->nodes[n].visits++;
+            if (added) {
+                if (this->nodes[n].over >= 0) score = this->nodes[n].over;
+                return n;
+            }
+        }
+    }
+
+    // the playouts of one thread, until the shared budget is spent or the deadline passes
+    void work(const Position &root, int rootCode, Random random, std::atomic<int> &started,
+              std::chrono::steady_clock::time_point deadline) {
+        for (int done = 0;; done++) {
+            if (this->timeMs > 0 ? done % CHECK_PLAYOUTS == 0 && std::chrono::steady_clock::now() >= deadline
+                                 : started++ >= PLAYOUTS) {
+                return;
+            }
+            Position pos = root;
+            int code = rootCode, score = -1, n;
+            {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                n = this->descend(pos, code, score);
+            }
+            // the other threads descend meanwhile, away from the virtual losses on this path
+            if (score < 0) score = rollout(pos, unsigned(code), random);
+            std::lock_guard<std::mutex> lock(this->mutex);
+            for (; n >= 0; n = this->nodes[n].parent, score = 2 - score) this->nodes[n].score += score;
+        }
+    }
+
+    // the most played move of the player who places "code" on "pos", or gives a piece when
+    // "code" is -1
+    Node search(const Position &pos, int code) {
+        Node move;
+        if (code >= 0) {
+            for (int i = 0; i < NP; i++) {
+                if (pos.occupied >> i & 1u) continue;
+                move.square = int8_t(i);
+                if (Board::isWinning(pos.occupied, pos.attributes, unsigned(code), i) || pos.unused == 0) return move;
+            }
+        }
+
+        this->nodes.clear();
+        this->nodes.reserve(MAX_NODES);
+        Node root;
+        root.moves = int16_t(moveCount(pos, code));
+        this->nodes.push_back(root);
+        std::atomic<int> started{0};
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(this->timeMs);
+        uint64_t base = (uint64_t(this->seed) << 32) + this->searches++ * this->threads;
+        std::vector<std::thread> workers;
+        for (int t = 1; t < this->threads; t++) {
+            workers.emplace_back(&MCTSPlayer::work, this, std::cref(pos), code, Random(base + t), std::ref(started),
+                                 deadline);
+        }
+        this->work(pos, code, Random(base), started, deadline);
+        for (auto &worker : workers) worker.join();
+
+        int best = this->nodes[0].firstChild;
+        for (int c = best; c >= 0; c = this->nodes[c].nextSibling) {
+            if (this->nodes[c].visits > this->nodes[best].visits) best = c;
+        }
+        return this->nodes[best];
+    }
+
+public:
+    MCTSPlayer() noexcept : Player(nullptr, nullptr) {}
+
+    void initialize(Board *b, Pool *p, int t, int n, unsigned int s) {
+        if (!this->board) {
+            this->board = b;
+            this->pool = p;
+            this->timeMs = t;
+            this->threads = std::max(n, 1);
+            this->seed = s;
+        }
+    }
+
+    Piece &selectPiece() override {
+        auto pos = position(this->board, this->pool);
+        if (this->nextPiece >= 0 && this->nextOccupied == pos.occupied && (pos.unused >> this->nextPiece & 1u)) {
+            return unusedPiece(this->pool, this->nextPiece);
+        }
+        return unusedPiece(this->pool, this->search(pos, -1).piece);
+    }
+
+    Square &selectSquare(const Piece &p) override {
+        auto pos = position(this->board, this->pool);
+        unsigned int code = p.getCode();
+        pos.unused &= ~(1u << code);
+        auto move = this->search(pos, int(code));
+        this->nextPiece = move.piece;
+        this->nextOccupied = pos.occupied | 1u << move.square;
+        return this->board->getSquare(Vaxis(move.square / N), Haxis(move.square % N));
+    }
+};
+
 static HumanPlayer humanPlayer;
 static MyopicPlayer myopicPlayer;
+static SearchPlayer searchPlayer;
+static MCTSPlayer mctsPlayer;
 
 Player *getHumanPlayer(Board *b, Pool *p) {
     humanPlayer.initialize(b, p);
@@ -163,3 +973,21 @@ Player *getMyopicPlayer(Board *b, Pool *p, unsigned int s) {
     myopicPlayer.initialize(b, p, s);
     return &myopicPlayer;
 }
+
+Player *getSearchPlayer(Board *b, Pool *p, int depth, int timeMs, int threads, bool ponder) {
+    searchPlayer.initialize(b, p, depth, timeMs, threads, ponder);
+    return &searchPlayer;
+}
+
+Player *getMCTSPlayer(Board *b, Pool *p, int timeMs, int threads, unsigned int seed) {
+    mctsPlayer.initialize(b, p, timeMs, threads, seed);
+    return &mctsPlayer;
+}
+
+bool loadSearchTablebase(const char *file) {
+    return searchPlayer.loadTablebase(file);
+}
+
+long long writeSearchTablebase(const char *file, long long positions, unsigned int seed, int empty) {
+    return searchPlayer.writeTablebase(file, positions, seed, empty);
+}
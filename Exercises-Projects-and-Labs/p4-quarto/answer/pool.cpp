@@ -23,6 +23,12 @@ Pool::Pool() {
     }
 }
 
+void Pool::reset() {
+    for (auto &piece : this->pieces) {
+        piece.setUsed(false);
+    }
+}
+
 Piece &Pool::getUnusedPiece(Height h, Color c, Shape s, Top t) {
     return this->getUnusedPiece(h * 8 + c * 4 + s * 2 + t);
 }
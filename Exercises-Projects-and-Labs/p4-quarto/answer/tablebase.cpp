@@ -0,0 +1,99 @@
+//
+// The exact values of positions solved ahead of time.
+//
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "tablebase.h"
+
+namespace {
+    const char MAGIC[8] = {'P', '4', 'T', 'B', 'A', 'S', 'E', '1'};
+
+    // the magic, then the number of empty squares and of entries
+    const size_t HEADER_SIZE = sizeof(MAGIC) + 2 * sizeof(uint64_t);
+
+    const uint64_t VALUE_MASK = 0xff;
+}
+
+Tablebase::Tablebase() : entries(nullptr), size(0), mappedBytes(0), empty(-1) {}
+
+Tablebase::~Tablebase() {
+    this->close();
+}
+
+void Tablebase::close() {
+    if (this->mappedBytes) {
+        ::munmap(const_cast<char *>(reinterpret_cast<const char *>(this->entries) - HEADER_SIZE),
+                 this->mappedBytes);
+    }
+    this->entries = nullptr;
+    this->size = 0;
+    this->mappedBytes = 0;
+    this->empty = -1;
+}
+
+bool Tablebase::open(const std::string &file) {
+    int fd = ::open(file.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st{};
+    void *map = MAP_FAILED;
+    if (::fstat(fd, &st) == 0 && size_t(st.st_size) >= HEADER_SIZE) {
+        map = ::mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+    if (map == MAP_FAILED) return false;
+
+    auto bytes = static_cast<const char *>(map);
+    uint64_t header[2];
+    std::memcpy(header, bytes + sizeof(MAGIC), sizeof(header));
+    if (std::memcmp(bytes, MAGIC, sizeof(MAGIC)) != 0 ||
+        header[1] != (size_t(st.st_size) - HEADER_SIZE) / sizeof(uint64_t)) {
+        ::munmap(map, size_t(st.st_size));
+        return false;
+    }
+    this->close();
+    this->entries = reinterpret_cast<const uint64_t *>(bytes + HEADER_SIZE);
+    this->size = size_t(header[1]);
+    this->mappedBytes = size_t(st.st_size);
+    this->empty = int(header[0]);
+    return true;
+}
+
+int Tablebase::emptySquares() const {
+    return this->empty;
+}
+
+bool Tablebase::probe(uint64_t key, int &value) const {
+    auto end = this->entries + this->size;
+    auto it = std::lower_bound(this->entries, end, key & ~VALUE_MASK);
+    if (it == end || (*it & ~VALUE_MASK) != (key & ~VALUE_MASK)) return false;
+    value = int8_t(*it & VALUE_MASK);
+    return true;
+}
+
+bool Tablebase::write(const std::string &file, int empty, std::vector<std::pair<uint64_t, int>> &values) {
+    std::vector<uint64_t> packed;
+    packed.reserve(values.size());
+    for (auto &entry : values) {
+        packed.push_back((entry.first & ~VALUE_MASK) | uint8_t(int8_t(entry.second)));
+    }
+    // a position met twice has the same value, and of keys alike but for their low byte, which
+    // the table cannot tell apart, only one is kept
+    std::sort(packed.begin(), packed.end());
+    packed.erase(std::unique(packed.begin(), packed.end(), [](uint64_t a, uint64_t b) {
+        return (a & ~VALUE_MASK) == (b & ~VALUE_MASK);
+    }), packed.end());
+
+    std::ofstream out(file, std::ios::binary | std::ios::trunc);
+    uint64_t header[2] = {uint64_t(empty), uint64_t(packed.size())};
+    out.write(MAGIC, sizeof(MAGIC));
+    out.write(reinterpret_cast<const char *>(header), sizeof(header));
+    out.write(reinterpret_cast<const char *>(packed.data()), std::streamsize(packed.size() * sizeof(uint64_t)));
+    return bool(out);
+}
@@ -8,11 +8,20 @@
 class Board{
    // OVERVIEW: a Quarto 4x4 board
    Square grid[N][N];
+   // the same board as bitboards, square (v, h) being bit v*N+h:
+   // the occupied squares, and for each attribute, the occupied
+   // squares whose piece has that attribute's bit of getCode() set
+   unsigned int occupied;
+   unsigned int attributes[N];
 
 public:
    Board();
    // EFFECTS: create a 4x4 board of empty squares
 
+   void reset();
+   // MODIFIES: "this"
+   // EFFECTS: empty every square, without touching the pieces
+
    Square &getSquare(Vaxis v, Haxis h);
    // EFFECTS: return a reference to the square at position (v, h)
 
@@ -24,10 +33,19 @@ public:
    // EFFECTS: return a reference to the square at a position encoded in "s" (e.g., B2)
    //          throw SquareException if the square is not empty
 
+   unsigned int emptyMask() const;
+   // EFFECTS: return the empty squares as a bitboard, square (v, h)
+   //          being bit v*N+h
+
    void place(Piece &p, Square &sq);
    // MODIFIES: "p" and "sq"
    // EFFECTS: place piece "p" on square "sq"
 
+   void remove(Piece &p, Square &sq);
+   // REQUIRES: "p" is placed on "sq"
+   // MODIFIES: "p" and "sq"
+   // EFFECTS: take piece "p" off square "sq", and mark it unused
+
    bool isWinning(const Piece &p, const Square &sq);
    // REQUIRES: if "p" is used, then it is already placed on "sq".
    //           Otherwise, "sq" is empty.
@@ -38,6 +56,13 @@ public:
    // REMARK: "p" may or may not have been placed on "sq"
    // (Please think about why), which may be empty.
 
+   static bool isWinning(unsigned int occupied, const unsigned int attributes[N],
+                         unsigned int code, int square);
+   // REQUIRES: "occupied" and "attributes" are bitboards as kept by a
+   //           Board, "code" is as returned by Piece::getCode()
+   // EFFECTS: return true if a piece of attributes "code" placed on
+   //          bit "square" of those bitboards yields a winning position
+
    std::string toString() const;
    // EFFECTS: return a string that represents the board
    // e.g., at the beginning of the game, the returned string
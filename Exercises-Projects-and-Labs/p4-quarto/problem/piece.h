@@ -33,6 +33,10 @@ public:
    // EFFECTS: return true if "this" has the same top as "p"
    //          return false otherwise
 
+   unsigned int getCode() const;
+   // EFFECTS: return the attributes of "this" as 4 bits, the height
+   // in bit 0, then the color, the shape, and the top in bit 3
+
    bool isUsed() const;
    // EFFECTS: return true if "this" has been placed on the board
    //          return false otherwise
@@ -25,4 +25,26 @@ public:
 
 extern Player *getHumanPlayer(Board *b, Pool *p);
 extern Player *getMyopicPlayer(Board *b, Pool *p, unsigned int s);
+extern Player *getSearchPlayer(Board *b, Pool *p, int depth, int timeMs, int threads = 1,
+                               bool ponder = false);
+// EFFECTS: return a player that searches "depth" placements ahead, then
+//          deeper for up to "timeMs" milliseconds a move, to the end of
+//          the game when there is time, splitting the moves over "threads".
+//          With "ponder", it searches the opponent's likely replies on a
+//          thread of its own while the opponent decides, and plays the
+//          move found for the reply made, if it got to it, at once
+
+extern Player *getMCTSPlayer(Board *b, Pool *p, int timeMs, int threads = 1, unsigned int seed = 0);
+// EFFECTS: return a player that plays out random games from each move by
+//          Monte Carlo tree search for "timeMs" milliseconds, or 20000
+//          games when "timeMs" is 0, sharing the tree among "threads"
+
+extern bool loadSearchTablebase(const char *file);
+// EFFECTS: let the search player probe the tablebase of "file", and
+//          return true if it could be loaded
+
+extern long long writeSearchTablebase(const char *file, long long positions, unsigned int seed, int empty);
+// EFFECTS: solve "positions" positions with "empty" empty squares met in
+//          myopic games seeded by "seed", write them to "file" as a
+//          tablebase, and return how many were written, or -1 on failure
 #endif
@@ -17,6 +17,10 @@ public:
    // EFFECTS: creates a pool of the 16 unused Quarto pieces
    // "unused" means "not placed on the board"
 
+   void reset();
+   // MODIFIES: "this"
+   // EFFECTS: mark all the pieces unused
+
    Piece & getUnusedPiece(Height h, Color c, Shape s, Top t);
    // EFFECTS: return the reference to a piece "p" given its attributes
    //          throw UsedPieceException if "p" is placed on the board
@@ -27,6 +31,14 @@ public:
    // see file "quarto.h/cpp" for the encoding of each attribute
    // e.g., "SEQO" encodes a piece that is short, sepia, square, and solid
 
+   template<typename F>
+   void forEachUnused(F f) {
+      for (auto &piece : pieces) {
+         if (!piece.isUsed()) f(piece);
+      }
+   }
+   // EFFECTS: call "f" on each unused piece, in the order of the pool
+
    std::string toString() const;
    // EFFECTS: returns a string that lists all the unused pieces
    // preceded by string "Available:\n" if the list is not empty
@@ -0,0 +1,54 @@
+#ifndef TABLEBASE_H
+#define TABLEBASE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+class Tablebase{
+   // OVERVIEW: a read-only table of the exact values of positions with a
+   // given number of empty squares, mapped from a file. The file holds a
+   // header, then the entries sorted, each the key of a position with its
+   // low byte replaced by the value
+   const uint64_t *entries;
+   size_t size;
+   size_t mappedBytes;
+   int empty;
+
+   void close();
+   // MODIFIES: "this"
+   // EFFECTS: unmap the table, leaving "this" empty
+
+public:
+   Tablebase();
+   // EFFECTS: create an empty table
+
+   ~Tablebase();
+
+   Tablebase(const Tablebase &) = delete;
+   Tablebase &operator=(const Tablebase &) = delete;
+
+   bool open(const std::string &file);
+   // MODIFIES: "this"
+   // EFFECTS: map the table of "file", and return true if it is valid
+   //          return false, and leave "this" empty, otherwise
+
+   int emptySquares() const;
+   // EFFECTS: return the number of empty squares of the positions in the
+   //          table, or -1 if it is empty
+
+   bool probe(uint64_t key, int &value) const;
+   // MODIFIES: "value"
+   // EFFECTS: return true and set "value" if the position of "key" is in
+   //          the table, return false otherwise
+
+   static bool write(const std::string &file, int empty, std::vector<std::pair<uint64_t, int>> &values);
+   // MODIFIES: "values"
+   // REQUIRES: every value is in [-128, 127]
+   // EFFECTS: write the keys and values of positions with "empty" empty
+   //          squares to "file" as a table, and return true on success
+};
+
+#endif
@@ -0,0 +1,323 @@
+//
+// Integers of any size: the arithmetic of large values on their limbs.
+//
+
+#include "bigint.h"
+
+#include <algorithm>
+#include <climits>
+
+using namespace std;
+
+typedef vector<uint32_t> Limbs;
+
+// Below this many limbs in the shorter operand, schoolbook multiplication
+// beats the extra additions of Karatsuba's three half-size products
+static const size_t KARATSUBA_THRESHOLD = 32;
+
+// The largest power of ten in a limb, for converting to and from decimal
+static const uint32_t CHUNK = 1000000000;
+static const int CHUNK_DIGITS = 9;
+
+static void trimhelper(Limbs &a) {
+    // MODIFIES: a
+    // EFFECTS: removes the leading zero limbs of a
+    while (!a.empty() && a.back() == 0) a.pop_back();
+}
+
+static int comparehelper(const Limbs &a, const Limbs &b) {
+    // REQUIRES: neither a nor b has a leading zero limb
+    // EFFECTS: returns -1, 0 or 1 as the magnitude a is less than, equal
+    //          to or greater than b
+    if (a.size() != b.size()) return a.size() < b.size() ? -1 : 1;
+    for (size_t i = a.size(); i-- > 0;) {
+        if (a[i] != b[i]) return a[i] < b[i] ? -1 : 1;
+    }
+    return 0;
+}
+
+static uint32_t addhelper(uint32_t *z, size_t nz, const uint32_t *x, size_t nx) {
+    // REQUIRES: nx <= nz
+    // MODIFIES: z
+    // EFFECTS: adds the nx limbs at x to the nz limbs at z, and returns the
+    //          carry out of the last limb of z
+    uint64_t carry = 0;
+    size_t i = 0;
+    for (; i < nx; i++) {
+        uint64_t t = uint64_t(z[i]) + x[i] + carry;
+        z[i] = uint32_t(t);
+        carry = t >> 32;
+    }
+    for (; carry && i < nz; i++) {
+        carry = ++z[i] == 0;
+    }
+    return uint32_t(carry);
+}
+
+static void subtracthelper(uint32_t *z, size_t nz, const uint32_t *x, size_t nx) {
+    // REQUIRES: nx <= nz, and the nz limbs at z are at least the nx at x
+    // MODIFIES: z
+    // EFFECTS: subtracts the nx limbs at x from the nz limbs at z
+    uint64_t borrow = 0;
+    size_t i = 0;
+    for (; i < nx; i++) {
+        uint64_t t = uint64_t(z[i]) - x[i] - borrow;
+        z[i] = uint32_t(t);
+        borrow = t >> 63;
+    }
+    for (; borrow && i < nz; i++) {
+        borrow = z[i]-- == 0;
+    }
+}
+
+static void schoolbookhelper(const uint32_t *a, size_t na, const uint32_t *b, size_t nb, uint32_t *z) {
+    // MODIFIES: z
+    // EFFECTS: sets the na + nb limbs at z to the product of the na limbs
+    //          at a and the nb limbs at b
+    fill(z, z + na + nb, 0);
+    for (size_t i = 0; i < na; i++) {
+        uint64_t carry = 0;
+        for (size_t j = 0; j < nb; j++) {
+            uint64_t t = uint64_t(a[i]) * b[j] + z[i + j] + carry;
+            z[i + j] = uint32_t(t);
+            carry = t >> 32;
+        }
+        z[i + nb] = uint32_t(carry);
+    }
+}
+
+static void multiplyhelper(const uint32_t *a, size_t na, const uint32_t *b, size_t nb, uint32_t *z) {
+    // MODIFIES: z
+    // EFFECTS: as schoolbookhelper(), by Karatsuba's method once both
+    //          operands have KARATSUBA_THRESHOLD limbs or more
+    if (na < nb) {
+        swap(a, b);
+        swap(na, nb);
+    }
+    if (nb < KARATSUBA_THRESHOLD) {
+        schoolbookhelper(a, na, b, nb, z);
+        return;
+    }
+    size_t m = na / 2;
+    if (nb <= m) {
+        // Too unbalanced to split both: multiply b by each half of a
+        multiplyhelper(a, m, b, nb, z);
+        fill(z + m + nb, z + na + nb, 0);
+        Limbs high(na - m + nb);
+        multiplyhelper(a + m, na - m, b, nb, high.data());
+        addhelper(z + m, na + nb - m, high.data(), high.size());
+        return;
+    }
+    // a = a1 B^m + a0 and b = b1 B^m + b0, so that a b is
+    // z2 B^2m + ((a0 + a1)(b0 + b1) - z0 - z2) B^m + z0
+    multiplyhelper(a, m, b, m, z);
+    multiplyhelper(a + m, na - m, b + m, nb - m, z + 2 * m);
+    Limbs sa(max(m, na - m) + 1), sb(max(m, nb - m) + 1);
+    copy(a + m, a + na, sa.begin());
+    copy(b + m, b + nb, sb.begin());
+    addhelper(sa.data(), sa.size(), a, m);
+    addhelper(sb.data(), sb.size(), b, m);
+    Limbs middle(sa.size() + sb.size());
+    multiplyhelper(sa.data(), sa.size(), sb.data(), sb.size(), middle.data());
+    subtracthelper(middle.data(), middle.size(), z, 2 * m);
+    subtracthelper(middle.data(), middle.size(), z + 2 * m, na + nb - 2 * m);
+    trimhelper(middle);
+    addhelper(z + m, na + nb - m, middle.data(), middle.size());
+}
+
+static uint32_t shortdividehelper(Limbs &a, uint32_t d) {
+    // REQUIRES: d != 0
+    // MODIFIES: a
+    // EFFECTS: divides a by d, and returns the remainder
+    uint64_t r = 0;
+    for (size_t i = a.size(); i-- > 0;) {
+        uint64_t t = (r << 32) | a[i];
+        a[i] = uint32_t(t / d);
+        r = t % d;
+    }
+    trimhelper(a);
+    return uint32_t(r);
+}
+
+static Limbs dividehelper(const Limbs &u, const Limbs &v) {
+    // REQUIRES: v is not zero, and neither u nor v has a leading zero limb
+    // EFFECTS: returns the magnitude u / v rounded down, by Knuth's
+    //          algorithm D
+    if (comparehelper(u, v) < 0) return Limbs();
+    if (v.size() == 1) {
+        Limbs q = u;
+        shortdividehelper(q, v[0]);
+        return q;
+    }
+    size_t n = v.size(), m = u.size();
+    // Shift both so that the top limb of the divisor has its top bit set,
+    // which keeps the estimate of each quotient limb at most 2 too high
+    int s = __builtin_clz(v[n - 1]);
+    Limbs vn(n), un(m + 1);
+    for (size_t i = n - 1; i > 0; i--) {
+        vn[i] = (v[i] << s) | (s ? v[i - 1] >> (32 - s) : 0);
+    }
+    vn[0] = v[0] << s;
+    un[m] = s ? u[m - 1] >> (32 - s) : 0;
+    for (size_t i = m - 1; i > 0; i--) {
+        un[i] = (u[i] << s) | (s ? u[i - 1] >> (32 - s) : 0);
+    }
+    un[0] = u[0] << s;
+
+    Limbs q(m - n + 1);
+    const uint64_t base = uint64_t(1) << 32;
+    for (size_t j = m - n + 1; j-- > 0;) {
+        uint64_t top = (uint64_t(un[j + n]) << 32) | un[j + n - 1];
+        uint64_t qhat = top / vn[n - 1], rhat = top % vn[n - 1];
+        while (qhat >= base || qhat * vn[n - 2] > ((rhat << 32) | un[j + n - 2])) {
+            qhat--;
+            rhat += vn[n - 1];
+            if (rhat >= base) break;
+        }
+        // Subtract qhat times the divisor, adding it back once if too much
+        int64_t borrow = 0, t;
+        for (size_t i = 0; i < n; i++) {
+            uint64_t p = qhat * vn[i];
+            t = int64_t(un[i + j]) - borrow - int64_t(p & 0xFFFFFFFF);
+            un[i + j] = uint32_t(t);
+            borrow = int64_t(p >> 32) - (t >> 32);
+        }
+        t = int64_t(un[j + n]) - borrow;
+        un[j + n] = uint32_t(t);
+        if (t < 0) {
+            qhat--;
+            un[j + n] += addhelper(&un[j], n, vn.data(), n);
+        }
+        q[j] = uint32_t(qhat);
+    }
+    trimhelper(q);
+    return q;
+}
+
+void BigInt::parts(bool &sign, Limbs &magnitude) const {
+    if (!isSmall()) {
+        sign = negative;
+        magnitude = limbs;
+        return;
+    }
+    sign = small < 0;
+    unsigned long long m = sign ? 0ULL - (unsigned long long) small : (unsigned long long) small;
+    magnitude.clear();
+    for (; m; m >>= 32) {
+        magnitude.push_back(uint32_t(m));
+    }
+}
+
+BigInt BigInt::make(bool sign, Limbs magnitude) {
+    trimhelper(magnitude);
+    BigInt r;
+    if (magnitude.size() <= 2) {
+        unsigned long long m = 0;
+        for (size_t i = magnitude.size(); i-- > 0;) {
+            m = (m << 32) | magnitude[i];
+        }
+        if (!sign && m <= (unsigned long long) LLONG_MAX) {
+            r.small = (long long) m;
+            return r;
+        }
+        if (sign && m <= 0ULL - (unsigned long long) LLONG_MIN) {
+            r.small = (long long) (0ULL - m);
+            return r;
+        }
+    }
+    r.limbs = std::move(magnitude);
+    r.negative = sign;
+    return r;
+}
+
+BigInt BigInt::add(const BigInt &a, const BigInt &b, bool subtract) {
+    bool sa, sb;
+    Limbs ma, mb;
+    a.parts(sa, ma);
+    b.parts(sb, mb);
+    if (subtract) sb = !sb;
+    if (sa == sb) {
+        if (ma.size() < mb.size()) swap(ma, mb);
+        ma.push_back(0);
+        addhelper(ma.data(), ma.size(), mb.data(), mb.size());
+        return make(sa, std::move(ma));
+    }
+    if (comparehelper(ma, mb) < 0) {
+        swap(ma, mb);
+        sa = sb;
+    }
+    subtracthelper(ma.data(), ma.size(), mb.data(), mb.size());
+    return make(sa, std::move(ma));
+}
+
+BigInt BigInt::multiply(const BigInt &a, const BigInt &b) {
+    bool sa, sb;
+    Limbs ma, mb;
+    a.parts(sa, ma);
+    b.parts(sb, mb);
+    if (ma.empty() || mb.empty()) return BigInt();
+    Limbs product(ma.size() + mb.size());
+    multiplyhelper(ma.data(), ma.size(), mb.data(), mb.size(), product.data());
+    return make(sa != sb, std::move(product));
+}
+
+BigInt BigInt::divide(const BigInt &a, const BigInt &b) {
+    bool sa, sb;
+    Limbs ma, mb;
+    a.parts(sa, ma);
+    b.parts(sb, mb);
+    return make(sa != sb, dividehelper(ma, mb));
+}
+
+bool BigInt::parse(const char *begin, const char *end, BigInt &value) {
+    bool sign = *begin == '-';
+    const char *p = begin;
+    if (*p == '-' || *p == '+') p++;
+    if (p == end) return false;
+    for (const char *q = p; q < end; q++) {
+        if (*q < '0' || *q > '9') return false;
+    }
+    // Each chunk of 9 digits, the first of what is left over, multiplies
+    // the limbs so far by 10^9 and adds the chunk
+    Limbs magnitude;
+    size_t first = size_t(end - p) % CHUNK_DIGITS;
+    if (first == 0) first = CHUNK_DIGITS;
+    for (; p < end; p += first, first = CHUNK_DIGITS) {
+        uint32_t chunk = 0, scale = 1;
+        for (size_t i = 0; i < first; i++) {
+            chunk = chunk * 10 + uint32_t(p[i] - '0');
+            scale *= 10;
+        }
+        uint64_t carry = chunk;
+        for (auto &limb : magnitude) {
+            uint64_t t = uint64_t(limb) * scale + carry;
+            limb = uint32_t(t);
+            carry = t >> 32;
+        }
+        if (carry) magnitude.push_back(uint32_t(carry));
+    }
+    value = make(sign, std::move(magnitude));
+    return true;
+}
+
+string BigInt::toString() const {
+    if (isSmall()) return to_string(small);
+    Limbs magnitude = limbs;
+    vector<uint32_t> chunks;
+    while (!magnitude.empty()) {
+        chunks.push_back(shortdividehelper(magnitude, CHUNK));
+    }
+    string s = negative ? "-" : "";
+    s += to_string(chunks.back());
+    for (size_t i = chunks.size() - 1; i-- > 0;) {
+        string digits = to_string(chunks[i]);
+        s.append(CHUNK_DIGITS - digits.size(), '0');
+        s += digits;
+    }
+    return s;
+}
+
+ostream &operator<<(ostream &os, const BigInt &v) {
+    if (v.isSmall()) return os << v.toLong();
+    return os << v.toString();
+}
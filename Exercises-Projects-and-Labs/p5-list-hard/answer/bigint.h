@@ -0,0 +1,121 @@
+//
+// Integers of any size, for the -big modes of calc and rpn.
+//
+
+#ifndef VE280_BIGINT_H
+#define VE280_BIGINT_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "operators.h"
+
+class BigInt {
+    // OVERVIEW: an integer of any size. A value that fits in 64 bits is
+    //           held in the object, and arithmetic on such values checks
+    //           for overflow inline, allocating nothing. A larger value
+    //           holds its magnitude in 32-bit limbs, least significant
+    //           first, and a result that fits in 64 bits again goes back
+    //           to the object, so a value is large exactly when it does
+    //           not fit.
+
+    long long small;                // The value, if limbs is empty
+    std::vector<uint32_t> limbs;    // The magnitude of a large value
+    bool negative;                  // The sign of a large value
+
+    static BigInt add(const BigInt &a, const BigInt &b, bool subtract);
+    static BigInt multiply(const BigInt &a, const BigInt &b);
+    static BigInt divide(const BigInt &a, const BigInt &b);
+    // EFFECT: the arithmetic of the operators below once either operand
+    //         is large or the result of small ones overflows
+
+    void parts(bool &sign, std::vector<uint32_t> &magnitude) const;
+    // MODIFIES sign, magnitude
+    // EFFECT: sets sign to whether the value is negative, and magnitude to
+    //         the limbs of its absolute value, with no leading zero limb
+
+    static BigInt make(bool sign, std::vector<uint32_t> magnitude);
+    // EFFECT: returns the value of magnitude, negated if sign, small if it
+    //         fits in 64 bits
+
+   public:
+    BigInt(long long v = 0) : small(v), negative(false) {}
+
+    static bool parse(const char *begin, const char *end, BigInt &value);
+    // MODIFIES value
+    // EFFECTS returns true and sets value if all of [begin, end) is a
+    //         decimal integer with an optional sign
+
+    bool isSmall() const { return limbs.empty(); }
+    // EFFECTS returns true if the value fits in 64 bits
+
+    long long toLong() const { return small; }
+    // REQUIRES isSmall()
+    // EFFECTS returns the value
+
+    std::string toString() const;
+    // EFFECTS returns the value in decimal
+
+    friend BigInt operator+(const BigInt &a, const BigInt &b) {
+        long long r;
+        if (a.isSmall() && b.isSmall() && !__builtin_add_overflow(a.small, b.small, &r)) return r;
+        return add(a, b, false);
+    }
+
+    friend BigInt operator-(const BigInt &a, const BigInt &b) {
+        long long r;
+        if (a.isSmall() && b.isSmall() && !__builtin_sub_overflow(a.small, b.small, &r)) return r;
+        return add(a, b, true);
+    }
+
+    friend BigInt operator*(const BigInt &a, const BigInt &b) {
+        long long r;
+        if (a.isSmall() && b.isSmall() && !__builtin_mul_overflow(a.small, b.small, &r)) return r;
+        return multiply(a, b);
+    }
+
+    friend BigInt operator/(const BigInt &a, const BigInt &b) {
+        // REQUIRES b != 0
+        // EFFECTS returns a / b rounded toward zero, as int division does
+        if (a.isSmall() && b.isSmall() && !(a.small == INT64_MIN && b.small == -1)) return a.small / b.small;
+        return divide(a, b);
+    }
+
+    BigInt operator-() const {
+        return BigInt() - *this;
+    }
+
+    friend bool operator==(const BigInt &a, const BigInt &b) {
+        return a.small == b.small && a.negative == b.negative && a.limbs == b.limbs;
+    }
+
+    friend bool operator!=(const BigInt &a, const BigInt &b) {
+        return !(a == b);
+    }
+};
+
+std::ostream &operator<<(std::ostream &os, const BigInt &v);
+// MODIFIES os
+// EFFECTS prints v in decimal
+
+inline BigInt applyOperator(OperatorKind kind, const BigInt &a, const BigInt &b) {
+    // REQUIRES kind is not OPERATOR_NONE, and b != 0 if it needs a divisor
+    // EFFECTS returns the result of kind on a and b, as the int kernels
+    //         would without overflow
+    switch (kind) {
+        case OPERATOR_ADD:
+            return a + b;
+        case OPERATOR_SUB:
+            return a - b;
+        case OPERATOR_MUL:
+            return a * b;
+        case OPERATOR_DIV:
+            return a / b;
+        default:
+            return -a;
+    }
+}
+
+#endif //VE280_BIGINT_H
@@ -2,28 +2,345 @@
 // Created by liu on 27/7/2020.
 //
 
+#include <algorithm>
 #include <iostream>
+#include <memory>
 #include <sstream>
-#include <cstring>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
 
-#include "dlist.h"
+#include "cache_sim.h"
+#include "trace.h"
 
 using namespace std;
 
-struct CacheBlock {
-    size_t index;
-    int value;
-};
+// Usage: cache [-ways N] [-policy lru|fifo|random|clock] [-write back|through]
+//              [-level BLOCKS[:WAYS]]... [-combine N] [-stats]
+//              [-trace FILE -blocks N [-memory N] [-interval N | -j N]]
+//              [-trace FILE -sweep N,N,... [-memory N]]
+//
+// The first line of input gives the number of blocks of L1 and the size of
+// memory in words; a size of 0 stands for the whole address space, which
+// PRINTMEM then lists as "address value" for the nonzero words only. -ways
+// makes L1 set-associative, each -level adds the next level below it, and
+// -stats prints the counters of every level on exit. The defaults, a fully
+// associative write-back LRU cache, are the behaviour of the original
+// simulator.
+//
+// Only dirty blocks are written back. What reaches memory waits in a
+// write-combining buffer of -combine slots (16 by default, 0 for none) and
+// is stored in address order when it fills; PRINTMEM flushes it first.
+//
+// -trace replays the accesses of a trace file (see trace.h) instead of
+// reading commands; the sizes of L1 and memory are then given by -blocks
+// and -memory, which defaults to the whole address space. Only the counters
+// are printed: at the end, and after every -interval accesses if given.
+//
+// -j replays a trace file on N threads. Each thread simulates only the
+// addresses of its share of the sets, so it needs no locking, and the
+// counters are added up at the end. The words the threads write to memory
+// are then put back in the order of the trace and passed through a single
+// write buffer. The results are those of a single thread, except that the
+// random policy draws different victims.
+//
+// -sweep replays a trace once for every L1 size in a comma-separated list
+// and prints the L1 hits and misses of each. A fully associative LRU L1 is
+// swept with Mattson's stack algorithm, which costs one simulation for all
+// sizes; otherwise every size is simulated side by side in a single pass
+// over the trace.
 
-int main() {
-    size_t cacheSize, memorySize;
-    cin >> cacheSize >> memorySize >> ws;
+static bool parselevelhelper(const string &arg, LevelConfig &config) {
+    // EFFECTS: parses "BLOCKS" or "BLOCKS:WAYS" into config and returns
+    //          true, or returns false if arg is neither
+    char *end;
+    config.blocks = strtoul(arg.c_str(), &end, 10);
+    config.ways = 0;
+    if (end == arg.c_str()) return false;
+    if (*end == ':') {
+        const char *ways = end + 1;
+        config.ways = strtoul(ways, &end, 10);
+        if (end == ways) return false;
+    }
+    return *end == '\0';
+}
+
+static int replayhelper(TraceFile &trace, CacheSim &cache, size_t interval) {
+    // MODIFIES: trace, cache
+    // EFFECTS: runs every access of trace through cache, printing the
+    //          counters every "interval" accesses (never if 0) and at the
+    //          end. Returns the exit status.
+    Access a;
+    size_t count = 0, outOfBound = 0;
+    size_t memorySize = cache.memorySize();
+    size_t nextReport = interval ? interval : size_t(-1);
+    while (trace.next(a)) {
+        if (a.address >= memorySize) {
+            outOfBound++;
+        } else if (a.write) {
+            cache.write(a.address, a.value);
+        } else {
+            cache.read(a.address);
+        }
+        if (++count == nextReport) {
+            cout << "after " << count << " accesses\n";
+            cache.printStats(cout);
+            nextReport += interval;
+        }
+    }
+    if (trace.failed()) {
+        cerr << "Bad trace record at " << trace.position() << endl;
+        return 1;
+    }
+    cout << count << " accesses";
+    if (outOfBound) cout << ", " << outOfBound << " out of bound";
+    cout << "\n";
+    cache.printStats(cout);
+    return 0;
+}
 
-    auto memory = new int[memorySize];
-    memset(memory, 0, memorySize * sizeof(int));
+static int replayparallelhelper(const string &path, const vector<LevelConfig> &configs,
+                                size_t memorySize, ReplacementPolicy policy,
+                                WritePolicy writePolicy, size_t combine, unsigned threads) {
+    // EFFECTS: replays the trace at path on "threads" threads and prints the
+    //          merged counters. Returns the exit status.
+    CacheSim total(configs, memorySize, policy, writePolicy, combine);
+    // Addresses that differ modulo "sets" never meet in a set, so a thread
+    // can own every address of some residues
+    size_t sets = total.independentSets();
+    if (sets == 0) sets = threads;
+    if (threads > sets) threads = unsigned(sets);
 
-    Dlist<CacheBlock> cache;
-    size_t cacheUsed = 0;
+    vector<unique_ptr<CacheSim>> shards(threads);
+    // The words each thread wrote to memory, and the access of the trace
+    // that wrote each of them
+    vector<vector<pair<size_t, int>>> words(threads);
+    vector<vector<size_t>> writers(threads);
+    vector<size_t> counts(threads, 0), outOfBounds(threads, 0);
+    vector<char> failed(threads, 0);
+    size_t position = 0;
+    vector<thread> workers;
+    for (unsigned t = 0; t < threads; t++) {
+        workers.emplace_back([&, t]() {
+            shards[t].reset(new CacheSim(configs, memorySize, policy, writePolicy, combine));
+            auto &cache = *shards[t];
+            cache.logMemoryWrites(&words[t]);
+            TraceFile trace;
+            if (!trace.open(path)) {
+                failed[t] = 1;
+                return;
+            }
+            Access a;
+            for (size_t index = 0; trace.next(a); index++) {
+                if (a.address % sets % threads != t) {
+                    continue;
+                }
+                counts[t]++;
+                if (a.address >= cache.memorySize()) {
+                    outOfBounds[t]++;
+                } else if (a.write) {
+                    cache.write(a.address, a.value);
+                } else {
+                    cache.read(a.address);
+                }
+                writers[t].resize(words[t].size(), index);
+            }
+            failed[t] = trace.failed();
+            if (t == 0) position = trace.position();
+        });
+    }
+    size_t count = 0, outOfBound = 0;
+    for (unsigned t = 0; t < threads; t++) {
+        workers[t].join();
+        total.addStats(*shards[t]);
+        count += counts[t];
+        outOfBound += outOfBounds[t];
+    }
+    // Each access is simulated by one thread, so taking the word of the
+    // earliest access among the threads gives the order of a single thread
+    vector<size_t> next(threads, 0);
+    while (true) {
+        unsigned first = threads;
+        for (unsigned t = 0; t < threads; t++) {
+            if (next[t] < words[t].size() && (first == threads || writers[t][next[t]] < writers[first][next[first]])) {
+                first = t;
+            }
+        }
+        if (first == threads) break;
+        const auto &word = words[first][next[first]++];
+        total.writeMemory(word.first, word.second);
+    }
+    for (unsigned t = 0; t < threads; t++) {
+        if (failed[t]) {
+            cerr << "Bad trace record at " << position << endl;
+            return 1;
+        }
+    }
+    cout << count << " accesses";
+    if (outOfBound) cout << ", " << outOfBound << " out of bound";
+    cout << "\n";
+    total.printStats(cout);
+    return 0;
+}
+
+static int sweephelper(TraceFile &trace, const vector<LevelConfig> &l1s,
+                       const vector<LevelConfig> &lower, size_t memorySize,
+                       ReplacementPolicy policy, WritePolicy writePolicy, size_t combine) {
+    // MODIFIES: trace
+    // EFFECTS: replays trace once for every L1 configuration in l1s and
+    //          prints the L1 counters of each. Returns the exit status.
+    bool stack = policy == POLICY_LRU;
+    for (const auto &l1 : l1s) {
+        stack = stack && l1.ways == 0;
+    }
+    StackDistance distances;
+    vector<unique_ptr<CacheSim>> sims;
+    if (!stack) {
+        for (const auto &l1 : l1s) {
+            vector<LevelConfig> configs(1, l1);
+            configs.insert(configs.end(), lower.begin(), lower.end());
+            sims.emplace_back(new CacheSim(configs, memorySize, policy, writePolicy, combine));
+        }
+    }
+    size_t limit = memorySize ? memorySize : size_t(-1);
+    Access a;
+    size_t count = 0, outOfBound = 0;
+    while (trace.next(a)) {
+        count++;
+        if (a.address >= limit) {
+            outOfBound++;
+        } else if (stack) {
+            distances.access(a.address);
+        } else {
+            for (auto &sim : sims) {
+                if (a.write) sim->write(a.address, a.value);
+                else sim->read(a.address);
+            }
+        }
+    }
+    if (trace.failed()) {
+        cerr << "Bad trace record at " << trace.position() << endl;
+        return 1;
+    }
+    cout << count << " accesses";
+    if (outOfBound) cout << ", " << outOfBound << " out of bound";
+    cout << "\n";
+    for (size_t i = 0; i < l1s.size(); i++) {
+        size_t accesses = count - outOfBound, hits;
+        if (stack) {
+            hits = distances.hits(l1s[i].blocks);
+        } else {
+            hits = sims[i]->levelStats(0).hits;
+        }
+        cout << l1s[i].blocks << " blocks: " << hits << " hits, " << accesses - hits
+             << " misses, miss ratio " << (accesses ? double(accesses - hits) / accesses : 0.0) << "\n";
+    }
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    size_t l1Ways = 0;
+    vector<LevelConfig> lower;
+    ReplacementPolicy policy = POLICY_LRU;
+    WritePolicy writePolicy = WRITE_BACK;
+    bool statsFlag = false;
+    string traceFile;
+    size_t traceBlocks = 0, traceMemory = 0, interval = 0;
+    size_t combine = WriteBuffer::DEFAULT_ENTRIES;
+    unsigned threads = 1;
+    vector<size_t> sweep;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        string value = i + 1 < argc ? argv[i + 1] : "";
+        LevelConfig config;
+        if (arg == "-stats") statsFlag = true;
+        else if (arg == "-trace" && i + 1 < argc) traceFile = argv[++i];
+        else if (arg == "-blocks" && i + 1 < argc) traceBlocks = strtoul(argv[++i], nullptr, 10);
+        else if (arg == "-memory" && i + 1 < argc) traceMemory = strtoul(argv[++i], nullptr, 10);
+        else if (arg == "-interval" && i + 1 < argc) interval = strtoul(argv[++i], nullptr, 10);
+        else if (arg == "-combine" && i + 1 < argc) combine = strtoul(argv[++i], nullptr, 10);
+        else if (arg == "-sweep" && i + 1 < argc) {
+            const char *p = argv[++i];
+            char *end;
+            do {
+                sweep.push_back(strtoul(p, &end, 10));
+                p = end + 1;
+            } while (*end == ',');
+        }
+        else if (arg == "-j" && i + 1 < argc) threads = unsigned(max(1L, strtol(argv[++i], nullptr, 10)));
+        else if (arg == "-ways" && i + 1 < argc) l1Ways = strtoul(argv[++i], nullptr, 10);
+        else if (arg == "-level" && parselevelhelper(value, config)) {
+            lower.push_back(config);
+            i++;
+        }
+        else if (arg == "-policy" && value == "lru") policy = POLICY_LRU, i++;
+        else if (arg == "-policy" && value == "fifo") policy = POLICY_FIFO, i++;
+        else if (arg == "-policy" && value == "random") policy = POLICY_RANDOM, i++;
+        else if (arg == "-policy" && value == "clock") policy = POLICY_CLOCK, i++;
+        else if (arg == "-write" && value == "back") writePolicy = WRITE_BACK, i++;
+        else if (arg == "-write" && value == "through") writePolicy = WRITE_THROUGH, i++;
+        else {
+            cerr << "Unknown option " << arg << endl;
+            return 1;
+        }
+    }
+
+    size_t cacheSize, memorySize;
+    TraceFile trace;
+    if (!traceFile.empty()) {
+        if (!traceBlocks && sweep.empty()) {
+            cerr << "-trace needs -blocks" << endl;
+            return 1;
+        }
+        if (threads > 1 && (interval || traceFile == "-")) {
+            cerr << "-j needs a trace file and no -interval" << endl;
+            return 1;
+        }
+        if (!trace.open(traceFile)) {
+            cerr << "Cannot open " << traceFile << endl;
+            return 1;
+        }
+        cacheSize = traceBlocks;
+        memorySize = traceMemory;
+    } else {
+        cin >> cacheSize >> memorySize >> ws;
+    }
+
+    vector<LevelConfig> configs(1, LevelConfig{cacheSize, l1Ways});
+    configs.insert(configs.end(), lower.begin(), lower.end());
+    for (size_t i = 0; i < configs.size(); i++) {
+        if (configs[i].ways && configs[i].blocks % configs[i].ways) {
+            cerr << "L" << i + 1 << ": " << configs[i].ways << " ways do not divide "
+                 << configs[i].blocks << " blocks" << endl;
+            return 1;
+        }
+    }
+    if (!sweep.empty()) {
+        if (traceFile.empty() || threads > 1 || interval) {
+            cerr << "-sweep needs -trace, and no -j or -interval" << endl;
+            return 1;
+        }
+        vector<LevelConfig> l1s;
+        for (auto blocks : sweep) {
+            if (l1Ways && blocks % l1Ways) {
+                cerr << "L1: " << l1Ways << " ways do not divide " << blocks << " blocks" << endl;
+                return 1;
+            }
+            l1s.push_back(LevelConfig{blocks, l1Ways});
+        }
+        ios::sync_with_stdio(false);
+        return sweephelper(trace, l1s, lower, memorySize, policy, writePolicy, combine);
+    }
+    if (threads > 1 && !traceFile.empty()) {
+        ios::sync_with_stdio(false);
+        return replayparallelhelper(traceFile, configs, memorySize, policy, writePolicy, combine, threads);
+    }
+    CacheSim cache(configs, memorySize, policy, writePolicy, combine);
+    if (!traceFile.empty()) {
+        ios::sync_with_stdio(false);
+        return replayhelper(trace, cache, interval);
+    }
 
     string line;
     istringstream iss;
@@ -35,14 +352,14 @@ int main() {
         iss >> instruction >> ws;
 
         if (instruction == "READ" || instruction == "WRITE") {
-            size_t index;
+            size_t address;
             int value;
             bool read = instruction == "READ";
-            if (!(iss >> index >> ws)) {
+            if (!(iss >> address >> ws)) {
                 cout << "ERROR: Not enough operands" << endl;
                 continue;
             }
-            if (index >= memorySize) {
+            if (address >= cache.memorySize()) {
                 cout << "ERROR: Address out of bound" << endl;
                 continue;
             }
@@ -54,47 +371,23 @@ int main() {
                 cout << "ERROR: Too many operands" << endl;
                 continue;
             }
-            auto block = new CacheBlock{index, value};
-            auto victim = cache.remove([](const CacheBlock *a, const CacheBlock *b) { return a->index == b->index; },
-                                       block);
-            if (victim) {
-                if (read) block->value = victim->value;
-                cache.insertFront(block);
-                delete victim;
-            } else {
-                if (read) block->value = memory[index];
-                cache.insertFront(block);
-                cacheUsed++;
-                if (cacheUsed > cacheSize) {
-                    victim = cache.removeBack();
-                    cacheUsed--;
-                    memory[victim->index] = victim->value;
-                    delete victim;
-                }
-            }
             if (read) {
-                cout << block->value << endl;
+                cout << cache.read(address) << endl;
+            } else {
+                cache.write(address, value);
             }
         } else if (instruction == "PRINTCACHE") {
             if (!iss.eof()) {
                 cout << "ERROR: Too many operands" << endl;
                 continue;
             }
-            auto temp = cache;
-            while (!temp.isEmpty()) {
-                auto block = temp.removeFront();
-                cout << block->index << " " << block->value << endl;
-                delete block;
-            }
+            cache.printCache(cout);
         } else if (instruction == "PRINTMEM") {
             if (!iss.eof()) {
                 cout << "ERROR: Too many operands" << endl;
                 continue;
             }
-            for (int i = 0; i < memorySize; i++) {
-                cout << memory[i] << " ";
-            }
-            cout << endl;
+            cache.printMemory(cout);
         } else if (instruction == "EXIT") {
             if (!iss.eof()) {
                 cout << "ERROR: Too many operands" << endl;
@@ -107,6 +400,8 @@ int main() {
 
     }
 
-
+    if (statsFlag) {
+        cache.printStats(cout);
+    }
     return 0;
 }
@@ -0,0 +1,433 @@
+//
+// Cache hierarchy model used by the cache simulator.
+//
+
+#include "cache_sim.h"
+
+#include <algorithm>
+#include <numeric>
+
+using namespace std;
+
+CacheLevel::CacheLevel(const LevelConfig &config, ReplacementPolicy policy) :
+        ways(config.ways ? config.ways : config.blocks), policy(policy),
+        sets(ways ? config.blocks / ways : 0), rng(280), stats() {
+    address.reserve(config.blocks + 1);
+}
+
+size_t CacheLevel::capacity() const {
+    return sets.size() * ways;
+}
+
+size_t CacheLevel::setCount() const {
+    return sets.size();
+}
+
+CacheBlock *CacheLevel::find(size_t address) {
+    auto found = this->address.find(address);
+    if (found == this->address.end()) {
+        return nullptr;
+    }
+    auto &block = Vlist<CacheBlock>::at(found->second);
+    if (policy == POLICY_LRU) {
+        sets[address % sets.size()].blocks.moveToFront(found->second);
+    } else if (policy == POLICY_CLOCK) {
+        block.referenced = true;
+    }
+    return &block;
+}
+
+size_t CacheLevel::victimhelper(Set &set) {
+    switch (policy) {
+        case POLICY_LRU:
+        case POLICY_FIFO:
+            return Vlist<CacheBlock>::at(set.blocks.back()).way;
+        case POLICY_RANDOM:
+            return rng() % ways;
+        case POLICY_CLOCK:
+            while (true) {
+                auto &block = Vlist<CacheBlock>::at(set.ways[set.hand]);
+                size_t way = set.hand;
+                set.hand = (set.hand + 1) % ways;
+                if (!block.referenced) {
+                    return way;
+                }
+                block.referenced = false;
+            }
+    }
+    return 0;
+}
+
+bool CacheLevel::fill(const CacheBlock &block, CacheBlock &victim) {
+    auto &set = sets[block.index % sets.size()];
+    bool evicted = set.ways.size() == ways;
+    size_t way = set.ways.size();
+    if (evicted) {
+        way = victimhelper(set);
+        victim = set.blocks.erase(set.ways[way]);
+        address.erase(victim.index);
+    } else {
+        set.ways.push_back(nullptr);
+    }
+    set.blocks.insertFront(block);
+    auto h = set.blocks.front();
+    Vlist<CacheBlock>::at(h).way = way;
+    set.ways[way] = h;
+    address.emplace(block.index, h);
+    return evicted;
+}
+
+void CacheLevel::print(ostream &os) const {
+    for (const auto &set : sets) {
+        for (const auto &block : set.blocks) {
+            os << block.index << " " << block.value << endl;
+        }
+    }
+}
+
+const size_t SparseMemory::PAGE_WORDS;
+
+SparseMemory::SparseMemory(size_t words) : words(words ? words : size_t(-1)) {}
+
+size_t SparseMemory::size() const {
+    return words;
+}
+
+int SparseMemory::read(size_t address) const {
+    auto found = pages.find(address / PAGE_WORDS);
+    return found == pages.end() ? 0 : found->second[address % PAGE_WORDS];
+}
+
+void SparseMemory::write(size_t address, int value) {
+    auto found = pages.find(address / PAGE_WORDS);
+    if (found == pages.end()) {
+        if (value == 0) {
+            return;
+        }
+        found = pages.emplace(address / PAGE_WORDS, unique_ptr<int[]>(new int[PAGE_WORDS]())).first;
+    }
+    found->second[address % PAGE_WORDS] = value;
+}
+
+void SparseMemory::write(const pair<size_t, int> *words, size_t n) {
+    size_t i = 0;
+    while (i < n) {
+        size_t page = words[i].first / PAGE_WORDS;
+        auto found = pages.find(page);
+        for (; i < n && words[i].first / PAGE_WORDS == page; i++) {
+            if (found == pages.end()) {
+                if (words[i].second == 0) {
+                    continue;
+                }
+                found = pages.emplace(page, unique_ptr<int[]>(new int[PAGE_WORDS]())).first;
+            }
+            found->second[words[i].first % PAGE_WORDS] = words[i].second;
+        }
+    }
+}
+
+void SparseMemory::print(ostream &os) const {
+    if (words != size_t(-1)) {
+        for (size_t base = 0; base < words; base += PAGE_WORDS) {
+            size_t n = min(PAGE_WORDS, words - base);
+            auto found = pages.find(base / PAGE_WORDS);
+            for (size_t i = 0; i < n; i++) {
+                os << (found == pages.end() ? 0 : found->second[i]) << " ";
+            }
+        }
+        os << endl;
+        return;
+    }
+    vector<size_t> touched;
+    for (const auto &page : pages) {
+        touched.push_back(page.first);
+    }
+    sort(touched.begin(), touched.end());
+    for (auto p : touched) {
+        const int *page = pages.at(p).get();
+        for (size_t i = 0; i < PAGE_WORDS; i++) {
+            if (page[i]) {
+                os << p * PAGE_WORDS + i << " " << page[i] << endl;
+            }
+        }
+    }
+}
+
+const size_t WriteBuffer::DEFAULT_ENTRIES;
+
+WriteBuffer::WriteBuffer(size_t entries) : entries(entries), log(nullptr), stats() {
+    pending.reserve(entries);
+}
+
+bool WriteBuffer::find(size_t address, int &value) const {
+    for (const auto &word : pending) {
+        if (word.first == address) {
+            value = word.second;
+            return true;
+        }
+    }
+    return false;
+}
+
+void WriteBuffer::write(SparseMemory &memory, size_t address, int value) {
+    if (log) {
+        memory.write(address, value);
+        log->emplace_back(address, value);
+        return;
+    }
+    stats.writes++;
+    if (entries == 0) {
+        memory.write(address, value);
+        return;
+    }
+    for (auto &word : pending) {
+        if (word.first == address) {
+            word.second = value;
+            stats.combined++;
+            return;
+        }
+    }
+    if (pending.size() == entries) {
+        flush(memory);
+    }
+    pending.emplace_back(address, value);
+}
+
+void WriteBuffer::flush(SparseMemory &memory) {
+    if (pending.empty()) {
+        return;
+    }
+    stats.flushes++;
+    sort(pending.begin(), pending.end());
+    memory.write(pending.data(), pending.size());
+    pending.clear();
+}
+
+void WriteBuffer::setLog(vector<pair<size_t, int>> *words) {
+    log = words;
+}
+
+CacheSim::CacheSim(const vector<LevelConfig> &configs, size_t memorySize,
+                   ReplacementPolicy policy, WritePolicy writePolicy, size_t bufferEntries) :
+        memory(memorySize), buffer(bufferEntries), writePolicy(writePolicy) {
+    for (const auto &config : configs) {
+        levels.emplace_back(config, policy);
+    }
+}
+
+size_t CacheSim::memorySize() const {
+    return memory.size();
+}
+
+size_t CacheSim::independentSets() const {
+    size_t s = 0;
+    for (const auto &l : levels) {
+        s = gcd(s, l.setCount());
+    }
+    return s;
+}
+
+const LevelStats &CacheSim::levelStats(size_t level) const {
+    return levels[level].stats;
+}
+
+const BufferStats &CacheSim::bufferStats() const {
+    return buffer.stats;
+}
+
+void CacheSim::addStats(const CacheSim &other) {
+    for (size_t i = 0; i < levels.size(); i++) {
+        auto &s = levels[i].stats;
+        const auto &o = other.levels[i].stats;
+        s.reads += o.reads;
+        s.writes += o.writes;
+        s.hits += o.hits;
+        s.misses += o.misses;
+        s.evictions += o.evictions;
+        s.writebacks += o.writebacks;
+    }
+    buffer.stats.writes += other.buffer.stats.writes;
+    buffer.stats.combined += other.buffer.stats.combined;
+    buffer.stats.flushes += other.buffer.stats.flushes;
+}
+
+void CacheSim::fillhelper(size_t level, size_t address, int value, bool dirty) {
+    // Put a block in a level that missed it, writing back what it displaces
+    auto &l = levels[level];
+    CacheBlock victim;
+    if (l.fill(CacheBlock{address, value, dirty, true, 0}, victim)) {
+        l.stats.evictions++;
+        if (victim.dirty) {
+            l.stats.writebacks++;
+            storehelper(level + 1, victim.index, victim.value);
+        }
+    }
+}
+
+int CacheSim::loadhelper(size_t level, size_t address) {
+    if (level == levels.size()) {
+        int value;
+        return buffer.find(address, value) ? value : memory.read(address);
+    }
+    auto &l = levels[level];
+    l.stats.reads++;
+    auto block = l.find(address);
+    if (block) {
+        l.stats.hits++;
+        return block->value;
+    }
+    l.stats.misses++;
+    int value = loadhelper(level + 1, address);
+    if (l.capacity()) {
+        fillhelper(level, address, value, false);
+    }
+    return value;
+}
+
+void CacheSim::storehelper(size_t level, size_t address, int value) {
+    if (level == levels.size()) {
+        buffer.write(memory, address, value);
+        return;
+    }
+    auto &l = levels[level];
+    l.stats.writes++;
+    bool back = writePolicy == WRITE_BACK && l.capacity();
+    auto block = l.find(address);
+    if (block) {
+        l.stats.hits++;
+        block->value = value;
+        block->dirty = block->dirty || back;
+    } else {
+        l.stats.misses++;
+        if (l.capacity()) {
+            fillhelper(level, address, value, back);
+        }
+    }
+    if (!back) {
+        storehelper(level + 1, address, value);
+    }
+}
+
+int CacheSim::read(size_t address) {
+    return loadhelper(0, address);
+}
+
+void CacheSim::write(size_t address, int value) {
+    storehelper(0, address, value);
+}
+
+void CacheSim::logMemoryWrites(vector<pair<size_t, int>> *words) {
+    buffer.setLog(words);
+}
+
+void CacheSim::writeMemory(size_t address, int value) {
+    buffer.write(memory, address, value);
+}
+
+void CacheSim::printCache(ostream &os) const {
+    for (size_t i = 0; i < levels.size(); i++) {
+        if (levels.size() > 1) {
+            os << "L" << i + 1 << endl;
+        }
+        levels[i].print(os);
+    }
+}
+
+void CacheSim::printMemory(ostream &os) {
+    buffer.flush(memory);
+    memory.print(os);
+}
+
+void CacheSim::printStats(ostream &os) const {
+    for (size_t i = 0; i < levels.size(); i++) {
+        const auto &s = levels[i].stats;
+        os << "L" << i + 1 << ": " << s.reads << " reads, " << s.writes << " writes, "
+           << s.hits << " hits, " << s.misses << " misses, " << s.evictions << " evictions ("
+           << s.evictions - s.writebacks << " clean, " << s.writebacks << " dirty), "
+           << s.writebacks << " writebacks" << endl;
+    }
+    const auto &b = buffer.stats;
+    os << "memory: " << b.writes << " writes, " << b.combined << " combined, "
+       << b.flushes << " flushes" << endl;
+}
+
+const size_t StackDistance::NONE;
+const size_t StackDistance::MIN_TIMES;
+
+StackDistance::StackDistance() :
+        tree(MIN_TIMES + 1, 0), owner(MIN_TIMES, NONE), histogram(1, 0), now(0), total(0) {}
+
+void StackDistance::addhelper(size_t time, size_t delta) {
+    // delta is added modulo 2^64, so size_t(-1) takes a mark away
+    for (size_t i = time + 1; i < tree.size(); i += i & (0 - i)) {
+        tree[i] += delta;
+    }
+}
+
+size_t StackDistance::countfromhelper(size_t time) const {
+    // Marks at times >= time: all marks less those before time
+    size_t before = 0;
+    for (size_t i = time; i > 0; i -= i & (0 - i)) {
+        before += tree[i];
+    }
+    return last.size() - before;
+}
+
+void StackDistance::compacthelper() {
+    // Renumber the marked times 0, 1, ... in order, keeping their order
+    size_t k = 0;
+    for (size_t t = 0; t < owner.size(); t++) {
+        if (owner[t] != NONE) {
+            last[owner[t]] = k;
+            owner[k++] = owner[t];
+        }
+    }
+    size_t times = max(MIN_TIMES, 2 * k);
+    owner.resize(times);
+    fill(owner.begin() + k, owner.end(), NONE);
+    tree.assign(times + 1, 0);
+    for (size_t i = 1; i <= times; i++) {
+        // Linear-time build: every node adds its own mark and passes its
+        // sum up to its parent
+        if (i <= k) tree[i] += 1;
+        size_t parent = i + (i & (0 - i));
+        if (parent <= times) tree[parent] += tree[i];
+    }
+    now = k;
+}
+
+void StackDistance::access(size_t address) {
+    if (now == owner.size()) {
+        compacthelper();
+    }
+    total++;
+    auto found = last.find(address);
+    if (found == last.end()) {
+        last.emplace(address, now);
+    } else {
+        size_t d = countfromhelper(found->second);
+        if (d >= histogram.size()) histogram.resize(max(d + 1, 2 * histogram.size()), 0);
+        histogram[d]++;
+        addhelper(found->second, size_t(-1));
+        owner[found->second] = NONE;
+        found->second = now;
+    }
+    addhelper(now, 1);
+    owner[now++] = address;
+}
+
+size_t StackDistance::accesses() const {
+    return total;
+}
+
+size_t StackDistance::distinct() const {
+    return last.size();
+}
+
+size_t StackDistance::hits(size_t blocks) const {
+    size_t h = 0;
+    for (size_t d = 1; d <= blocks && d < histogram.size(); d++) {
+        h += histogram[d];
+    }
+    return h;
+}
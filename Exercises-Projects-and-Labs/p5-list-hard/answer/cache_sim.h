@@ -0,0 +1,335 @@
+//
+// Cache hierarchy model used by the cache simulator.
+//
+
+#ifndef VE280_CACHE_SIM_H
+#define VE280_CACHE_SIM_H
+
+#include <cstddef>
+#include <memory>
+#include <ostream>
+#include <random>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "vlist.h"
+
+enum ReplacementPolicy {
+    POLICY_LRU,     // Evict the least recently used block
+    POLICY_FIFO,    // Evict the block filled longest ago
+    POLICY_RANDOM,  // Evict a block chosen at random
+    POLICY_CLOCK,   // Second chance: evict the first unreferenced block
+};
+
+enum WritePolicy {
+    WRITE_BACK,     // A write stays in its level until the block is evicted
+    WRITE_THROUGH,  // A write also goes to every level below and to memory
+};
+
+struct CacheBlock {
+    size_t index;       // Memory address of the word held
+    int value;
+    bool dirty;         // Written since it was filled (write-back only)
+    bool referenced;    // CLOCK's reference bit
+    size_t way;         // The slot of its set the block occupies
+};
+
+struct LevelConfig {
+    size_t blocks;      // Number of one-word blocks
+    size_t ways;        // Blocks per set; 0 for a fully associative level
+};
+
+struct LevelStats {
+    size_t reads;
+    size_t writes;
+    size_t hits;
+    size_t misses;
+    size_t evictions;
+    size_t writebacks;  // Dirty blocks written to the level below; the
+                        // other evictions were clean and cost nothing
+};
+
+struct BufferStats {
+    size_t writes;      // Words written to memory
+    size_t combined;    // Of those, the ones that replaced a waiting word
+    size_t flushes;
+};
+
+class CacheLevel {
+    // OVERVIEW: one level of a cache, holding up to "blocks" words in sets
+    //           of "ways" blocks. Address a maps to set a % (blocks / ways).
+    //           Each set keeps its blocks on a list, most recently used
+    //           first for LRU and most recently filled first otherwise, and
+    //           remembers which way every block sits in for the policies
+    //           that choose a victim by position.
+
+    struct Set {
+        Vlist<CacheBlock> blocks;
+        std::vector<Vlist<CacheBlock>::handle> ways;    // The block in each way
+        size_t hand;                                    // CLOCK's next candidate
+
+        Set() : hand(0) {}
+    };
+
+    size_t ways;
+    ReplacementPolicy policy;
+    std::vector<Set> sets;
+    std::unordered_map<size_t, Vlist<CacheBlock>::handle> address;
+    std::minstd_rand rng;
+
+    size_t victimhelper(Set &set);
+    // REQUIRES set is full
+    // MODIFIES set, rng
+    // EFFECTS returns the way whose block the policy evicts from set
+
+   public:
+    LevelStats stats;
+
+    CacheLevel(const LevelConfig &config, ReplacementPolicy policy);
+    // REQUIRES config.ways is 0 or divides config.blocks
+    // EFFECTS constructs an empty level
+
+    CacheLevel(const CacheLevel &) = delete;
+    // The sets' way tables point into their lists, so a level is never copied
+    CacheLevel(CacheLevel &&) = default;
+
+    size_t capacity() const;
+    // EFFECTS returns how many blocks the level holds when full
+
+    size_t setCount() const;
+    // EFFECTS returns the number of sets
+
+    CacheBlock *find(size_t address);
+    // MODIFIES this
+    // EFFECTS returns the block holding address, or NULL if there is none.
+    //         A block found counts as used.
+
+    bool fill(const CacheBlock &block, CacheBlock &victim);
+    // REQUIRES capacity() > 0 and no block holds block.index
+    // MODIFIES this, victim
+    // EFFECTS puts block in its set. If the set was full, evicts a block
+    //         chosen by the policy, copies it to victim and returns true.
+
+    void print(std::ostream &os) const;
+    // MODIFIES os
+    // EFFECTS writes "address value" for every block, set by set
+};
+
+class SparseMemory {
+    // OVERVIEW: word-addressed memory backed by 4 KiB pages, which are
+    //           allocated on the first write of a nonzero word. Words of
+    //           pages never written read as zero, so the memory used grows
+    //           with the working set rather than with the address space.
+
+    static const size_t PAGE_WORDS = 4096 / sizeof(int);
+
+    std::unordered_map<size_t, std::unique_ptr<int[]>> pages;
+    size_t words;
+
+   public:
+    explicit SparseMemory(size_t words);
+    // EFFECTS constructs a zeroed memory of "words" words, or of the whole
+    //         address space if words is 0
+
+    size_t size() const;
+    // EFFECTS returns the number of addressable words
+
+    int read(size_t address) const;
+    // REQUIRES address < size()
+    // EFFECTS returns the word at address
+
+    void write(size_t address, int value);
+    // REQUIRES address < size()
+    // MODIFIES this
+    // EFFECTS stores value at address
+
+    void write(const std::pair<size_t, int> *words, size_t n);
+    // REQUIRES the n words are in increasing order of address, each less
+    //          than size()
+    // MODIFIES this
+    // EFFECTS stores every value at its address, looking up each page once
+    //         for a run of words in it
+
+    void print(std::ostream &os) const;
+    // MODIFIES os
+    // EFFECTS writes every word on one line if the size was given, or else
+    //         "address value" for every nonzero word, in address order.
+    //         Only pages that were written are visited.
+};
+
+class WriteBuffer {
+    // OVERVIEW: a write-combining buffer in front of a SparseMemory. The
+    //           words written to memory wait in up to "entries" slots, a
+    //           later write to a waiting word replacing it, and are stored
+    //           together in address order when the slots run out, so a
+    //           flush finds each page once. Reads look in the slots first.
+
+    std::vector<std::pair<size_t, int>> pending;
+    size_t entries;
+    std::vector<std::pair<size_t, int>> *log;  // Takes the words instead, if set
+
+   public:
+    static const size_t DEFAULT_ENTRIES = 16;
+
+    BufferStats stats;
+
+    explicit WriteBuffer(size_t entries);
+    // EFFECTS constructs an empty buffer of "entries" slots; one of 0
+    //         passes every write straight to memory
+
+    bool find(size_t address, int &value) const;
+    // MODIFIES value
+    // EFFECTS returns true and the waiting word in value if address has
+    //         one, or false
+
+    void write(SparseMemory &memory, size_t address, int value);
+    // REQUIRES address < memory.size()
+    // MODIFIES this, memory
+    // EFFECTS puts value for address in the buffer, flushing it to memory
+    //         first if it is full
+
+    void flush(SparseMemory &memory);
+    // MODIFIES this, memory
+    // EFFECTS stores the waiting words in memory and empties the buffer
+
+    void setLog(std::vector<std::pair<size_t, int>> *words);
+    // MODIFIES this
+    // EFFECTS makes every later write store its word in memory at once and
+    //         append it to *words, uncounted, or undoes that if words is
+    //         null
+};
+
+class CacheSim {
+    // OVERVIEW: a stack of cache levels, L1 first, in front of a
+    //           SparseMemory. A level that misses asks the level
+    //           below; the block is then filled into every level that
+    //           missed. Levels are neither inclusive nor exclusive: a block
+    //           evicted from one level is written to the next only if it is
+    //           dirty, and every write allocates. What reaches memory passes
+    //           through a WriteBuffer.
+
+    std::vector<CacheLevel> levels;
+    SparseMemory memory;
+    WriteBuffer buffer;
+    WritePolicy writePolicy;
+
+    int loadhelper(size_t level, size_t address);
+    void storehelper(size_t level, size_t address, int value);
+    void fillhelper(size_t level, size_t address, int value, bool dirty);
+
+   public:
+    CacheSim(const std::vector<LevelConfig> &configs, size_t memorySize,
+             ReplacementPolicy policy, WritePolicy writePolicy,
+             size_t bufferEntries = WriteBuffer::DEFAULT_ENTRIES);
+    // REQUIRES every config is valid for CacheLevel
+    // EFFECTS constructs empty levels in front of a zeroed memory of
+    //         memorySize words, or of the whole address space if 0, with
+    //         a write buffer of bufferEntries slots
+
+    size_t memorySize() const;
+    // EFFECTS returns the number of words of memory
+
+    size_t independentSets() const;
+    // EFFECTS returns the largest S such that two addresses that differ
+    //         modulo S never share a set at any level, or 0 if no level
+    //         holds any block. Accesses to addresses that differ modulo S
+    //         do not affect each other.
+
+    const LevelStats &levelStats(size_t level) const;
+    // REQUIRES level is less than the number of levels
+    // EFFECTS returns the counters of level "level", 0 for L1
+
+    const BufferStats &bufferStats() const;
+    // EFFECTS returns the counters of the write buffer
+
+    void addStats(const CacheSim &other);
+    // REQUIRES other has as many levels as this
+    // MODIFIES this
+    // EFFECTS adds the counters of every level and of the write buffer of
+    //         other to this
+
+    int read(size_t address);
+    // REQUIRES address < memorySize()
+    // MODIFIES this
+    // EFFECTS returns the word at address
+
+    void write(size_t address, int value);
+    // REQUIRES address < memorySize()
+    // MODIFIES this
+    // EFFECTS stores value at address
+
+    void logMemoryWrites(std::vector<std::pair<size_t, int>> *words);
+    // MODIFIES this
+    // EFFECTS makes the words that reach memory skip the write buffer and
+    //         go to the end of *words as well, so that another CacheSim can
+    //         pass them through its own buffer with writeMemory(); a null
+    //         words ends that
+
+    void writeMemory(size_t address, int value);
+    // REQUIRES address < memorySize()
+    // MODIFIES this
+    // EFFECTS passes value for address through the write buffer to memory,
+    //         as a word written back by the last level is
+
+    void printCache(std::ostream &os) const;
+    // MODIFIES os
+    // EFFECTS writes the blocks of every level, each level headed by its
+    //         name if there is more than one
+
+    void printMemory(std::ostream &os);
+    // MODIFIES this, os
+    // EFFECTS flushes the write buffer and writes the words of memory, as
+    //         SparseMemory::print()
+
+    void printStats(std::ostream &os) const;
+    // MODIFIES os
+    // EFFECTS writes the counters of every level, one line each, with
+    //         their clean and dirty evictions, then those of the write
+    //         buffer
+};
+
+class StackDistance {
+    // OVERVIEW: Mattson's stack algorithm. Records, for every access, how
+    //           many distinct addresses were used since the last access to
+    //           the same one; a fully associative LRU cache of C blocks
+    //           hits exactly the accesses at a distance of at most C, so one
+    //           pass gives the hits of every cache size. Distances are
+    //           counted with a Fenwick tree over access times in which the
+    //           latest access to each address is marked; its times are
+    //           renumbered when it fills, so it stays a small multiple of
+    //           the number of distinct addresses.
+
+    static const size_t NONE = size_t(-1);
+    static const size_t MIN_TIMES = 1 << 16;
+
+    std::unordered_map<size_t, size_t> last;    // Address -> time of its latest access
+    std::vector<size_t> tree;                   // Fenwick tree of the marks
+    std::vector<size_t> owner;                  // Time -> address marked there, or NONE
+    std::vector<size_t> histogram;              // histogram[d]: accesses at distance d
+    size_t now;
+    size_t total;
+
+    void addhelper(size_t time, size_t delta);
+    size_t countfromhelper(size_t time) const;
+    void compacthelper();
+
+   public:
+    StackDistance();
+
+    void access(size_t address);
+    // MODIFIES this
+    // EFFECTS records an access to address
+
+    size_t accesses() const;
+    // EFFECTS returns the number of accesses recorded
+
+    size_t distinct() const;
+    // EFFECTS returns the number of distinct addresses accessed
+
+    size_t hits(size_t blocks) const;
+    // EFFECTS returns how many accesses a fully associative LRU cache of
+    //         "blocks" blocks would have hit
+};
+
+#endif //VE280_CACHE_SIM_H
@@ -0,0 +1,101 @@
+#ifndef __CONCURRENT_DLIST_H__
+#define __CONCURRENT_DLIST_H__
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+#include "dlist.h"
+
+template <class T>
+class ConcurrentDlist {
+    // OVERVIEW: a double-ended list of Objects, shared by threads as a
+    //           work-stealing deque (Chase and Lev; with the memory orders
+    //           of Le et al., "Correct and Efficient Work-Stealing for Weak
+    //           Memory Models", 2013). One thread, the owner, inserts and
+    //           removes at the back; any thread may take from the front at
+    //           the same time, without locks.
+    //
+    //           The objects are held in a circular array that the owner
+    //           doubles when full. A thief may still be reading an array
+    //           that was replaced, so the old arrays are only freed with
+    //           the list.
+    //
+    //           Like Dlist, the list owns the objects it holds, and
+    //           deletes those left in it when destroyed.
+
+   public:
+    // Operational methods
+
+    bool isEmpty() const;
+    // EFFECTS: returns true if list is empty, false otherwise; while
+    //          other threads change it, the answer may already be stale
+
+    void insertBack(T *op);
+    // REQUIRES called by the owner
+    // MODIFIES this
+    // EFFECTS inserts o at the back of the list
+
+    T *removeBack();
+    // REQUIRES called by the owner
+    // MODIFIES this
+    // EFFECTS removes and returns last object from non-empty list
+    //         throws an instance of emptyList if empty, which includes
+    //         a thief having taken the last object first
+
+    T *steal();
+    // MODIFIES this
+    // EFFECTS removes and returns the first object; returns NULL if the
+    //         list is empty or another thread took that object first.
+    //         Lock-free: it fails only because another thread made
+    //         progress
+
+    T *removeFront();
+    // MODIFIES this
+    // EFFECTS removes and returns first object from non-empty list,
+    //         trying again while other threads take objects first
+    //         throws an instance of emptyList if empty
+
+    // Maintenance methods
+    ConcurrentDlist();                                      // constructor
+    ConcurrentDlist(const ConcurrentDlist &l) = delete;
+    ConcurrentDlist &operator=(const ConcurrentDlist &l) = delete;
+    ~ConcurrentDlist();                                     // destructor
+    // REQUIRES no other thread uses the list any more
+
+   private:
+    // A private type
+    struct array {
+        long long mask;                 // The size, a power of two, minus one
+        std::atomic<T *> *slots;
+
+        explicit array(long long size);
+        ~array();
+
+        T *get(long long i) const;
+        void put(long long i, T *op);
+    };
+
+    static const long long FIRST_SIZE = 64;
+
+    // Padded apart, as the owner writes bottom and the thieves top
+    alignas(64) std::atomic<long long> top;     // The index of the first object
+    alignas(64) std::atomic<long long> bottom;  // The index past the last object
+    std::atomic<array *> objects;
+    std::vector<array *> retired;   // The arrays replaced; the owner's only
+
+    int stealhelper(T *&op);
+    // MODIFIES this, op
+    // EFFECTS tries once to take the first object into op; returns 1 if it
+    //         did, 0 if the list is empty, -1 if another thread took it
+
+    array *grow(array *a, long long b, long long t);
+    // REQUIRES called by the owner; a holds [t, b)
+    // MODIFIES this
+    // EFFECTS replaces the array by one twice as large, holding the same
+    //         objects at the same indices, and returns it
+};
+
+#include "concurrent_dlist_impl.h"
+
+#endif /* __CONCURRENT_DLIST_H__ */
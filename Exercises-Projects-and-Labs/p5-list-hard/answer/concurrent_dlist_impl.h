@@ -0,0 +1,129 @@
+#ifndef VE280_CONCURRENT_DLIST_IMPL_H
+#define VE280_CONCURRENT_DLIST_IMPL_H
+
+#include "concurrent_dlist.h"
+
+template<class T>
+ConcurrentDlist<T>::array::array(long long size) : mask(size - 1), slots(new std::atomic<T *>[size]) {}
+
+template<class T>
+ConcurrentDlist<T>::array::~array() {
+    delete[] slots;
+}
+
+template<class T>
+T *ConcurrentDlist<T>::array::get(long long i) const {
+    return slots[i & mask].load(std::memory_order_relaxed);
+}
+
+template<class T>
+void ConcurrentDlist<T>::array::put(long long i, T *op) {
+    slots[i & mask].store(op, std::memory_order_relaxed);
+}
+
+template<class T>
+ConcurrentDlist<T>::ConcurrentDlist() : top(0), bottom(0), objects(new array(FIRST_SIZE)) {}
+
+template<class T>
+ConcurrentDlist<T>::~ConcurrentDlist() {
+    array *a = objects.load(std::memory_order_relaxed);
+    long long b = bottom.load(std::memory_order_relaxed);
+    for (long long i = top.load(std::memory_order_relaxed); i < b; i++) {
+        delete a->get(i);
+    }
+    delete a;
+    for (auto old : retired) {
+        delete old;
+    }
+}
+
+template<class T>
+bool ConcurrentDlist<T>::isEmpty() const {
+    return bottom.load(std::memory_order_acquire) <= top.load(std::memory_order_acquire);
+}
+
+template<class T>
+typename ConcurrentDlist<T>::array *ConcurrentDlist<T>::grow(array *a, long long b, long long t) {
+    array *bigger = new array(2 * (a->mask + 1));
+    for (long long i = t; i < b; i++) {
+        bigger->put(i, a->get(i));
+    }
+    retired.push_back(a);
+    objects.store(bigger, std::memory_order_release);
+    return bigger;
+}
+
+template<class T>
+void ConcurrentDlist<T>::insertBack(T *op) {
+    long long b = bottom.load(std::memory_order_relaxed);
+    long long t = top.load(std::memory_order_acquire);
+    array *a = objects.load(std::memory_order_relaxed);
+    if (b - t > a->mask) {
+        a = grow(a, b, t);
+    }
+    a->put(b, op);
+    // Released, so that a thief that sees the new bottom sees the object
+    bottom.store(b + 1, std::memory_order_release);
+}
+
+template<class T>
+T *ConcurrentDlist<T>::removeBack() {
+    long long b = bottom.load(std::memory_order_relaxed) - 1;
+    array *a = objects.load(std::memory_order_relaxed);
+    bottom.store(b, std::memory_order_relaxed);
+    // Claims the last object before looking at top, so that a thief
+    // either sees it claimed or is seen by the owner
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    long long t = top.load(std::memory_order_relaxed);
+    if (t > b) {
+        bottom.store(b + 1, std::memory_order_relaxed);
+        throw emptyList();
+    }
+    T *op = a->get(b);
+    if (t == b) {
+        // The last object: the owner and the thieves race for it on top
+        bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+        bottom.store(b + 1, std::memory_order_relaxed);
+        if (!won) {
+            throw emptyList();
+        }
+    }
+    return op;
+}
+
+template<class T>
+int ConcurrentDlist<T>::stealhelper(T *&op) {
+    long long t = top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    long long b = bottom.load(std::memory_order_acquire);
+    if (t >= b) {
+        return 0;
+    }
+    // The array is read before top is claimed: once claimed, the owner may
+    // overwrite the slot
+    op = objects.load(std::memory_order_acquire)->get(t);
+    if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        return -1;
+    }
+    return 1;
+}
+
+template<class T>
+T *ConcurrentDlist<T>::steal() {
+    T *op;
+    return stealhelper(op) > 0 ? op : nullptr;
+}
+
+template<class T>
+T *ConcurrentDlist<T>::removeFront() {
+    T *op;
+    int result;
+    while ((result = stealhelper(op)) < 0) {
+    }
+    if (result == 0) {
+        throw emptyList();
+    }
+    return op;
+}
+
+#endif //VE280_CONCURRENT_DLIST_IMPL_H
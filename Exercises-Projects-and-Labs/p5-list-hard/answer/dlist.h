@@ -1,15 +1,35 @@
 #ifndef __DLIST_H__
 #define __DLIST_H__
 
+#include <cstddef>
+#include <iterator>
+
+#include "node_pool.h"
+
 class emptyList {
     // OVERVIEW: an exception class
 };
 
-template <class T>
+template <class T, template <class> class Alloc = NodePool>
 class Dlist {
     // OVERVIEW: contains a double-ended list of Objects
+    //           Nodes come from an Alloc<node>, which must provide
+    //           node *allocate() and void deallocate(node *). The default
+    //           NodePool recycles them; HeapNodes uses new and delete;
+    //           alloc::Nodes, of alloc/alloc.h, takes them from a memory
+    //           resource, given as Dlist<T, alloc::Nodes> list(&resource).
+    //           merge() also needs void adopt(Alloc<node> &), by which
+    //           an Alloc takes over the nodes another one handed out.
+
+    struct node;
 
    public:
+    typedef Alloc<node> allocator_type;
+
+    typedef node *handle;
+    // A handle names one node of the list. It stays valid until that node
+    // is removed, however the list is reordered.
+
     // Operational methods
 
     bool isEmpty() const;
@@ -41,10 +61,118 @@ class Dlist {
     //         removes and returns this object from the list
     //         returns NULL pointer if no such node exists
 
+    handle front() const;
+    // EFFECTS returns a handle to the first node, or NULL if empty
+
+    handle back() const;
+    // EFFECTS returns a handle to the last node, or NULL if empty
+
+    static T *at(handle h);
+    // REQUIRES h names a node of some list
+    // EFFECTS returns the object in the node named by h
+
+    void splice(handle pos, handle h);
+    // REQUIRES h names a node of this list; pos names one too, or is NULL
+    // MODIFIES this
+    // EFFECTS moves the node named by h to just before pos, or to the back
+    //         if pos is NULL, in constant time and without allocating
+
+    void moveToFront(handle h);
+    // REQUIRES h names a node of this list
+    // MODIFIES this
+    // EFFECTS moves the node named by h to the front in constant time
+
+    T *erase(handle h);
+    // REQUIRES h names a node of this list
+    // MODIFIES this
+    // EFFECTS removes the node named by h in constant time and returns its
+    //         object; h is no longer valid
+
+    void sort(bool (*cmp)(const T*, const T*));
+    // REQUIRES cmp(a, b) tells whether a goes before b, a strict weak order
+    // MODIFIES this
+    // EFFECTS puts the objects in the order of cmp, those equal in the
+    //         order they were in, by a bottom-up merge sort in O(n log n).
+    //         The nodes are relinked, not allocated, so handles stay valid
+
+    void merge(Dlist &l, bool (*cmp)(const T*, const T*));
+    // REQUIRES this and l are each in the order of cmp, as sort() leaves
+    //          them
+    // MODIFIES this, l
+    // EFFECTS moves the nodes of l into this in the order of cmp, those of
+    //         this before equal ones of l, in O(n + m) without allocating
+    //         nodes, and leaves l empty. Handles of l name nodes of this,
+    //         whose Alloc takes over those l handed out
+
+    template <bool reverse>
+    class basic_const_iterator {
+        // OVERVIEW: walks the list front to back, or back to front if
+        //           reverse, without changing it. It yields the
+        //           objects the list points to.
+        //           An iterator stays valid until the node it is at is
+        //           removed, however the list is reordered, but reordering
+        //           while walking may skip or repeat nodes.
+
+        const node *cur;    // The node at, or NULL past the end
+        const node *start;  // The node the walk began at
+
+        friend class Dlist;
+
+        basic_const_iterator(const node *cur) : cur(cur), start(cur) {}
+
+       public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const T *pointer;
+        typedef const T &reference;
+
+        basic_const_iterator() : cur(nullptr), start(nullptr) {}
+
+        reference operator*() const { return *cur->op; }
+
+        pointer operator->() const { return cur->op; }
+
+        basic_const_iterator &operator++() {
+            // REQUIRES this is not past the end
+            cur = reverse ? cur->prev : cur->next;
+            if (cur == start) cur = nullptr;
+            return *this;
+        }
+
+        basic_const_iterator operator++(int) {
+            basic_const_iterator old = *this;
+            ++*this;
+            return old;
+        }
+
+        bool operator==(const basic_const_iterator &i) const { return cur == i.cur; }
+
+        bool operator!=(const basic_const_iterator &i) const { return cur != i.cur; }
+    };
+
+    typedef basic_const_iterator<false> const_iterator;
+    typedef basic_const_iterator<true> const_reverse_iterator;
+
+    const_iterator begin() const;
+    // EFFECTS returns an iterator at the first object, or end() if empty
+
+    const_iterator end() const;
+    // EFFECTS returns the iterator past the last object
+
+    const_reverse_iterator rbegin() const;
+    // EFFECTS returns an iterator at the last object, or rend() if empty
+
+    const_reverse_iterator rend() const;
+    // EFFECTS returns the iterator past the first object
+
     // Maintenance methods
     Dlist();                           // constructor
+    explicit Dlist(allocator_type a);  // constructor, with nodes from a
     Dlist(const Dlist &l);             // copy constructor
     Dlist &operator=(const Dlist &l);  // assignment operator
+    Dlist(Dlist &&l);                  // move constructor
+    Dlist &operator=(Dlist &&l);       // move assignment
     ~Dlist();                          // destructor
 
    private:
@@ -57,9 +185,22 @@ class Dlist {
 
     node *first;  // The pointer to the first node (NULL if none)
     node *last;   // The pointer to the last node (NULL if none)
+    Alloc<node> nodes;  // Where nodes come from; moved, never copied
 
     // Utility methods
 
+    static node *mergeRuns(node *a, node *b, bool (*cmp)(const T*, const T*));
+    // REQUIRES a and b are runs of nodes linked by next and ended by NULL,
+    //          each in the order of cmp
+    // EFFECTS links the nodes of both into one run in the order of cmp,
+    //         those of a before equal ones of b, and returns its first node
+
+    void relink(node *run);
+    // REQUIRES run is a run of nodes linked by next and ended by NULL
+    // MODIFIES this
+    // EFFECT: makes the list the nodes of run in its order, setting their
+    //         prev links and closing the circle
+
     void removeAll();
     // EFFECT: called by destructor/operator= to remove and destroy
     //         all list elements
@@ -5,16 +5,20 @@
 #ifndef VE280_DLIST_IMPL_H
 #define VE280_DLIST_IMPL_H
 
+#include <utility>
+
 #include "dlist.h"
+#include "../../../bench/tracing.h"
 
-template<class T>
-bool Dlist<T>::isEmpty() const {
+template<class T, template <class> class Alloc>
+bool Dlist<T, Alloc>::isEmpty() const {
     return first == nullptr;
 }
 
-template<class T>
-void Dlist<T>::insertFront(T *op) {
-    auto newNode = new node;
+template<class T, template <class> class Alloc>
+void Dlist<T, Alloc>::insertFront(T *op) {
+    TRACE_SCOPE("Dlist::insertFront");
+    auto newNode = nodes.allocate();
     newNode->op = op;
     if (isEmpty()) {
         first = last = newNode->prev = newNode->next = newNode;
@@ -25,9 +29,10 @@ void Dlist<T>::insertFront(T *op) {
     }
 }
 
-template<class T>
-void Dlist<T>::insertBack(T *op) {
-    auto newNode = new node;
+template<class T, template <class> class Alloc>
+void Dlist<T, Alloc>::insertBack(T *op) {
+    TRACE_SCOPE("Dlist::insertBack");
+    auto newNode = nodes.allocate();
     newNode->op = op;
     if (isEmpty()) {
         first = last = newNode->prev = newNode->next = newNode;
@@ -38,8 +43,9 @@ void Dlist<T>::insertBack(T *op) {
     }
 }
 
-template<class T>
-T *Dlist<T>::removeFront() {
+template<class T, template <class> class Alloc>
+T *Dlist<T, Alloc>::removeFront() {
+    TRACE_SCOPE("Dlist::removeFront");
     if (isEmpty()) {
         throw emptyList();
     }
@@ -51,12 +57,13 @@ T *Dlist<T>::removeFront() {
         first = victim->prev->next = victim->next;
         victim->next->prev = victim->prev;
     }
-    delete victim;
+    nodes.deallocate(victim);
     return op;
 }
 
-template<class T>
-T *Dlist<T>::removeBack() {
+template<class T, template <class> class Alloc>
+T *Dlist<T, Alloc>::removeBack() {
+    TRACE_SCOPE("Dlist::removeBack");
     if (isEmpty()) {
         throw emptyList();
     }
@@ -68,12 +75,12 @@ T *Dlist<T>::removeBack() {
         victim->prev->next = victim->next;
         last = victim->next->prev = victim->prev;
     }
-    delete victim;
+    nodes.deallocate(victim);
     return op;
 }
 
-template<class T>
-T * Dlist<T>::remove(bool (*cmp)(const T *, const T *), T *ref) {
+template<class T, template <class> class Alloc>
+T * Dlist<T, Alloc>::remove(bool (*cmp)(const T *, const T *), T *ref) {
     if (isEmpty()) {
         return nullptr;
     }
@@ -89,7 +96,7 @@ T * Dlist<T>::remove(bool (*cmp)(const T *, const T *), T *ref) {
             auto op = temp->op;
             temp->prev->next = temp->next;
             temp->next->prev = temp->prev;
-            delete temp;
+            nodes.deallocate(temp);
             return op;
         }
         temp = temp->prev;
@@ -97,46 +104,244 @@ T * Dlist<T>::remove(bool (*cmp)(const T *, const T *), T *ref) {
     return nullptr;
 }
 
-template<class T>
-Dlist<T>::Dlist() {
+template<class T, template <class> class Alloc>
+typename Dlist<T, Alloc>::handle Dlist<T, Alloc>::front() const {
+    return first;
+}
+
+template<class T, template <class> class Alloc>
+typename Dlist<T, Alloc>::handle Dlist<T, Alloc>::back() const {
+    return last;
+}
+
+template<class T, template <class> class Alloc>
+T *Dlist<T, Alloc>::at(handle h) {
+    return h->op;
+}
+
+template<class T, template <class> class Alloc>
+void Dlist<T, Alloc>::moveToFront(handle h) {
+    TRACE_SCOPE("Dlist::moveToFront");
+    if (h == first) {
+        return;
+    }
+    if (h == last) {
+        // The list is circular: the last node becomes first by rotation
+        first = last;
+        last = last->prev;
+        return;
+    }
+    h->prev->next = h->next;
+    h->next->prev = h->prev;
+    h->prev = last;
+    h->next = first;
+    first = first->prev = last->next = h;
+}
+
+template<class T, template <class> class Alloc>
+void Dlist<T, Alloc>::splice(handle pos, handle h) {
+    TRACE_SCOPE("Dlist::splice");
+    if (h == pos || h == h->next) {
+        return;
+    }
+    h->prev->next = h->next;
+    h->next->prev = h->prev;
+    if (h == first) first = h->next;
+    if (h == last) last = h->prev;
+    // Insert before pos; before first is the same place as after last
+    auto after = pos ? pos : first;
+    h->prev = after->prev;
+    h->next = after;
+    after->prev->next = h;
+    after->prev = h;
+    if (!pos) {
+        last = h;
+    } else if (pos == first) {
+        first = h;
+    }
+}
+
+template<class T, template <class> class Alloc>
+T *Dlist<T, Alloc>::erase(handle h) {
+    TRACE_SCOPE("Dlist::erase");
+    if (h == first) {
+        return removeFront();
+    }
+    if (h == last) {
+        return removeBack();
+    }
+    auto op = h->op;
+    h->prev->next = h->next;
+    h->next->prev = h->prev;
+    nodes.deallocate(h);
+    return op;
+}
+
+template<class T, template <class> class Alloc>
+typename Dlist<T, Alloc>::node *Dlist<T, Alloc>::mergeRuns(node *a, node *b, bool (*cmp)(const T *, const T *)) {
+    node head;
+    auto tail = &head;
+    while (a && b) {
+        // b goes first only if it is before a, so equal nodes keep their order
+        if (cmp(b->op, a->op)) {
+            tail->next = b;
+            b = b->next;
+        } else {
+            tail->next = a;
+            a = a->next;
+        }
+        tail = tail->next;
+    }
+    tail->next = a ? a : b;
+    return head.next;
+}
+
+template<class T, template <class> class Alloc>
+void Dlist<T, Alloc>::relink(node *run) {
+    first = run;
+    while (run->next) {
+        run->next->prev = run;
+        run = run->next;
+    }
+    last = run;
+    last->next = first;
+    first->prev = last;
+}
+
+template<class T, template <class> class Alloc>
+void Dlist<T, Alloc>::sort(bool (*cmp)(const T *, const T *)) {
+    TRACE_SCOPE("Dlist::sort");
+    if (first == last) {
+        return;
+    }
+    // bins[i] is NULL or a sorted run of 2^i nodes, the runs of higher bins
+    // taken from earlier in the list. Each node is merged into the small
+    // runs while they are still in cache, as a binary counter is carried.
+    node *bins[64] = {};
+    int used = 0;
+    last->next = nullptr;
+    auto cur = first;
+    while (cur) {
+        auto carry = cur;
+        cur = cur->next;
+        carry->next = nullptr;
+        int i = 0;
+        for (; bins[i]; i++) {
+            carry = mergeRuns(bins[i], carry, cmp);
+            bins[i] = nullptr;
+        }
+        bins[i] = carry;
+        if (i == used) used++;
+    }
+    node *run = nullptr;
+    for (int i = 0; i < used; i++) {
+        if (bins[i]) run = mergeRuns(bins[i], run, cmp);
+    }
+    relink(run);
+}
+
+template<class T, template <class> class Alloc>
+void Dlist<T, Alloc>::merge(Dlist &l, bool (*cmp)(const T *, const T *)) {
+    TRACE_SCOPE("Dlist::merge");
+    if (&l == this || l.isEmpty()) {
+        return;
+    }
+    nodes.adopt(l.nodes);
+    if (isEmpty()) {
+        first = l.first;
+        last = l.last;
+    } else {
+        last->next = l.last->next = nullptr;
+        relink(mergeRuns(first, l.first, cmp));
+    }
+    l.first = l.last = nullptr;
+}
+
+template<class T, template <class> class Alloc>
+typename Dlist<T, Alloc>::const_iterator Dlist<T, Alloc>::begin() const {
+    return const_iterator(first);
+}
+
+template<class T, template <class> class Alloc>
+typename Dlist<T, Alloc>::const_iterator Dlist<T, Alloc>::end() const {
+    return const_iterator(nullptr);
+}
+
+template<class T, template <class> class Alloc>
+typename Dlist<T, Alloc>::const_reverse_iterator Dlist<T, Alloc>::rbegin() const {
+    return const_reverse_iterator(last);
+}
+
+template<class T, template <class> class Alloc>
+typename Dlist<T, Alloc>::const_reverse_iterator Dlist<T, Alloc>::rend() const {
+    return const_reverse_iterator(nullptr);
+}
+
+template<class T, template <class> class Alloc>
+Dlist<T, Alloc>::Dlist() {
     first = last = nullptr;
 }
 
-template<class T>
-Dlist<T>::Dlist(const Dlist &l) {
+template<class T, template <class> class Alloc>
+Dlist<T, Alloc>::Dlist(allocator_type a) : nodes(std::move(a)) {
     first = last = nullptr;
-    copyAll(l);
 }
 
-template<class T>
-Dlist<T> &Dlist<T>::operator=(const Dlist &l) {
-    removeAll();
+template<class T, template <class> class Alloc>
+Dlist<T, Alloc>::Dlist(const Dlist &l) {
+    first = last = nullptr;
     copyAll(l);
+}
+
+template<class T, template <class> class Alloc>
+Dlist<T, Alloc> &Dlist<T, Alloc>::operator=(const Dlist &l) {
+    if (this != &l) {
+        removeAll();
+        copyAll(l);
+    }
+    return *this;
+}
+
+template<class T, template <class> class Alloc>
+Dlist<T, Alloc>::Dlist(Dlist &&l) : first(l.first), last(l.last), nodes(std::move(l.nodes)) {
+    l.first = l.last = nullptr;
+}
+
+template<class T, template <class> class Alloc>
+Dlist<T, Alloc> &Dlist<T, Alloc>::operator=(Dlist &&l) {
+    if (this != &l) {
+        removeAll();
+        // The nodes belong to l's pool, so it comes along with them
+        nodes = std::move(l.nodes);
+        first = l.first;
+        last = l.last;
+        l.first = l.last = nullptr;
+    }
     return *this;
 }
 
-template<class T>
-Dlist<T>::~Dlist() {
+template<class T, template <class> class Alloc>
+Dlist<T, Alloc>::~Dlist() {
     removeAll();
 }
 
-template<class T>
-void Dlist<T>::removeAll() {
+template<class T, template <class> class Alloc>
+void Dlist<T, Alloc>::removeAll() {
     if (!isEmpty()) {
         auto temp = first;
         while (temp != last) {
             temp = temp->next;
             delete temp->prev->op;
-            delete temp->prev;
+            nodes.deallocate(temp->prev);
         }
         delete temp->op;
-        delete temp;
+        nodes.deallocate(temp);
     }
     first = last = nullptr;
 }
 
-template<class T>
-void Dlist<T>::copyAll(const Dlist &l) {
+template<class T, template <class> class Alloc>
+void Dlist<T, Alloc>::copyAll(const Dlist &l) {
     if (!l.isEmpty()) {
         auto temp = l.last;
         while (temp != l.first) {
@@ -0,0 +1,223 @@
+//
+// Infix expressions: conversion to RPN and compilation for repeated evaluation.
+//
+
+#include "expression.h"
+#include "operators.h"
+
+#include <cctype>
+#include <climits>
+#include <cstring>
+
+using namespace std;
+
+static bool numberhelper(const char *p, const char *end, long &number) {
+    // EFFECTS: returns true and sets number if all of [p, end) is a decimal
+    //          integer with an optional sign, saturated to the range of
+    //          long as strtol() does
+    bool negative = *p == '-';
+    if (*p == '-' || *p == '+') p++;
+    if (p == end) return false;
+    unsigned long v = 0;
+    bool overflow = false;
+    const unsigned long limit = negative ? 0UL - (unsigned long) LONG_MIN : (unsigned long) LONG_MAX;
+    for (; p < end; p++) {
+        if (*p < '0' || *p > '9') return false;
+        unsigned long digit = (unsigned long) (*p - '0');
+        if (v > (limit - digit) / 10) overflow = true;
+        else v = v * 10 + digit;
+    }
+    if (overflow) number = negative ? LONG_MIN : LONG_MAX;
+    else number = negative ? long(0UL - v) : long(v);
+    return true;
+}
+
+ParseResult toRPN(const char *begin, const char *end, const vector<string> &variables,
+                  Vlist<Token> &rpn, Vlist<char> &operators, vector<BigInt> *large) {
+    const char *p = begin;
+    while (true) {
+        while (p < end && isspace((unsigned char) *p)) p++;
+        if (p == end) {
+            break;
+        }
+        const char *token = p;
+        while (p < end && !isspace((unsigned char) *p)) p++;
+        size_t length = size_t(p - token);
+
+        long number;
+        if (numberhelper(token, p, number)) {
+            BigInt value;
+            if (large && (number == LONG_MIN || number == LONG_MAX) && BigInt::parse(token, p, value)
+                && value != BigInt(number)) {
+                Token constant;
+                constant.value.number = long(large->size());
+                constant.type = Token::LARGE;
+                large->push_back(value);
+                rpn.insertBack(constant);
+            } else {
+                rpn.insertBack(Token{number, Token::INT});
+            }
+            continue;
+        }
+        char op = token[0];
+        OperatorKind kind = operatorKind(op);
+        if (length == 1 && (op == '(' || op == ')'
+                            || (kind != OPERATOR_NONE && OPERATORS[kind].precedence > 0))) {
+            if (op == '(') {
+                operators.insertBack(op);
+            } else if (op == ')') {
+                while (true) {
+                    if (operators.isEmpty()) {
+                        return PARSE_PARENTHESIS_MISMATCH;
+                    }
+                    auto op2 = operators.removeBack();
+                    if (op2 != '(') {
+                        rpn.insertBack(Token{op2, Token::CHAR});
+                    } else {
+                        break;
+                    }
+                }
+            } else {
+                while (!operators.isEmpty()) {
+                    auto op2 = operators.removeBack();
+                    if (op2 == '(' || OPERATORS[operatorKind(op2)].precedence < OPERATORS[kind].precedence) {
+                        operators.insertBack(op2);
+                        break;
+                    }
+                    rpn.insertBack(Token{op2, Token::CHAR});
+                }
+                operators.insertBack(op);
+            }
+            continue;
+        }
+        size_t i = 0;
+        while (i < variables.size()
+               && (variables[i].size() != length || memcmp(variables[i].data(), token, length) != 0)) {
+            i++;
+        }
+        if (i == variables.size()) {
+            return PARSE_UNKNOWN_TOKEN;
+        }
+        Token var;
+        var.value.number = long(i);
+        var.type = Token::VAR;
+        rpn.insertBack(var);
+    }
+    while (!operators.isEmpty()) {
+        auto op2 = operators.removeBack();
+        if (op2 == '(') {
+            return PARSE_PARENTHESIS_MISMATCH;
+        }
+        rpn.insertBack(Token{op2, Token::CHAR});
+    }
+    return PARSE_OK;
+}
+
+ParseResult toRPN(const string &line, const vector<string> &variables,
+                  Vlist<Token> &rpn, Vlist<char> &operators) {
+    return toRPN(line.data(), line.data() + line.size(), variables, rpn, operators);
+}
+
+const size_t Program::BATCH;
+
+Program::Status Program::compile(const Vlist<Token> &rpn) {
+    code.clear();
+    size_t depth = 0, maxDepth = 0;
+    for (const auto &item : rpn) {
+        Instruction in;
+        if (item.type == Token::INT) {
+            in = Instruction{OP_CONST, int(item.value.number)};
+        } else if (item.type == Token::VAR) {
+            in = Instruction{OP_VAR, int(item.value.number)};
+        } else {
+            if (depth < 2) {
+                return NOT_ENOUGH_OPERANDS;
+            }
+            depth -= 2;
+            in = Instruction{OP_APPLY, operatorKind(item.value.op)};
+        }
+        code.push_back(in);
+        depth++;
+        if (depth > maxDepth) maxDepth = depth;
+    }
+    if (depth == 0) {
+        return NOT_ENOUGH_OPERANDS;
+    }
+    if (depth > 1) {
+        return TOO_MANY_OPERANDS;
+    }
+    stack.assign(maxDepth, 0);
+    scratch.assign(maxDepth * BATCH, 0);
+    operands.assign(maxDepth, nullptr);
+    return OK;
+}
+
+Program::Fault Program::evaluate(const int *variables, int &result) {
+    int *s = stack.data();
+    size_t n = 0;   // Values on the stack
+    for (const auto &in : code) {
+        switch (in.op) {
+            case OP_CONST:
+                s[n++] = in.operand;
+                break;
+            case OP_VAR:
+                s[n++] = variables[in.operand];
+                break;
+            case OP_APPLY:
+                n--;
+                if (OPERATORS[in.operand].needsDivisor && s[n] == 0) {
+                    return DIVIDE_BY_ZERO;
+                }
+                if (OPERATORS[in.operand].needsDivisor && s[n] == -1 && s[n - 1] == INT_MIN) {
+                    return DIVIDE_OVERFLOW;
+                }
+                s[n - 1] = applyOperator(OperatorKind(in.operand), s[n - 1], s[n]);
+                break;
+        }
+    }
+    result = s[0];
+    return NO_FAULT;
+}
+
+void Program::evaluateBatch(const int *const *columns, size_t n, int *results,
+                            unsigned char *faults) {
+    // Every stack slot names its values: a column, or its own scratch
+    // buffer once an instruction has written there
+    size_t depth = 0;
+    for (size_t i = 0; i < n; i++) faults[i] = NO_FAULT;
+    for (const auto &in : code) {
+        if (in.op == OP_VAR) {
+            operands[depth++] = columns[in.operand];
+            continue;
+        }
+        if (in.op == OP_CONST) {
+            int *out = &scratch[depth * BATCH];
+            for (size_t i = 0; i < n; i++) out[i] = in.operand;
+            operands[depth++] = out;
+            continue;
+        }
+        depth--;
+        int *out = &scratch[(depth - 1) * BATCH];
+        const int *a = operands[depth - 1];
+        const int *b = operands[depth];
+        bool needsDivisor = OPERATORS[in.operand].needsDivisor;
+        visitOperator(OperatorKind(in.operand), [&](auto kernel) {
+            if (!needsDivisor) {
+                for (size_t i = 0; i < n; i++) out[i] = kernel.apply(a[i], b[i]);
+                return;
+            }
+            // A zero divisor, or the -1 that INT_MIN overflows on, is
+            // replaced by 1 so the loop never traps, and the row is flagged
+            // instead
+            for (size_t i = 0; i < n; i++) {
+                unsigned char zero = b[i] == 0;
+                unsigned char overflow = (a[i] == INT_MIN) & (b[i] == -1);
+                faults[i] |= zero * DIVIDE_BY_ZERO | overflow * DIVIDE_OVERFLOW;
+                out[i] = kernel.apply(a[i], b[i] + zero + 2 * overflow);
+            }
+        });
+        operands[depth - 1] = out;
+    }
+    const int *result = operands[0];
+    for (size_t i = 0; i < n; i++) results[i] = result[i];
+}
@@ -0,0 +1,117 @@
+//
+// Infix expressions: conversion to RPN and compilation for repeated evaluation.
+//
+
+#ifndef VE280_EXPRESSION_H
+#define VE280_EXPRESSION_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "bigint.h"
+#include "vlist.h"
+
+struct Token {
+    union {
+        long number;    // The constant, or the index of a variable or a large constant
+        char op;
+    } value;
+    enum {
+        INT,
+        CHAR,
+        VAR,
+        LARGE
+    } type;
+};
+
+enum ParseResult {
+    PARSE_OK,
+    PARSE_PARENTHESIS_MISMATCH,
+    PARSE_UNKNOWN_TOKEN,
+};
+
+ParseResult toRPN(const std::string &line, const std::vector<std::string> &variables,
+                  Vlist<Token> &rpn, Vlist<char> &operators);
+// REQUIRES rpn and operators are empty
+// MODIFIES rpn, operators
+// EFFECTS converts the infix expression in line, whose tokens are
+//         separated by blanks, to RPN in rpn by the shunting-yard
+//         algorithm, using operators as its stack. A name in variables
+//         becomes a VAR token holding its index. Returns PARSE_OK, or the
+//         first error found, leaving rpn and operators unspecified.
+
+ParseResult toRPN(const char *begin, const char *end, const std::vector<std::string> &variables,
+                  Vlist<Token> &rpn, Vlist<char> &operators, std::vector<BigInt> *large = nullptr);
+// REQUIRES rpn and operators are empty
+// MODIFIES rpn, operators, large
+// EFFECTS as above, for the expression in [begin, end). Tokens are read in
+//         place, with no copy of the text. If large is given, a constant
+//         out of the range of long is appended to it whole, and becomes a
+//         LARGE token holding its index, rather than an INT saturated to
+//         that range.
+
+class Program {
+    // OVERVIEW: an expression compiled to a flat array of instructions for
+    //           a stack machine. The stack is sized when compiling, so
+    //           evaluating allocates nothing and needs no bounds checks.
+
+    enum Opcode {
+        OP_CONST,   // Push operand
+        OP_VAR,     // Push variable number operand
+        OP_APPLY,   // Apply the binary OperatorKind operand to the top two
+    };
+
+    struct Instruction {
+        Opcode op;
+        int operand;
+    };
+
+    std::vector<Instruction> code;
+    std::vector<int> stack;
+    std::vector<int> scratch;           // A BATCH-sized buffer per stack slot
+    std::vector<const int *> operands;  // The values in each stack slot
+
+   public:
+    static const size_t BATCH = 1024;
+
+    enum Status {
+        OK,
+        NOT_ENOUGH_OPERANDS,
+        TOO_MANY_OPERANDS,
+    };
+
+    // What keeps a division from giving an int, as bits
+    enum Fault {
+        NO_FAULT = 0,
+        DIVIDE_BY_ZERO = 1,
+        DIVIDE_OVERFLOW = 2,    // INT_MIN / -1
+    };
+
+    Status compile(const Vlist<Token> &rpn);
+    // REQUIRES rpn holds no LARGE token
+    // MODIFIES this
+    // EFFECTS compiles rpn, which came from toRPN(), and returns OK, or the
+    //         reason it is not a valid expression
+
+    Fault evaluate(const int *variables, int &result);
+    // REQUIRES compile() returned OK, and variables holds a value for
+    //          every variable index the expression uses
+    // MODIFIES this, result
+    // EFFECTS evaluates the expression on variables into result and
+    //         returns NO_FAULT, or returns the fault of the first division
+    //         it cannot do
+
+    void evaluateBatch(const int *const *columns, size_t n, int *results,
+                       unsigned char *faults);
+    // REQUIRES compile() returned OK, n <= BATCH, and columns[v] holds n
+    //          values of variable v for every variable the expression uses
+    // MODIFIES this, results, faults
+    // EFFECTS evaluates the expression on row i of the columns into
+    //         results[i] for every i < n. faults[i] is set to the Fault bits
+    //         of the divisions row i cannot do, when results[i] is
+    //         unspecified, and to NO_FAULT otherwise. Every instruction runs once per batch, as a
+    //         loop over the rows the compiler can vectorize.
+};
+
+#endif //VE280_EXPRESSION_H
@@ -0,0 +1,143 @@
+//
+// Allocation policies for the nodes of Dlist.
+//
+
+#ifndef VE280_NODE_POOL_H
+#define VE280_NODE_POOL_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+template<class N>
+class NodePool {
+    // OVERVIEW: hands out objects of type N carved from slabs it owns.
+    //           Freed objects go on a free list and are reused before a
+    //           new slab is taken, so a list that keeps inserting and
+    //           removing stops touching the global heap once it has
+    //           reached its largest size. The slabs are returned only when
+    //           the pool is destroyed.
+
+    union Slot {
+        Slot *next;                                 // Next free slot
+        alignas(N) unsigned char storage[sizeof(N)];
+    };
+
+    static const size_t FIRST_SLAB = 16;
+    static const size_t LAST_SLAB = 4096;
+
+    std::vector<std::unique_ptr<Slot[]>> slabs;
+    size_t slabSize;    // Size of the next slab
+    Slot *freeList;     // Free slots, most recently freed first
+
+    void grow() {
+        std::unique_ptr<Slot[]> slab(new Slot[slabSize]);
+        for (size_t i = 0; i < slabSize; i++) {
+            slab[i].next = i + 1 < slabSize ? &slab[i + 1] : freeList;
+        }
+        freeList = &slab[0];
+        slabs.push_back(std::move(slab));
+        if (slabSize < LAST_SLAB) slabSize *= 2;
+    }
+
+public:
+    NodePool() : slabSize(FIRST_SLAB), freeList(nullptr) {}
+
+    NodePool(const NodePool &) = delete;
+
+    NodePool &operator=(const NodePool &) = delete;
+
+    NodePool(NodePool &&p) :
+            slabs(std::move(p.slabs)), slabSize(p.slabSize), freeList(p.freeList) {
+        // MODIFIES: p
+        // EFFECTS: takes over p's slabs, and with them every object p handed
+        //          out; p is left empty
+        p.slabs.clear();
+        p.slabSize = FIRST_SLAB;
+        p.freeList = nullptr;
+    }
+
+    NodePool &operator=(NodePool &&p) {
+        // REQUIRES: every object this pool handed out has been deallocated
+        // MODIFIES: this, p
+        // EFFECTS: frees this pool's slabs and takes over p's
+        if (this != &p) {
+            slabs = std::move(p.slabs);
+            slabSize = p.slabSize;
+            freeList = p.freeList;
+            p.slabs.clear();
+            p.slabSize = FIRST_SLAB;
+            p.freeList = nullptr;
+        }
+        return *this;
+    }
+
+    void adopt(NodePool &p) {
+        // MODIFIES: this, p
+        // EFFECTS: takes over p's slabs and free slots, and with them every
+        //          object p handed out, which are deallocated to this pool
+        //          from then on; p is left empty
+        if (this == &p) return;
+        for (auto &slab : p.slabs) {
+            slabs.push_back(std::move(slab));
+        }
+        if (p.freeList) {
+            Slot *tail = p.freeList;
+            while (tail->next) tail = tail->next;
+            tail->next = freeList;
+            freeList = p.freeList;
+        }
+        p.slabs.clear();
+        p.slabSize = FIRST_SLAB;
+        p.freeList = nullptr;
+    }
+
+    template<class... Args>
+    N *allocate(Args &&... args) {
+        // MODIFIES: this
+        // EFFECTS: returns an N constructed from args
+        if (!freeList) grow();
+        Slot *slot = freeList;
+        freeList = slot->next;
+        try {
+            return new(slot->storage) N(std::forward<Args>(args)...);
+        } catch (...) {
+            slot->next = freeList;
+            freeList = slot;
+            throw;
+        }
+    }
+
+    void deallocate(N *n) {
+        // REQUIRES: n was returned by allocate() of this pool
+        // MODIFIES: this
+        // EFFECTS: destroys n and keeps its storage for reuse
+        n->~N();
+        Slot *slot = reinterpret_cast<Slot *>(n);
+        slot->next = freeList;
+        freeList = slot;
+    }
+};
+
+template<class N>
+class HeapNodes {
+    // OVERVIEW: allocates every node with new and frees it with delete
+
+public:
+    template<class... Args>
+    N *allocate(Args &&... args) {
+        return new N(std::forward<Args>(args)...);
+    }
+
+    void deallocate(N *n) {
+        delete n;
+    }
+
+    void adopt(HeapNodes &) {
+        // EFFECTS: nothing, as every node is deleted alike
+    }
+};
+
+#endif //VE280_NODE_POOL_H
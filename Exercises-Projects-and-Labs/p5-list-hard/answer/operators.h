@@ -0,0 +1,120 @@
+//
+// The arithmetic operators shared by calc, rpn and the expression compiler:
+// one constant table describing them, and their kernels as functors.
+//
+
+#ifndef VE280_OPERATORS_H
+#define VE280_OPERATORS_H
+
+// The kernels. apply() is static and inline, so a call through a kernel
+// type, rather than through the table's function pointer, compiles to the
+// bare instruction
+
+struct AddKernel {
+    static int apply(int a, int b) { return a + b; }
+};
+
+struct SubKernel {
+    static int apply(int a, int b) { return a - b; }
+};
+
+struct MulKernel {
+    static int apply(int a, int b) { return a * b; }
+};
+
+struct DivKernel {
+    // REQUIRES b != 0
+    static int apply(int a, int b) { return a / b; }
+};
+
+struct NegKernel {
+    static int apply(int a, int) { return -a; }
+};
+
+enum OperatorKind {
+    OPERATOR_ADD,
+    OPERATOR_SUB,
+    OPERATOR_MUL,
+    OPERATOR_DIV,
+    OPERATOR_NEG,
+    OPERATOR_NONE,
+};
+
+struct Operator {
+    char symbol;
+    int precedence;         // Higher binds tighter in infix, 0 if postfix only
+    int arity;              // Operands taken; a unary kernel ignores b
+    bool needsDivisor;      // Undefined on a second operand of 0
+    int (*kernel)(int a, int b);
+};
+
+// Indexed by OperatorKind
+constexpr Operator OPERATORS[] = {
+    {'+', 2, 2, false, &AddKernel::apply},
+    {'-', 2, 2, false, &SubKernel::apply},
+    {'*', 3, 2, false, &MulKernel::apply},
+    {'/', 3, 2, true, &DivKernel::apply},
+    {'n', 0, 1, false, &NegKernel::apply},
+};
+
+inline OperatorKind operatorKind(char symbol) {
+    // EFFECTS returns the operator written symbol, or OPERATOR_NONE
+    switch (symbol) {
+        case '+':
+            return OPERATOR_ADD;
+        case '-':
+            return OPERATOR_SUB;
+        case '*':
+            return OPERATOR_MUL;
+        case '/':
+            return OPERATOR_DIV;
+        case 'n':
+            return OPERATOR_NEG;
+        default:
+            return OPERATOR_NONE;
+    }
+}
+
+template<class Visitor>
+inline void visitOperator(OperatorKind kind, Visitor &&visitor) {
+    // REQUIRES kind is not OPERATOR_NONE
+    // EFFECTS calls visitor(K()) with the kernel type K of kind, so that a
+    //         loop in visitor is compiled once per kernel, with the kernel
+    //         inlined
+    switch (kind) {
+        case OPERATOR_ADD:
+            visitor(AddKernel());
+            break;
+        case OPERATOR_SUB:
+            visitor(SubKernel());
+            break;
+        case OPERATOR_MUL:
+            visitor(MulKernel());
+            break;
+        case OPERATOR_DIV:
+            visitor(DivKernel());
+            break;
+        default:
+            visitor(NegKernel());
+            break;
+    }
+}
+
+inline int applyOperator(OperatorKind kind, int a, int b) {
+    // REQUIRES kind is not OPERATOR_NONE, and b != 0 if it needs a divisor
+    // EFFECTS returns the result of kind on a and b
+    switch (kind) {
+        case OPERATOR_ADD:
+            return AddKernel::apply(a, b);
+        case OPERATOR_SUB:
+            return SubKernel::apply(a, b);
+        case OPERATOR_MUL:
+            return MulKernel::apply(a, b);
+        case OPERATOR_DIV:
+            return DivKernel::apply(a, b);
+        default:
+            return NegKernel::apply(a, b);
+    }
+}
+
+#endif //VE280_OPERATORS_H
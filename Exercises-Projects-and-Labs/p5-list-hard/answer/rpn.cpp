@@ -4,9 +4,17 @@
 
 #include <iostream>
 #include <sstream>
-#include <cassert>
+#include <charconv>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
 
-#include "dlist.h"
+#include "bigint.h"
+#include "expression.h"
+#include "operators.h"
 
 //#include <vector>
 //#include <stack>
@@ -14,170 +22,347 @@
 
 using namespace std;
 
-struct Token {
-    union {
-        long number;
-        char op;
-    } value;
-    enum {
-        INT,
-        CHAR
-    } type;
+// Usage: rpn [-big] [-stream] | rpn -rows [-batch]
+//
+// Reads an infix expression from the first line, prints it in RPN and
+// evaluates it. With -stream every line of input is such an expression,
+// and each is handled as if it were the only one. With -rows the second line names the columns of the lines
+// that follow, and the expression, which may use the column names as
+// variables, is compiled once and evaluated on every row; one result is
+// printed per row. -batch gathers the rows into columns of Program::BATCH
+// values and evaluates each batch at once. -big evaluates on BigInt rather
+// than int, so that constants and results of any size are exact.
+
+class OutputBuffer {
+    // OVERVIEW: collects output in memory and writes it to standard output
+    //           in large blocks, and when destroyed
+
+    static const size_t CAPACITY = 1 << 16;
+    string buffer;
+
+   public:
+    OutputBuffer() {
+        buffer.reserve(CAPACITY);
+    }
+
+    ~OutputBuffer() {
+        flush();
+    }
+
+    OutputBuffer &operator<<(const char *s) {
+        buffer += s;
+        if (buffer.size() >= CAPACITY) flush();
+        return *this;
+    }
+
+    OutputBuffer &operator<<(char c) {
+        buffer += c;
+        if (buffer.size() >= CAPACITY) flush();
+        return *this;
+    }
+
+    OutputBuffer &operator<<(long v) {
+        char digits[24];
+        auto end = to_chars(digits, digits + sizeof(digits), v).ptr;
+        buffer.append(digits, end);
+        if (buffer.size() >= CAPACITY) flush();
+        return *this;
+    }
+
+    OutputBuffer &operator<<(int v) {
+        return *this << long(v);
+    }
+
+    OutputBuffer &operator<<(const BigInt &v) {
+        if (v.isSmall()) {
+            char digits[24];
+            buffer.append(digits, to_chars(digits, digits + sizeof(digits), v.toLong()).ptr);
+        } else {
+            buffer += v.toString();
+        }
+        if (buffer.size() >= CAPACITY) flush();
+        return *this;
+    }
+
+    void flush() {
+        // MODIFIES: this
+        // EFFECTS: writes out everything collected so far
+        fwrite(buffer.data(), 1, buffer.size(), stdout);
+        buffer.clear();
+    }
 };
 
-int main() {
-    int precedence[128] = {};
-    precedence['('] = 10;
-    precedence[')'] = 1;
-    precedence['*'] = 3;
-    precedence['/'] = 3;
-    precedence['+'] = 2;
-    precedence['-'] = 2;
+template<class T>
+static void clearhelper(Vlist<T> &l) {
+    // MODIFIES: l
+    // EFFECTS: removes every element of l, keeping its nodes for reuse
+    while (!l.isEmpty()) {
+        l.removeFront();
+    }
+}
 
+static bool reporthelper(ParseResult result, OutputBuffer &out) {
+    // MODIFIES: out
+    // EFFECTS: prints the error of a failed parse and returns false, or
+    //          returns true if the parse succeeded
+    if (result == PARSE_PARENTHESIS_MISMATCH) {
+        out << "ERROR: Parenthesis mismatch\n";
+    } else if (result == PARSE_UNKNOWN_TOKEN) {
+        out << "ERROR: Unknown token\n";
+    }
+    return result == PARSE_OK;
+}
 
-    string line;
+static int rowshelper(bool batched) {
+    // EFFECTS: runs the -rows mode on standard input, a batch at a time if
+    //          batched, and returns the exit status
+    string line, header;
     getline(cin, line);
+    getline(cin, header);
+    vector<string> columns;
+    istringstream iss(header);
+    string name;
+    while (iss >> name) {
+        columns.push_back(name);
+    }
 
-    Dlist<Token> rpn;
-    Dlist<char> operators;
+    OutputBuffer out;
+    Vlist<Token> rpn;
+    Vlist<char> operators;
+    if (!reporthelper(toRPN(line, columns, rpn, operators), out)) {
+        return 0;
+    }
+    Program program;
+    auto status = program.compile(rpn);
+    if (status != Program::OK) {
+        out << (status == Program::NOT_ENOUGH_OPERANDS ? "ERROR: Not enough operands\n"
+                                                       : "ERROR: Too many operands\n");
+        return 0;
+    }
 
-    istringstream iss(line);
-    string token;
-    while (iss >> token) {
+    vector<int> row(columns.size());
+    // Columns of the pending batch, and the rows of it that were malformed
+    vector<vector<int>> batch(batched ? columns.size() : 0, vector<int>(Program::BATCH));
+    vector<const int *> batchColumns;
+    for (const auto &column : batch) {
+        batchColumns.push_back(column.data());
+    }
+    vector<int> results(Program::BATCH);
+    vector<unsigned char> faults(Program::BATCH), malformed(Program::BATCH);
+    size_t pending = 0;
+    auto flush = [&]() {
+        program.evaluateBatch(batchColumns.data(), pending, results.data(), faults.data());
+        for (size_t i = 0; i < pending; i++) {
+            if (malformed[i]) {
+                out << "ERROR: Wrong number of values\n";
+            } else if (faults[i] & Program::DIVIDE_BY_ZERO) {
+                out << "ERROR: Divide by zero\n";
+            } else if (faults[i]) {
+                out << "ERROR: Division overflow\n";
+            } else {
+                out << results[i] << '\n';
+            }
+        }
+        pending = 0;
+    };
+
+    while (getline(cin, line)) {
+        const char *p = line.c_str();
         char *end;
-        auto number = strtol(token.c_str(), &end, 10);
-        if (end == token.c_str() + token.length()) {
-            rpn.insertBack(new Token{number, Token::INT});
+        size_t n = 0;
+        while (true) {
+            long v = strtol(p, &end, 10);
+            if (end == p) break;
+            if (n < row.size()) row[n] = int(v);
+            n++;
+            p = end;
+        }
+        while (*p == ' ' || *p == '\t' || *p == '\r') p++;
+        if (n == 0 && *p == '\0') {
             continue;
         }
-        if (token.length() == 1) {
-            char op = token[0];
-            if (precedence[op] > 0) {
-                if (op == '(') {
-                    operators.insertBack(new char(op));
-                } else if (op == ')') {
-                    while (true) {
-                        if (operators.isEmpty()) {
-                            cout << "ERROR: Parenthesis mismatch" << endl;
-                            return 0;
-                        }
-                        auto op2 = operators.removeBack();
-                        if (*op2 != '(') {
-                            rpn.insertBack(new Token{*op2, Token::CHAR});
-                            delete op2;
-                        } else {
-                            delete op2;
-                            break;
-                        }
-                    }
-//                    while (!operators.isEmpty() && operators.top().first != '(') {
-//                        rpn.push_back(Token{operators.top().first, Token::CHAR});
-//                        operators.pop();
-//                    }
-//                    if (operators.empty()) {
-//                        cout << "ERROR: Parenthesis mismatch" << endl;
-//                        return 0;
-//                    }
-//                    operators.pop();
-                } else {
-                    while (!operators.isEmpty()) {
-                        auto op2 = operators.removeBack();
-                        if (*op2 == '(' || precedence[*op2] < precedence[op]) {
-                            operators.insertBack(op2);
-                            break;
-                        }
-                        rpn.insertBack(new Token{*op2, Token::CHAR});
-                        delete op2;
-                    }
-                    operators.insertBack(new char(op));
-//                    while (!operators.empty() && operators.top().first != '(' && operators.top().second >= it->second) {
-//                        rpn.push_back(Token{operators.top().first, Token::CHAR});
-//                        operators.pop();
-//                    }
-//                    operators.push(*it);
-                }
-                continue;
+        bool wrong = n != row.size() || *p != '\0';
+        if (batched) {
+            malformed[pending] = wrong;
+            for (size_t c = 0; c < row.size(); c++) {
+                batch[c][pending] = wrong ? 0 : row[c];
             }
+            if (++pending == Program::BATCH) flush();
+            continue;
         }
-        assert(0);
-    }
-    while (!operators.isEmpty()) {
-        auto op2 = operators.removeBack();
-        if (*op2 == '(') {
-            cout << "ERROR: Parenthesis mismatch" << endl;
-            delete op2;
-            return 0;
+        int result = 0;
+        auto fault = wrong ? Program::NO_FAULT : program.evaluate(row.data(), result);
+        if (wrong) {
+            out << "ERROR: Wrong number of values\n";
+        } else if (fault == Program::DIVIDE_BY_ZERO) {
+            out << "ERROR: Divide by zero\n";
+        } else if (fault) {
+            out << "ERROR: Division overflow\n";
+        } else {
+            out << result << '\n';
         }
-        rpn.insertBack(new Token{*op2, Token::CHAR});
-        delete op2;
-    }
-    
-    auto temp = rpn;
-    while (!temp.isEmpty()) {
-        auto item = temp.removeFront();
-        if (item->type == Token::INT) {
-            cout << item->value.number << " ";
+    }
+    if (pending) flush();
+    return 0;
+}
+
+static void largehelper(Vlist<int> &, const BigInt &) {
+    // EFFECTS: nothing, as toRPN() makes no LARGE token for int, which has
+    //          no list for them
+}
+
+static void largehelper(Vlist<BigInt> &rpnStack, const BigInt &value) {
+    // MODIFIES: rpnStack
+    // EFFECTS: pushes the large constant value
+    rpnStack.insertBack(value);
+}
+
+static bool overflowhelper(int a, int b) {
+    // EFFECTS: returns true if a / b is no int, which is INT_MIN / -1
+    return a == INT_MIN && b == -1;
+}
+
+static bool overflowhelper(const BigInt &, const BigInt &) {
+    // EFFECTS: false, as every quotient of BigInts is one
+    return false;
+}
+
+template<class V>
+static void runhelper(const char *begin, const char *end, Vlist<Token> &rpn,
+                      Vlist<char> &operators, Vlist<V> &rpnStack, vector<BigInt> *large, OutputBuffer &out) {
+    // REQUIRES rpn, operators and rpnStack are empty, and large is given
+    //          if V is BigInt
+    // MODIFIES rpn, operators, rpnStack, large, out
+    // EFFECTS converts the expression in [begin, end) to RPN, evaluates it
+    //         on V and prints both, or the first error. The lists are left
+    //         empty, with their nodes kept for the next expression.
+    if (large) large->clear();
+    if (!reporthelper(toRPN(begin, end, vector<string>(), rpn, operators, large), out)) {
+        clearhelper(rpn);
+        clearhelper(operators);
+        return;
+    }
+
+    for (const auto &item : rpn) {
+        if (item.type == Token::INT) {
+            out << item.value.number << ' ';
+        } else if (item.type == Token::LARGE) {
+            out << (*large)[item.value.number] << ' ';
         } else {
-            cout << item->value.op << " ";
+            out << item.value.op << ' ';
         }
-        delete item;
     }
-    cout << endl;
+    out << '\n';
 
-    Dlist<int> rpnStack;
     if (rpn.isEmpty()) {
-        cout << "ERROR: Not enough operands" << endl;
-        return 0;
+        out << "ERROR: Not enough operands\n";
+        return;
     }
 
     while (!rpn.isEmpty()) {
         auto item = rpn.removeFront();
-        if (item->type == Token::INT) {
-            rpnStack.insertBack(new int(item->value.number));
+        if (item.type == Token::INT) {
+            rpnStack.insertBack(V(item.value.number));
+        } else if (item.type == Token::LARGE) {
+            largehelper(rpnStack, (*large)[item.value.number]);
         } else {
-            int *b = rpnStack.removeBack();
             if (rpnStack.isEmpty()) {
-                cout << "ERROR: Not enough operands" << endl;
-                delete b;
-                delete item;
-                return 0;
+                out << "ERROR: Not enough operands\n";
+                clearhelper(rpn);
+                return;
             }
-            int *a = rpnStack.removeBack();
-            if (item->value.op == '/' && *b == 0) {
-                cout << "ERROR: Divide by zero" << endl;
-                delete a;
-                delete b;
-                delete item;
-                return 0;
+            V b = rpnStack.removeBack();
+            if (rpnStack.isEmpty()) {
+                out << "ERROR: Not enough operands\n";
+                clearhelper(rpn);
+                return;
+            }
+            V a = rpnStack.removeBack();
+            auto kind = operatorKind(item.value.op);
+            if (OPERATORS[kind].needsDivisor && b == 0) {
+                out << "ERROR: Divide by zero\n";
+                clearhelper(rpn);
+                clearhelper(rpnStack);
+                return;
             }
-            switch (item->value.op) {
-                case '+':
-                    *a += *b;
-                    break;
-                case '-':
-                    *a -= *b;
-                    break;
-                case '*':
-                    *a *= *b;
-                    break;
-                case '/':
-                    *a /= *b;
-                    break;
-                default:
-                    assert(0);
+            if (OPERATORS[kind].needsDivisor && overflowhelper(a, b)) {
+                out << "ERROR: Division overflow\n";
+                clearhelper(rpn);
+                clearhelper(rpnStack);
+                return;
             }
-            delete b;
+            a = applyOperator(kind, a, b);
             rpnStack.insertBack(a);
         }
-        delete item;
     }
 
     auto result = rpnStack.removeFront();
     if (!rpnStack.isEmpty()) {
-        cout << "ERROR: Too many operands" << endl;
+        out << "ERROR: Too many operands\n";
+        clearhelper(rpnStack);
     } else {
-        cout << *result << endl;
+        out << result << '\n';
+    }
+}
+
+template<class V>
+static int streamhelper(vector<BigInt> *large) {
+    // REQUIRES large is given if V is BigInt
+    // EFFECTS: runs every line of standard input through runhelper() on V
+    //          and returns the exit status
+    vector<char> input;
+    char chunk[65536];
+    size_t got;
+    while ((got = fread(chunk, 1, sizeof(chunk), stdin)) > 0) {
+        input.insert(input.end(), chunk, chunk + got);
+    }
+    OutputBuffer out;
+    Vlist<Token> rpn;
+    Vlist<char> operators;
+    Vlist<V> rpnStack;
+    const char *p = input.data(), *end = p + input.size();
+    while (p < end) {
+        auto eol = (const char *) memchr(p, '\n', size_t(end - p));
+        if (!eol) eol = end;
+        runhelper(p, eol, rpn, operators, rpnStack, large, out);
+        p = eol + 1;
     }
-    delete result;
     return 0;
-}
\ No newline at end of file
+}
+
+template<class V>
+static int singlehelper(vector<BigInt> *large) {
+    // REQUIRES large is given if V is BigInt
+    // EFFECTS: runs the first line of standard input through runhelper()
+    //          on V and returns the exit status
+    string line;
+    getline(cin, line);
+
+    OutputBuffer out;
+    Vlist<Token> rpn;
+    Vlist<char> operators;
+    Vlist<V> rpnStack;
+    runhelper(line.data(), line.data() + line.size(), rpn, operators, rpnStack, large, out);
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    bool big = argc > 1 && string(argv[1]) == "-big";
+    if (big) {
+        argc--;
+        argv++;
+    }
+    if (argc > 1 && string(argv[1]) == "-rows") {
+        if (big) {
+            cerr << "Error: -big does not apply to -rows" << endl;
+            return 1;
+        }
+        return rowshelper(argc > 2 && string(argv[2]) == "-batch");
+    }
+    bool stream = argc > 1 && string(argv[1]) == "-stream";
+    vector<BigInt> large;
+    if (big) {
+        return stream ? streamhelper<BigInt>(&large) : singlehelper<BigInt>(&large);
+    }
+    return stream ? streamhelper<int>(nullptr) : singlehelper<int>(nullptr);
+}
@@ -0,0 +1,112 @@
+//
+// Address traces replayed by the cache simulator.
+//
+
+#include "trace.h"
+
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+TraceFile::TraceFile() :
+        begin(nullptr), cur(nullptr), end(nullptr), binary(false), bad(false), line(1),
+        map(nullptr), mapSize(0) {}
+
+TraceFile::~TraceFile() {
+    if (map) munmap(map, mapSize);
+}
+
+bool TraceFile::open(const string &path) {
+    int fd = path == "-" ? STDIN_FILENO : ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        void *p = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED) {
+            map = p;
+            mapSize = size_t(st.st_size);
+            madvise(map, mapSize, MADV_SEQUENTIAL);
+        }
+    }
+    if (!map) {
+        char chunk[65536];
+        ssize_t r;
+        while ((r = ::read(fd, chunk, sizeof(chunk))) > 0) {
+            buffer.insert(buffer.end(), chunk, chunk + r);
+        }
+        if (r < 0) {
+            if (fd != STDIN_FILENO) close(fd);
+            return false;
+        }
+    }
+    if (fd != STDIN_FILENO) close(fd);
+    begin = map ? (const char *) map : buffer.data();
+    end = begin + (map ? mapSize : buffer.size());
+    binary = size_t(end - begin) >= sizeof(TRACE_MAGIC)
+             && memcmp(begin, TRACE_MAGIC, sizeof(TRACE_MAGIC)) == 0;
+    if (binary) begin += sizeof(TRACE_MAGIC);
+    cur = begin;
+    return true;
+}
+
+static bool parsenumberhelper(const char *&p, const char *end, uint64_t &v) {
+    // EFFECTS: skips blanks, then parses a decimal number at p and returns
+    //          true, or returns false if there is none
+    while (p < end && (*p == ' ' || *p == '\t')) p++;
+    if (p == end || *p < '0' || *p > '9') return false;
+    v = 0;
+    while (p < end && *p >= '0' && *p <= '9') v = v * 10 + uint64_t(*p++ - '0');
+    return true;
+}
+
+bool TraceFile::nexttexthelper(Access &a) {
+    while (cur < end) {
+        const char *p = cur;
+        const char *eol = (const char *) memchr(p, '\n', size_t(end - p));
+        if (!eol) eol = end;
+        while (p < eol && (*p == ' ' || *p == '\t' || *p == '\r')) p++;
+        if (p == eol || *p == '#') {
+            cur = eol + (eol < end);
+            line++;
+            continue;
+        }
+        char kind = *p++;
+        uint64_t address, value = 0;
+        bool negative = false;
+        bool ok = (kind == 'R' || kind == 'W') && parsenumberhelper(p, eol, address);
+        if (ok && kind == 'W') {
+            while (p < eol && (*p == ' ' || *p == '\t')) p++;
+            if (p < eol && *p == '-') {
+                negative = true;
+                p++;
+            }
+            ok = parsenumberhelper(p, eol, value);
+        }
+        while (ok && p < eol && (*p == ' ' || *p == '\t' || *p == '\r')) p++;
+        if (!ok || p != eol) {
+            bad = true;
+            return false;
+        }
+        a.address = size_t(address);
+        a.write = kind == 'W';
+        a.value = negative ? -int(value) : int(value);
+        cur = eol + (eol < end);
+        line++;
+        return true;
+    }
+    return false;
+}
+
+bool TraceFile::failed() const {
+    return bad;
+}
+
+size_t TraceFile::position() const {
+    return binary ? size_t(cur - begin) / TRACE_RECORD_SIZE : line;
+}
@@ -0,0 +1,89 @@
+//
+// Address traces replayed by the cache simulator.
+//
+
+#ifndef VE280_TRACE_H
+#define VE280_TRACE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct Access {
+    size_t address;
+    int value;          // The word written; unused for a read
+    bool write;
+};
+
+// A binary trace starts with TRACE_MAGIC and holds TRACE_RECORD_SIZE-byte
+// records, little endian:
+//
+//   8 bytes   address * 2 + 1 for a write, address * 2 for a read
+//   4 bytes   value written, ignored for a read
+//
+// A text trace holds one access per line, "R address" or "W address value";
+// empty lines and lines starting with '#' are skipped.
+
+const char TRACE_MAGIC[4] = {'C', 'T', 'R', 'C'};
+const size_t TRACE_RECORD_SIZE = 12;
+
+class TraceFile {
+    // OVERVIEW: reads the accesses of a trace in order. Regular files are
+    //           memory mapped; pipes are read into memory whole.
+
+    const char *begin;  // First record
+    const char *cur;
+    const char *end;
+    bool binary;
+    bool bad;           // A record could not be parsed
+    size_t line;        // Text line of cur
+    void *map;
+    size_t mapSize;
+    std::vector<char> buffer;
+
+    bool nexttexthelper(Access &a);
+
+   public:
+    TraceFile();
+
+    TraceFile(const TraceFile &) = delete;
+
+    TraceFile &operator=(const TraceFile &) = delete;
+
+    ~TraceFile();
+
+    bool open(const std::string &path);
+    // MODIFIES this
+    // EFFECTS opens the trace at path, or standard input if path is "-",
+    //         and returns false if it cannot be read
+
+    bool next(Access &a) {
+        // MODIFIES this, a
+        // EFFECTS reads the next access into a and returns true, or returns
+        //         false at the end of the trace or at a malformed record
+        if (!binary) return nexttexthelper(a);
+        if (size_t(end - cur) < TRACE_RECORD_SIZE) {
+            bad = cur != end;
+            return false;
+        }
+        uint64_t tagged = 0;
+        uint32_t value = 0;
+        for (int i = 7; i >= 0; i--) tagged = (tagged << 8) | (unsigned char) cur[i];
+        for (int i = 11; i >= 8; i--) value = (value << 8) | (unsigned char) cur[i];
+        a.address = size_t(tagged >> 1);
+        a.write = tagged & 1;
+        a.value = int(value);
+        cur += TRACE_RECORD_SIZE;
+        return true;
+    }
+
+    bool failed() const;
+    // EFFECTS returns true if reading stopped at a malformed record
+
+    size_t position() const;
+    // EFFECTS returns the line of a text trace, or the record of a binary
+    //         one, that reading stopped at
+};
+
+#endif //VE280_TRACE_H
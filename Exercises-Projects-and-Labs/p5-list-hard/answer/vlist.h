@@ -0,0 +1,193 @@
+#ifndef __VLIST_H__
+#define __VLIST_H__
+
+#include <cstddef>
+#include <iterator>
+
+#include "dlist.h"
+#include "node_pool.h"
+
+template <class T, template <class> class Alloc = NodePool>
+class Vlist {
+    // OVERVIEW: a double-ended list like Dlist, except that it stores the
+    //           objects themselves in its nodes rather than pointers to
+    //           objects the caller allocated. Removing an object hands it
+    //           back by value. Nodes come from an Alloc<node>, as in Dlist.
+
+    struct node;
+
+   public:
+    typedef Alloc<node> allocator_type;
+
+    typedef node *handle;
+    // A handle names one node of the list. It stays valid until that node
+    // is removed, however the list is reordered.
+
+    // Operational methods
+
+    bool isEmpty() const;
+    // EFFECTS returns true if list is empty, false otherwise
+
+    template <class... Args>
+    void emplaceFront(Args &&... args);
+    // MODIFIES this
+    // EFFECTS constructs an object from args at the front of the list
+
+    template <class... Args>
+    void emplaceBack(Args &&... args);
+    // MODIFIES this
+    // EFFECTS constructs an object from args at the back of the list
+
+    void insertFront(T value);
+    // MODIFIES this
+    // EFFECTS inserts value at the front of the list
+
+    void insertBack(T value);
+    // MODIFIES this
+    // EFFECTS inserts value at the back of the list
+
+    T removeFront();
+    // MODIFIES this
+    // EFFECTS removes and returns first object from non-empty list
+    //         throws an instance of emptyList if empty
+
+    T removeBack();
+    // MODIFIES this
+    // EFFECTS removes and returns last object from non-empty list
+    //         throws an instance of emptyList if empty
+
+    handle front() const;
+    // EFFECTS returns a handle to the first node, or NULL if empty
+
+    handle back() const;
+    // EFFECTS returns a handle to the last node, or NULL if empty
+
+    static T &at(handle h);
+    // REQUIRES h names a node of some list
+    // EFFECTS returns the object in the node named by h
+
+    void splice(handle pos, handle h);
+    // REQUIRES h names a node of this list; pos names one too, or is NULL
+    // MODIFIES this
+    // EFFECTS moves the node named by h to just before pos, or to the back
+    //         if pos is NULL, in constant time and without allocating
+
+    void moveToFront(handle h);
+    // REQUIRES h names a node of this list
+    // MODIFIES this
+    // EFFECTS moves the node named by h to the front in constant time
+
+    T erase(handle h);
+    // REQUIRES h names a node of this list
+    // MODIFIES this
+    // EFFECTS removes the node named by h in constant time and returns its
+    //         object; h is no longer valid
+
+    template <bool reverse>
+    class basic_const_iterator {
+        // OVERVIEW: walks the list front to back, or back to front if
+        //           reverse, without changing it. It yields the
+        //           objects held in the nodes.
+        //           An iterator stays valid until the node it is at is
+        //           removed, however the list is reordered, but reordering
+        //           while walking may skip or repeat nodes.
+
+        const node *cur;    // The node at, or NULL past the end
+        const node *start;  // The node the walk began at
+
+        friend class Vlist;
+
+        basic_const_iterator(const node *cur) : cur(cur), start(cur) {}
+
+       public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const T *pointer;
+        typedef const T &reference;
+
+        basic_const_iterator() : cur(nullptr), start(nullptr) {}
+
+        reference operator*() const { return cur->value; }
+
+        pointer operator->() const { return &cur->value; }
+
+        basic_const_iterator &operator++() {
+            // REQUIRES this is not past the end
+            cur = reverse ? cur->prev : cur->next;
+            if (cur == start) cur = nullptr;
+            return *this;
+        }
+
+        basic_const_iterator operator++(int) {
+            basic_const_iterator old = *this;
+            ++*this;
+            return old;
+        }
+
+        bool operator==(const basic_const_iterator &i) const { return cur == i.cur; }
+
+        bool operator!=(const basic_const_iterator &i) const { return cur != i.cur; }
+    };
+
+    typedef basic_const_iterator<false> const_iterator;
+    typedef basic_const_iterator<true> const_reverse_iterator;
+
+    const_iterator begin() const;
+    // EFFECTS returns an iterator at the first object, or end() if empty
+
+    const_iterator end() const;
+    // EFFECTS returns the iterator past the last object
+
+    const_reverse_iterator rbegin() const;
+    // EFFECTS returns an iterator at the last object, or rend() if empty
+
+    const_reverse_iterator rend() const;
+    // EFFECTS returns the iterator past the first object
+
+    // Maintenance methods
+    Vlist();                           // constructor
+    explicit Vlist(allocator_type a);  // constructor, with nodes from a
+    Vlist(const Vlist &l);             // copy constructor
+    Vlist &operator=(const Vlist &l);  // assignment operator
+    Vlist(Vlist &&l);                  // move constructor
+    Vlist &operator=(Vlist &&l);       // move assignment
+    ~Vlist();                          // destructor
+
+   private:
+    struct node {
+        node *next;
+        node *prev;
+        T value;
+
+        template <class... Args>
+        explicit node(Args &&... args);
+    };
+
+    node *first;  // The pointer to the first node (NULL if none)
+    node *last;   // The pointer to the last node (NULL if none)
+    Alloc<node> nodes;  // Where nodes come from; moved, never copied
+
+    // Utility methods
+
+    void link(node *n, bool front);
+    // MODIFIES this
+    // EFFECTS: puts n at the front or the back of the list
+
+    T unlink(node *n);
+    // REQUIRES n is a node of this list
+    // MODIFIES this
+    // EFFECTS: removes n from the list, frees it and returns its object
+
+    void removeAll();
+    // EFFECT: called by destructor/operator= to remove and destroy
+    //         all list elements
+
+    void copyAll(const Vlist &l);
+    // EFFECT: called by copy constructor/operator= to copy elements
+    //         from a source instance l to this instance
+};
+
+#include "vlist_impl.h"
+
+#endif /* __VLIST_H__ */
@@ -0,0 +1,241 @@
+#ifndef VE280_VLIST_IMPL_H
+#define VE280_VLIST_IMPL_H
+
+#include <utility>
+
+#include "vlist.h"
+#include "../../../bench/tracing.h"
+
+template<class T, template <class> class Alloc>
+template<class... Args>
+Vlist<T, Alloc>::node::node(Args &&... args) :
+        next(nullptr), prev(nullptr), value(std::forward<Args>(args)...) {}
+
+template<class T, template <class> class Alloc>
+bool Vlist<T, Alloc>::isEmpty() const {
+    return first == nullptr;
+}
+
+template<class T, template <class> class Alloc>
+void Vlist<T, Alloc>::link(node *n, bool front) {
+    if (isEmpty()) {
+        first = last = n->prev = n->next = n;
+    } else {
+        n->prev = last;
+        n->next = first;
+        first->prev = last->next = n;
+        if (front) {
+            first = n;
+        } else {
+            last = n;
+        }
+    }
+}
+
+template<class T, template <class> class Alloc>
+T Vlist<T, Alloc>::unlink(node *n) {
+    if (n == n->next) {
+        first = last = nullptr;
+    } else {
+        n->prev->next = n->next;
+        n->next->prev = n->prev;
+        if (n == first) first = n->next;
+        if (n == last) last = n->prev;
+    }
+    T value = std::move(n->value);
+    nodes.deallocate(n);
+    return value;
+}
+
+template<class T, template <class> class Alloc>
+template<class... Args>
+void Vlist<T, Alloc>::emplaceFront(Args &&... args) {
+    TRACE_SCOPE("Vlist::emplaceFront");
+    link(nodes.allocate(std::forward<Args>(args)...), true);
+}
+
+template<class T, template <class> class Alloc>
+template<class... Args>
+void Vlist<T, Alloc>::emplaceBack(Args &&... args) {
+    TRACE_SCOPE("Vlist::emplaceBack");
+    link(nodes.allocate(std::forward<Args>(args)...), false);
+}
+
+template<class T, template <class> class Alloc>
+void Vlist<T, Alloc>::insertFront(T value) {
+    emplaceFront(std::move(value));
+}
+
+template<class T, template <class> class Alloc>
+void Vlist<T, Alloc>::insertBack(T value) {
+    emplaceBack(std::move(value));
+}
+
+template<class T, template <class> class Alloc>
+T Vlist<T, Alloc>::removeFront() {
+    TRACE_SCOPE("Vlist::removeFront");
+    if (isEmpty()) {
+        throw emptyList();
+    }
+    return unlink(first);
+}
+
+template<class T, template <class> class Alloc>
+T Vlist<T, Alloc>::removeBack() {
+    TRACE_SCOPE("Vlist::removeBack");
+    if (isEmpty()) {
+        throw emptyList();
+    }
+    return unlink(last);
+}
+
+template<class T, template <class> class Alloc>
+typename Vlist<T, Alloc>::handle Vlist<T, Alloc>::front() const {
+    return first;
+}
+
+template<class T, template <class> class Alloc>
+typename Vlist<T, Alloc>::handle Vlist<T, Alloc>::back() const {
+    return last;
+}
+
+template<class T, template <class> class Alloc>
+T &Vlist<T, Alloc>::at(handle h) {
+    return h->value;
+}
+
+template<class T, template <class> class Alloc>
+void Vlist<T, Alloc>::moveToFront(handle h) {
+    TRACE_SCOPE("Vlist::moveToFront");
+    if (h == first) {
+        return;
+    }
+    if (h == last) {
+        // The list is circular: the last node becomes first by rotation
+        first = last;
+        last = last->prev;
+        return;
+    }
+    h->prev->next = h->next;
+    h->next->prev = h->prev;
+    h->prev = last;
+    h->next = first;
+    first = first->prev = last->next = h;
+}
+
+template<class T, template <class> class Alloc>
+void Vlist<T, Alloc>::splice(handle pos, handle h) {
+    TRACE_SCOPE("Vlist::splice");
+    if (h == pos || h == h->next) {
+        return;
+    }
+    h->prev->next = h->next;
+    h->next->prev = h->prev;
+    if (h == first) first = h->next;
+    if (h == last) last = h->prev;
+    // Insert before pos; before first is the same place as after last
+    auto after = pos ? pos : first;
+    h->prev = after->prev;
+    h->next = after;
+    after->prev->next = h;
+    after->prev = h;
+    if (!pos) {
+        last = h;
+    } else if (pos == first) {
+        first = h;
+    }
+}
+
+template<class T, template <class> class Alloc>
+T Vlist<T, Alloc>::erase(handle h) {
+    TRACE_SCOPE("Vlist::erase");
+    return unlink(h);
+}
+
+template<class T, template <class> class Alloc>
+typename Vlist<T, Alloc>::const_iterator Vlist<T, Alloc>::begin() const {
+    return const_iterator(first);
+}
+
+template<class T, template <class> class Alloc>
+typename Vlist<T, Alloc>::const_iterator Vlist<T, Alloc>::end() const {
+    return const_iterator(nullptr);
+}
+
+template<class T, template <class> class Alloc>
+typename Vlist<T, Alloc>::const_reverse_iterator Vlist<T, Alloc>::rbegin() const {
+    return const_reverse_iterator(last);
+}
+
+template<class T, template <class> class Alloc>
+typename Vlist<T, Alloc>::const_reverse_iterator Vlist<T, Alloc>::rend() const {
+    return const_reverse_iterator(nullptr);
+}
+
+template<class T, template <class> class Alloc>
+Vlist<T, Alloc>::Vlist() {
+    first = last = nullptr;
+}
+
+template<class T, template <class> class Alloc>
+Vlist<T, Alloc>::Vlist(allocator_type a) : nodes(std::move(a)) {
+    first = last = nullptr;
+}
+
+template<class T, template <class> class Alloc>
+Vlist<T, Alloc>::Vlist(const Vlist &l) {
+    first = last = nullptr;
+    copyAll(l);
+}
+
+template<class T, template <class> class Alloc>
+Vlist<T, Alloc> &Vlist<T, Alloc>::operator=(const Vlist &l) {
+    if (this != &l) {
+        removeAll();
+        copyAll(l);
+    }
+    return *this;
+}
+
+template<class T, template <class> class Alloc>
+Vlist<T, Alloc>::Vlist(Vlist &&l) : first(l.first), last(l.last), nodes(std::move(l.nodes)) {
+    l.first = l.last = nullptr;
+}
+
+template<class T, template <class> class Alloc>
+Vlist<T, Alloc> &Vlist<T, Alloc>::operator=(Vlist &&l) {
+    if (this != &l) {
+        removeAll();
+        // The nodes belong to l's pool, so it comes along with them
+        nodes = std::move(l.nodes);
+        first = l.first;
+        last = l.last;
+        l.first = l.last = nullptr;
+    }
+    return *this;
+}
+
+template<class T, template <class> class Alloc>
+Vlist<T, Alloc>::~Vlist() {
+    removeAll();
+}
+
+template<class T, template <class> class Alloc>
+void Vlist<T, Alloc>::removeAll() {
+    while (!isEmpty()) {
+        unlink(last);
+    }
+}
+
+template<class T, template <class> class Alloc>
+void Vlist<T, Alloc>::copyAll(const Vlist &l) {
+    if (!l.isEmpty()) {
+        auto temp = l.first;
+        do {
+            emplaceBack(temp->value);
+            temp = temp->next;
+        } while (temp != l.first);
+    }
+}
+
+#endif //VE280_VLIST_IMPL_H
@@ -2,208 +2,335 @@
 // Created by liu on 16-7-19.
 //
 
-#include "dlist.h"
+#include "stack.h"
+#include "../../p5-list-hard/answer/bigint.h"
+#include "../../p5-list-hard/answer/operators.h"
 #include <iostream>
+#include <sstream>
 #include <string>
+#include <cctype>
+#include <cstdio>
 #include <cstdlib>
 
 using namespace std;
 
+// Usage: calc [-big] [-script [FILE]]
+//
+// Reads commands from standard input one at a time. With -script the whole
+// of FILE, or of standard input if none is named, is read at once, and
+// the output is gathered in memory and written when the script ends. With
+// -big the stack holds BigInt rather than int, so that numbers of any size
+// are exact.
+
 const char op[] = "q+-*/ndrpca";
 
-void two(char c, Dlist<int> *stack)
+static int applyhelper(OperatorKind kind, int a, int b)
+// REQUIRES: kind is not OPERATOR_NONE, and b != 0 if it needs a divisor
+// EFFECTS: returns the result of kind on a and b, through the kernel of
+//          its descriptor
+{
+    return OPERATORS[kind].kernel(a, b);
+}
+
+static BigInt applyhelper(OperatorKind kind, const BigInt &a, const BigInt &b)
+// REQUIRES: kind is not OPERATOR_NONE, and b != 0 if it needs a divisor
+// EFFECTS: returns the result of kind on a and b
+{
+    return applyOperator(kind, a, b);
+}
+
+template <class V>
+void two(char c, Stack<V> *stack, ostream &out)
 {
-    int *a, *b;
+    V a = stack->pop();
+    V b;
     try
     {
-        a = stack->removeBack();
+        b = stack->pop();
     }
     catch (emptyList)
     {
+        stack->push(a);
         throw;
     }
-    try
+    if (c == 'r')
     {
-        b = stack->removeBack();
+        stack->push(a);
+        stack->push(b);
+        return;
     }
-    catch (emptyList)
+    OperatorKind kind = operatorKind(c);
+    if (OPERATORS[kind].needsDivisor && a == 0)
     {
-        stack->insertBack(a);
-        throw;
+        out << "Divide by zero\n";
+        stack->push(b);
+        stack->push(a);
+        return;
     }
-    switch (c)
-    {
-    case '+':
-        *b = *b + *a;
-        break;
-    case '-':
-        *b = *b - *a;
-        break;
-    case '*':
-        *b = *b * *a;
-        break;
-    case '/':
-        if (*a != 0)
-        {
-            *b = *b / *a;
-        }
-        else
-        {
-            cout << "Divide by zero\n";
-            return;
-        }
-        break;
-    case 'r':
-        stack->insertBack(a);
-        break;
-    default:
-        break;
-    }
-    stack->insertBack(b);
+    stack->push(applyhelper(kind, b, a));
 }
 
-void one(char c, Dlist<int> *stack)
+template <class V>
+void one(char c, Stack<V> *stack, ostream &out)
 {
-    int *a;
-    try
-    {
-        a = stack->removeBack();
-    }
-    catch (emptyList)
-    {
-        throw;
-    }
+    V &a = stack->top();
     switch (c)
     {
-    case 'n':
-        *a *= 1;
-        break;
     case 'd':
-    {
-        auto b = new int(*a);
-        stack->insertBack(b);
+        stack->push(V(a));
         break;
-    }
     case 'p':
-        cout << *a << endl;
+        out << a << '\n';
         break;
     default:
+        a = applyhelper(operatorKind(c), a, V(0));
         break;
     }
-    stack->insertBack(a);
 }
 
-void clear(Dlist<int> *stack)
+template <class V>
+void clear(Stack<V> *stack)
 {
-    try
+    stack->clear();
+}
+
+template <class V>
+void print(const Stack<V> *stack, ostream &out)
+{
+    // Top first, as removing from the back of the list printed it
+    for (int i = 0; i < stack->size(); i++)
     {
-        while (true)
-        {
-            stack->removeBack();
-        }
+        out << (*stack)[i] << " ";
     }
-    catch (emptyList)
-    { }
+    out << '\n';
 }
 
-void print(const Dlist<int> *stack)
+template <class V>
+using Command = bool (*)(char c, Stack<V> *stack, ostream &out);
+// A command named by one character. Returns false if the calculator
+// should stop.
+
+template <class V>
+static bool quithelper(char, Stack<V> *, ostream &)
 {
-    auto temp = new Dlist<int>(*stack);
-    try
+    return false;
+}
+
+template <class V>
+static bool twohelper(char c, Stack<V> *stack, ostream &out)
+{
+    two(c, stack, out);
+    return true;
+}
+
+template <class V>
+static bool onehelper(char c, Stack<V> *stack, ostream &out)
+{
+    one(c, stack, out);
+    return true;
+}
+
+template <class V>
+static bool clearhelper(char, Stack<V> *stack, ostream &)
+{
+    clear(stack);
+    return true;
+}
+
+template <class V>
+static bool printhelper(char, Stack<V> *stack, ostream &out)
+{
+    print(stack, out);
+    return true;
+}
+
+template <class V>
+static const Command<V> *tablehelper()
+// EFFECTS: returns the command for every first character, NULL where
+//          there is none
+{
+    static Command<V> table[256] = {};
+    if (!table['q'])
     {
-        while (true)
+        for (const Operator &o : OPERATORS)
         {
-            cout << temp->removeBack() << " ";
+            table[(unsigned char) o.symbol] = o.arity == 2 ? twohelper<V> : onehelper<V>;
         }
+        table['r'] = twohelper<V>;
+        table['d'] = table['p'] = onehelper<V>;
+        table['c'] = clearhelper<V>;
+        table['a'] = printhelper<V>;
+        table['q'] = quithelper<V>;
     }
-    catch (emptyList)
+    return table;
+}
+
+static void pushhelper(const char *cmd, size_t length, Stack<int> *stack)
+// REQUIRES: [cmd, cmd + length) is digits, after an optional '-'
+// MODIFIES: stack
+// EFFECTS: pushes the number, wrapped to int
+{
+    int sym = 1;
+    size_t i = 0;
+    if (cmd[0] == '-')
     {
-        cout << endl;
+        sym = -1;
+        i = 1;
+    }
+    int num = 0;
+    for (; i < length; i++)
+    {
+        num *= 10;
+        num += cmd[i] - '0';
     }
+    num *= sym;
+    stack->push(num);
+}
+
+static void pushhelper(const char *cmd, size_t length, Stack<BigInt> *stack)
+// REQUIRES: [cmd, cmd + length) is digits, after an optional '-'
+// MODIFIES: stack
+// EFFECTS: pushes the number
+{
+    BigInt num;
+    BigInt::parse(cmd, cmd + length, num);
+    stack->push(num);
 }
 
-bool input(string cmd, Dlist<int> *stack)
+template <class V>
+static bool dispatchhelper(const char *cmd, size_t length, Stack<V> *stack, ostream &out)
+// REQUIRES: length > 0
+// MODIFIES: stack, out
+// EFFECTS: runs the command or pushes the number in [cmd, cmd + length),
+//          printing any error to out. Returns false if the command was q.
 {
-    if (cmd.length() == 1)
+    if (length == 1)
     {
-        try
+        Command<V> command = tablehelper<V>()[(unsigned char) cmd[0]];
+        if (command)
         {
-            switch (cmd[0])
+            try
             {
-            case 'q':
-                return false;
-            case '+':
-            case '-':
-            case '*':
-            case '/':
-            case 'r':
-                two(cmd[0], stack);
-                return true;
-            case 'n':
-            case 'd':
-            case 'p':
-                one(cmd[0], stack);
-                return true;
-            case 'c':
-                clear(stack);
-                return true;
-            case 'a':
-                print(stack);
+                return command(cmd[0], stack, out);
+            }
+            catch (emptyList)
+            {
+                out << "Not enough operands\n";
                 return true;
-            default:
-                if (cmd[0] < '0' || cmd[0] > '9')
-                {
-                    cout << "Bad input\n";
-                    return true;
-                }
             }
         }
-        catch (emptyList)
+        if (cmd[0] < '0' || cmd[0] > '9')
         {
-            cout << "Not enough operands\n";
+            out << "Bad input\n";
             return true;
         }
     }
 
-    int sym = 1;
+    size_t i = 0;
     if (cmd[0] == '-')
     {
-        sym = -1;
-        cmd = cmd.substr(1);
-        if (cmd.length() < 1)
+        i = 1;
+        if (length < 2)
         {
-            cout << "Bad input\n";
+            out << "Bad input\n";
             return true;
         }
     }
-    int num = 0;
-    for (int i = 0; i < cmd.length(); i++)
+    for (; i < length; i++)
     {
-        if (cmd[i] >= '0' && cmd[i] <= '9')
+        if (cmd[i] < '0' || cmd[i] > '9')
         {
-            num *= 10;
-            num += cmd[i] - '0';
-        }
-        else
-        {
-            cout << "Bad input\n";
+            out << "Bad input\n";
             return true;
         }
     }
-    num *= sym;
-    stack->insertBack(new int(num));
+    pushhelper(cmd, length, stack);
     return true;
 }
 
-int main()
+bool input(string cmd, Stack<int> *stack)
 {
+    return dispatchhelper(cmd.data(), cmd.length(), stack, cout);
+}
+
+template <class V>
+static int scripthelper(const char *path)
+// EFFECTS: runs the script in the file at path, or on standard input if
+//          path is NULL, on a stack of V, and returns the exit status
+{
+    FILE *file = path ? fopen(path, "rb") : stdin;
+    if (!file)
+    {
+        cerr << "Error: cannot open " << path << endl;
+        return 1;
+    }
+    string script;
+    char chunk[65536];
+    size_t got;
+    while ((got = fread(chunk, 1, sizeof(chunk), file)) > 0)
+    {
+        script.append(chunk, got);
+    }
+    if (path)
+    {
+        fclose(file);
+    }
+
+    ostringstream out;
+    Stack<V> stack;
+    const char *p = script.data(), *end = p + script.size();
+    while (true)
+    {
+        while (p < end && isspace((unsigned char) *p))
+        {
+            p++;
+        }
+        if (p == end)
+        {
+            break;
+        }
+        const char *token = p;
+        while (p < end && !isspace((unsigned char) *p))
+        {
+            p++;
+        }
+        if (!dispatchhelper(token, size_t(p - token), &stack, out))
+        {
+            break;
+        }
+    }
+    const string &result = out.str();
+    fwrite(result.data(), 1, result.size(), stdout);
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    bool big = argc > 1 && string(argv[1]) == "-big";
+    if (big)
+    {
+        argc--;
+        argv++;
+    }
+    if (argc > 1 && string(argv[1]) == "-script")
+    {
+        const char *path = argc > 2 ? argv[2] : NULL;
+        return big ? scripthelper<BigInt>(path) : scripthelper<int>(path);
+    }
+
     string str;
-    auto *stack = new Dlist<int>;
-    do
+    if (big)
+    {
+        Stack<BigInt> stack;
+        while (cin >> str && dispatchhelper(str.data(), str.length(), &stack, cout))
+        {
+        }
+        return 0;
+    }
+    auto *stack = new Stack<int>;
+    while (cin >> str && input(str, stack))
     {
-        cin >> str;
     }
-    while (input(str, stack));
     delete stack;
     return 0;
-}
\ No newline at end of file
+}
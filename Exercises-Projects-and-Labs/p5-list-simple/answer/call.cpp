@@ -6,9 +6,35 @@
 #include <iostream>
 #include <string>
 #include <cstdlib>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <queue>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <vector>
 
 using namespace std;
 
+// Usage: call [-events] [-agents N]
+//        call -replicate R [-agents N,N,...] [-calls N] [-rate X]
+//             [-duration X] [-mix P,G,S,R] [-threads N] [-seed N]
+//
+// Simulates agents answering calls, highest status first. Time jumps from
+// one event (an arrival or the end of a call) to the next; the ticks in
+// between are printed as if they had been simulated, unless -events is
+// given, when only the ticks at which something happens are printed.
+//
+// With -replicate the calls are not read but generated: R independent
+// replications of -calls calls each are run for every agent count, on
+// -threads threads. Arrivals average -rate calls a tick, calls last
+// -duration ticks on average, and -mix weighs the four statuses. The wait
+// of every call, from its arrival to its answer, is pooled over the
+// replications and its percentiles printed per status. Replication i
+// always draws from the same random stream, so the results do not depend
+// on the number of threads.
+
 enum STATUS
 {
     PLATINUM, GOLD, SILVER, REGULAR,
@@ -21,8 +47,33 @@ struct Customer
     int timestamp;
     string name;
     int duration;
+    STATUS status;
 };
 
+enum EVENT_KIND
+{
+    COMPLETION, ARRIVAL,
+};
+
+struct Event
+{
+    int time;
+    EVENT_KIND kind;
+    long sequence;          // Arrivals at the same time keep input order
+    Customer *customer;     // The caller, for an arrival
+
+    bool operator>(const Event &other) const
+    {
+        // Earliest first; at the same time agents are freed before anyone
+        // arrives
+        if (time != other.time) return time > other.time;
+        if (kind != other.kind) return kind > other.kind;
+        return sequence > other.sequence;
+    }
+};
+
+typedef priority_queue<Event, vector<Event>, greater<Event> > EventQueue;
+
 STATUS getStatus(string str)
 {
     for (int i = 0; i < 4; i++)
@@ -32,78 +83,356 @@ STATUS getStatus(string str)
             return STATUS(i);
         }
     }
+    return REGULAR;
 }
 
-int main()
+class CallSource
 {
-    int num, time_next = 0;
-    auto customer = new Dlist<Customer>[4];
-    cin >> num;
-    if (num > 0)
+    // OVERVIEW: the calls of one simulation, in order of arrival
+public:
+    virtual bool next(Customer &c) = 0;
+    // MODIFIES: this, c
+    // EFFECTS: sets c to the next call and returns true, or returns false
+    //          if there are no more
+
+    virtual ~CallSource()
     {
-        num--;
-        cin >> time_next;
     }
-    else
+};
+
+class InputSource : public CallSource
+{
+    // OVERVIEW: calls read from a stream: their number, then a line
+    //           "timestamp name status duration" for each
+    istream &is;
+    int remaining;
+
+public:
+    explicit InputSource(istream &is) : is(is), remaining(0)
+    {
+        if (!(is >> remaining))
+        {
+            remaining = 0;
+        }
+    }
+
+    bool next(Customer &c)
+    {
+        if (remaining <= 0)
+        {
+            return false;
+        }
+        string str;
+        is >> c.timestamp >> c.name >> str >> c.duration;
+        c.status = getStatus(str);
+        remaining--;
+        return true;
+    }
+};
+
+class RandomSource : public CallSource
+{
+    // OVERVIEW: a fixed number of random calls. Gaps between arrivals and
+    //           call lengths are geometric, the discrete counterpart of
+    //           the exponential times of a Poisson process.
+    mt19937_64 rng;
+    geometric_distribution<int> gap, length;
+    discrete_distribution<int> mix;
+    int remaining;
+    int time;
+
+public:
+    RandomSource(unsigned long long seed, unsigned long long stream, int calls, double rate,
+                 double duration, const vector<double> &weights) :
+            gap(rate / (1 + rate)), length(1 / duration), mix(weights.begin(), weights.end()),
+            remaining(calls), time(0)
     {
-        time_next = -1;
+        // REQUIRES: rate > 0, duration >= 1, and weights holds four
+        //           non-negative weights, not all 0
+        seed_seq seq = {(unsigned) seed, (unsigned) (seed >> 32), (unsigned) stream,
+                        (unsigned) (stream >> 32)};
+        rng.seed(seq);
     }
-    int time = 0, end = 0;
+
+    bool next(Customer &c)
+    {
+        if (remaining <= 0)
+        {
+            return false;
+        }
+        time += gap(rng);
+        c.timestamp = time;
+        c.duration = 1 + length(rng);
+        c.status = STATUS(mix(rng));
+        remaining--;
+        return true;
+    }
+};
+
+static void readhelper(CallSource &source, long sequence, EventQueue &events)
+// MODIFIES: source, events
+// EFFECTS: schedules the arrival of the next call of source, if any
+{
+    auto temp = new Customer;
+    if (!source.next(*temp))
+    {
+        delete temp;
+        return;
+    }
+    events.push(Event{temp->timestamp, ARRIVAL, sequence, temp});
+}
+
+static void simulatehelper(CallSource &source, int agents, ostream *log, bool eventsOnly,
+                           vector<int> *waits)
+// REQUIRES: agents > 0, and waits is null or has one vector per status
+// MODIFIES: source, *log, waits
+// EFFECTS: runs the calls of source through agents agents, printing the
+//          simulation to log if it is not null. Appends the wait of every
+//          call, by status, to waits if it is not null.
+{
+    auto customer = new Dlist<Customer>[4];
+    int waiting = 0;
+    long sequence = 0;
+    EventQueue events;
+    // Calls are read one ahead, so the queue never holds more than the
+    // next arrival and the end of every call in progress
+    readhelper(source, sequence++, events);
+
+    int time = 0, printed = -1, idle = agents;
     while (true)
     {
-        cout << "Starting tick #" << time << endl;
-        while (time == time_next && num >= 0)
-        {
-            auto temp = new Customer;
-            temp->timestamp = time_next;
-            cin >> temp->name;
-            string str;
-            cin >> str;
-            auto status = getStatus(str);
-            cin >> temp->duration;
-            customer[status].insertBack(temp);
-            cout << "Call from " << temp->name << " a " << STATUS_STR[status] << " member" << endl;
-            num--;
-            if (num >= 0)
+        if (log && eventsOnly)
+        {
+            *log << "Starting tick #" << time << '\n';
+        }
+        else if (log)
+        {
+            while (printed < time)
             {
-                cin >> time_next;
+                *log << "Starting tick #" << ++printed << '\n';
             }
         }
-        if (end > time)
+        printed = time;
+
+        while (!events.empty() && events.top().time <= time)
         {
-            time++;
-            continue;
+            Event e = events.top();
+            events.pop();
+            if (e.kind == COMPLETION)
+            {
+                idle++;
+                continue;
+            }
+            customer[e.customer->status].insertBack(e.customer);
+            waiting++;
+            if (log)
+            {
+                *log << "Call from " << e.customer->name << " a "
+                     << STATUS_STR[e.customer->status] << " member\n";
+            }
+            readhelper(source, sequence++, events);
         }
-        bool count = 0;
-        for (int i = 0; i < 4; i++)
+
+        for (int i = 0; i < 4 && idle > 0 && waiting > 0; i++)
         {
-            try
+            // Every idle agent answers one call, even a zero-length one,
+            // and is busy until the next tick at least
+            while (idle > 0 && !customer[i].isEmpty())
             {
                 auto temp = customer[i].removeFront();
-                count++;
-                if (temp->timestamp <= time)
+                waiting--;
+                idle--;
+                if (log)
                 {
-                    cout << "Answering call from " << temp->name << endl;
-                    end += temp->duration;
-                    delete temp;
-                    break;
+                    *log << "Answering call from " << temp->name << '\n';
                 }
-                else
+                if (waits)
                 {
-                    customer[i].insertFront(temp);
+                    waits[i].push_back(time - temp->timestamp);
                 }
-            }
-            catch (emptyList)
-            {
-                continue;
+                events.push(Event{time + (temp->duration > 0 ? temp->duration : 1), COMPLETION,
+                                  0, NULL});
+                delete temp;
             }
         }
-        if (count == 0 && time == end)
+
+        if (events.empty())
         {
             break;
         }
-        time++;
+        time = events.top().time;
     }
     delete[] customer;
+}
+
+static bool listhelper(const string &s, vector<double> &values)
+// MODIFIES: values
+// EFFECTS: parses the comma-separated numbers in s into values and returns
+//          true, or returns false if s is not such a list
+{
+    values.clear();
+    istringstream iss(s);
+    double v;
+    while (iss >> v)
+    {
+        values.push_back(v);
+        if (iss.peek() == ',')
+        {
+            iss.get();
+        }
+    }
+    return iss.eof() && !values.empty();
+}
+
+static int replicatehelper(int replications, const vector<int> &agents, int calls, double rate,
+                           double duration, const vector<double> &weights, int threads,
+                           unsigned long long seed)
+// EFFECTS: runs replications replications for every count in agents on
+//          threads threads, prints the percentiles of the waits and returns
+//          the exit status
+{
+    for (size_t a = 0; a < agents.size(); a++)
+    {
+        // Each replication keeps its own waits, merged once all are done
+        vector<vector<int> > results(size_t(replications) * 4);
+        atomic<int> nextReplication(0);
+        auto worker = [&]()
+        {
+            int r;
+            while ((r = nextReplication++) < replications)
+            {
+                RandomSource source(seed, (unsigned long long) r, calls, rate, duration, weights);
+                simulatehelper(source, agents[a], NULL, false, &results[size_t(r) * 4]);
+            }
+        };
+        vector<thread> pool;
+        for (int t = 1; t < threads; t++)
+        {
+            pool.push_back(thread(worker));
+        }
+        worker();
+        for (size_t t = 0; t < pool.size(); t++)
+        {
+            pool[t].join();
+        }
+
+        for (int s = 0; s < 4; s++)
+        {
+            vector<int> waits;
+            for (int r = 0; r < replications; r++)
+            {
+                const vector<int> &w = results[size_t(r) * 4 + s];
+                waits.insert(waits.end(), w.begin(), w.end());
+            }
+            cout << agents[a] << (agents[a] == 1 ? " agent, " : " agents, ") << STATUS_STR[s]
+                 << ": " << waits.size() << " calls";
+            if (!waits.empty())
+            {
+                sort(waits.begin(), waits.end());
+                double total = 0;
+                for (size_t i = 0; i < waits.size(); i++)
+                {
+                    total += waits[i];
+                }
+                const int percentiles[] = {50, 90, 99};
+                cout << ", mean wait " << total / waits.size();
+                for (int p = 0; p < 3; p++)
+                {
+                    // Nearest rank
+                    size_t rank = (waits.size() * percentiles[p] + 99) / 100;
+                    cout << ", p" << percentiles[p] << " " << waits[rank - 1];
+                }
+            }
+            cout << '\n';
+        }
+    }
     return 0;
-}
\ No newline at end of file
+}
+
+int main(int argc, char *argv[])
+{
+    bool eventsOnly = false;
+    int replications = 0, calls = 1000, threads = int(thread::hardware_concurrency());
+    double rate = 0.5, duration = 3;
+    unsigned long long seed = 280;
+    vector<double> agentList(1, 1), weights(4, 1);
+    for (int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "-events")
+        {
+            eventsOnly = true;
+        }
+        else if (arg == "-replicate" && hasValue)
+        {
+            replications = atoi(argv[++i]);
+        }
+        else if (arg == "-agents" && hasValue && listhelper(argv[i + 1], agentList))
+        {
+            i++;
+        }
+        else if (arg == "-calls" && hasValue)
+        {
+            calls = atoi(argv[++i]);
+        }
+        else if (arg == "-rate" && hasValue)
+        {
+            rate = atof(argv[++i]);
+        }
+        else if (arg == "-duration" && hasValue)
+        {
+            duration = atof(argv[++i]);
+        }
+        else if (arg == "-mix" && hasValue && listhelper(argv[i + 1], weights))
+        {
+            i++;
+        }
+        else if (arg == "-threads" && hasValue)
+        {
+            threads = atoi(argv[++i]);
+        }
+        else if (arg == "-seed" && hasValue)
+        {
+            seed = strtoull(argv[++i], NULL, 10);
+        }
+        else
+        {
+            cerr << "Error: unknown option " << arg << endl;
+            return 1;
+        }
+    }
+
+    vector<int> agents;
+    for (size_t i = 0; i < agentList.size(); i++)
+    {
+        agents.push_back(int(agentList[i]));
+        if (agents.back() < 1)
+        {
+            cerr << "Error: the number of agents must be positive" << endl;
+            return 1;
+        }
+    }
+    if (replications > 0)
+    {
+        double weightSum = 0;
+        bool negative = false;
+        for (size_t i = 0; i < weights.size(); i++)
+        {
+            weightSum += weights[i];
+            negative = negative || weights[i] < 0;
+        }
+        if (weights.size() != 4 || negative || weightSum <= 0 || rate <= 0 || duration < 1
+            || calls < 0)
+        {
+            cerr << "Error: invalid replication parameters" << endl;
+            return 1;
+        }
+        return replicatehelper(replications, agents, calls, rate, duration, weights,
+                               threads > 0 ? threads : 1, seed);
+    }
+
+    InputSource source(cin);
+    simulatehelper(source, agents[0], &cout, eventsOnly, NULL);
+    return 0;
+}
@@ -13,20 +13,55 @@ bool Dlist<T>::isEmpty()
 }
 
 template<class T>
-void Dlist<T>::insertFront(T *op)
+void Dlist<T>::link(node *n, bool front)
 {
-    auto newNode = new node;
-    newNode->op = op;
     if (this->isEmpty())
     {
-        newNode->prev = newNode->next = newNode;
+        n->prev = n->next = n;
+        this->first = this->last = n;
     }
     else
     {
-        newNode->prev = this->last;
-        newNode->next = this->first;
+        n->prev = this->last;
+        n->next = this->first;
+        this->first->prev = this->last->next = n;
+        if (front)
+        {
+            this->first = n;
+        }
+        else
+        {
+            this->last = n;
+        }
+    }
+}
+
+template<class T>
+void Dlist<T>::unlink(node *n)
+{
+    if (n == n->next)
+    {
+        this->first = this->last = NULL;
+        return;
+    }
+    n->prev->next = n->next;
+    n->next->prev = n->prev;
+    if (n == this->first)
+    {
+        this->first = n->next;
+    }
+    if (n == this->last)
+    {
+        this->last = n->prev;
     }
-    this->first = newNode;
+}
+
+template<class T>
+void Dlist<T>::insertFront(T *op)
+{
+    auto newNode = new node;
+    newNode->op = op;
+    this->link(newNode, true);
 }
 
 template<class T>
@@ -34,60 +69,176 @@ void Dlist<T>::insertBack(T *op)
 {
     auto newNode = new node;
     newNode->op = op;
+    this->link(newNode, false);
+}
+
+template<class T>
+T *Dlist<T>::removeFront()
+{
     if (this->isEmpty())
     {
-        newNode->prev = newNode->next = newNode;
-    }
-    else
-    {
-        newNode->prev = this->last;
-        newNode->next = this->first;
+        throw emptyList();
     }
-    this->last = newNode;
+    return this->erase(this->first);
 }
 
 template<class T>
-T *Dlist<T>::removeFront()
+T *Dlist<T>::removeBack()
 {
     if (this->isEmpty())
     {
         throw emptyList();
     }
-    auto oldNode = this->first;
-    auto op = oldNode->op;
-    if (oldNode == oldNode->next)
+    return this->erase(this->last);
+}
+
+template<class T>
+typename Dlist<T>::handle Dlist<T>::front() const
+{
+    return this->first;
+}
+
+template<class T>
+T *Dlist<T>::at(handle h)
+{
+    return h->op;
+}
+
+template<class T>
+void Dlist<T>::splice(handle pos, handle h)
+{
+    if (h == pos)
     {
-        this->first = this->last = NULL;
+        return;
     }
-    else
+    this->unlink(h);
+    if (pos == NULL || this->isEmpty())
+    {
+        this->link(h, false);
+        return;
+    }
+    h->prev = pos->prev;
+    h->next = pos;
+    pos->prev->next = h;
+    pos->prev = h;
+    if (pos == this->first)
     {
-        this->first = oldNode->prev->next = oldNode->next;
-        oldNode->next->prev = oldNode->prev;
+        this->first = h;
     }
-    delete oldNode;
+}
+
+template<class T>
+void Dlist<T>::moveToFront(handle h)
+{
+    this->splice(this->first, h);
+}
+
+template<class T>
+T *Dlist<T>::erase(handle h)
+{
+    auto op = h->op;
+    this->unlink(h);
+    delete h;
     return op;
 }
 
 template<class T>
-T *Dlist<T>::removeBack()
+typename Dlist<T>::node *Dlist<T>::mergeRuns(node *a, node *b, bool (*cmp)(const T *, const T *))
 {
-    if (this->isEmpty())
+    node head;
+    auto tail = &head;
+    while (a != NULL && b != NULL)
     {
-        throw emptyList();
+        // b goes first only if it is before a, so equal nodes keep their order
+        if (cmp(b->op, a->op))
+        {
+            tail->next = b;
+            b = b->next;
+        }
+        else
+        {
+            tail->next = a;
+            a = a->next;
+        }
+        tail = tail->next;
+    }
+    tail->next = a != NULL ? a : b;
+    return head.next;
+}
+
+template<class T>
+void Dlist<T>::relink(node *run)
+{
+    this->first = run;
+    while (run->next != NULL)
+    {
+        run->next->prev = run;
+        run = run->next;
     }
-    auto oldNode = this->last;
-    auto op = oldNode->op;
-    if (oldNode == oldNode->next)
+    this->last = run;
+    this->last->next = this->first;
+    this->first->prev = this->last;
+}
+
+template<class T>
+void Dlist<T>::sort(bool (*cmp)(const T *, const T *))
+{
+    if (this->first == this->last)
     {
-        this->first = this->last = NULL;
+        return;
+    }
+    // bins[i] is NULL or a sorted run of 2^i nodes, the runs of higher bins
+    // taken from earlier in the list
+    node *bins[64] = {};
+    int used = 0;
+    this->last->next = NULL;
+    auto cur = this->first;
+    while (cur != NULL)
+    {
+        auto carry = cur;
+        cur = cur->next;
+        carry->next = NULL;
+        int i = 0;
+        for (; bins[i] != NULL; i++)
+        {
+            carry = mergeRuns(bins[i], carry, cmp);
+            bins[i] = NULL;
+        }
+        bins[i] = carry;
+        if (i == used)
+        {
+            used++;
+        }
+    }
+    node *run = NULL;
+    for (int i = 0; i < used; i++)
+    {
+        if (bins[i] != NULL)
+        {
+            run = mergeRuns(bins[i], run, cmp);
+        }
+    }
+    this->relink(run);
+}
+
+template<class T>
+void Dlist<T>::merge(Dlist &l, bool (*cmp)(const T *, const T *))
+{
+    if (&l == this || l.isEmpty())
+    {
+        return;
+    }
+    if (this->isEmpty())
+    {
+        this->first = l.first;
+        this->last = l.last;
     }
     else
     {
-        oldNode->prev->next = oldNode->next;
-        this->last = oldNode->next->prev = oldNode->prev;
+        this->last->next = l.last->next = NULL;
+        this->relink(mergeRuns(this->first, l.first, cmp));
     }
-    delete oldNode;
-    return op;
+    l.first = l.last = NULL;
 }
 
 template<class T>
@@ -99,15 +250,18 @@ Dlist<T>::Dlist()
 template<class T>
 Dlist<T>::Dlist(const Dlist &l)
 {
-    this->removeAll();
+    this->first = this->last = NULL;
     this->copyAll(l);
 }
 
 template<class T>
 Dlist<T> &Dlist<T>::operator=(const Dlist &l)
 {
-    this->removeAll();
-    this->copyAll(l);
+    if (this != &l)
+    {
+        this->removeAll();
+        this->copyAll(l);
+    }
     return *this;
 }
 
@@ -120,32 +274,22 @@ Dlist<T>::~Dlist()
 template<class T>
 void Dlist<T>::removeAll()
 {
-    if (!this->isEmpty())
+    while (!this->isEmpty())
     {
-        auto temp = this->first;
-        while (temp != temp->next)
-        {
-            temp = temp->next;
-            delete temp->prev->op;
-            delete temp->prev;
-        }
-        delete temp->op;
-        delete temp;
+        delete this->removeFront();
     }
-    this->first = this->last = NULL;
 }
 
 template<class T>
 void Dlist<T>::copyAll(const Dlist &l)
 {
-    if (l.last != NULL)
+    if (l.first != NULL)
     {
-        auto temp = l.last;
-        while (temp != temp->prev)
+        auto temp = l.first;
+        do
         {
-            this->insertFront(new T(*temp->op));
-            temp = temp->prev;
-        }
-        this->insertFront(temp->op);
+            this->insertBack(new T(*temp->op));
+            temp = temp->next;
+        } while (temp != l.first);
     }
 }
@@ -11,6 +11,8 @@ class Dlist
 {
     // OVERVIEW: contains a double-ended list of Objects
 
+    struct node;
+
  public:
 
     // Operational methods
@@ -36,6 +38,49 @@ class Dlist
     // EFFECTS removes and returns last object from non-empty list
     //         throws an instance of emptyList if empty
 
+    typedef node *handle;
+    // A handle names one node of the list. It stays valid until that node
+    // is removed, however the list is reordered.
+
+    handle front() const;
+    // EFFECTS returns a handle to the first node, or NULL if empty
+
+    static T *at(handle h);
+    // REQUIRES h names a node of some list
+    // EFFECTS returns the object in the node named by h
+
+    void splice(handle pos, handle h);
+    // REQUIRES h names a node of this list; pos names one too, or is NULL
+    // MODIFIES this
+    // EFFECTS moves the node named by h to just before pos, or to the back
+    //         if pos is NULL, in constant time and without allocating
+
+    void moveToFront(handle h);
+    // REQUIRES h names a node of this list
+    // MODIFIES this
+    // EFFECTS moves the node named by h to the front in constant time
+
+    T *erase(handle h);
+    // REQUIRES h names a node of this list
+    // MODIFIES this
+    // EFFECTS removes the node named by h in constant time and returns its
+    //         object; h is no longer valid
+
+    void sort(bool (*cmp)(const T *, const T *));
+    // REQUIRES cmp(a, b) tells whether a goes before b, a strict weak order
+    // MODIFIES this
+    // EFFECTS puts the objects in the order of cmp, those equal in the
+    //         order they were in, by a bottom-up merge sort in O(n log n).
+    //         The nodes are relinked, not allocated, so handles stay valid
+
+    void merge(Dlist &l, bool (*cmp)(const T *, const T *));
+    // REQUIRES this and l are each in the order of cmp, as sort() leaves
+    //          them
+    // MODIFIES this, l
+    // EFFECTS moves the nodes of l into this in the order of cmp, those of
+    //         this before equal ones of l, in O(n + m) without allocating,
+    //         and leaves l empty. Handles of l name nodes of this
+
     // Maintenance methods
     Dlist();                                   // constructor
     Dlist(const Dlist &l);                     // copy constructor
@@ -56,6 +101,27 @@ class Dlist
 
     // Utility methods
 
+    void link(node *n, bool front);
+    // MODIFIES this
+    // EFFECT: puts n at the front or the back of the list
+
+    static node *mergeRuns(node *a, node *b, bool (*cmp)(const T *, const T *));
+    // REQUIRES a and b are runs of nodes linked by next and ended by NULL,
+    //          each in the order of cmp
+    // EFFECT: links the nodes of both into one run in the order of cmp,
+    //         those of a before equal ones of b, and returns its first node
+
+    void relink(node *run);
+    // REQUIRES run is a run of nodes linked by next and ended by NULL
+    // MODIFIES this
+    // EFFECT: makes the list the nodes of run in its order, setting their
+    //         prev links and closing the circle
+
+    void unlink(node *n);
+    // REQUIRES n is a node of this list
+    // MODIFIES this
+    // EFFECT: takes n out of the list without freeing it
+
     void removeAll();
     // EFFECT: called by destructor/operator= to remove and destroy
     //         all list elements
@@ -0,0 +1,124 @@
+//
+// Array-backed stack used by the calculator.
+//
+#pragma once
+
+#include "stack.h"
+
+template<class T>
+bool Stack<T>::isEmpty() const
+{
+    return this->count == 0;
+}
+
+template<class T>
+int Stack<T>::size() const
+{
+    return this->count;
+}
+
+template<class T>
+void Stack<T>::grow()
+{
+    int newCapacity = this->capacity ? 2 * this->capacity : 16;
+    auto newItems = new T[newCapacity];
+    for (int i = 0; i < this->count; i++)
+    {
+        newItems[i] = this->items[i];
+    }
+    delete[] this->items;
+    this->items = newItems;
+    this->capacity = newCapacity;
+}
+
+template<class T>
+void Stack<T>::push(const T &op)
+{
+    if (this->count == this->capacity)
+    {
+        // op may be one of the objects that are about to move
+        T temp = op;
+        this->grow();
+        this->items[this->count++] = temp;
+        return;
+    }
+    this->items[this->count++] = op;
+}
+
+template<class T>
+T Stack<T>::pop()
+{
+    if (this->isEmpty())
+    {
+        throw emptyList();
+    }
+    return this->items[--this->count];
+}
+
+template<class T>
+T &Stack<T>::top()
+{
+    if (this->isEmpty())
+    {
+        throw emptyList();
+    }
+    return this->items[this->count - 1];
+}
+
+template<class T>
+const T &Stack<T>::operator[](int i) const
+{
+    return this->items[this->count - 1 - i];
+}
+
+template<class T>
+void Stack<T>::clear()
+{
+    this->count = 0;
+}
+
+template<class T>
+Stack<T>::Stack()
+{
+    this->items = NULL;
+    this->count = this->capacity = 0;
+}
+
+template<class T>
+Stack<T>::Stack(const Stack &s)
+{
+    this->items = NULL;
+    this->count = this->capacity = 0;
+    this->copyAll(s);
+}
+
+template<class T>
+Stack<T> &Stack<T>::operator=(const Stack &s)
+{
+    if (this != &s)
+    {
+        this->clear();
+        this->copyAll(s);
+    }
+    return *this;
+}
+
+template<class T>
+Stack<T>::~Stack()
+{
+    delete[] this->items;
+}
+
+template<class T>
+void Stack<T>::copyAll(const Stack &s)
+{
+    while (this->capacity < s.count)
+    {
+        this->grow();
+    }
+    for (int i = 0; i < s.count; i++)
+    {
+        this->items[i] = s.items[i];
+    }
+    this->count = s.count;
+}
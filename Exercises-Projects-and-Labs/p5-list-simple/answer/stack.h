@@ -0,0 +1,67 @@
+#ifndef __STACK_H__
+#define __STACK_H__
+
+#include "dlist.h"      // emptyList
+
+template <class T>
+class Stack
+{
+    // OVERVIEW: a stack of objects held by value in one growable array, so
+    //           pushing and popping allocate nothing once it has grown
+
+ public:
+
+    // Operational methods
+
+    bool isEmpty() const;
+    // EFFECTS: returns true if the stack is empty, false otherwise
+
+    int size() const;
+    // EFFECTS: returns the number of objects on the stack
+
+    void push(const T &op);
+    // MODIFIES this
+    // EFFECTS puts a copy of op on top of the stack
+
+    T pop();
+    // MODIFIES this
+    // EFFECTS removes and returns the top object of a non-empty stack
+    //         throws an instance of emptyList if empty
+
+    T &top();
+    // EFFECTS returns the top object of a non-empty stack
+    //         throws an instance of emptyList if empty
+
+    const T &operator[](int i) const;
+    // REQUIRES 0 <= i < size()
+    // EFFECTS returns the i-th object from the top; 0 is the top
+
+    void clear();
+    // MODIFIES this
+    // EFFECTS removes every object, keeping the array for reuse
+
+    // Maintenance methods
+    Stack();                                   // constructor
+    Stack(const Stack &s);                     // copy constructor
+    Stack &operator=(const Stack &s);          // assignment operator
+    ~Stack();                                  // destructor
+
+ private:
+    T      *items;     // The objects, bottom first
+    int     count;     // The number of objects
+    int     capacity;  // The length of items
+
+    // Utility methods
+
+    void grow();
+    // MODIFIES this
+    // EFFECT: doubles the capacity, keeping the objects
+
+    void copyAll(const Stack &s);
+    // EFFECT: called by copy constructor/operator= to copy the objects
+    //         of s to this empty instance
+};
+
+#include "stack.cpp"
+
+#endif /* __STACK_H__ */
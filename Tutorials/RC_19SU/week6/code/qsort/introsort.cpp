@@ -0,0 +1,85 @@
+// quickSort in nonrec.cpp without its scratch arrays and recursion: it
+// partitions in place around a median of three, keeps the parts still to
+// sort on a stack, sorts the small ones by insertion, and switches to
+// heapsort for a part that has been split too many times, so the worst
+// case is O(n log n) however the input is ordered.
+#include <iostream>
+#include <utility>
+using namespace std;
+
+const int SMALL = 16;   // parts this short are sorted by insertion
+
+void insertionSort(int *data, int left, int right) {
+    for (int i = left + 1; i < right; ++i) {
+        int v = data[i]; int j = i;
+        for (; j > left && data[j - 1] > v; --j) data[j] = data[j - 1];
+        data[j] = v;
+    }
+}
+
+void siftDown(int *heap, int root, int len) {
+    int v = heap[root];
+    for (int child; (child = 2 * root + 1) < len; root = child) {
+        if (child + 1 < len && heap[child + 1] > heap[child]) ++child;
+        if (heap[child] <= v) break;
+        heap[root] = heap[child];
+    } heap[root] = v;
+}
+
+void heapSort(int *data, int left, int right) {
+    int *heap = data + left; int len = right - left;
+    for (int i = len / 2 - 1; i >= 0; --i) siftDown(heap, i, len);
+    for (int end = len - 1; end > 0; --end) {
+        swap(heap[0], heap[end]); siftDown(heap, 0, end);
+    }
+}
+
+// REQUIRES: right - left >= 3
+// EFFECTS: puts a pivot at p, the elements <= it before and >= it after
+int partition(int *data, int left, int right) {
+    int mid = left + (right - left) / 2, last = right - 1;
+    // Median of three at mid, the least at left and the greatest at last,
+    // which stop the scans below without bounds checks
+    if (data[mid] < data[left]) swap(data[mid], data[left]);
+    if (data[last] < data[left]) swap(data[last], data[left]);
+    if (data[last] < data[mid]) swap(data[last], data[mid]);
+    int pivot = data[mid]; swap(data[mid], data[last - 1]);
+    int i = left, j = last - 1;
+    while (true) {
+        while (data[++i] < pivot) {}
+        while (pivot < data[--j]) {}
+        if (i >= j) break;
+        swap(data[i], data[j]);
+    } swap(data[i], data[last - 1]);
+    return i;
+}
+
+void introSort(int *data, int left, int right) {
+    int depth = 0;
+    for (int len = right - left; len > 1; len >>= 1) depth += 2;
+    // Each part with the splits it has left; the smaller part of a split is
+    // sorted first, so at most log2(n) parts wait at once
+    struct Part { int left, right, depth; } stack[64];
+    int top = 0; stack[top++] = {left, right, depth};
+    while (top > 0) {
+        Part part = stack[--top];
+        while (part.right - part.left > SMALL) {
+            if (part.depth-- == 0) { heapSort(data, part.left, part.right); break; }
+            int p = partition(data, part.left, part.right);
+            Part lo = {part.left, p, part.depth}, hi = {p + 1, part.right, part.depth};
+            if (lo.right - lo.left < hi.right - hi.left) swap(lo, hi);
+            stack[top++] = lo; part = hi;
+        }
+    }
+    // The parts left unsorted are short and in order, so one insertion sort
+    // over all of them takes O(n * SMALL)
+    insertionSort(data, left, right);
+}
+
+int main() {
+    int data[1000], n = 0;
+    while (n < 1000 && cin >> data[n]) ++n;
+    introSort(data, 0, n);
+    for (int i = 0; i < n; ++i) cout << data[i] << " ";
+    cout << endl;
+}
@@ -0,0 +1,144 @@
+// File grown into a reader: RAII still closes the file (and stops the
+// thread, and unmaps) however the scope is left, unwinding included.
+#include <condition_variable>
+#include <cstring>
+#include <fcntl.h>
+#include <mutex>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+class fileError {};   // Cannot open or read the file
+
+class BufferedFile {
+public:
+    enum Mode { READ_AHEAD, PREFETCH, MAP };
+    // READ_AHEAD: next() reads the next capacity bytes at once
+    // PREFETCH:   a thread reads the next chunk while you parse this one
+    // MAP:        the whole file is mapped, and next() returns all of it
+    struct Span { const char *data; size_t size; };
+
+    BufferedFile(const std::string &name, Mode mode = READ_AHEAD, size_t capacity = 1 << 20)
+        : mode(mode), capacity(capacity), front(capacity), map(nullptr), size(0),
+          mapped(false), ready(false), stop(false), failed(false), chunk{nullptr, 0}, pos(0) {
+        fd = open(name.c_str(), O_RDONLY);
+        if (fd < 0) throw fileError();
+        if (mode == MAP) {
+            struct stat st;
+            if (fstat(fd, &st) < 0) { close(fd); throw fileError(); }
+            size = size_t(st.st_size);
+            if (size > 0) {
+                map = static_cast<char *>(mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0));
+                if (map == MAP_FAILED) { close(fd); throw fileError(); }
+                madvise(map, size, MADV_SEQUENTIAL);
+            }
+        } else if (mode == PREFETCH) {
+            back.resize(capacity);
+            worker = std::thread(&BufferedFile::prefetch, this);
+        }
+    }
+    ~BufferedFile() {
+        if (worker.joinable()) {
+            { std::lock_guard<std::mutex> lock(m); stop = true; }
+            changed.notify_all();
+            worker.join();
+        }
+        if (map) munmap(map, size);
+        close(fd);
+    }
+    BufferedFile(const BufferedFile &) = delete;            // One owner of fd
+    BufferedFile &operator=(const BufferedFile &) = delete;
+
+    Span next() {   // The next chunk, valid until the next call; empty at the end
+        if (mode == MAP) {
+            if (mapped) return Span{nullptr, 0};
+            mapped = true;
+            return Span{map, size};
+        }
+        if (mode == READ_AHEAD) {
+            ssize_t got = fill(front.data());
+            if (got < 0) throw fileError();
+            return Span{front.data(), size_t(got)};
+        }
+        std::unique_lock<std::mutex> lock(m);
+        changed.wait(lock, [this] { return ready; });
+        if (failed) throw fileError();
+        if (size == 0) return Span{nullptr, 0};    // Worker done; stays ready
+        front.swap(back);             // Hand the finished buffer back to the
+        size_t got = size;              // worker, which fills it meanwhile
+        ready = false;
+        lock.unlock();
+        changed.notify_all();
+        return Span{front.data(), got};
+    }
+
+    bool nextLine(Span &line) { // The next line, without '\n'; false at the end
+        carry.clear();
+        while (true) {
+            if (pos == chunk.size) {
+                chunk = next();
+                pos = 0;
+                if (chunk.size == 0) {  // A last line with no '\n'
+                    line = Span{carry.data(), carry.size()};
+                    return !carry.empty();
+                }
+            }
+            const char *start = chunk.data + pos;
+            const char *eol = static_cast<const char *>(memchr(start, '\n', chunk.size - pos));
+            if (!eol) {                 // Straddles two chunks: only these lines
+                carry.append(start, chunk.size - pos);  // are copied
+                pos = chunk.size;
+                continue;
+            }
+            pos = size_t(eol - chunk.data) + 1;
+            if (carry.empty()) line = Span{start, size_t(eol - start)};
+            else { carry.append(start, eol); line = Span{carry.data(), carry.size()}; }
+            return true;
+        }
+    }
+
+private:
+    int fd;
+    Mode mode;
+    size_t capacity;
+    std::vector<char> front, back;      // Being parsed, being prefetched
+    char *map;
+    size_t size;                        // Mapped bytes, or bytes in back
+    bool mapped, ready, stop, failed;
+    std::thread worker;
+    std::mutex m;
+    std::condition_variable changed;
+    Span chunk;                         // Where nextLine() is
+    size_t pos;
+    std::string carry;
+
+    ssize_t fill(char *buffer) {        // Up to capacity bytes, short only at the end
+        size_t got = 0;
+        while (got < capacity) {
+            ssize_t n = read(fd, buffer + got, capacity - got);
+            if (n < 0) return -1;
+            if (n == 0) break;
+            got += size_t(n);
+        }
+        return ssize_t(got);
+    }
+    void prefetch() {
+        while (true) {
+            std::unique_lock<std::mutex> lock(m);
+            changed.wait(lock, [this] { return !ready || stop; });
+            if (stop) return;
+            lock.unlock();
+            ssize_t got = fill(back.data());    // back is ours until ready
+            lock.lock();
+            failed = got < 0;
+            size = got < 0 ? 0 : size_t(got);
+            ready = true;
+            lock.unlock();
+            changed.notify_all();
+            if (got <= 0) return;               // End or error: next() sees it
+        }
+    }
+};
@@ -0,0 +1,23 @@
+#include <iostream>
+#include <string>
+using namespace std;
+#include "buffered_file.h"
+int main(int argc, char *argv[]) {     // lines FILE [ahead|prefetch|map]
+    if (argc < 2) { cout << "Usage: lines FILE [ahead|prefetch|map]" << endl; return 1; }
+    string how = argc > 2 ? argv[2] : "ahead";
+    BufferedFile::Mode mode = how == "map" ? BufferedFile::MAP
+                            : how == "prefetch" ? BufferedFile::PREFETCH : BufferedFile::READ_AHEAD;
+    try {
+        BufferedFile f(argv[1], mode);  // Closed on every way out of the block
+        BufferedFile::Span line;
+        size_t lines = 0, longest = 0;
+        while (f.nextLine(line)) {
+            lines++;
+            if (line.size > longest) longest = line.size;
+        }
+        cout << lines << " lines, the longest of " << longest << " chars" << endl;
+    } catch (fileError) {
+        cout << "Cannot read " << argv[1] << endl;
+        return 1;
+    }
+}
\ No newline at end of file
@@ -34,3 +34,5 @@ public:
         std::cout << "Height = " << *height << std::endl;
     }
 };
+
+#endif
@@ -0,0 +1,124 @@
+#ifndef VALUE_BOX_H
+#define VALUE_BOX_H
+
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+#include <vector>
+
+// Box from box.h with its sides held by value: no new, no delete, and the
+// copy the compiler writes copies the sides, so there is nothing to free
+// twice. The rule of zero: copy, move and destructor are all defaulted.
+class ValueBox {
+private:
+    int length;
+    int width;
+    int height;
+
+public:
+    ValueBox(int l = 10, int w = 20, int h = 30)
+        : length(l), width(w), height(h) {}
+
+    void set(int l, int w, int h) {
+        length = l;
+        width  = w;
+        height = h;
+    }
+
+    int getLength() const { return length; }
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+
+    long long volume() const {
+        return (long long)length * width * height;
+    }
+
+    bool fitsIn(const ValueBox &container) const {
+        // Turned so its sides go shortest to longest in both boxes
+        int mine[3] = {length, width, height};
+        int theirs[3] = {container.length, container.width, container.height};
+        std::sort(mine, mine + 3);
+        std::sort(theirs, theirs + 3);
+        return mine[0] <= theirs[0] && mine[1] <= theirs[1] && mine[2] <= theirs[2];
+    }
+
+    void show() const {
+        std::cout << "Length = " << length << std::endl;
+        std::cout << "Width  = " << width  << std::endl;
+        std::cout << "Height = " << height << std::endl;
+    }
+};
+
+// Many boxes stored as one array per side (structure of arrays), so a
+// query over all of them is a loop over plain int arrays that the compiler
+// vectorizes at -O3.
+class BoxArray {
+private:
+    std::vector<int> lengths;
+    std::vector<int> widths;
+    std::vector<int> heights;
+
+public:
+    size_t size() const { return lengths.size(); }
+
+    void reserve(size_t n) {
+        lengths.reserve(n);
+        widths.reserve(n);
+        heights.reserve(n);
+    }
+
+    void push_back(const ValueBox &box) {
+        lengths.push_back(box.getLength());
+        widths.push_back(box.getWidth());
+        heights.push_back(box.getHeight());
+    }
+
+    ValueBox operator[](size_t i) const {
+        return ValueBox(lengths[i], widths[i], heights[i]);
+    }
+
+    void set(size_t i, const ValueBox &box) {
+        lengths[i] = box.getLength();
+        widths[i]  = box.getWidth();
+        heights[i] = box.getHeight();
+    }
+
+    void volumes(long long *out) const {
+        // out[i] = the volume of box i, for every i < size()
+        const int *l = lengths.data(), *w = widths.data(), *h = heights.data();
+        for (size_t i = 0; i < size(); i++) {
+            out[i] = (long long)l[i] * w[i] * h[i];
+        }
+    }
+
+    long long totalVolume() const {
+        const int *l = lengths.data(), *w = widths.data(), *h = heights.data();
+        long long total = 0;
+        for (size_t i = 0; i < size(); i++) {
+            total += (long long)l[i] * w[i] * h[i];
+        }
+        return total;
+    }
+
+    size_t fits(const ValueBox &container, unsigned char *out) const {
+        // out[i] = 1 if box i fitsIn(container), 0 if not; returns how many fit.
+        // The three sides are sorted by min and max rather than by
+        // branches, which keeps the loop vectorizable
+        int c[3] = {container.getLength(), container.getWidth(), container.getHeight()};
+        std::sort(c, c + 3);
+        const int *l = lengths.data(), *w = widths.data(), *h = heights.data();
+        size_t count = 0;
+        for (size_t i = 0; i < size(); i++) {
+            int a = std::min(l[i], w[i]), b = std::max(l[i], w[i]);
+            int shortest = std::min(a, h[i]);
+            int middle = std::max(a, std::min(b, h[i]));
+            int longest = std::max(b, h[i]);
+            unsigned char fit = (shortest <= c[0]) & (middle <= c[1]) & (longest <= c[2]);
+            out[i] = fit;
+            count += fit;
+        }
+        return count;
+    }
+};
+
+#endif
@@ -0,0 +1,25 @@
+#include "value_box.h"
+#include <utility>
+int main() {
+    ValueBox box1;
+    box1.set(10, 20, 30);
+
+    ValueBox box2 = box1;   // the default copy constructor copies the sides
+    box2.set(1, 2, 3);      // so changing box2 leaves box1 alone
+    ValueBox box3 = std::move(box2);
+
+    std::cout << "show box1:" << std::endl;
+    box1.show();
+    std::cout << "show box3:" << std::endl;
+    box3.show();
+
+    BoxArray boxes;
+    boxes.push_back(box1);
+    boxes.push_back(box3);
+    boxes.push_back(ValueBox(40, 5, 25));
+    unsigned char fit[3];
+    std::cout << "total volume = " << boxes.totalVolume() << std::endl;
+    std::cout << boxes.fits(ValueBox(30, 25, 10), fit)
+              << " of 3 fit in a 30 x 25 x 10 box" << std::endl;
+    return 0;   // nothing to delete, nothing freed twice
+}
\ No newline at end of file
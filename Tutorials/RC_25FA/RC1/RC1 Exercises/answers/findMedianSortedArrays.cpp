@@ -1,21 +1,48 @@
 #include <iostream>
 #include <vector>
 #include <algorithm>
+#include <climits>
 #include <cstdio>
 
+// Binary search on how many of the smaller array go to the lower half: the
+// split is right once every element left of it is no greater than every
+// element right of it. O(log(min(m, n))) time, O(1) memory.
 double findMedianSortedArrays(int* nums1, int nums1Size, int* nums2, int nums2Size) {
-    int nums[nums1Size + nums2Size];
-    int ptr = 0, ptr1 = 0, ptr2 = 0;
-    while (1) {
-        if (ptr1 == nums1Size && ptr2 == nums2Size) break;
-        else if (ptr1 == nums1Size) nums[ptr++] = nums2[ptr2++];
-        else if (ptr2 == nums2Size) nums[ptr++] = nums1[ptr1++];
-        else if (nums1[ptr1] < nums2[ptr2]) nums[ptr++] = nums1[ptr1++];
-        else nums[ptr++] = nums2[ptr2++];
+    if (nums1Size > nums2Size) return findMedianSortedArrays(nums2, nums2Size, nums1, nums1Size);
+    int half = (nums1Size + nums2Size + 1) / 2;
+    int lo = 0, hi = nums1Size;
+    while (true) {
+        int i = lo + (hi - lo) / 2;  // from nums1
+        int j = half - i;            // from nums2
+        int left1 = i > 0 ? nums1[i - 1] : INT_MIN, right1 = i < nums1Size ? nums1[i] : INT_MAX;
+        int left2 = j > 0 ? nums2[j - 1] : INT_MIN, right2 = j < nums2Size ? nums2[j] : INT_MAX;
+        if (left1 > right2) hi = i - 1;
+        else if (left2 > right1) lo = i + 1;
+        else {
+            int left = std::max(left1, left2);
+            if ((nums1Size + nums2Size) % 2) return left;
+            // In double, so that the sum does not overflow
+            return ((double)left + std::min(right1, right2)) / 2;
+        }
     }
-    int totSize = nums1Size + nums2Size;
-    if (totSize % 2) return nums[totSize / 2];
-    else return (double)(nums[totSize / 2] + nums[totSize / 2 - 1]) / 2;
+}
+
+// The k-th smallest (from 0) of the elements of count sorted arrays, by a
+// binary search on the value: the answer is the least v with more than k
+// elements <= v, each count an upper_bound per array. O(count * log(size)
+// * 32) time and O(1) memory, whatever the number and sizes of the arrays,
+// so that percentiles over sorted shards need no merge.
+// REQUIRES: 0 <= k < the total size
+int kthSmallest(int* const* arrays, const int* sizes, int count, long long k) {
+    long long lo = INT_MIN, hi = INT_MAX;
+    while (lo < hi) {
+        long long mid = lo + (hi - lo) / 2;
+        long long below = 0;  // elements <= mid
+        for (int a = 0; a < count; ++a) below += std::upper_bound(arrays[a], arrays[a] + sizes[a], (int)mid) - arrays[a];
+        if (below > k) hi = mid;
+        else lo = mid + 1;
+    }
+    return (int)lo;
 }
 
 void test_median(int* n1, int s1, int* n2, int s2, double expected) {
@@ -43,5 +70,17 @@ int main() {
     int nums2_2[] = {3, 4};
     test_median(nums1_2, 2, nums2_2, 2, 2.50000);
 
+    // Example 3: one array empty, and values whose sum overflows an int
+    int nums1_3[] = {INT_MAX - 1, INT_MAX};
+    test_median(nums1_3, 2, nullptr, 0, 2147483646.5);
+
+    std::cout << "--- k-th smallest of many sorted arrays ---\n\n";
+    int a[] = {1, 4, 9}, b[] = {2, 2, 7, 10}, c[] = {-5};
+    int* shards[] = {a, b, c};
+    int sizes[] = {3, 4, 1};
+    std::cout << "Shards [1,4,9] [2,2,7,10] [-5], k = 0 to 7:";
+    for (int k = 0; k < 8; ++k) std::cout << " " << kthSmallest(shards, sizes, 3, k);
+    std::cout << "\n(Expected: -5 1 2 2 4 7 9 10)\n";
+
     return 0;
 }
\ No newline at end of file
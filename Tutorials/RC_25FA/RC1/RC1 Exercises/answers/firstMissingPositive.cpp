@@ -1,5 +1,7 @@
 #include <iostream>
 #include <algorithm>
+#include <cstdint>
+#include <cstdio>
 #include <vector>
 
 int firstMissingPositive (int* nums, int numsSize) {
@@ -15,6 +17,37 @@ int firstMissingPositive (int* nums, int numsSize) {
     return -1;
 }
 
+// The same answer for ints stored in binary in a file too large to load:
+// it is read front to back in chunks, and a bitmap marks which of a window of
+// candidates [lo, lo + windowBits) appear. The answer is in [1, N + 1], so
+// ceil((N + 1) / windowBits) passes at most, each with windowBits / 8 bytes;
+// a window of N + 1 bits answers in one pass with about N / 8 bytes.
+// Returns -1 if the file cannot be read.
+long long firstMissingPositiveStream(FILE* in, long long windowBits) {
+    const int CHUNK = 1 << 16;  // ints read at a time
+    if (fseek(in, 0, SEEK_END) != 0) return -1;
+    long long n = ftell(in) / (long long)sizeof(int);
+    std::vector<int> chunk(CHUNK);
+    std::vector<uint64_t> seen;
+    for (long long lo = 1; lo <= n + 1; lo += windowBits) {
+        long long hi = std::min(n + 1, lo + windowBits - 1);
+        seen.assign((hi - lo) / 64 + 1, 0);
+        rewind(in);
+        size_t got;
+        while ((got = fread(chunk.data(), sizeof(int), CHUNK, in)) > 0) {
+            for (size_t i = 0; i < got; i++) {
+                long long v = chunk[i];
+                if (v >= lo && v <= hi) seen[(v - lo) / 64] |= uint64_t(1) << ((v - lo) % 64);
+            }
+        }
+        if (ferror(in)) return -1;
+        for (long long v = lo; v <= hi; v++) {
+            if (!(seen[(v - lo) / 64] >> ((v - lo) % 64) & 1)) return v;
+        }
+    }
+    return n + 1;
+}
+
 // Helper function to print an array (for testing display)
 void printArray(int* arr, int size) {
     std::cout << "[";
@@ -31,7 +64,15 @@ void test_missing_positive(int* arr, int size, int expected) {
     std::cout << "Input: "; 
     printArray(original_vec.data(), size); 
     std::cout << "\n";
-    std::cout << "Output: " << result << " (Expected: " << expected << ")\n\n";
+    std::cout << "Output: " << result << " (Expected: " << expected << ")\n";
+
+    // Streamed from a file, in one pass and in windows of 2 candidates
+    FILE* file = tmpfile();
+    fwrite(original_vec.data(), sizeof(int), size, file);
+    long long streamed = firstMissingPositiveStream(file, size + 1);
+    long long windowed = firstMissingPositiveStream(file, 2);
+    fclose(file);
+    std::cout << "Streamed: " << streamed << ", in windows of 2: " << windowed << "\n\n";
 }
 
 int main() {
@@ -1,4 +1,5 @@
 #include "IntList.h"
+#include <algorithm>
 #include <iostream>
 using namespace std;
 
@@ -6,38 +7,105 @@ bool IntList::isEmpty() const {
     return first == nullptr;
 }
 
-IntList::IntList(): first(nullptr) {}
+int IntList::size() const { return length; }
 
-IntList::~IntList() { removeAll(); }
+IntList::IntList(): first(nullptr), last(nullptr), spare(nullptr), length(0) {}
+
+IntList::~IntList() { removeAll(); delete spare; }
 
 void IntList::removeAll() {
-     while(!isEmpty()) remove(); 
+    while (first) {
+        chunk *victim = first;
+        first = first->next;
+        delete victim;
+    }
+    last = nullptr;
+    length = 0;
+}
+
+chunk *IntList::newChunk(int at) {
+    chunk *cp = spare ? spare : new chunk;  // Reuse before allocating
+    spare = nullptr;
+    cp->next = nullptr;
+    cp->begin = cp->end = at;
+    return cp;
 }
 
 void IntList::insert(int v){
-    node *np = new node;      // Gaining Ownership
-    np->value = v;
-    np->next = first;         // Keep it in mind!
-    first = np;               // Also keep that in mind!
+    if (!first || first->begin == 0) {      // Front chunk full: a new one,
+        chunk *cp = newChunk(CHUNK_SIZE);   // filled from its end
+        cp->next = first;
+        if (!first) last = cp;
+        first = cp;
+    }
+    first->values[--first->begin] = v;
+    length++;
 }
+
+void IntList::append(int v) {
+    if (!last || last->end == CHUNK_SIZE) { // The tail pointer makes it O(1)
+        chunk *cp = newChunk(0);
+        if (last) last->next = cp;
+        else first = cp;
+        last = cp;
+    }
+    last->values[last->end++] = v;
+    length++;
+}
+
 int IntList::remove() {
     if (isEmpty()) throw listIsEmpty();
-    int result = first->value; // None empty, always possible
-    node *victim = first;      // Whay save to victim?
-    first = first->next;     
-    delete victim;             // Giving up ownership
-    return result;             // Value container
+    int result = first->values[first->begin++];
+    length--;
+    if (first->begin == first->end) {       // Chunk emptied
+        chunk *victim = first;
+        first = first->next;
+        if (!first) last = nullptr;
+        delete spare;
+        spare = victim;                     // Kept for the next insert
+    }
+    return result;
+}
+
+void IntList::splice(IntList &l) {
+    if (this == &l || l.isEmpty()) return;
+    if (isEmpty()) first = l.first;
+    else if (l.first->end - l.first->begin <= CHUNK_SIZE - last->end) {
+        chunk *cp = l.first;                // Fits in our last chunk: copied,
+        last->end = copy(cp->values + cp->begin, cp->values + cp->end,
+                         last->values + last->end) - last->values;
+        last->next = cp->next;              // so short splices stay packed
+        if (cp == l.last) l.last = last;
+        delete cp;
+    }
+    else last->next = l.first;
+    last = l.last;
+    length += l.length;
+    l.first = l.last = nullptr;             // l gave up ownership
+    l.length = 0;
+}
+
+void IntList::reverse() {
+    chunk *reversed = nullptr;
+    last = first;
+    while (first) {
+        chunk *cp = first;
+        first = first->next;
+        std::reverse(cp->values + cp->begin, cp->values + cp->end);
+        cp->next = reversed;
+        reversed = cp;
+    }
+    first = reversed;
 }
 
 IntList::IntList(const IntList &l)
-    : first (0) { 
+    : first(nullptr), last(nullptr), spare(nullptr), length(0) {
         copyList(l.first);
     }
 
-void IntList::copyList(node *list) {
-    if (!list) return; // Base case
-    copyList(list->next);
-    insert(list->value);
+void IntList::copyList(chunk *list) {
+    for (; list; list = list->next)        // In order, no recursion
+        for (int i = list->begin; i < list->end; i++) append(list->values[i]);
 }
 
 
@@ -50,11 +118,7 @@ IntList &IntList::operator= (const IntList &l) {
 }
 
 void IntList::print() const {
-    node *p = first;
-    while(p)
-    {
-        cout << p->value << " ";
-        p = p->next;
-    }
+    for (chunk *cp = first; cp; cp = cp->next)
+        for (int i = cp->begin; i < cp->end; i++) cout << cp->values[i] << " ";
     cout << endl;
 }
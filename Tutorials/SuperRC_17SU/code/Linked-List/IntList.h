@@ -1,13 +1,21 @@
 class listIsEmpty {}; // An exception class
-struct node{ node *next; int value; };
+const int CHUNK_SIZE = 64;
+struct chunk{ chunk *next; int begin, end; int values[CHUNK_SIZE]; }; // values[begin..end)
 class IntList {
-    node *first;
+    chunk *first, *last;
+    chunk *spare;               // last emptied chunk, reused by the next one
+    int length;
     void removeAll();
-    void copyList(node *list);
+    void copyList(chunk *list);
+    chunk *newChunk(int at);    // empty chunk with begin == end == at
 public:
     bool isEmpty() const;
+    int size() const;           // O(1), cached
     void insert(int v);   // inserts v into the front of the list
+    void append(int v);   // inserts v at the end of the list, O(1)
     int remove(); // Pops the first element
+    void splice(IntList &l);    // moves all of l to the end, O(1)
+    void reverse();             // reverses the list in place
     void print() const; // print the int list
     IntList();                  // default constructor
     IntList(const IntList& l);  // copy constructor
@@ -32,5 +32,18 @@ int main()
     s.remove();
     s.print();
 
+    IntList t;
+    cout << "Append 4 and 5 at the end of another list" << endl;
+    t.append(4);
+    t.append(5);
+    cout << "Splice it to the end of the first one" << endl;
+    s.splice(t);
+    s.print();
+    cout << "Size " << s.size() << ", and the other one is now empty: "
+         << t.isEmpty() << endl;
+    cout << "Reverse the list" << endl;
+    s.reverse();
+    s.print();
+
     return 0;
 }
@@ -2,6 +2,7 @@
 #include <cassert>
 #include "bigthing_t.h"
 #include "list_t.h"
+#include "pooled_list_t.h"
 using namespace std;
 
 int main(int argc, char *argv[])
@@ -35,5 +36,17 @@ int main(int argc, char *argv[])
 	delete d; // Must delete d!
     ll.print();
 
+    cout << "p makes and inserts 5, then 4 from new. p is" << endl;
+	PooledList p;
+	p.insert(p.make(BigThing(5)));
+	p.insert(new BigThing(4)); // deleted by p, like List would
+    p.print();
+
+    cout << "pp is a copy of p, remove the front of pp. pp is" << endl;
+	PooledList pp(p);
+	BigThing *e = pp.remove();
+	pp.destroy(e); // Must give e back to pp!
+    pp.print();
+
 	return 0;
 }
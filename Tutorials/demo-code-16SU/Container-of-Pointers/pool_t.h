@@ -0,0 +1,87 @@
+#ifndef POOL_T_H
+#define POOL_T_H
+#include <cstddef>
+#include <new>
+#include <vector>
+
+template <class T>
+class Pool
+{
+	// OVERVIEW: allocates objects of type T from slabs, each twice as
+	// large as the one before, instead of from the heap one by one. An
+	// object keeps its address until it is destroyed, and its slot then
+	// goes on a free list for the next object. Objects made one after the
+	// other sit next to each other in memory.
+	union slot
+	{
+		slot *next; // while free
+		alignas(T) unsigned char storage[sizeof(T)];
+	};
+
+	std::vector<slot *> slabs;
+	std::vector<size_t> sizes; // the number of slots of each slab
+	size_t used;               // the slots of the last slab ever used
+	slot *freed;               // the free list
+
+	static const size_t FIRST_SLAB = 64;
+
+	Pool(const Pool &);
+	Pool &operator=(const Pool &);
+	// not copyable
+
+public:
+	Pool(): used(0), freed(0) {}
+
+	~Pool()
+	// REQUIRES: every object made has been destroyed
+	{
+		for (size_t i = 0; i < slabs.size(); i++) delete[] slabs[i];
+	}
+
+	T *create(const T &v)
+	// EFFECTS: returns a new copy of v.
+	{
+		slot *s = freed;
+		if (s)
+		{
+			freed = s->next;
+		}
+		else
+		{
+			if (slabs.empty() || used == sizes.back())
+			{
+				size_t size = slabs.empty() ? FIRST_SLAB : 2 * sizes.back();
+				slabs.push_back(new slot[size]);
+				sizes.push_back(size);
+				used = 0;
+			}
+			s = &slabs.back()[used++];
+		}
+		return new (s->storage) T(v);
+	}
+
+	void destroy(T *p)
+	// REQUIRES: p was made by create and is not destroyed yet
+	// EFFECTS: destroys *p and frees its slot.
+	{
+		p->~T();
+		slot *s = reinterpret_cast<slot *>(p);
+		s->next = freed;
+		freed = s;
+	}
+
+	bool owns(const T *p) const
+	// EFFECTS: returns true if p points to a slot of this pool, in O(log n)
+	//          since there are as many slabs.
+	{
+		const unsigned char *q = reinterpret_cast<const unsigned char *>(p);
+		for (size_t i = 0; i < slabs.size(); i++)
+		{
+			const unsigned char *begin = slabs[i]->storage;
+			if (q >= begin && q < begin + sizes[i] * sizeof(slot)) return true;
+		}
+		return false;
+	}
+};
+
+#endif
@@ -0,0 +1,93 @@
+#include "pooled_list_t.h"
+#include <iostream>
+#include <vector>
+using namespace std;
+
+PooledList::PooledList(): first(0)
+{
+}
+
+bool PooledList::isEmpty() const
+{
+	return (!first);
+}
+
+BigThing *PooledList::make(const BigThing &v)
+{
+	return things.create(v);
+}
+
+void PooledList::insert(BigThing *v)
+{
+	pnode np = {v, first};
+	first = nodes.create(np);
+}
+
+BigThing *PooledList::remove()
+{
+	if(isEmpty())
+	{
+		listIsEmpty e;
+		throw e;
+	}
+
+	pnode *victim = first;
+	BigThing *result = victim->value;
+	first = victim->next;
+	nodes.destroy(victim);
+	return result;
+}
+
+void PooledList::destroy(BigThing *v)
+{
+	if(things.owns(v)) things.destroy(v);
+	else delete v;
+}
+
+void PooledList::print() const
+{
+	pnode *cur = first;
+	while(cur)
+	{
+		cur->value->print();
+		cur = cur->next;
+	}
+	cout << endl;
+}
+
+void PooledList::copyList(const PooledList &l)
+{
+	// From the back, so that the copies are inserted in the same order,
+	// without the recursion of List::copyList
+	vector<BigThing *> values;
+	for(pnode *cur = l.first; cur; cur = cur->next) values.push_back(cur->value);
+	for(size_t i = values.size(); i-- > 0;) insert(make(*values[i]));
+}
+
+void PooledList::removeAll()
+{
+	while(!isEmpty())
+	{
+		destroy(remove());
+	}
+}
+
+PooledList::~PooledList()
+{
+	removeAll();
+}
+
+PooledList::PooledList(const PooledList &l): first(0)
+{
+	copyList(l);
+}
+
+PooledList& PooledList::operator=(const PooledList &l)
+{
+	if(this != &l)
+	{
+		removeAll();
+		copyList(l);
+	}
+	return *this;
+}
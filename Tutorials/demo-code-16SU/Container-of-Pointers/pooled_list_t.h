@@ -0,0 +1,49 @@
+#ifndef POOLED_LIST_T_H
+#define POOLED_LIST_T_H
+#include "bigthing_t.h"
+#include "list_t.h"
+#include "pool_t.h"
+
+class PooledList
+{
+	// OVERVIEW: a List of BigThing pointers whose nodes, and the BigThings
+	// it makes, come from pools instead of new. Callers still insert and
+	// remove BigThing pointers: ones from make(), which stay valid until
+	// given to destroy(), or ones from new, which the list deletes as
+	// List does.
+	struct pnode
+	{
+		BigThing *value;
+		pnode *next;
+	};
+
+	pnode *first;
+	Pool<pnode> nodes;
+	Pool<BigThing> things;
+
+	void removeAll();
+	void copyList(const PooledList &l);
+
+public:
+	bool isEmpty() const;
+	BigThing *make(const BigThing &v);
+	// EFFECTS: returns a copy of v in the pool of this list, to insert
+	//          into it.
+	void insert(BigThing *v);
+	// REQUIRES: v is from make() of this list, or from new
+	BigThing *remove();
+	// EFFECTS: removes the front and returns it, which the caller gives to
+	//          destroy() when done with it;
+	//          throws listIsEmpty if empty.
+	void destroy(BigThing *v);
+	// REQUIRES: v is from make() of this list, or from new
+	// EFFECTS: frees v, in the pool or with delete.
+	void print() const;
+
+	PooledList();
+	PooledList(const PooledList &l);
+	PooledList &operator=(const PooledList &l);
+	~PooledList();
+};
+
+#endif
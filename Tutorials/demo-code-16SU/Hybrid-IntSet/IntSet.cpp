@@ -0,0 +1,417 @@
+#include "IntSet.h"
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+
+using namespace std;
+
+// Memory per element of the two representations, in bits: 32 in the array,
+// span / numElts in the bitset. A sparse set becomes dense when the bitset
+// would take at most half the memory, and goes back at twice the memory.
+const long long TO_DENSE = 16;
+const long long TO_SPARSE = 64;
+
+static long long floor64(long long v)
+// EFFECTS: returns the greatest multiple of 64 not above v.
+{
+    return v >= 0 ? v / 64 * 64 : -((-v + 63) / 64 * 64);
+}
+
+IntSet::IntSet(): dense(false), base(0), numElts(0)
+{
+}
+
+long long IntSet::span() const
+{
+    if (dense) return (long long)words.size() * 64;
+    if (elts.empty()) return 0;
+    return (long long)elts.back() - elts.front() + 1;
+}
+
+void IntSet::toDense(long long lo, long long hi)
+{
+    base = floor64(lo);
+    words.assign((hi - base) / 64 + 1, 0);
+    for (size_t i = 0; i < elts.size(); i++)
+    {
+        long long bit = elts[i] - base;
+        words[bit / 64] |= uint64_t(1) << (bit % 64);
+    }
+    elts.clear();
+    elts.shrink_to_fit();
+    dense = true;
+}
+
+void IntSet::toSparse()
+{
+    elts = sorted();
+    words.clear();
+    words.shrink_to_fit();
+    dense = false;
+}
+
+void IntSet::cover(long long lo, long long hi)
+{
+    if (words.empty())
+    {
+        base = floor64(lo);
+        words.assign((hi - base) / 64 + 1, 0);
+        return;
+    }
+    long long first = min(floor64(lo), base);
+    long long last = max(hi, base + (long long)words.size() * 64 - 1);
+    if (first < base) words.insert(words.begin(), (base - first) / 64, 0);
+    base = first;
+    words.resize((last - base) / 64 + 1, 0);
+}
+
+void IntSet::trim()
+{
+    size_t end = words.size();
+    while (end > 0 && words[end - 1] == 0) end--;
+    size_t begin = 0;
+    while (begin < end && words[begin] == 0) begin++;
+    words.erase(words.begin() + end, words.end());
+    words.erase(words.begin(), words.begin() + begin);
+    base += (long long)begin * 64;
+}
+
+void IntSet::recount()
+{
+    int count = 0;
+    for (size_t i = 0; i < words.size(); i++)
+    {
+        count += __builtin_popcountll(words[i]);
+    }
+    numElts = count;
+}
+
+void IntSet::rebalance()
+{
+    if (dense)
+    {
+        trim();
+        if (numElts == 0 || span() > TO_SPARSE * numElts) toSparse();
+    }
+    else if (numElts > 0 && span() <= TO_DENSE * numElts)
+    {
+        toDense(elts.front(), elts.back());
+    }
+}
+
+vector<int> IntSet::sorted() const
+{
+    if (!dense) return elts;
+    vector<int> result;
+    result.reserve(numElts);
+    for (size_t i = 0; i < words.size(); i++)
+    {
+        for (uint64_t w = words[i]; w != 0; w &= w - 1)
+        {
+            result.push_back((int)(base + (long long)i * 64 + __builtin_ctzll(w)));
+        }
+    }
+    return result;
+}
+
+bool IntSet::has(int v) const
+{
+    if (!dense) return binary_search(elts.begin(), elts.end(), v);
+    long long bit = v - base;
+    if (bit < 0 || bit >= (long long)words.size() * 64) return false;
+    return (words[bit / 64] >> (bit % 64)) & 1;
+}
+
+void IntSet::bounds(long long &lo, long long &hi) const
+{
+    if (dense)
+    {
+        lo = base;
+        hi = base + (long long)words.size() * 64 - 1;
+    }
+    else
+    {
+        lo = elts.front();
+        hi = elts.back();
+    }
+}
+
+void IntSet::insert(int v)
+{
+    if (dense && !has(v))
+    {
+        long long lo, hi;
+        bounds(lo, hi);
+        // A value far outside the bitset would only grow it with zeros
+        if (max<long long>(hi, v) - min<long long>(lo, v) + 1 > TO_SPARSE * (numElts + 1)) toSparse();
+    }
+    if (dense)
+    {
+        cover(v, v);
+        long long bit = v - base;
+        uint64_t mask = uint64_t(1) << (bit % 64);
+        if (!(words[bit / 64] & mask))
+        {
+            words[bit / 64] |= mask;
+            numElts++;
+        }
+    }
+    else
+    {
+        vector<int>::iterator it = lower_bound(elts.begin(), elts.end(), v);
+        if (it != elts.end() && *it == v) return;
+        elts.insert(it, v);
+        numElts++;
+    }
+    rebalance();
+}
+
+void IntSet::insert(int lo, int hi)
+{
+    if (lo >= hi) return;
+    long long count = (long long)hi - lo;
+    long long first = lo, last = hi - 1;
+    if (numElts > 0)
+    {
+        long long l, h;
+        bounds(l, h);
+        first = min(first, l);
+        last = max(last, h);
+    }
+    if (last - first + 1 > (dense ? TO_SPARSE : TO_DENSE) * (numElts + count))
+    {
+        // Too spread out even with the range: merged as arrays
+        if (dense) toSparse();
+        vector<int> range(count), merged;
+        for (long long i = 0; i < count; i++) range[i] = (int)(lo + i);
+        set_union(elts.begin(), elts.end(), range.begin(), range.end(), back_inserter(merged));
+        elts.swap(merged);
+        numElts = (int)elts.size();
+        return;
+    }
+    if (dense) cover(lo, hi - 1);
+    else toDense(first, last);
+    // Whole words between partial ones at either end
+    long long from = lo - base, to = hi - base;
+    while (from < to && from % 64 != 0)
+    {
+        words[from / 64] |= uint64_t(1) << (from % 64);
+        from++;
+    }
+    while (to > from && to % 64 != 0)
+    {
+        to--;
+        words[to / 64] |= uint64_t(1) << (to % 64);
+    }
+    fill(words.begin() + from / 64, words.begin() + to / 64, ~uint64_t(0));
+    recount();
+}
+
+void IntSet::remove(int v)
+{
+    if (!has(v)) return;
+    if (dense)
+    {
+        long long bit = v - base;
+        words[bit / 64] &= ~(uint64_t(1) << (bit % 64));
+    }
+    else
+    {
+        elts.erase(lower_bound(elts.begin(), elts.end(), v));
+    }
+    numElts--;
+    rebalance();
+}
+
+bool IntSet::query(int v)
+{
+    return has(v);
+}
+
+int IntSet::size()
+{
+    return numElts;
+}
+
+bool IntSet::isDense()
+{
+    return dense;
+}
+
+void IntSet::print()
+{
+    vector<int> values = sorted();
+    for (size_t i = 0; i < values.size(); i++)
+    {
+        cout << values[i] << " ";
+    }
+    cout << endl;
+}
+
+IntSet &IntSet::operator|=(const IntSet &s)
+{
+    if (&s == this) return *this;
+    if (s.numElts == 0) return *this;
+    if (numElts == 0) return *this = s;
+    long long lo, hi, sLo, sHi;
+    bounds(lo, hi);
+    s.bounds(sLo, sHi);
+    lo = min(lo, sLo);
+    hi = max(hi, sHi);
+    if (hi - lo + 1 > TO_SPARSE * ((long long)numElts + s.numElts))
+    {
+        // Too spread out for a bitset: merged as arrays
+        if (dense) toSparse();
+        vector<int> copy;
+        if (s.dense) copy = s.sorted();
+        const vector<int> &other = s.dense ? copy : s.elts;
+        vector<int> merged;
+        merged.reserve(elts.size() + other.size());
+        set_union(elts.begin(), elts.end(), other.begin(), other.end(), back_inserter(merged));
+        elts.swap(merged);
+        numElts = (int)elts.size();
+    }
+    else
+    {
+        if (dense) cover(lo, hi);
+        else toDense(lo, hi);
+        if (s.dense)
+        {
+            uint64_t *to = words.data() + (s.base - base) / 64;
+            const uint64_t *from = s.words.data();
+            for (size_t i = 0; i < s.words.size(); i++)
+            {
+                to[i] |= from[i];
+            }
+        }
+        else
+        {
+            for (size_t i = 0; i < s.elts.size(); i++)
+            {
+                long long bit = s.elts[i] - base;
+                words[bit / 64] |= uint64_t(1) << (bit % 64);
+            }
+        }
+        recount();
+    }
+    rebalance();
+    return *this;
+}
+
+IntSet &IntSet::operator&=(const IntSet &s)
+{
+    if (&s == this) return *this;
+    if (dense && s.dense)
+    {
+        // Only the words in both ranges may stay set
+        long long lo = max(base, s.base);
+        long long hi = min(base + (long long)words.size() * 64, s.base + (long long)s.words.size() * 64);
+        if (lo >= hi)
+        {
+            words.clear();
+        }
+        else
+        {
+            words.erase(words.begin() + (hi - base) / 64, words.end());
+            words.erase(words.begin(), words.begin() + (lo - base) / 64);
+            base = lo;
+            uint64_t *to = words.data();
+            const uint64_t *from = s.words.data() + (lo - s.base) / 64;
+            for (size_t i = 0; i < words.size(); i++)
+            {
+                to[i] &= from[i];
+            }
+        }
+        recount();
+    }
+    else if (!dense && !s.dense)
+    {
+        vector<int> kept;
+        set_intersection(elts.begin(), elts.end(), s.elts.begin(), s.elts.end(), back_inserter(kept));
+        elts.swap(kept);
+        numElts = (int)elts.size();
+    }
+    else
+    {
+        // The elements of the sparse one that the other has, which is sparse
+        const IntSet &sparse = dense ? s : *this;
+        const IntSet &other = dense ? *this : s;
+        vector<int> kept;
+        for (size_t i = 0; i < sparse.elts.size(); i++)
+        {
+            if (other.has(sparse.elts[i])) kept.push_back(sparse.elts[i]);
+        }
+        words.clear();
+        dense = false;
+        elts.swap(kept);
+        numElts = (int)elts.size();
+    }
+    rebalance();
+    return *this;
+}
+
+IntSet &IntSet::operator-=(const IntSet &s)
+{
+    if (&s == this) return *this = IntSet();
+    if (dense && s.dense)
+    {
+        long long lo = max(base, s.base);
+        long long hi = min(base + (long long)words.size() * 64, s.base + (long long)s.words.size() * 64);
+        if (lo < hi)
+        {
+            uint64_t *to = words.data() + (lo - base) / 64;
+            const uint64_t *from = s.words.data() + (lo - s.base) / 64;
+            for (long long i = 0; i < (hi - lo) / 64; i++)
+            {
+                to[i] &= ~from[i];
+            }
+        }
+        recount();
+    }
+    else if (dense)
+    {
+        for (size_t i = 0; i < s.elts.size(); i++)
+        {
+            long long bit = s.elts[i] - base;
+            if (bit >= 0 && bit < (long long)words.size() * 64)
+            {
+                words[bit / 64] &= ~(uint64_t(1) << (bit % 64));
+            }
+        }
+        recount();
+    }
+    else if (!s.dense)
+    {
+        vector<int> kept;
+        set_difference(elts.begin(), elts.end(), s.elts.begin(), s.elts.end(), back_inserter(kept));
+        elts.swap(kept);
+        numElts = (int)elts.size();
+    }
+    else
+    {
+        vector<int> kept;
+        for (size_t i = 0; i < elts.size(); i++)
+        {
+            if (!s.has(elts[i])) kept.push_back(elts[i]);
+        }
+        elts.swap(kept);
+        numElts = (int)elts.size();
+    }
+    rebalance();
+    return *this;
+}
+
+IntSet operator|(IntSet a, const IntSet &b)
+{
+    return a |= b;
+}
+
+IntSet operator&(IntSet a, const IntSet &b)
+{
+    return a &= b;
+}
+
+IntSet operator-(IntSet a, const IntSet &b)
+{
+    return a -= b;
+}
@@ -0,0 +1,108 @@
+#ifndef INTSET_H
+#define INTSET_H
+
+#include <cstdint>
+#include <vector>
+
+class IntSet
+{
+// OVERVIEW: a mutable set of integers of any size, stored as a sorted
+//           array while it is sparse, and as a bitset over the range it
+//           spans once that takes less memory. The set operations work a
+//           64-bit word at a time on two bitsets, and merge two arrays.
+    bool dense;                  // which of the representations is used
+    std::vector<int> elts;       // sparse: the elements, sorted
+    long long base;              // dense: the value of the first bit, a multiple of 64
+    std::vector<uint64_t> words; // dense: the bits, from base
+    int numElts;                 // current occupancy
+
+    long long span() const;
+    // EFFECTS: returns the number of values from the least element to
+    //          the greatest, or from base to the end of words if dense.
+
+    void toDense(long long lo, long long hi);
+    // REQUIRES: lo and hi bound the elements, lo <= hi
+    // MODIFIES: this
+    // EFFECTS: makes this dense, with words covering lo to hi.
+
+    void toSparse();
+    // MODIFIES: this
+    // EFFECTS: makes this sparse.
+
+    void cover(long long lo, long long hi);
+    // REQUIRES: dense, lo <= hi
+    // MODIFIES: this
+    // EFFECTS: extends words to cover lo to hi.
+
+    void trim();
+    // REQUIRES: dense
+    // MODIFIES: this
+    // EFFECTS: drops the zero words at both ends of words.
+
+    void recount();
+    // REQUIRES: dense
+    // MODIFIES: this
+    // EFFECTS: sets numElts to the number of bits set.
+
+    void rebalance();
+    // MODIFIES: this
+    // EFFECTS: switches the representation if the other one is now much
+    //          smaller. The thresholds differ by 4 times either way, so
+    //          that a set near one does not switch back and forth.
+
+    void bounds(long long &lo, long long &hi) const;
+    // REQUIRES: this is not empty
+    // MODIFIES: lo, hi
+    // EFFECTS: sets lo and hi to bound the elements: the least and the
+    //          greatest if sparse, the range of words if dense.
+
+    std::vector<int> sorted() const;
+    // EFFECTS: returns the elements, sorted.
+
+    bool has(int v) const;
+    // EFFECTS: returns true if v is in this, false otherwise.
+
+public:
+    IntSet();
+    // EFFECTS: default constructor. Creates an empty IntSet.
+
+    void insert(int v);
+    // MODIFIES: this
+    // EFFECTS: this = this + {v}.
+    void insert(int lo, int hi);
+    // MODIFIES: this
+    // EFFECTS: this = this + {lo, lo + 1, ..., hi - 1}.
+    void remove(int v);
+    // MODIFIES: this
+    // EFFECTS: this = this - {v} if v is in this
+    bool query(int v);
+    // EFFECTS: returns true if v is in this, false otherwise.
+    int  size();
+    // EFFECTS: returns |this|.
+    bool isDense();
+    // EFFECTS: returns true if this is stored as a bitset, false
+    //          otherwise.
+    void print();
+    // MODIFIES: cout
+    // EFFECTS: print out the integers contained in the set in
+    //          sequence.
+
+    IntSet &operator|=(const IntSet &s);
+    // MODIFIES: this
+    // EFFECTS: this = this union s.
+    IntSet &operator&=(const IntSet &s);
+    // MODIFIES: this
+    // EFFECTS: this = this intersection s.
+    IntSet &operator-=(const IntSet &s);
+    // MODIFIES: this
+    // EFFECTS: this = this - s.
+};
+
+IntSet operator|(IntSet a, const IntSet &b);
+// EFFECTS: returns a union b.
+IntSet operator&(IntSet a, const IntSet &b);
+// EFFECTS: returns a intersection b.
+IntSet operator-(IntSet a, const IntSet &b);
+// EFFECTS: returns a - b.
+
+#endif
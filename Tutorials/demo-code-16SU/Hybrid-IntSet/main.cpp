@@ -0,0 +1,74 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <iterator>
+#include <vector>
+#include "IntSet.h"
+
+using namespace std;
+
+static double since(chrono::steady_clock::time_point start)
+// EFFECTS: returns the milliseconds since start.
+{
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+int main()
+{
+    IntSet foo;
+    cout << "insert 7, 3, 4, 5, 7, 8" << endl;
+    foo.insert(7);
+    foo.insert(3);
+    foo.insert(4);
+    foo.insert(5);
+    foo.insert(7);
+    foo.insert(8);
+    foo.print();
+    cout << (foo.isDense() ? "dense" : "sparse") << endl;
+
+    cout << "insert 1000000" << endl;
+    foo.insert(1000000);
+    foo.print();
+    cout << (foo.isDense() ? "dense" : "sparse") << endl;
+
+    IntSet bar;
+    cout << "bar: insert 4 to 9" << endl;
+    bar.insert(4, 10);
+    bar.print();
+    cout << "foo | bar: ";
+    (foo | bar).print();
+    cout << "foo & bar: ";
+    (foo & bar).print();
+    cout << "foo - bar: ";
+    (foo - bar).print();
+
+    // Millions of IDs: every third one in a range, and a run across it,
+    // against the same operations on sorted arrays
+    const int N = 3000000;
+    IntSet thirds, run;
+    vector<int> thirdsArray, runArray;
+    for (int i = 0; i < N; i += 3)
+    {
+        thirds.insert(i);
+        thirdsArray.push_back(i);
+    }
+    run.insert(N / 2, N + N / 2);
+    for (int i = N / 2; i < N + N / 2; i++) runArray.push_back(i);
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    int sizes = (thirds | run).size() + (thirds & run).size() + (thirds - run).size();
+    double bitset = since(start);
+
+    start = chrono::steady_clock::now();
+    vector<int> u, in, d;
+    set_union(thirdsArray.begin(), thirdsArray.end(), runArray.begin(), runArray.end(), back_inserter(u));
+    set_intersection(thirdsArray.begin(), thirdsArray.end(), runArray.begin(), runArray.end(), back_inserter(in));
+    set_difference(thirdsArray.begin(), thirdsArray.end(), runArray.begin(), runArray.end(), back_inserter(d));
+    double arrays = since(start);
+
+    cout << "union, intersection, difference of " << thirds.size() << " and " << run.size() << " IDs: "
+         << sizes << " elements " << (sizes == (int)(u.size() + in.size() + d.size()) ? "(agree)" : "(DIFFER)")
+         << endl;
+    cout << "IntSet: " << bitset << " ms, sorted arrays: " << arrays << " ms" << endl;
+    return 0;
+}
@@ -0,0 +1,141 @@
+/*
+ * A benchmark of the IntSet variants of the demos: the unsorted array of
+ * IntSet, the sorted array of IntSet-efficiency, the array of a given
+ * capacity of Dynamic-IntSet and the array or bitset of Hybrid-IntSet.
+ * Each is built from empty, queried, and then runs removes, queries and
+ * inserts, at 10^2 to 10^7 elements; the report is in nanoseconds per
+ * operation, and bytes of memory per element once built.
+ *
+ * A variant is skipped at the sizes over its capacity, and from the size
+ * where building it would take more than the budget. The estimate scales
+ * the insert cost at the last size by how much it grew from the size
+ * before, or by the size itself after a single size.
+ *
+ * Usage: bench [budget in seconds = 2]
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <utility>
+#include "workloads.h"
+
+Result benchUnsorted(const Data &data, int queries);
+Result benchSorted(const Data &data, int queries);
+Result benchDynamic(const Data &data, int queries);
+Result benchHybrid(const Data &data, int queries);
+
+// new and delete keep the size of each block before it, to add up heapBytes
+static long long liveBytes = 0;
+static const size_t HEADER = 16;
+
+void *operator new(size_t size)
+{
+    char *block = static_cast<char *>(std::malloc(size + HEADER));
+    if (!block) throw std::bad_alloc();
+    *reinterpret_cast<size_t *>(block) = size;
+    liveBytes += size;
+    return block + HEADER;
+}
+
+void operator delete(void *p) noexcept
+{
+    if (!p) return;
+    char *block = static_cast<char *>(p) - HEADER;
+    liveBytes -= *reinterpret_cast<size_t *>(block);
+    std::free(block);
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete[](void *p) noexcept
+{
+    operator delete(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    operator delete(p);
+}
+
+void operator delete[](void *p, size_t) noexcept
+{
+    operator delete(p);
+}
+
+long long heapBytes()
+{
+    return liveBytes;
+}
+
+volatile int sink;
+
+struct Variant
+{
+    const char *name;
+    int capacity; // 0 for none
+    Result (*bench)(const Data &, int);
+};
+
+static Data makeData(int n, std::mt19937 &random)
+// EFFECTS: returns the keys and probes of a benchmark of n elements.
+{
+    Data data;
+    data.keys.resize(n);
+    for (int i = 0; i < n; i++) data.keys[i] = 4 * i + (int)(random() % 2);
+    for (int i = n - 1; i > 0; i--) std::swap(data.keys[i], data.keys[random() % (i + 1)]);
+    data.probes.resize(1 << 16);
+    for (size_t i = 0; i < data.probes.size(); i++) data.probes[i] = (int)(random() % (4ULL * n));
+    return data;
+}
+
+int main(int argc, char *argv[])
+{
+    double budget = argc > 1 ? std::atof(argv[1]) : 2;
+    const Variant variants[] = {
+        {"unsorted", 100, benchUnsorted},
+        {"sorted", 100, benchSorted},
+        {"dynamic", 0, benchDynamic},
+        {"hybrid", 0, benchHybrid},
+    };
+    const int VARIANTS = sizeof(variants) / sizeof(variants[0]);
+    // The insert cost of each variant at its last two sizes
+    double lastNs[VARIANTS] = {0}, beforeNs[VARIANTS] = {0};
+    int lastN[VARIANTS] = {0};
+
+    std::mt19937 random(1);
+    std::printf("%-9s %9s %11s %11s %11s %11s\n", "variant", "n", "insert ns", "query ns", "mixed ns", "bytes/elt");
+    for (int n = 100; n <= 10000000; n *= 10) {
+        Data data = makeData(n, random);
+        for (int v = 0; v < VARIANTS; v++) {
+            const Variant &variant = variants[v];
+            if (variant.capacity && n > variant.capacity) {
+                std::printf("%-9s %9d   over its capacity of %d\n", variant.name, n, variant.capacity);
+                continue;
+            }
+            double perInsert = 0;
+            if (beforeNs[v] > 0) perInsert = lastNs[v] * std::max(1.0, lastNs[v] / beforeNs[v]);
+            else if (lastN[v]) perInsert = lastNs[v] * ((double)n / lastN[v]);
+            double estimate = perInsert * 1e-9 * n;
+            if (estimate > budget) {
+                std::printf("%-9s %9d   skipped, about %.0f s to build\n", variant.name, n, estimate);
+                continue;
+            }
+            // As many queries as the budget allows, going by the inserts
+            int queries = 100000;
+            if (perInsert * queries * 4 > budget * 1e9) queries = std::max(1000, (int)(budget * 1e9 / perInsert / 4));
+            Result result = variant.bench(data, queries);
+            beforeNs[v] = lastNs[v];
+            lastNs[v] = result.insertNs;
+            lastN[v] = n;
+            std::printf("%-9s %9d %11.1f %11.1f %11.1f %11.2f\n", variant.name, n, result.insertNs,
+                        result.queryNs, result.mixedNs, (double)result.bytes / n);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,19 @@
+// The IntSet of ../Dynamic-IntSet, in a namespace of its own so that all the
+// variants link into one benchmark. The header it includes comes first,
+// outside the namespace.
+#include <iostream>
+#include "workloads.h"
+
+namespace dynamic {
+#include "../Dynamic-IntSet/IntSet.cpp"
+
+static IntSet *make(int n)
+{
+    return new IntSet(n);
+}
+}
+
+Result benchDynamic(const Data &data, int queries)
+{
+    return measure<dynamic::IntSet>(dynamic::make, data, queries);
+}
@@ -0,0 +1,24 @@
+// The IntSet of ../Hybrid-IntSet, in a namespace of its own so that all the
+// variants link into one benchmark. The headers it includes come first,
+// outside the namespace.
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <iterator>
+#include <vector>
+#include "workloads.h"
+
+namespace hybrid {
+#include "../Hybrid-IntSet/IntSet.cpp"
+
+static IntSet *make(int n)
+{
+    (void)n;
+    return new IntSet;
+}
+}
+
+Result benchHybrid(const Data &data, int queries)
+{
+    return measure<hybrid::IntSet>(hybrid::make, data, queries);
+}
@@ -0,0 +1,20 @@
+// The IntSet of ../IntSet-efficiency, in a namespace of its own so that all the
+// variants link into one benchmark. The header it includes comes first,
+// outside the namespace.
+#include <iostream>
+#include "workloads.h"
+
+namespace sorted {
+#include "../IntSet-efficiency/IntSet.cpp"
+
+static IntSet *make(int n)
+{
+    (void)n;
+    return new IntSet;
+}
+}
+
+Result benchSorted(const Data &data, int queries)
+{
+    return measure<sorted::IntSet>(sorted::make, data, queries);
+}
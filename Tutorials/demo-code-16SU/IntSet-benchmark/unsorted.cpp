@@ -0,0 +1,20 @@
+// The IntSet of ../IntSet, in a namespace of its own so that all the
+// variants link into one benchmark. The header it includes comes first,
+// outside the namespace.
+#include <iostream>
+#include "workloads.h"
+
+namespace unsorted {
+#include "../IntSet/IntSet.cpp"
+
+static IntSet *make(int n)
+{
+    (void)n;
+    return new IntSet;
+}
+}
+
+Result benchUnsorted(const Data &data, int queries)
+{
+    return measure<unsorted::IntSet>(unsorted::make, data, queries);
+}
@@ -0,0 +1,75 @@
+#ifndef WORKLOADS_H
+#define WORKLOADS_H
+
+#include <chrono>
+#include <vector>
+
+struct Data
+{
+    // OVERVIEW: the values a benchmark of n elements uses
+    std::vector<int> keys;   // n distinct values in random order, each 4i or 4i + 1
+    std::vector<int> probes; // random values from 0 to 4n, a quarter of them in the set
+};
+
+struct Result
+{
+    // OVERVIEW: the cost of the workloads on one set of n elements
+    double insertNs; // per insert, building the set from empty
+    double queryNs;  // per query, on the full set
+    double mixedNs;  // per operation of remove, query, insert again
+    long long bytes; // the set and the memory it allocated, when full
+};
+
+long long heapBytes();
+// EFFECTS: returns the number of bytes allocated by new and not deleted.
+
+extern volatile int sink;
+// The results of the queries go there, so that the compiler keeps them
+// EFFECTS: returns the number of bytes allocated by new and not deleted.
+
+static inline double nanoseconds(std::chrono::steady_clock::time_point start)
+// EFFECTS: returns the nanoseconds since start.
+{
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+template <class Set, class Make>
+Result measure(Make make, const Data &data, int queries)
+// REQUIRES: make(n) returns a new empty Set that holds n elements.
+// EFFECTS: runs the three workloads on a set of data.keys.size() elements,
+//          with queries queries and mixed operations.
+{
+    Result result;
+    int n = (int)data.keys.size();
+    long long before = heapBytes();
+    Set *set = make(n);
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int i = 0; i < n; i++) set->insert(data.keys[i]);
+    result.insertNs = nanoseconds(start) / n;
+    result.bytes = (long long)sizeof(Set) + heapBytes() - before;
+
+    int found = 0;
+    int probes = (int)data.probes.size();
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < queries; i++) found += set->query(data.probes[i % probes]);
+    result.queryNs = nanoseconds(start) / queries;
+
+    // Each key removed is in the set, and is inserted back right after
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < queries; i++)
+    {
+        int key = data.keys[i % n];
+        set->remove(key);
+        found += set->query(data.probes[i % probes]);
+        set->insert(key);
+    }
+    result.mixedNs = nanoseconds(start) / (3.0 * queries);
+
+    sink = found;
+    if (set->size() != n) result.bytes = -1;
+    delete set;
+    return result;
+}
+
+#endif
@@ -1,62 +1,155 @@
 #include "IntList.h"
+#include <algorithm>
 #include <iostream>
 using namespace std;
 
-bool IntList::isEmpty()
+bool IntList::isEmpty() const
 {
     return !first;
 }
 
+int IntList::size() const
+{
+    return length;
+}
+
+chunk *IntList::newChunk(int at)
+{
+    chunk *cp = spare ? spare : new chunk;
+    spare = 0;
+    cp->next = 0;
+    cp->begin = cp->end = at;
+    return cp;
+}
+
 void IntList::insert(int v)
 {
-    node *np = new node;
-    np->value = v;
-    np->next = first;
-    first = np;
+    // The front chunk fills from its end, so inserting at the front is O(1)
+    if (!first || first->begin == 0)
+    {
+        chunk *cp = newChunk(CHUNK_SIZE);
+        cp->next = first;
+        if (!first) last = cp;
+        first = cp;
+    }
+    first->values[--first->begin] = v;
+    length++;
 }
 
-int IntList::remove()
+void IntList::append(int v)
 {
-    node *victim = first;
-    int result;
+    if (!last || last->end == CHUNK_SIZE)
+    {
+        chunk *cp = newChunk(0);
+        if (last) last->next = cp;
+        else first = cp;
+        last = cp;
+    }
+    last->values[last->end++] = v;
+    length++;
+}
 
+int IntList::remove()
+{
     if (isEmpty())
     {
         listIsEmpty e;
         throw e;
     }
 
-    first = victim->next;
-    result = victim->value;
-    delete victim;
+    int result = first->values[first->begin++];
+    length--;
+    if (first->begin == first->end)
+    {
+        chunk *victim = first;
+        first = victim->next;
+        if (!first) last = 0;
+        delete spare;
+        spare = victim;
+    }
     return result;
 }
 
-IntList::IntList(): first(0)
+void IntList::splice(IntList &l)
+{
+    if (this == &l || l.isEmpty()) return;
+
+    if (isEmpty())
+    {
+        first = l.first;
+    }
+    else if (l.first->end - l.first->begin <= CHUNK_SIZE - last->end)
+    {
+        // The first chunk of l fits after our last one: copying it keeps
+        // repeated short splices from leaving a list of almost empty chunks
+        chunk *cp = l.first;
+        last->end = copy(cp->values + cp->begin, cp->values + cp->end,
+                         last->values + last->end) - last->values;
+        last->next = cp->next;
+        if (cp == l.last) l.last = last;
+        delete cp;
+    }
+    else
+    {
+        last->next = l.first;
+    }
+    last = l.last;
+    length += l.length;
+
+    l.first = l.last = 0;
+    l.length = 0;
+}
+
+void IntList::reverse()
+{
+    chunk *reversed = 0;
+    last = first;
+    while (first)
+    {
+        chunk *cp = first;
+        first = cp->next;
+        std::reverse(cp->values + cp->begin, cp->values + cp->end);
+        cp->next = reversed;
+        reversed = cp;
+    }
+    first = reversed;
+}
+
+IntList::IntList(): first(0), last(0), spare(0), length(0)
 {
 }
 
 void IntList::removeAll()
 {
-    while(!isEmpty())
+    while (first)
     {
-        remove();
+        chunk *victim = first;
+        first = victim->next;
+        delete victim;
     }
+    last = 0;
+    length = 0;
 }
 
 IntList::~IntList()
 {
     removeAll();
+    delete spare;
 }
 
-void IntList::copyList(node *list)
+void IntList::copyList(chunk *list)
 {
-    if (!list) return; // Base case
-    copyList(list->next);
-    insert(list->value);
+    // In order and chunk by chunk, so the copy is packed and does not recurse
+    for (; list; list = list->next)
+    {
+        for (int i = list->begin; i < list->end; i++)
+        {
+            append(list->values[i]);
+        }
+    }
 }
 
-IntList::IntList(const IntList &l): first (0)
+IntList::IntList(const IntList &l): first(0), last(0), spare(0), length(0)
 {
     copyList(l.first);
 }
@@ -71,13 +164,14 @@ IntList &IntList::operator= (const IntList &l)
     return *this;
 }
 
-void IntList::print()
+void IntList::print() const
 {
-    node *p = first;
-    while(p)
+    for (chunk *cp = first; cp; cp = cp->next)
     {
-        cout << p->value << " ";
-        p = p->next;
+        for (int i = cp->begin; i < cp->end; i++)
+        {
+            cout << cp->values[i] << " ";
+        }
     }
     cout << endl;
 }
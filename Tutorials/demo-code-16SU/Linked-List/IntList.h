@@ -3,30 +3,55 @@
 
 class listIsEmpty {}; // An exception class
 
-struct node
+const int CHUNK_SIZE = 64;
+
+struct chunk
+// A node holding up to CHUNK_SIZE consecutive elements of the list, in
+// values[begin], ..., values[end - 1]
 {
-    node *next;
-    int   value;
+    chunk *next;
+    int   begin;
+    int   end;
+    int   values[CHUNK_SIZE];
 };
 
 class IntList
 {
-    node *first;
+    chunk *first;
+    chunk *last;
+    chunk *spare;   // the last emptied chunk, kept for the next one needed
+    int   length;
     void removeAll();
-    void copyList(node *list);
+    void copyList(chunk *list);
+    chunk *newChunk(int at);
+    // EFFECTS: returns an empty chunk with begin == end == at
 
 public:
-    bool isEmpty();
+    bool isEmpty() const;
     // EFFECTS: returns true if list is empty, false otherwise
+    int size() const;
+    // EFFECTS: returns the number of elements, in O(1)
     void insert(int v);
     // MODIFIES: this
     // EFFECTS: inserts v into the front of the list
+    void append(int v);
+    // MODIFIES: this
+    // EFFECTS: inserts v at the end of the list, in O(1)
     int remove();
     // MODIFIES: this
     // EFFECTS: if list is empty, throw listIsEmpty.
-    //          Otherwise, remove and return the first 
+    //          Otherwise, remove and return the first
     //          element of the list
-    void print();
+    void splice(IntList &l);
+    // REQUIRES: l is not this list
+    // MODIFIES: this, l
+    // EFFECTS: moves the elements of l to the end of this list, in
+    //          order, and leaves l empty. Takes O(1): the chunks of l
+    //          are linked, not copied
+    void reverse();
+    // MODIFIES: this
+    // EFFECTS: reverses the order of the elements, in place
+    void print() const;
     // MODIFIES: cout
     // EFFECTS: print the int list
 
@@ -36,7 +61,7 @@ public:
     // copy constructor
     ~IntList();
     // destructor
-    IntList &operator=(const IntList &l); 
+    IntList &operator=(const IntList &l);
     // assignment operator
 };
 
@@ -4,6 +4,8 @@
 #include "string_t.h"
 #include "dyn_t.h"
 #include "list_t.h"
+#include "tagged_list_t.h"
+#include "segregated_list_t.h"
 using namespace std;
 
 int main(int argc, char *argv[])
@@ -35,6 +37,33 @@ int main(int argc, char *argv[])
 	delete d; // Must delete d!
 
     ll.print();
+
+    cout << "The same values in a TaggedList t, and tt as a copy of t" << endl;
+    TaggedList t;
+    t.insert(int_t(5));
+    t.insert(string_t("four"));
+    t.insert(dyn_t(4));
+    TaggedList tt = t;
+    tt.print();
+
+    cout << "Remove the front of tt" << endl;
+    dyn_t *e = dynamic_cast<dyn_t*>(tt.remove());
+    assert(e);
+    delete e;
+
+    tt.print();
+    t.print();
+
+    cout << "The same objects in a SegregatedList s, and the sum of its ints" << endl;
+    SegregatedList s;
+    s.insert(int_t(5));
+    s.insert(string_t("four"));
+    s.insert(dyn_t(4));
+    s.insert(int_t(3));
+    s.print();
+    int sum = 0;
+    s.eachInt([&sum](int_t &v) { sum += v.get_value(); });
+    cout << sum << endl;
     /*
 	List ll;
 	BigThing *b = new BigThing(4);
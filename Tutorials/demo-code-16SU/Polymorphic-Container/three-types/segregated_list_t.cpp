@@ -0,0 +1,101 @@
+#include "segregated_list_t.h"
+#include <iostream>
+using namespace std;
+
+SegregatedList::SegregatedList()
+{
+}
+
+SegregatedList::SegregatedList(const SegregatedList &l):
+	order(l.order), ints(l.ints), strings(l.strings), dyns(l.dyns)
+{
+}
+
+SegregatedList &SegregatedList::operator=(SegregatedList l)
+{
+	order.swap(l.order);
+	ints.swap(l.ints);
+	strings.swap(l.strings);
+	dyns.swap(l.dyns);
+	return *this;
+}
+
+SegregatedList::~SegregatedList()
+{
+}
+
+bool SegregatedList::isEmpty() const
+{
+	return order.empty();
+}
+
+void SegregatedList::print() const
+{
+	for (size_t i = order.size(); i-- > 0;)
+	{
+		const entry &e = order[i];
+		switch (e.type)
+		{
+		case INT:
+			ints[e.index].print();
+			break;
+		case STRING:
+			strings[e.index].print();
+			break;
+		case DYN:
+			dyns[e.index].print();
+			break;
+		}
+	}
+	cout << endl;
+}
+
+void SegregatedList::insert(const int_t &v)
+{
+	ints.push_back(v);
+	entry e = {INT, (int)ints.size() - 1};
+	order.push_back(e);
+}
+
+void SegregatedList::insert(const string_t &v)
+{
+	strings.push_back(v);
+	entry e = {STRING, (int)strings.size() - 1};
+	order.push_back(e);
+}
+
+void SegregatedList::insert(const dyn_t &v)
+{
+	dyns.push_back(v);
+	entry e = {DYN, (int)dyns.size() - 1};
+	order.push_back(e);
+}
+
+Object *SegregatedList::remove()
+{
+	if (isEmpty())
+	{
+		listIsEmpty e;
+		throw e;
+	}
+
+	// The front element is the last of its type
+	Object *result = 0;
+	switch (order.back().type)
+	{
+	case INT:
+		result = new int_t(ints.back());
+		ints.pop_back();
+		break;
+	case STRING:
+		result = new string_t(strings.back());
+		strings.pop_back();
+		break;
+	case DYN:
+		result = new dyn_t(dyns.back());
+		dyns.pop_back();
+		break;
+	}
+	order.pop_back();
+	return result;
+}
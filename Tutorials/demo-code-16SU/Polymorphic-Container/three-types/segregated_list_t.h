@@ -0,0 +1,73 @@
+#ifndef SEGREGATED_LIST_T_H
+#define SEGREGATED_LIST_T_H
+#include "object_t.h"
+#include "int_t.h"
+#include "string_t.h"
+#include "dyn_t.h"
+#include "list_t.h"
+#include <vector>
+
+class SegregatedList
+{
+	// OVERVIEW: a List of int_t, string_t and dyn_t objects, kept by value
+	// in one array per type, and an array of the order of the elements:
+	// each a type and an index in the array of that type. Elements are
+	// added and removed at the front, the back of the arrays.
+	// eachInt, eachString and eachDyn run a function over all the objects
+	// of one type, in a loop over one array with no virtual call, for the
+	// bulk operations that do not need the order.
+public:
+	bool isEmpty() const;
+	void print() const;
+	void insert(const int_t &v);
+	void insert(const string_t &v);
+	void insert(const dyn_t &v);
+	Object *remove();
+	// EFFECTS: removes the front element and returns a copy of it, which
+	//          the caller must delete, as List does;
+	//          throws listIsEmpty if empty.
+
+	template <class Fn>
+	void eachInt(Fn fn)
+	// EFFECTS: calls fn on each int_t, in no particular order.
+	{
+		for (size_t i = 0; i < ints.size(); i++) fn(ints[i]);
+	}
+
+	template <class Fn>
+	void eachString(Fn fn)
+	// EFFECTS: calls fn on each string_t, in no particular order.
+	{
+		for (size_t i = 0; i < strings.size(); i++) fn(strings[i]);
+	}
+
+	template <class Fn>
+	void eachDyn(Fn fn)
+	// EFFECTS: calls fn on each dyn_t, in no particular order.
+	{
+		for (size_t i = 0; i < dyns.size(); i++) fn(dyns[i]);
+	}
+
+	SegregatedList();
+	SegregatedList(const SegregatedList &l);
+	SegregatedList &operator=(SegregatedList l);
+	// dyn_t has no assignment operator of its own, so the arrays are
+	// assigned by swapping with a copy rather than element by element
+	~SegregatedList();
+
+private:
+	enum type_t { INT, STRING, DYN };
+
+	struct entry
+	{
+		type_t type;
+		int index;
+	};
+
+	std::vector<entry> order;
+	std::vector<int_t> ints;
+	std::vector<string_t> strings;
+	std::vector<dyn_t> dyns;
+};
+
+#endif
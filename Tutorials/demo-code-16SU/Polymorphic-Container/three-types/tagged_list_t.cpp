@@ -0,0 +1,71 @@
+#include "tagged_list_t.h"
+#include <iostream>
+using namespace std;
+
+bool TaggedList::isEmpty() const
+{
+	return items.empty();
+}
+
+void TaggedList::print() const
+{
+	for (size_t i = items.size(); i-- > 0;)
+	{
+		const item &it = items[i];
+		switch (it.tag)
+		{
+		case INT:
+		case DYN:
+			cout << it.value << " ";
+			break;
+		case STRING:
+			cout << strings[it.value] << " ";
+			break;
+		}
+	}
+	cout << endl;
+}
+
+void TaggedList::insert(int_t v)
+{
+	item it = {INT, v.get_value()};
+	items.push_back(it);
+}
+
+void TaggedList::insert(string_t v)
+{
+	strings.push_back(v.get_value());
+	item it = {STRING, (int)strings.size() - 1};
+	items.push_back(it);
+}
+
+void TaggedList::insert(dyn_t v)
+{
+	item it = {DYN, v.get_value()};
+	items.push_back(it);
+}
+
+Object *TaggedList::remove()
+{
+	if (isEmpty())
+	{
+		listIsEmpty e;
+		throw e;
+	}
+
+	item it = items.back();
+	items.pop_back();
+	switch (it.tag)
+	{
+	case INT:
+		return new int_t(it.value);
+	case DYN:
+		return new dyn_t(it.value);
+	case STRING:
+		break;
+	}
+	// The string of the front element is the last one
+	string_t *result = new string_t(strings.back());
+	strings.pop_back();
+	return result;
+}
@@ -0,0 +1,47 @@
+#ifndef TAGGED_LIST_T_H
+#define TAGGED_LIST_T_H
+#include "object_t.h"
+#include "int_t.h"
+#include "string_t.h"
+#include "dyn_t.h"
+#include "list_t.h"
+#include <string>
+#include <vector>
+
+class TaggedList
+{
+	// OVERVIEW: a List of the values of int_t, string_t and dyn_t objects,
+	// stored in place instead of as Object pointers. Each element is a tag
+	// and an int: the value itself, or the index of a string in strings.
+	// Elements are added and removed at the front, which is the back of the
+	// arrays, so both stay contiguous; a copy copies the two arrays, with
+	// no clone() and no allocation per element, and print() switches on the
+	// tag instead of calling a virtual function.
+public:
+	bool isEmpty() const;
+	void print() const;
+	void insert(int_t v);
+	void insert(string_t v);
+	void insert(dyn_t v);
+	Object *remove();
+	// EFFECTS: removes the front element and returns it as a new object
+	//          of its type, which the caller must delete, as List does;
+	//          throws listIsEmpty if empty.
+
+	// The implicit copy constructor, assignment and destructor copy and
+	// free the arrays.
+
+private:
+	enum tag_t { INT, STRING, DYN };
+
+	struct item
+	{
+		tag_t tag;
+		int value;
+	};
+
+	std::vector<item> items;
+	std::vector<std::string> strings;
+};
+
+#endif
@@ -1,22 +1,48 @@
 #ifndef LIST_H
 #define LIST_H
 #include <iostream>
+#include <new>
+#include <utility>
 using namespace std;
 
 class listIsEmpty
 {
 };
 
-template <class T>
+template <class T, int N = 4>
 class List
+// OVERVIEW: a singly linked list of T. The first N nodes live inside the
+//           List itself, and the next ones are allocated in blocks, so a
+//           short list never touches the heap and a long one allocates
+//           once per block rather than once per insert. Removed nodes are
+//           kept for the next inserts until the List is destroyed.
 {
 public:
     bool isEmpty();
-    void insert(T v);
+    void insert(const T &v);
+    void insert(T &&v);
+    // MODIFIES: this
+    // EFFECTS: inserts v at the front, moving it when it is an rvalue.
+
+    template <class... Args>
+    void emplace(Args&&... args);
+    // MODIFIES: this
+    // EFFECTS: inserts T(args...) at the front, built in place.
+
+    template <class It>
+    void insert(It begin, It end);
+    // MODIFIES: this
+    // EFFECTS: inserts the elements of [begin, end) at the front, in the
+    //          same order, so the list reads begin..end and then its old
+    //          elements. If copying one throws, the list is unchanged.
+
     T remove();
     void print();
 
     List();
+    template <class It>
+    List(It begin, It end);
+    // EFFECTS: makes a list of the elements of [begin, end), in order.
     List(const List &l);
     List &operator=(const List &l);
     ~List();
@@ -24,32 +50,135 @@ public:
 private:
     struct node
     {
-        T value;
         node* next;
+        alignas(T) unsigned char storage[sizeof(T)];
+        T *value() { return reinterpret_cast<T *>(storage); }
     };
 
+    static_assert(N > 0, "List needs at least one inline node");
+    static const int MAX_BLOCK = 256;
+
     node *first;
+    node *unused;   // unused nodes, inline ones and those of blocks
+    node *blocks;   // the allocated blocks; the first node of each block
+                    // only links to the previous one
+    int capacity;   // nodes inline and in blocks
+    node buffer[N];
+
+    node *allocate();
+    // EFFECTS: takes a node from unused, adding a block if it is empty.
+    void release(node *np);
+    // EFFECTS: gives np, whose value is destroyed, back to unused.
     void removeAll();
     void copyList(node *v);
 };
 
-template <class T>
-bool List<T>::isEmpty()
+template <class T, int N>
+bool List<T, N>::isEmpty()
 {
 	return (!first);
 }
 
-template <class T>
-void List<T>::insert(T v)
+template <class T, int N>
+typename List<T, N>::node *List<T, N>::allocate()
+{
+	if(!unused)
+	{
+		// Blocks grow with the list, up to MAX_BLOCK nodes
+		int count = capacity < MAX_BLOCK ? capacity : MAX_BLOCK;
+		node *block = new node[count + 1];
+		block->next = blocks;
+		blocks = block;
+		for(int i = count; i > 0; i--)
+			release(&block[i]);
+		capacity += count;
+	}
+
+	node *np = unused;
+	unused = np->next;
+	return np;
+}
+
+template <class T, int N>
+void List<T, N>::release(node *np)
 {
-	node *np = new node;
-	np->value = v;
+	np->next = unused;
+	unused = np;
+}
+
+template <class T, int N>
+template <class... Args>
+void List<T, N>::emplace(Args&&... args)
+{
+	node *np = allocate();
+	try
+	{
+		new (np->storage) T(std::forward<Args>(args)...);
+	}
+	catch(...)
+	{
+		release(np);
+		throw;
+	}
 	np->next = first;
 	first = np;
 }
 
-template <class T>
-T List<T>::remove()
+template <class T, int N>
+void List<T, N>::insert(const T &v)
+{
+	emplace(v);
+}
+
+template <class T, int N>
+void List<T, N>::insert(T &&v)
+{
+	emplace(std::move(v));
+}
+
+template <class T, int N>
+template <class It>
+void List<T, N>::insert(It begin, It end)
+{
+	// The new elements are linked in order, then spliced in front
+	node *head = 0;
+	node **tail = &head;
+	try
+	{
+		for(; begin != end; ++begin)
+		{
+			node *np = allocate();
+			try
+			{
+				new (np->storage) T(*begin);
+			}
+			catch(...)
+			{
+				release(np);
+				throw;
+			}
+			*tail = np;
+			tail = &np->next;
+		}
+	}
+	catch(...)
+	{
+		*tail = 0;
+		while(head)
+		{
+			node *np = head;
+			head = np->next;
+			np->value()->~T();
+			release(np);
+		}
+		throw;
+	}
+	*tail = first;
+	first = head;
+}
+
+template <class T, int N>
+T List<T, N>::remove()
 {
 	node *victim = first;
 	if(isEmpty())
@@ -57,59 +186,88 @@ T List<T>::remove()
 		listIsEmpty e;
 		throw e;
 	}
-	
-	T result = victim->value;
+
+	T result = std::move(*victim->value());
+	victim->value()->~T();
 	first = victim->next;
-	delete victim;
+	release(victim);
 	return result;
 }
 
-template <class T>
-void List<T>::print()
+template <class T, int N>
+void List<T, N>::print()
 {
     node *p = first;
     while(p)
     {
-        cout << p->value << " ";
+        cout << *p->value() << " ";
         p = p->next;
     }
     cout << endl;
 }
 
-template <class T>
-List<T>::List(): first(0)
+template <class T, int N>
+List<T, N>::List(): first(0), unused(0), blocks(0), capacity(N)
+{
+	for(int i = N - 1; i >= 0; i--)
+		release(&buffer[i]);
+}
+
+template <class T, int N>
+template <class It>
+List<T, N>::List(It begin, It end): List()
 {
+	insert(begin, end);
 }
 
-template <class T>
-void List<T>::removeAll()
+template <class T, int N>
+void List<T, N>::removeAll()
 {
-	while(!isEmpty())
-		remove();
+	// The nodes are kept in unused, so removeAll does not touch the heap
+	while(first)
+	{
+		node *victim = first;
+		first = victim->next;
+		victim->value()->~T();
+		release(victim);
+	}
 }
 
-template <class T>
-List<T>::~List()
+template <class T, int N>
+List<T, N>::~List()
 {
 	removeAll();
+	while(blocks)
+	{
+		node *block = blocks;
+		blocks = block->next;
+		delete[] block;
+	}
 }
 
-template <class T>
-void List<T>::copyList(node *np)
+template <class T, int N>
+void List<T, N>::copyList(node *np)
 {
-	if(!np) return;
-	copyList(np->next);
-	insert(np->value);
+	// Walks the nodes from np as insert walks a range, in order
+	struct walker
+	{
+		node *np;
+		bool operator!=(const walker &w) const { return np != w.np; }
+		void operator++() { np = np->next; }
+		const T &operator*() const { return *np->value(); }
+	};
+	walker begin = {np}, end = {0};
+	insert(begin, end);
 }
 
-template <class T>
-List<T>::List(const List &l): first(0)
+template <class T, int N>
+List<T, N>::List(const List &l): List()
 {
 	copyList(l.first);
 }
 
-template <class T>
-List<T> &List<T>::operator=(const List &l)
+template <class T, int N>
+List<T, N> &List<T, N>::operator=(const List &l)
 {
 	if(this != &l)
 	{
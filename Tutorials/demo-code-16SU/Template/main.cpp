@@ -1,4 +1,5 @@
 #include <iostream>
+#include <string>
 #include "list.h"
 using namespace std;
 
@@ -31,5 +32,25 @@ int main(int argc, char *argv[])
     cout << "print ln" << endl;
     ln.print();
 
+    int values[] = {1, 2, 3, 4, 5, 6};
+    cout << "lr created from the range of values" << endl;
+    List<int> lr(values, values + 6); // call range constructor
+    cout << "insert values 1 and 2 at the front of lr" << endl;
+    lr.insert(values, values + 2);
+    cout << "print lr" << endl;
+    // lr is (1 2 1 2 3 4 5 6)
+    lr.print();
+
+    List<string> ls;
+    string word = "template";
+    cout << "ls insert a copy of word, then a moved string" << endl;
+    ls.insert(word);
+    ls.insert(string("list"));
+    cout << "ls emplace 3 copies of '!'" << endl;
+    ls.emplace(3, '!'); // call string(3, '!') in place
+    cout << "print ls" << endl;
+    // ls is (!!! list template)
+    ls.print();
+
     return 0;
 }
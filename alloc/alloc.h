@@ -0,0 +1,629 @@
+//
+// The memory resources shared by the projects: a monotonic arena, a pool of
+// size classes, and a process-wide pool with a cache in each thread. They
+// are std::pmr::memory_resource objects where <memory_resource> is there,
+// and objects of a class with the same interface in C++11, so code written
+// against one builds with the other.
+//
+// A container opts in through a template parameter (Nodes, for the policy
+// of Dlist) or a base class (Allocated, for objects made with new), and
+// takes its resource from a constructor or setResource(), or from the
+// default resource. Each resource counts its calls in stats(), which is the
+// one place to see what allocation costs.
+//
+
+#ifndef ALLOC_H
+#define ALLOC_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <utility>
+
+#if __cplusplus >= 201703L && defined(__has_include)
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#define ALLOC_PMR 1
+#endif
+#endif
+
+namespace alloc {
+
+#ifdef ALLOC_PMR
+
+typedef std::pmr::memory_resource Resource;
+
+template<class T>
+using Allocator = std::pmr::polymorphic_allocator<T>;
+
+inline Resource *newDeleteResource() {
+    return std::pmr::new_delete_resource();
+}
+
+inline Resource *defaultResource() {
+    return std::pmr::get_default_resource();
+}
+
+inline Resource *setDefaultResource(Resource *resource) {
+    return std::pmr::set_default_resource(resource);
+}
+
+#else
+
+class Resource {
+    // OVERVIEW: the interface of std::pmr::memory_resource: allocate() and
+    //           deallocate() call the virtual functions a resource
+    //           defines, and deallocate() is given the same size and
+    //           alignment as the allocate() it undoes
+
+   public:
+    virtual ~Resource() {}
+
+    void *allocate(size_t bytes, size_t alignment = alignof(std::max_align_t)) {
+        return do_allocate(bytes, alignment);
+    }
+
+    void deallocate(void *p, size_t bytes, size_t alignment = alignof(std::max_align_t)) {
+        do_deallocate(p, bytes, alignment);
+    }
+
+    bool is_equal(const Resource &other) const noexcept {
+        return do_is_equal(other);
+    }
+
+   private:
+    virtual void *do_allocate(size_t bytes, size_t alignment) = 0;
+    virtual void do_deallocate(void *p, size_t bytes, size_t alignment) = 0;
+    virtual bool do_is_equal(const Resource &other) const noexcept = 0;
+};
+
+inline bool operator==(const Resource &a, const Resource &b) {
+    return &a == &b || a.is_equal(b);
+}
+
+inline bool operator!=(const Resource &a, const Resource &b) {
+    return !(a == b);
+}
+
+class NewDeleteResource : public Resource {
+    // OVERVIEW: ::operator new and delete. C++11 has no aligned new, so a
+    //           larger alignment than max_align_t is found within a larger
+    //           block, with the start of the block stored just before it
+
+    void *do_allocate(size_t bytes, size_t alignment) override {
+        if (alignment <= alignof(std::max_align_t)) return ::operator new(bytes);
+        char *block = static_cast<char *>(::operator new(bytes + alignment + sizeof(void *)));
+        char *p = block + sizeof(void *);
+        p += (alignment - uintptr_t(p) % alignment) % alignment;
+        reinterpret_cast<void **>(p)[-1] = block;
+        return p;
+    }
+
+    void do_deallocate(void *p, size_t, size_t alignment) override {
+        ::operator delete(alignment <= alignof(std::max_align_t) ? p : static_cast<void **>(p)[-1]);
+    }
+
+    bool do_is_equal(const Resource &other) const noexcept override {
+        return this == &other;
+    }
+};
+
+inline Resource *newDeleteResource() {
+    static NewDeleteResource resource;
+    return &resource;
+}
+
+inline std::atomic<Resource *> &defaultslot() {
+    static std::atomic<Resource *> slot(newDeleteResource());
+    return slot;
+}
+
+inline Resource *defaultResource() {
+    return defaultslot().load(std::memory_order_acquire);
+}
+
+inline Resource *setDefaultResource(Resource *resource) {
+    // EFFECTS makes resource the default, or new and delete if it is NULL,
+    //         and returns the one before
+    return defaultslot().exchange(resource ? resource : newDeleteResource(), std::memory_order_acq_rel);
+}
+
+template<class T>
+class Allocator {
+    // OVERVIEW: the part of std::pmr::polymorphic_allocator that C++11
+    //           containers use: T objects from a Resource
+
+    template<class U> friend class Allocator;
+
+    Resource *source;
+
+   public:
+    typedef T value_type;
+
+    Allocator() : source(defaultResource()) {}
+
+    Allocator(Resource *resource) : source(resource) {}
+
+    template<class U>
+    Allocator(const Allocator<U> &other) : source(other.source) {}
+
+    T *allocate(size_t n) {
+        return static_cast<T *>(source->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T *p, size_t n) {
+        source->deallocate(p, n * sizeof(T), alignof(T));
+    }
+
+    Resource *resource() const { return source; }
+
+    // A copied container takes the default resource, as with pmr
+    Allocator select_on_container_copy_construction() const { return Allocator(); }
+
+    template<class U>
+    bool operator==(const Allocator<U> &other) const { return *source == *other.source; }
+
+    template<class U>
+    bool operator!=(const Allocator<U> &other) const { return !(*this == other); }
+};
+
+#endif
+
+struct Stats {
+    // What a resource was asked for, and what it took from upstream
+    size_t allocations = 0;
+    size_t deallocations = 0;
+    size_t bytesInUse = 0;          // Asked for and not given back
+    size_t peakBytes = 0;           // The most bytesInUse has been
+    size_t upstreamBytes = 0;       // Held from the upstream resource
+
+    void allocated(size_t bytes) {
+        allocations++;
+        bytesInUse += bytes;
+        peakBytes = std::max(peakBytes, bytesInUse);
+    }
+
+    void deallocated(size_t bytes) {
+        deallocations++;
+        bytesInUse -= bytes;
+    }
+};
+
+inline size_t alignup(size_t n, size_t alignment) {
+    return (n + alignment - 1) & ~(alignment - 1);
+}
+
+class MonotonicArena : public Resource {
+    // OVERVIEW: hands out memory by bumping a pointer through blocks taken
+    //           from upstream, each twice as large as the one before, up
+    //           to MAX_BLOCK unless a request needs more. deallocate() does
+    //           nothing: the memory comes back all at once, by release() or
+    //           the destructor. Not safe to share between threads.
+
+    struct Block {
+        Block *next;
+        size_t size;    // With this header
+    };
+
+    static const size_t MAX_BLOCK = size_t(1) << 20;
+
+    Resource *upstream;
+    Block *blocks;      // Most recent first
+    char *cur, *end;    // The free part of the most recent block, or of the buffer
+    size_t nextSize;
+    size_t firstSize;
+    char *buffer;       // Given to the constructor, used first
+    size_t bufferSize;
+    Stats counts;
+
+    void *do_allocate(size_t bytes, size_t alignment) override {
+        // MODIFIES this
+        // EFFECTS returns bytes aligned to alignment, from a new block if
+        //         the current one has not got them
+        uintptr_t at = alignup(uintptr_t(cur), alignment);
+        if (cur == nullptr || at + bytes > uintptr_t(end)) {
+            size_t header = alignup(sizeof(Block), alignof(std::max_align_t));
+            size_t size = std::max(nextSize, header + bytes + alignment);
+            Block *block = static_cast<Block *>(upstream->allocate(size, alignof(std::max_align_t)));
+            block->next = blocks;
+            block->size = size;
+            blocks = block;
+            counts.upstreamBytes += size;
+            cur = reinterpret_cast<char *>(block) + header;
+            end = reinterpret_cast<char *>(block) + size;
+            if (nextSize < MAX_BLOCK) nextSize = nextSize * 2 < MAX_BLOCK ? nextSize * 2 : MAX_BLOCK;
+            at = alignup(uintptr_t(cur), alignment);
+        }
+        cur = reinterpret_cast<char *>(at + bytes);
+        counts.allocated(bytes);
+        return reinterpret_cast<void *>(at);
+    }
+
+    void do_deallocate(void *, size_t bytes, size_t) override {
+        counts.deallocated(bytes);
+    }
+
+    bool do_is_equal(const Resource &other) const noexcept override {
+        return this == &other;
+    }
+
+   public:
+    explicit MonotonicArena(Resource *upstream = defaultResource(), size_t firstBlock = 4096) :
+            upstream(upstream), blocks(nullptr), cur(nullptr), end(nullptr),
+            nextSize(std::max(firstBlock, size_t(64))), firstSize(nextSize), buffer(nullptr), bufferSize(0) {}
+
+    MonotonicArena(void *buffer, size_t size, Resource *upstream = defaultResource()) :
+            MonotonicArena(upstream, std::max(size, size_t(4096))) {
+        // EFFECTS an arena that hands out the size bytes at buffer before
+        //         taking blocks from upstream
+        this->buffer = cur = static_cast<char *>(buffer);
+        bufferSize = size;
+        end = cur + size;
+    }
+
+    MonotonicArena(const MonotonicArena &) = delete;
+
+    MonotonicArena &operator=(const MonotonicArena &) = delete;
+
+    ~MonotonicArena() override {
+        release();
+    }
+
+    void release() {
+        // MODIFIES this
+        // EFFECTS gives every block back to upstream; what the arena handed
+        //         out is no longer valid
+        while (blocks) {
+            Block *next = blocks->next;
+            upstream->deallocate(blocks, blocks->size, alignof(std::max_align_t));
+            blocks = next;
+        }
+        cur = buffer;
+        end = buffer ? buffer + bufferSize : nullptr;
+        nextSize = firstSize;
+        counts.upstreamBytes = 0;
+        counts.bytesInUse = 0;
+    }
+
+    Resource *upstreamResource() const { return upstream; }
+
+    const Stats &stats() const { return counts; }
+};
+
+// The size classes of the pools: multiples of 16 bytes up to MAX_POOLED,
+// each taken in slabs of SLAB_BYTES. Larger sizes and alignments go to the
+// upstream resource at once.
+const size_t POOL_GRAIN = 16;
+const size_t MAX_POOLED = 512;
+const size_t POOL_CLASSES = MAX_POOLED / POOL_GRAIN;
+const size_t SLAB_BYTES = 64 * 1024;
+
+inline bool pooled(size_t bytes, size_t alignment) {
+    return bytes <= MAX_POOLED && alignment <= POOL_GRAIN;
+}
+
+inline size_t poolclass(size_t bytes) {
+    // REQUIRES pooled(bytes, alignment)
+    return bytes == 0 ? 0 : (bytes - 1) / POOL_GRAIN;
+}
+
+struct FreeBlock {
+    FreeBlock *next;
+};
+
+class PoolResource : public Resource {
+    // OVERVIEW: a free list for each size class, refilled by carving a
+    //           slab from upstream. A freed block goes back on its list and
+    //           is the next one handed out, so a working set that stays the
+    //           same size stops taking memory. The slabs come back by
+    //           release() or the destructor. Not safe to share between
+    //           threads.
+
+    Resource *upstream;
+    FreeBlock *lists[POOL_CLASSES];
+    FreeBlock *slabs;       // Each slab starts with the link to the next
+    Stats counts;
+
+    void refill(size_t c) {
+        // MODIFIES this
+        // EFFECTS carves a new slab into blocks of class c
+        size_t size = (c + 1) * POOL_GRAIN;
+        char *slab = static_cast<char *>(upstream->allocate(SLAB_BYTES, POOL_GRAIN));
+        reinterpret_cast<FreeBlock *>(slab)->next = slabs;
+        slabs = reinterpret_cast<FreeBlock *>(slab);
+        counts.upstreamBytes += SLAB_BYTES;
+        for (size_t at = alignup(sizeof(FreeBlock), POOL_GRAIN); at + size <= SLAB_BYTES; at += size) {
+            FreeBlock *block = reinterpret_cast<FreeBlock *>(slab + at);
+            block->next = lists[c];
+            lists[c] = block;
+        }
+    }
+
+    void *do_allocate(size_t bytes, size_t alignment) override {
+        counts.allocated(bytes);
+        if (!pooled(bytes, alignment)) {
+            counts.upstreamBytes += bytes;
+            return upstream->allocate(bytes, alignment);
+        }
+        size_t c = poolclass(bytes);
+        if (!lists[c]) refill(c);
+        FreeBlock *block = lists[c];
+        lists[c] = block->next;
+        return block;
+    }
+
+    void do_deallocate(void *p, size_t bytes, size_t alignment) override {
+        counts.deallocated(bytes);
+        if (!pooled(bytes, alignment)) {
+            counts.upstreamBytes -= bytes;
+            upstream->deallocate(p, bytes, alignment);
+            return;
+        }
+        size_t c = poolclass(bytes);
+        FreeBlock *block = static_cast<FreeBlock *>(p);
+        block->next = lists[c];
+        lists[c] = block;
+    }
+
+    bool do_is_equal(const Resource &other) const noexcept override {
+        return this == &other;
+    }
+
+   public:
+    explicit PoolResource(Resource *upstream = defaultResource()) : upstream(upstream), slabs(nullptr) {
+        std::fill(lists, lists + POOL_CLASSES, nullptr);
+    }
+
+    PoolResource(const PoolResource &) = delete;
+
+    PoolResource &operator=(const PoolResource &) = delete;
+
+    ~PoolResource() override {
+        release();
+    }
+
+    void release() {
+        // REQUIRES the blocks larger than MAX_POOLED were deallocated
+        // MODIFIES this
+        // EFFECTS gives every slab back to upstream
+        while (slabs) {
+            FreeBlock *next = slabs->next;
+            upstream->deallocate(slabs, SLAB_BYTES, POOL_GRAIN);
+            slabs = next;
+        }
+        std::fill(lists, lists + POOL_CLASSES, nullptr);
+        counts.upstreamBytes = 0;
+        counts.bytesInUse = 0;
+    }
+
+    Resource *upstreamResource() const { return upstream; }
+
+    const Stats &stats() const { return counts; }
+};
+
+class ThreadCachedPool : public Resource {
+    // OVERVIEW: the size classes of PoolResource for the whole process and
+    //           every thread. Each thread keeps up to 2 * BATCH free blocks
+    //           of each class, which it allocates and frees without a lock;
+    //           it takes and gives back BATCH blocks at a time from the
+    //           shared lists under a mutex, and gives back all it holds when
+    //           it ends. The slabs come from new and are never freed, so
+    //           that a thread may end after the pool is destroyed; there is
+    //           one pool, threadCachedResource().
+
+    static const size_t BATCH = 32;
+
+    struct Lists {
+        FreeBlock *heads[POOL_CLASSES];
+        size_t lengths[POOL_CLASSES];
+
+        Lists() {
+            std::fill(heads, heads + POOL_CLASSES, nullptr);
+            std::fill(lengths, lengths + POOL_CLASSES, size_t(0));
+        }
+    };
+
+    struct Cache : Lists {
+        ThreadCachedPool *owner;
+
+        explicit Cache(ThreadCachedPool *owner) : owner(owner) {}
+
+        ~Cache() {
+            std::lock_guard<std::mutex> lock(owner->mutex);
+            for (size_t c = 0; c < POOL_CLASSES; c++) owner->give(*this, c, lengths[c]);
+        }
+    };
+
+    std::mutex mutex;
+    Lists shared;           // Under mutex
+    std::atomic<size_t> upstream;
+
+    void move(Lists &from, Lists &to, size_t c, size_t n) {
+        // MODIFIES from, to
+        // EFFECTS moves up to n blocks of class c from one set of lists to
+        //         the other
+        while (n-- > 0 && from.heads[c]) {
+            FreeBlock *block = from.heads[c];
+            from.heads[c] = block->next;
+            from.lengths[c]--;
+            block->next = to.heads[c];
+            to.heads[c] = block;
+            to.lengths[c]++;
+        }
+    }
+
+    void give(Lists &cache, size_t c, size_t n) {
+        // REQUIRES mutex is held
+        move(cache, shared, c, n);
+    }
+
+    void take(Lists &cache, size_t c) {
+        // MODIFIES this, cache
+        // EFFECTS moves BATCH blocks of class c to cache, carving a slab
+        //         if the shared list has not got them
+        std::lock_guard<std::mutex> lock(mutex);
+        if (shared.lengths[c] < BATCH) {
+            size_t size = (c + 1) * POOL_GRAIN;
+            char *slab = static_cast<char *>(::operator new(SLAB_BYTES));
+            upstream.fetch_add(SLAB_BYTES, std::memory_order_relaxed);
+            for (size_t at = 0; at + size <= SLAB_BYTES; at += size) {
+                FreeBlock *block = reinterpret_cast<FreeBlock *>(slab + at);
+                block->next = shared.heads[c];
+                shared.heads[c] = block;
+                shared.lengths[c]++;
+            }
+        }
+        move(shared, cache, c, BATCH);
+    }
+
+    Cache &cache() {
+        thread_local Cache local(this);
+        return local;
+    }
+
+    void *do_allocate(size_t bytes, size_t alignment) override {
+        if (!pooled(bytes, alignment)) return newDeleteResource()->allocate(bytes, alignment);
+        size_t c = poolclass(bytes);
+        Cache &local = cache();
+        if (!local.heads[c]) take(local, c);
+        FreeBlock *block = local.heads[c];
+        local.heads[c] = block->next;
+        local.lengths[c]--;
+        return block;
+    }
+
+    void do_deallocate(void *p, size_t bytes, size_t alignment) override {
+        if (!pooled(bytes, alignment)) {
+            newDeleteResource()->deallocate(p, bytes, alignment);
+            return;
+        }
+        size_t c = poolclass(bytes);
+        Cache &local = cache();
+        FreeBlock *block = static_cast<FreeBlock *>(p);
+        block->next = local.heads[c];
+        local.heads[c] = block;
+        if (++local.lengths[c] > 2 * BATCH) {
+            std::lock_guard<std::mutex> lock(mutex);
+            give(local, c, BATCH);
+        }
+    }
+
+    bool do_is_equal(const Resource &other) const noexcept override {
+        return this == &other;
+    }
+
+    ThreadCachedPool() : upstream(0) {}
+
+    friend Resource *threadCachedResource();
+
+   public:
+    ThreadCachedPool(const ThreadCachedPool &) = delete;
+
+    ThreadCachedPool &operator=(const ThreadCachedPool &) = delete;
+
+    Stats stats() const {
+        // EFFECTS returns what the pool took from upstream; the calls are
+        //         not counted, which would make the threads share a line
+        Stats s;
+        s.upstreamBytes = upstream.load(std::memory_order_relaxed);
+        return s;
+    }
+};
+
+inline Resource *threadCachedResource() {
+    // EFFECTS returns the ThreadCachedPool of the process, which is never
+    //         destroyed
+    static ThreadCachedPool *pool = new ThreadCachedPool;
+    return pool;
+}
+
+template<class N>
+class Nodes {
+    // OVERVIEW: the allocation policy of Dlist over a resource, the default
+    //           one unless the list is given another. Moving it moves the
+    //           resource along, as the nodes come with it; a copy of a list
+    //           takes the default.
+
+    Resource *source;
+
+   public:
+    Nodes() : source(defaultResource()) {}
+
+    Nodes(Resource *resource) : source(resource) {}
+
+    template<class... Args>
+    N *allocate(Args &&... args) {
+        // EFFECTS returns an N constructed from args
+        void *p = source->allocate(sizeof(N), alignof(N));
+        try {
+            return new(p) N(std::forward<Args>(args)...);
+        } catch (...) {
+            source->deallocate(p, sizeof(N), alignof(N));
+            throw;
+        }
+    }
+
+    void deallocate(N *n) {
+        // REQUIRES n was returned by allocate() of this policy or one moved
+        //          into it
+        // EFFECTS destroys n and gives its storage back
+        n->~N();
+        source->deallocate(n, sizeof(N), alignof(N));
+    }
+
+    void adopt(Nodes &p) {
+        // REQUIRES p takes from the same resource as this policy
+        // EFFECTS nothing, as the nodes of p go back to that resource
+        (void) p;
+    }
+
+    Resource *resource() const { return source; }
+};
+
+template<class T>
+class Allocated {
+    // OVERVIEW: a base class that makes new T take its memory from the
+    //           resource of setResource(), new and delete unless set. Each
+    //           object records the resource it came from, in the
+    //           alignment of max_align_t in front of it, so that delete
+    //           finds it however often the resource is changed.
+
+    static const size_t HEADER = alignof(std::max_align_t);
+
+    static std::atomic<Resource *> &slot() {
+        static std::atomic<Resource *> resource(newDeleteResource());
+        return resource;
+    }
+
+   public:
+    static Resource *setResource(Resource *resource) {
+        // EFFECTS makes the T objects made from now on come from resource,
+        //         or from new and delete if it is NULL, and returns the one
+        //         before
+        return slot().exchange(resource ? resource : newDeleteResource(), std::memory_order_acq_rel);
+    }
+
+    static Resource *resource() {
+        return slot().load(std::memory_order_acquire);
+    }
+
+    static void *operator new(size_t size) {
+        Resource *source = resource();
+        char *p = static_cast<char *>(source->allocate(HEADER + size, HEADER));
+        *reinterpret_cast<Resource **>(p) = source;
+        return p + HEADER;
+    }
+
+    static void operator delete(void *object, size_t size) {
+        if (object == nullptr) return;
+        char *p = static_cast<char *>(object) - HEADER;
+        (*reinterpret_cast<Resource **>(p))->deallocate(p, HEADER + size, HEADER);
+    }
+};
+
+}  // namespace alloc
+
+#endif //ALLOC_H
@@ -0,0 +1,104 @@
+//
+// Benchmarks of the resources of alloc/alloc.h: the same patterns of
+// allocation on each, and the nodes of Dlist from each against its NodePool.
+//
+
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "alloc.h"
+#include "bench.h"
+#include "dlist.h"
+
+using namespace std;
+
+static void churnhelper(alloc::Resource *resource, vector<void *> &live, const vector<size_t> &sizes) {
+    // MODIFIES live
+    // EFFECTS frees and allocates the objects of live one by one, each with
+    //         its size of sizes, as a working set of a steady size does
+    for (size_t i = 0; i < live.size(); i++) {
+        resource->deallocate(live[i], sizes[i]);
+        live[i] = resource->allocate(sizes[i]);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    bench::Suite suite("alloc", argc, argv);
+    const int N = 1000;
+
+    // Sizes of 8 to 256 bytes, like those of the nodes and cells of the
+    // projects
+    mt19937 random(1);
+    vector<size_t> sizes(N);
+    for (auto &size : sizes) size = 8 + random() % 249;
+
+    alloc::PoolResource pool;
+    alloc::MonotonicArena arena;
+    vector<pair<string, alloc::Resource *> > resources = {
+            {"new_delete", alloc::newDeleteResource()}, {"pool", &pool},
+            {"thread_cached", alloc::threadCachedResource()}};
+
+    for (const auto &r : resources) {
+        alloc::Resource *resource = r.second;
+        suite.micro(r.first + " allocate+deallocate 32B", [&]() {
+            void *p = resource->allocate(32);
+            bench::keep(p);
+            resource->deallocate(p, 32);
+        }, 1);
+
+        // Allocated in bulk, then freed in the same order
+        suite.micro(r.first + " 1000 allocate then 1000 deallocate", [&]() {
+            static void *objects[N];
+            for (int i = 0; i < N; i++) objects[i] = resource->allocate(sizes[i]);
+            for (int i = 0; i < N; i++) resource->deallocate(objects[i], sizes[i]);
+        }, N);
+
+        vector<void *> live(N);
+        for (int i = 0; i < N; i++) live[i] = resource->allocate(sizes[i]);
+        suite.micro(r.first + " churn/1000", [&]() { churnhelper(resource, live, sizes); }, N);
+        for (int i = 0; i < N; i++) resource->deallocate(live[i], sizes[i]);
+    }
+
+    // The arena frees nothing, so it is released after each sample
+    suite.micro("monotonic 1000 allocate then release", [&]() {
+        for (int i = 0; i < N; i++) bench::keep(arena.allocate(sizes[i]));
+        arena.release();
+    }, N);
+
+    // Four threads each churning their own working set
+    for (const auto &r : resources) {
+        if (r.second == &pool) continue;
+        alloc::Resource *resource = r.second;
+        suite.macro(r.first + " churn/4 threads x 100000", [&]() {
+            vector<thread> threads;
+            for (int t = 0; t < 4; t++) {
+                threads.emplace_back([&]() {
+                    vector<void *> live(N);
+                    for (int i = 0; i < N; i++) live[i] = resource->allocate(sizes[i]);
+                    for (int k = 0; k < 100; k++) churnhelper(resource, live, sizes);
+                    for (int i = 0; i < N; i++) resource->deallocate(live[i], sizes[i]);
+                });
+            }
+            for (auto &t : threads) t.join();
+            return true;
+        }, 4 * 100 * N);
+    }
+
+    static int values[N];
+    suite.micro("Dlist<NodePool> insertBack+removeFront/1000", [&]() {
+        Dlist<int> list;
+        for (int i = 0; i < N; i++) list.insertBack(&values[i]);
+        while (!list.isEmpty()) bench::keep(list.removeFront());
+    }, N);
+    for (const auto &r : resources) {
+        alloc::Resource *resource = r.second;
+        suite.micro("Dlist<alloc::Nodes> " + r.first + " insertBack+removeFront/1000", [&]() {
+            Dlist<int, alloc::Nodes> list(resource);
+            for (int i = 0; i < N; i++) list.insertBack(&values[i]);
+            while (!list.isEmpty()) bench::keep(list.removeFront());
+        }, N);
+    }
+    return suite.finish();
+}
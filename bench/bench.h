@@ -0,0 +1,299 @@
+//
+// The benchmark framework of the bench-* targets: timed samples after
+// warmup runs, their percentiles, and one JSON report per suite.
+//
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+namespace bench {
+
+template<class T>
+inline void keep(const T &value) {
+    // EFFECTS makes the compiler compute value, even if nothing reads it
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+struct Stats {
+    // Nanoseconds per call
+    double min, mean, stddev, p50, p90, p99, max;
+};
+
+inline Stats summarize(std::vector<double> samples) {
+    // REQUIRES samples is not empty
+    // EFFECTS returns the statistics of samples, with nearest-rank
+    //         percentiles
+    std::sort(samples.begin(), samples.end());
+    auto rank = [&](double p) {
+        size_t i = size_t(std::ceil(p * double(samples.size())));
+        return samples[std::min(samples.size(), std::max<size_t>(i, 1)) - 1];
+    };
+    double sum = 0, squares = 0;
+    for (double s : samples) sum += s;
+    double mean = sum / double(samples.size());
+    for (double s : samples) squares += (s - mean) * (s - mean);
+    return Stats{samples.front(), mean, std::sqrt(squares / double(samples.size())),
+                 rank(0.50), rank(0.90), rank(0.99), samples.back()};
+}
+
+class Suite {
+    // OVERVIEW: the benchmarks of one subsystem. Each benchmark runs
+    //           "warmup" untimed samples, then "repetitions" timed ones. A
+    //           micro benchmark times a small operation, called as many
+    //           times per sample as make the sample last minSample seconds;
+    //           a macro benchmark or a command is one call per sample.
+    //           finish() prints the results, and writes them as JSON if
+    //           asked to.
+    //
+    //           Options: --json FILE, --warmup N, --reps N,
+    //           --min-sample SECONDS, --filter TEXT (run the benchmarks
+    //           whose name contains TEXT), --workdir DIR (for the files the
+    //           benchmarks make), --quick (1 warmup, 3 repetitions, 1 ms
+    //           samples, for a smoke test) and --list.
+
+    struct Result {
+        std::string name, kind;
+        size_t iterations;      // Calls per sample
+        size_t samples;
+        double items;           // Items processed per call, 0 if not counted
+        Stats ns;
+        bool failed;
+        long maxRssKb;          // Peak resident size of a command, in KiB, 0
+                                // if not measured
+    };
+
+    std::string name;
+    int warmup = 2;
+    int repetitions = 10;
+    double minSample = 0.01;
+    std::string jsonPath, filter, workdir = ".";
+    bool listOnly = false;
+    std::vector<Result> results;
+
+    template<class F>
+    static double timehelper(F &f, size_t iterations) {
+        // EFFECTS calls f iterations times and returns the seconds taken
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; i++) f();
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    template<class F>
+    void runhelper(const std::string &benchmark, const char *kind, F &f, size_t iterations, double items) {
+        // MODIFIES this
+        // EFFECTS runs the warmup and timed samples of f, of iterations
+        //         calls each, and records them; f returns false on failure
+        Result result{benchmark, kind, iterations, 0, items, Stats{}, false, 0};
+        std::vector<double> samples;
+        auto batch = [&]() {
+            bool ok = true;
+            for (size_t i = 0; i < iterations && ok; i++) ok = f();
+            return ok;
+        };
+        for (int i = 0; i < warmup + repetitions && !result.failed; i++) {
+            auto start = std::chrono::steady_clock::now();
+            result.failed = !batch();
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            if (i >= warmup) samples.push_back(seconds * 1e9 / double(iterations));
+        }
+        if (!samples.empty()) result.ns = summarize(samples);
+        result.samples = samples.size();
+        results.push_back(result);
+    }
+
+    static void printhelper(const Result &r) {
+        char line[256];
+        if (r.failed) {
+            snprintf(line, sizeof(line), "%-40s %-7s FAILED", r.name.c_str(), r.kind.c_str());
+        } else {
+            snprintf(line, sizeof(line), "%-40s %-7s %12.0f %12.0f %12.0f %12.0f", r.name.c_str(), r.kind.c_str(),
+                     r.ns.p50, r.ns.p90, r.ns.p99, r.ns.min);
+        }
+        std::cout << line;
+        if (!r.failed && r.items > 0) {
+            snprintf(line, sizeof(line), " %12.4g/s", r.items * 1e9 / r.ns.p50);
+            std::cout << line;
+        }
+        if (!r.failed && r.maxRssKb > 0) {
+            snprintf(line, sizeof(line), " %9.1f MiB", double(r.maxRssKb) / 1024);
+            std::cout << line;
+        }
+        std::cout << std::endl;
+    }
+
+    static std::string quotehelper(const std::string &s) {
+        // EFFECTS returns s as a JSON string
+        std::string out = "\"";
+        for (char c : s) {
+            if (c == '"' || c == '\\') out += '\\';
+            if ((unsigned char) c < 0x20) {
+                char escape[8];
+                snprintf(escape, sizeof(escape), "\\u%04x", c);
+                out += escape;
+            } else {
+                out += c;
+            }
+        }
+        return out + "\"";
+    }
+
+   public:
+    Suite(const std::string &suiteName, int argc, char *argv[]) : name(suiteName) {
+        // EFFECTS reads the options, exits with usage on a wrong one
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            bool value = i + 1 < argc;
+            if (arg == "--json" && value) jsonPath = argv[++i];
+            else if (arg == "--warmup" && value) warmup = std::max(0, atoi(argv[++i]));
+            else if (arg == "--reps" && value) repetitions = std::max(1, atoi(argv[++i]));
+            else if (arg == "--min-sample" && value) minSample = atof(argv[++i]);
+            else if (arg == "--filter" && value) filter = argv[++i];
+            else if (arg == "--workdir" && value) workdir = argv[++i];
+            else if (arg == "--list") listOnly = true;
+            else if (arg == "--quick") {
+                warmup = 1;
+                repetitions = 3;
+                minSample = 0.001;
+            } else {
+                std::cerr << "Usage: " << argv[0] << " [--json FILE] [--warmup N] [--reps N] [--min-sample SECONDS]"
+                          << " [--filter TEXT] [--workdir DIR] [--quick] [--list]" << std::endl;
+                exit(2);
+            }
+        }
+        if (!listOnly) {
+            std::cout << "suite " << name << ": " << warmup << " warmup, " << repetitions
+                      << " repetitions, ns per call" << std::endl;
+            char header[128];
+            snprintf(header, sizeof(header), "%-40s %-7s %12s %12s %12s %12s", "benchmark", "kind",
+                     "p50", "p90", "p99", "min");
+            std::cout << header << std::endl;
+        }
+    }
+
+    const std::string &workDir() const {
+        return workdir;
+    }
+
+    bool listing() const {
+        // EFFECTS returns true with --list, when no benchmark runs and the
+        //         setup of the files they need can be skipped
+        return listOnly;
+    }
+
+    bool enabled(const std::string &benchmark) {
+        // EFFECTS returns true if benchmark is to run; with --list, prints
+        //         its name and returns false
+        if (!filter.empty() && benchmark.find(filter) == std::string::npos) return false;
+        if (listOnly) std::cout << name << "/" << benchmark << std::endl;
+        return !listOnly;
+    }
+
+    template<class F>
+    void micro(const std::string &benchmark, F &&f, double itemsPerCall = 0) {
+        // MODIFIES this
+        // EFFECTS times f(), a small operation returning nothing, over
+        //         batches of calls lasting minSample seconds or more
+        if (!enabled(benchmark)) return;
+        auto call = [&]() {
+            f();
+            return true;
+        };
+        size_t iterations = 1;
+        double seconds;
+        while ((seconds = timehelper(call, iterations)) < minSample && iterations < (size_t(1) << 40)) {
+            // Grow by the ratio left, at most 10 times, at least 2 times
+            double ratio = seconds > 0 ? minSample / seconds : 10;
+            iterations = size_t(double(iterations) * std::min(10.0, std::max(2.0, ratio * 1.2)));
+        }
+        runhelper(benchmark, "micro", call, iterations, itemsPerCall);
+        printhelper(results.back());
+    }
+
+    template<class F>
+    void macro(const std::string &benchmark, F &&f, double items = 0) {
+        // MODIFIES this
+        // EFFECTS times f(), a whole run returning true on success, once
+        //         per sample
+        if (!enabled(benchmark)) return;
+        runhelper(benchmark, "macro", f, 1, items);
+        printhelper(results.back());
+    }
+
+    void command(const std::string &benchmark, const std::string &cmd, double items = 0) {
+        // MODIFIES this
+        // EFFECTS times the shell command cmd, which fails if its exit
+        //         status is not 0, once per sample, and records the largest
+        //         peak resident size of a sample
+        if (!enabled(benchmark)) return;
+        long maxRssKb = 0;
+        auto run = [&]() {
+            // std::system() with the child's resource use: wait4() counts
+            // the shell and the processes it waited for
+            pid_t pid = fork();
+            if (pid < 0) return false;
+            if (pid == 0) {
+                execl("/bin/sh", "sh", "-c", cmd.c_str(), (char *) NULL);
+                _exit(127);
+            }
+            int status;
+            struct rusage usage;
+            if (wait4(pid, &status, 0, &usage) != pid) return false;
+            maxRssKb = std::max(maxRssKb, long(usage.ru_maxrss));
+            return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+        };
+        runhelper(benchmark, "command", run, 1, items);
+        results.back().maxRssKb = maxRssKb;
+        printhelper(results.back());
+    }
+
+    int finish() {
+        // EFFECTS writes the JSON report if asked to, and returns the exit
+        //         status: 1 if a benchmark failed or the report could not be
+        //         written, 0 otherwise
+        bool failed = false;
+        for (const auto &r : results) failed = failed || r.failed;
+        if (jsonPath.empty() || listOnly) return failed;
+        std::ofstream out(jsonPath);
+        out.precision(10);
+        out << "{\n  \"suite\": " << quotehelper(name) << ",\n  \"warmup\": " << warmup
+            << ",\n  \"repetitions\": " << repetitions << ",\n  \"unit\": \"ns\",\n  \"benchmarks\": [";
+        for (size_t i = 0; i < results.size(); i++) {
+            const Result &r = results[i];
+            out << (i ? "," : "") << "\n    {\"name\": " << quotehelper(r.name) << ", \"kind\": \"" << r.kind
+                << "\", \"iterations\": " << r.iterations << ", \"samples\": " << r.samples
+                << ", \"failed\": " << (r.failed ? "true" : "false");
+            if (r.samples) {
+                out << ", \"min\": " << r.ns.min << ", \"mean\": " << r.ns.mean << ", \"stddev\": " << r.ns.stddev
+                    << ", \"p50\": " << r.ns.p50 << ", \"p90\": " << r.ns.p90 << ", \"p99\": " << r.ns.p99
+                    << ", \"max\": " << r.ns.max;
+                if (r.items > 0) out << ", \"items_per_second\": " << r.items * 1e9 / r.ns.p50;
+                if (r.maxRssKb > 0) out << ", \"max_rss_kb\": " << r.maxRssKb;
+            }
+            out << "}";
+        }
+        out << "\n  ]\n}\n";
+        out.close();
+        if (!out) {
+            std::cerr << "Cannot write " << jsonPath << std::endl;
+            return 1;
+        }
+        return failed;
+    }
+};
+
+}  // namespace bench
+
+#endif //BENCH_H
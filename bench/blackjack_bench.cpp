@@ -0,0 +1,60 @@
+//
+// Benchmarks of p4-blackjack: shuffling and dealing a shoe, a hand's
+// value, and whole simulations, a session printed and through a hand
+// history, and the tournament through the executable.
+//
+
+#include <cstdlib>
+#include <string>
+
+#include "bench.h"
+#include "hand.h"
+#include "rand.h"
+#include "shoe.h"
+
+using namespace std;
+
+int main(int argc, char *argv[]) {
+    bench::Suite suite("blackjack", argc, argv);
+    Random random(119);
+    Shoe shoe(6, 0.75);
+
+    suite.micro("Shoe shuffle/6 decks", [&]() {
+        shoe.shuffle(random);
+        bench::keep(shoe.cardsLeft());
+    }, 6 * 52);
+
+    shoe.shuffle(random);
+    suite.micro("Shoe deal", [&]() {
+        if (shoe.cardsLeft() == 0) shoe.shuffle(random);
+        Card c = shoe.deal();
+        bench::keep(c);
+    }, 1);
+
+    Hand hand;
+    suite.micro("Hand addCard+handValue", [&]() {
+        if (shoe.cardsLeft() == 0) shoe.shuffle(random);
+        hand.addCard(shoe.deal());
+        HandValue value = hand.handValue();
+        if (value.count > 21) hand.discardAll();
+        bench::keep(value);
+    }, 1);
+
+    // bankroll, hands, player, sessions, threads, seed
+    string blackjack = string(BLACKJACK) + " ";
+    for (const char *player : {"simple", "counting"}) {
+        suite.command(string("simulate ") + player + "/2000 sessions",
+                      blackjack + "100 1000 " + player + " 2000 1 119 > /dev/null", 2000.0 * 1000);
+    }
+    // one session printed, and the same session written to a hand history and printed from it
+    string history = suite.workDir() + "/blackjack.history";
+    string session = "100000000 100000 counting";
+    if (!suite.listing() && std::system((blackjack + session + " --history " + history).c_str()) != 0) return 1;
+    suite.command("play printed/100000 hands", blackjack + session + " > /dev/null", 100000);
+    suite.command("play history/100000 hands", blackjack + session + " --history " + history, 100000);
+    suite.command("history printed/100000 hands", blackjack + "history " + history + " > /dev/null", 100000);
+    suite.command("tournament/100000 hands", blackjack + "tournament 100000 1 119 > /dev/null", 100000);
+    // 40 rule sets, each of which plays every hand
+    suite.command("rules sweep/100000 hands", blackjack + "rules 100000 1 119 > /dev/null", 100000.0 * 40);
+    return suite.finish();
+}
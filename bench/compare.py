@@ -0,0 +1,65 @@
+import argparse
+import json
+import os
+import sys
+
+# Compares two directories of bench-results/<suite>.json, as written by the
+# run-bench-* targets: the p50 of every benchmark in both, as a ratio of the
+# current run to the baseline. Exits with 1 if a benchmark got slower by more
+# than the threshold, or failed.
+#
+#   python3 compare.py <baseline dir> <current dir> [--threshold 0.10]
+
+
+def load(directory):
+    # {(suite, benchmark): result} of every report in directory
+    results = {}
+    for name in sorted(os.listdir(directory)):
+        if not name.endswith('.json'):
+            continue
+        with open(os.path.join(directory, name)) as f:
+            report = json.load(f)
+        for b in report['benchmarks']:
+            results[(report['suite'], b['name'])] = b
+    return results
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument('baseline')
+    parser.add_argument('current')
+    parser.add_argument('--threshold', type=float, default=0.10,
+                        help='slowdown of the p50 reported as a regression')
+    args = parser.parse_args()
+
+    baseline = load(args.baseline)
+    current = load(args.current)
+    regressions = 0
+    print('%-52s %14s %14s %8s' % ('benchmark', 'baseline p50', 'current p50', 'ratio'))
+    for key in sorted(current):
+        name = '%s/%s' % key
+        now = current[key]
+        if now['failed']:
+            print('%-52s %14s %14s %8s' % (name, '', 'FAILED', ''))
+            regressions += 1
+            continue
+        if key not in baseline or baseline[key]['failed']:
+            print('%-52s %14s %14.0f %8s' % (name, 'new', now['p50'], ''))
+            continue
+        ratio = now['p50'] / baseline[key]['p50'] if baseline[key]['p50'] > 0 else 1.0
+        flag = ''
+        if ratio > 1 + args.threshold:
+            flag = ' slower'
+            regressions += 1
+        elif ratio < 1 - args.threshold:
+            flag = ' faster'
+        print('%-52s %14.0f %14.0f %8.3f%s' % (name, baseline[key]['p50'], now['p50'], ratio, flag))
+    for key in sorted(set(baseline) - set(current)):
+        print('%-52s %14.0f %14s %8s' % ('%s/%s' % key, baseline[key]['p50'], 'gone', ''))
+    if regressions:
+        print('%d regression(s) beyond %.0f%%' % (regressions, args.threshold * 100))
+    return 1 if regressions else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,130 @@
+//
+// Benchmarks of the lists of p5-list-hard: Dlist, Vlist and ConcurrentDlist
+// operations, sorting a Dlist, the LRU cache simulator built on them, and
+// the cache and rpn executables on the test cases.
+//
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "cache_sim.h"
+#include "concurrent_dlist.h"
+#include "dlist.h"
+#include "vlist.h"
+
+using namespace std;
+
+int main(int argc, char *argv[]) {
+    bench::Suite suite("dlist", argc, argv);
+    const int N = 1000;
+
+    suite.micro("Dlist insertBack+removeFront/1000", [&]() {
+        Dlist<int> list;
+        static int values[N];
+        for (int i = 0; i < N; i++) list.insertBack(&values[i]);
+        while (!list.isEmpty()) bench::keep(list.removeFront());
+    }, N);
+
+    // The owner's end of a work-stealing deque, with no thief
+    suite.micro("Dlist insertBack+removeBack/1000", [&]() {
+        Dlist<int> list;
+        static int values[N];
+        for (int i = 0; i < N; i++) list.insertBack(&values[i]);
+        while (!list.isEmpty()) bench::keep(list.removeBack());
+    }, N);
+
+    ConcurrentDlist<int> deque;
+    suite.micro("ConcurrentDlist insertBack+removeBack/1000", [&]() {
+        static int values[N];
+        for (int i = 0; i < N; i++) deque.insertBack(&values[i]);
+        for (int i = 0; i < N; i++) bench::keep(deque.removeBack());
+    }, N);
+
+    suite.micro("Vlist insertBack+removeFront/1000", [&]() {
+        Vlist<int> list;
+        for (int i = 0; i < N; i++) list.insertBack(i);
+        int sum = 0;
+        while (!list.isEmpty()) sum += list.removeFront();
+        bench::keep(sum);
+    }, N);
+
+    Vlist<int> full;
+    for (int i = 0; i < N; i++) full.insertBack(i);
+    suite.micro("Vlist iterate/1000", [&]() {
+        int sum = 0;
+        for (int value : full) sum += value;
+        bench::keep(sum);
+    }, N);
+
+    suite.micro("Vlist copy/1000", [&]() {
+        Vlist<int> copy(full);
+        bench::keep(copy.front());
+    }, N);
+
+    // The step of an LRU: move a block found in the middle to the front
+    mt19937 rng(119);
+    vector<Vlist<int>::handle> handles;
+    for (int i = 0; i < N; i++) {
+        handles.push_back(full.back());
+        full.moveToFront(full.back());
+    }
+    size_t next = 0;
+    vector<size_t> picks(4096);
+    for (auto &pick : picks) pick = rng() % handles.size();
+    suite.micro("Vlist moveToFront", [&]() {
+        full.moveToFront(handles[picks[next++ & 4095]]);
+        bench::keep(Vlist<int>::at(full.front()));
+    }, 1);
+
+    // Sorting 100000 objects, given new random keys each time: in place,
+    // and by copying them out to sort and into a new list
+    const int SORTED = 100000;
+    vector<int> keys(SORTED);
+    Dlist<int> unsorted;
+    for (int i = 0; i < SORTED; i++) unsorted.insertBack(&keys[i]);
+    auto before = [](const int *a, const int *b) { return *a < *b; };
+    suite.macro("Dlist sort/100000", [&]() {
+        for (auto &key : keys) key = int(rng());
+        unsorted.sort(before);
+        return *Dlist<int>::at(unsorted.front()) <= *Dlist<int>::at(unsorted.back());
+    }, SORTED);
+    suite.macro("Dlist copy out+stable_sort/100000", [&]() {
+        for (auto &key : keys) key = int(rng());
+        vector<int *> objects;
+        while (!unsorted.isEmpty()) objects.push_back(unsorted.removeFront());
+        stable_sort(objects.begin(), objects.end(), before);
+        for (int *object : objects) unsorted.insertBack(object);
+        return *Dlist<int>::at(unsorted.front()) <= *Dlist<int>::at(unsorted.back());
+    }, SORTED);
+    // the list would delete the keys it points to
+    while (!unsorted.isEmpty()) unsorted.removeFront();
+
+    // 1M accesses, 90% to a hot tenth of memory, through a 3-level cache
+    const size_t MEMORY = 1 << 16, ACCESSES = 1 << 20;
+    vector<size_t> addresses(ACCESSES);
+    for (auto &address : addresses) {
+        address = rng() % 10 ? rng() % (MEMORY / 10) : rng() % MEMORY;
+    }
+    for (ReplacementPolicy policy : {POLICY_LRU, POLICY_CLOCK}) {
+        string name = string("CacheSim ") + (policy == POLICY_LRU ? "lru" : "clock") + "/1M accesses";
+        suite.macro(name, [&]() {
+            CacheSim cache({{256, 0}, {4096, 8}, {16384, 16}}, MEMORY, policy, WRITE_BACK);
+            unsigned sum = 0;
+            for (size_t i = 0; i < ACCESSES; i++) {
+                if (i % 4 == 0) cache.write(addresses[i], int(i));
+                else sum += unsigned(cache.read(addresses[i]));
+            }
+            bench::keep(sum);
+            return cache.levelStats(0).hits > 0;
+        }, double(ACCESSES));
+    }
+
+    string cases = string(PROJECTS_DIR) + "/p5-list-hard/cases/";
+    suite.command("cache cache.3.in", string(DLIST_CACHE) + " < " + cases + "cache.3.in > /dev/null");
+    string rpn = "for f in " + cases + "rpn.*.in; do " + DLIST_RPN + " < $f > /dev/null || exit 1; done";
+    suite.command("rpn rpn.*.in", rpn);
+    return suite.finish();
+}
@@ -0,0 +1,143 @@
+//
+// Benchmarks of the Huffman codec of p4-huffman: counting, building the
+// code, coding and decoding one frame and adaptive coding in process, the
+// buffer codec of huffmanCodec.h, and the compress and decompress executables
+// on a file.
+//
+
+#include <algorithm>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "adaptiveHuffman.h"
+#include "bench.h"
+#include "binaryTree.h"
+#include "frameCodec.h"
+#include "huffmanCodec.h"
+#include "huffmanTree.h"
+#include "inputFile.h"
+
+using namespace std;
+
+static vector<unsigned char> corpushelper(size_t size, unsigned seed) {
+    // EFFECTS returns size bytes of text-like data: words of a Zipf-like
+    //         vocabulary separated by spaces and newlines
+    mt19937 rng(seed);
+    vector<string> words;
+    for (int i = 0; i < 2000; i++) {
+        string word;
+        int length = 2 + int(rng() % 8);
+        for (int j = 0; j < length; j++) word += char('a' + rng() % 26);
+        words.push_back(word);
+    }
+    vector<unsigned char> data;
+    data.reserve(size + 16);
+    while (data.size() < size) {
+        // Rank r with probability about 1 / r
+        double u = double(rng()) / double(rng.max());
+        const string &word = words[size_t(pow(double(words.size()), u)) - 1];
+        data.insert(data.end(), word.begin(), word.end());
+        data.push_back(rng() % 12 == 0 ? '\n' : ' ');
+    }
+    data.resize(size);
+    return data;
+}
+
+int main(int argc, char *argv[]) {
+    bench::Suite suite("huffman", argc, argv);
+    const size_t FRAME = DEFAULT_BLOCK_SIZE;
+    vector<unsigned char> data = corpushelper(16 * FRAME, 280);
+
+    suite.micro("countBytes/64KiB", [&]() {
+        uint64_t count[256] = {};
+        countBytes(data.data(), 1 << 16, count);
+        bench::keep(count);
+    }, 1 << 16);
+
+    uint64_t count[256] = {};
+    countBytes(data.data(), FRAME, count);
+    suite.micro("buildHuffman", [&]() {
+        Node *root = buildHuffman(count);
+        HuffmanTree tree(root);
+        bench::keep(tree.root);
+    });
+
+    string frame, frame4;
+    suite.macro("encodeFrame/1MiB", [&]() {
+        frame.clear();
+        encodeFrame(data.data(), FRAME, frame);
+        return !frame.empty();
+    }, double(FRAME));
+    suite.macro("encodeFrame-interleaved/1MiB", [&]() {
+        frame4.clear();
+        encodeFrame(data.data(), FRAME, frame4, 0, true);
+        return !frame4.empty();
+    }, double(FRAME));
+
+    string adaptive;
+    suite.macro("AdaptiveEncoder/1MiB", [&]() {
+        adaptive.clear();
+        BitWriter writer(adaptive);
+        AdaptiveEncoder encoder(writer);
+        for (size_t i = 0; i < FRAME; i++) encoder.put(data[i]);
+        encoder.finish();
+        return !adaptive.empty();
+    }, double(FRAME));
+
+    // Decoding reads the frame back through an InputFile, as decompress does
+    for (int interleaved = 0; interleaved < 2; interleaved++) {
+        string name = string("decodeFrame") + (interleaved ? "-interleaved" : "") + "/1MiB";
+        if (!suite.enabled(name)) continue;
+        string path = suite.workDir() + "/huffman-frame.bin";
+        string &coded = interleaved ? frame4 : frame;
+        if (coded.empty()) encodeFrame(data.data(), FRAME, coded, 0, interleaved != 0);
+        ofstream(path, ios::binary).write(coded.data(), streamsize(coded.size()));
+        InputFile in;
+        FrameInfo info;
+        size_t got = 0;
+        const unsigned char *payload = nullptr;
+        if (in.open(path) && readFrameInfo(in, info)) payload = in.read(info.payloadSize, got);
+        vector<unsigned char> out(FRAME);
+        bool valid = payload && got == info.payloadSize && decodeFrame(info, payload, out.data())
+                     && equal(out.begin(), out.end(), data.begin());
+        suite.macro(name, [&]() {
+            return valid && decodeFrame(info, payload, out.data());
+        }, double(FRAME));
+    }
+
+    // The buffer codec on the whole corpus, what the executables below do
+    // without the process and the pipe
+    vector<unsigned char> archived(compressBound(data.size())), restored(data.size());
+    size_t archivedSize = 0;
+    HuffmanContext context;
+    suite.macro("compress in process/16MiB", [&]() {
+        archivedSize = compress(data.data(), data.size(), archived.data(), archived.size());
+        return archivedSize > 0;
+    }, double(data.size()));
+    bool restores = false;
+    if (suite.enabled("decompress in process/16MiB")) {
+        if (archivedSize == 0) archivedSize = compress(data.data(), data.size(), archived.data(), archived.size());
+        restores = decompress(archived.data(), archivedSize, restored.data(), restored.size()) == data.size()
+                   && restored == data;
+    }
+    suite.macro("decompress in process/16MiB", [&]() {
+        return restores && decompress(archived.data(), archivedSize, restored.data(), restored.size(),
+                                      &context) == data.size();
+    }, double(data.size()));
+
+    // The executables, on a 16 MiB file
+    string input = suite.workDir() + "/huffman-corpus.txt";
+    string archive = suite.workDir() + "/huffman-corpus.huf";
+    if (!suite.listing()) ofstream(input, ios::binary).write((const char *) data.data(), streamsize(data.size()));
+    string compress = string(HUFFMAN_COMPRESS) + " ";
+    string decompress = string(HUFFMAN_DECOMPRESS) + " -binary ";
+    if (!suite.listing() && std::system((compress + "-stream " + input + " > " + archive).c_str()) != 0) return 1;
+    suite.command("compress -stream/16MiB", compress + "-stream " + input + " > /dev/null", double(data.size()));
+    suite.command("compress -interleave/16MiB", compress + "-interleave " + input + " > /dev/null", double(data.size()));
+    suite.command("compress -adaptive/16MiB", compress + "-adaptive " + input + " > /dev/null", double(data.size()));
+    suite.command("compress -order1/16MiB", compress + "-order1 " + input + " > /dev/null", double(data.size()));
+    suite.command("decompress -binary/16MiB", decompress + archive + " > /dev/null", double(data.size()));
+    return suite.finish();
+}
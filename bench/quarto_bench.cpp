@@ -0,0 +1,164 @@
+//
+// Benchmarks of p4-quarto: the bitboard win test, perft on the Board,
+// Square and Piece objects and on bitboards, and self-play between the
+// search and the myopic players through the executable.
+//
+
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "board.h"
+#include "pool.h"
+
+using namespace std;
+
+// The continuations found by perft: every placement, and the placements of
+// them that win
+struct Perft {
+    long long nodes = 0, wins = 0;
+};
+
+static void objectperfthelper(Board &board, Pool &pool, Piece &piece, int depth, Perft &count) {
+    // REQUIRES: "piece" is unused, "depth" >= 1
+    // MODIFIES: "board", "pool", "count"
+    // EFFECTS: add to "count" the placements of "piece" on each empty square
+    //          and, unless one wins, of each unused piece given after it, up
+    //          to "depth" placements, leaving "board" and "pool" as they were
+    for (int i = 0; i < NP; i++) {
+        Square &square = board.getSquare(Vaxis(i / N), Haxis(i % N));
+        if (!square.isEmpty()) continue;
+        board.place(piece, square);
+        count.nodes++;
+        if (board.isWinning(piece, square)) {
+            count.wins++;
+        } else if (depth > 1) {
+            pool.forEachUnused([&](Piece &next) { objectperfthelper(board, pool, next, depth - 1, count); });
+        }
+        board.remove(piece, square);
+    }
+}
+
+// A position as bitboards, as Board keeps them, and the pieces neither
+// placed nor to be placed, by their codes
+struct BitPosition {
+    unsigned int occupied, attributes[N], unused;
+};
+
+static void bitboardperfthelper(const BitPosition &pos, unsigned int code, int depth, Perft &count) {
+    // REQUIRES: "depth" >= 1
+    // MODIFIES: "count"
+    // EFFECTS: as objectperfthelper(), for the piece "code" on "pos"
+    for (unsigned int empty = ~pos.occupied & ((1u << NP) - 1); empty; empty &= empty - 1) {
+        int square = __builtin_ctz(empty);
+        count.nodes++;
+        if (Board::isWinning(pos.occupied, pos.attributes, code, square)) {
+            count.wins++;
+            continue;
+        }
+        if (depth == 1) continue;
+        unsigned int bit = 1u << square;
+        BitPosition child = pos;
+        child.occupied |= bit;
+        for (int i = 0; i < N; i++) {
+            if (code >> i & 1u) child.attributes[i] |= bit;
+        }
+        for (unsigned int unused = pos.unused; unused; unused &= unused - 1) {
+            unsigned int next = unsigned(__builtin_ctz(unused));
+            child.unused = pos.unused & ~(1u << next);
+            bitboardperfthelper(child, next, depth - 1, count);
+        }
+    }
+}
+
+int main(int argc, char *argv[]) {
+    bench::Suite suite("quarto", argc, argv);
+
+    // 4096 random positions, each with an empty square and a piece for it
+    struct Position {
+        unsigned int occupied, attributes[N], code;
+        int square;
+    };
+    mt19937 rng(119);
+    vector<Position> positions(4096);
+    for (auto &p : positions) {
+        p.occupied = rng() & 0xffff;
+        p.square = int(rng() % (N * N));
+        p.occupied &= ~(1u << p.square);
+        for (int i = 0; i < N; i++) p.attributes[i] = rng() & p.occupied;
+        p.code = rng() % 16;
+    }
+    size_t next = 0;
+    suite.micro("Board::isWinning", [&]() {
+        const Position &p = positions[next++ & 4095];
+        bench::keep(Board::isWinning(p.occupied, p.attributes, p.code, p.square));
+    }, 1);
+
+    // Perft from reference positions of random play that won no game: the
+    // placements so far, the piece to place, and the depth searched. The
+    // object model makes and unmakes each placement on a Board; the
+    // bitboard engine copies a BitPosition. Their counts must agree.
+    struct Reference {
+        const char *placements, *piece;
+        int depth;
+    };
+    const Reference references[] = {
+            {"", "SECO", 3},
+            {"A4 TEQH C1 SBCH B4 TBCO B3 TECO", "SBCO", 3},
+            {"D4 SECH A2 TECH A3 TECO B1 SEQH B4 SEQO D2 TBQH", "TEQH", 4},
+            {"D3 TECH C2 SBQH B1 TBQO A2 SBQO A3 SEQO A1 SEQH B2 SECH D2 TEQO", "SBCH", 5},
+    };
+    for (const auto &reference : references) {
+        Board board;
+        Pool pool;
+        istringstream placements(reference.placements);
+        string square, piece;
+        while (placements >> square >> piece) {
+            board.place(pool.getUnusedPiece(piece), board.getEmptySquare(square));
+        }
+        Piece &toPlace = pool.getUnusedPiece(reference.piece);
+        BitPosition pos{0, {}, 0};
+        pool.forEachUnused([&](Piece &p) {
+            if (&p != &toPlace) pos.unused |= 1u << p.getCode();
+        });
+        for (int i = 0; i < NP; i++) {
+            const Square &sq = board.getSquare(Vaxis(i / N), Haxis(i % N));
+            if (sq.isEmpty()) continue;
+            unsigned int code = sq.getPiece().getCode();
+            pos.occupied |= 1u << i;
+            for (int a = 0; a < N; a++) {
+                if (code >> a & 1u) pos.attributes[a] |= 1u << i;
+            }
+        }
+
+        Perft expected;
+        if (!suite.listing()) objectperfthelper(board, pool, toPlace, reference.depth, expected);
+        string name = to_string(NP - __builtin_popcount(pos.occupied)) + " empty/depth "
+                      + to_string(reference.depth);
+        auto check = [&](const char *engine, const Perft &count) {
+            if (count.nodes == expected.nodes && count.wins == expected.wins) return true;
+            cerr << "perft " << engine << " " << name << ": " << count.nodes << " nodes, " << count.wins
+                 << " wins, against " << expected.nodes << " nodes, " << expected.wins << " wins" << endl;
+            return false;
+        };
+        suite.macro("perft objects " + name, [&]() {
+            Perft count;
+            objectperfthelper(board, pool, toPlace, reference.depth, count);
+            return check("objects", count);
+        }, double(expected.nodes));
+        suite.macro("perft bitboards " + name, [&]() {
+            Perft count;
+            bitboardperfthelper(pos, toPlace.getCode(), reference.depth, count);
+            return check("bitboards", count);
+        }, double(expected.nodes));
+    }
+
+    // games, player 1, player 2, seed, depth, time limit (0: none), threads
+    string quarto = string(QUARTO) + " selfplay ";
+    suite.command("selfplay search-myopic depth 2/20 games", quarto + "20 s m 119 2 0 1 > /dev/null", 20);
+    suite.command("selfplay search-search depth 3/4 games", quarto + "4 s s 119 3 0 1 > /dev/null", 4);
+    return suite.finish();
+}
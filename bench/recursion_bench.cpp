@@ -0,0 +1,62 @@
+//
+// Benchmarks of the recursive lists and trees of p2-recursion-v2. Lists
+// are hash-consed, so each call makes its result in a cell_arena that is
+// destroyed after it, or every call after the first would find its result
+// already made.
+//
+
+#include <random>
+
+#include "bench.h"
+#include "p2.h"
+#include "recursive.h"
+
+using namespace std;
+
+template<class F>
+static void arenahelper(F f) {
+    // EFFECTS calls f with the cells it makes freed afterwards
+    cell_arena arena;
+    f();
+}
+
+int main(int argc, char *argv[]) {
+    bench::Suite suite("recursion", argc, argv);
+    const int N = 10000;
+    mt19937 rng(119);
+
+    list_t list = list_make(), other = list_make();
+    for (int i = 0; i < N; i++) list = list_make(int(rng() % 1000), list);
+    for (int i = 0; i < N; i++) other = list_make(int(rng() % 1000), other);
+    tree_t tree = tree_make();
+    for (int i = 0; i < N; i++) tree = insert_tree(int(rng() >> 1), tree);
+
+    suite.micro("size/10000", [&]() { bench::keep(size(list)); }, N);
+    suite.micro("dot/10000", [&]() { bench::keep(dot(list, other)); }, N);
+    suite.micro("reverse/10000", [&]() {
+        arenahelper([&]() { bench::keep(list_first(reverse(list))); });
+    }, N);
+    suite.micro("append/10000+10000", [&]() {
+        arenahelper([&]() { bench::keep(list_first(append(list, other))); });
+    }, 2 * N);
+    suite.micro("filter_odd/10000", [&]() {
+        arenahelper([&]() { bench::keep(list_isEmpty(filter_odd(list))); });
+    }, N);
+    suite.micro("unique/10000", [&]() {
+        arenahelper([&]() { bench::keep(list_isEmpty(unique(list))); });
+    }, N);
+    // tree_sum reads a sum the cells keep, so walk the tree with a search
+    // that finds nothing
+    suite.micro("tree_search miss/10000", [&]() { bench::keep(tree_search(tree, -1)); }, N);
+    suite.micro("traversal/10000", [&]() {
+        arenahelper([&]() { bench::keep(list_first(traversal(tree))); });
+    }, N);
+    suite.micro("insert_tree/10000", [&]() {
+        arenahelper([&]() {
+            tree_t t = tree_make();
+            for (int i = 0; i < N; i++) t = insert_tree(i * 7919 % N, t);
+            bench::keep(tree_elt(t));
+        });
+    }, N);
+    return suite.finish();
+}
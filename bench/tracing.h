@@ -0,0 +1,179 @@
+//
+// Scoped timers and counters for the hot paths of the projects, written as
+// a Chrome trace that Perfetto (ui.perfetto.dev) or chrome://tracing opens.
+//
+// Compiled out unless ECE2800J_TRACE is defined (cmake -DTRACE=ON from the
+// top of the repository): TRACE_SCOPE and TRACE_COUNTER then expand to
+// nothing that runs. Traced, each thread records into its own buffer, and
+// the trace is written at exit to $ECE2800J_TRACE_FILE, or to
+// trace-<pid>.json; several of those files open together in one view.
+//
+
+#ifndef BENCH_TRACING_H
+#define BENCH_TRACING_H
+
+#ifdef ECE2800J_TRACE
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace trace {
+
+struct Event {
+    const char *name;
+    char phase;             // 'X' for a scope, 'C' for a counter
+    int64_t start;          // Nanoseconds since the recorder started
+    int64_t value;          // The duration of a scope, the value of a counter
+};
+
+class Recorder {
+    // OVERVIEW: the events of every thread, written as one trace when
+    //           the program exits. Each thread appends to a buffer of its
+    //           own, without locking; past EVENT_LIMIT events, a thread
+    //           only counts the events it drops.
+
+    struct Buffer {
+        unsigned int thread;
+        std::vector<Event> events;
+        size_t dropped;
+    };
+
+    static const size_t EVENT_LIMIT = size_t(1) << 22;
+
+    std::mutex m;
+    std::vector<std::shared_ptr<Buffer> > buffers;
+    std::chrono::steady_clock::time_point origin;
+
+    Recorder() : origin(std::chrono::steady_clock::now()) {}
+
+    std::shared_ptr<Buffer> registerhelper() {
+        // EFFECTS adds the buffer of a new thread
+        std::shared_ptr<Buffer> buffer(new Buffer{0, std::vector<Event>(), 0});
+        std::lock_guard<std::mutex> lock(m);
+        buffer->thread = (unsigned int) buffers.size() + 1;
+        buffers.push_back(buffer);
+        return buffer;
+    }
+
+    static std::string processhelper() {
+        // EFFECTS returns the name of the executable
+        std::string name = "process";
+        if (FILE *f = fopen("/proc/self/comm", "r")) {
+            char comm[64];
+            if (fgets(comm, sizeof(comm), f)) {
+                name = comm;
+                if (!name.empty() && name.back() == '\n') name.pop_back();
+            }
+            fclose(f);
+        }
+        return name;
+    }
+
+   public:
+    static Recorder &get() {
+        static Recorder recorder;
+        return recorder;
+    }
+
+    ~Recorder() {
+        write();
+    }
+
+    int64_t now() const {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - origin)
+            .count();
+    }
+
+    void record(const Event &event) {
+        // REQUIRES event.name outlives the recorder, as a string literal does
+        // MODIFIES the buffer of this thread
+        thread_local std::shared_ptr<Buffer> buffer = registerhelper();
+        if (buffer->events.size() < EVENT_LIMIT) buffer->events.push_back(event);
+        else buffer->dropped++;
+    }
+
+    void write() {
+        // REQUIRES the threads that recorded have finished
+        // EFFECTS writes the trace; names are printed as they are, so they
+        //         must need no JSON escape
+        const char *path = getenv("ECE2800J_TRACE_FILE");
+        std::string file = path ? path : "trace-" + std::to_string(getpid()) + ".json";
+        FILE *out = fopen(file.c_str(), "w");
+        if (!out) {
+            fprintf(stderr, "Cannot write the trace %s\n", file.c_str());
+            return;
+        }
+        int pid = (int) getpid();
+        std::lock_guard<std::mutex> lock(m);
+        fprintf(out, "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n");
+        fprintf(out, "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": %d, \"args\": {\"name\": \"%s\"}}",
+                pid, processhelper().c_str());
+        for (const auto &buffer : buffers) {
+            for (const Event &e : buffer->events) {
+                if (e.phase == 'X') {
+                    fprintf(out, ",\n{\"name\": \"%s\", \"ph\": \"X\", \"pid\": %d, \"tid\": %u, \"ts\": %.3f, "
+                            "\"dur\": %.3f}", e.name, pid, buffer->thread, e.start / 1e3, e.value / 1e3);
+                } else {
+                    fprintf(out, ",\n{\"name\": \"%s\", \"ph\": \"C\", \"pid\": %d, \"tid\": %u, \"ts\": %.3f, "
+                            "\"args\": {\"value\": %lld}}", e.name, pid, buffer->thread, e.start / 1e3,
+                            (long long) e.value);
+                }
+            }
+            if (buffer->dropped) {
+                fprintf(stderr, "trace: thread %u dropped %zu events\n", buffer->thread, buffer->dropped);
+            }
+        }
+        fprintf(out, "\n]}\n");
+        fclose(out);
+    }
+};
+
+class Scope {
+    // OVERVIEW: records the time from its construction to its destruction
+    const char *name;
+    int64_t start;
+
+   public:
+    explicit Scope(const char *name) : name(name), start(Recorder::get().now()) {}
+
+    ~Scope() {
+        Recorder &recorder = Recorder::get();
+        recorder.record(Event{name, 'X', start, recorder.now() - start});
+    }
+
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+};
+
+inline void counter(const char *name, int64_t value) {
+    Recorder &recorder = Recorder::get();
+    recorder.record(Event{name, 'C', recorder.now(), value});
+}
+
+}  // namespace trace
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+
+// Times the rest of the enclosing block as the event "name"
+#define TRACE_SCOPE(name) ::trace::Scope TRACE_CONCAT(traceScope, __LINE__)(name)
+// Records "value" on the counter track "name"
+#define TRACE_COUNTER(name, value) ::trace::counter((name), (int64_t) (value))
+
+#else
+
+// The arguments are named but not evaluated, so that a variable used only
+// to trace draws no warning
+#define TRACE_SCOPE(name) ((void) sizeof(name))
+#define TRACE_COUNTER(name, value) ((void) sizeof(name), (void) sizeof(value))
+
+#endif
+
+#endif //BENCH_TRACING_H
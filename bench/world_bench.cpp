@@ -0,0 +1,51 @@
+//
+// Benchmarks of p3-hard-world and p2-simple-twitter, whose state lives in
+// the executables (a world, a singleton server), so both are timed as
+// commands on their test data.
+//
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+
+using namespace std;
+
+struct Generated {
+    // A world made by p3-hard-world-gen, and the rounds to run on it
+    unsigned size, creatures, rounds;
+};
+
+int main(int argc, char *argv[]) {
+    bench::Suite suite("world", argc, argv);
+
+    string cases = string("cd ") + PROJECTS_DIR + "/p3-hard-world/test-cases/tc-imba && ";
+    string world = string(WORLD) + " species/species2 worlds/";
+    for (const char *name : {"aworld", "bworld", "cnmworld", "sjtu"}) {
+        suite.command(string("world ") + name + "/1000 rounds",
+                      cases + world + name + " 1000 -q > /dev/null", 1000);
+    }
+
+    // Generated worlds of a creature on every 10th square, from 64 x 64 up;
+    // BENCH_WORLD_HUGE=1 adds 8192 x 8192 with 10^7 creatures, which takes
+    // about 1.5 GiB and over 10 seconds a sample. "load" runs no round, so
+    // that the rounds take the difference.
+    vector<Generated> generated = {{64, 400, 1000}, {256, 6500, 200}, {1024, 100000, 20}, {2048, 400000, 5}};
+    const char *huge = getenv("BENCH_WORLD_HUGE");
+    if (huge != NULL && string(huge) == "1") generated.push_back({8192, 10000000, 2});
+    for (const auto &g : generated) {
+        string size = to_string(g.size), dir = suite.workDir() + "/world-" + size;
+        string name = "world gen" + size + "^2/";
+        if (!suite.listing() && std::system((string(WORLDGEN) + " " + dir + " " + size + " " +
+                                             to_string(g.creatures)).c_str()) != 0) return 1;
+        string run = "cd " + dir + " && " + WORLD + " species world ";
+        suite.command(name + "load", run + "0 --large -q > /dev/null");
+        suite.command(name + to_string(g.rounds) + " rounds",
+                      run + to_string(g.rounds) + " --large -q > /dev/null", g.rounds);
+    }
+
+    string data = string("cd ") + PROJECTS_DIR + "/p2-simple-twitter/data && ";
+    suite.command("twitter data/logfile", data + TWITTER + " username logfile > /dev/null");
+    return suite.finish();
+}
@@ -0,0 +1,40 @@
+//
+// The test case of p4-huffman: the tree and the code of textfile.txt, and
+// the file decoded back from them.
+//
+
+#include <string>
+
+#include "regress.h"
+
+using namespace std;
+
+int regress_compress_main(int argc, char *argv[]);
+int regress_decompress_main(int argc, char *argv[]);
+
+int main(int argc, char *argv[]) {
+    regress::Suite suite("huffman", argc, argv);
+    string cases = string(PROJECTS_DIR) + "/p4-huffman/cases";
+
+    regress::Case tree;
+    tree.name = "compress-tree";
+    tree.dir = cases;
+    tree.program = "./compress";
+    tree.args = {"-tree", "textfile.txt"};
+    tree.expected = cases + "/tree.txt";
+    suite.add(regress_compress_main, tree);
+
+    regress::Case binary = tree;
+    binary.name = "compress";
+    binary.args = {"textfile.txt"};
+    binary.expected = cases + "/binary.txt";
+    suite.add(regress_compress_main, binary);
+
+    regress::Case text = tree;
+    text.name = "decompress";
+    text.program = "./decompress";
+    text.args = {"tree.txt", "binary.txt"};
+    text.expected = cases + "/textfile.txt";
+    suite.add(regress_decompress_main, text);
+    return suite.finish();
+}
@@ -0,0 +1,46 @@
+//
+// The test cases of p5-list-simple: 0 to 5 are the input and output of
+// call, 6 to 9 and the pretest those of calc. 10, 11 and pretest/5 are
+// the output of test-all.cpp and test-exception.cpp, which are built on
+// the dlist.h of the problem and not run here.
+//
+
+#include <string>
+
+#include "regress.h"
+
+using namespace std;
+
+int regress_call_main(int argc, char *argv[]);
+int regress_calc_main(int argc, char *argv[]);
+
+static void addhelper(regress::Suite &suite, const string &dir, const string &name, regress::Entry entry,
+                      const char *program, const string &label) {
+    // MODIFIES suite
+    // EFFECTS adds the case of dir/name.in and dir/name.out, if there is
+    //         one, run by entry and called label
+    string path = dir + "/" + name;
+    if (!regress::exists(path + ".in")) return;
+    regress::Case c;
+    c.name = label;
+    c.dir = dir;
+    c.program = string("./") + program;
+    c.input = path + ".in";
+    c.expected = path + ".out";
+    suite.add(entry, c);
+}
+
+int main(int argc, char *argv[]) {
+    regress::Suite suite("list", argc, argv);
+    string tests = string(PROJECTS_DIR) + "/p5-list-simple/test-cases";
+    for (int n = 0; n <= 5; n++) {
+        addhelper(suite, tests, to_string(n), regress_call_main, "call", "call/" + to_string(n));
+    }
+    for (int n = 6; n <= 9; n++) {
+        addhelper(suite, tests, to_string(n), regress_calc_main, "calc", "calc/" + to_string(n));
+    }
+    for (int n = 0; n <= 3; n++) {
+        addhelper(suite, tests + "/pretest", to_string(n), regress_calc_main, "calc", "calc/pretest-" + to_string(n));
+    }
+    return suite.finish();
+}
@@ -0,0 +1,311 @@
+//
+// The regression framework of the regress-* targets: the test cases of a
+// project run against its engine, linked into the runner, and their output
+// compared with the expected one in memory.
+//
+
+#ifndef REGRESS_H
+#define REGRESS_H
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <iostream>
+#include <signal.h>
+#include <string>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace regress {
+
+// The main() of an engine, compiled under another name
+typedef int (*Entry)(int argc, char *argv[]);
+
+enum class Compare {
+    EXACT,              // Byte for byte
+    IGNORE_BLANK_LINES  // Line for line, without the empty lines of either
+};
+
+struct Case {
+    std::string name;
+    std::string dir;                // The working directory of the run
+    std::string program;            // argv[0]
+    std::vector<std::string> args;
+    std::string input;              // The file read as standard input, /dev/null if empty
+    std::string expected;           // The file of the expected standard output
+    Compare compare = Compare::EXACT;
+    std::string knownFailure;       // Why the case is expected to fail, if it is
+};
+
+inline bool readFile(const std::string &path, std::string &contents) {
+    // MODIFIES contents
+    // EFFECTS reads the file at path into contents, and returns false if
+    //         it cannot be read
+    FILE *file = fopen(path.c_str(), "rb");
+    if (file == NULL) return false;
+    contents.clear();
+    char buffer[1 << 16];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), file)) > 0) contents.append(buffer, n);
+    bool ok = !ferror(file);
+    fclose(file);
+    return ok;
+}
+
+inline bool exists(const std::string &path) {
+    return access(path.c_str(), F_OK) == 0;
+}
+
+inline std::vector<std::string> listDirectory(const std::string &path) {
+    // EFFECTS returns the names in the directory at path, but . and ..,
+    //         sorted, or none if it cannot be read
+    std::vector<std::string> names;
+    DIR *dir = opendir(path.c_str());
+    if (dir == NULL) return names;
+    while (struct dirent *entry = readdir(dir)) {
+        std::string name = entry->d_name;
+        if (name != "." && name != "..") names.push_back(name);
+    }
+    closedir(dir);
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+inline std::vector<std::string> splitWords(const std::string &line) {
+    // EFFECTS returns the words of line, split at blanks, as a shell
+    //         splits a command without quotes
+    std::vector<std::string> words;
+    std::string word;
+    for (char c : line + ' ') {
+        if (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+            if (!word.empty()) words.push_back(word);
+            word.clear();
+        } else {
+            word += c;
+        }
+    }
+    return words;
+}
+
+class Suite {
+    // OVERVIEW: the cases of one project. finish() runs them, --jobs at a
+    //           time, each in a fork of the runner that calls the engine
+    //           in place of exec'ing it: the engine keeps its globals and
+    //           std::cout as a process of its own would, and a crash or an
+    //           exit() ends only its case. The output goes to a temporary
+    //           file that the runner reads back and compares.
+    //
+    //           Options: --jobs N (the number of processors by default),
+    //           --filter TEXT (run the cases whose name contains TEXT),
+    //           --timeout SECONDS (60 by default), --verbose (print the
+    //           passing cases too) and --list.
+
+    struct Run {
+        size_t index;
+        pid_t pid;
+        FILE *output;
+        std::chrono::steady_clock::time_point deadline;
+        bool timedOut;
+    };
+
+    std::string name;
+    unsigned jobs = std::max(1u, std::thread::hardware_concurrency());
+    double timeout = 60;
+    std::string filter;
+    bool verbose = false, listOnly = false;
+    std::vector<Case> cases;
+    std::vector<Entry> entries;
+
+    static std::vector<std::string> lineshelper(const std::string &text, bool skipBlank) {
+        std::vector<std::string> lines;
+        size_t start = 0;
+        while (start < text.size()) {
+            size_t end = text.find('\n', start);
+            if (end == std::string::npos) end = text.size();
+            std::string line = text.substr(start, end - start);
+            if (skipBlank && !line.empty() && line.back() == '\r') line.pop_back();
+            if (!skipBlank || !line.empty()) lines.push_back(line);
+            start = end + 1;
+        }
+        return lines;
+    }
+
+    static std::string comparehelper(const std::string &output, const std::string &expected, Compare compare) {
+        // EFFECTS returns "" if output matches expected, or else where
+        //         they first differ
+        if (compare == Compare::EXACT && output == expected) return "";
+        auto got = lineshelper(output, compare == Compare::IGNORE_BLANK_LINES);
+        auto want = lineshelper(expected, compare == Compare::IGNORE_BLANK_LINES);
+        if (compare == Compare::IGNORE_BLANK_LINES && got == want) return "";
+        size_t i = 0;
+        while (i < got.size() && i < want.size() && got[i] == want[i]) i++;
+        auto show = [](const std::vector<std::string> &lines, size_t i) {
+            if (i >= lines.size()) return std::string("(end of output)");
+            return '"' + (lines[i].size() > 100 ? lines[i].substr(0, 100) + "..." : lines[i]) + '"';
+        };
+        if (i == got.size() && i == want.size()) return "the same lines, but for the line ends";
+        return "line " + std::to_string(i + 1) + ": got " + show(got, i) + ", expected " + show(want, i);
+    }
+
+    [[noreturn]] static void childhelper(const Case &c, Entry entry, int output) {
+        // EFFECTS runs the engine on c in this forked process, with its
+        //         standard output to output, and exits with its status
+        int input = open(c.input.empty() ? "/dev/null" : c.input.c_str(), O_RDONLY);
+        int null = open("/dev/null", O_WRONLY);
+        if (chdir(c.dir.c_str()) != 0 || input < 0 || null < 0) _exit(126);
+        dup2(input, 0);
+        dup2(output, 1);
+        dup2(null, 2);
+        std::vector<std::string> words(1, c.program);
+        words.insert(words.end(), c.args.begin(), c.args.end());
+        std::vector<char *> argv;
+        for (auto &word : words) argv.push_back(&word[0]);
+        argv.push_back(NULL);
+        int status = entry(int(words.size()), argv.data());
+        std::cout.flush();
+        fflush(stdout);
+        _exit(status & 0xff);
+    }
+
+    bool starthelper(size_t index, std::vector<Run> &running) {
+        // MODIFIES running
+        // EFFECTS forks the run of case index, and returns false if it
+        //         could not be started
+        FILE *output = tmpfile();
+        if (output == NULL) return false;
+        // What is buffered here would be written again by the child
+        std::cout.flush();
+        fflush(stdout);
+        pid_t pid = fork();
+        if (pid < 0) {
+            fclose(output);
+            return false;
+        }
+        if (pid == 0) childhelper(cases[index], entries[index], fileno(output));
+        auto deadline = std::chrono::steady_clock::now() +
+                        std::chrono::milliseconds(long(timeout * 1000));
+        running.push_back(Run{index, pid, output, deadline, false});
+        return true;
+    }
+
+    std::string resulthelper(const Run &run, int status) {
+        // EFFECTS returns "" if the run of a case passed, or why it failed
+        const Case &c = cases[run.index];
+        if (run.timedOut) {
+            char why[64];
+            snprintf(why, sizeof(why), "timed out after %g s", timeout);
+            return why;
+        }
+        if (WIFSIGNALED(status)) return std::string("killed by ") + strsignal(WTERMSIG(status));
+        if (WIFEXITED(status) && WEXITSTATUS(status) == 126) return "cannot enter " + c.dir;
+        std::string output, expected;
+        rewind(run.output);
+        char buffer[1 << 16];
+        size_t n;
+        while ((n = fread(buffer, 1, sizeof(buffer), run.output)) > 0) output.append(buffer, n);
+        if (!readFile(c.expected, expected)) return "cannot read " + c.expected;
+        return comparehelper(output, expected, c.compare);
+    }
+
+   public:
+    Suite(const std::string &suiteName, int argc, char *argv[]) : name(suiteName) {
+        // EFFECTS reads the options, exits with usage on a wrong one
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            bool value = i + 1 < argc;
+            if (arg == "--jobs" && value) jobs = unsigned(std::max(1, atoi(argv[++i])));
+            else if (arg == "--filter" && value) filter = argv[++i];
+            else if (arg == "--timeout" && value) timeout = std::max(0.001, atof(argv[++i]));
+            else if (arg == "--verbose") verbose = true;
+            else if (arg == "--list") listOnly = true;
+            else {
+                std::cerr << "Usage: " << argv[0] << " [--jobs N] [--filter TEXT] [--timeout SECONDS]"
+                          << " [--verbose] [--list]" << std::endl;
+                exit(2);
+            }
+        }
+    }
+
+    void add(Entry entry, const Case &c) {
+        // MODIFIES this
+        // EFFECTS adds case c, run by entry, unless --filter leaves it out
+        if (!filter.empty() && c.name.find(filter) == std::string::npos) return;
+        cases.push_back(c);
+        entries.push_back(entry);
+    }
+
+    int finish() {
+        // EFFECTS runs the cases and prints those that failed, then a
+        //         summary; returns 1 if a case failed that was not known to,
+        //         or none was found, and 0 otherwise
+        if (listOnly) {
+            for (const auto &c : cases) std::cout << name << "/" << c.name << std::endl;
+            return 0;
+        }
+        auto start = std::chrono::steady_clock::now();
+        size_t next = 0, passed = 0, failed = 0, known = 0, fixed = 0;
+        std::vector<Run> running;
+        while (next < cases.size() || !running.empty()) {
+            while (next < cases.size() && running.size() < jobs) {
+                if (!starthelper(next, running)) {
+                    std::cout << "FAIL " << name << "/" << cases[next].name << ": cannot start: "
+                              << strerror(errno) << std::endl;
+                    failed++;
+                }
+                next++;
+            }
+            int status;
+            pid_t pid = waitpid(-1, &status, WNOHANG);
+            if (pid <= 0) {
+                // Nothing ended: kill the late runs, and look again soon
+                auto now = std::chrono::steady_clock::now();
+                for (auto &run : running) {
+                    if (!run.timedOut && now >= run.deadline) {
+                        run.timedOut = true;
+                        kill(run.pid, SIGKILL);
+                    }
+                }
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+                continue;
+            }
+            auto run = std::find_if(running.begin(), running.end(), [pid](const Run &r) { return r.pid == pid; });
+            if (run == running.end()) continue;
+            const Case &c = cases[run->index];
+            std::string why = resulthelper(*run, status);
+            fclose(run->output);
+            running.erase(run);
+            std::string label = name + "/" + c.name;
+            if (why.empty() && c.knownFailure.empty()) {
+                passed++;
+                if (verbose) std::cout << "PASS " << label << std::endl;
+            } else if (why.empty()) {
+                fixed++;
+                std::cout << "PASS " << label << ", known to fail: " << c.knownFailure << std::endl;
+            } else if (!c.knownFailure.empty()) {
+                known++;
+                if (verbose) std::cout << "KNOWN " << label << ": " << c.knownFailure << "; " << why << std::endl;
+            } else {
+                failed++;
+                std::cout << "FAIL " << label << ": " << why << std::endl;
+            }
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        char summary[256];
+        snprintf(summary, sizeof(summary), "%s: %zu passed, %zu failed, %zu known failures, %zu fixed, in %.3f s"
+                 " on %u jobs", name.c_str(), passed + fixed, failed, known, fixed, seconds, jobs);
+        std::cout << summary << std::endl;
+        if (cases.empty()) std::cout << name << ": no case found" << std::endl;
+        return failed > 0 || cases.empty();
+    }
+};
+
+}  // namespace regress
+
+#endif //REGRESS_H
@@ -0,0 +1,34 @@
+//
+// The test cases of p3-simple-world, on the engine of p3-hard-world built
+// with P3_SIMPLE_WORLD: N.in holds the command line, test_cases/N.out the
+// output expected.
+//
+
+#include <string>
+
+#include "regress.h"
+
+using namespace std;
+
+int regress_simple_world_main(int argc, char *argv[]);
+
+int main(int argc, char *argv[]) {
+    regress::Suite suite("simple-world", argc, argv);
+    string project = string(PROJECTS_DIR) + "/p3-simple-world";
+    for (const auto &file : regress::listDirectory(project + "/test-cases")) {
+        if (file.size() < 4 || file.compare(file.size() - 3, 3, ".in") != 0) continue;
+        string n = file.substr(0, file.size() - 3), line;
+        regress::readFile(project + "/test-cases/" + file, line);
+        auto words = regress::splitWords(line);
+        if (words.empty()) continue;
+        regress::Case c;
+        c.name = n;
+        c.dir = project + "/test-cases";
+        // The usage message names the program as it was called
+        c.program = words[0];
+        c.args.assign(words.begin() + 1, words.end());
+        c.expected = project + "/test_cases/" + n + ".out";
+        suite.add(regress_simple_world_main, c);
+    }
+    return suite.finish();
+}
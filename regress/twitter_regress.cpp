@@ -0,0 +1,89 @@
+//
+// The test cases of p2-simple-twitter: cases/args.json gives the arguments
+// of each, run from cases/, and ans/<name> its output, compared without
+// the empty lines as test.py does. The cases without an answer are left
+// out.
+//
+
+#include <cctype>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "regress.h"
+
+using namespace std;
+
+int regress_twitter_main(int argc, char *argv[]);
+
+typedef vector<pair<string, vector<string> > > Arguments;
+
+static bool stringhelper(const string &json, size_t &at, string &value) {
+    // MODIFIES at, value
+    // EFFECTS reads the JSON string at json[at], with the escapes of file
+    //         names, and returns false if there is none
+    while (at < json.size() && isspace((unsigned char) json[at])) at++;
+    if (at >= json.size() || json[at] != '"') return false;
+    value.clear();
+    for (at++; at < json.size() && json[at] != '"'; at++) {
+        if (json[at] == '\\' && at + 1 < json.size()) at++;
+        value += json[at];
+    }
+    return at++ < json.size();
+}
+
+static bool punctuationhelper(const string &json, size_t &at, char c) {
+    // MODIFIES at
+    // EFFECTS skips c at json[at], after blanks, and returns false if it
+    //         is not there
+    while (at < json.size() && isspace((unsigned char) json[at])) at++;
+    if (at >= json.size() || json[at] != c) return false;
+    at++;
+    return true;
+}
+
+static bool argumentshelper(const string &json, Arguments &arguments) {
+    // MODIFIES arguments
+    // EFFECTS reads the object of arrays of strings in json, and returns
+    //         false if it is not one
+    size_t at = 0;
+    if (!punctuationhelper(json, at, '{')) return false;
+    if (punctuationhelper(json, at, '}')) return true;
+    do {
+        string name, arg;
+        vector<string> args;
+        if (!stringhelper(json, at, name) || !punctuationhelper(json, at, ':') ||
+            !punctuationhelper(json, at, '[')) return false;
+        if (!punctuationhelper(json, at, ']')) {
+            do {
+                if (!stringhelper(json, at, arg)) return false;
+                args.push_back(arg);
+            } while (punctuationhelper(json, at, ','));
+            if (!punctuationhelper(json, at, ']')) return false;
+        }
+        arguments.emplace_back(name, args);
+    } while (punctuationhelper(json, at, ','));
+    return punctuationhelper(json, at, '}');
+}
+
+int main(int argc, char *argv[]) {
+    regress::Suite suite("twitter", argc, argv);
+    string cases = string(PROJECTS_DIR) + "/p2-simple-twitter/cases", json;
+    Arguments arguments;
+    if (!regress::readFile(cases + "/args.json", json) || !argumentshelper(json, arguments)) {
+        std::cerr << "Cannot read " << cases << "/args.json" << std::endl;
+        return 1;
+    }
+    for (const auto &entry : arguments) {
+        if (!regress::exists(cases + "/ans/" + entry.first)) continue;
+        regress::Case c;
+        c.name = entry.first;
+        c.dir = cases;
+        c.program = "./p2";
+        c.args = entry.second;
+        c.expected = cases + "/ans/" + entry.first;
+        c.compare = regress::Compare::IGNORE_BLANK_LINES;
+        suite.add(regress_twitter_main, c);
+    }
+    return suite.finish();
+}